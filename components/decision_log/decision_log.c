@@ -0,0 +1,627 @@
+/**
+ * @file decision_log.c
+ * @brief Decision Log Component - Append-only irrigation event log on flash
+ *
+ * Writes go through a RAM queue drained by a low-priority task, so callers
+ * (state machine, pulse timer) never wait for a flash erase. Sequence
+ * numbers are assigned when a record reaches flash; record timestamps are
+ * taken when it is queued.
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "decision_log.h"
+#include "time_sync.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+/* ============================ CONFIGURATION ============================ */
+
+#ifndef CONFIG_DECISION_LOG_PARTITION
+#define CONFIG_DECISION_LOG_PARTITION "irrlog"
+#endif
+
+#ifndef CONFIG_DECISION_LOG_QUEUE_RECORDS
+#define CONFIG_DECISION_LOG_QUEUE_RECORDS 16
+#endif
+
+#ifndef CONFIG_DECISION_LOG_TASK_PRIORITY
+#define CONFIG_DECISION_LOG_TASK_PRIORITY 2
+#endif
+
+#ifndef CONFIG_DECISION_LOG_TASK_STACK_SIZE
+#define CONFIG_DECISION_LOG_TASK_STACK_SIZE 3072
+#endif
+
+#define DECISION_LOG_MAGIC              0x474F4C44  // "DLOG"
+#define DECISION_LOG_VERSION            1
+#define DECISION_LOG_ERASED             0xFFFFFFFF
+
+#define DECISION_LOG_SEGMENT_SIZE       4096        // One flash sector
+#define DECISION_LOG_HEADER_SIZE        64
+#define DECISION_LOG_RECORD_SIZE        48
+#define DECISION_LOG_SEGMENT_RECORDS    ((DECISION_LOG_SEGMENT_SIZE - DECISION_LOG_HEADER_SIZE) / DECISION_LOG_RECORD_SIZE)
+#define DECISION_LOG_INDEX_STRIDE       8
+#define DECISION_LOG_INDEX_SLOTS        ((DECISION_LOG_SEGMENT_RECORDS + DECISION_LOG_INDEX_STRIDE - 1) / DECISION_LOG_INDEX_STRIDE)
+
+/* ============================ PRIVATE TYPES ============================ */
+
+/**
+ * @brief Segment header (64 bytes)
+ *
+ * magic..crc are written when the segment is started; index slots are
+ * written later into the erased area, one per DECISION_LOG_INDEX_STRIDE
+ * records.
+ */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t sequence;                          ///< Segment order in the ring
+    uint32_t crc;                               ///< CRC32 of the fields above
+    uint32_t index[DECISION_LOG_INDEX_SLOTS];   ///< Newest timestamp up to record i*STRIDE
+    uint32_t reserved;
+} decision_log_segment_header_t;
+
+_Static_assert(sizeof(decision_log_record_t) == DECISION_LOG_RECORD_SIZE, "record layout is the flash format");
+_Static_assert(sizeof(decision_log_segment_header_t) == DECISION_LOG_HEADER_SIZE, "header layout is the flash format");
+
+/**
+ * @brief Decision log context
+ */
+typedef struct {
+    const esp_partition_t *partition;
+    uint32_t segment_count;
+    uint32_t head_segment;              ///< Segment being written
+    uint32_t head_sequence;             ///< Its sequence number
+    uint32_t head_record;               ///< Next free slot in the head segment
+    uint32_t next_seq;                  ///< Sequence of the next record
+    uint32_t high_water;                ///< Newest timestamp written
+
+    decision_log_record_t *queue;       ///< Records waiting for flash
+    uint16_t queue_tail;
+    uint16_t queue_count;
+    uint32_t dropped;
+
+    SemaphoreHandle_t mutex;            ///< Flash access and head position
+    TaskHandle_t task_handle;
+} decision_log_context_t;
+
+/* ============================ PRIVATE STATE ============================ */
+
+static const char *TAG = "decision_log";
+
+static decision_log_context_t s_dl_ctx = {0};
+static portMUX_TYPE s_dl_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+static const char *s_event_names[DECISION_EVENT_COUNT] = {
+    "evaluation", "valve_open", "valve_close", "state", "command", "boot"
+};
+
+static const char *s_reason_names[DECISION_REASON_COUNT] = {
+    "none", "soil_dry", "soil_adequate", "soil_sufficient", "continue",
+    "target_reached", "over_moisture", "planned_duration", "session_timeout",
+    "temperature_critical", "temperature_normal", "offline_level", "offline_normal",
+    "window_deferred", "window_released", "window_dropped", "valve_failure",
+    "pulse_on", "pulse_soak", "pulse_program_done", "remote_command",
+    "emergency_stop", "sensor_failure", "session_resumed", "session_interrupted"
+};
+
+/* ============================ FLASH LAYOUT ============================ */
+
+static uint32_t segment_offset(uint32_t segment)
+{
+    return segment * DECISION_LOG_SEGMENT_SIZE;
+}
+
+static uint32_t record_offset(uint32_t segment, uint32_t record)
+{
+    return segment_offset(segment) + DECISION_LOG_HEADER_SIZE + record * DECISION_LOG_RECORD_SIZE;
+}
+
+static uint32_t header_crc(const decision_log_segment_header_t *header)
+{
+    return esp_rom_crc32_le(0, (const uint8_t *)header, offsetof(decision_log_segment_header_t, crc));
+}
+
+static uint32_t record_crc(const decision_log_record_t *record)
+{
+    return esp_rom_crc32_le(0, (const uint8_t *)record, offsetof(decision_log_record_t, crc));
+}
+
+static bool record_is_erased(const decision_log_record_t *record)
+{
+    return record->seq == DECISION_LOG_ERASED && record->crc == DECISION_LOG_ERASED;
+}
+
+static bool segment_read_header(uint32_t segment, decision_log_segment_header_t *header)
+{
+    if (esp_partition_read(s_dl_ctx.partition, segment_offset(segment), header, sizeof(*header)) != ESP_OK) {
+        return false;
+    }
+    return header->magic == DECISION_LOG_MAGIC &&
+           header->version == DECISION_LOG_VERSION &&
+           header->record_size == DECISION_LOG_RECORD_SIZE &&
+           header->crc == header_crc(header);
+}
+
+/**
+ * @brief Erase @p segment and write its header (index slots left erased)
+ */
+static esp_err_t segment_start(uint32_t segment, uint32_t sequence)
+{
+    esp_err_t ret = esp_partition_erase_range(s_dl_ctx.partition, segment_offset(segment),
+                                              DECISION_LOG_SEGMENT_SIZE);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    decision_log_segment_header_t header = {
+        .magic = DECISION_LOG_MAGIC,
+        .version = DECISION_LOG_VERSION,
+        .record_size = DECISION_LOG_RECORD_SIZE,
+        .sequence = sequence,
+    };
+    header.crc = header_crc(&header);
+    return esp_partition_write(s_dl_ctx.partition, segment_offset(segment), &header,
+                               offsetof(decision_log_segment_header_t, index));
+}
+
+/**
+ * @brief Count the used slots of @p segment and find its last sequence
+ *
+ * Torn records (bad CRC) still use their slot.
+ */
+static uint32_t segment_scan(uint32_t segment, uint32_t *last_seq, uint32_t *high_water)
+{
+    uint32_t used = 0;
+    decision_log_record_t record;
+
+    while (used < DECISION_LOG_SEGMENT_RECORDS) {
+        if (esp_partition_read(s_dl_ctx.partition, record_offset(segment, used),
+                               &record, sizeof(record)) != ESP_OK ||
+            record_is_erased(&record)) {
+            break;
+        }
+        if (record.crc == record_crc(&record)) {
+            *last_seq = record.seq;
+            if (record.timestamp > *high_water) {
+                *high_water = record.timestamp;
+            }
+        }
+        used++;
+    }
+    return used;
+}
+
+/**
+ * @brief Find the segment being written and the next free slot
+ */
+static esp_err_t decision_log_recover(void)
+{
+    decision_log_segment_header_t header;
+    bool found = false;
+    uint32_t head = 0;
+    uint32_t head_sequence = 0;
+    uint32_t head_hw = 0;
+
+    for (uint32_t seg = 0; seg < s_dl_ctx.segment_count; seg++) {
+        if (segment_read_header(seg, &header) && (!found || header.sequence > head_sequence)) {
+            found = true;
+            head = seg;
+            head_sequence = header.sequence;
+            head_hw = (header.index[0] != DECISION_LOG_ERASED) ? header.index[0] : 0;
+        }
+    }
+
+    if (!found) {
+        ESP_LOGI(TAG, "Empty log, formatting segment 0");
+        esp_err_t ret = segment_start(0, 1);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        s_dl_ctx.head_segment = 0;
+        s_dl_ctx.head_sequence = 1;
+        s_dl_ctx.head_record = 0;
+        s_dl_ctx.next_seq = 1;
+        s_dl_ctx.high_water = 0;
+        return ESP_OK;
+    }
+
+    uint32_t last_seq = 0;
+    uint32_t used = segment_scan(head, &last_seq, &head_hw);
+    if (used == 0) {
+        // Fresh segment: the sequence continues from the previous one
+        uint32_t prev = (head + s_dl_ctx.segment_count - 1) % s_dl_ctx.segment_count;
+        if (segment_read_header(prev, &header) && header.sequence == head_sequence - 1) {
+            segment_scan(prev, &last_seq, &head_hw);
+        }
+    }
+
+    s_dl_ctx.head_segment = head;
+    s_dl_ctx.head_sequence = head_sequence;
+    s_dl_ctx.head_record = used;
+    s_dl_ctx.next_seq = last_seq + 1;
+    s_dl_ctx.high_water = head_hw;
+    return ESP_OK;
+}
+
+/**
+ * @brief Write one record at the head (mutex held)
+ */
+static esp_err_t decision_log_write_locked(decision_log_record_t *record)
+{
+    esp_err_t ret;
+
+    if (s_dl_ctx.head_record >= DECISION_LOG_SEGMENT_RECORDS) {
+        // Segment full: the oldest one is erased and becomes the head
+        uint32_t next = (s_dl_ctx.head_segment + 1) % s_dl_ctx.segment_count;
+        ret = segment_start(next, s_dl_ctx.head_sequence + 1);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to start segment %" PRIu32 ": %s", next, esp_err_to_name(ret));
+            return ret;
+        }
+        s_dl_ctx.head_segment = next;
+        s_dl_ctx.head_sequence++;
+        s_dl_ctx.head_record = 0;
+    }
+
+    record->seq = s_dl_ctx.next_seq++;
+    record->crc = record_crc(record);
+
+    uint32_t slot = s_dl_ctx.head_record++;
+    ret = esp_partition_write(s_dl_ctx.partition, record_offset(s_dl_ctx.head_segment, slot),
+                              record, sizeof(*record));
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to write record %" PRIu32 ": %s", record->seq, esp_err_to_name(ret));
+        return ret;
+    }
+
+    if (record->timestamp > s_dl_ctx.high_water) {
+        s_dl_ctx.high_water = record->timestamp;
+    }
+    if (slot % DECISION_LOG_INDEX_STRIDE == 0) {
+        uint32_t index_offset = segment_offset(s_dl_ctx.head_segment) +
+                                offsetof(decision_log_segment_header_t, index) +
+                                (slot / DECISION_LOG_INDEX_STRIDE) * sizeof(uint32_t);
+        esp_partition_write(s_dl_ctx.partition, index_offset, &s_dl_ctx.high_water, sizeof(uint32_t));
+    }
+    return ESP_OK;
+}
+
+static bool decision_log_pop(decision_log_record_t *record)
+{
+    bool popped = false;
+
+    portENTER_CRITICAL(&s_dl_spinlock);
+    {
+        if (s_dl_ctx.queue_count > 0) {
+            *record = s_dl_ctx.queue[s_dl_ctx.queue_tail];
+            s_dl_ctx.queue_tail = (s_dl_ctx.queue_tail + 1) % CONFIG_DECISION_LOG_QUEUE_RECORDS;
+            s_dl_ctx.queue_count--;
+            popped = true;
+        }
+    }
+    portEXIT_CRITICAL(&s_dl_spinlock);
+
+    return popped;
+}
+
+static void decision_log_flush_locked(void)
+{
+    decision_log_record_t record;
+    while (decision_log_pop(&record)) {
+        decision_log_write_locked(&record);
+    }
+}
+
+static void decision_log_task(void *param)
+{
+    (void)param;
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        decision_log_flush();
+    }
+}
+
+/* ============================ QUERY ============================ */
+
+/**
+ * @brief Collect the matching records of one segment
+ *
+ * @param next_first_hw index[0] of the next segment in the ring
+ *        (DECISION_LOG_ERASED if this is the head)
+ * @return false once the query is complete
+ */
+static bool decision_log_query_segment(uint32_t segment, const decision_log_segment_header_t *header,
+                                       uint32_t next_first_hw, const decision_log_filter_t *filter,
+                                       decision_log_record_t *records, size_t max_records,
+                                       size_t *count)
+{
+    // The next segment starts with a running maximum older than the range
+    if (filter->from > 0 && next_first_hw != DECISION_LOG_ERASED && next_first_hw < filter->from) {
+        return true;
+    }
+
+    decision_log_record_t block[DECISION_LOG_INDEX_STRIDE];
+
+    for (uint32_t b = 0; b < DECISION_LOG_INDEX_SLOTS; b++) {
+        // Every record of block b is older than the index slot of block b+1
+        if (filter->from > 0 && b + 1 < DECISION_LOG_INDEX_SLOTS &&
+            header->index[b + 1] != DECISION_LOG_ERASED && header->index[b + 1] < filter->from) {
+            continue;
+        }
+
+        uint32_t first = b * DECISION_LOG_INDEX_STRIDE;
+        uint32_t n = DECISION_LOG_SEGMENT_RECORDS - first;
+        if (n > DECISION_LOG_INDEX_STRIDE) {
+            n = DECISION_LOG_INDEX_STRIDE;
+        }
+        if (esp_partition_read(s_dl_ctx.partition, record_offset(segment, first),
+                               block, n * sizeof(decision_log_record_t)) != ESP_OK) {
+            return true;
+        }
+
+        for (uint32_t i = 0; i < n; i++) {
+            const decision_log_record_t *record = &block[i];
+            if (record_is_erased(record)) {
+                return true;    // End of the written part
+            }
+            if (record->crc != record_crc(record) || record->seq <= filter->after_seq) {
+                continue;
+            }
+            if (record->timestamp == 0) {
+                if (filter->from != 0) {
+                    continue;
+                }
+            } else if (record->timestamp < filter->from ||
+                       (filter->to != 0 && record->timestamp > filter->to)) {
+                continue;       // Newer records may follow a clock step back
+            }
+
+            records[(*count)++] = *record;
+            if (*count >= max_records) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/* ============================ PUBLIC API ============================ */
+
+esp_err_t decision_log_init(void)
+{
+#if !CONFIG_DECISION_LOG_ENABLE
+    return ESP_ERR_NOT_SUPPORTED;
+#else
+    if (s_dl_ctx.queue != NULL) {
+        return ESP_OK;
+    }
+
+    const esp_partition_t *partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                                ESP_PARTITION_SUBTYPE_ANY,
+                                                                CONFIG_DECISION_LOG_PARTITION);
+    if (partition == NULL || partition->size < 2 * DECISION_LOG_SEGMENT_SIZE) {
+        ESP_LOGW(TAG, "Partition '%s' not found, decision log disabled", CONFIG_DECISION_LOG_PARTITION);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    s_dl_ctx.partition = partition;
+    s_dl_ctx.segment_count = partition->size / DECISION_LOG_SEGMENT_SIZE;
+    s_dl_ctx.mutex = xSemaphoreCreateMutex();
+    if (s_dl_ctx.mutex == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t ret = decision_log_recover();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open log: %s", esp_err_to_name(ret));
+        vSemaphoreDelete(s_dl_ctx.mutex);
+        s_dl_ctx.mutex = NULL;
+        return ret;
+    }
+
+    decision_log_record_t *queue = calloc(CONFIG_DECISION_LOG_QUEUE_RECORDS, sizeof(decision_log_record_t));
+    if (queue == NULL) {
+        vSemaphoreDelete(s_dl_ctx.mutex);
+        s_dl_ctx.mutex = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    BaseType_t task_ret = xTaskCreate(decision_log_task, "decision_log", CONFIG_DECISION_LOG_TASK_STACK_SIZE,
+                                      NULL, CONFIG_DECISION_LOG_TASK_PRIORITY, &s_dl_ctx.task_handle);
+    if (task_ret != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create writer task");
+        free(queue);
+        vSemaphoreDelete(s_dl_ctx.mutex);
+        s_dl_ctx.mutex = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    portENTER_CRITICAL(&s_dl_spinlock);
+    {
+        s_dl_ctx.queue = queue;
+    }
+    portEXIT_CRITICAL(&s_dl_spinlock);
+
+    ESP_LOGI(TAG, "Decision log: %" PRIu32 " segments x %d records, head %" PRIu32 "/%" PRIu32
+             ", next seq %" PRIu32,
+             s_dl_ctx.segment_count, DECISION_LOG_SEGMENT_RECORDS,
+             s_dl_ctx.head_segment, s_dl_ctx.head_record, s_dl_ctx.next_seq);
+    return ESP_OK;
+#endif
+}
+
+void decision_log_append(const decision_log_record_t *record)
+{
+    if (record == NULL) {
+        return;
+    }
+
+    decision_log_record_t entry = *record;
+    time_quality_t quality;
+    uint32_t now = time_sync_get_timestamp(&quality);
+    entry.timestamp = (quality != TIME_QUALITY_UNSYNCED) ? now : 0;
+    entry.uptime_s = (uint32_t)(esp_timer_get_time() / 1000000);
+    entry.flags = (entry.flags & ~DECISION_LOG_FLAG_TIME_SYNCED) |
+                  ((quality != TIME_QUALITY_UNSYNCED) ? DECISION_LOG_FLAG_TIME_SYNCED : 0);
+    entry.seq = 0;
+    entry.crc = 0;
+
+    bool queued = false;
+    portENTER_CRITICAL(&s_dl_spinlock);
+    {
+        if (s_dl_ctx.queue != NULL) {
+            if (s_dl_ctx.queue_count < CONFIG_DECISION_LOG_QUEUE_RECORDS) {
+                uint16_t slot = (s_dl_ctx.queue_tail + s_dl_ctx.queue_count) % CONFIG_DECISION_LOG_QUEUE_RECORDS;
+                s_dl_ctx.queue[slot] = entry;
+                s_dl_ctx.queue_count++;
+                queued = true;
+            } else {
+                s_dl_ctx.dropped++;
+            }
+        }
+    }
+    portEXIT_CRITICAL(&s_dl_spinlock);
+
+    if (queued) {
+        xTaskNotifyGive(s_dl_ctx.task_handle);
+    }
+}
+
+void decision_log_flush(void)
+{
+    if (s_dl_ctx.mutex == NULL) {
+        return;
+    }
+
+    xSemaphoreTake(s_dl_ctx.mutex, portMAX_DELAY);
+    decision_log_flush_locked();
+    xSemaphoreGive(s_dl_ctx.mutex);
+}
+
+esp_err_t decision_log_query(const decision_log_filter_t *filter,
+                             decision_log_record_t *records, size_t max_records,
+                             size_t *count)
+{
+    if (filter == NULL || records == NULL || count == NULL || max_records == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *count = 0;
+    if (s_dl_ctx.queue == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(s_dl_ctx.mutex, portMAX_DELAY);
+    decision_log_flush_locked();
+
+    // Ring order from the oldest segment (after the head) to the head; a
+    // segment is scanned once the next one's first index slot is known
+    decision_log_segment_header_t prev_header;
+    decision_log_segment_header_t header;
+    uint32_t prev_segment = 0;
+    bool have_prev = false;
+    bool more = true;
+
+    for (uint32_t k = 1; k <= s_dl_ctx.segment_count && more; k++) {
+        uint32_t segment = (s_dl_ctx.head_segment + k) % s_dl_ctx.segment_count;
+        if (!segment_read_header(segment, &header)) {
+            continue;
+        }
+        if (have_prev) {
+            more = decision_log_query_segment(prev_segment, &prev_header, header.index[0],
+                                              filter, records, max_records, count);
+        }
+        prev_segment = segment;
+        prev_header = header;
+        have_prev = true;
+    }
+    if (have_prev && more) {
+        decision_log_query_segment(prev_segment, &prev_header, DECISION_LOG_ERASED,
+                                   filter, records, max_records, count);
+    }
+
+    xSemaphoreGive(s_dl_ctx.mutex);
+    return ESP_OK;
+}
+
+uint32_t decision_log_get_dropped(void)
+{
+    uint32_t dropped;
+
+    portENTER_CRITICAL(&s_dl_spinlock);
+    {
+        dropped = s_dl_ctx.dropped;
+    }
+    portEXIT_CRITICAL(&s_dl_spinlock);
+
+    return dropped;
+}
+
+const char* decision_log_event_to_string(uint8_t event)
+{
+    return (event < DECISION_EVENT_COUNT) ? s_event_names[event] : "unknown";
+}
+
+const char* decision_log_reason_to_string(uint8_t reason)
+{
+    return (reason < DECISION_REASON_COUNT) ? s_reason_names[reason] : "unknown";
+}
+
+cJSON* decision_log_record_to_json(const decision_log_record_t *record)
+{
+    if (record == NULL) {
+        return NULL;
+    }
+
+    cJSON *item = cJSON_CreateObject();
+    if (item == NULL) {
+        return NULL;
+    }
+
+    cJSON_AddNumberToObject(item, "seq", record->seq);
+    if (record->flags & DECISION_LOG_FLAG_TIME_SYNCED) {
+        cJSON_AddNumberToObject(item, "timestamp", record->timestamp);
+    } else {
+        cJSON_AddNullToObject(item, "timestamp");
+    }
+    cJSON_AddNumberToObject(item, "uptime", record->uptime_s);
+    cJSON_AddStringToObject(item, "event", decision_log_event_to_string(record->event));
+    cJSON_AddStringToObject(item, "reason", decision_log_reason_to_string(record->reason));
+    cJSON_AddNumberToObject(item, "state", record->state);
+    if (record->level == DECISION_LOG_LEVEL_NONE) {
+        cJSON_AddNullToObject(item, "offline_level");
+    } else {
+        cJSON_AddNumberToObject(item, "offline_level", record->level);
+    }
+    cJSON_AddNumberToObject(item, "valve", record->valve);
+    cJSON_AddNumberToObject(item, "value", record->value);
+    cJSON_AddNumberToObject(item, "arg", record->arg);
+    cJSON_AddBoolToObject(item, "online", (record->flags & DECISION_LOG_FLAG_ONLINE) != 0);
+    cJSON_AddBoolToObject(item, "pulse", (record->flags & DECISION_LOG_FLAG_PULSE) != 0);
+    cJSON_AddNumberToObject(item, "temperature", record->temperature_x10 / 10.0);
+    cJSON_AddNumberToObject(item, "humidity", record->humidity_x10 / 10.0);
+
+    cJSON *soil = cJSON_AddArrayToObject(item, "soil");
+    if (soil != NULL) {
+        uint8_t channels = (record->soil_count < DECISION_LOG_SOIL_CHANNELS)
+            ? record->soil_count : DECISION_LOG_SOIL_CHANNELS;
+        for (uint8_t i = 0; i < channels; i++) {
+            float percent = decision_log_soil_percent(record->soil[i]);
+            cJSON_AddItemToArray(soil, (percent < 0.0f) ? cJSON_CreateNull() : cJSON_CreateNumber(percent));
+        }
+    }
+    return item;
+}
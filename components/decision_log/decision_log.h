@@ -0,0 +1,253 @@
+/**
+ * @file decision_log.h
+ * @brief Decision Log Component - Append-only irrigation event log on flash
+ *
+ * Records every irrigation decision with its inputs (soil per channel,
+ * ambient temperature/humidity, offline level, state) and the valve
+ * actions it caused, so "why did zone 1 water at 3 am" can be answered
+ * from the device. Reasons are stored as decision_reason_t codes and only
+ * rendered to text when queried.
+ *
+ * Flash layout (dedicated data partition, CONFIG_DECISION_LOG_PARTITION):
+ * - The partition is a ring of 4 KB segments (one flash sector each)
+ * - Segment header: magic, version, sequence, CRC32 and a sparse time
+ *   index with one slot every DECISION_LOG_INDEX_STRIDE records
+ * - Records: fixed 48 bytes with their own CRC32; the first erased slot
+ *   ends the segment being written
+ *
+ * Each index slot holds the newest timestamp logged so far (a running
+ * maximum across segments), so a range query skips every segment and
+ * block that only holds records older than its start, even if the wall
+ * clock stepped back, and reads from the first candidate block on.
+ *
+ * Component Responsibilities:
+ * - Queue records from any task or esp_timer callback (no flash access)
+ * - Append queued records to flash from a low-priority writer task
+ * - Time-range queries with paging for the HTTP and MQTT front ends
+ *
+ * Thread-Safety:
+ * - decision_log_append() only takes a spinlock
+ * - Flash writes and queries are serialized by a mutex
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef DECISION_LOG_H
+#define DECISION_LOG_H
+
+#include "esp_err.h"
+#include "cJSON.h"
+#include "sdkconfig.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================ CONSTANTS ============================ */
+
+#ifndef CONFIG_DECISION_LOG_QUERY_MAX_RECORDS
+#define CONFIG_DECISION_LOG_QUERY_MAX_RECORDS 32
+#endif
+
+#define DECISION_LOG_SOIL_CHANNELS      16      ///< Soil channels per record (SOIL_MAX_SENSORS)
+#define DECISION_LOG_SOIL_NONE          0xFF    ///< Channel not present
+#define DECISION_LOG_LEVEL_NONE         0xFF    ///< No offline level (online)
+#define DECISION_LOG_QUERY_MAX          CONFIG_DECISION_LOG_QUERY_MAX_RECORDS
+
+#define DECISION_LOG_FLAG_TIME_SYNCED   0x01    ///< timestamp is wall clock
+#define DECISION_LOG_FLAG_ONLINE        0x02    ///< WiFi connected
+#define DECISION_LOG_FLAG_PULSE         0x04    ///< Part of a cycle-and-soak program
+
+/* ============================ TYPES ============================ */
+
+/**
+ * @brief What happened
+ */
+typedef enum {
+    DECISION_EVENT_EVALUATION = 0,  ///< Decision without valve action (deferred, recommendation)
+    DECISION_EVENT_VALVE_OPEN,      ///< Valve opened (session or pulse start)
+    DECISION_EVENT_VALVE_CLOSE,     ///< Valve closed (session end or soak)
+    DECISION_EVENT_STATE,           ///< State change without valve action
+    DECISION_EVENT_COMMAND,         ///< Remote command received
+    DECISION_EVENT_BOOT,            ///< Controller started (journal restore)
+    DECISION_EVENT_COUNT
+} decision_log_event_t;
+
+/**
+ * @brief Why it happened
+ *
+ * Stored as one byte: append new codes at the end, never renumber.
+ */
+typedef enum {
+    DECISION_REASON_NONE = 0,
+    DECISION_REASON_SOIL_DRY,               ///< Soil at or below the critical threshold
+    DECISION_REASON_SOIL_ADEQUATE,          ///< Between critical and optimal
+    DECISION_REASON_SOIL_SUFFICIENT,        ///< At or above optimal
+    DECISION_REASON_CONTINUE,               ///< Below target, keep watering
+    DECISION_REASON_TARGET_REACHED,         ///< Optimal threshold reached
+    DECISION_REASON_OVER_MOISTURE,          ///< A sensor above the maximum threshold
+    DECISION_REASON_PLANNED_DURATION,       ///< Learned-model duration elapsed and verified
+    DECISION_REASON_SESSION_TIMEOUT,        ///< Maximum session duration
+    DECISION_REASON_TEMPERATURE_CRITICAL,   ///< Thermal protection
+    DECISION_REASON_TEMPERATURE_NORMAL,     ///< Thermal protection released
+    DECISION_REASON_OFFLINE_LEVEL,          ///< Offline critical/emergency level
+    DECISION_REASON_OFFLINE_NORMAL,         ///< Offline level below critical
+    DECISION_REASON_WINDOW_DEFERRED,        ///< Start queued until the time-of-day window
+    DECISION_REASON_WINDOW_RELEASED,        ///< Queued start released by its window
+    DECISION_REASON_WINDOW_DROPPED,         ///< Queued start dropped, soil recovered
+    DECISION_REASON_VALVE_FAILURE,          ///< Valve driver error
+    DECISION_REASON_PULSE_ON,               ///< Next pulse of a program
+    DECISION_REASON_PULSE_SOAK,             ///< Soak between pulses
+    DECISION_REASON_PULSE_PROGRAM_DONE,     ///< Last pulse or no budget left
+    DECISION_REASON_REMOTE_COMMAND,         ///< MQTT/API command
+    DECISION_REASON_EMERGENCY_STOP,         ///< Emergency stop (safety lock)
+    DECISION_REASON_SENSOR_FAILURE,         ///< No valid sensor sample
+    DECISION_REASON_SESSION_RESUMED,        ///< Session resumed after a reset
+    DECISION_REASON_SESSION_INTERRUPTED,    ///< Session closed after a reset
+    DECISION_REASON_COUNT
+} decision_reason_t;
+
+/**
+ * @brief Stored record (48 bytes, little endian, layout is the flash format)
+ *
+ * value by event:
+ * - VALVE_OPEN: planned duration (min, 0 = until threshold)
+ * - VALVE_CLOSE: water time of the session so far (s)
+ * - EVALUATION WINDOW_DEFERRED: minutes until the window opens
+ * - BOOT: water time of the interrupted session (s)
+ * arg by reason: REMOTE_COMMAND/EMERGENCY_STOP = irrigation_command_t,
+ * PULSE_* and soak stops = pulse index
+ */
+typedef struct {
+    uint32_t seq;                   ///< Record sequence number (set when written)
+    uint32_t timestamp;             ///< Wall clock (s), 0 if not synced
+    uint32_t uptime_s;              ///< Seconds since boot
+    uint8_t event;                  ///< decision_log_event_t
+    uint8_t reason;                 ///< decision_reason_t
+    uint8_t state;                  ///< irrigation_state_t after the decision
+    uint8_t level;                  ///< offline_level_t, DECISION_LOG_LEVEL_NONE online
+    uint8_t valve;                  ///< Valve acted on (0 = none)
+    uint8_t flags;                  ///< DECISION_LOG_FLAG_*
+    uint16_t value;                 ///< Event value (see above)
+    int16_t temperature_x10;        ///< Ambient temperature (0.1 °C)
+    uint16_t humidity_x10;          ///< Ambient humidity (0.1 %)
+    uint8_t soil_count;             ///< Soil channels used in soil[]
+    uint8_t arg;                    ///< Event argument (see above)
+    uint8_t reserved[2];
+    uint8_t soil[DECISION_LOG_SOIL_CHANNELS];   ///< Soil humidity per channel (0.5 %)
+    uint32_t crc;                   ///< CRC32 of every field above
+} decision_log_record_t;
+
+/**
+ * @brief Query filter
+ *
+ * Records without a synced timestamp (timestamp 0) only match from == 0.
+ */
+typedef struct {
+    uint32_t from;                  ///< Oldest timestamp (s), inclusive (0 = beginning)
+    uint32_t to;                    ///< Newest timestamp (s), inclusive (0 = no limit)
+    uint32_t after_seq;             ///< Only records after this sequence (paging, 0 = none)
+} decision_log_filter_t;
+
+/* ============================ PUBLIC API ============================ */
+
+/**
+ * @brief Open the log partition, find the write position and start the writer task
+ *
+ * @return ESP_OK on success
+ *         ESP_ERR_NOT_FOUND if the partition is missing (log disabled)
+ *         ESP_ERR_NOT_SUPPORTED if CONFIG_DECISION_LOG_ENABLE is off
+ */
+esp_err_t decision_log_init(void);
+
+/**
+ * @brief Queue a record for writing
+ *
+ * Fills seq, timestamp, uptime_s, the TIME_SYNCED flag and crc. Safe from
+ * any task or esp_timer callback; a no-op before init. When the queue is
+ * full the record is dropped and counted.
+ *
+ * @param record Record with the decision fields set
+ */
+void decision_log_append(const decision_log_record_t *record);
+
+/**
+ * @brief Write every queued record to flash from the calling task
+ *
+ * Call before esp_restart() or deep sleep so no records are lost.
+ */
+void decision_log_flush(void);
+
+/**
+ * @brief Read records matching @p filter in write order
+ *
+ * Queued records are flushed first. To page, repeat the query with
+ * after_seq set to the seq of the last record returned.
+ *
+ * @param filter Time range and paging cursor
+ * @param[out] records Output array
+ * @param max_records Size of @p records
+ * @param[out] count Records returned
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if the log is not available
+ */
+esp_err_t decision_log_query(const decision_log_filter_t *filter,
+                             decision_log_record_t *records, size_t max_records,
+                             size_t *count);
+
+/**
+ * @brief Get number of records dropped because the queue was full
+ *
+ * @return Dropped record count since boot
+ */
+uint32_t decision_log_get_dropped(void);
+
+/**
+ * @brief Event name for query output
+ */
+const char* decision_log_event_to_string(uint8_t event);
+
+/**
+ * @brief Reason name for query output and logging
+ */
+const char* decision_log_reason_to_string(uint8_t reason);
+
+/**
+ * @brief Render a record as a JSON object (names, units, soil array)
+ *
+ * Shared by the HTTP and MQTT query front ends.
+ *
+ * @param record Record returned by decision_log_query()
+ * @return New cJSON object (caller deletes), NULL on allocation failure
+ */
+cJSON* decision_log_record_to_json(const decision_log_record_t *record);
+
+/**
+ * @brief Soil humidity of a stored channel in percent (negative if absent)
+ */
+static inline float decision_log_soil_percent(uint8_t stored)
+{
+    return (stored == DECISION_LOG_SOIL_NONE) ? -1.0f : stored * 0.5f;
+}
+
+/**
+ * @brief Encode a soil humidity percent for a record
+ */
+static inline uint8_t decision_log_soil_encode(float percent)
+{
+    if (percent < 0.0f) {
+        return DECISION_LOG_SOIL_NONE;
+    }
+    float half = percent * 2.0f + 0.5f;
+    return (half >= 200.0f) ? 200 : (uint8_t)half;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DECISION_LOG_H
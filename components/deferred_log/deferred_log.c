@@ -0,0 +1,403 @@
+/**
+ * @file deferred_log.c
+ * @brief Deferred Log Component - Binary log ring for hot paths
+ *
+ * Arguments are captured by walking the format string once: floating point
+ * conversions are stored as float bits, everything else as 32-bit words.
+ * The flush task walks the format again and formats one conversion at a
+ * time with the matching argument type.
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "deferred_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/portmacro.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <sys/param.h>
+
+/* ============================ CONFIGURATION ============================ */
+
+#ifndef CONFIG_DEFERRED_LOG_RING_ENTRIES
+#define CONFIG_DEFERRED_LOG_RING_ENTRIES 64
+#endif
+
+#ifndef CONFIG_DEFERRED_LOG_FLUSH_INTERVAL_MS
+#define CONFIG_DEFERRED_LOG_FLUSH_INTERVAL_MS 500
+#endif
+
+#ifndef CONFIG_DEFERRED_LOG_TASK_PRIORITY
+#define CONFIG_DEFERRED_LOG_TASK_PRIORITY 1
+#endif
+
+#ifndef CONFIG_DEFERRED_LOG_TASK_STACK_SIZE
+#define CONFIG_DEFERRED_LOG_TASK_STACK_SIZE 3072
+#endif
+
+#define DEFERRED_LOG_MAX_ARGS          6
+#define DEFERRED_LOG_LINE_MAX_LEN      160
+#define DEFERRED_LOG_SPEC_MAX_LEN      16
+#define DEFERRED_LOG_TASK_STACK_SIZE   CONFIG_DEFERRED_LOG_TASK_STACK_SIZE
+
+/* ============================ PRIVATE STATE ============================ */
+
+static const char *TAG = "deferred_log";
+
+/**
+ * @brief Captured log record (40 bytes)
+ */
+typedef struct {
+    uint32_t timestamp_ms;              ///< esp_log_timestamp() at capture
+    const char *tag;
+    const char *format;
+    uint8_t level;
+    uint8_t nargs;
+    uint16_t reserved;
+    uint32_t args[DEFERRED_LOG_MAX_ARGS];
+} deferred_log_record_t;
+
+typedef struct {
+    deferred_log_record_t *ring;
+    uint16_t head;                      ///< Next slot to write
+    uint16_t tail;                      ///< Next slot to read
+    uint16_t count;
+    uint32_t dropped;
+    uint32_t dropped_reported;
+    deferred_log_sink_t sink;
+    void *sink_ctx;
+    TaskHandle_t task_handle;
+} deferred_log_context_t;
+
+static deferred_log_context_t s_dlog_ctx = {0};
+static portMUX_TYPE s_dlog_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+/* ============================ FORMAT PARSING ============================ */
+
+/**
+ * @brief Conversion argument class
+ */
+typedef enum {
+    DLOG_ARG_NONE = 0,                  ///< Literal or unsupported (e.g. '*' width)
+    DLOG_ARG_INT,
+    DLOG_ARG_INT64,
+    DLOG_ARG_FLOAT,
+    DLOG_ARG_PTR
+} dlog_arg_class_t;
+
+/**
+ * @brief Parse one conversion spec starting at '%'
+ *
+ * @param p Pointer to '%'
+ * @param[out] arg_class Argument class of the conversion
+ * @return Pointer to the last character of the spec (conversion char)
+ */
+static const char* deferred_log_parse_spec(const char *p, dlog_arg_class_t *arg_class)
+{
+    int long_count = 0;
+
+    *arg_class = DLOG_ARG_NONE;
+    p++;  // skip '%'
+
+    while (*p != '\0' && strchr("-+ #0", *p) != NULL) p++;
+    while ((*p >= '0' && *p <= '9') || *p == '.') p++;
+    while (*p != '\0' && strchr("hlzjtL", *p) != NULL) {
+        if (*p == 'l') {
+            long_count++;
+        }
+        p++;
+    }
+
+    switch (*p) {
+        case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+            *arg_class = (long_count >= 2) ? DLOG_ARG_INT64 : DLOG_ARG_INT;
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+            *arg_class = DLOG_ARG_FLOAT;
+            break;
+        case 's': case 'p':
+            *arg_class = DLOG_ARG_PTR;
+            break;
+        case '\0':
+            return p - 1;  // Truncated spec at end of string
+        default:
+            break;  // '%%' and unsupported conversions consume no argument
+    }
+
+    return p;
+}
+
+static uint8_t deferred_log_capture_args(const char *format, va_list ap, uint32_t *args)
+{
+    uint8_t nargs = 0;
+
+    for (const char *p = format; *p != '\0' && nargs < DEFERRED_LOG_MAX_ARGS; p++) {
+        if (*p != '%') {
+            continue;
+        }
+
+        dlog_arg_class_t arg_class;
+        p = deferred_log_parse_spec(p, &arg_class);
+
+        switch (arg_class) {
+            case DLOG_ARG_INT:
+                args[nargs++] = va_arg(ap, uint32_t);
+                break;
+            case DLOG_ARG_INT64:
+                args[nargs++] = (uint32_t)va_arg(ap, uint64_t);
+                break;
+            case DLOG_ARG_FLOAT: {
+                float value = (float)va_arg(ap, double);
+                memcpy(&args[nargs++], &value, sizeof(value));
+                break;
+            }
+            case DLOG_ARG_PTR:
+                args[nargs++] = (uint32_t)(uintptr_t)va_arg(ap, void *);
+                break;
+            default:
+                break;
+        }
+    }
+
+    return nargs;
+}
+
+static void deferred_log_format(const deferred_log_record_t *record, char *out, size_t out_size)
+{
+    size_t pos = 0;
+    uint8_t arg_index = 0;
+
+    for (const char *p = record->format; *p != '\0' && pos < out_size - 1; p++) {
+        if (*p != '%') {
+            out[pos++] = *p;
+            continue;
+        }
+
+        dlog_arg_class_t arg_class;
+        const char *spec_start = p;
+        p = deferred_log_parse_spec(p, &arg_class);
+
+        if (arg_class == DLOG_ARG_NONE) {
+            if (*p == '%') {
+                out[pos++] = '%';
+            }
+            continue;
+        }
+
+        if (arg_index >= record->nargs) {
+            break;  // More conversions than captured arguments
+        }
+
+        char spec[DEFERRED_LOG_SPEC_MAX_LEN];
+        size_t spec_len = MIN((size_t)(p - spec_start + 1), sizeof(spec) - 1);
+        memcpy(spec, spec_start, spec_len);
+        spec[spec_len] = '\0';
+
+        uint32_t raw = record->args[arg_index++];
+        int written;
+        switch (arg_class) {
+            case DLOG_ARG_FLOAT: {
+                float value;
+                memcpy(&value, &raw, sizeof(value));
+                written = snprintf(out + pos, out_size - pos, spec, (double)value);
+                break;
+            }
+            case DLOG_ARG_INT64:
+                written = snprintf(out + pos, out_size - pos, spec, (unsigned long long)raw);
+                break;
+            case DLOG_ARG_PTR:
+                written = snprintf(out + pos, out_size - pos, spec, (void *)(uintptr_t)raw);
+                break;
+            default:
+                written = snprintf(out + pos, out_size - pos, spec, raw);
+                break;
+        }
+
+        if (written > 0) {
+            pos = MIN(pos + (size_t)written, out_size - 1);
+        }
+    }
+
+    out[pos] = '\0';
+}
+
+/* ============================ OUTPUT ============================ */
+
+static char deferred_log_level_char(esp_log_level_t level)
+{
+    switch (level) {
+        case ESP_LOG_ERROR:   return 'E';
+        case ESP_LOG_WARN:    return 'W';
+        case ESP_LOG_INFO:    return 'I';
+        case ESP_LOG_DEBUG:   return 'D';
+        default:              return 'V';
+    }
+}
+
+static void deferred_log_emit(const deferred_log_record_t *record)
+{
+    esp_log_level_t level = (esp_log_level_t)record->level;
+
+    // Runtime level filter (esp_log_level_set) applied here, off the hot path
+    if (esp_log_level_get(record->tag) < level) {
+        return;
+    }
+
+    char message[DEFERRED_LOG_LINE_MAX_LEN];
+    deferred_log_format(record, message, sizeof(message));
+
+    esp_log_write(level, record->tag, "%c (%" PRIu32 ") %s: %s\n",
+                  deferred_log_level_char(level), record->timestamp_ms, record->tag, message);
+
+    deferred_log_sink_t sink;
+    void *sink_ctx;
+    portENTER_CRITICAL(&s_dlog_spinlock);
+    sink = s_dlog_ctx.sink;
+    sink_ctx = s_dlog_ctx.sink_ctx;
+    portEXIT_CRITICAL(&s_dlog_spinlock);
+
+    if (sink != NULL) {
+        sink(level, record->tag, record->timestamp_ms, message, sink_ctx);
+    }
+}
+
+static bool deferred_log_pop(deferred_log_record_t *record)
+{
+    bool popped = false;
+
+    portENTER_CRITICAL(&s_dlog_spinlock);
+    if (s_dlog_ctx.count > 0) {
+        *record = s_dlog_ctx.ring[s_dlog_ctx.tail];
+        s_dlog_ctx.tail = (s_dlog_ctx.tail + 1) % CONFIG_DEFERRED_LOG_RING_ENTRIES;
+        s_dlog_ctx.count--;
+        popped = true;
+    }
+    portEXIT_CRITICAL(&s_dlog_spinlock);
+
+    return popped;
+}
+
+static void deferred_log_task(void *param)
+{
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(CONFIG_DEFERRED_LOG_FLUSH_INTERVAL_MS));
+        deferred_log_flush();
+    }
+}
+
+/* ============================ PUBLIC API ============================ */
+
+esp_err_t deferred_log_init(void)
+{
+    if (s_dlog_ctx.ring != NULL) {
+        return ESP_OK;
+    }
+
+    deferred_log_record_t *ring = calloc(CONFIG_DEFERRED_LOG_RING_ENTRIES, sizeof(deferred_log_record_t));
+    if (ring == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate log ring");
+        return ESP_ERR_NO_MEM;
+    }
+
+    BaseType_t ret = xTaskCreate(deferred_log_task, "dlog_flush", DEFERRED_LOG_TASK_STACK_SIZE,
+                                 NULL, CONFIG_DEFERRED_LOG_TASK_PRIORITY, &s_dlog_ctx.task_handle);
+    if (ret != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create flush task");
+        free(ring);
+        return ESP_ERR_NO_MEM;
+    }
+
+    portENTER_CRITICAL(&s_dlog_spinlock);
+    s_dlog_ctx.ring = ring;
+    portEXIT_CRITICAL(&s_dlog_spinlock);
+
+    ESP_LOGI(TAG, "Deferred log initialized (%d entries, %d bytes)",
+             CONFIG_DEFERRED_LOG_RING_ENTRIES,
+             CONFIG_DEFERRED_LOG_RING_ENTRIES * (int)sizeof(deferred_log_record_t));
+
+    return ESP_OK;
+}
+
+void deferred_log_write(esp_log_level_t level, const char *tag, const char *format, ...)
+{
+    deferred_log_record_t record;
+    record.timestamp_ms = esp_log_timestamp();
+    record.tag = tag;
+    record.format = format;
+    record.level = (uint8_t)level;
+    record.reserved = 0;
+
+    va_list ap;
+    va_start(ap, format);
+    record.nargs = deferred_log_capture_args(format, ap, record.args);
+    va_end(ap);
+
+    bool stored = false;
+    bool wake = false;
+    TaskHandle_t task_handle;
+
+    portENTER_CRITICAL(&s_dlog_spinlock);
+    task_handle = s_dlog_ctx.task_handle;
+    if (s_dlog_ctx.ring != NULL) {
+        if (s_dlog_ctx.count < CONFIG_DEFERRED_LOG_RING_ENTRIES) {
+            s_dlog_ctx.ring[s_dlog_ctx.head] = record;
+            s_dlog_ctx.head = (s_dlog_ctx.head + 1) % CONFIG_DEFERRED_LOG_RING_ENTRIES;
+            s_dlog_ctx.count++;
+            wake = (s_dlog_ctx.count == CONFIG_DEFERRED_LOG_RING_ENTRIES / 2);
+        } else {
+            s_dlog_ctx.dropped++;
+        }
+        stored = true;
+    }
+    portEXIT_CRITICAL(&s_dlog_spinlock);
+
+    if (!stored) {
+        deferred_log_emit(&record);  // Not initialized yet - format synchronously
+    } else if (wake && task_handle != NULL) {
+        xTaskNotifyGive(task_handle);
+    }
+}
+
+void deferred_log_flush(void)
+{
+    deferred_log_record_t record;
+    while (deferred_log_pop(&record)) {
+        deferred_log_emit(&record);
+    }
+
+    uint32_t newly_dropped;
+    portENTER_CRITICAL(&s_dlog_spinlock);
+    newly_dropped = s_dlog_ctx.dropped - s_dlog_ctx.dropped_reported;
+    s_dlog_ctx.dropped_reported = s_dlog_ctx.dropped;
+    portEXIT_CRITICAL(&s_dlog_spinlock);
+
+    if (newly_dropped > 0) {
+        ESP_LOGW(TAG, "%" PRIu32 " log records dropped (ring full)", newly_dropped);
+    }
+}
+
+void deferred_log_set_sink(deferred_log_sink_t sink, void *user_ctx)
+{
+    portENTER_CRITICAL(&s_dlog_spinlock);
+    s_dlog_ctx.sink = sink;
+    s_dlog_ctx.sink_ctx = user_ctx;
+    portEXIT_CRITICAL(&s_dlog_spinlock);
+}
+
+uint32_t deferred_log_get_dropped(void)
+{
+    uint32_t dropped;
+
+    portENTER_CRITICAL(&s_dlog_spinlock);
+    dropped = s_dlog_ctx.dropped;
+    portEXIT_CRITICAL(&s_dlog_spinlock);
+
+    return dropped;
+}
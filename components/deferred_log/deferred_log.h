@@ -0,0 +1,131 @@
+/**
+ * @file deferred_log.h
+ * @brief Deferred Log Component - Binary log ring for hot paths
+ *
+ * DLOG_x() records the format string pointer and raw 32-bit arguments into
+ * a RAM ring instead of formatting them in place. A low-priority task
+ * formats and prints the records later, keeping printf/float formatting
+ * and UART waits out of control loops.
+ *
+ * Component Responsibilities:
+ * - Capture (format, args) records without formatting
+ * - Format and print records from a low-priority flush task
+ * - Forward formatted lines to an optional sink (e.g. MQTT batching)
+ *
+ * Usage restrictions:
+ * - Format strings and tags must be string literals (pointer is stored)
+ * - %s arguments must point to static storage
+ * - At most 6 arguments; 64-bit arguments are truncated to 32 bits
+ * - Not for ISR context
+ *
+ * Thread-Safety:
+ * - Ring access protected by spinlock (portMUX_TYPE)
+ * - Safe for concurrent calls from multiple tasks
+ *
+ * Configuration:
+ * - Ring size, flush interval and task priority via Kconfig
+ * - CONFIG_DEFERRED_LOG_ENABLE=n maps DLOG_x() to ESP_LOGx()
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef DEFERRED_LOG_H
+#define DEFERRED_LOG_H
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================ TYPES ============================ */
+
+/**
+ * @brief Sink for formatted log lines
+ *
+ * Called from the flush task after the line is printed.
+ *
+ * @param level Log level
+ * @param tag Log tag
+ * @param timestamp_ms Time the record was captured (ms since boot)
+ * @param message Formatted message (no prefix, no newline)
+ * @param user_ctx User context passed to deferred_log_set_sink()
+ */
+typedef void (*deferred_log_sink_t)(esp_log_level_t level, const char *tag,
+                                    uint32_t timestamp_ms, const char *message,
+                                    void *user_ctx);
+
+/* ============================ LOGGING MACROS ============================ */
+
+#if CONFIG_DEFERRED_LOG_ENABLE
+#define DLOG_LEVEL(level, tag, format, ...) do {                              \
+        if (LOG_LOCAL_LEVEL >= (level)) {                                     \
+            deferred_log_write((level), (tag), (format), ##__VA_ARGS__);      \
+        }                                                                     \
+    } while (0)
+#else
+#define DLOG_LEVEL(level, tag, format, ...) ESP_LOG_LEVEL_LOCAL(level, tag, format, ##__VA_ARGS__)
+#endif
+
+#define DLOG_E(tag, format, ...) DLOG_LEVEL(ESP_LOG_ERROR,   tag, format, ##__VA_ARGS__)
+#define DLOG_W(tag, format, ...) DLOG_LEVEL(ESP_LOG_WARN,    tag, format, ##__VA_ARGS__)
+#define DLOG_I(tag, format, ...) DLOG_LEVEL(ESP_LOG_INFO,    tag, format, ##__VA_ARGS__)
+#define DLOG_D(tag, format, ...) DLOG_LEVEL(ESP_LOG_DEBUG,   tag, format, ##__VA_ARGS__)
+#define DLOG_V(tag, format, ...) DLOG_LEVEL(ESP_LOG_VERBOSE, tag, format, ##__VA_ARGS__)
+
+/* ============================ PUBLIC API ============================ */
+
+/**
+ * @brief Initialize deferred log ring and start flush task
+ *
+ * Records written before init are formatted synchronously.
+ *
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if ring or task allocation fails
+ */
+esp_err_t deferred_log_init(void);
+
+/**
+ * @brief Record a log line without formatting it
+ *
+ * Use through DLOG_x() macros.
+ *
+ * @param level Log level
+ * @param tag Log tag (string literal)
+ * @param format printf-style format (string literal)
+ */
+void deferred_log_write(esp_log_level_t level, const char *tag, const char *format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+/**
+ * @brief Format and print all pending records from the calling task
+ *
+ * Call before esp_restart() or deep sleep so no records are lost.
+ */
+void deferred_log_flush(void);
+
+/**
+ * @brief Set sink receiving every formatted line
+ *
+ * @param sink Sink callback (NULL to remove)
+ * @param user_ctx User context passed to the sink
+ */
+void deferred_log_set_sink(deferred_log_sink_t sink, void *user_ctx);
+
+/**
+ * @brief Get number of records dropped because the ring was full
+ *
+ * @return Dropped record count since boot
+ */
+uint32_t deferred_log_get_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DEFERRED_LOG_H
@@ -42,6 +42,7 @@ static const char *TAG = "device_config";
 // Default values for sensors
 #define DEFAULT_SENSOR_COUNT        3       // 3 soil sensors
 #define DEFAULT_READING_INTERVAL    60      // 60 seconds
+#define DEFAULT_AMBIENT_SENSOR      AMBIENT_SENSOR_DHT22
 
 /* ============================ PRIVATE STATE ============================ */
 
@@ -786,8 +787,8 @@ esp_err_t device_config_get_soil_sensor_count(uint8_t* count)
 
 esp_err_t device_config_set_soil_sensor_count(uint8_t count)
 {
-    if (count < 1 || count > 3) {
-        ESP_LOGE(TAG, "Invalid sensor count: %d (must be 1-3)", count);
+    if (count < 1 || count > SOIL_MAX_SENSORS) {
+        ESP_LOGE(TAG, "Invalid sensor count: %d (must be 1-%d)", count, SOIL_MAX_SENSORS);
         return ESP_ERR_INVALID_ARG;
     }
 
@@ -865,6 +866,61 @@ esp_err_t device_config_set_reading_interval(uint16_t interval)
     return ret;
 }
 
+esp_err_t device_config_get_ambient_sensor(ambient_sensor_type_t* type)
+{
+    if (type == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!s_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (!take_mutex(pdMS_TO_TICKS(1000))) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    uint8_t value = DEFAULT_AMBIENT_SENSOR;
+    esp_err_t ret = nvs_get_u8(s_nvs_handle, DEVICE_CONFIG_NVS_KEY_AMBIENT, &value);
+
+    if (ret == ESP_ERR_NVS_NOT_FOUND || (ret == ESP_OK && value >= AMBIENT_SENSOR_MAX)) {
+        value = DEFAULT_AMBIENT_SENSOR;
+        ret = ESP_OK;
+    }
+    *type = (ambient_sensor_type_t)value;
+
+    give_mutex();
+    return ret;
+}
+
+esp_err_t device_config_set_ambient_sensor(ambient_sensor_type_t type)
+{
+    if (type >= AMBIENT_SENSOR_MAX) {
+        ESP_LOGE(TAG, "Invalid ambient sensor: %d", type);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!s_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (!take_mutex(pdMS_TO_TICKS(1000))) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    esp_err_t ret = nvs_set_u8(s_nvs_handle, DEVICE_CONFIG_NVS_KEY_AMBIENT, (uint8_t)type);
+
+    if (ret == ESP_OK) {
+        ret = nvs_commit(s_nvs_handle);
+        if (ret == ESP_OK) {
+            ESP_LOGI(TAG, "Ambient sensor saved: %d (applies after reboot)", type);
+        }
+    }
+
+    give_mutex();
+    return ret;
+}
+
 /* ============================ SYSTEM MANAGEMENT ============================ */
 
 esp_err_t device_config_load(config_category_t category)
@@ -943,6 +999,7 @@ esp_err_t device_config_reset(config_category_t category)
         case CONFIG_CATEGORY_SENSOR:
             nvs_erase_key(s_nvs_handle, DEVICE_CONFIG_NVS_KEY_SENSOR_COUNT);
             nvs_erase_key(s_nvs_handle, DEVICE_CONFIG_NVS_KEY_READ_INTERVAL);
+            nvs_erase_key(s_nvs_handle, DEVICE_CONFIG_NVS_KEY_AMBIENT);
             ESP_LOGI(TAG, "Sensor config reset to defaults");
             break;
 
@@ -344,7 +344,7 @@ esp_err_t device_config_get_soil_sensor_count(uint8_t* count);
 /**
  * @brief Set number of soil sensors
  *
- * @param count Sensor count (1-3)
+ * @param count Sensor count (1-3 direct ADC, up to SOIL_MAX_SENSORS behind a mux)
  * @return ESP_OK on success
  */
 esp_err_t device_config_set_soil_sensor_count(uint8_t count);
@@ -365,6 +365,24 @@ esp_err_t device_config_get_reading_interval(uint16_t* interval);
  */
 esp_err_t device_config_set_reading_interval(uint16_t interval);
 
+/**
+ * @brief Get ambient sensor model
+ *
+ * Read by main before sensor_reader_init(); changes apply after reboot.
+ *
+ * @param[out] type Pointer to store the sensor model
+ * @return ESP_OK on success
+ */
+esp_err_t device_config_get_ambient_sensor(ambient_sensor_type_t* type);
+
+/**
+ * @brief Set ambient sensor model
+ *
+ * @param type Sensor model (DHT22, SHT3x or BME280)
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if unknown
+ */
+esp_err_t device_config_set_ambient_sensor(ambient_sensor_type_t type);
+
 /* ============================ CONFIGURATION ============================ */
 
 /**
@@ -436,6 +454,7 @@ esp_err_t device_config_set_reading_interval(uint16_t interval);
  */
 #define DEVICE_CONFIG_NVS_KEY_SENSOR_COUNT  "sensor_cnt"
 #define DEVICE_CONFIG_NVS_KEY_READ_INTERVAL "read_intv"
+#define DEVICE_CONFIG_NVS_KEY_AMBIENT     "amb_sensor"
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,263 @@
+/**
+ * @file event_bus.c
+ * @brief Event Bus Component - Typed internal publish/subscribe
+ *
+ * Subscriber queues carry 1-byte pool indices, not event copies. A record
+ * holds one reference per queued delivery plus one for the poster while it
+ * fans out; dispatch tasks copy the record and release it before calling
+ * the handler, so slow handlers do not pin pool slots.
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "event_bus.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/portmacro.h"
+#include <string.h>
+#include <inttypes.h>
+
+/* ============================ CONFIGURATION ============================ */
+
+#ifndef CONFIG_EVENT_BUS_POOL_SIZE
+#define CONFIG_EVENT_BUS_POOL_SIZE 16
+#endif
+
+#ifndef CONFIG_EVENT_BUS_MAX_SUBSCRIBERS
+#define CONFIG_EVENT_BUS_MAX_SUBSCRIBERS 8
+#endif
+
+#ifndef CONFIG_EVENT_BUS_QUEUE_LEN
+#define CONFIG_EVENT_BUS_QUEUE_LEN 8
+#endif
+
+_Static_assert(EVENT_BUS_EVENT_MAX <= 32, "event_bus masks are 32-bit");
+
+/* ============================ PRIVATE STATE ============================ */
+
+static const char *TAG = "event_bus";
+
+typedef struct {
+    const char *name;
+    uint32_t event_mask;
+    event_bus_handler_t handler;
+    void *user_ctx;
+    QueueHandle_t queue;                ///< NULL = slot free
+    uint32_t dropped;
+    bool active;                        ///< Dispatch task running, receives posts
+} event_bus_subscriber_t;
+
+typedef struct {
+    event_bus_event_t pool[CONFIG_EVENT_BUS_POOL_SIZE];
+    uint8_t refcount[CONFIG_EVENT_BUS_POOL_SIZE];
+    event_bus_subscriber_t subscribers[CONFIG_EVENT_BUS_MAX_SUBSCRIBERS];
+    uint8_t subscriber_count;           ///< Slots reserved so far (high-water mark)
+    uint32_t posted;
+    uint32_t pool_exhausted;
+} event_bus_context_t;
+
+static event_bus_context_t s_bus = {0};
+static portMUX_TYPE s_bus_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+/* ============================ PRIVATE FUNCTIONS ============================ */
+
+static void event_bus_release(uint8_t slot)
+{
+    portENTER_CRITICAL(&s_bus_spinlock);
+    if (s_bus.refcount[slot] > 0) {
+        s_bus.refcount[slot]--;
+    }
+    portEXIT_CRITICAL(&s_bus_spinlock);
+}
+
+static void event_bus_dispatch_task(void *param)
+{
+    event_bus_subscriber_t *subscriber = (event_bus_subscriber_t *)param;
+    uint8_t slot;
+
+    while (1) {
+        if (xQueueReceive(subscriber->queue, &slot, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        // Records are immutable while referenced - copy out and release early
+        event_bus_event_t event = s_bus.pool[slot];
+        event_bus_release(slot);
+
+        subscriber->handler(&event, subscriber->user_ctx);
+    }
+}
+
+/* ============================ PUBLIC API ============================ */
+
+esp_err_t event_bus_subscribe(const event_bus_subscriber_config_t *config)
+{
+    if (config == NULL || config->handler == NULL || config->name == NULL ||
+        config->event_mask == 0 || config->stack_size == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint8_t queue_len = (config->queue_len > 0) ? config->queue_len : CONFIG_EVENT_BUS_QUEUE_LEN;
+    QueueHandle_t queue = xQueueCreate(queue_len, sizeof(uint8_t));
+    if (queue == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Reserve a slot (one freed by a failed subscribe, or the next one) so
+    // concurrent subscribers never share it
+    event_bus_subscriber_t *subscriber = NULL;
+    portENTER_CRITICAL(&s_bus_spinlock);
+    for (uint8_t i = 0; i < s_bus.subscriber_count; i++) {
+        if (s_bus.subscribers[i].queue == NULL) {
+            subscriber = &s_bus.subscribers[i];
+            break;
+        }
+    }
+    if (subscriber == NULL && s_bus.subscriber_count < CONFIG_EVENT_BUS_MAX_SUBSCRIBERS) {
+        subscriber = &s_bus.subscribers[s_bus.subscriber_count++];
+    }
+    if (subscriber != NULL) {
+        subscriber->name = config->name;
+        subscriber->event_mask = config->event_mask;
+        subscriber->handler = config->handler;
+        subscriber->user_ctx = config->user_ctx;
+        subscriber->queue = queue;
+        subscriber->dropped = 0;
+        subscriber->active = false;
+    }
+    portEXIT_CRITICAL(&s_bus_spinlock);
+
+    if (subscriber == NULL) {
+        vQueueDelete(queue);
+        ESP_LOGE(TAG, "Subscriber table full, cannot add '%s'", config->name);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Task must exist before the entry becomes visible to posters
+    BaseType_t ret = xTaskCreate(event_bus_dispatch_task, config->name, config->stack_size,
+                                 subscriber, config->priority, NULL);
+
+    portENTER_CRITICAL(&s_bus_spinlock);
+    if (ret == pdPASS) {
+        subscriber->active = true;
+    } else {
+        // Roll back the reservation
+        subscriber->queue = NULL;
+        if (subscriber == &s_bus.subscribers[s_bus.subscriber_count - 1]) {
+            s_bus.subscriber_count--;
+        }
+    }
+    portEXIT_CRITICAL(&s_bus_spinlock);
+
+    if (ret != pdPASS) {
+        vQueueDelete(queue);
+        ESP_LOGE(TAG, "Failed to create dispatch task for '%s'", config->name);
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGD(TAG, "Subscriber '%s' registered (mask 0x%08" PRIx32 ", queue %d)",
+             config->name, config->event_mask, queue_len);
+
+    return ESP_OK;
+}
+
+esp_err_t event_bus_post(event_bus_event_id_t id, const event_bus_data_t *data)
+{
+    if (id >= EVENT_BUS_EVENT_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint32_t mask = EVENT_BUS_MASK(id);
+    int slot = -1;
+    uint8_t subscriber_count;
+
+    portENTER_CRITICAL(&s_bus_spinlock);
+    subscriber_count = s_bus.subscriber_count;
+    for (int i = 0; i < CONFIG_EVENT_BUS_POOL_SIZE; i++) {
+        if (s_bus.refcount[i] == 0) {
+            slot = i;
+            s_bus.refcount[i] = 1;  // Poster reference held during fan-out
+            break;
+        }
+    }
+    if (slot < 0) {
+        s_bus.pool_exhausted++;
+    }
+    portEXIT_CRITICAL(&s_bus_spinlock);
+
+    if (slot < 0) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    event_bus_event_t *event = &s_bus.pool[slot];
+    event->id = id;
+    event->timestamp_ms = (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+    if (data != NULL) {
+        event->data = *data;
+    } else {
+        memset(&event->data, 0, sizeof(event->data));
+    }
+
+    for (uint8_t i = 0; i < subscriber_count; i++) {
+        event_bus_subscriber_t *subscriber = &s_bus.subscribers[i];
+        bool deliver;
+
+        // Reserved slots are skipped until their dispatch task runs
+        portENTER_CRITICAL(&s_bus_spinlock);
+        deliver = subscriber->active && (subscriber->event_mask & mask) != 0;
+        if (deliver) {
+            s_bus.refcount[slot]++;
+        }
+        portEXIT_CRITICAL(&s_bus_spinlock);
+
+        if (!deliver) {
+            continue;
+        }
+
+        uint8_t index = (uint8_t)slot;
+        if (xQueueSend(subscriber->queue, &index, 0) != pdTRUE) {
+            portENTER_CRITICAL(&s_bus_spinlock);
+            s_bus.refcount[slot]--;
+            subscriber->dropped++;
+            portEXIT_CRITICAL(&s_bus_spinlock);
+        }
+    }
+
+    portENTER_CRITICAL(&s_bus_spinlock);
+    s_bus.posted++;
+    portEXIT_CRITICAL(&s_bus_spinlock);
+    event_bus_release((uint8_t)slot);
+
+    return ESP_OK;
+}
+
+esp_err_t event_bus_get_stats(event_bus_stats_t *stats)
+{
+    if (stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(stats, 0, sizeof(event_bus_stats_t));
+
+    portENTER_CRITICAL(&s_bus_spinlock);
+    stats->posted = s_bus.posted;
+    stats->pool_exhausted = s_bus.pool_exhausted;
+    for (uint8_t i = 0; i < s_bus.subscriber_count; i++) {
+        if (s_bus.subscribers[i].active) {
+            stats->subscriber_count++;
+            stats->subscriber_drops += s_bus.subscribers[i].dropped;
+        }
+    }
+    for (int i = 0; i < CONFIG_EVENT_BUS_POOL_SIZE; i++) {
+        if (s_bus.refcount[i] > 0) {
+            stats->pool_in_use++;
+        }
+    }
+    portEXIT_CRITICAL(&s_bus_spinlock);
+
+    return ESP_OK;
+}
@@ -0,0 +1,171 @@
+/**
+ * @file event_bus.h
+ * @brief Event Bus Component - Typed internal publish/subscribe
+ *
+ * Lightweight replacement for component-to-component esp_event posts.
+ * Events are fixed-size records taken from a static pool; each subscriber
+ * has its own queue and dispatch task, so a slow subscriber never blocks
+ * the producer or other subscribers.
+ *
+ * Component Responsibilities:
+ * - Static subscriber table with per-subscriber event masks
+ * - Pre-allocated, reference-counted event records
+ * - Non-blocking post with per-subscriber drop accounting
+ *
+ * Thread-Safety:
+ * - Pool and subscriber table protected by spinlock (portMUX_TYPE)
+ * - event_bus_post() never blocks; not callable from ISR
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================ EVENT IDS ============================ */
+
+/**
+ * @brief Event identifiers (max 32, one bit each in subscriber masks)
+ */
+typedef enum {
+    // Connectivity (wifi_manager)
+    EVENT_BUS_WIFI_INIT_COMPLETE = 0,       ///< WiFi manager initialized
+    EVENT_BUS_WIFI_PROVISIONING_STARTED,    ///< Provisioning portal started
+    EVENT_BUS_WIFI_PROVISIONING_COMPLETED,  ///< Credentials stored
+    EVENT_BUS_WIFI_CONNECTED,               ///< Associated with AP
+    EVENT_BUS_WIFI_DISCONNECTED,            ///< Link lost
+    EVENT_BUS_WIFI_IP_OBTAINED,             ///< Data: ip_addr
+    EVENT_BUS_WIFI_CONNECTION_FAILED,       ///< Retries exhausted
+    EVENT_BUS_WIFI_RESET_REQUESTED,         ///< Factory reset boot pattern
+
+    // Connectivity (mqtt_client)
+    EVENT_BUS_MQTT_CONNECTED,               ///< Connected to broker
+    EVENT_BUS_MQTT_DISCONNECTED,            ///< Disconnected from broker
+
+    // Sensors and irrigation
+    EVENT_BUS_SENSOR_SAMPLE,                ///< Data: sensor
+    EVENT_BUS_IRRIGATION_STATE_CHANGED,     ///< Data: irrigation
+
+    EVENT_BUS_EVENT_MAX
+} event_bus_event_id_t;
+
+#define EVENT_BUS_MASK(id)             (1UL << (id))
+#define EVENT_BUS_MASK_ALL             ((1UL << EVENT_BUS_EVENT_MAX) - 1)
+#define EVENT_BUS_MASK_WIFI            (EVENT_BUS_MASK(EVENT_BUS_WIFI_INIT_COMPLETE) | \
+                                        EVENT_BUS_MASK(EVENT_BUS_WIFI_PROVISIONING_STARTED) | \
+                                        EVENT_BUS_MASK(EVENT_BUS_WIFI_PROVISIONING_COMPLETED) | \
+                                        EVENT_BUS_MASK(EVENT_BUS_WIFI_CONNECTED) | \
+                                        EVENT_BUS_MASK(EVENT_BUS_WIFI_DISCONNECTED) | \
+                                        EVENT_BUS_MASK(EVENT_BUS_WIFI_IP_OBTAINED) | \
+                                        EVENT_BUS_MASK(EVENT_BUS_WIFI_CONNECTION_FAILED) | \
+                                        EVENT_BUS_MASK(EVENT_BUS_WIFI_RESET_REQUESTED))
+
+/* ============================ TYPES ============================ */
+
+/**
+ * @brief Event payload (16 bytes, interpretation depends on event id)
+ */
+typedef union {
+    uint32_t ip_addr;               ///< EVENT_BUS_WIFI_IP_OBTAINED: esp_ip4_addr_t.addr
+    struct {
+        float soil_avg;             ///< Average soil humidity %
+        float temperature;          ///< Ambient temperature °C
+        float humidity;             ///< Ambient humidity %
+        uint32_t timestamp;         ///< Reading timestamp (see time_quality_t)
+    } sensor;                       ///< EVENT_BUS_SENSOR_SAMPLE
+    struct {
+        uint8_t state;              ///< New irrigation_state_t
+        uint8_t previous_state;     ///< Previous irrigation_state_t
+        uint8_t mode;               ///< irrigation_mode_t
+        uint8_t valve_open;         ///< 1 if valve open
+    } irrigation;                   ///< EVENT_BUS_IRRIGATION_STATE_CHANGED
+    uint8_t raw[16];
+} event_bus_data_t;
+
+/**
+ * @brief Event record delivered to subscribers
+ */
+typedef struct {
+    event_bus_event_id_t id;        ///< Event identifier
+    uint32_t timestamp_ms;          ///< Post time (ms since boot)
+    event_bus_data_t data;          ///< Payload
+} event_bus_event_t;
+
+/**
+ * @brief Subscriber handler, runs in the subscriber's dispatch task
+ *
+ * @param event Event copy (valid for the duration of the call)
+ * @param user_ctx User context from subscriber config
+ */
+typedef void (*event_bus_handler_t)(const event_bus_event_t *event, void *user_ctx);
+
+/**
+ * @brief Subscriber configuration
+ */
+typedef struct {
+    const char *name;               ///< Task name (string literal)
+    uint32_t event_mask;            ///< EVENT_BUS_MASK() bits of wanted events
+    event_bus_handler_t handler;    ///< Handler callback
+    void *user_ctx;                 ///< Passed to handler
+    uint32_t stack_size;            ///< Dispatch task stack (bytes)
+    uint8_t priority;               ///< Dispatch task priority
+    uint8_t queue_len;              ///< Queue length (0 = CONFIG_EVENT_BUS_QUEUE_LEN)
+} event_bus_subscriber_config_t;
+
+/**
+ * @brief Bus statistics
+ */
+typedef struct {
+    uint32_t posted;                ///< Successful posts
+    uint32_t pool_exhausted;        ///< Posts dropped because the pool was empty
+    uint32_t subscriber_drops;      ///< Deliveries dropped on full subscriber queues
+    uint8_t pool_in_use;            ///< Records currently referenced
+    uint8_t subscriber_count;       ///< Registered subscribers
+} event_bus_stats_t;
+
+/* ============================ PUBLIC API ============================ */
+
+/**
+ * @brief Register a subscriber and start its dispatch task
+ *
+ * Subscribers cannot be removed; register them once at startup from
+ * component init functions (calls must not run concurrently).
+ *
+ * @param config Subscriber configuration
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if table full or allocation failed,
+ *         ESP_ERR_INVALID_ARG if config invalid
+ */
+esp_err_t event_bus_subscribe(const event_bus_subscriber_config_t *config);
+
+/**
+ * @brief Post an event without blocking
+ *
+ * @param id Event identifier
+ * @param data Payload (NULL for none)
+ * @return ESP_OK if queued (or no subscriber wants it), ESP_ERR_NO_MEM if pool empty
+ */
+esp_err_t event_bus_post(event_bus_event_id_t id, const event_bus_data_t *data);
+
+/**
+ * @brief Get bus statistics
+ *
+ * @param[out] stats Statistics structure
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if stats is NULL
+ */
+esp_err_t event_bus_get_stats(event_bus_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EVENT_BUS_H
@@ -0,0 +1,303 @@
+/**
+ * @file footprint_audit.c
+ * @brief Footprint Audit Component - Task stack and RAM usage report
+ *
+ * Stack usage comes from uxTaskGetStackHighWaterMark() (bytes on ESP-IDF),
+ * so no trace facility is needed. Heap scopes use the local minimum-free
+ * monitor of heap_caps: the peak of a scope is the free size at begin minus
+ * the lowest free size seen until end, including transient buffers that
+ * were already released.
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "footprint_audit.h"
+#include "sdkconfig.h"
+
+#if CONFIG_FOOTPRINT_AUDIT_ENABLE
+
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/portmacro.h"
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+/* ============================ CONFIGURATION ============================ */
+
+#ifndef CONFIG_FOOTPRINT_AUDIT_INTERVAL_S
+#define CONFIG_FOOTPRINT_AUDIT_INTERVAL_S 300
+#endif
+
+#ifndef CONFIG_FOOTPRINT_AUDIT_STACK_MARGIN
+#define CONFIG_FOOTPRINT_AUDIT_STACK_MARGIN 512
+#endif
+
+#ifndef CONFIG_FOOTPRINT_AUDIT_MAX_TASKS
+#define CONFIG_FOOTPRINT_AUDIT_MAX_TASKS 16
+#endif
+
+#define FOOTPRINT_AUDIT_MAX_SCOPES       12
+#define FOOTPRINT_AUDIT_TASK_STACK_SIZE  3072
+#define FOOTPRINT_AUDIT_TASK_PRIORITY    1
+#define FOOTPRINT_AUDIT_STACK_ROUNDING   256
+#define FOOTPRINT_AUDIT_HEAP_CAPS        MALLOC_CAP_INTERNAL
+
+/* Linker symbols delimiting the DRAM data and bss sections */
+extern int _data_start, _data_end;
+extern int _bss_start, _bss_end;
+
+/* ============================ PRIVATE STATE ============================ */
+
+static const char *TAG = "footprint_audit";
+
+typedef struct {
+    char name[configMAX_TASK_NAME_LEN];
+    uint32_t configured_stack;
+} footprint_task_entry_t;
+
+typedef struct {
+    const char *name;
+    uint32_t free_before;           ///< Internal heap free at begin
+    uint32_t free_after;            ///< Internal heap free at end
+    uint32_t min_free;              ///< Lowest internal heap free within scope
+} footprint_heap_scope_t;
+
+typedef struct {
+    footprint_task_entry_t tasks[CONFIG_FOOTPRINT_AUDIT_MAX_TASKS];
+    uint8_t task_count;
+    footprint_heap_scope_t scopes[FOOTPRINT_AUDIT_MAX_SCOPES];
+    uint8_t scope_count;
+    bool scope_active;
+    TaskHandle_t task_handle;
+} footprint_audit_context_t;
+
+static footprint_audit_context_t s_audit_ctx = {0};
+
+static portMUX_TYPE s_audit_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+/* ============================ PRIVATE FUNCTIONS ============================ */
+
+static uint32_t footprint_round_up(uint32_t value, uint32_t step)
+{
+    return ((value + step - 1) / step) * step;
+}
+
+static void footprint_report_tasks(void)
+{
+    footprint_task_entry_t tasks[CONFIG_FOOTPRINT_AUDIT_MAX_TASKS];
+    uint8_t count;
+
+    portENTER_CRITICAL(&s_audit_spinlock);
+    count = s_audit_ctx.task_count;
+    memcpy(tasks, s_audit_ctx.tasks, count * sizeof(footprint_task_entry_t));
+    portEXIT_CRITICAL(&s_audit_spinlock);
+
+    ESP_LOGI(TAG, "%-16s %7s %7s %7s %7s", "task", "stack", "used", "free", "suggest");
+
+    for (uint8_t i = 0; i < count; i++) {
+        TaskHandle_t handle = xTaskGetHandle(tasks[i].name);
+        if (handle == NULL) {
+            ESP_LOGI(TAG, "%-16s %7" PRIu32 "   (not running)", tasks[i].name, tasks[i].configured_stack);
+            continue;
+        }
+
+        uint32_t free_min = (uint32_t)uxTaskGetStackHighWaterMark(handle);
+        uint32_t used = (free_min < tasks[i].configured_stack) ? tasks[i].configured_stack - free_min : 0;
+        uint32_t suggest = footprint_round_up(used + CONFIG_FOOTPRINT_AUDIT_STACK_MARGIN,
+                                              FOOTPRINT_AUDIT_STACK_ROUNDING);
+
+        if (free_min < CONFIG_FOOTPRINT_AUDIT_STACK_MARGIN) {
+            ESP_LOGW(TAG, "%-16s %7" PRIu32 " %7" PRIu32 " %7" PRIu32 " %7" PRIu32 "  LOW",
+                     tasks[i].name, tasks[i].configured_stack, used, free_min, suggest);
+        } else {
+            ESP_LOGI(TAG, "%-16s %7" PRIu32 " %7" PRIu32 " %7" PRIu32 " %7" PRIu32,
+                     tasks[i].name, tasks[i].configured_stack, used, free_min, suggest);
+        }
+    }
+}
+
+static void footprint_report_heap_scopes(void)
+{
+    footprint_heap_scope_t scopes[FOOTPRINT_AUDIT_MAX_SCOPES];
+    uint8_t count;
+
+    portENTER_CRITICAL(&s_audit_spinlock);
+    count = s_audit_ctx.scope_count;
+    memcpy(scopes, s_audit_ctx.scopes, count * sizeof(footprint_heap_scope_t));
+    portEXIT_CRITICAL(&s_audit_spinlock);
+
+    if (count == 0) {
+        return;
+    }
+
+    ESP_LOGI(TAG, "%-16s %8s %9s", "subsystem", "peak", "retained");
+    for (uint8_t i = 0; i < count; i++) {
+        int32_t retained = (int32_t)scopes[i].free_before - (int32_t)scopes[i].free_after;
+        ESP_LOGI(TAG, "%-16s %8" PRIu32 " %9" PRId32,
+                 scopes[i].name, scopes[i].free_before - scopes[i].min_free, retained);
+    }
+}
+
+static void footprint_audit_task(void *param)
+{
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(CONFIG_FOOTPRINT_AUDIT_INTERVAL_S * 1000UL));
+        footprint_audit_report();
+    }
+}
+
+/* ============================ PUBLIC API ============================ */
+
+esp_err_t footprint_audit_init(void)
+{
+    if (s_audit_ctx.task_handle != NULL) {
+        return ESP_OK;
+    }
+
+    BaseType_t ret = xTaskCreate(footprint_audit_task, "fp_audit", FOOTPRINT_AUDIT_TASK_STACK_SIZE,
+                                 NULL, FOOTPRINT_AUDIT_TASK_PRIORITY, &s_audit_ctx.task_handle);
+    if (ret != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create report task");
+        return ESP_ERR_NO_MEM;
+    }
+
+    footprint_audit_register_task("fp_audit", FOOTPRINT_AUDIT_TASK_STACK_SIZE);
+
+    ESP_LOGI(TAG, "Footprint audit enabled (report every %d s)", CONFIG_FOOTPRINT_AUDIT_INTERVAL_S);
+    return ESP_OK;
+}
+
+esp_err_t footprint_audit_register_task(const char *name, uint32_t configured_stack)
+{
+    if (name == NULL || configured_stack == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = ESP_OK;
+
+    portENTER_CRITICAL(&s_audit_spinlock);
+    if (s_audit_ctx.task_count >= CONFIG_FOOTPRINT_AUDIT_MAX_TASKS) {
+        ret = ESP_ERR_NO_MEM;
+    } else {
+        footprint_task_entry_t *entry = &s_audit_ctx.tasks[s_audit_ctx.task_count++];
+        strncpy(entry->name, name, sizeof(entry->name) - 1);
+        entry->name[sizeof(entry->name) - 1] = '\0';
+        entry->configured_stack = configured_stack;
+    }
+    portEXIT_CRITICAL(&s_audit_spinlock);
+
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Task table full, '%s' not registered", name);
+    }
+    return ret;
+}
+
+esp_err_t footprint_audit_heap_begin(const char *subsystem)
+{
+    if (subsystem == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint32_t free_before = heap_caps_get_free_size(FOOTPRINT_AUDIT_HEAP_CAPS);
+    esp_err_t ret = ESP_OK;
+
+    portENTER_CRITICAL(&s_audit_spinlock);
+    if (s_audit_ctx.scope_active) {
+        ret = ESP_ERR_INVALID_STATE;
+    } else if (s_audit_ctx.scope_count >= FOOTPRINT_AUDIT_MAX_SCOPES) {
+        ret = ESP_ERR_NO_MEM;
+    } else {
+        footprint_heap_scope_t *scope = &s_audit_ctx.scopes[s_audit_ctx.scope_count];
+        scope->name = subsystem;
+        scope->free_before = free_before;
+        scope->free_after = free_before;
+        scope->min_free = free_before;
+        s_audit_ctx.scope_active = true;
+    }
+    portEXIT_CRITICAL(&s_audit_spinlock);
+
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Heap scope '%s' not recorded: %s", subsystem, esp_err_to_name(ret));
+        return ret;
+    }
+
+    return heap_caps_monitor_local_minimum_free_size_start();
+}
+
+esp_err_t footprint_audit_heap_end(void)
+{
+    uint32_t min_free = heap_caps_get_minimum_free_size(FOOTPRINT_AUDIT_HEAP_CAPS);
+    heap_caps_monitor_local_minimum_free_size_stop();
+    uint32_t free_after = heap_caps_get_free_size(FOOTPRINT_AUDIT_HEAP_CAPS);
+    esp_err_t ret = ESP_OK;
+
+    portENTER_CRITICAL(&s_audit_spinlock);
+    if (!s_audit_ctx.scope_active) {
+        ret = ESP_ERR_INVALID_STATE;
+    } else {
+        footprint_heap_scope_t *scope = &s_audit_ctx.scopes[s_audit_ctx.scope_count++];
+        scope->free_after = free_after;
+        if (min_free < scope->min_free) {
+            scope->min_free = min_free;
+        }
+        s_audit_ctx.scope_active = false;
+    }
+    portEXIT_CRITICAL(&s_audit_spinlock);
+
+    return ret;
+}
+
+void footprint_audit_report(void)
+{
+    uint32_t data_size = (uint32_t)((uintptr_t)&_data_end - (uintptr_t)&_data_start);
+    uint32_t bss_size = (uint32_t)((uintptr_t)&_bss_end - (uintptr_t)&_bss_start);
+
+    ESP_LOGI(TAG, "==== Footprint report (uptime %" PRIu32 " s) ====",
+             (uint32_t)(esp_timer_get_time() / 1000000));
+    ESP_LOGI(TAG, "Static RAM: .data %" PRIu32 " B, .bss %" PRIu32 " B (per component: idf.py size-components)",
+             data_size, bss_size);
+    ESP_LOGI(TAG, "Internal heap: free %u B, min ever %u B, largest block %u B",
+             (unsigned)heap_caps_get_free_size(FOOTPRINT_AUDIT_HEAP_CAPS),
+             (unsigned)heap_caps_get_minimum_free_size(FOOTPRINT_AUDIT_HEAP_CAPS),
+             (unsigned)heap_caps_get_largest_free_block(FOOTPRINT_AUDIT_HEAP_CAPS));
+
+    footprint_report_tasks();
+    footprint_report_heap_scopes();
+}
+
+#else /* !CONFIG_FOOTPRINT_AUDIT_ENABLE */
+
+esp_err_t footprint_audit_init(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t footprint_audit_register_task(const char *name, uint32_t configured_stack)
+{
+    (void)name;
+    (void)configured_stack;
+    return ESP_OK;
+}
+
+esp_err_t footprint_audit_heap_begin(const char *subsystem)
+{
+    (void)subsystem;
+    return ESP_OK;
+}
+
+esp_err_t footprint_audit_heap_end(void)
+{
+    return ESP_OK;
+}
+
+void footprint_audit_report(void)
+{
+}
+
+#endif /* CONFIG_FOOTPRINT_AUDIT_ENABLE */
@@ -0,0 +1,88 @@
+/**
+ * @file footprint_audit.h
+ * @brief Footprint Audit Component - Task stack and RAM usage report
+ *
+ * Sizing aid for shrinking stacks and freeing RAM. Tasks are registered by
+ * name with the stack size they were created with; subsystem initialization
+ * can be wrapped in heap scopes to capture its peak internal heap use.
+ *
+ * Component Responsibilities:
+ * - Report configured stack vs. high-water mark for registered tasks
+ * - Report static RAM (.data/.bss) and internal heap watermarks
+ * - Record peak and retained heap per subsystem init scope
+ *
+ * Thread-Safety:
+ * - Registration and scopes protected by spinlock (portMUX_TYPE)
+ * - Heap scopes must not nest or overlap (one global monitor)
+ *
+ * Configuration:
+ * - CONFIG_FOOTPRINT_AUDIT_ENABLE=n compiles the API to no-ops
+ * - Static RAM per component: idf.py size-components (build time)
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef FOOTPRINT_AUDIT_H
+#define FOOTPRINT_AUDIT_H
+
+#include "esp_err.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================ PUBLIC API ============================ */
+
+/**
+ * @brief Start the periodic report task
+ *
+ * @return ESP_OK on success (or when the audit is disabled)
+ * @return ESP_ERR_NO_MEM if the report task cannot be created
+ */
+esp_err_t footprint_audit_init(void);
+
+/**
+ * @brief Register a task for stack reporting
+ *
+ * The task is looked up by name at report time, so it may be registered
+ * before it is created and may come and go (e.g. the OTA task).
+ *
+ * @param name FreeRTOS task name
+ * @param configured_stack Stack size the task is created with (bytes)
+ * @return ESP_OK on success
+ * @return ESP_ERR_INVALID_ARG if name is NULL or configured_stack is 0
+ * @return ESP_ERR_NO_MEM if the task table is full
+ */
+esp_err_t footprint_audit_register_task(const char *name, uint32_t configured_stack);
+
+/**
+ * @brief Begin a heap scope (subsystem initialization)
+ *
+ * @param subsystem Scope name (must be a string literal)
+ * @return ESP_OK on success
+ * @return ESP_ERR_INVALID_STATE if another scope is active
+ * @return ESP_ERR_NO_MEM if the scope table is full
+ */
+esp_err_t footprint_audit_heap_begin(const char *subsystem);
+
+/**
+ * @brief End the active heap scope and record its peak and retained heap
+ *
+ * @return ESP_OK on success
+ * @return ESP_ERR_INVALID_STATE if no scope is active
+ */
+esp_err_t footprint_audit_heap_end(void);
+
+/**
+ * @brief Log the footprint report now
+ */
+void footprint_audit_report(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FOOTPRINT_AUDIT_H
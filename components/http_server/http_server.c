@@ -16,8 +16,12 @@
 
 #include "http_server.h"
 #include "sensor_reader.h"
+#include "sensor_scheduler.h"
 #include "device_config.h"
 #include "wifi_manager.h"
+#include "decision_log.h"
+#include "payload_cache.h"
+#include "metrics.h"
 
 // ESP-IDF includes
 #include "esp_log.h"
@@ -31,6 +35,7 @@
 
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 /* ========================== CONSTANTS AND MACROS ========================== */
 
@@ -61,15 +66,36 @@ typedef struct {
     // Configuration
     http_server_config_t config;
 
-    // Statistics
-    http_request_stats_t stats;
-
 } http_server_context_t;
 
 /* ========================== GLOBAL STATE ========================== */
 
 static http_server_context_t s_http_ctx = {0};
 
+// Outside s_http_ctx: init clears the context, the provider is set by the app
+static http_irrigation_status_provider_t s_status_provider = NULL;
+static void* s_status_provider_data = NULL;
+
+// Request statistics (metrics registry, updated lock-free from the httpd task)
+#define HTTP_REQUESTS_METRIC(endpoint_) \
+    METRICS_COUNTER_INIT("http_requests", "HTTP requests by endpoint", "endpoint=\"" endpoint_ "\"")
+
+static metrics_counter_t s_http_requests[HTTP_ENDPOINT_COUNT] = {
+    [HTTP_ENDPOINT_WHOAMI]     = HTTP_REQUESTS_METRIC("whoami"),
+    [HTTP_ENDPOINT_SENSORS]    = HTTP_REQUESTS_METRIC("sensors"),
+    [HTTP_ENDPOINT_PING]       = HTTP_REQUESTS_METRIC("ping"),
+    [HTTP_ENDPOINT_STATUS]     = HTTP_REQUESTS_METRIC("status"),
+    [HTTP_ENDPOINT_IRRIGATION] = HTTP_REQUESTS_METRIC("irrigation"),
+    [HTTP_ENDPOINT_CONFIG]     = HTTP_REQUESTS_METRIC("config"),
+    [HTTP_ENDPOINT_EVENTS]     = HTTP_REQUESTS_METRIC("events"),
+    [HTTP_ENDPOINT_METRICS]    = HTTP_REQUESTS_METRIC("metrics"),
+};
+static metrics_counter_t s_http_errors = METRICS_COUNTER_INIT(
+    "http_errors", "HTTP requests answered with an error (incl. 404)", NULL);
+
+// GET /metrics output chunk (handlers run on the single httpd task)
+static char s_metrics_chunk[METRICS_EXPORT_CHUNK_SIZE];
+
 /* ========================== FORWARD DECLARATIONS ========================== */
 
 // Endpoint handlers
@@ -77,6 +103,8 @@ static esp_err_t whoami_handler(httpd_req_t *req);
 static esp_err_t sensors_handler(httpd_req_t *req);
 static esp_err_t ping_handler(httpd_req_t *req);
 static esp_err_t status_handler(httpd_req_t *req);
+static esp_err_t events_handler(httpd_req_t *req);
+static esp_err_t metrics_handler(httpd_req_t *req);
 
 // Error handlers
 static esp_err_t default_404_handler(httpd_req_t *req, httpd_err_code_t err);
@@ -86,6 +114,8 @@ static esp_err_t register_all_endpoints(void);
 static void add_cors_headers(httpd_req_t *req);
 static void log_request(const char* method, const char* uri, int status_code);
 static const char* get_method_string(httpd_method_t method);
+static void http_count_request(http_endpoint_t endpoint);
+static void http_count_error(void);
 
 /* ========================== INITIALIZATION ========================== */
 
@@ -116,6 +146,12 @@ esp_err_t http_server_init(const http_server_config_t* config)
     ESP_LOGI(TAG, "  Logging: %s", s_http_ctx.config.enable_logging ? "enabled" : "disabled");
     ESP_LOGI(TAG, "  CORS: %s", s_http_ctx.config.enable_cors ? "enabled" : "disabled");
 
+    // Statistics live in the metrics registry (GET /metrics)
+    for (int i = 0; i < HTTP_ENDPOINT_COUNT; i++) {
+        metrics_register(&s_http_requests[i].desc);
+    }
+    metrics_register(&s_http_errors.desc);
+
     s_http_ctx.state = HTTP_STATE_STOPPED;
     s_http_ctx.initialized = true;
 
@@ -208,7 +244,7 @@ esp_err_t http_server_deinit(void)
     http_server_stop();
 
     // Reset statistics
-    memset(&s_http_ctx.stats, 0, sizeof(http_request_stats_t));
+    http_server_reset_stats();
 
     // Reset context
     memset(&s_http_ctx, 0, sizeof(http_server_context_t));
@@ -225,8 +261,7 @@ esp_err_t http_server_deinit(void)
 static esp_err_t whoami_handler(httpd_req_t *req)
 {
     // Update statistics
-    s_http_ctx.stats.requests[HTTP_ENDPOINT_WHOAMI]++;
-    s_http_ctx.stats.total_requests++;
+    http_count_request(HTTP_ENDPOINT_WHOAMI);
     // Note: last_request_time tracking removed (context doesn't have status field)
 
     // Log request start
@@ -264,7 +299,7 @@ static esp_err_t whoami_handler(httpd_req_t *req)
     cJSON *root = cJSON_CreateObject();
     if (root == NULL) {
         ESP_LOGE(TAG, "Failed to create JSON object");
-        s_http_ctx.stats.total_errors++;
+        http_count_error();
         return httpd_resp_send_500(req);
     }
 
@@ -306,12 +341,24 @@ static esp_err_t whoami_handler(httpd_req_t *req)
     cJSON_AddStringToObject(ep4, "description", "System status (available in Phase 2)");
     cJSON_AddItemToArray(endpoints, ep4);
 
+    cJSON *ep5 = cJSON_CreateObject();
+    cJSON_AddStringToObject(ep5, "path", HTTP_URI_EVENTS);
+    cJSON_AddStringToObject(ep5, "method", "GET");
+    cJSON_AddStringToObject(ep5, "description", "Irrigation decision log (?from=&to=&after=&limit=)");
+    cJSON_AddItemToArray(endpoints, ep5);
+
+    cJSON *ep6 = cJSON_CreateObject();
+    cJSON_AddStringToObject(ep6, "path", HTTP_URI_METRICS);
+    cJSON_AddStringToObject(ep6, "method", "GET");
+    cJSON_AddStringToObject(ep6, "description", "Component metrics (OpenMetrics text)");
+    cJSON_AddItemToArray(endpoints, ep6);
+
     // Serialize to string
     char *json_string = cJSON_Print(root);
     if (json_string == NULL) {
         ESP_LOGE(TAG, "Failed to serialize JSON");
         cJSON_Delete(root);
-        s_http_ctx.stats.total_errors++;
+        http_count_error();
         return httpd_resp_send_500(req);
     }
 
@@ -335,13 +382,44 @@ static esp_err_t whoami_handler(httpd_req_t *req)
 }
 
 /**
- * @brief GET /sensors - Current sensor readings (immediate read)
+ * @brief Send a cached payload with its uptime field rewritten to now
+ *
+ * The shared buffer is not modified and not copied: the bytes around the
+ * uptime field go out as chunks, no per-request serialization.
+ */
+static esp_err_t send_payload(httpd_req_t *req, const payload_buffer_t *payload)
+{
+    const char *data = (const char*)payload->data;
+    uint8_t uptime[PAYLOAD_UPTIME_MAX_SIZE];
+    size_t uptime_len = payload_cache_encode_uptime(payload, uptime, sizeof(uptime));
+    if (uptime_len == 0) {
+        return httpd_resp_send(req, data, payload->len);
+    }
+
+    size_t tail = payload->uptime_offset + payload->uptime_len;
+    esp_err_t ret = httpd_resp_send_chunk(req, data, payload->uptime_offset);
+    if (ret == ESP_OK) {
+        ret = httpd_resp_send_chunk(req, (const char*)uptime, uptime_len);
+    }
+    if (ret == ESP_OK && tail < payload->len) {
+        ret = httpd_resp_send_chunk(req, data + tail, payload->len - tail);
+    }
+    if (ret == ESP_OK) {
+        ret = httpd_resp_send_chunk(req, NULL, 0);
+    }
+    return ret;
+}
+
+/**
+ * @brief GET /sensors - Latest sensor sample
+ *
+ * Sends the same sensor_data payload published over MQTT, encoded once per
+ * sample. ?format=binary selects the compact binary encoding.
  */
 static esp_err_t sensors_handler(httpd_req_t *req)
 {
     // Update statistics
-    s_http_ctx.stats.requests[HTTP_ENDPOINT_SENSORS]++;
-    s_http_ctx.stats.total_requests++;
+    http_count_request(HTTP_ENDPOINT_SENSORS);
     // Note: last_request_time tracking removed (context doesn't have status field)
 
     // Log request start
@@ -349,70 +427,85 @@ static esp_err_t sensors_handler(httpd_req_t *req)
         log_request("GET", HTTP_URI_SENSORS, 0);
     }
 
-    // Read sensors IMMEDIATELY (not cached)
+    char query[32] = "";
+    char format_str[8] = "";
+    payload_format_t format = PAYLOAD_FORMAT_JSON;
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+        httpd_query_key_value(query, "format", format_str, sizeof(format_str)) == ESP_OK &&
+        strcmp(format_str, "binary") == 0) {
+        format = PAYLOAD_FORMAT_BINARY;
+    }
+
+    // Latest scheduler sample: a request never touches the sensor bus
     sensor_reading_t reading;
-    esp_err_t ret = sensor_reader_get_all(&reading);
+    esp_err_t ret = sensor_scheduler_get_latest(&reading);
+
+    const payload_buffer_t *payload = NULL;
+    if (ret == ESP_OK) {
+        ret = payload_cache_acquire(&reading, format, &payload);
+    }
+
+    if (ret == ESP_OK) {
+        add_cors_headers(req);
+        httpd_resp_set_type(req, (format == PAYLOAD_FORMAT_BINARY) ? HTTP_CONTENT_TYPE_BINARY
+                                                                   : HTTP_CONTENT_TYPE_JSON);
+        esp_err_t send_ret = send_payload(req, payload);
+        payload_cache_release(payload);
+
+        if (s_http_ctx.config.enable_logging) {
+            log_request("GET", HTTP_URI_SENSORS, (send_ret == ESP_OK ? 200 : 500));
+        }
+        return send_ret;
+    }
 
     cJSON *root = cJSON_CreateObject();
     if (root == NULL) {
         ESP_LOGE(TAG, "Failed to create JSON object");
-        s_http_ctx.stats.total_errors++;
+        http_count_error();
         return httpd_resp_send_500(req);
     }
 
-    int status_code;
+    // Sensor read or encoding failed - return error response
+    ESP_LOGE(TAG, "Failed to read sensors: %s", esp_err_to_name(ret));
 
-    if (ret != ESP_OK) {
-        // Sensor read failed - return error response
-        ESP_LOGE(TAG, "Failed to read sensors: %s", esp_err_to_name(ret));
-
-        cJSON_AddStringToObject(root, "status", "error");
-
-        cJSON *error = cJSON_CreateObject();
-        cJSON_AddItemToObject(root, "error", error);
-
-        const char *error_msg = "Sensor read failed";
-        const char *error_desc = "Failed to read sensor data";
-
-        switch (ret) {
-            case ESP_ERR_TIMEOUT:
-                error_msg = "Sensor Timeout";
-                error_desc = "Sensor reading timed out";
-                break;
-            case ESP_ERR_INVALID_STATE:
-                error_msg = "Sensor Not Ready";
-                error_desc = "Sensor not initialized or not healthy";
-                break;
-            default:
-                break;
-        }
+    cJSON_AddStringToObject(root, "status", "error");
 
-        cJSON_AddStringToObject(error, "message", error_msg);
-        cJSON_AddStringToObject(error, "description", error_desc);
-        cJSON_AddStringToObject(error, "code", esp_err_to_name(ret));
+    cJSON *error = cJSON_CreateObject();
+    cJSON_AddItemToObject(root, "error", error);
 
-        status_code = 500;
-        s_http_ctx.stats.total_errors++;
+    const char *error_msg = "Sensor read failed";
+    const char *error_desc = "Failed to read sensor data";
+
+    switch (ret) {
+        case ESP_ERR_TIMEOUT:
+            error_msg = "Sensor Timeout";
+            error_desc = "Sensor reading timed out";
+            break;
+        case ESP_ERR_INVALID_STATE:
+            error_msg = "Sensor Not Ready";
+            error_desc = "Sensor not initialized or not healthy";
+            break;
+        case ESP_ERR_NO_MEM:
+        case ESP_ERR_INVALID_SIZE:
+            error_msg = "Payload Unavailable";
+            error_desc = "Failed to encode sensor data";
+            break;
+        default:
+            break;
+    }
 
-    } else {
-        // Success - return sensor data
-        cJSON_AddStringToObject(root, "status", "success");
-        cJSON_AddNumberToObject(root, "ambient_temperature", reading.ambient.temperature);
-        cJSON_AddNumberToObject(root, "ambient_humidity", reading.ambient.humidity);
-        cJSON_AddNumberToObject(root, "soil_humidity_1", reading.soil.soil_humidity[0]);
-        cJSON_AddNumberToObject(root, "soil_humidity_2", reading.soil.soil_humidity[1]);
-        cJSON_AddNumberToObject(root, "soil_humidity_3", reading.soil.soil_humidity[2]);
-        // Note: timestamp removed - sensor_reading_t doesn't have timestamp field
+    cJSON_AddStringToObject(error, "message", error_msg);
+    cJSON_AddStringToObject(error, "description", error_desc);
+    cJSON_AddStringToObject(error, "code", esp_err_to_name(ret));
 
-        status_code = 200;
-    }
+    http_count_error();
 
     // Serialize to string
     char *json_string = cJSON_Print(root);
     if (json_string == NULL) {
         ESP_LOGE(TAG, "Failed to serialize JSON");
         cJSON_Delete(root);
-        s_http_ctx.stats.total_errors++;
+        http_count_error();
         return httpd_resp_send_500(req);
     }
 
@@ -421,9 +514,7 @@ static esp_err_t sensors_handler(httpd_req_t *req)
 
     // Send response
     httpd_resp_set_type(req, HTTP_CONTENT_TYPE_JSON);
-    if (status_code == 500) {
-        httpd_resp_set_status(req, "500 Internal Server Error");
-    }
+    httpd_resp_set_status(req, "500 Internal Server Error");
     esp_err_t send_ret = httpd_resp_send(req, json_string, strlen(json_string));
 
     // Cleanup
@@ -432,7 +523,7 @@ static esp_err_t sensors_handler(httpd_req_t *req)
 
     // Log request end
     if (s_http_ctx.config.enable_logging) {
-        log_request("GET", HTTP_URI_SENSORS, (send_ret == ESP_OK ? status_code : 500));
+        log_request("GET", HTTP_URI_SENSORS, 500);
     }
 
     return send_ret;
@@ -444,8 +535,7 @@ static esp_err_t sensors_handler(httpd_req_t *req)
 static esp_err_t ping_handler(httpd_req_t *req)
 {
     // Update statistics
-    s_http_ctx.stats.requests[HTTP_ENDPOINT_PING]++;
-    s_http_ctx.stats.total_requests++;
+    http_count_request(HTTP_ENDPOINT_PING);
     // Note: last_request_time tracking removed (context doesn't have status field)
 
     // Log request start
@@ -462,7 +552,7 @@ static esp_err_t ping_handler(httpd_req_t *req)
     cJSON *root = cJSON_CreateObject();
     if (root == NULL) {
         ESP_LOGE(TAG, "Failed to create JSON object");
-        s_http_ctx.stats.total_errors++;
+        http_count_error();
         return httpd_resp_send_500(req);
     }
 
@@ -475,7 +565,7 @@ static esp_err_t ping_handler(httpd_req_t *req)
     if (json_string == NULL) {
         ESP_LOGE(TAG, "Failed to serialize JSON");
         cJSON_Delete(root);
-        s_http_ctx.stats.total_errors++;
+        http_count_error();
         return httpd_resp_send_500(req);
     }
 
@@ -499,36 +589,182 @@ static esp_err_t ping_handler(httpd_req_t *req)
 }
 
 /**
- * @brief GET /status - System status (Phase 2)
+ * @brief Irrigation state name for /status
+ */
+static const char* http_irrigation_state_name(irrigation_state_t state)
+{
+    switch (state) {
+        case IRRIGATION_IDLE:               return "idle";
+        case IRRIGATION_ACTIVE:             return "active";
+        case IRRIGATION_PAUSED:             return "paused";
+        case IRRIGATION_ERROR:              return "error";
+        case IRRIGATION_EMERGENCY_STOP:     return "emergency_stop";
+        case IRRIGATION_THERMAL_PROTECTION: return "thermal_protection";
+        default:                            return "unknown";
+    }
+}
+
+/**
+ * @brief GET /status - Irrigation status and lifetime statistics
  */
 static esp_err_t status_handler(httpd_req_t *req)
 {
     // Update statistics
-    s_http_ctx.stats.requests[HTTP_ENDPOINT_STATUS]++;
-    s_http_ctx.stats.total_requests++;
+    http_count_request(HTTP_ENDPOINT_STATUS);
 
     // Log request start
     if (s_http_ctx.config.enable_logging) {
         log_request("GET", HTTP_URI_STATUS, 0);
     }
 
-    // Placeholder response for Phase 2
+    irrigation_status_t status;
+    bool have_status = (s_status_provider != NULL &&
+                        s_status_provider(&status, s_status_provider_data) == ESP_OK);
+
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL) {
+        ESP_LOGE(TAG, "Failed to create JSON object");
+        http_count_error();
+        return httpd_resp_send_500(req);
+    }
+
+    if (have_status) {
+        cJSON_AddStringToObject(root, "irrigation_state", http_irrigation_state_name(status.state));
+        cJSON_AddNumberToObject(root, "valve_number", status.valve_number);
+        cJSON_AddNumberToObject(root, "session_duration", status.session_duration_sec);
+        cJSON_AddBoolToObject(root, "safety_lock", status.safety_lock);
+
+        cJSON *stats = cJSON_AddObjectToObject(root, "stats");
+        if (stats != NULL) {
+            cJSON_AddNumberToObject(stats, "today_runtime", status.total_runtime_today);
+            cJSON_AddNumberToObject(stats, "total_sessions", status.total_sessions);
+            cJSON_AddNumberToObject(stats, "total_runtime", status.total_runtime_sec);
+            cJSON_AddNumberToObject(stats, "emergency_stops", status.emergency_stops);
+            cJSON_AddNumberToObject(stats, "thermal_stops", status.thermal_stops);
+        }
+    } else {
+        cJSON_AddStringToObject(root, "irrigation_state", "unavailable");
+    }
+    cJSON_AddNumberToObject(root, "free_heap", esp_get_free_heap_size());
+    cJSON_AddNumberToObject(root, "uptime_seconds", (uint32_t)(esp_timer_get_time() / 1000000));
+
+    // Serialize to string
+    char *json_string = cJSON_Print(root);
+    if (json_string == NULL) {
+        ESP_LOGE(TAG, "Failed to serialize JSON");
+        cJSON_Delete(root);
+        http_count_error();
+        return httpd_resp_send_500(req);
+    }
+
+    // Add CORS headers if enabled
+    add_cors_headers(req);
+
+    // Send response
+    httpd_resp_set_type(req, HTTP_CONTENT_TYPE_JSON);
+    esp_err_t send_ret = httpd_resp_send(req, json_string, strlen(json_string));
+
+    // Cleanup
+    free(json_string);
+    cJSON_Delete(root);
+
+    // Log request end
+    if (s_http_ctx.config.enable_logging) {
+        log_request("GET", HTTP_URI_STATUS, (send_ret == ESP_OK ? 200 : 500));
+    }
+
+    return send_ret;
+}
+
+/**
+ * @brief Unsigned query parameter, @p default_value if absent or malformed
+ */
+static uint32_t http_query_u32(const char* query, const char* key, uint32_t default_value)
+{
+    char value[12];
+    if (query[0] == '\0' || httpd_query_key_value(query, key, value, sizeof(value)) != ESP_OK) {
+        return default_value;
+    }
+
+    char *end;
+    unsigned long parsed = strtoul(value, &end, 10);
+    return (end != value && *end == '\0') ? (uint32_t)parsed : default_value;
+}
+
+/**
+ * @brief GET /events - Irrigation decision log by time range
+ *
+ * Query: from/to (Unix seconds, inclusive), after (seq cursor), limit.
+ * Pass next_after of the response as after to read the next page.
+ */
+static esp_err_t events_handler(httpd_req_t *req)
+{
+    // Update statistics
+    http_count_request(HTTP_ENDPOINT_EVENTS);
+
+    // Log request start
+    if (s_http_ctx.config.enable_logging) {
+        log_request("GET", HTTP_URI_EVENTS, 0);
+    }
+
+    char query[96] = "";
+    size_t query_len = httpd_req_get_url_query_len(req);
+    if (query_len > 0 && (query_len >= sizeof(query) ||
+                          httpd_req_get_url_query_str(req, query, sizeof(query)) != ESP_OK)) {
+        http_count_error();
+        return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid query");
+    }
+
+    decision_log_filter_t filter = {
+        .from = http_query_u32(query, "from", 0),
+        .to = http_query_u32(query, "to", 0),
+        .after_seq = http_query_u32(query, "after", 0),
+    };
+    uint32_t limit = http_query_u32(query, "limit", DECISION_LOG_QUERY_MAX);
+    if (limit == 0 || limit > DECISION_LOG_QUERY_MAX) {
+        limit = DECISION_LOG_QUERY_MAX;
+    }
+
+    decision_log_record_t *records = malloc(limit * sizeof(decision_log_record_t));
+    if (records == NULL) {
+        http_count_error();
+        return httpd_resp_send_500(req);
+    }
+
+    size_t count = 0;
+    esp_err_t ret = decision_log_query(&filter, records, limit, &count);
+    if (ret != ESP_OK) {
+        free(records);
+        http_count_error();
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        return httpd_resp_sendstr(req, "Decision log not available");
+    }
+
     cJSON *root = cJSON_CreateObject();
     if (root == NULL) {
         ESP_LOGE(TAG, "Failed to create JSON object");
-        s_http_ctx.stats.total_errors++;
+        free(records);
+        http_count_error();
         return httpd_resp_send_500(req);
     }
 
-    cJSON_AddStringToObject(root, "status", "not_implemented");
-    cJSON_AddStringToObject(root, "message", "Status endpoint available in Phase 2 (irrigation_controller)");
+    cJSON_AddNumberToObject(root, "count", count);
+    cJSON_AddNumberToObject(root, "next_after", (count > 0) ? records[count - 1].seq : filter.after_seq);
+    cJSON_AddBoolToObject(root, "more", count == limit);
+    cJSON_AddNumberToObject(root, "dropped", decision_log_get_dropped());
+
+    cJSON *events = cJSON_AddArrayToObject(root, "events");
+    for (size_t i = 0; i < count && events != NULL; i++) {
+        cJSON_AddItemToArray(events, decision_log_record_to_json(&records[i]));
+    }
+    free(records);
 
     // Serialize to string
     char *json_string = cJSON_Print(root);
     if (json_string == NULL) {
         ESP_LOGE(TAG, "Failed to serialize JSON");
         cJSON_Delete(root);
-        s_http_ctx.stats.total_errors++;
+        http_count_error();
         return httpd_resp_send_500(req);
     }
 
@@ -537,7 +773,6 @@ static esp_err_t status_handler(httpd_req_t *req)
 
     // Send response
     httpd_resp_set_type(req, HTTP_CONTENT_TYPE_JSON);
-    httpd_resp_set_status(req, "501 Not Implemented");
     esp_err_t send_ret = httpd_resp_send(req, json_string, strlen(json_string));
 
     // Cleanup
@@ -546,12 +781,59 @@ static esp_err_t status_handler(httpd_req_t *req)
 
     // Log request end
     if (s_http_ctx.config.enable_logging) {
-        log_request("GET", HTTP_URI_STATUS, 501);
+        log_request("GET", HTTP_URI_EVENTS, (send_ret == ESP_OK ? 200 : 500));
     }
 
     return send_ret;
 }
 
+/**
+ * @brief metrics_export() sink: one HTTP chunk per filled buffer
+ */
+static esp_err_t metrics_send_chunk(const char *data, size_t len, void *ctx)
+{
+    return httpd_resp_send_chunk((httpd_req_t*)ctx, data, len);
+}
+
+/**
+ * @brief GET /metrics - Component metrics in OpenMetrics text format
+ *
+ * Streamed with chunked encoding through a fixed buffer, so the response
+ * size does not depend on heap or on how many metrics are registered.
+ */
+static esp_err_t metrics_handler(httpd_req_t *req)
+{
+    // Update statistics
+    http_count_request(HTTP_ENDPOINT_METRICS);
+
+    // Log request start
+    if (s_http_ctx.config.enable_logging) {
+        log_request("GET", HTTP_URI_METRICS, 0);
+    }
+
+    add_cors_headers(req);
+    httpd_resp_set_type(req, HTTP_CONTENT_TYPE_OPENMETRICS);
+
+    esp_err_t ret = metrics_export(s_metrics_chunk, sizeof(s_metrics_chunk), metrics_send_chunk, req);
+    if (ret == ESP_OK) {
+        // Terminating chunk
+        ret = httpd_resp_send_chunk(req, NULL, 0);
+    }
+
+    if (ret != ESP_OK) {
+        // Headers are already out: the scraper sees a truncated body
+        ESP_LOGW(TAG, "Metrics export failed: %s", esp_err_to_name(ret));
+        http_count_error();
+    }
+
+    // Log request end
+    if (s_http_ctx.config.enable_logging) {
+        log_request("GET", HTTP_URI_METRICS, (ret == ESP_OK ? 200 : 500));
+    }
+
+    return ret;
+}
+
 /* ========================== ERROR HANDLERS ========================== */
 
 /**
@@ -560,7 +842,7 @@ static esp_err_t status_handler(httpd_req_t *req)
 static esp_err_t default_404_handler(httpd_req_t *req, httpd_err_code_t err)
 {
     // Update error statistics
-    s_http_ctx.stats.total_errors++;
+    http_count_error();
 
     // Log request
     if (s_http_ctx.config.enable_logging) {
@@ -666,11 +948,55 @@ static esp_err_t register_all_endpoints(void)
     }
     ESP_LOGI(TAG, "Registered endpoint: GET %s (placeholder)", HTTP_URI_STATUS);
 
+    // Register /events endpoint
+    httpd_uri_t events_uri = {
+        .uri = HTTP_URI_EVENTS,
+        .method = HTTP_GET,
+        .handler = events_handler,
+        .user_ctx = NULL
+    };
+    ret = httpd_register_uri_handler(s_http_ctx.server, &events_uri);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to register /events endpoint: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    ESP_LOGI(TAG, "Registered endpoint: GET %s", HTTP_URI_EVENTS);
+
+    // Register /metrics endpoint
+    httpd_uri_t metrics_uri = {
+        .uri = HTTP_URI_METRICS,
+        .method = HTTP_GET,
+        .handler = metrics_handler,
+        .user_ctx = NULL
+    };
+    ret = httpd_register_uri_handler(s_http_ctx.server, &metrics_uri);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to register /metrics endpoint: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    ESP_LOGI(TAG, "Registered endpoint: GET %s", HTTP_URI_METRICS);
+
     return ESP_OK;
 }
 
 /* ========================== HELPER FUNCTIONS ========================== */
 
+/**
+ * @brief Count a request to an endpoint
+ */
+static void http_count_request(http_endpoint_t endpoint)
+{
+    metrics_counter_inc(&s_http_requests[endpoint]);
+}
+
+/**
+ * @brief Count a request answered with an error
+ */
+static void http_count_error(void)
+{
+    metrics_counter_inc(&s_http_errors);
+}
+
 /**
  * @brief Add CORS headers to response
  */
@@ -724,8 +1050,11 @@ esp_err_t http_server_get_status(http_server_status_t* status)
 
     status->state = s_http_ctx.state;
     status->port = s_http_ctx.config.port;
-    status->total_requests = s_http_ctx.stats.total_requests;
-    status->error_count = s_http_ctx.stats.total_errors;
+    http_request_stats_t stats;
+    http_server_get_stats(&stats);
+
+    status->total_requests = stats.total_requests;
+    status->error_count = stats.total_errors;
     status->last_request_time = 0;  // Not tracked in context
     status->handle = s_http_ctx.server;
 
@@ -738,17 +1067,34 @@ esp_err_t http_server_get_stats(http_request_stats_t* stats)
         return ESP_ERR_INVALID_ARG;
     }
 
-    memcpy(stats, &s_http_ctx.stats, sizeof(http_request_stats_t));
+    memset(stats, 0, sizeof(http_request_stats_t));
+    for (int i = 0; i < HTTP_ENDPOINT_COUNT; i++) {
+        stats->requests[i] = metrics_counter_get(&s_http_requests[i]);
+        stats->total_requests += stats->requests[i];
+    }
+    stats->total_errors = metrics_counter_get(&s_http_errors);
     return ESP_OK;
 }
 
 esp_err_t http_server_reset_stats(void)
 {
-    memset(&s_http_ctx.stats, 0, sizeof(http_request_stats_t));
+    for (int i = 0; i < HTTP_ENDPOINT_COUNT; i++) {
+        metrics_counter_reset(&s_http_requests[i]);
+    }
+    metrics_counter_reset(&s_http_errors);
     ESP_LOGI(TAG, "Statistics reset");
     return ESP_OK;
 }
 
+esp_err_t http_server_register_status_provider(http_irrigation_status_provider_t provider,
+                                               void* user_data)
+{
+    // Set once at startup, before the server accepts requests
+    s_status_provider_data = user_data;
+    s_status_provider = provider;
+    return ESP_OK;
+}
+
 bool http_server_is_running(void)
 {
     return (s_http_ctx.state == HTTP_STATE_RUNNING);
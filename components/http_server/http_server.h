@@ -53,6 +53,8 @@ typedef enum {
     HTTP_ENDPOINT_STATUS,           ///< /status - System status
     HTTP_ENDPOINT_IRRIGATION,       ///< /irrigation - Irrigation status
     HTTP_ENDPOINT_CONFIG,           ///< /config - Device configuration
+    HTTP_ENDPOINT_EVENTS,           ///< /events - Irrigation decision log
+    HTTP_ENDPOINT_METRICS,          ///< /metrics - OpenMetrics scrape
     HTTP_ENDPOINT_COUNT             ///< Total endpoint count
 } http_endpoint_t;
 
@@ -83,6 +85,9 @@ typedef struct {
 
 /**
  * @brief HTTP request statistics
+ *
+ * Snapshot of the http_requests/http_errors counters of the metrics
+ * registry (also exported on GET /metrics).
  */
 typedef struct {
     uint32_t requests[HTTP_ENDPOINT_COUNT]; ///< Requests per endpoint
@@ -91,6 +96,19 @@ typedef struct {
     uint32_t avg_response_time_ms;  ///< Average response time
 } http_request_stats_t;
 
+/**
+ * @brief Irrigation status provider for GET /status
+ *
+ * http_server does not depend on irrigation_controller; the application
+ * registers a function that fills the common irrigation_status_t.
+ *
+ * @param[out] status Status to fill
+ * @param user_data User data passed during registration
+ * @return ESP_OK if status was filled
+ */
+typedef esp_err_t (*http_irrigation_status_provider_t)(irrigation_status_t* status,
+                                                       void* user_data);
+
 /* ============================ PUBLIC API ============================ */
 
 /**
@@ -161,6 +179,19 @@ bool http_server_is_running(void);
  */
 esp_err_t http_server_reset_stats(void);
 
+/**
+ * @brief Register the irrigation status provider used by GET /status
+ *
+ * May be called before http_server_init(); the registration survives
+ * stop/start.
+ *
+ * @param provider Provider function (NULL to unregister)
+ * @param user_data User data passed to provider (can be NULL)
+ * @return ESP_OK
+ */
+esp_err_t http_server_register_status_provider(http_irrigation_status_provider_t provider,
+                                               void* user_data);
+
 /* ============================ ENDPOINT RESPONSES ============================ */
 
 /**
@@ -184,16 +215,28 @@ esp_err_t http_server_reset_stats(void);
 /**
  * @brief Endpoint: GET /sensors
  *
- * Returns current sensor readings (immediate read, not cached).
+ * Returns the latest sensor_scheduler sample as the same sensor_data
+ * payload published over MQTT (payload_cache, encoded once per sample).
+ * ?format=binary returns the compact binary encoding (application/octet-stream).
+ * The JSON has one soil_humidity_N per active channel (N = 1..soil_sensor_count,
+ * up to 16); a channel whose valid_mask bit is clear reads 0.
+ * uptime_ms (binary: uptime) is the uptime when the response is sent, not
+ * when the cached payload was encoded.
  *
  * Response (JSON):
  * {
+ *   "event_type": "sensor_data",
+ *   "mac_address": "AA:BB:CC:DD:EE:FF",
+ *   "ip_address": "192.168.1.100",
  *   "ambient_temperature": 25.6,
  *   "ambient_humidity": 65.2,
+ *   "soil_sensor_count": 3,
  *   "soil_humidity_1": 45.8,
  *   "soil_humidity_2": 42.1,
  *   "soil_humidity_3": 48.3,
- *   "timestamp": 1640995200
+ *   "timestamp": 1640995200,
+ *   "time_quality": "sntp",
+ *   "uptime_ms": 12345678
  * }
  */
 
@@ -218,14 +261,23 @@ esp_err_t http_server_reset_stats(void);
  *
  * Response (JSON):
  * {
- *   "system_health": "healthy",
- *   "connectivity": "full",
- *   "wifi_connected": true,
- *   "mqtt_connected": true,
  *   "irrigation_state": "idle",
+ *   "valve_number": 0,
+ *   "session_duration": 0,
+ *   "safety_lock": false,
+ *   "stats": {
+ *     "today_runtime": 900,
+ *     "total_sessions": 42,
+ *     "total_runtime": 37800,
+ *     "emergency_stops": 0,
+ *     "thermal_stops": 1
+ *   },
  *   "free_heap": 180000,
  *   "uptime_seconds": 12345
  * }
+ *
+ * irrigation_state is "unavailable" (and the other irrigation fields are
+ * omitted) when no status provider is registered.
  */
 
 /**
@@ -260,6 +312,21 @@ esp_err_t http_server_reset_stats(void);
  * }
  */
 
+/**
+ * @brief Endpoint: GET /metrics
+ *
+ * Every metric in the metrics registry (HTTP, MQTT, notifications, sensor
+ * sampling, payload cache, heap) in OpenMetrics text format, sent with
+ * chunked encoding from a fixed METRICS_EXPORT_CHUNK_SIZE buffer.
+ *
+ * Response (application/openmetrics-text):
+ * # HELP http_requests HTTP requests by endpoint
+ * # TYPE http_requests counter
+ * http_requests_total{endpoint="sensors"} 42
+ * ...
+ * # EOF
+ */
+
 /* ============================ CONFIGURATION ============================ */
 
 /**
@@ -310,6 +377,8 @@ esp_err_t http_server_reset_stats(void);
  */
 #define HTTP_CONTENT_TYPE_JSON      "application/json"
 #define HTTP_CONTENT_TYPE_TEXT      "text/plain"
+#define HTTP_CONTENT_TYPE_BINARY    "application/octet-stream"
+#define HTTP_CONTENT_TYPE_OPENMETRICS "application/openmetrics-text; version=1.0.0; charset=utf-8"
 
 /**
  * @brief HTTP status codes (commonly used)
@@ -327,6 +396,8 @@ esp_err_t http_server_reset_stats(void);
 #define HTTP_URI_STATUS             "/status"
 #define HTTP_URI_IRRIGATION         "/irrigation"
 #define HTTP_URI_CONFIG             "/config"
+#define HTTP_URI_EVENTS             "/events"
+#define HTTP_URI_METRICS            "/metrics"
 
 #ifdef __cplusplus
 }
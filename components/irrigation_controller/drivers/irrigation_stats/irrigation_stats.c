@@ -0,0 +1,150 @@
+/**
+ * @file irrigation_stats.c
+ * @brief Lifetime irrigation counters with rate-limited NVS checkpoints
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "irrigation_stats.h"
+#include "irrigation_controller.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "nvs.h"
+#include "freertos/FreeRTOS.h"
+#include <inttypes.h>
+
+/* ============================ PRIVATE STATE ============================ */
+
+static const char *TAG = "irrigation_stats";
+
+static irrigation_stats_totals_t s_totals;
+static bool s_dirty = false;
+static int64_t s_last_write_ms = 0;
+static uint32_t s_checkpoint_interval_ms = 0;
+static portMUX_TYPE s_stats_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+/* ============================ PUBLIC API ============================ */
+
+esp_err_t irrigation_stats_init(uint32_t checkpoint_interval_ms)
+{
+    irrigation_stats_totals_t totals = {0};
+
+    nvs_handle_t nvs_handle;
+    esp_err_t ret = nvs_open(IRRIGATION_CONTROLLER_NVS_NAMESPACE, NVS_READONLY, &nvs_handle);
+    if (ret == ESP_OK) {
+        nvs_get_u32(nvs_handle, IRRIGATION_NVS_KEY_TOTAL_SESSIONS, &totals.total_sessions);
+        nvs_get_u32(nvs_handle, IRRIGATION_NVS_KEY_TOTAL_RUNTIME, &totals.total_runtime_seconds);
+        nvs_get_u32(nvs_handle, IRRIGATION_NVS_KEY_EMERGENCY_STOPS, &totals.emergency_stops);
+        nvs_get_u32(nvs_handle, IRRIGATION_NVS_KEY_THERMAL_STOPS, &totals.thermal_stops);
+        nvs_close(nvs_handle);
+    } else if (ret != ESP_ERR_NVS_NOT_FOUND) {
+        ESP_LOGW(TAG, "Failed to read statistics: %s", esp_err_to_name(ret));
+    }
+
+    portENTER_CRITICAL(&s_stats_spinlock);
+    {
+        s_totals = totals;
+        s_dirty = false;
+        s_last_write_ms = esp_timer_get_time() / 1000;
+        s_checkpoint_interval_ms = checkpoint_interval_ms;
+    }
+    portEXIT_CRITICAL(&s_stats_spinlock);
+
+    ESP_LOGI(TAG, "Lifetime: %" PRIu32 " sessions, %" PRIu32 " s irrigated, %" PRIu32
+             " emergency / %" PRIu32 " thermal stops",
+             totals.total_sessions, totals.total_runtime_seconds,
+             totals.emergency_stops, totals.thermal_stops);
+    return ESP_OK;
+}
+
+void irrigation_stats_record_session(uint32_t runtime_seconds)
+{
+    portENTER_CRITICAL(&s_stats_spinlock);
+    {
+        s_totals.total_sessions++;
+        s_totals.total_runtime_seconds += runtime_seconds;
+        s_dirty = true;
+    }
+    portEXIT_CRITICAL(&s_stats_spinlock);
+}
+
+void irrigation_stats_record_emergency_stop(void)
+{
+    portENTER_CRITICAL(&s_stats_spinlock);
+    {
+        s_totals.emergency_stops++;
+        s_dirty = true;
+    }
+    portEXIT_CRITICAL(&s_stats_spinlock);
+}
+
+void irrigation_stats_record_thermal_stop(void)
+{
+    portENTER_CRITICAL(&s_stats_spinlock);
+    {
+        s_totals.thermal_stops++;
+        s_dirty = true;
+    }
+    portEXIT_CRITICAL(&s_stats_spinlock);
+}
+
+void irrigation_stats_get(irrigation_stats_totals_t *totals)
+{
+    if (totals == NULL) {
+        return;
+    }
+
+    portENTER_CRITICAL(&s_stats_spinlock);
+    {
+        *totals = s_totals;
+    }
+    portEXIT_CRITICAL(&s_stats_spinlock);
+}
+
+esp_err_t irrigation_stats_checkpoint(bool transition)
+{
+    int64_t now_ms = esp_timer_get_time() / 1000;
+    irrigation_stats_totals_t totals;
+    bool due;
+
+    portENTER_CRITICAL(&s_stats_spinlock);
+    {
+        due = s_dirty && (transition || now_ms - s_last_write_ms >= s_checkpoint_interval_ms);
+        totals = s_totals;
+        if (due) {
+            // Cleared before the write: a concurrent record re-dirties it
+            s_dirty = false;
+            s_last_write_ms = now_ms;
+        }
+    }
+    portEXIT_CRITICAL(&s_stats_spinlock);
+
+    if (!due) {
+        return ESP_OK;
+    }
+
+    nvs_handle_t nvs_handle;
+    esp_err_t ret = nvs_open(IRRIGATION_CONTROLLER_NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+    if (ret == ESP_OK) {
+        nvs_set_u32(nvs_handle, IRRIGATION_NVS_KEY_TOTAL_SESSIONS, totals.total_sessions);
+        nvs_set_u32(nvs_handle, IRRIGATION_NVS_KEY_TOTAL_RUNTIME, totals.total_runtime_seconds);
+        nvs_set_u32(nvs_handle, IRRIGATION_NVS_KEY_EMERGENCY_STOPS, totals.emergency_stops);
+        ret = nvs_set_u32(nvs_handle, IRRIGATION_NVS_KEY_THERMAL_STOPS, totals.thermal_stops);
+        if (ret == ESP_OK) {
+            ret = nvs_commit(nvs_handle);
+        }
+        nvs_close(nvs_handle);
+    }
+
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Statistics checkpoint failed: %s", esp_err_to_name(ret));
+        portENTER_CRITICAL(&s_stats_spinlock);
+        {
+            s_dirty = true;     // Retry on the next due checkpoint
+        }
+        portEXIT_CRITICAL(&s_stats_spinlock);
+    }
+    return ret;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file irrigation_stats.h
+ * @brief Lifetime irrigation counters with rate-limited NVS checkpoints
+ *
+ * Counters accumulate in RAM and are written to NVS only when something
+ * changed, and then at most every checkpoint interval or on a controller
+ * state transition, which bounds flash writes to a few per session.
+ * Today's runtime stays in the controller (it drives the daily budget and
+ * is protected by the session journal); these are the lifetime totals.
+ *
+ * Thread-Safety:
+ * - Recording and reading are safe from any task or esp_timer callback
+ * - irrigation_stats_checkpoint() must run in task context (NVS write)
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef IRRIGATION_STATS_H
+#define IRRIGATION_STATS_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================ TYPES ============================ */
+
+/**
+ * @brief Lifetime counters
+ */
+typedef struct {
+    uint32_t total_sessions;            ///< Completed sessions
+    uint32_t total_runtime_seconds;     ///< Valve-open time of every session
+    uint32_t emergency_stops;           ///< Emergency stops
+    uint32_t thermal_stops;             ///< Thermal protection triggers
+} irrigation_stats_totals_t;
+
+/* ============================ API ============================ */
+
+/**
+ * @brief Load the counters from NVS (missing keys start at 0)
+ *
+ * @param checkpoint_interval_ms Minimum time between periodic checkpoints
+ * @return ESP_OK (a read failure is logged and the counters start at 0)
+ */
+esp_err_t irrigation_stats_init(uint32_t checkpoint_interval_ms);
+
+/**
+ * @brief Count a completed session
+ *
+ * @param runtime_seconds Valve-open time of the session
+ */
+void irrigation_stats_record_session(uint32_t runtime_seconds);
+
+/**
+ * @brief Count an emergency stop
+ */
+void irrigation_stats_record_emergency_stop(void);
+
+/**
+ * @brief Count a thermal protection trigger
+ */
+void irrigation_stats_record_thermal_stop(void);
+
+/**
+ * @brief Copy the current counters
+ */
+void irrigation_stats_get(irrigation_stats_totals_t *totals);
+
+/**
+ * @brief Write the counters to NVS if they changed and a write is due
+ *
+ * @param transition true on a controller state transition (write now if
+ *                   dirty), false for the periodic call (write only once
+ *                   the checkpoint interval elapsed)
+ * @return ESP_OK if written or nothing to do, NVS error otherwise
+ */
+esp_err_t irrigation_stats_checkpoint(bool transition);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // IRRIGATION_STATS_H
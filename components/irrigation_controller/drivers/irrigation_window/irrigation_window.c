@@ -0,0 +1,215 @@
+/**
+ * @file irrigation_window.c
+ * @brief Time-of-day irrigation windows and deferred-start queue
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "irrigation_window.h"
+#include <string.h>
+
+/* ============================ WINDOWS ============================ */
+
+/**
+ * @brief Parse "HH:MM" at *p and advance past it
+ */
+static bool window_parse_time(const char **p, uint16_t *minute)
+{
+    const char *s = *p;
+    int hour = 0;
+    int min = 0;
+    int digits = 0;
+
+    while (*s == ' ') {
+        s++;
+    }
+    while (*s >= '0' && *s <= '9' && digits < 2) {
+        hour = hour * 10 + (*s++ - '0');
+        digits++;
+    }
+    if (digits == 0 || *s++ != ':') {
+        return false;
+    }
+    if (!(s[0] >= '0' && s[0] <= '9' && s[1] >= '0' && s[1] <= '9')) {
+        return false;
+    }
+    min = (s[0] - '0') * 10 + (s[1] - '0');
+    s += 2;
+
+    // 24:00 is accepted as the end of the day
+    if (min > 59 || hour > 24 || (hour == 24 && min != 0)) {
+        return false;
+    }
+    while (*s == ' ') {
+        s++;
+    }
+
+    *minute = (uint16_t)((hour * 60 + min) % IRRIGATION_WINDOW_DAY_MINUTES);
+    *p = s;
+    return true;
+}
+
+bool irrigation_window_parse(const char *spec, irrigation_window_schedule_t *schedule)
+{
+    memset(schedule, 0, sizeof(*schedule));
+    if (spec == NULL) {
+        return true;
+    }
+
+    const char *p = spec;
+    while (*p == ' ') {
+        p++;
+    }
+
+    while (*p != '\0') {
+        irrigation_window_t window;
+        if (schedule->count >= IRRIGATION_WINDOW_MAX ||
+            !window_parse_time(&p, &window.start_min) || *p++ != '-' ||
+            !window_parse_time(&p, &window.end_min) ||
+            window.start_min == window.end_min) {
+            schedule->count = 0;
+            return false;
+        }
+        schedule->windows[schedule->count++] = window;
+
+        if (*p == ',') {
+            p++;
+        } else if (*p != '\0') {
+            schedule->count = 0;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool irrigation_window_is_open(const irrigation_window_schedule_t *schedule,
+                               uint16_t minute_of_day)
+{
+    if (schedule->count == 0) {
+        return true;
+    }
+
+    for (uint8_t i = 0; i < schedule->count; i++) {
+        const irrigation_window_t *w = &schedule->windows[i];
+        bool open = (w->start_min < w->end_min)
+            ? (minute_of_day >= w->start_min && minute_of_day < w->end_min)
+            : (minute_of_day >= w->start_min || minute_of_day < w->end_min);   // Wraps midnight
+        if (open) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint16_t irrigation_window_minutes_until_open(const irrigation_window_schedule_t *schedule,
+                                              uint16_t minute_of_day)
+{
+    if (irrigation_window_is_open(schedule, minute_of_day)) {
+        return 0;
+    }
+
+    uint16_t best = IRRIGATION_WINDOW_DAY_MINUTES;
+    for (uint8_t i = 0; i < schedule->count; i++) {
+        uint16_t wait = (uint16_t)((schedule->windows[i].start_min + IRRIGATION_WINDOW_DAY_MINUTES -
+                                    minute_of_day) % IRRIGATION_WINDOW_DAY_MINUTES);
+        if (wait < best) {
+            best = wait;
+        }
+    }
+    return best;
+}
+
+/* ============================ DEFERRED QUEUE ============================ */
+
+/**
+ * @brief True if @p a must start before @p b
+ */
+static bool deferred_more_urgent(const irrigation_deferred_t *a, const irrigation_deferred_t *b)
+{
+    if (a->level != b->level) {
+        return a->level > b->level;
+    }
+    if (a->soil != b->soil) {
+        return a->soil < b->soil;
+    }
+    return a->requested_s < b->requested_s;
+}
+
+static int deferred_find(const irrigation_deferred_queue_t *queue, uint8_t zone)
+{
+    for (uint8_t i = 0; i < queue->count; i++) {
+        if (queue->entries[i].zone == zone) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void irrigation_deferred_init(irrigation_deferred_queue_t *queue)
+{
+    memset(queue, 0, sizeof(*queue));
+}
+
+bool irrigation_deferred_push(irrigation_deferred_queue_t *queue,
+                              const irrigation_deferred_t *request)
+{
+    int i = deferred_find(queue, request->zone);
+    if (i >= 0) {
+        queue->entries[i].level = request->level;
+        queue->entries[i].soil = request->soil;
+        return true;
+    }
+
+    if (queue->count >= IRRIGATION_WINDOW_QUEUE_LEN) {
+        return false;
+    }
+    queue->entries[queue->count++] = *request;
+    return true;
+}
+
+bool irrigation_deferred_remove(irrigation_deferred_queue_t *queue, uint8_t zone)
+{
+    int i = deferred_find(queue, zone);
+    if (i < 0) {
+        return false;
+    }
+
+    queue->count--;
+    queue->entries[i] = queue->entries[queue->count];
+    return true;
+}
+
+bool irrigation_deferred_contains(const irrigation_deferred_queue_t *queue, uint8_t zone)
+{
+    return deferred_find(queue, zone) >= 0;
+}
+
+bool irrigation_deferred_pop_ready(irrigation_deferred_queue_t *queue,
+                                   const irrigation_window_schedule_t *schedules,
+                                   uint8_t zone_count, uint16_t minute_of_day,
+                                   irrigation_deferred_t *out)
+{
+    int best = -1;
+
+    for (uint8_t i = 0; i < queue->count; i++) {
+        const irrigation_deferred_t *entry = &queue->entries[i];
+        if (entry->zone == 0 || entry->zone > zone_count ||
+            !irrigation_window_is_open(&schedules[entry->zone - 1], minute_of_day)) {
+            continue;
+        }
+        if (best < 0 || deferred_more_urgent(entry, &queue->entries[best])) {
+            best = i;
+        }
+    }
+
+    if (best < 0) {
+        return false;
+    }
+
+    *out = queue->entries[best];
+    queue->count--;
+    queue->entries[best] = queue->entries[queue->count];
+    return true;
+}
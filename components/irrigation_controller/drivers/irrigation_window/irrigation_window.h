@@ -0,0 +1,154 @@
+/**
+ * @file irrigation_window.h
+ * @brief Time-of-day irrigation windows and deferred-start queue
+ *
+ * Each zone may only start automatic irrigation inside its allowed windows
+ * (e.g. early morning and evening, when evaporation is low and the shared
+ * pump is free). A start requested outside the windows is queued and
+ * released when a window opens; if several zones wait, the most urgent one
+ * goes first:
+ *
+ * 1. higher offline level (see offline_mode_driver)
+ * 2. drier soil
+ * 3. older request
+ *
+ * Emergency starts are the caller's business: it simply does not queue
+ * them.
+ *
+ * Pure C with no ESP-IDF dependencies and no clock reads: every call takes
+ * the minute of day and a timestamp from the caller, so a host simulation
+ * can run it against an accelerated clock.
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef IRRIGATION_WINDOW_H
+#define IRRIGATION_WINDOW_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================ CONSTANTS ============================ */
+
+#define IRRIGATION_WINDOW_MAX           4       ///< Windows per zone
+#define IRRIGATION_WINDOW_QUEUE_LEN     4       ///< Deferred requests (one per zone)
+#define IRRIGATION_WINDOW_DAY_MINUTES   1440
+
+/* ============================ TYPES ============================ */
+
+/**
+ * @brief One allowed window, [start, end) in minutes since local midnight
+ *
+ * end < start wraps past midnight (e.g. 22:00-02:00).
+ */
+typedef struct {
+    uint16_t start_min;
+    uint16_t end_min;
+} irrigation_window_t;
+
+/**
+ * @brief Allowed windows of one zone (count 0 = always allowed)
+ */
+typedef struct {
+    irrigation_window_t windows[IRRIGATION_WINDOW_MAX];
+    uint8_t count;
+} irrigation_window_schedule_t;
+
+/**
+ * @brief A start waiting for its zone's window
+ */
+typedef struct {
+    uint8_t zone;                   ///< Valve (1-based)
+    uint8_t level;                  ///< Urgency level (offline_level_t), higher first
+    float soil;                     ///< Soil average when last refreshed, drier first
+    int64_t requested_s;            ///< First request time (caller's clock, seconds)
+} irrigation_deferred_t;
+
+/**
+ * @brief Deferred-start queue
+ */
+typedef struct {
+    irrigation_deferred_t entries[IRRIGATION_WINDOW_QUEUE_LEN];
+    uint8_t count;
+} irrigation_deferred_queue_t;
+
+/* ============================ WINDOWS ============================ */
+
+/**
+ * @brief Parse "HH:MM-HH:MM[,HH:MM-HH:MM...]"
+ *
+ * An empty string means no restriction (count 0).
+ *
+ * @param spec Window list
+ * @param[out] schedule Parsed windows (count 0 on failure)
+ * @return false on a syntax error, a time out of range or too many windows
+ */
+bool irrigation_window_parse(const char *spec, irrigation_window_schedule_t *schedule);
+
+/**
+ * @brief True if @p minute_of_day falls in one of the windows
+ */
+bool irrigation_window_is_open(const irrigation_window_schedule_t *schedule,
+                               uint16_t minute_of_day);
+
+/**
+ * @brief Minutes until the next window opens (0 if open now)
+ */
+uint16_t irrigation_window_minutes_until_open(const irrigation_window_schedule_t *schedule,
+                                              uint16_t minute_of_day);
+
+/* ============================ DEFERRED QUEUE ============================ */
+
+/**
+ * @brief Empty the queue
+ */
+void irrigation_deferred_init(irrigation_deferred_queue_t *queue);
+
+/**
+ * @brief Queue a start, or refresh the level and soil of the zone's entry
+ *
+ * A refreshed entry keeps its original request time.
+ *
+ * @return false if the queue is full
+ */
+bool irrigation_deferred_push(irrigation_deferred_queue_t *queue,
+                              const irrigation_deferred_t *request);
+
+/**
+ * @brief Drop the entry of @p zone (soil recovered, manual session...)
+ *
+ * @return true if an entry was removed
+ */
+bool irrigation_deferred_remove(irrigation_deferred_queue_t *queue, uint8_t zone);
+
+/**
+ * @brief True if @p zone has a queued start
+ */
+bool irrigation_deferred_contains(const irrigation_deferred_queue_t *queue, uint8_t zone);
+
+/**
+ * @brief Take the most urgent entry whose zone window is open
+ *
+ * @param queue Queue
+ * @param schedules Windows per zone, indexed by zone - 1
+ * @param zone_count Entries in @p schedules
+ * @param minute_of_day Current local time
+ * @param[out] out Released entry
+ * @return false if no queued zone may start now
+ */
+bool irrigation_deferred_pop_ready(irrigation_deferred_queue_t *queue,
+                                   const irrigation_window_schedule_t *schedules,
+                                   uint8_t zone_count, uint16_t minute_of_day,
+                                   irrigation_deferred_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // IRRIGATION_WINDOW_H
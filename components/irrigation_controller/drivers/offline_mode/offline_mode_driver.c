@@ -12,6 +12,8 @@
 
 #include "offline_mode_driver.h"
 #include "esp_log.h"
+#include "esp_attr.h"
+#include "esp_system.h"
 #include "freertos/portmacro.h"
 #include <time.h>
 #include <string.h>
@@ -69,25 +71,22 @@ static const offline_level_config_t s_level_config[] = {
 /* ============================ PRIVATE STATE ============================ */
 
 /**
- * @brief Offline mode context
+ * @brief Level of the default instance, kept across deep sleep so
+ * hysteresis survives the reboot
  */
-typedef struct {
-    bool is_initialized;
-    bool is_active;
-    offline_level_t current_level;
-    float last_soil_humidity;
-    time_t last_evaluation_time;
-    uint32_t level_change_count;
-    portMUX_TYPE spinlock;
-} offline_mode_context_t;
+static RTC_DATA_ATTR offline_level_t s_rtc_level = OFFLINE_LEVEL_NORMAL;
 
-static offline_mode_context_t s_offline_ctx = {
+/**
+ * @brief Instance behind the functions without a handle
+ */
+static offline_mode_t s_default_offline = {
     .is_initialized = false,
     .is_active = false,
     .current_level = OFFLINE_LEVEL_NORMAL,
     .last_soil_humidity = 50.0f,
     .last_evaluation_time = 0,
     .level_change_count = 0,
+    .retained_level = &s_rtc_level,
     .spinlock = portMUX_INITIALIZER_UNLOCKED
 };
 
@@ -148,28 +147,45 @@ static const char* _get_level_name(offline_level_t level)
     return config->name;
 }
 
-/* ============================ PUBLIC API IMPLEMENTATION ============================ */
+/* ============================ INSTANCE API ============================ */
 
-esp_err_t offline_mode_init(void)
+offline_mode_t* offline_mode_default(void)
+{
+    return &s_default_offline;
+}
+
+esp_err_t offline_mode_instance_init(offline_mode_t* mode)
 {
-    if (s_offline_ctx.is_initialized) {
+    if (mode == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (mode->is_initialized) {
         ESP_LOGW(TAG, "Offline mode already initialized");
         return ESP_OK;
     }
 
     ESP_LOGI(TAG, "Initializing offline mode driver");
 
+    // Resume the pre-sleep level after a deep sleep wakeup
+    offline_level_t initial_level = OFFLINE_LEVEL_NORMAL;
+    if (mode->retained_level != NULL && esp_reset_reason() == ESP_RST_DEEPSLEEP &&
+        *mode->retained_level <= OFFLINE_LEVEL_EMERGENCY) {
+        initial_level = *mode->retained_level;
+    }
+
     // Initialize with defaults
-    portENTER_CRITICAL(&s_offline_ctx.spinlock);
+    portMUX_INITIALIZE(&mode->spinlock);
+    portENTER_CRITICAL(&mode->spinlock);
     {
-        s_offline_ctx.is_active = false;
-        s_offline_ctx.current_level = OFFLINE_LEVEL_NORMAL;
-        s_offline_ctx.last_soil_humidity = 50.0f;
-        s_offline_ctx.last_evaluation_time = time(NULL);
-        s_offline_ctx.level_change_count = 0;
-        s_offline_ctx.is_initialized = true;
+        mode->is_active = false;
+        mode->current_level = initial_level;
+        mode->last_soil_humidity = 50.0f;
+        mode->last_evaluation_time = time(NULL);
+        mode->level_change_count = 0;
+        mode->is_initialized = true;
     }
-    portEXIT_CRITICAL(&s_offline_ctx.spinlock);
+    portEXIT_CRITICAL(&mode->spinlock);
 
     ESP_LOGI(TAG, "Offline mode initialized");
     ESP_LOGI(TAG, "  Level thresholds: NORMAL(45 percent), WARNING(40 percent), CRITICAL(30 percent), EMERGENCY(<30 percent)");
@@ -178,29 +194,33 @@ esp_err_t offline_mode_init(void)
     return ESP_OK;
 }
 
-esp_err_t offline_mode_deinit(void)
+esp_err_t offline_mode_instance_deinit(offline_mode_t* mode)
 {
-    if (!s_offline_ctx.is_initialized) {
+    if (mode == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!mode->is_initialized) {
         return ESP_OK;
     }
 
     ESP_LOGI(TAG, "Deinitializing offline mode driver");
 
-    portENTER_CRITICAL(&s_offline_ctx.spinlock);
+    portENTER_CRITICAL(&mode->spinlock);
     {
-        s_offline_ctx.is_initialized = false;
-        s_offline_ctx.is_active = false;
+        mode->is_initialized = false;
+        mode->is_active = false;
     }
-    portEXIT_CRITICAL(&s_offline_ctx.spinlock);
+    portEXIT_CRITICAL(&mode->spinlock);
 
     return ESP_OK;
 }
 
-offline_evaluation_t offline_mode_evaluate(float soil_humidity_avg)
+offline_evaluation_t offline_mode_instance_evaluate(offline_mode_t* mode, float soil_humidity_avg)
 {
     offline_evaluation_t result = {0};
 
-    if (!s_offline_ctx.is_initialized) {
+    if (mode == NULL || !mode->is_initialized) {
         ESP_LOGW(TAG, "Offline mode not initialized");
         result.level = OFFLINE_LEVEL_NORMAL;
         result.interval_ms = OFFLINE_INTERVAL_NORMAL_MS;
@@ -216,11 +236,11 @@ offline_evaluation_t offline_mode_evaluate(float soil_humidity_avg)
 
     // Get current level
     offline_level_t current_level;
-    portENTER_CRITICAL(&s_offline_ctx.spinlock);
+    portENTER_CRITICAL(&mode->spinlock);
     {
-        current_level = s_offline_ctx.current_level;
+        current_level = mode->current_level;
     }
-    portEXIT_CRITICAL(&s_offline_ctx.spinlock);
+    portEXIT_CRITICAL(&mode->spinlock);
 
     // Evaluate new level with hysteresis
     offline_level_t new_level = _evaluate_level(soil_humidity_avg, current_level);
@@ -236,14 +256,17 @@ offline_evaluation_t offline_mode_evaluate(float soil_humidity_avg)
 
     // Update context if level changed
     if (new_level != current_level) {
-        portENTER_CRITICAL(&s_offline_ctx.spinlock);
+        portENTER_CRITICAL(&mode->spinlock);
         {
-            s_offline_ctx.current_level = new_level;
-            s_offline_ctx.last_soil_humidity = soil_humidity_avg;
-            s_offline_ctx.last_evaluation_time = time(NULL);
-            s_offline_ctx.level_change_count++;
+            mode->current_level = new_level;
+            mode->last_soil_humidity = soil_humidity_avg;
+            mode->last_evaluation_time = time(NULL);
+            mode->level_change_count++;
+        }
+        portEXIT_CRITICAL(&mode->spinlock);
+        if (mode->retained_level != NULL) {
+            *mode->retained_level = new_level;
         }
-        portEXIT_CRITICAL(&s_offline_ctx.spinlock);
 
         ESP_LOGI(TAG, "Offline level changed: %s → %s (soil=%.1f%%, interval=%lu ms)",
                  _get_level_name(current_level),
@@ -258,55 +281,100 @@ offline_evaluation_t offline_mode_evaluate(float soil_humidity_avg)
                  result.interval_ms);
 
         // Still update last soil humidity for trend tracking
-        portENTER_CRITICAL(&s_offline_ctx.spinlock);
+        portENTER_CRITICAL(&mode->spinlock);
         {
-            s_offline_ctx.last_soil_humidity = soil_humidity_avg;
+            mode->last_soil_humidity = soil_humidity_avg;
         }
-        portEXIT_CRITICAL(&s_offline_ctx.spinlock);
+        portEXIT_CRITICAL(&mode->spinlock);
     }
 
     return result;
 }
 
-uint32_t offline_mode_get_interval_ms(offline_level_t level)
+offline_level_t offline_mode_instance_get_current_level(offline_mode_t* mode)
 {
-    const offline_level_config_t* config = _get_level_config(level);
-    return config->interval_ms;
-}
+    offline_level_t level = OFFLINE_LEVEL_NORMAL;
 
-offline_level_t offline_mode_get_current_level(void)
-{
-    offline_level_t level;
+    if (mode == NULL) {
+        return level;
+    }
 
-    portENTER_CRITICAL(&s_offline_ctx.spinlock);
+    portENTER_CRITICAL(&mode->spinlock);
     {
-        if (!s_offline_ctx.is_initialized) {
-            level = OFFLINE_LEVEL_NORMAL;
-        } else {
-            level = s_offline_ctx.current_level;
+        if (mode->is_initialized) {
+            level = mode->current_level;
         }
     }
-    portEXIT_CRITICAL(&s_offline_ctx.spinlock);
+    portEXIT_CRITICAL(&mode->spinlock);
 
     return level;
 }
 
-esp_err_t offline_mode_get_status(offline_mode_status_t* status)
+esp_err_t offline_mode_instance_get_status(offline_mode_t* mode, offline_mode_status_t* status)
 {
-    if (status == NULL) {
+    if (mode == NULL || status == NULL) {
         return ESP_ERR_INVALID_ARG;
     }
 
-    portENTER_CRITICAL(&s_offline_ctx.spinlock);
+    portENTER_CRITICAL(&mode->spinlock);
     {
-        status->is_active = s_offline_ctx.is_active;
-        status->current_level = s_offline_ctx.current_level;
-        status->next_evaluation_time = s_offline_ctx.last_evaluation_time +
-                                      (offline_mode_get_interval_ms(s_offline_ctx.current_level) / 1000);
-        status->last_soil_humidity = s_offline_ctx.last_soil_humidity;
-        status->level_change_count = s_offline_ctx.level_change_count;
+        status->is_active = mode->is_active;
+        status->current_level = mode->current_level;
+        status->next_evaluation_time = mode->last_evaluation_time +
+                                      (offline_mode_get_interval_ms(mode->current_level) / 1000);
+        status->last_soil_humidity = mode->last_soil_humidity;
+        status->level_change_count = mode->level_change_count;
     }
-    portEXIT_CRITICAL(&s_offline_ctx.spinlock);
+    portEXIT_CRITICAL(&mode->spinlock);
 
     return ESP_OK;
 }
+
+/* ============================ PUBLIC API IMPLEMENTATION ============================ */
+
+esp_err_t offline_mode_init(void)
+{
+    return offline_mode_instance_init(&s_default_offline);
+}
+
+esp_err_t offline_mode_deinit(void)
+{
+    return offline_mode_instance_deinit(&s_default_offline);
+}
+
+offline_evaluation_t offline_mode_evaluate(float soil_humidity_avg)
+{
+    return offline_mode_instance_evaluate(&s_default_offline, soil_humidity_avg);
+}
+
+uint32_t offline_mode_get_interval_ms(offline_level_t level)
+{
+    const offline_level_config_t* config = _get_level_config(level);
+    return config->interval_ms;
+}
+
+esp_err_t offline_mode_get_wake_band(offline_level_t level, float* wake_below, float* wake_above)
+{
+    if (wake_below == NULL || wake_above == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const offline_level_config_t* config = _get_level_config(level);
+
+    // Mirrors _evaluate_level(): dropping to a more critical level needs
+    // the hysteresis margin, rising to a less critical one does not
+    *wake_below = config->threshold_low - OFFLINE_LEVEL_HYSTERESIS;
+    *wake_above = config->threshold_high;
+
+    return ESP_OK;
+}
+
+offline_level_t offline_mode_get_current_level(void)
+{
+    return offline_mode_instance_get_current_level(&s_default_offline);
+}
+
+esp_err_t offline_mode_get_status(offline_mode_status_t* status)
+{
+    return offline_mode_instance_get_status(&s_default_offline, status);
+}
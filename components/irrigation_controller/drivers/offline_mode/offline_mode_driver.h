@@ -24,8 +24,10 @@
 
 #include "esp_err.h"
 #include "irrigation_controller.h"
+#include "freertos/FreeRTOS.h"
 #include <stdint.h>
 #include <stdbool.h>
+#include <time.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -61,6 +63,66 @@ typedef struct {
     uint32_t level_change_count;     ///< Total level changes
 } offline_mode_status_t;
 
+/**
+ * @brief Offline mode instance
+ *
+ * One per irrigation controller, allocated by the caller. Set
+ * retained_level, then call offline_mode_instance_init(); the other
+ * members are private. The functions without a handle act on
+ * offline_mode_default().
+ */
+typedef struct {
+    bool is_initialized;
+    bool is_active;
+    offline_level_t current_level;
+    float last_soil_humidity;
+    time_t last_evaluation_time;
+    uint32_t level_change_count;
+    offline_level_t* retained_level;  ///< Survives deep sleep (RTC memory), NULL if none
+    portMUX_TYPE spinlock;
+} offline_mode_t;
+
+/* ============================ INSTANCE API ============================ */
+
+/**
+ * @brief Instance used by the functions without a handle
+ *
+ * Its level is kept in RTC memory across deep sleep.
+ */
+offline_mode_t* offline_mode_default(void);
+
+/**
+ * @brief Initialize an offline mode instance
+ *
+ * After a deep sleep wakeup the level resumes from mode->retained_level,
+ * so hysteresis survives the reboot. Call once, before any other use of
+ * @p mode.
+ *
+ * @param mode Instance to initialize
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if mode is NULL
+ */
+esp_err_t offline_mode_instance_init(offline_mode_t* mode);
+
+/**
+ * @brief Deinitialize an offline mode instance
+ */
+esp_err_t offline_mode_instance_deinit(offline_mode_t* mode);
+
+/**
+ * @brief Evaluate the offline level of an instance (see offline_mode_evaluate())
+ */
+offline_evaluation_t offline_mode_instance_evaluate(offline_mode_t* mode, float soil_humidity_avg);
+
+/**
+ * @brief Most recently evaluated level of an instance
+ */
+offline_level_t offline_mode_instance_get_current_level(offline_mode_t* mode);
+
+/**
+ * @brief Status of an instance
+ */
+esp_err_t offline_mode_instance_get_status(offline_mode_t* mode, offline_mode_status_t* status);
+
 /* ============================ PUBLIC API ============================ */
 
 /**
@@ -109,6 +171,21 @@ offline_evaluation_t offline_mode_evaluate(float soil_humidity_avg);
  */
 uint32_t offline_mode_get_interval_ms(offline_level_t level);
 
+/**
+ * @brief Get the soil humidity band in which a level stays unchanged
+ *
+ * offline_mode_evaluate() would leave @p level once humidity drops below
+ * @p wake_below or reaches @p wake_above. Used to arm the ULP soil
+ * monitor before deep sleep. A bound outside 0-100% means that side can
+ * never trigger a change.
+ *
+ * @param level Offline level
+ * @param[out] wake_below Lower bound (%)
+ * @param[out] wake_above Upper bound (%)
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if an output is NULL
+ */
+esp_err_t offline_mode_get_wake_band(offline_level_t level, float* wake_below, float* wake_above);
+
 /**
  * @brief Get current offline level
  *
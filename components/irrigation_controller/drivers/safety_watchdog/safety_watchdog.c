@@ -11,10 +11,10 @@
  */
 
 #include "safety_watchdog.h"
+#include "time_sync.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/portmacro.h"
-#include <time.h>
 #include <inttypes.h>
 
 /* ============================ PRIVATE STATE ============================ */
@@ -22,58 +22,44 @@
 static const char *TAG = "safety_watchdog";
 
 /**
- * @brief Session timing state
+ * @brief Instance behind the functions without a handle
  */
-typedef struct {
-    time_t session_start_time;      ///< Session start timestamp
-    time_t valve_open_time;         ///< Valve open start time
-    time_t mqtt_override_start_time;///< MQTT override start time
-} watchdog_timers_t;
-
-/**
- * @brief Global watchdog state
- */
-static watchdog_timers_t s_timers = {
-    .session_start_time = 0,
-    .valve_open_time = 0,
-    .mqtt_override_start_time = 0
+static safety_watchdog_t s_default_watchdog = {
+    .spinlock = portMUX_INITIALIZER_UNLOCKED,
+    .is_initialized = false
 };
 
-/**
- * @brief Last evaluation inputs (for debugging)
- */
-static watchdog_inputs_t s_last_inputs = {0};
+/* ============================ INSTANCE API ============================ */
 
-/**
- * @brief Spinlock for thread-safe timer access
- */
-static portMUX_TYPE watchdog_spinlock = portMUX_INITIALIZER_UNLOCKED;
-
-/**
- * @brief Initialization flag
- */
-static bool is_initialized = false;
-
-/* ============================ PUBLIC API ============================ */
+safety_watchdog_t* safety_watchdog_default(void)
+{
+    return &s_default_watchdog;
+}
 
-esp_err_t safety_watchdog_init(void)
+esp_err_t safety_watchdog_instance_init(safety_watchdog_t* wd)
 {
-    if (is_initialized) {
+    if (wd == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (wd->is_initialized) {
         ESP_LOGW(TAG, "Safety watchdog already initialized");
         return ESP_OK;
     }
 
     ESP_LOGI(TAG, "Initializing safety watchdog");
 
-    portENTER_CRITICAL(&watchdog_spinlock);
+    portMUX_INITIALIZE(&wd->spinlock);
+    portENTER_CRITICAL(&wd->spinlock);
     {
-        s_timers.session_start_time = 0;
-        s_timers.valve_open_time = 0;
-        s_timers.mqtt_override_start_time = 0;
+        wd->session_start_time = 0;
+        wd->valve_open_time = 0;
+        wd->mqtt_override_start_time = 0;
+        wd->last_inputs = (watchdog_inputs_t){0};
     }
-    portEXIT_CRITICAL(&watchdog_spinlock);
+    portEXIT_CRITICAL(&wd->spinlock);
 
-    is_initialized = true;
+    wd->is_initialized = true;
 
     // Log safety thresholds for reference
     ESP_LOGI(TAG, "Safety watchdog initialized");
@@ -92,7 +78,8 @@ esp_err_t safety_watchdog_init(void)
     return ESP_OK;
 }
 
-watchdog_alerts_t safety_watchdog_check(const watchdog_inputs_t* inputs)
+watchdog_alerts_t safety_watchdog_instance_check(safety_watchdog_t* wd,
+                                                 const watchdog_inputs_t* inputs)
 {
     watchdog_alerts_t alerts = {
         .session_timeout_exceeded = false,
@@ -103,16 +90,16 @@ watchdog_alerts_t safety_watchdog_check(const watchdog_inputs_t* inputs)
         .rain_detected = false
     };
 
-    if (!is_initialized || inputs == NULL) {
+    if (wd == NULL || !wd->is_initialized || inputs == NULL) {
         return alerts;
     }
 
     // Store last inputs for debugging
-    portENTER_CRITICAL(&watchdog_spinlock);
+    portENTER_CRITICAL(&wd->spinlock);
     {
-        s_last_inputs = *inputs;
+        wd->last_inputs = *inputs;
     }
-    portEXIT_CRITICAL(&watchdog_spinlock);
+    portEXIT_CRITICAL(&wd->spinlock);
 
     /* ==================== SESSION TIMEOUT CHECK ==================== */
     if (inputs->session_duration_ms >= WATCHDOG_SESSION_TIMEOUT_MS) {
@@ -165,65 +152,98 @@ watchdog_alerts_t safety_watchdog_check(const watchdog_inputs_t* inputs)
     return alerts;
 }
 
-esp_err_t safety_watchdog_reset_session(void)
+esp_err_t safety_watchdog_instance_reset_session(safety_watchdog_t* wd)
 {
-    if (!is_initialized) {
+    if (wd == NULL || !wd->is_initialized) {
         return ESP_ERR_INVALID_STATE;
     }
 
-    portENTER_CRITICAL(&watchdog_spinlock);
+    portENTER_CRITICAL(&wd->spinlock);
     {
-        s_timers.session_start_time = time(NULL);
-        ESP_LOGD(TAG, "Session timer reset to %" PRId64, (int64_t)s_timers.session_start_time);
+        wd->session_start_time = time_sync_get_monotonic_ms();
+        ESP_LOGD(TAG, "Session timer reset to %" PRId64, wd->session_start_time);
     }
-    portEXIT_CRITICAL(&watchdog_spinlock);
+    portEXIT_CRITICAL(&wd->spinlock);
 
     return ESP_OK;
 }
 
-esp_err_t safety_watchdog_reset_valve_timer(void)
+esp_err_t safety_watchdog_instance_reset_valve_timer(safety_watchdog_t* wd)
 {
-    if (!is_initialized) {
+    if (wd == NULL || !wd->is_initialized) {
         return ESP_ERR_INVALID_STATE;
     }
 
-    portENTER_CRITICAL(&watchdog_spinlock);
+    portENTER_CRITICAL(&wd->spinlock);
     {
-        s_timers.valve_open_time = time(NULL);
-        ESP_LOGD(TAG, "Valve timer reset to %" PRId64, (int64_t)s_timers.valve_open_time);
+        wd->valve_open_time = time_sync_get_monotonic_ms();
+        ESP_LOGD(TAG, "Valve timer reset to %" PRId64, wd->valve_open_time);
     }
-    portEXIT_CRITICAL(&watchdog_spinlock);
+    portEXIT_CRITICAL(&wd->spinlock);
 
     return ESP_OK;
 }
 
-esp_err_t safety_watchdog_reset_mqtt_timer(void)
+esp_err_t safety_watchdog_instance_reset_mqtt_timer(safety_watchdog_t* wd)
 {
-    if (!is_initialized) {
+    if (wd == NULL || !wd->is_initialized) {
         return ESP_ERR_INVALID_STATE;
     }
 
-    portENTER_CRITICAL(&watchdog_spinlock);
+    portENTER_CRITICAL(&wd->spinlock);
     {
-        s_timers.mqtt_override_start_time = time(NULL);
-        ESP_LOGD(TAG, "MQTT override timer reset to %" PRId64, (int64_t)s_timers.mqtt_override_start_time);
+        wd->mqtt_override_start_time = time_sync_get_monotonic_ms();
+        ESP_LOGD(TAG, "MQTT override timer reset to %" PRId64, wd->mqtt_override_start_time);
     }
-    portEXIT_CRITICAL(&watchdog_spinlock);
+    portEXIT_CRITICAL(&wd->spinlock);
 
     return ESP_OK;
 }
 
-esp_err_t safety_watchdog_get_current_inputs(watchdog_inputs_t* inputs)
+esp_err_t safety_watchdog_instance_get_current_inputs(safety_watchdog_t* wd,
+                                                      watchdog_inputs_t* inputs)
 {
-    if (!is_initialized || inputs == NULL) {
+    if (wd == NULL || !wd->is_initialized || inputs == NULL) {
         return ESP_ERR_INVALID_ARG;
     }
 
-    portENTER_CRITICAL(&watchdog_spinlock);
+    portENTER_CRITICAL(&wd->spinlock);
     {
-        *inputs = s_last_inputs;
+        *inputs = wd->last_inputs;
     }
-    portEXIT_CRITICAL(&watchdog_spinlock);
+    portEXIT_CRITICAL(&wd->spinlock);
 
     return ESP_OK;
 }
+
+/* ============================ PUBLIC API ============================ */
+
+esp_err_t safety_watchdog_init(void)
+{
+    return safety_watchdog_instance_init(&s_default_watchdog);
+}
+
+watchdog_alerts_t safety_watchdog_check(const watchdog_inputs_t* inputs)
+{
+    return safety_watchdog_instance_check(&s_default_watchdog, inputs);
+}
+
+esp_err_t safety_watchdog_reset_session(void)
+{
+    return safety_watchdog_instance_reset_session(&s_default_watchdog);
+}
+
+esp_err_t safety_watchdog_reset_valve_timer(void)
+{
+    return safety_watchdog_instance_reset_valve_timer(&s_default_watchdog);
+}
+
+esp_err_t safety_watchdog_reset_mqtt_timer(void)
+{
+    return safety_watchdog_instance_reset_mqtt_timer(&s_default_watchdog);
+}
+
+esp_err_t safety_watchdog_get_current_inputs(watchdog_inputs_t* inputs)
+{
+    return safety_watchdog_instance_get_current_inputs(&s_default_watchdog, inputs);
+}
@@ -20,6 +20,7 @@
 #define SAFETY_WATCHDOG_H
 
 #include "esp_err.h"
+#include "freertos/FreeRTOS.h"
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -61,6 +62,66 @@ typedef struct {
     bool rain_detected;                 ///< Rain detected (Phase 6 feature)
 } watchdog_alerts_t;
 
+/* ============================ WATCHDOG INSTANCE ============================ */
+
+/**
+ * @brief Safety watchdog instance
+ *
+ * One per irrigation controller, allocated by the caller. Members are
+ * private: set up with safety_watchdog_instance_init(). The functions
+ * without a handle act on safety_watchdog_default().
+ */
+typedef struct {
+    int64_t session_start_time;         ///< Session start (monotonic ms)
+    int64_t valve_open_time;            ///< Valve open start (monotonic ms)
+    int64_t mqtt_override_start_time;   ///< MQTT override start (monotonic ms)
+    watchdog_inputs_t last_inputs;      ///< Last evaluation inputs (debugging)
+    portMUX_TYPE spinlock;
+    bool is_initialized;
+} safety_watchdog_t;
+
+/**
+ * @brief Instance used by the functions without a handle
+ */
+safety_watchdog_t* safety_watchdog_default(void);
+
+/**
+ * @brief Initialize a safety watchdog instance
+ *
+ * Resets its timers. Call once, before any other use of @p wd.
+ *
+ * @param wd Instance to initialize
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if wd is NULL
+ */
+esp_err_t safety_watchdog_instance_init(safety_watchdog_t* wd);
+
+/**
+ * @brief Evaluate safety conditions on an instance (see safety_watchdog_check())
+ */
+watchdog_alerts_t safety_watchdog_instance_check(safety_watchdog_t* wd,
+                                                 const watchdog_inputs_t* inputs);
+
+/**
+ * @brief Reset the session timer of an instance
+ */
+esp_err_t safety_watchdog_instance_reset_session(safety_watchdog_t* wd);
+
+/**
+ * @brief Reset the valve timer of an instance
+ */
+esp_err_t safety_watchdog_instance_reset_valve_timer(safety_watchdog_t* wd);
+
+/**
+ * @brief Reset the MQTT override timer of an instance
+ */
+esp_err_t safety_watchdog_instance_reset_mqtt_timer(safety_watchdog_t* wd);
+
+/**
+ * @brief Last inputs evaluated by an instance (debugging)
+ */
+esp_err_t safety_watchdog_instance_get_current_inputs(safety_watchdog_t* wd,
+                                                      watchdog_inputs_t* inputs);
+
 /* ============================ WATCHDOG API ============================ */
 
 /**
@@ -0,0 +1,178 @@
+/**
+ * @file session_journal.c
+ * @brief Crash-safe irrigation session journal
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "session_journal.h"
+#include "irrigation_controller.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+#include "esp_rtc_time.h"
+#include "nvs.h"
+#include "freertos/FreeRTOS.h"
+#include <stddef.h>
+#include <time.h>
+
+/* ============================ CONSTANTS ============================ */
+
+#define SESSION_JOURNAL_MAGIC       0x4A524E4C  // "JRNL"
+#define SESSION_JOURNAL_VERSION     1
+#define SESSION_JOURNAL_NVS_KEY     "journal"
+
+/* ============================ PRIVATE TYPES ============================ */
+
+/**
+ * @brief Stored record (RTC and NVS copies share the layout)
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    session_journal_entry_t entry;
+    uint32_t reserved;              ///< Keeps rtc_us aligned without padding in the CRC
+    uint64_t rtc_us;                ///< RTC timer when written
+    int64_t wall_s;                 ///< Wall clock when written (0 = not set)
+    uint32_t crc;                   ///< CRC32 of every field above
+} session_journal_record_t;
+
+/* ============================ PRIVATE STATE ============================ */
+
+static const char *TAG = "session_journal";
+
+/**
+ * @brief RTC copy: not initialized at boot, so it survives soft resets
+ */
+static RTC_NOINIT_ATTR session_journal_record_t s_rtc_record;
+
+static portMUX_TYPE s_journal_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+/* ============================ PRIVATE FUNCTIONS ============================ */
+
+static uint32_t journal_crc(const session_journal_record_t *record)
+{
+    return esp_rom_crc32_le(0, (const uint8_t *)record, offsetof(session_journal_record_t, crc));
+}
+
+static bool journal_is_valid(const session_journal_record_t *record)
+{
+    return record->magic == SESSION_JOURNAL_MAGIC &&
+           record->version == SESSION_JOURNAL_VERSION &&
+           record->crc == journal_crc(record);
+}
+
+/**
+ * @brief Wall clock, 0 before it was ever set (1970 after a power loss)
+ */
+static int64_t journal_wall_s(void)
+{
+    time_t now = time(NULL);
+    return (now > 1700000000) ? (int64_t)now : 0;
+}
+
+/* ============================ PUBLIC API ============================ */
+
+esp_err_t session_journal_read(session_journal_entry_t *entry,
+                               session_journal_source_t *source,
+                               int64_t *downtime_ms)
+{
+    if (entry == NULL || source == NULL || downtime_ms == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    session_journal_record_t record;
+    portENTER_CRITICAL(&s_journal_spinlock);
+    {
+        record = s_rtc_record;
+    }
+    portEXIT_CRITICAL(&s_journal_spinlock);
+
+    if (journal_is_valid(&record)) {
+        uint64_t now_us = esp_rtc_get_time_us();
+        *entry = record.entry;
+        *source = SESSION_JOURNAL_RTC;
+        *downtime_ms = (now_us >= record.rtc_us) ? (int64_t)((now_us - record.rtc_us) / 1000) : -1;
+        return ESP_OK;
+    }
+
+    // RTC copy lost: fall back to the last checkpoint
+    nvs_handle_t nvs_handle;
+    esp_err_t ret = nvs_open(IRRIGATION_CONTROLLER_NVS_NAMESPACE, NVS_READONLY, &nvs_handle);
+    if (ret == ESP_OK) {
+        size_t size = sizeof(record);
+        ret = nvs_get_blob(nvs_handle, SESSION_JOURNAL_NVS_KEY, &record, &size);
+        nvs_close(nvs_handle);
+        if (ret == ESP_OK && (size != sizeof(record) || !journal_is_valid(&record))) {
+            ret = ESP_ERR_INVALID_CRC;
+        }
+    }
+
+    if (ret != ESP_OK) {
+        *source = SESSION_JOURNAL_NONE;
+        *downtime_ms = -1;
+        if (ret == ESP_ERR_INVALID_CRC) {
+            ESP_LOGW(TAG, "NVS journal checkpoint invalid, ignored");
+        }
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    int64_t wall_s = journal_wall_s();
+    *entry = record.entry;
+    *source = SESSION_JOURNAL_NVS;
+    *downtime_ms = (record.wall_s > 0 && wall_s >= record.wall_s) ? (wall_s - record.wall_s) * 1000 : -1;
+    return ESP_OK;
+}
+
+esp_err_t session_journal_write(const session_journal_entry_t *entry, bool checkpoint)
+{
+    if (entry == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    session_journal_record_t record = {
+        .magic = SESSION_JOURNAL_MAGIC,
+        .version = SESSION_JOURNAL_VERSION,
+        .entry = *entry,
+        .rtc_us = esp_rtc_get_time_us(),
+        .wall_s = journal_wall_s(),
+    };
+    record.crc = journal_crc(&record);
+
+    portENTER_CRITICAL(&s_journal_spinlock);
+    {
+        s_rtc_record = record;
+    }
+    portEXIT_CRITICAL(&s_journal_spinlock);
+
+    if (!checkpoint) {
+        return ESP_OK;
+    }
+
+    nvs_handle_t nvs_handle;
+    esp_err_t ret = nvs_open(IRRIGATION_CONTROLLER_NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+    if (ret == ESP_OK) {
+        ret = nvs_set_blob(nvs_handle, SESSION_JOURNAL_NVS_KEY, &record, sizeof(record));
+        if (ret == ESP_OK) {
+            ret = nvs_commit(nvs_handle);
+        }
+        nvs_close(nvs_handle);
+    }
+
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Journal checkpoint failed: %s", esp_err_to_name(ret));
+    }
+    return ret;
+}
+
+const char* session_journal_source_to_string(session_journal_source_t source)
+{
+    switch (source) {
+        case SESSION_JOURNAL_RTC:   return "rtc";
+        case SESSION_JOURNAL_NVS:   return "nvs";
+        case SESSION_JOURNAL_NONE:
+        default:                    return "none";
+    }
+}
@@ -0,0 +1,99 @@
+/**
+ * @file session_journal.h
+ * @brief Crash-safe irrigation session journal
+ *
+ * Keeps the controller state needed to survive a watchdog reset, panic or
+ * brownout (session progress, daily runtime, next allowed session, safety
+ * lock) in two places:
+ *
+ * - RTC slow memory (RTC_NOINIT_ATTR): rewritten on every change, survives
+ *   every reset except power loss and is read back in microseconds
+ * - NVS: checkpoint on state transitions only (bounded flash writes), used
+ *   when the RTC copy is gone after a power loss
+ *
+ * Both copies carry a magic, a version and a CRC32. Downtime is measured
+ * with the RTC timer, which keeps running across soft resets; after a
+ * power loss it is only known if the wall clock was restored.
+ *
+ * Thread-Safety:
+ * - session_journal_write() may be called from any task or esp_timer
+ *   callback as long as checkpoint is false
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef SESSION_JOURNAL_H
+#define SESSION_JOURNAL_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================ TYPES ============================ */
+
+/**
+ * @brief Journaled controller state
+ */
+typedef struct {
+    uint8_t state;                  ///< irrigation_state_t
+    uint8_t valve;                  ///< Active valve (0 = none)
+    uint8_t safety_lock;            ///< Emergency stop lock
+    uint8_t pulse_count;            ///< Pulse program size (0 = continuous)
+    int16_t stats_day;              ///< Local day-of-year of today_runtime_sec (-1 = unknown)
+    uint16_t planned_duration_min;  ///< Learned-model plan (0 = closed loop)
+    uint16_t session_duration_min;  ///< Requested duration of the session
+    uint16_t reserved;
+    uint32_t session_water_ms;      ///< Valve-open time of the session so far
+    uint32_t today_runtime_sec;     ///< Daily runtime, completed sessions
+    uint32_t session_count;         ///< Sessions started
+    uint32_t next_allowed_in_ms;    ///< Minimum interval left
+} session_journal_entry_t;
+
+/**
+ * @brief Where session_journal_read() found the journal
+ */
+typedef enum {
+    SESSION_JOURNAL_NONE = 0,       ///< Nothing valid (first boot)
+    SESSION_JOURNAL_RTC,            ///< RTC slow memory (soft reset, deep sleep)
+    SESSION_JOURNAL_NVS             ///< Last NVS checkpoint (power loss)
+} session_journal_source_t;
+
+/* ============================ API ============================ */
+
+/**
+ * @brief Read the journal left by the previous boot
+ *
+ * @param[out] entry Journaled state
+ * @param[out] source Copy used
+ * @param[out] downtime_ms Time since the journal was written, -1 if unknown
+ * @return ESP_OK if a valid journal was found, ESP_ERR_NOT_FOUND otherwise
+ */
+esp_err_t session_journal_read(session_journal_entry_t *entry,
+                               session_journal_source_t *source,
+                               int64_t *downtime_ms);
+
+/**
+ * @brief Record the current state
+ *
+ * @param entry State to record
+ * @param checkpoint Also write the NVS copy (state transitions only)
+ * @return ESP_OK on success, NVS error if the checkpoint failed
+ */
+esp_err_t session_journal_write(const session_journal_entry_t *entry, bool checkpoint);
+
+/**
+ * @brief Source name for logging
+ */
+const char* session_journal_source_to_string(session_journal_source_t source);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SESSION_JOURNAL_H
@@ -0,0 +1,117 @@
+/**
+ * @file soil_response_model.c
+ * @brief Learned soil-moisture response to irrigation time
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "soil_response_model.h"
+#include <math.h>
+#include <string.h>
+
+#define SOIL_RESPONSE_MAX_SESSIONS  0xFFFF
+
+void soil_response_model_reset(soil_response_model_t *model)
+{
+    memset(model, 0, sizeof(*model));
+    model->version = SOIL_RESPONSE_MODEL_VERSION;
+}
+
+bool soil_response_model_is_valid(const soil_response_model_t *model)
+{
+    return model->version == SOIL_RESPONSE_MODEL_VERSION &&
+           model->sum_w >= 0.0f && model->sum_tt >= 0.0f;
+}
+
+bool soil_response_model_update(soil_response_model_t *model,
+                                const soil_response_observation_t *obs,
+                                float forgetting)
+{
+    float t = obs->minutes;
+    float rise_soak = obs->soil_soaked - obs->soil_start;
+    float rise_imm = obs->soil_stop - obs->soil_start;
+
+    if (t < SOIL_RESPONSE_MIN_MINUTES || rise_soak <= 0.0f) {
+        return false;
+    }
+    if (rise_imm < 0.0f) {
+        rise_imm = 0.0f;
+    }
+    if (forgetting <= 0.0f || forgetting > 1.0f) {
+        forgetting = 1.0f;
+    }
+
+    model->sum_w = forgetting * model->sum_w + 1.0f;
+    model->sum_tt = forgetting * model->sum_tt + t * t;
+    model->sum_t_soak = forgetting * model->sum_t_soak + t * rise_soak;
+    model->sum_soak_soak = forgetting * model->sum_soak_soak + rise_soak * rise_soak;
+    model->sum_t_imm = forgetting * model->sum_t_imm + t * rise_imm;
+
+    if (model->sessions < SOIL_RESPONSE_MAX_SESSIONS) {
+        model->sessions++;
+    }
+    return true;
+}
+
+float soil_response_model_gain(const soil_response_model_t *model)
+{
+    if (model->sum_tt <= 0.0f) {
+        return 0.0f;
+    }
+    return model->sum_t_soak / model->sum_tt;
+}
+
+float soil_response_model_immediate_gain(const soil_response_model_t *model)
+{
+    if (model->sum_tt <= 0.0f) {
+        return 0.0f;
+    }
+    return model->sum_t_imm / model->sum_tt;
+}
+
+float soil_response_model_residual(const soil_response_model_t *model)
+{
+    if (model->sum_w <= 0.0f || model->sum_tt <= 0.0f) {
+        return 0.0f;
+    }
+
+    // Weighted SSE of a fit through the origin: Syy - Sxy^2 / Sxx
+    float sse = model->sum_soak_soak -
+                (model->sum_t_soak * model->sum_t_soak) / model->sum_tt;
+    if (sse <= 0.0f) {
+        return 0.0f;
+    }
+    return sqrtf(sse / model->sum_w);
+}
+
+bool soil_response_model_ready(const soil_response_model_t *model, uint16_t min_sessions)
+{
+    return soil_response_model_is_valid(model) &&
+           model->sessions >= min_sessions &&
+           soil_response_model_gain(model) >= SOIL_RESPONSE_MIN_GAIN;
+}
+
+float soil_response_model_plan(const soil_response_model_t *model,
+                               float current, float target, float max_minutes)
+{
+    float deficit = target - current;
+    float gain = soil_response_model_gain(model);
+
+    if (deficit <= 0.0f) {
+        return 0.0f;
+    }
+    if (gain < SOIL_RESPONSE_MIN_GAIN) {
+        return max_minutes;
+    }
+
+    float minutes = deficit / gain;
+    if (minutes < SOIL_RESPONSE_MIN_MINUTES) {
+        minutes = SOIL_RESPONSE_MIN_MINUTES;
+    }
+    if (minutes > max_minutes) {
+        minutes = max_minutes;
+    }
+    return minutes;
+}
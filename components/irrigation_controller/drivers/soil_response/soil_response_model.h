@@ -0,0 +1,123 @@
+/**
+ * @file soil_response_model.h
+ * @brief Learned soil-moisture response to irrigation time
+ *
+ * Fits, per zone, how many soil humidity points one minute of irrigation
+ * adds. Two gains are learned from every completed session with
+ * exponentially-forgetting least squares through the origin:
+ *
+ * - soak gain: rise measured after the water has infiltrated (used to
+ *   plan the session duration, so the soil settles at the target instead
+ *   of overshooting it)
+ * - immediate gain: rise seen by the probes when the valve closes (used
+ *   to verify a planned session is tracking the model)
+ *
+ * Pure C with no ESP-IDF dependencies, so it can be exercised on a host
+ * against a simulated soil.
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef SOIL_RESPONSE_MODEL_H
+#define SOIL_RESPONSE_MODEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================ CONSTANTS ============================ */
+
+#define SOIL_RESPONSE_MODEL_VERSION     1
+#define SOIL_RESPONSE_MIN_GAIN          0.05f   ///< %/min below which a plan is not trusted
+#define SOIL_RESPONSE_MIN_MINUTES       1.0f    ///< Shorter sessions are not learned from
+
+/* ============================ TYPES ============================ */
+
+/**
+ * @brief Weighted sums of one zone (stored as an NVS blob)
+ */
+typedef struct {
+    uint8_t version;                ///< SOIL_RESPONSE_MODEL_VERSION
+    uint8_t reserved;
+    uint16_t sessions;              ///< Sessions learned from (saturates)
+    float sum_w;                    ///< Sum of weights
+    float sum_tt;                   ///< Sum of w * minutes^2
+    float sum_t_soak;               ///< Sum of w * minutes * soaked rise
+    float sum_soak_soak;            ///< Sum of w * soaked rise^2
+    float sum_t_imm;                ///< Sum of w * minutes * immediate rise
+} soil_response_model_t;
+
+/**
+ * @brief One completed session
+ */
+typedef struct {
+    float minutes;                  ///< Valve open time
+    float soil_start;               ///< Soil average when the valve opened
+    float soil_stop;                ///< Soil average when the valve closed
+    float soil_soaked;              ///< Soil average after the soak time
+} soil_response_observation_t;
+
+/* ============================ API ============================ */
+
+/**
+ * @brief Clear a model (no sessions learned)
+ */
+void soil_response_model_reset(soil_response_model_t *model);
+
+/**
+ * @brief True if @p model was produced by this version of the code
+ */
+bool soil_response_model_is_valid(const soil_response_model_t *model);
+
+/**
+ * @brief Learn from one session
+ *
+ * Older sessions are down-weighted by @p forgetting (1.0 = never forget),
+ * so the model follows seasonal changes in infiltration.
+ *
+ * @return false if the observation was rejected (too short, or soil did
+ *         not rise: rain, sensor fault) and the model is unchanged
+ */
+bool soil_response_model_update(soil_response_model_t *model,
+                                const soil_response_observation_t *obs,
+                                float forgetting);
+
+/**
+ * @brief True once @p min_sessions were learned and the gain is usable
+ */
+bool soil_response_model_ready(const soil_response_model_t *model, uint16_t min_sessions);
+
+/**
+ * @brief Soaked rise per irrigation minute (%/min, 0 if nothing learned)
+ */
+float soil_response_model_gain(const soil_response_model_t *model);
+
+/**
+ * @brief Rise per irrigation minute seen when the valve closes (%/min)
+ */
+float soil_response_model_immediate_gain(const soil_response_model_t *model);
+
+/**
+ * @brief RMS residual of the soaked fit (% soil humidity)
+ */
+float soil_response_model_residual(const soil_response_model_t *model);
+
+/**
+ * @brief Minutes of irrigation to bring the soil from @p current to @p target
+ *
+ * @return Duration clamped to [SOIL_RESPONSE_MIN_MINUTES, max_minutes],
+ *         0 if the soil is already at the target
+ */
+float soil_response_model_plan(const soil_response_model_t *model,
+                               float current, float target, float max_minutes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SOIL_RESPONSE_MODEL_H
@@ -19,171 +19,1451 @@
 #include "drivers/valve_driver/valve_driver.h"
 #include "drivers/safety_watchdog/safety_watchdog.h"
 #include "drivers/offline_mode/offline_mode_driver.h"
+#include "drivers/soil_response/soil_response_model.h"
+#include "drivers/irrigation_window/irrigation_window.h"
+#include "drivers/session_journal/session_journal.h"
+#include "drivers/irrigation_stats/irrigation_stats.h"
 #include "sensor_reader.h"
+#include "sensor_scheduler.h"
 #include "wifi_manager.h"
 #include "device_config.h"
+#include "time_sync.h"
+#include "deferred_log.h"
+#include "decision_log.h"
+#include "event_bus.h"
+#include "ulp_soil_monitor.h"
 #include "esp_log.h"
+#include "esp_sleep.h"
+#include "nvs.h"
 #include "sdkconfig.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "freertos/portmacro.h"
+#include "esp_timer.h"
 #include <time.h>
 #include <string.h>
+#include <math.h>
 #include <inttypes.h>
 
+#ifndef CONFIG_IRRIGATION_TASK_STACK_SIZE
+#define CONFIG_IRRIGATION_TASK_STACK_SIZE 4096
+#endif
+
+#ifndef CONFIG_IRRIGATION_DEEP_SLEEP_MIN_AWAKE_S
+#define CONFIG_IRRIGATION_DEEP_SLEEP_MIN_AWAKE_S 90
+#endif
+
+#ifndef CONFIG_IRRIGATION_SOIL_MODEL_MIN_SESSIONS
+#define CONFIG_IRRIGATION_SOIL_MODEL_MIN_SESSIONS 3
+#endif
+
+#ifndef CONFIG_IRRIGATION_SOIL_MODEL_SOAK_MINUTES
+#define CONFIG_IRRIGATION_SOIL_MODEL_SOAK_MINUTES 10
+#endif
+
+#ifndef CONFIG_IRRIGATION_SOIL_MODEL_FORGETTING_PCT
+#define CONFIG_IRRIGATION_SOIL_MODEL_FORGETTING_PCT 90
+#endif
+
+#ifndef CONFIG_IRRIGATION_SOIL_MODEL_VERIFY_TOLERANCE
+#define CONFIG_IRRIGATION_SOIL_MODEL_VERIFY_TOLERANCE 5
+#endif
+
+#ifndef CONFIG_IRRIGATION_PULSE_ON_MINUTES
+#define CONFIG_IRRIGATION_PULSE_ON_MINUTES 10
+#endif
+
+#ifndef CONFIG_IRRIGATION_PULSE_SOAK_MINUTES
+#define CONFIG_IRRIGATION_PULSE_SOAK_MINUTES 20
+#endif
+
+#ifndef CONFIG_IRRIGATION_PULSE_COUNT
+#define CONFIG_IRRIGATION_PULSE_COUNT 3
+#endif
+
+// Empty = no time-of-day restriction (also when IRRIGATION_WINDOW_ENABLE is off)
+#ifndef CONFIG_IRRIGATION_WINDOW_ZONE1
+#define CONFIG_IRRIGATION_WINDOW_ZONE1 ""
+#endif
+
+#ifndef CONFIG_IRRIGATION_WINDOW_ZONE2
+#define CONFIG_IRRIGATION_WINDOW_ZONE2 ""
+#endif
+
+#ifndef CONFIG_IRRIGATION_JOURNAL_RESUME_MAX_S
+#define CONFIG_IRRIGATION_JOURNAL_RESUME_MAX_S 300
+#endif
+
+#ifndef CONFIG_IRRIGATION_STATS_CHECKPOINT_MINUTES
+#define CONFIG_IRRIGATION_STATS_CHECKPOINT_MINUTES 30
+#endif
+
+#define IRRIGATION_FIRST_SAMPLE_WAIT_MS   10000   // DHT22 + soil scan at boot
+#define IRRIGATION_ZONE_COUNT             2       // One soil response model per valve
+#define IRRIGATION_MODEL_NVS_NAMESPACE    "irrig_model"
+#define IRRIGATION_OFFLINE_DEFAULT_MIN    20      // Offline auto-start without a learned model
+#define IRRIGATION_ONLINE_DEFAULT_MIN     15      // Online recommendation without a learned model
+
 /* ============================ PRIVATE TYPES ============================ */
 
 /**
- * @brief Internal irrigation controller context
+ * @brief Internal irrigation controller context
+ *
+ * Maintains complete state of the irrigation system. The evaluation task,
+ * the pulse timer and the public API reach it through a pointer to
+ * s_irrig_ctx.
+ */
+typedef struct {
+    // Configuration
+    irrigation_controller_config_t config;
+
+    // Current session state
+    irrigation_state_t current_state;
+    irrigation_mode_t current_mode;
+    int64_t session_start_ms;           ///< Session start (monotonic ms, may be <= 0 for a session resumed after a reset)
+    bool session_active;                ///< A session is running (session_start_ms is valid)
+    time_t last_session_end_time;
+    uint16_t current_session_duration_min;
+    bool is_valve_open;
+    uint8_t active_valve_num;
+
+    // MQTT override
+    bool mqtt_override_active;
+    char mqtt_override_command[20];
+    time_t mqtt_override_start_time;
+
+    // Statistics
+    uint32_t session_count;
+    uint32_t total_runtime_today_sec;
+    int16_t stats_day;                  ///< Local day-of-year of daily stats (-1 = clock unsynced)
+
+    // Online/offline detection
+    bool is_online;
+    time_t last_online_check;
+
+    // Safety
+    bool safety_lock;
+    bool thermal_protection_active;
+    int64_t next_allowed_session_ms;    ///< Earliest next session (monotonic ms)
+
+    // Last evaluation
+    irrigation_evaluation_t last_evaluation;
+    time_t last_eval_time;
+
+    // Startup stabilization
+    uint8_t startup_cycles_remaining;  ///< Remaining startup cycles (10 cycles at 60s for stabilization)
+
+    // Learned soil response (see drivers/soil_response)
+    float session_start_soil;           ///< Soil average when the valve opened (<0 = unknown)
+    int64_t plan_end_ms;                ///< Model-planned stop (monotonic ms, 0 = closed loop)
+    uint16_t planned_duration_min;      ///< Model-planned duration (0 = closed loop)
+    bool learn_pending;                 ///< Last session waits for its soaked sample
+    uint8_t learn_zone;                 ///< Valve of the pending session
+    int64_t learn_due_ms;               ///< End of the soak time (monotonic ms)
+    uint32_t learn_after_id;            ///< Learn from a sample newer than this (0 = not armed)
+    soil_response_observation_t learn_obs;
+
+    // Cycle-and-soak pulse program (driven by pulse_timer)
+    uint8_t pulse_count;                ///< Pulses in the program (0 = continuous session)
+    uint8_t pulse_index;                ///< Current pulse (1-based)
+    bool pulse_soaking;                 ///< Valve closed between two pulses
+    bool pulse_done_notify;             ///< Program finished by a phase change, notify after the sample
+    uint32_t pulse_on_ms;               ///< On-period length
+    uint32_t pulse_soak_ms;             ///< Soak-period length
+    int64_t pulse_phase_start_ms;       ///< Start of the current on/soak period (monotonic ms)
+    int64_t pulse_phase_end_ms;         ///< Timer deadline of the current period (0 = not armed)
+    uint32_t pulse_water_ms;            ///< On-time of the completed pulses
+
+    // Per-zone learned response, windows and deferred starts (index = valve - 1)
+    soil_response_model_t soil_models[IRRIGATION_ZONE_COUNT];   ///< Written only by the evaluation task
+    irrigation_window_schedule_t windows[IRRIGATION_ZONE_COUNT];
+    irrigation_deferred_queue_t deferred;   ///< Automatic starts waiting for their window
+
+    // Collaborators (the driver default instances, set by init)
+    safety_watchdog_t* watchdog;
+    offline_mode_t* offline;
+
+    // Runtime resources
+    esp_timer_handle_t pulse_timer;     ///< One-shot timer waking the task at each pulse on/soak deadline
+    SemaphoreHandle_t pulse_mutex;      ///< Pulse phase changes vs. session stops (see irrigation_pulse_cancel())
+    TaskHandle_t task_handle;           ///< Evaluation task (cleared by the task when it exits)
+    bool task_exit;                     ///< Stop requested: the evaluation task leaves its loop
+    portMUX_TYPE spinlock;              ///< Thread-safe state access
+    bool is_initialized;
+} irrigation_controller_context_t;
+
+/* ============================ PRIVATE STATE ============================ */
+
+static const char *TAG = "irrigation_controller";
+
+/**
+ * @brief Global irrigation controller context
+ */
+static irrigation_controller_context_t s_irrig_ctx = {
+    .current_state = IRRIGATION_IDLE,
+    .current_mode = IRRIGATION_MODE_ONLINE,
+    .is_valve_open = false,
+    .active_valve_num = 0,
+    .mqtt_override_active = false,
+    .session_count = 0,
+    .total_runtime_today_sec = 0,
+    .stats_day = -1,
+    .is_online = false,
+    .safety_lock = false,
+    .thermal_protection_active = false,
+    .startup_cycles_remaining = 10,  // First 10 cycles at 60s for stabilization
+    .session_start_soil = -1.0f,
+    .spinlock = portMUX_INITIALIZER_UNLOCKED,
+    .is_initialized = false
+};
+
+/* ============================ PRIVATE FUNCTIONS ============================ */
+
+// Forward declarations for state handlers
+static void irrigation_state_idle_handler(irrigation_controller_context_t* ctx, const sensor_reading_t* reading);
+static void irrigation_state_running_handler(irrigation_controller_context_t* ctx, const sensor_reading_t* reading);
+static void irrigation_state_error_handler(irrigation_controller_context_t* ctx, const sensor_reading_t* reading);
+static void irrigation_state_thermal_stop_handler(irrigation_controller_context_t* ctx,
+                                                  const sensor_reading_t* reading);
+static void irrigation_state_soak_handler(irrigation_controller_context_t* ctx, const sensor_reading_t* reading);
+
+/**
+ * @brief Reset daily statistics when the local date changes
+ *
+ * Only acts once wall-clock time is valid, so an unsynced boot does not
+ * count as a new day.
+ */
+static void irrigation_check_day_rollover(irrigation_controller_context_t* ctx)
+{
+    if (!time_sync_is_valid()) {
+        return;
+    }
+
+    time_t now = time(NULL);
+    struct tm timeinfo;
+    localtime_r(&now, &timeinfo);
+
+    int16_t previous_day;
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        previous_day = ctx->stats_day;
+        ctx->stats_day = (int16_t)timeinfo.tm_yday;
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+
+    if (previous_day >= 0 && previous_day != timeinfo.tm_yday) {
+        irrigation_controller_reset_daily_stats();
+    }
+}
+
+/**
+ * @brief Load the learned soil response of every zone from NVS
+ *
+ * A missing or outdated blob leaves the zone unlearned.
+ */
+static void irrigation_model_load(irrigation_controller_context_t* ctx)
+{
+    for (uint8_t zone = 0; zone < IRRIGATION_ZONE_COUNT; zone++) {
+        soil_response_model_reset(&ctx->soil_models[zone]);
+    }
+
+#if CONFIG_IRRIGATION_SOIL_MODEL_ENABLE
+    nvs_handle_t nvs_handle;
+    if (nvs_open(IRRIGATION_MODEL_NVS_NAMESPACE, NVS_READONLY, &nvs_handle) != ESP_OK) {
+        return;     // Nothing learned yet
+    }
+
+    for (uint8_t zone = 0; zone < IRRIGATION_ZONE_COUNT; zone++) {
+        char key[8];
+        snprintf(key, sizeof(key), "zone%u", zone + 1);
+
+        soil_response_model_t model;
+        size_t size = sizeof(model);
+        if (nvs_get_blob(nvs_handle, key, &model, &size) == ESP_OK &&
+            size == sizeof(model) && soil_response_model_is_valid(&model)) {
+            ctx->soil_models[zone] = model;
+            ESP_LOGI(TAG, "Zone %u soil response: %.2f %%/min (%u sessions, residual %.1f%%)",
+                     zone + 1, soil_response_model_gain(&model), model.sessions,
+                     soil_response_model_residual(&model));
+        }
+    }
+    nvs_close(nvs_handle);
+#endif
+}
+
+/**
+ * @brief Persist the learned soil response of one zone
+ */
+static void irrigation_model_save(irrigation_controller_context_t* ctx, uint8_t zone)
+{
+    char key[8];
+    snprintf(key, sizeof(key), "zone%u", zone + 1);
+
+    soil_response_model_t model;
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        model = ctx->soil_models[zone];
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+
+    nvs_handle_t nvs_handle;
+    esp_err_t ret = nvs_open(IRRIGATION_MODEL_NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+    if (ret == ESP_OK) {
+        ret = nvs_set_blob(nvs_handle, key, &model, sizeof(model));
+        if (ret == ESP_OK) {
+            ret = nvs_commit(nvs_handle);
+        }
+        nvs_close(nvs_handle);
+    }
+
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to save zone %u soil response: %s", zone + 1, esp_err_to_name(ret));
+    }
+}
+
+/**
+ * @brief Session duration the learned model needs to reach the optimal level
+ *
+ * @param valve Valve of the session (1-2)
+ * @param soil_avg Current soil average
+ * @return Minutes, or 0 if the zone has no usable model yet
+ */
+static uint16_t irrigation_model_plan_minutes(irrigation_controller_context_t* ctx, uint8_t valve, float soil_avg)
+{
+#if CONFIG_IRRIGATION_SOIL_MODEL_ENABLE
+    if (valve < 1 || valve > IRRIGATION_ZONE_COUNT) {
+        return 0;
+    }
+
+    soil_response_model_t model;
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        model = ctx->soil_models[valve - 1];
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+
+    if (!soil_response_model_ready(&model, CONFIG_IRRIGATION_SOIL_MODEL_MIN_SESSIONS)) {
+        return 0;
+    }
+
+    float minutes = soil_response_model_plan(&model, soil_avg,
+                                             ctx->config.soil_threshold_optimal,
+                                             (float)ctx->config.max_duration_minutes);
+    return (uint16_t)ceilf(minutes);
+#else
+    (void)valve;
+    (void)soil_avg;
+    return 0;
+#endif
+}
+
+/**
+ * @brief Time water has flowed in the current session (call under the spinlock)
+ *
+ * Soak periods of a pulse program do not count, so they do not consume
+ * the daily budget or the watchdog session limit.
+ */
+static int64_t irrigation_session_water_ms_locked(irrigation_controller_context_t* ctx, int64_t now_ms)
+{
+    if (ctx->pulse_count == 0) {
+        return now_ms - ctx->session_start_ms;
+    }
+    int64_t water_ms = ctx->pulse_water_ms;
+    if (!ctx->pulse_soaking && ctx->pulse_phase_start_ms > 0) {
+        water_ms += now_ms - ctx->pulse_phase_start_ms;
+    }
+    return water_ms;
+}
+
+/**
+ * @brief Record the controller state in the session journal
+ *
+ * The RTC copy is cheap and safe from the pulse timer; pass @p checkpoint
+ * only from task context on state transitions (NVS write).
+ */
+static void irrigation_journal_save(irrigation_controller_context_t* ctx, bool checkpoint)
+{
+    int64_t now_ms = time_sync_get_monotonic_ms();
+    session_journal_entry_t entry;
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        bool in_session = ctx->is_valve_open || ctx->pulse_count > 0;
+        entry = (session_journal_entry_t){
+            .state = (uint8_t)ctx->current_state,
+            .valve = ctx->active_valve_num,
+            .safety_lock = ctx->safety_lock ? 1 : 0,
+            .pulse_count = ctx->pulse_count,
+            .stats_day = ctx->stats_day,
+            .planned_duration_min = ctx->planned_duration_min,
+            .session_duration_min = ctx->current_session_duration_min,
+            .session_water_ms = in_session ? (uint32_t)irrigation_session_water_ms_locked(ctx, now_ms) : 0,
+            .today_runtime_sec = ctx->total_runtime_today_sec,
+            .session_count = ctx->session_count,
+            .next_allowed_in_ms = (ctx->next_allowed_session_ms > now_ms)
+                ? (uint32_t)(ctx->next_allowed_session_ms - now_ms) : 0,
+        };
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+
+    session_journal_write(&entry, checkpoint);
+}
+
+/**
+ * @brief Soil average of the latest scheduler sample (-1 if unavailable)
+ */
+static float irrigation_latest_soil_avg(void)
+{
+    sensor_reading_t latest;
+    if (sensor_scheduler_get_latest(&latest) != ESP_OK || latest.soil.valid_mask == 0) {
+        return -1.0f;
+    }
+    return sensor_reader_soil_average(&latest.soil);
+}
+
+/**
+ * @brief Append a decision to the flash log together with its inputs
+ *
+ * Safe from the pulse timer (decision_log_append() only queues).
+ *
+ * @param event What happened
+ * @param reason Why
+ * @param valve Valve acted on (0 = none)
+ * @param value Event value (see decision_log_record_t)
+ * @param arg Event argument (see decision_log_record_t)
+ * @param reading Sample the decision was based on (NULL = latest sample)
+ */
+static void irrigation_log_decision(irrigation_controller_context_t* ctx,
+                                    decision_log_event_t event, decision_reason_t reason,
+                                    uint8_t valve, uint16_t value, uint8_t arg,
+                                    const sensor_reading_t* reading)
+{
+    decision_log_record_t record = {
+        .event = (uint8_t)event,
+        .reason = (uint8_t)reason,
+        .valve = valve,
+        .value = value,
+        .arg = arg,
+        .level = DECISION_LOG_LEVEL_NONE,
+    };
+    memset(record.soil, DECISION_LOG_SOIL_NONE, sizeof(record.soil));
+
+    sensor_reading_t latest;
+    if (reading == NULL && sensor_scheduler_get_latest(&latest) == ESP_OK) {
+        reading = &latest;
+    }
+    if (reading != NULL) {
+        record.temperature_x10 = (int16_t)lroundf(reading->ambient.temperature * 10.0f);
+        record.humidity_x10 = (uint16_t)lroundf(reading->ambient.humidity * 10.0f);
+        record.soil_count = reading->soil.sensor_count;
+        for (uint8_t i = 0; i < reading->soil.sensor_count && i < DECISION_LOG_SOIL_CHANNELS; i++) {
+            if (reading->soil.valid_mask & (1U << i)) {
+                record.soil[i] = decision_log_soil_encode(reading->soil.soil_humidity[i]);
+            }
+        }
+    }
+
+    bool is_online;
+    bool in_pulse;
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        record.state = (uint8_t)ctx->current_state;
+        is_online = ctx->is_online;
+        in_pulse = ctx->pulse_count > 0;
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+
+    if (!is_online) {
+        record.level = (uint8_t)offline_mode_instance_get_current_level(ctx->offline);
+    }
+    record.flags = (is_online ? DECISION_LOG_FLAG_ONLINE : 0) |
+                   (in_pulse ? DECISION_LOG_FLAG_PULSE : 0);
+
+    decision_log_append(&record);
+}
+
+/**
+ * @brief Record the start of a session (call after the valve opened)
+ *
+ * @param soil_avg Soil average at valve open (<0 if unknown: no learning)
+ * @param plan true to stop on the learned duration instead of the threshold
+ * @return Planned minutes, 0 for a closed-loop session
+ */
+static uint16_t irrigation_session_begin(irrigation_controller_context_t* ctx, float soil_avg, bool plan)
+{
+    uint8_t valve;
+    int64_t start_ms;
+    bool dropped;
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        valve = ctx->active_valve_num;
+        start_ms = ctx->session_start_ms;
+        irrigation_deferred_remove(&ctx->deferred, valve);     // Started, by any path
+        dropped = ctx->learn_pending;
+        ctx->learn_pending = false;      // New water: the soak sample is meaningless
+        ctx->session_start_soil = soil_avg;
+        ctx->plan_end_ms = 0;
+        ctx->planned_duration_min = 0;
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+
+    if (dropped) {
+        ESP_LOGW(TAG, "Soil response: previous session not learned (new session before soak end)");
+    }
+
+    uint16_t minutes = (plan && soil_avg >= 0.0f) ? irrigation_model_plan_minutes(ctx, valve, soil_avg) : 0;
+    if (minutes == 0) {
+        irrigation_journal_save(ctx, false);
+        return 0;
+    }
+
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        ctx->plan_end_ms = start_ms + (int64_t)minutes * 60000;
+        ctx->planned_duration_min = minutes;
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+
+    irrigation_journal_save(ctx, false);
+
+    ESP_LOGI(TAG, "Planned session: %u min to bring soil %.1f%% -> %.1f%% (valve %u)",
+             minutes, soil_avg, ctx->config.soil_threshold_optimal, valve);
+    return minutes;
+}
+
+/**
+ * @brief Record the end of a session (call after the valve closed)
+ *
+ * Arms learning: the soaked soil level is sampled once the soak time has
+ * passed (see irrigation_model_learn()). Also clears a pulse program, so
+ * stop paths must run irrigation_pulse_cancel() first. Without a running
+ * session (error handler, repeated STOP) only the program fields are
+ * cleared: the minimum interval, a pending learn and the journal are left
+ * as they are.
+ *
+ * @param soil_avg Soil average at valve close (<0 to skip learning)
+ */
+static void irrigation_session_end(irrigation_controller_context_t* ctx, float soil_avg)
+{
+    int64_t now_ms = time_sync_get_monotonic_ms();
+    bool had_session;
+    uint32_t water_s = 0;
+
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        float start_soil = ctx->session_start_soil;
+        had_session = ctx->session_active;
+        float minutes = 0.0f;
+        if (had_session) {
+            int64_t water_ms = irrigation_session_water_ms_locked(ctx, now_ms);
+            minutes = (float)water_ms / 60000.0f;
+            water_s = (uint32_t)(water_ms / 1000);
+            ctx->total_runtime_today_sec += water_s;
+            ctx->session_start_ms = 0;
+            ctx->session_active = false;
+            ctx->next_allowed_session_ms = now_ms + (int64_t)ctx->config.min_interval_minutes * 60000;
+            ctx->learn_pending = false;
+        }
+
+        ctx->pulse_count = 0;
+        ctx->pulse_phase_end_ms = 0;
+        ctx->plan_end_ms = 0;
+        ctx->planned_duration_min = 0;
+        ctx->session_start_soil = -1.0f;
+
+#if CONFIG_IRRIGATION_SOIL_MODEL_ENABLE
+        if (had_session && start_soil >= 0.0f && soil_avg >= 0.0f &&
+            ctx->active_valve_num >= 1 &&
+            ctx->active_valve_num <= IRRIGATION_ZONE_COUNT) {
+            ctx->learn_obs = (soil_response_observation_t){
+                .minutes = minutes,
+                .soil_start = start_soil,
+                .soil_stop = soil_avg,
+                .soil_soaked = 0.0f,
+            };
+            ctx->learn_zone = ctx->active_valve_num;
+            ctx->learn_due_ms = now_ms + (int64_t)CONFIG_IRRIGATION_SOIL_MODEL_SOAK_MINUTES * 60000;
+            ctx->learn_after_id = 0;
+            ctx->learn_pending = true;
+        }
+#else
+        (void)start_soil;
+        (void)minutes;
+#endif
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+
+    if (had_session) {
+        irrigation_stats_record_session(water_s);
+        irrigation_journal_save(ctx, false);
+    }
+}
+
+/**
+ * @brief Feed the soaked sample of the last session to its zone model
+ *
+ * The first sample taken after the soak time counts, so the evaluation
+ * task arms on the current reading id and learns from the next one.
+ */
+static void irrigation_model_learn(irrigation_controller_context_t* ctx, const sensor_reading_t* reading)
+{
+    bool pending;
+    bool valve_open;
+    int64_t due_ms;
+    uint32_t after_id;
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        pending = ctx->learn_pending;
+        valve_open = ctx->is_valve_open;
+        due_ms = ctx->learn_due_ms;
+        after_id = ctx->learn_after_id;
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+
+    if (!pending || valve_open || time_sync_get_monotonic_ms() < due_ms) {
+        return;
+    }
+
+    if (after_id == 0) {
+        portENTER_CRITICAL(&ctx->spinlock);
+        {
+            ctx->learn_after_id = (reading->reading_id != 0) ? reading->reading_id : 1;
+        }
+        portEXIT_CRITICAL(&ctx->spinlock);
+        return;
+    }
+    if (reading->reading_id == after_id) {
+        return;
+    }
+
+    float soaked = sensor_reader_soil_average(&reading->soil);
+    soil_response_observation_t obs;
+    uint8_t zone;
+    bool learned;
+    soil_response_model_t model;
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        ctx->learn_pending = false;
+        ctx->learn_obs.soil_soaked = soaked;
+        obs = ctx->learn_obs;
+        zone = ctx->learn_zone - 1;
+        learned = soil_response_model_update(&ctx->soil_models[zone], &obs,
+                                             CONFIG_IRRIGATION_SOIL_MODEL_FORGETTING_PCT / 100.0f);
+        model = ctx->soil_models[zone];
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+
+    if (!learned) {
+        ESP_LOGW(TAG, "Soil response: session ignored (%.1f min, soil %.1f%% -> %.1f%% soaked)",
+                 obs.minutes, obs.soil_start, obs.soil_soaked);
+        return;
+    }
+
+    ESP_LOGI(TAG, "Zone %u soil response: %.1f min raised soil %.1f%% -> %.1f%% (%.1f%% at stop); "
+             "gain %.2f %%/min, residual %.1f%%, %u sessions",
+             zone + 1, obs.minutes, obs.soil_start, obs.soil_soaked, obs.soil_stop,
+             soil_response_model_gain(&model), soil_response_model_residual(&model),
+             model.sessions);
+    irrigation_model_save(ctx, zone);
+}
+
+/**
+ * @brief Check a planned session at its end against the model
+ *
+ * The probes should show at least the immediate rise the model predicts.
+ * A shortfall (low line pressure, much drier soil) drops the plan and
+ * returns the session to the closed-loop threshold stop.
+ *
+ * @return true if the valve should close now
+ */
+static bool irrigation_plan_verify(irrigation_controller_context_t* ctx, float soil_avg, float elapsed_min)
+{
+    float start_soil;
+    soil_response_model_t model;
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        start_soil = ctx->session_start_soil;
+        model = ctx->soil_models[ctx->active_valve_num - 1];
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+
+    float expected = start_soil + soil_response_model_immediate_gain(&model) * elapsed_min;
+    if (soil_avg >= expected - CONFIG_IRRIGATION_SOIL_MODEL_VERIFY_TOLERANCE) {
+        ESP_LOGI(TAG, "Planned duration reached: soil %.1f%% (expected %.1f%%)", soil_avg, expected);
+        return true;
+    }
+
+    ESP_LOGW(TAG, "Plan verification failed: soil %.1f%% < expected %.1f%%, continuing to threshold",
+             soil_avg, expected);
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        ctx->plan_end_ms = 0;
+        ctx->planned_duration_min = 0;
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+    return false;
+}
+
+/**
+ * @brief Map valve, connectivity and offline level to a sampling profile
+ *
+ * Called every cycle and right after MQTT commands so opening the valve
+ * switches sensor_scheduler to fast soil sampling immediately. A session
+ * with a learned duration keeps the idle rate until its planned end.
+ */
+static void irrigation_update_sample_profile(irrigation_controller_context_t* ctx)
+{
+    bool valve_open;
+    bool is_online;
+    int64_t plan_end_ms;
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        valve_open = ctx->is_valve_open;
+        is_online = ctx->is_online;
+        plan_end_ms = ctx->plan_end_ms;
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+
+    sensor_sample_profile_t profile = SENSOR_SAMPLE_PROFILE_IDLE;
+    if (valve_open) {
+        // A planned session only needs safety checks until its end
+        bool planned = plan_end_ms > 0 && time_sync_get_monotonic_ms() < plan_end_ms;
+        profile = planned ? SENSOR_SAMPLE_PROFILE_IDLE : SENSOR_SAMPLE_PROFILE_IRRIGATING;
+    } else if (!is_online) {
+        switch (offline_mode_instance_get_current_level(ctx->offline)) {
+            case OFFLINE_LEVEL_WARNING:
+                profile = SENSOR_SAMPLE_PROFILE_OFFLINE_WARNING;
+                break;
+            case OFFLINE_LEVEL_CRITICAL:
+                profile = SENSOR_SAMPLE_PROFILE_OFFLINE_CRITICAL;
+                break;
+            case OFFLINE_LEVEL_EMERGENCY:
+                profile = SENSOR_SAMPLE_PROFILE_OFFLINE_EMERGENCY;
+                break;
+            default:
+                profile = SENSOR_SAMPLE_PROFILE_OFFLINE_NORMAL;
+                break;
+        }
+    }
+
+    sensor_scheduler_set_profile(profile);
+}
+
+/**
+ * @brief Wait for the next evaluation while the valve is open
+ *
+ * Closed-loop sessions evaluate every new sample. Planned sessions sleep
+ * until their planned end (at most @p max_wait_ms, so safety checks keep
+ * running), then switch to fast sampling and wait for one fresh sample:
+ * the verification sample.
+ */
+static void irrigation_wait_open_valve(irrigation_controller_context_t* ctx,
+                                       uint32_t last_sample_id, uint32_t max_wait_ms)
+{
+    int64_t plan_end_ms;
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        plan_end_ms = ctx->plan_end_ms;
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+
+    if (plan_end_ms == 0) {
+        sensor_scheduler_wait_sample(last_sample_id, max_wait_ms);
+        return;
+    }
+
+    int64_t remaining_ms = plan_end_ms - time_sync_get_monotonic_ms();
+    if (remaining_ms > 0) {
+        if (remaining_ms > max_wait_ms) {
+            remaining_ms = max_wait_ms;
+        }
+        vTaskDelay(pdMS_TO_TICKS((uint32_t)remaining_ms) + 1);
+    }
+
+    if (time_sync_get_monotonic_ms() >= plan_end_ms) {
+        irrigation_update_sample_profile(ctx);
+
+        sensor_reading_t latest;
+        sensor_scheduler_get_latest(&latest);
+        sensor_scheduler_wait_sample(latest.reading_id, IRRIGATION_FIRST_SAMPLE_WAIT_MS);
+    }
+}
+
+/**
+ * @brief Local minute of day, false while the clock is not synchronized
+ */
+static bool irrigation_minute_of_day(uint16_t* minute)
+{
+    if (!time_sync_is_valid()) {
+        return false;
+    }
+
+    time_t now = time(NULL);
+    struct tm timeinfo;
+    localtime_r(&now, &timeinfo);
+    *minute = (uint16_t)(timeinfo.tm_hour * 60 + timeinfo.tm_min);
+    return true;
+}
+
+/**
+ * @brief Decide whether an automatic start of @p valve may run now
+ *
+ * Outside the zone's windows the start is queued (or its urgency
+ * refreshed) and released once a window opens, most urgent zone first.
+ * The emergency offline level bypasses the windows; so does an
+ * unsynchronized clock, rather than leaving the crop without water.
+ */
+static bool irrigation_window_allows_start(irrigation_controller_context_t* ctx, uint8_t valve,
+                                           offline_level_t level, float soil_avg)
+{
+    uint16_t minute;
+    if (level >= OFFLINE_LEVEL_EMERGENCY || !irrigation_minute_of_day(&minute)) {
+        return true;
+    }
+
+    irrigation_deferred_t request = {
+        .zone = valve,
+        .level = (uint8_t)level,
+        .soil = soil_avg,
+        .requested_s = time_sync_get_monotonic_ms() / 1000,
+    };
+    irrigation_deferred_t next;
+    bool was_queued;
+    bool queued;
+    bool ready;
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        was_queued = irrigation_deferred_contains(&ctx->deferred, valve);
+        queued = irrigation_deferred_push(&ctx->deferred, &request);
+        ready = irrigation_deferred_pop_ready(&ctx->deferred, ctx->windows, IRRIGATION_ZONE_COUNT,
+                                              minute, &next);
+        if (ready && next.zone != valve) {
+            irrigation_deferred_push(&ctx->deferred, &next);   // A more urgent zone goes first
+            ready = false;
+        }
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+
+    if (!queued) {
+        return irrigation_window_is_open(&ctx->windows[valve - 1], minute);
+    }
+    if (ready) {
+        if (was_queued) {
+            ESP_LOGI(TAG, "Deferred start released: valve %d (level=%d, soil=%.1f%%)",
+                     valve, level, soil_avg);
+            irrigation_log_decision(ctx, DECISION_EVENT_EVALUATION, DECISION_REASON_WINDOW_RELEASED,
+                                    valve, 0, 0, NULL);
+        }
+        return true;
+    }
+    if (!was_queued) {
+        uint16_t opens_in = irrigation_window_minutes_until_open(&ctx->windows[valve - 1], minute);
+        ESP_LOGI(TAG, "Start deferred: valve %d outside its window, opens in %u min", valve, opens_in);
+        irrigation_log_decision(ctx, DECISION_EVENT_EVALUATION, DECISION_REASON_WINDOW_DEFERRED,
+                                valve, opens_in, 0, NULL);
+    }
+    return false;
+}
+
+/**
+ * @brief Drop a deferred start whose soil recovered (rain, manual watering)
+ */
+static void irrigation_window_cancel(irrigation_controller_context_t* ctx, uint8_t valve)
+{
+    bool removed;
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        removed = irrigation_deferred_remove(&ctx->deferred, valve);
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+
+    if (removed) {
+        ESP_LOGI(TAG, "Deferred start dropped: valve %d soil recovered", valve);
+        irrigation_log_decision(ctx, DECISION_EVENT_EVALUATION, DECISION_REASON_WINDOW_DROPPED,
+                                valve, 0, 0, NULL);
+    }
+}
+
+/**
+ * @brief Shorten @p wait_ms so a pending deferred start runs when its window opens
+ */
+static uint32_t irrigation_window_cap_wait_ms(irrigation_controller_context_t* ctx, uint32_t wait_ms)
+{
+    uint16_t minute;
+    if (!irrigation_minute_of_day(&minute)) {
+        return wait_ms;
+    }
+
+    uint32_t cap_ms = wait_ms;
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        for (uint8_t i = 0; i < ctx->deferred.count; i++) {
+            uint8_t zone = ctx->deferred.entries[i].zone;
+            if (zone == 0 || zone > IRRIGATION_ZONE_COUNT) {
+                continue;
+            }
+            // +1 min: land inside the window, not on its edge
+            uint32_t open_ms = ((uint32_t)irrigation_window_minutes_until_open(&ctx->windows[zone - 1], minute) + 1) * 60000;
+            if (open_ms < cap_ms) {
+                cap_ms = open_ms;
+            }
+        }
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+    return cap_ms;
+}
+
+/**
+ * @brief Disarm the pulse timer before a stop path closes the valve
+ *
+ * Waits for a phase change in progress: irrigation_pulse_phase_change()
+ * holds the pulse mutex for a whole phase change, so a stop can never interleave
+ * with a valve re-opening at the end of a soak. The program fields stay
+ * intact so the stop path still sees the water time;
+ * irrigation_session_end() clears them.
+ */
+static void irrigation_pulse_cancel(irrigation_controller_context_t* ctx)
+{
+    if (ctx->pulse_mutex == NULL) {
+        return;
+    }
+
+    xSemaphoreTake(ctx->pulse_mutex, portMAX_DELAY);
+    esp_timer_stop(ctx->pulse_timer);
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        ctx->pulse_phase_end_ms = 0;
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+    xSemaphoreGive(ctx->pulse_mutex);
+}
+
+/**
+ * @brief Pulse timer: wake the evaluation task at an on/soak deadline
+ *
+ * Runs in the esp_timer task, so it does no work of its own: the valve,
+ * the session journal, the stats and the decision log are handled by
+ * irrigation_pulse_phase_change() in the evaluation task.
+ */
+static void irrigation_pulse_timer_callback(void *arg)
+{
+    irrigation_controller_context_t* ctx = arg;
+
+    if (ctx->task_handle != NULL) {
+        xTaskNotifyGive(ctx->task_handle);
+    }
+}
+
+/**
+ * @brief Shorten @p wait_ms so the task wakes at the current pulse deadline
+ *
+ * Waits that cannot see the timer notification (new sample, WiFi bit)
+ * end there on their own; one tick of margin lands past the deadline.
+ */
+static uint32_t irrigation_pulse_cap_wait_ms(irrigation_controller_context_t* ctx, uint32_t wait_ms)
+{
+    int64_t phase_end_ms;
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        phase_end_ms = ctx->pulse_phase_end_ms;
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+
+    if (phase_end_ms == 0) {
+        return wait_ms;
+    }
+
+    int64_t left_ms = phase_end_ms - time_sync_get_monotonic_ms();
+    if (left_ms < 0) {
+        left_ms = 0;
+    }
+    left_ms += portTICK_PERIOD_MS;
+    return (left_ms < (int64_t)wait_ms) ? (uint32_t)left_ms : wait_ms;
+}
+
+/**
+ * @brief End of an on-period or of a soak-period (evaluation task)
+ *
+ * No-op until the armed deadline has passed, so a late or stale timer
+ * wakeup (program cancelled or restarted meanwhile) changes nothing.
+ * Webhook notifications are sent later in the cycle, with the sample.
+ */
+static void irrigation_pulse_phase_change(irrigation_controller_context_t* ctx)
+{
+    if (ctx->pulse_mutex == NULL) {
+        return;
+    }
+
+    xSemaphoreTake(ctx->pulse_mutex, portMAX_DELAY);
+
+    int64_t now_ms = time_sync_get_monotonic_ms();
+    bool armed;
+    bool soaking;
+    bool last_pulse;
+    uint8_t valve;
+    uint32_t next_on_ms = 0;
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        armed = ctx->pulse_count > 0 && ctx->pulse_phase_end_ms > 0 &&
+                now_ms >= ctx->pulse_phase_end_ms;
+        soaking = ctx->pulse_soaking;
+        valve = ctx->active_valve_num;
+        last_pulse = ctx->pulse_index >= ctx->pulse_count;
+
+        if (armed && soaking) {
+            // Next pulse limited by the daily budget and the session limit
+            int64_t water_ms = irrigation_session_water_ms_locked(ctx, now_ms);
+            int64_t daily_left_ms = (int64_t)ctx->config.max_daily_minutes * 60000 -
+                                    (int64_t)ctx->total_runtime_today_sec * 1000 - water_ms;
+            int64_t session_left_ms = (int64_t)ctx->config.max_duration_minutes * 60000 - water_ms;
+            int64_t left_ms = (daily_left_ms < session_left_ms) ? daily_left_ms : session_left_ms;
+
+            next_on_ms = ctx->pulse_on_ms;
+            if (left_ms < (int64_t)next_on_ms) {
+                next_on_ms = (left_ms > 0) ? (uint32_t)left_ms : 0;
+            }
+        }
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+
+    if (!armed) {
+        xSemaphoreGive(ctx->pulse_mutex);
+        return;
+    }
+
+    if (soaking && next_on_ms >= 60000) {
+        // Soak over: next pulse
+        uint8_t index;
+        portENTER_CRITICAL(&ctx->spinlock);
+        {
+            ctx->pulse_soaking = false;
+            ctx->pulse_index++;
+            ctx->pulse_phase_start_ms = now_ms;
+            ctx->pulse_phase_end_ms = now_ms + next_on_ms;
+            ctx->is_valve_open = true;
+            ctx->current_state = IRRIGATION_ACTIVE;
+            index = ctx->pulse_index;
+        }
+        portEXIT_CRITICAL(&ctx->spinlock);
+
+        valve_driver_open(valve);
+        safety_watchdog_instance_reset_valve_timer(ctx->watchdog);
+        esp_timer_start_once(ctx->pulse_timer, (uint64_t)next_on_ms * 1000);
+        DLOG_I(TAG, "Pulse %d started (%" PRIu32 " s on)", index, next_on_ms / 1000);
+        irrigation_log_decision(ctx, DECISION_EVENT_VALVE_OPEN, DECISION_REASON_PULSE_ON,
+                                valve, (uint16_t)(next_on_ms / 60000), index, NULL);
+    } else if (!soaking && !last_pulse) {
+        // On-period over: soak
+        valve_driver_close(valve);
+
+        uint8_t index;
+        uint32_t soak_ms;
+        uint32_t water_ms;
+        portENTER_CRITICAL(&ctx->spinlock);
+        {
+            ctx->pulse_water_ms += (uint32_t)(now_ms - ctx->pulse_phase_start_ms);
+            water_ms = ctx->pulse_water_ms;
+            ctx->pulse_soaking = true;
+            ctx->pulse_phase_start_ms = now_ms;
+            ctx->pulse_phase_end_ms = now_ms + ctx->pulse_soak_ms;
+            ctx->is_valve_open = false;
+            ctx->current_state = IRRIGATION_PAUSED;
+            index = ctx->pulse_index;
+            soak_ms = ctx->pulse_soak_ms;
+        }
+        portEXIT_CRITICAL(&ctx->spinlock);
+
+        esp_timer_start_once(ctx->pulse_timer, (uint64_t)soak_ms * 1000);
+        DLOG_I(TAG, "Pulse %d done, soaking %" PRIu32 " s", index, soak_ms / 1000);
+        irrigation_log_decision(ctx, DECISION_EVENT_VALVE_CLOSE, DECISION_REASON_PULSE_SOAK,
+                                valve, (uint16_t)(water_ms / 1000), index, NULL);
+    } else {
+        // Last pulse done, or no budget left for another one
+        if (!soaking) {
+            valve_driver_close(valve);
+        }
+
+        uint32_t water_s;
+        uint8_t index;
+        portENTER_CRITICAL(&ctx->spinlock);
+        {
+            water_s = (uint32_t)(irrigation_session_water_ms_locked(ctx, now_ms) / 1000);
+            index = ctx->pulse_index;
+            ctx->pulse_phase_end_ms = 0;
+            ctx->is_valve_open = false;
+            ctx->last_session_end_time = time(NULL);
+            ctx->current_state = IRRIGATION_IDLE;
+            ctx->pulse_done_notify = true;
+        }
+        portEXIT_CRITICAL(&ctx->spinlock);
+
+        irrigation_log_decision(ctx, DECISION_EVENT_VALVE_CLOSE, DECISION_REASON_PULSE_PROGRAM_DONE,
+                                valve, (uint16_t)water_s, index, NULL);
+        irrigation_session_end(ctx, irrigation_latest_soil_avg());
+        DLOG_I(TAG, "Pulse program finished (%" PRIu32 " s of water)", water_s);
+    }
+
+    xSemaphoreGive(ctx->pulse_mutex);
+    irrigation_journal_save(ctx, false);
+    irrigation_update_sample_profile(ctx);
+}
+
+/**
+ * @brief Open the valve for the first pulse of a cycle-and-soak program
+ *
+ * Caller validates safety conditions. Subsequent transitions run on
+ * pulse timer deadlines: the timer wakes the evaluation task, which
+ * changes the phase before its next sample.
+ *
+ * @param valve Valve (1-2)
+ * @param pulse_count Pulses (1-IRRIGATION_PULSE_MAX)
+ * @param on_minutes On-period of each pulse
+ * @param soak_minutes Soak between pulses
+ */
+static esp_err_t irrigation_pulse_start(irrigation_controller_context_t* ctx, uint8_t valve,
+                                        uint8_t pulse_count, uint16_t on_minutes,
+                                        uint16_t soak_minutes)
+{
+    if (pulse_count == 0 || pulse_count > IRRIGATION_PULSE_MAX ||
+        on_minutes == 0 || soak_minutes == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (ctx->pulse_timer == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    irrigation_pulse_cancel(ctx);
+
+    // Same limits as the later pulses (irrigation_pulse_phase_change()),
+    // plus the minimum interval since the last session
+    int64_t now_ms = time_sync_get_monotonic_ms();
+    int64_t wait_ms;
+    int64_t left_ms;
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        wait_ms = ctx->next_allowed_session_ms - now_ms;
+        int64_t daily_left_ms = (int64_t)ctx->config.max_daily_minutes * 60000 -
+                                (int64_t)ctx->total_runtime_today_sec * 1000;
+        int64_t session_left_ms = (int64_t)ctx->config.max_duration_minutes * 60000;
+        left_ms = (daily_left_ms < session_left_ms) ? daily_left_ms : session_left_ms;
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+
+    if (wait_ms > 0) {
+        ESP_LOGW(TAG, "Cannot start pulse program: must wait %" PRId32 " more minutes (min interval: %d minutes)",
+                 (int32_t)(wait_ms / 60000), ctx->config.min_interval_minutes);
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (left_ms < 60000) {
+        ESP_LOGW(TAG, "Cannot start pulse program: max daily duration reached (%d minutes)",
+                 ctx->config.max_daily_minutes);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    uint32_t on_ms = (uint32_t)on_minutes * 60000;
+    if (left_ms < (int64_t)on_ms) {
+        on_ms = (uint32_t)left_ms;
+    }
+
+    esp_err_t ret = valve_driver_open(valve);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open valve: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    xSemaphoreTake(ctx->pulse_mutex, portMAX_DELAY);
+    now_ms = time_sync_get_monotonic_ms();
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        ctx->is_valve_open = true;
+        ctx->active_valve_num = valve;
+        ctx->session_start_ms = now_ms;
+        ctx->session_active = true;
+        ctx->current_session_duration_min = pulse_count * on_minutes;
+        ctx->current_state = IRRIGATION_ACTIVE;
+        ctx->session_count++;
+
+        ctx->pulse_count = pulse_count;
+        ctx->pulse_index = 1;
+        ctx->pulse_soaking = false;
+        ctx->pulse_on_ms = on_ms;
+        ctx->pulse_soak_ms = (uint32_t)soak_minutes * 60000;
+        ctx->pulse_phase_start_ms = now_ms;
+        ctx->pulse_phase_end_ms = now_ms + on_ms;
+        ctx->pulse_water_ms = 0;
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+    esp_timer_start_once(ctx->pulse_timer, (uint64_t)on_ms * 1000);
+    xSemaphoreGive(ctx->pulse_mutex);
+
+    // Closed loop per pulse; the program itself is the plan
+    irrigation_session_begin(ctx, irrigation_latest_soil_avg(), false);
+
+    safety_watchdog_instance_reset_session(ctx->watchdog);
+    safety_watchdog_instance_reset_valve_timer(ctx->watchdog);
+    irrigation_update_sample_profile(ctx);
+
+    ESP_LOGI(TAG, "Pulse program started: valve %d, %d x %d min on / %d min soak",
+             valve, pulse_count, on_minutes, soak_minutes);
+    return ESP_OK;
+}
+
+#if CONFIG_IRRIGATION_OFFLINE_DEEP_SLEEP
+/**
+ * @brief Deep sleep until the soil leaves the current offline level
  *
- * Maintains complete state of irrigation system
+ * The ULP keeps sampling the soil sensors and wakes the CPU on a level
+ * boundary crossing or after the level's evaluation interval. Each boot
+ * stays awake at least CONFIG_IRRIGATION_DEEP_SLEEP_MIN_AWAKE_S so WiFi
+ * can reconnect. Returns only if sleeping is not possible right now.
  */
-typedef struct {
-    // Configuration
-    irrigation_controller_config_t config;
+static void irrigation_offline_deep_sleep(irrigation_controller_context_t* ctx)
+{
+    int64_t min_awake_ms = (int64_t)CONFIG_IRRIGATION_DEEP_SLEEP_MIN_AWAKE_S * 1000;
+    int64_t uptime_ms = time_sync_get_monotonic_ms();
+    if (uptime_ms < min_awake_ms &&
+        wifi_manager_wait_connected((uint32_t)(min_awake_ms - uptime_ms)) == ESP_OK) {
+        return;
+    }
 
-    // Current session state
-    irrigation_state_t current_state;
-    irrigation_mode_t current_mode;
-    time_t session_start_time;
-    time_t last_session_end_time;
-    uint16_t current_session_duration_min;
-    bool is_valve_open;
-    uint8_t active_valve_num;
+    // Never sleep with the valve open or outside a quiet IDLE state
+    irrigation_state_t state;
+    bool valve_open;
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        state = ctx->current_state;
+        valve_open = ctx->is_valve_open;
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
 
-    // MQTT override
-    bool mqtt_override_active;
-    char mqtt_override_command[20];
-    time_t mqtt_override_start_time;
+    if (state != IRRIGATION_IDLE || valve_open) {
+        return;
+    }
 
-    // Statistics
-    uint32_t session_count;
-    uint32_t total_runtime_today_sec;
+    offline_level_t level = offline_mode_instance_get_current_level(ctx->offline);
+    float wake_below;
+    float wake_above;
+    offline_mode_get_wake_band(level, &wake_below, &wake_above);
+    uint32_t heartbeat_s = irrigation_window_cap_wait_ms(ctx, offline_mode_get_interval_ms(level)) / 1000;
 
-    // Online/offline detection
-    bool is_online;
-    time_t last_online_check;
+    esp_err_t ret = sensor_reader_start_soil_monitor(wake_below, wake_above, heartbeat_s);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Deep sleep skipped, ULP monitor unavailable: %s", esp_err_to_name(ret));
+        return;
+    }
 
-    // Safety
-    bool safety_lock;
-    bool thermal_protection_active;
-    time_t next_allowed_session;
+    ESP_LOGI(TAG, "OFFLINE: entering deep sleep (level=%d, heartbeat=%" PRIu32 " s)",
+             level, heartbeat_s);
+    deferred_log_flush();
+    decision_log_flush();
+    esp_deep_sleep_start();
+}
+#endif
 
-    // Last evaluation
-    irrigation_evaluation_t last_evaluation;
-    time_t last_eval_time;
+/**
+ * @brief Restore the state journaled before a reset
+ *
+ * Daily runtime, session count and the minimum interval always come back.
+ * The safety lock comes back from the RTC copy only, so a power cycle is
+ * still the manual unlock. A session interrupted by the reset resumes if
+ * the downtime was short and limits allow it, otherwise it is closed:
+ * its water counts toward today and the minimum interval starts now.
+ * Pulse programs are always closed.
+ */
+static void irrigation_journal_restore(irrigation_controller_context_t* ctx)
+{
+    session_journal_entry_t entry;
+    session_journal_source_t source;
+    int64_t downtime_ms;
+    if (session_journal_read(&entry, &source, &downtime_ms) != ESP_OK) {
+        ESP_LOGI(TAG, "No session journal: fresh start");
+        irrigation_log_decision(ctx, DECISION_EVENT_BOOT, DECISION_REASON_NONE, 0, 0, 0, NULL);
+        return;
+    }
 
-    // Startup stabilization
-    uint8_t startup_cycles_remaining;  ///< Remaining startup cycles (10 cycles at 60s for stabilization)
-} irrigation_controller_context_t;
+    int64_t now_ms = time_sync_get_monotonic_ms();
+    bool interrupted = (entry.state == IRRIGATION_ACTIVE || entry.state == IRRIGATION_PAUSED) &&
+                       entry.valve >= 1 && entry.valve <= 2;
+    bool lock = entry.safety_lock && source == SESSION_JOURNAL_RTC;
 
-/* ============================ PRIVATE STATE ============================ */
+    // Unknown downtime: keep the whole interval left (conservative)
+    int64_t next_allowed_in_ms = entry.next_allowed_in_ms;
+    if (downtime_ms >= 0) {
+        next_allowed_in_ms = (next_allowed_in_ms > downtime_ms) ? next_allowed_in_ms - downtime_ms : 0;
+    }
 
-static const char *TAG = "irrigation_controller";
+    bool resume = false;
+#if CONFIG_IRRIGATION_JOURNAL_RESUME
+    resume = interrupted && !lock && entry.pulse_count == 0 &&
+             downtime_ms >= 0 && downtime_ms <= (int64_t)CONFIG_IRRIGATION_JOURNAL_RESUME_MAX_S * 1000 &&
+             entry.session_water_ms < (uint32_t)ctx->config.max_duration_minutes * 60000 &&
+             entry.today_runtime_sec + entry.session_water_ms / 1000 <
+                 (uint32_t)ctx->config.max_daily_minutes * 60;
+#endif
+    if (resume && valve_driver_open(entry.valve) != ESP_OK) {
+        resume = false;
+    }
 
-/**
- * @brief Global irrigation controller context
- */
-static irrigation_controller_context_t s_irrig_ctx = {
-    .current_state = IRRIGATION_IDLE,
-    .current_mode = IRRIGATION_MODE_ONLINE,
-    .is_valve_open = false,
-    .active_valve_num = 0,
-    .mqtt_override_active = false,
-    .session_count = 0,
-    .total_runtime_today_sec = 0,
-    .is_online = false,
-    .safety_lock = false,
-    .thermal_protection_active = false,
-    .startup_cycles_remaining = 10  // First 10 cycles at 60s for stabilization
-};
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        ctx->session_count = entry.session_count;
+        ctx->total_runtime_today_sec = entry.today_runtime_sec;
+        ctx->stats_day = entry.stats_day;
+        ctx->next_allowed_session_ms = now_ms + next_allowed_in_ms;
+        ctx->safety_lock = lock;
+        if (lock) {
+            ctx->current_state = IRRIGATION_EMERGENCY_STOP;
+        }
 
-/**
- * @brief Task handle for irrigation evaluation task
- */
-static TaskHandle_t s_irrigation_task_handle = NULL;
+        if (resume) {
+            // Water time continues where the reset cut it
+            ctx->is_valve_open = true;
+            ctx->active_valve_num = entry.valve;
+            ctx->session_start_ms = now_ms - entry.session_water_ms;
+            ctx->session_active = true;
+            ctx->current_session_duration_min = entry.session_duration_min;
+            ctx->current_state = IRRIGATION_ACTIVE;
+            ctx->session_start_soil = -1.0f;    // Start level lost: do not learn
+            ctx->planned_duration_min = entry.planned_duration_min;
+            ctx->plan_end_ms = (entry.planned_duration_min > 0)
+                ? ctx->session_start_ms + (int64_t)entry.planned_duration_min * 60000 : 0;
+        } else if (interrupted) {
+            ctx->total_runtime_today_sec += entry.session_water_ms / 1000;     // Not via session_end()
+            ctx->last_session_end_time = time(NULL);
+            ctx->next_allowed_session_ms = now_ms + (int64_t)ctx->config.min_interval_minutes * 60000;
+        }
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
 
-/**
- * @brief Spinlock for thread-safe state access
- */
-static portMUX_TYPE s_irrigation_spinlock = portMUX_INITIALIZER_UNLOCKED;
+    if (resume) {
+        safety_watchdog_instance_reset_session(ctx->watchdog);
+        safety_watchdog_instance_reset_valve_timer(ctx->watchdog);
+    } else if (interrupted) {
+        irrigation_stats_record_session(entry.session_water_ms / 1000);
+    }
 
-/**
- * @brief Initialization flag
- */
-static bool is_initialized = false;
+    ESP_LOGI(TAG, "Journal restored from %s (downtime %lld ms): today=%" PRIu32 " s, sessions=%" PRIu32
+             ", next session in %lld s%s",
+             session_journal_source_to_string(source), (long long)downtime_ms,
+             entry.today_runtime_sec, entry.session_count, (long long)(next_allowed_in_ms / 1000),
+             lock ? ", SAFETY LOCK" : "");
+    if (interrupted) {
+        ESP_LOGW(TAG, "Session on valve %d interrupted after %" PRIu32 " s of water: %s",
+                 entry.valve, entry.session_water_ms / 1000, resume ? "resumed" : "closed");
+        irrigation_log_decision(ctx, DECISION_EVENT_BOOT,
+                                resume ? DECISION_REASON_SESSION_RESUMED : DECISION_REASON_SESSION_INTERRUPTED,
+                                entry.valve, (uint16_t)(entry.session_water_ms / 1000), 0, NULL);
+    } else {
+        irrigation_log_decision(ctx, DECISION_EVENT_BOOT, DECISION_REASON_NONE, 0, 0, 0, NULL);
+    }
 
-/* ============================ PRIVATE FUNCTIONS ============================ */
+    irrigation_journal_save(ctx, true);
+}
 
-// Forward declarations for state handlers
-static void irrigation_state_idle_handler(const sensor_reading_t* reading);
-static void irrigation_state_running_handler(const sensor_reading_t* reading);
-static void irrigation_state_error_handler(const sensor_reading_t* reading);
-static void irrigation_state_thermal_stop_handler(const sensor_reading_t* reading);
+/**
+ * @brief Stop requested by irrigation_controller_stop()
+ */
+static bool irrigation_task_exit_requested(irrigation_controller_context_t* ctx)
+{
+    bool requested;
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        requested = ctx->task_exit;
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+    return requested;
+}
 
 /**
  * @brief Irrigation evaluation task
  *
  * Main task loop for periodic irrigation evaluation.
  * Interval logic:
+ * - Valve open: every new sensor_scheduler sample (fast soil profile)
  * - Online mode: 60 seconds (always)
  * - Offline mode: 60 seconds for first 10 cycles (startup stabilization), then 2 hours
  * Implements complete state machine with sensor integration.
  */
 static void irrigation_evaluation_task(void *param)
 {
+    irrigation_controller_context_t* ctx = param;
     ESP_LOGI(TAG, "Irrigation evaluation task started");
     uint32_t cycle_count = 0;
+    uint32_t last_sample_id = 0;
+    irrigation_state_t last_published_state = IRRIGATION_IDLE;
 
-    while (1) {
+    while (!irrigation_task_exit_requested(ctx)) {
         cycle_count++;
-        ESP_LOGI(TAG, "=== Irrigation evaluation cycle #%" PRIu32 " ===", cycle_count);
-        
+        DLOG_I(TAG, "=== Irrigation evaluation cycle #%" PRIu32 " ===", cycle_count);
+
+        irrigation_check_day_rollover(ctx);
+
+        // Pulse on/soak deadline reached (woken by the pulse timer)
+        irrigation_pulse_phase_change(ctx);
+
         // 1. Detect connectivity status
         bool is_online = wifi_manager_is_connected();
 
-        portENTER_CRITICAL(&s_irrigation_spinlock);
+        portENTER_CRITICAL(&ctx->spinlock);
         {
-            s_irrig_ctx.is_online = is_online;
+            ctx->is_online = is_online;
         }
-        portEXIT_CRITICAL(&s_irrigation_spinlock);
+        portEXIT_CRITICAL(&ctx->spinlock);
+        irrigation_update_sample_profile(ctx);
 
-        // 2. Read sensors
+        // 2. Latest sample from sensor_scheduler (first cycle may precede it)
         sensor_reading_t reading;
-        esp_err_t sensor_ret = sensor_reader_get_all(&reading);
+        esp_err_t sensor_ret = sensor_scheduler_get_latest(&reading);
+        if (sensor_ret == ESP_ERR_NOT_FOUND &&
+            sensor_scheduler_wait_sample(0, IRRIGATION_FIRST_SAMPLE_WAIT_MS) == ESP_OK) {
+            sensor_ret = sensor_scheduler_get_latest(&reading);
+        }
+        if (sensor_ret == ESP_OK) {
+            last_sample_id = reading.reading_id;
+        }
 
         if (sensor_ret != ESP_OK) {
             ESP_LOGE(TAG, "Sensor read failed: %s", esp_err_to_name(sensor_ret));
-            portENTER_CRITICAL(&s_irrigation_spinlock);
+            irrigation_state_t previous_state;
+            portENTER_CRITICAL(&ctx->spinlock);
             {
-                s_irrig_ctx.current_state = IRRIGATION_ERROR;
+                previous_state = ctx->current_state;
+                ctx->current_state = IRRIGATION_ERROR;
+            }
+            portEXIT_CRITICAL(&ctx->spinlock);
+            irrigation_state_error_handler(ctx, NULL);
+            if (previous_state != IRRIGATION_ERROR) {
+                irrigation_log_decision(ctx, DECISION_EVENT_STATE, DECISION_REASON_SENSOR_FAILURE,
+                                        0, 0, 0, NULL);
             }
-            portEXIT_CRITICAL(&s_irrigation_spinlock);
-            irrigation_state_error_handler(NULL);
         } else {
             // 3. Execute state machine
             irrigation_state_t current_state;
-            portENTER_CRITICAL(&s_irrigation_spinlock);
+            portENTER_CRITICAL(&ctx->spinlock);
             {
-                current_state = s_irrig_ctx.current_state;
+                current_state = ctx->current_state;
             }
-            portEXIT_CRITICAL(&s_irrigation_spinlock);
+            portEXIT_CRITICAL(&ctx->spinlock);
 
             switch (current_state) {
                 case IRRIGATION_IDLE:
-                    irrigation_state_idle_handler(&reading);
+                    irrigation_state_idle_handler(ctx, &reading);
                     break;
 
                 case IRRIGATION_ACTIVE:
-                    irrigation_state_running_handler(&reading);
+                    irrigation_state_running_handler(ctx, &reading);
+                    break;
+
+                case IRRIGATION_PAUSED:
+                    irrigation_state_soak_handler(ctx, &reading);
                     break;
 
                 case IRRIGATION_ERROR:
-                    irrigation_state_error_handler(&reading);
+                    irrigation_state_error_handler(ctx, &reading);
                     break;
 
                 case IRRIGATION_THERMAL_PROTECTION:
-                    irrigation_state_thermal_stop_handler(&reading);
+                    irrigation_state_thermal_stop_handler(ctx, &reading);
                     break;
 
                 case IRRIGATION_EMERGENCY_STOP:
@@ -195,17 +1475,34 @@ static void irrigation_evaluation_task(void *param)
                     ESP_LOGW(TAG, "Unknown state: %d", current_state);
                     break;
             }
+
+            irrigation_model_learn(ctx, &reading);
+        }
+
+        // Pulse program finished from the timer: notify from task context
+        bool pulse_done;
+        portENTER_CRITICAL(&ctx->spinlock);
+        {
+            pulse_done = ctx->pulse_done_notify;
+            ctx->pulse_done_notify = false;
+        }
+        portEXIT_CRITICAL(&ctx->spinlock);
+        if (pulse_done) {
+            notification_send_irrigation_event("irrigation_off",
+                                              sensor_reader_soil_average(&reading.soil),
+                                              reading.ambient.humidity,
+                                              reading.ambient.temperature);
         }
 
         // 4. Determine evaluation interval based on connectivity and startup state
         uint32_t eval_interval_ms;
         uint8_t startup_cycles;
         
-        portENTER_CRITICAL(&s_irrigation_spinlock);
+        portENTER_CRITICAL(&ctx->spinlock);
         {
-            startup_cycles = s_irrig_ctx.startup_cycles_remaining;
+            startup_cycles = ctx->startup_cycles_remaining;
         }
-        portEXIT_CRITICAL(&s_irrigation_spinlock);
+        portEXIT_CRITICAL(&ctx->spinlock);
         
         if (is_online) {
             eval_interval_ms = 60000;  // 60 seconds online
@@ -215,60 +1512,97 @@ static void irrigation_evaluation_task(void *param)
             // Then switch to 2h intervals
             if (startup_cycles > 0) {
                 eval_interval_ms = 60000;  // 60 seconds during startup
-                ESP_LOGI(TAG, "Offline mode - STARTUP: cycle %d/10, next evaluation in 60s", 
+                DLOG_I(TAG, "Offline mode - STARTUP: cycle %d/10, next evaluation in 60s",
                          11 - startup_cycles);
                 
                 // Decrement startup counter (only when offline)
-                portENTER_CRITICAL(&s_irrigation_spinlock);
+                portENTER_CRITICAL(&ctx->spinlock);
                 {
-                    s_irrig_ctx.startup_cycles_remaining--;
+                    ctx->startup_cycles_remaining--;
                 }
-                portEXIT_CRITICAL(&s_irrigation_spinlock);
+                portEXIT_CRITICAL(&ctx->spinlock);
             } else {
                 eval_interval_ms = 7200000;  // 2 hours offline (normal operation)
                 ESP_LOGD(TAG, "Offline mode - normal operation, next evaluation in 2h");
             }
         }
 
+        // Wake up when the window of a deferred start opens, and at the
+        // next pulse on/soak deadline
+        eval_interval_ms = irrigation_window_cap_wait_ms(ctx, eval_interval_ms);
+        eval_interval_ms = irrigation_pulse_cap_wait_ms(ctx, eval_interval_ms);
+
         // 5. Log summary (INFO level for visibility)
         irrigation_state_t current_state_log;
+        irrigation_mode_t current_mode_log;
         bool is_valve_open_log;
-        portENTER_CRITICAL(&s_irrigation_spinlock);
+        portENTER_CRITICAL(&ctx->spinlock);
         {
-            current_state_log = s_irrig_ctx.current_state;
-            is_valve_open_log = s_irrig_ctx.is_valve_open;
+            current_state_log = ctx->current_state;
+            current_mode_log = ctx->current_mode;
+            is_valve_open_log = ctx->is_valve_open;
+        }
+        portEXIT_CRITICAL(&ctx->spinlock);
+
+        // Journal every cycle (RTC), checkpoint to NVS on state transitions;
+        // lifetime counters on transitions or every STATS_CHECKPOINT_MINUTES
+        irrigation_journal_save(ctx, current_state_log != last_published_state);
+        irrigation_stats_checkpoint(current_state_log != last_published_state);
+
+        // Notify bus subscribers of state transitions (non-blocking)
+        if (current_state_log != last_published_state) {
+            event_bus_data_t bus_data = {
+                .irrigation = {
+                    .state = (uint8_t)current_state_log,
+                    .previous_state = (uint8_t)last_published_state,
+                    .mode = (uint8_t)current_mode_log,
+                    .valve_open = is_valve_open_log ? 1 : 0,
+                },
+            };
+            event_bus_post(EVENT_BUS_IRRIGATION_STATE_CHANGED, &bus_data);
+            last_published_state = current_state_log;
         }
-        portEXIT_CRITICAL(&s_irrigation_spinlock);
         
-        ESP_LOGI(TAG, "Evaluation cycle: State=%d, Valve=%s, Online=%d, StartupCycles=%d, NextWait=%" PRIu32 "ms",
+        DLOG_I(TAG, "Evaluation cycle: State=%d, Valve=%s, Online=%d, StartupCycles=%d, NextWait=%" PRIu32 "ms",
                  current_state_log,
                  is_valve_open_log ? "OPEN" : "CLOSED",
                  is_online,
                  startup_cycles,
                  eval_interval_ms);
 
-        // 6. Wait for next evaluation with periodic WiFi check
-        // If offline, check WiFi every 10 seconds to detect reconnection quickly
-        if (!is_online) {
-            // Break long delay into smaller chunks to check WiFi status
-            uint32_t check_interval_ms = 10000;  // Check every 10 seconds
-            uint32_t remaining_ms = eval_interval_ms;
-            
-            while (remaining_ms > 0 && !wifi_manager_is_connected()) {
-                uint32_t delay_ms = (remaining_ms > check_interval_ms) ? check_interval_ms : remaining_ms;
-                vTaskDelay(pdMS_TO_TICKS(delay_ms));
-                remaining_ms -= delay_ms;
+        // The state machine may have opened or closed the valve
+        irrigation_update_sample_profile(ctx);
+
+        // 6. Wait for next evaluation
+        // With the valve open, evaluate every new sample so irrigation stops
+        // close to the optimal threshold, or sleep until the planned end of
+        // a session with a learned duration. If offline, block on the WiFi
+        // connection bit so a reconnection wakes the task immediately
+        // (wifi_manager owns the retry backoff)
+        if (is_valve_open_log) {
+            irrigation_wait_open_valve(ctx, last_sample_id, eval_interval_ms);
+        } else if (!is_online) {
+#if CONFIG_IRRIGATION_OFFLINE_DEEP_SLEEP
+            if (startup_cycles == 0) {
+                irrigation_offline_deep_sleep(ctx);
             }
-            
-            // If WiFi reconnected during wait, log it
-            if (wifi_manager_is_connected()) {
+#endif
+            if (wifi_manager_wait_connected(eval_interval_ms) == ESP_OK) {
                 ESP_LOGI(TAG, "WiFi reconnected during wait - switching to online mode");
             }
         } else {
-            // Online mode: simple delay
-            vTaskDelay(pdMS_TO_TICKS(eval_interval_ms));
+            // Online mode: delay, cut short by the pulse timer
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(eval_interval_ms));
         }
     }
+
+    ESP_LOGI(TAG, "Irrigation evaluation task stopped");
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        ctx->task_handle = NULL;
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+    vTaskDelete(NULL);
 }
 
 /**
@@ -363,53 +1697,81 @@ static irrigation_controller_config_t _get_default_config(void)
  *
  * Evaluates if riego should start based on soil moisture
  */
-static void irrigation_state_idle_handler(const sensor_reading_t* reading)
+static void irrigation_state_idle_handler(irrigation_controller_context_t* ctx, const sensor_reading_t* reading)
 {
     if (reading == NULL) {
         return;
     }
 
-    // Calculate average soil moisture from 3 sensors
-    float soil_avg = (reading->soil.soil_humidity[0] +
-                      reading->soil.soil_humidity[1] +
-                      reading->soil.soil_humidity[2]) / 3.0f;
+    // Calculate average soil moisture over the active sensors
+    float soil_avg = sensor_reader_soil_average(&reading->soil);
 
     // Log at INFO level for visibility
-    ESP_LOGI(TAG, "IDLE state: soil_avg=%.1f%% (sensors: %.1f%%, %.1f%%, %.1f%%) - threshold=%.1f%%",
-             soil_avg, 
-             reading->soil.soil_humidity[0],
-             reading->soil.soil_humidity[1],
-             reading->soil.soil_humidity[2],
-             s_irrig_ctx.config.soil_threshold_critical);
-
-    // Check if should start irrigation (<= to include threshold value)
-    if (soil_avg <= s_irrig_ctx.config.soil_threshold_critical) {
-        ESP_LOGI(TAG, "Soil too dry (%.1f%% <= %.1f%%) - starting irrigation",
-                 soil_avg, s_irrig_ctx.config.soil_threshold_critical);
-
-        // Open valve
-        valve_driver_open(s_irrig_ctx.config.primary_valve);
-
-        // Update state
-        portENTER_CRITICAL(&s_irrigation_spinlock);
-        {
-            s_irrig_ctx.is_valve_open = true;
-            s_irrig_ctx.active_valve_num = s_irrig_ctx.config.primary_valve;
-            s_irrig_ctx.session_start_time = time(NULL);
-            s_irrig_ctx.current_state = IRRIGATION_ACTIVE;
-            s_irrig_ctx.session_count++;
-        }
-        portEXIT_CRITICAL(&s_irrigation_spinlock);
+    DLOG_I(TAG, "IDLE state: soil_avg=%.1f%% (%d sensors) - threshold=%.1f%%",
+             soil_avg,
+             reading->soil.sensor_count,
+             ctx->config.soil_threshold_critical);
+
+    // Check if should start irrigation (<= to include threshold value);
+    // a wet soil also drops a deferred start
+    if (soil_avg > ctx->config.soil_threshold_critical) {
+        irrigation_window_cancel(ctx, ctx->config.primary_valve);
+        return;
+    }
 
-        // Reset watchdog timers
-        safety_watchdog_reset_session();
-        safety_watchdog_reset_valve_timer();
+    // Outside the zone's time-of-day window only an emergency starts now
+    offline_evaluation_t level_eval = offline_mode_instance_evaluate(ctx->offline, soil_avg);
+    if (!irrigation_window_allows_start(ctx, ctx->config.primary_valve, level_eval.level, soil_avg)) {
+        return;
+    }
 
-        // Send notification
+    ESP_LOGI(TAG, "Soil too dry (%.1f%% <= %.1f%%) - starting irrigation",
+             soil_avg, ctx->config.soil_threshold_critical);
+
+#if CONFIG_IRRIGATION_PULSE_AUTO
+    // Cycle-and-soak: the pulse timer drives the session from here
+    if (irrigation_pulse_start(ctx, ctx->config.primary_valve,
+                               CONFIG_IRRIGATION_PULSE_COUNT,
+                               CONFIG_IRRIGATION_PULSE_ON_MINUTES,
+                               CONFIG_IRRIGATION_PULSE_SOAK_MINUTES) == ESP_OK) {
+        irrigation_log_decision(ctx, DECISION_EVENT_VALVE_OPEN, DECISION_REASON_SOIL_DRY,
+                                ctx->config.primary_valve,
+                                CONFIG_IRRIGATION_PULSE_COUNT * CONFIG_IRRIGATION_PULSE_ON_MINUTES,
+                                0, reading);
         notification_send_irrigation_event("irrigation_on", soil_avg,
                                           reading->ambient.humidity,
                                           reading->ambient.temperature);
     }
+#else
+    // Open valve
+    valve_driver_open(ctx->config.primary_valve);
+
+    // Update state
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        ctx->is_valve_open = true;
+        ctx->active_valve_num = ctx->config.primary_valve;
+        ctx->session_start_ms = time_sync_get_monotonic_ms();
+        ctx->session_active = true;
+        ctx->current_state = IRRIGATION_ACTIVE;
+        ctx->session_count++;
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+
+    // Stop on the learned duration when the zone model is ready
+    uint16_t planned = irrigation_session_begin(ctx, soil_avg, true);
+    irrigation_log_decision(ctx, DECISION_EVENT_VALVE_OPEN, DECISION_REASON_SOIL_DRY,
+                            ctx->config.primary_valve, planned, 0, reading);
+
+    // Reset watchdog timers
+    safety_watchdog_instance_reset_session(ctx->watchdog);
+    safety_watchdog_instance_reset_valve_timer(ctx->watchdog);
+
+    // Send notification
+    notification_send_irrigation_event("irrigation_on", soil_avg,
+                                      reading->ambient.humidity,
+                                      reading->ambient.temperature);
+#endif
 }
 
 /**
@@ -417,94 +1779,115 @@ static void irrigation_state_idle_handler(const sensor_reading_t* reading)
  *
  * Monitors running irrigation and decides when to stop
  */
-static void irrigation_state_running_handler(const sensor_reading_t* reading)
+static void irrigation_state_running_handler(irrigation_controller_context_t* ctx, const sensor_reading_t* reading)
 {
     if (reading == NULL) {
         return;
     }
 
     // Calculate soil average
-    float soil_avg = (reading->soil.soil_humidity[0] +
-                      reading->soil.soil_humidity[1] +
-                      reading->soil.soil_humidity[2]) / 3.0f;
+    float soil_avg = sensor_reader_soil_average(&reading->soil);
 
     // Find maximum (any sensor too wet?)
-    float soil_max = reading->soil.soil_humidity[0];
-    if (reading->soil.soil_humidity[1] > soil_max) soil_max = reading->soil.soil_humidity[1];
-    if (reading->soil.soil_humidity[2] > soil_max) soil_max = reading->soil.soil_humidity[2];
+    float soil_max = sensor_reader_soil_max(&reading->soil);
 
-    ESP_LOGD(TAG, "ACTIVE state: soil_avg=%.1f%%, soil_max=%.1f%% (stop=%.1f%%, danger=%.1f%%)",
+    DLOG_D(TAG, "ACTIVE state: soil_avg=%.1f%%, soil_max=%.1f%% (stop=%.1f%%, danger=%.1f%%)",
              soil_avg, soil_max,
-             s_irrig_ctx.config.soil_threshold_optimal,
-             s_irrig_ctx.config.soil_threshold_max);
-
-    // Calculate elapsed time
-    time_t elapsed = time(NULL) - s_irrig_ctx.session_start_time;
+             ctx->config.soil_threshold_optimal,
+             ctx->config.soil_threshold_max);
+
+    // Calculate elapsed water time (pulse soaks excluded) and current valve-open time
+    int64_t now_ms = time_sync_get_monotonic_ms();
+    time_t elapsed;
+    int64_t valve_open_ms;
+    int64_t plan_end_ms;
+    uint8_t valve;
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        elapsed = (time_t)(irrigation_session_water_ms_locked(ctx, now_ms) / 1000);
+        valve_open_ms = (ctx->pulse_count > 0) ? now_ms - ctx->pulse_phase_start_ms
+                                                      : (int64_t)elapsed * 1000;
+        plan_end_ms = ctx->plan_end_ms;
+        valve = ctx->active_valve_num;
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
 
     // Check safety watchdog
     watchdog_inputs_t watchdog_inputs = {
         .session_duration_ms = elapsed * 1000,
-        .valve_open_time_ms = elapsed * 1000,
+        .valve_open_time_ms = (uint32_t)valve_open_ms,
         .mqtt_override_idle_ms = 0,
         .current_temperature = reading->ambient.temperature,
         .current_soil_humidity_avg = soil_avg
     };
 
-    watchdog_alerts_t alerts = safety_watchdog_check(&watchdog_inputs);
+    watchdog_alerts_t alerts = safety_watchdog_instance_check(ctx->watchdog, &watchdog_inputs);
 
     // Decide if should stop
     bool should_stop = false;
-    const char* stop_reason = NULL;
+    decision_reason_t stop_reason = DECISION_REASON_NONE;
 
     // Check conditions in priority order
-    if (soil_max >= s_irrig_ctx.config.soil_threshold_max) {
+    if (soil_max >= ctx->config.soil_threshold_max) {
         should_stop = true;
-        stop_reason = "over_moisture";
+        stop_reason = DECISION_REASON_OVER_MOISTURE;
         ESP_LOGW(TAG, "Over-moisture detected (%.1f%% >= %.1f%%)",
-                 soil_max, s_irrig_ctx.config.soil_threshold_max);
+                 soil_max, ctx->config.soil_threshold_max);
     }
     else if (alerts.temperature_critical) {
         should_stop = true;
-        stop_reason = "temperature_critical";
-        portENTER_CRITICAL(&s_irrigation_spinlock);
+        stop_reason = DECISION_REASON_TEMPERATURE_CRITICAL;
+        portENTER_CRITICAL(&ctx->spinlock);
         {
-            s_irrig_ctx.thermal_protection_active = true;
-            s_irrig_ctx.current_state = IRRIGATION_THERMAL_PROTECTION;
+            ctx->thermal_protection_active = true;
+            ctx->current_state = IRRIGATION_THERMAL_PROTECTION;
         }
-        portEXIT_CRITICAL(&s_irrigation_spinlock);
+        portEXIT_CRITICAL(&ctx->spinlock);
+        irrigation_stats_record_thermal_stop();
         ESP_LOGE(TAG, "THERMAL PROTECTION: T°=%.1f°C > %.1f°C",
-                 reading->ambient.temperature, s_irrig_ctx.config.temp_thermal_stop);
+                 reading->ambient.temperature, ctx->config.temp_thermal_stop);
     }
     else if (alerts.session_timeout_exceeded) {
         should_stop = true;
-        stop_reason = "session_timeout";
+        stop_reason = DECISION_REASON_SESSION_TIMEOUT;
         ESP_LOGW(TAG, "Session timeout: %lld sec > %d min",
-                 (long long)elapsed, s_irrig_ctx.config.max_duration_minutes * 60);
+                 (long long)elapsed, ctx->config.max_duration_minutes * 60);
     }
-    else if (soil_avg >= s_irrig_ctx.config.soil_threshold_optimal) {
+    else if (soil_avg >= ctx->config.soil_threshold_optimal) {
         should_stop = true;
-        stop_reason = "target_reached";
+        stop_reason = DECISION_REASON_TARGET_REACHED;
         ESP_LOGI(TAG, "Target soil moisture reached (%.1f%% >= %.1f%%)",
-                 soil_avg, s_irrig_ctx.config.soil_threshold_optimal);
+                 soil_avg, ctx->config.soil_threshold_optimal);
+    }
+    else if (plan_end_ms > 0 && time_sync_get_monotonic_ms() >= plan_end_ms) {
+        // Verification sample of a planned session
+        if (irrigation_plan_verify(ctx, soil_avg, elapsed / 60.0f)) {
+            should_stop = true;
+            stop_reason = DECISION_REASON_PLANNED_DURATION;
+        }
     }
 
-    // Execute stop if needed
+    // Execute stop if needed (also ends a pulse program)
     if (should_stop) {
-        valve_driver_close(s_irrig_ctx.config.primary_valve);
+        irrigation_pulse_cancel(ctx);
+        valve_driver_close(valve);
 
-        portENTER_CRITICAL(&s_irrigation_spinlock);
+        portENTER_CRITICAL(&ctx->spinlock);
         {
-            s_irrig_ctx.is_valve_open = false;
-            s_irrig_ctx.last_session_end_time = time(NULL);
-            s_irrig_ctx.total_runtime_today_sec += elapsed;
+            ctx->is_valve_open = false;
+            ctx->last_session_end_time = time(NULL);
 
-            if (s_irrig_ctx.current_state != IRRIGATION_THERMAL_PROTECTION) {
-                s_irrig_ctx.current_state = IRRIGATION_IDLE;
+            if (ctx->current_state != IRRIGATION_THERMAL_PROTECTION) {
+                ctx->current_state = IRRIGATION_IDLE;
             }
         }
-        portEXIT_CRITICAL(&s_irrigation_spinlock);
+        portEXIT_CRITICAL(&ctx->spinlock);
 
-        ESP_LOGI(TAG, "Irrigation stopped: %s (duration %.1f min)", stop_reason, elapsed / 60.0f);
+        ESP_LOGI(TAG, "Irrigation stopped: %s (duration %.1f min)",
+                 decision_log_reason_to_string(stop_reason), elapsed / 60.0f);
+        irrigation_log_decision(ctx, DECISION_EVENT_VALVE_CLOSE, stop_reason,
+                                valve, (uint16_t)elapsed, 0, reading);
+        irrigation_session_end(ctx, soil_avg);
 
         // Send notification
         notification_send_irrigation_event("irrigation_off", soil_avg,
@@ -514,8 +1897,85 @@ static void irrigation_state_running_handler(const sensor_reading_t* reading)
 
     // Alert if valve timeout (40 min)
     if (alerts.valve_timeout_exceeded) {
-        ESP_LOGW(TAG, "Valve timeout alert: open for %lld sec", (long long)elapsed);
+        ESP_LOGW(TAG, "Valve timeout alert: open for %lld sec", (long long)(valve_open_ms / 1000));
+    }
+}
+
+/**
+ * @brief State handler: PAUSED (soak between two pulses)
+ *
+ * The valve is closed and the pulse timer reopens it. Ends the program
+ * early if the soil already reached the target or gets too hot.
+ */
+static void irrigation_state_soak_handler(irrigation_controller_context_t* ctx, const sensor_reading_t* reading)
+{
+    if (reading == NULL) {
+        return;
+    }
+
+    float soil_avg = sensor_reader_soil_average(&reading->soil);
+    float soil_max = sensor_reader_soil_max(&reading->soil);
+
+    uint8_t pulse_index;
+    uint8_t pulse_count;
+    int64_t phase_end_ms;
+    uint8_t valve;
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        pulse_index = ctx->pulse_index;
+        pulse_count = ctx->pulse_count;
+        phase_end_ms = ctx->pulse_phase_end_ms;
+        valve = ctx->active_valve_num;
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+
+    if (pulse_count == 0) {
+        return;     // Program ended in the meantime
+    }
+
+    decision_reason_t stop_reason = DECISION_REASON_NONE;
+    irrigation_state_t next_state = IRRIGATION_IDLE;
+    if (soil_max >= ctx->config.soil_threshold_max) {
+        stop_reason = DECISION_REASON_OVER_MOISTURE;
+    } else if (reading->ambient.temperature >= ctx->config.temp_thermal_stop) {
+        stop_reason = DECISION_REASON_TEMPERATURE_CRITICAL;
+        next_state = IRRIGATION_THERMAL_PROTECTION;
+    } else if (soil_avg >= ctx->config.soil_threshold_optimal) {
+        stop_reason = DECISION_REASON_TARGET_REACHED;
+    }
+
+    if (stop_reason == DECISION_REASON_NONE) {
+        DLOG_D(TAG, "SOAK after pulse %d/%d: soil_avg=%.1f%%, next pulse in %" PRId32 " s",
+               pulse_index, pulse_count, soil_avg,
+               (int32_t)((phase_end_ms - time_sync_get_monotonic_ms()) / 1000));
+        return;
+    }
+
+    irrigation_pulse_cancel(ctx);
+
+    uint32_t water_s;
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        water_s = (uint32_t)(irrigation_session_water_ms_locked(ctx, time_sync_get_monotonic_ms()) / 1000);
+        ctx->last_session_end_time = time(NULL);
+        ctx->current_state = next_state;
+        if (next_state == IRRIGATION_THERMAL_PROTECTION) {
+            ctx->thermal_protection_active = true;
+        }
     }
+    portEXIT_CRITICAL(&ctx->spinlock);
+    if (next_state == IRRIGATION_THERMAL_PROTECTION) {
+        irrigation_stats_record_thermal_stop();
+    }
+    irrigation_log_decision(ctx, DECISION_EVENT_VALVE_CLOSE, stop_reason,
+                            valve, (uint16_t)water_s, pulse_index, reading);
+    irrigation_session_end(ctx, soil_avg);
+
+    ESP_LOGI(TAG, "Pulse program ended during soak %d/%d: %s (%.1f min of water)",
+             pulse_index, pulse_count, decision_log_reason_to_string(stop_reason), water_s / 60.0f);
+    notification_send_irrigation_event("irrigation_off", soil_avg,
+                                      reading->ambient.humidity,
+                                      reading->ambient.temperature);
 }
 
 /**
@@ -523,25 +1983,25 @@ static void irrigation_state_running_handler(const sensor_reading_t* reading)
  *
  * Error state - sensors failed or safety triggered
  */
-static void irrigation_state_error_handler(const sensor_reading_t* reading)
+static void irrigation_state_error_handler(irrigation_controller_context_t* ctx, const sensor_reading_t* reading)
 {
     ESP_LOGE(TAG, "ERROR state handler");
 
     // Close all valves for safety
+    irrigation_pulse_cancel(ctx);
     valve_driver_close(1);
     valve_driver_close(2);
 
-    portENTER_CRITICAL(&s_irrigation_spinlock);
+    portENTER_CRITICAL(&ctx->spinlock);
     {
-        s_irrig_ctx.is_valve_open = false;
+        ctx->is_valve_open = false;
     }
-    portEXIT_CRITICAL(&s_irrigation_spinlock);
+    portEXIT_CRITICAL(&ctx->spinlock);
+    irrigation_session_end(ctx, -1.0f);      // Sensors unreliable: do not learn
 
     if (reading != NULL) {
         notification_send_irrigation_event("sensor_error",
-                        (reading->soil.soil_humidity[0] +
-                         reading->soil.soil_humidity[1] +
-                         reading->soil.soil_humidity[2]) / 3.0f,
+                        sensor_reader_soil_average(&reading->soil),
                         reading->ambient.humidity,
                         reading->ambient.temperature);
     }
@@ -552,7 +2012,8 @@ static void irrigation_state_error_handler(const sensor_reading_t* reading)
  *
  * Temperature too high - wait for cooling
  */
-static void irrigation_state_thermal_stop_handler(const sensor_reading_t* reading)
+static void irrigation_state_thermal_stop_handler(irrigation_controller_context_t* ctx,
+                                                  const sensor_reading_t* reading)
 {
     if (reading == NULL) {
         return;
@@ -560,24 +2021,24 @@ static void irrigation_state_thermal_stop_handler(const sensor_reading_t* readin
 
     ESP_LOGW(TAG, "THERMAL_PROTECTION: T°=%.1f°C (waiting for < %.1f°C)",
              reading->ambient.temperature,
-             s_irrig_ctx.config.temp_critical);
+             ctx->config.temp_critical);
 
     // Check if cooled down enough to resume
-    if (reading->ambient.temperature < s_irrig_ctx.config.temp_critical) {
-        portENTER_CRITICAL(&s_irrigation_spinlock);
+    if (reading->ambient.temperature < ctx->config.temp_critical) {
+        portENTER_CRITICAL(&ctx->spinlock);
         {
-            s_irrig_ctx.thermal_protection_active = false;
-            s_irrig_ctx.current_state = IRRIGATION_IDLE;
+            ctx->thermal_protection_active = false;
+            ctx->current_state = IRRIGATION_IDLE;
         }
-        portEXIT_CRITICAL(&s_irrigation_spinlock);
+        portEXIT_CRITICAL(&ctx->spinlock);
 
         ESP_LOGI(TAG, "Temperature normalized, returning to IDLE");
+        irrigation_log_decision(ctx, DECISION_EVENT_STATE, DECISION_REASON_TEMPERATURE_NORMAL,
+                                0, 0, 0, reading);
     }
 
     notification_send_irrigation_event("temperature_critical",
-                    (reading->soil.soil_humidity[0] +
-                     reading->soil.soil_humidity[1] +
-                     reading->soil.soil_humidity[2]) / 3.0f,
+                    sensor_reader_soil_average(&reading->soil),
                     reading->ambient.humidity,
                     reading->ambient.temperature);
 }
@@ -586,9 +2047,11 @@ static void irrigation_state_thermal_stop_handler(const sensor_reading_t* readin
 
 esp_err_t irrigation_controller_init(const irrigation_controller_config_t* config)
 {
+    irrigation_controller_context_t* ctx = &s_irrig_ctx;
+
     ESP_LOGI(TAG, "=== irrigation_controller_init() CALLED ===");
-    
-    if (is_initialized) {
+
+    if (ctx->is_initialized) {
         ESP_LOGW(TAG, "Irrigation controller already initialized");
         return ESP_OK;
     }
@@ -605,9 +2068,13 @@ esp_err_t irrigation_controller_init(const irrigation_controller_config_t* confi
     }
     ESP_LOGI(TAG, "Step 1: Valve driver initialized OK");
 
+    // One controller per chip: it drives the driver default instances
+    ctx->watchdog = safety_watchdog_default();
+    ctx->offline = offline_mode_default();
+
     // Initialize safety watchdog
     ESP_LOGI(TAG, "Step 2: Initializing safety watchdog...");
-    ret = safety_watchdog_init();
+    ret = safety_watchdog_instance_init(ctx->watchdog);
     ESP_LOGI(TAG, "safety_watchdog_init() returned: %s (code: %d)", esp_err_to_name(ret), ret);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to initialize safety watchdog: %s", esp_err_to_name(ret));
@@ -618,7 +2085,7 @@ esp_err_t irrigation_controller_init(const irrigation_controller_config_t* confi
 
     // Initialize offline mode driver
     ESP_LOGI(TAG, "Step 3: Initializing offline mode driver...");
-    ret = offline_mode_init();
+    ret = offline_mode_instance_init(ctx->offline);
     ESP_LOGI(TAG, "offline_mode_init() returned: %s (code: %d)", esp_err_to_name(ret), ret);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to initialize offline mode driver: %s", esp_err_to_name(ret));
@@ -629,42 +2096,84 @@ esp_err_t irrigation_controller_init(const irrigation_controller_config_t* confi
 
     // Set configuration
     if (config != NULL) {
-        portENTER_CRITICAL(&s_irrigation_spinlock);
+        portENTER_CRITICAL(&ctx->spinlock);
         {
-            s_irrig_ctx.config = *config;
+            ctx->config = *config;
         }
-        portEXIT_CRITICAL(&s_irrigation_spinlock);
+        portEXIT_CRITICAL(&ctx->spinlock);
     } else {
-        portENTER_CRITICAL(&s_irrigation_spinlock);
+        portENTER_CRITICAL(&ctx->spinlock);
         {
-            s_irrig_ctx.config = _get_default_config();
+            ctx->config = _get_default_config();
+        }
+        portEXIT_CRITICAL(&ctx->spinlock);
+    }
+
+    // Learned soil response per zone (NVS)
+    irrigation_model_load(ctx);
+
+    // Time-of-day start windows
+    const char* window_specs[IRRIGATION_ZONE_COUNT] = {
+        CONFIG_IRRIGATION_WINDOW_ZONE1,
+        CONFIG_IRRIGATION_WINDOW_ZONE2,
+    };
+    irrigation_deferred_init(&ctx->deferred);
+    for (uint8_t zone = 0; zone < IRRIGATION_ZONE_COUNT; zone++) {
+        if (!irrigation_window_parse(window_specs[zone], &ctx->windows[zone])) {
+            ESP_LOGW(TAG, "Invalid irrigation window \"%s\" (valve %d): no restriction",
+                     window_specs[zone], zone + 1);
         }
-        portEXIT_CRITICAL(&s_irrigation_spinlock);
     }
 
-    // Initialize startup cycles counter (10 cycles at 60s for stabilization when offline)
-    portENTER_CRITICAL(&s_irrigation_spinlock);
+    // Cycle-and-soak pulse timer
+    ctx->pulse_mutex = xSemaphoreCreateMutex();
+    const esp_timer_create_args_t pulse_timer_args = {
+        .callback = irrigation_pulse_timer_callback,
+        .arg = ctx,
+        .name = "irrig_pulse",
+    };
+    if (ctx->pulse_mutex == NULL || esp_timer_create(&pulse_timer_args, &ctx->pulse_timer) != ESP_OK) {
+        ESP_LOGW(TAG, "Pulse timer unavailable: pulse irrigation disabled");
+        ctx->pulse_timer = NULL;
+    }
+
+    // Lifetime counters, then session, daily totals and minimum interval
+    // from before a reset
+    irrigation_stats_init((uint32_t)CONFIG_IRRIGATION_STATS_CHECKPOINT_MINUTES * 60000);
+    irrigation_journal_restore(ctx);
+
+    // Initialize startup cycles counter (10 cycles at 60s for stabilization when offline).
+    // A ULP wakeup already comes with a filtered soil reading, so skip it.
+    ulp_soil_monitor_wake_t ulp_wake;
+    bool ulp_woke = ulp_soil_monitor_woke_up(&ulp_wake);
+    portENTER_CRITICAL(&ctx->spinlock);
     {
-        s_irrig_ctx.startup_cycles_remaining = 10;
+        ctx->startup_cycles_remaining = ulp_woke ? 0 : 10;
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+    if (ulp_woke) {
+        ESP_LOGI(TAG, "Woken by ULP soil monitor: reason=%d, filtered raw=%u, samples=%u",
+                 ulp_wake.reason, ulp_wake.filtered_raw, ulp_wake.sample_count);
+    } else {
+        ESP_LOGI(TAG, "Startup stabilization: 10 cycles at 60s when offline");
     }
-    portEXIT_CRITICAL(&s_irrigation_spinlock);
-    ESP_LOGI(TAG, "Startup stabilization: 10 cycles at 60s when offline");
 
-    is_initialized = true;
+    ctx->is_initialized = true;
 
     // Create evaluation task
     ESP_LOGI(TAG, "Step 4: Creating irrigation evaluation task...");
+    ctx->task_exit = false;
     BaseType_t task_ret = xTaskCreatePinnedToCore(
         irrigation_evaluation_task,
         "irrigation_task",
-        4096,
-        NULL,
+        CONFIG_IRRIGATION_TASK_STACK_SIZE,
+        ctx,
         4,  // Priority 4 (below wifi/mqtt at ~5, above idle at ~1)
-        &s_irrigation_task_handle,
+        &ctx->task_handle,
         1   // Core 1
     );
     ESP_LOGI(TAG, "xTaskCreatePinnedToCore() returned: %s (handle: %p)", 
-             (task_ret == pdPASS) ? "pdPASS" : "pdFAIL", s_irrigation_task_handle);
+             (task_ret == pdPASS) ? "pdPASS" : "pdFAIL", ctx->task_handle);
 
     if (task_ret != pdPASS) {
         ESP_LOGE(TAG, "Failed to create irrigation evaluation task");
@@ -675,10 +2184,10 @@ esp_err_t irrigation_controller_init(const irrigation_controller_config_t* confi
 
     ESP_LOGI(TAG, "Irrigation controller initialized");
     ESP_LOGI(TAG, "  Soil threshold: %.1f%% start, %.1f%% stop",
-             s_irrig_ctx.config.soil_threshold_critical,
-             s_irrig_ctx.config.soil_threshold_optimal);
-    ESP_LOGI(TAG, "  Max duration: %d minutes", s_irrig_ctx.config.max_duration_minutes);
-    ESP_LOGI(TAG, "  Primary valve: %d", s_irrig_ctx.config.primary_valve);
+             ctx->config.soil_threshold_critical,
+             ctx->config.soil_threshold_optimal);
+    ESP_LOGI(TAG, "  Max duration: %d minutes", ctx->config.max_duration_minutes);
+    ESP_LOGI(TAG, "  Primary valve: %d", ctx->config.primary_valve);
     ESP_LOGI(TAG, "  Evaluation task created (priority 4, stack 4KB)");
 
     return ESP_OK;
@@ -686,7 +2195,9 @@ esp_err_t irrigation_controller_init(const irrigation_controller_config_t* confi
 
 esp_err_t irrigation_controller_start(uint16_t duration_minutes, uint8_t valve_number)
 {
-    if (!is_initialized) {
+    irrigation_controller_context_t* ctx = &s_irrig_ctx;
+
+    if (!ctx->is_initialized) {
         ESP_LOGE(TAG, "Irrigation controller not initialized");
         return ESP_ERR_INVALID_STATE;
     }
@@ -696,6 +2207,22 @@ esp_err_t irrigation_controller_start(uint16_t duration_minutes, uint8_t valve_n
         return ESP_ERR_INVALID_ARG;
     }
 
+    // Same refusals as start_pulse and the START command: opening the valve
+    // under a pulse program would be closed again by its next phase timer
+    bool safety_lock;
+    bool pulse_running;
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        safety_lock = ctx->safety_lock;
+        pulse_running = ctx->pulse_count > 0;
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+
+    if (safety_lock || pulse_running) {
+        ESP_LOGW(TAG, "Cannot start irrigation: %s", safety_lock ? "safety lock active" : "pulse program in progress");
+        return ESP_ERR_INVALID_STATE;
+    }
+
     ESP_LOGI(TAG, "Starting irrigation: valve %d, duration %d min", valve_number, duration_minutes);
 
     // Open valve
@@ -705,46 +2232,114 @@ esp_err_t irrigation_controller_start(uint16_t duration_minutes, uint8_t valve_n
         return ret;
     }
 
-    portENTER_CRITICAL(&s_irrigation_spinlock);
+    portENTER_CRITICAL(&ctx->spinlock);
     {
-        s_irrig_ctx.is_valve_open = true;
-        s_irrig_ctx.active_valve_num = valve_number;
-        s_irrig_ctx.session_start_time = time(NULL);
-        s_irrig_ctx.current_state = IRRIGATION_ACTIVE;
-        s_irrig_ctx.session_count++;
+        ctx->is_valve_open = true;
+        ctx->active_valve_num = valve_number;
+        ctx->session_start_ms = time_sync_get_monotonic_ms();
+        ctx->session_active = true;
+        ctx->current_state = IRRIGATION_ACTIVE;
+        ctx->session_count++;
     }
-    portEXIT_CRITICAL(&s_irrigation_spinlock);
+    portEXIT_CRITICAL(&ctx->spinlock);
+    irrigation_session_begin(ctx, irrigation_latest_soil_avg(), false);
 
     // Reset watchdog timers
-    safety_watchdog_reset_session();
-    safety_watchdog_reset_valve_timer();
+    safety_watchdog_instance_reset_session(ctx->watchdog);
+    safety_watchdog_instance_reset_valve_timer(ctx->watchdog);
 
     return ESP_OK;
 }
 
+esp_err_t irrigation_controller_start_pulse(uint8_t pulse_count, uint16_t on_minutes,
+                                            uint16_t soak_minutes, uint8_t valve_number)
+{
+    irrigation_controller_context_t* ctx = &s_irrig_ctx;
+
+    if (!ctx->is_initialized) {
+        ESP_LOGE(TAG, "Irrigation controller not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (valve_number == 0) {
+        valve_number = ctx->config.primary_valve;
+    }
+    if (valve_number < 1 || valve_number > 2) {
+        ESP_LOGE(TAG, "Invalid valve number: %d", valve_number);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    bool safety_lock;
+    bool busy;
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        safety_lock = ctx->safety_lock;
+        busy = ctx->is_valve_open || ctx->pulse_count > 0;
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+
+    if (safety_lock || busy) {
+        ESP_LOGW(TAG, "Cannot start pulse program: %s", safety_lock ? "safety lock active" : "session in progress");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Daily budget and minimum interval: checked by irrigation_pulse_start()
+    return irrigation_pulse_start(ctx, valve_number, pulse_count, on_minutes, soak_minutes);
+}
+
 esp_err_t irrigation_controller_stop(void)
 {
-    if (!is_initialized) {
+    irrigation_controller_context_t* ctx = &s_irrig_ctx;
+
+    if (!ctx->is_initialized) {
         return ESP_ERR_INVALID_STATE;
     }
 
     ESP_LOGI(TAG, "Stopping irrigation controller");
 
-    // Close all valves immediately
+    // Close all valves immediately. The pulse mutex is held until the
+    // session has ended, so a phase change cannot re-open a valve or see
+    // a half-cleared program.
+    if (ctx->pulse_mutex != NULL) {
+        xSemaphoreTake(ctx->pulse_mutex, portMAX_DELAY);
+    }
+    if (ctx->pulse_timer != NULL) {
+        esp_timer_stop(ctx->pulse_timer);
+    }
     valve_driver_close(1);
     valve_driver_close(2);
 
-    portENTER_CRITICAL(&s_irrigation_spinlock);
+    TaskHandle_t task;
+    portENTER_CRITICAL(&ctx->spinlock);
+    {
+        ctx->is_valve_open = false;
+        ctx->current_state = IRRIGATION_IDLE;
+        ctx->task_exit = true;
+        task = ctx->task_handle;
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+
+    irrigation_session_end(ctx, -1.0f);     // Cut short: do not learn
+
+    portENTER_CRITICAL(&ctx->spinlock);
     {
-        s_irrig_ctx.is_valve_open = false;
-        s_irrig_ctx.current_state = IRRIGATION_IDLE;
+        ctx->pulse_index = 0;
+        ctx->pulse_soaking = false;
+        ctx->pulse_done_notify = false;
+        ctx->pulse_phase_start_ms = 0;
+        ctx->pulse_water_ms = 0;
+    }
+    portEXIT_CRITICAL(&ctx->spinlock);
+
+    if (ctx->pulse_mutex != NULL) {
+        xSemaphoreGive(ctx->pulse_mutex);
     }
-    portEXIT_CRITICAL(&s_irrigation_spinlock);
+    irrigation_journal_save(ctx, true);
 
-    // Delete task if running
-    if (s_irrigation_task_handle != NULL) {
-        vTaskDelete(s_irrigation_task_handle);
-        s_irrigation_task_handle = NULL;
+    // The task may be holding the pulse mutex or a driver lock, so it is
+    // never deleted from here: it leaves its loop at the next wakeup
+    if (task != NULL) {
+        xTaskNotifyGive(task);
     }
 
     return ESP_OK;
@@ -752,7 +2347,9 @@ esp_err_t irrigation_controller_stop(void)
 
 esp_err_t irrigation_controller_deinit(void)
 {
-    if (!is_initialized) {
+    irrigation_controller_context_t* ctx = &s_irrig_ctx;
+
+    if (!ctx->is_initialized) {
         return ESP_OK;
     }
 
@@ -764,94 +2361,136 @@ esp_err_t irrigation_controller_deinit(void)
     // Deinitialize drivers
     valve_driver_deinit();
 
-    is_initialized = false;
+    ctx->is_initialized = false;
 
     return ESP_OK;
 }
 
 irrigation_state_t irrigation_controller_get_state(void)
 {
+    irrigation_controller_context_t* ctx = &s_irrig_ctx;
     irrigation_state_t state;
 
-    portENTER_CRITICAL(&s_irrigation_spinlock);
+    portENTER_CRITICAL(&ctx->spinlock);
     {
-        state = s_irrig_ctx.current_state;
+        state = ctx->current_state;
     }
-    portEXIT_CRITICAL(&s_irrigation_spinlock);
+    portEXIT_CRITICAL(&ctx->spinlock);
 
     return state;
 }
 
 esp_err_t irrigation_controller_get_status(irrigation_controller_status_t* status)
 {
+    irrigation_controller_context_t* ctx = &s_irrig_ctx;
+
     if (status == NULL) {
         return ESP_ERR_INVALID_ARG;
     }
 
-    if (!is_initialized) {
+    if (!ctx->is_initialized) {
         return ESP_ERR_INVALID_STATE;
     }
 
-    portENTER_CRITICAL(&s_irrigation_spinlock);
+    uint16_t minute = 0;
+    bool clock_valid = irrigation_minute_of_day(&minute);
+    irrigation_stats_totals_t totals;
+    irrigation_stats_get(&totals);
+
+    portENTER_CRITICAL(&ctx->spinlock);
     {
-        status->state = s_irrig_ctx.current_state;
-        status->mode = s_irrig_ctx.current_mode;
-        status->is_irrigating = s_irrig_ctx.is_valve_open;
-        status->active_valve = s_irrig_ctx.active_valve_num;
-        status->safety_lock = s_irrig_ctx.safety_lock;
-        status->thermal_protection_active = s_irrig_ctx.thermal_protection_active;
+        status->state = ctx->current_state;
+        status->mode = ctx->current_mode;
+        status->is_irrigating = ctx->is_valve_open;
+        status->active_valve = ctx->active_valve_num;
+        status->safety_lock = ctx->safety_lock;
+        status->thermal_protection_active = ctx->thermal_protection_active;
 
         // Calculate session elapsed time
-        if (s_irrig_ctx.is_valve_open && s_irrig_ctx.session_start_time > 0) {
-            status->session_elapsed_sec = time(NULL) - s_irrig_ctx.session_start_time;
+        if (ctx->is_valve_open && ctx->session_active) {
+            status->session_elapsed_sec = (time_sync_get_monotonic_ms() - ctx->session_start_ms) / 1000;
         } else {
             status->session_elapsed_sec = 0;
         }
+        status->planned_duration_min = ctx->planned_duration_min;
+
+        // Time-of-day window of the primary valve zone
+        uint8_t window_zone = ctx->config.primary_valve - 1;
+        status->deferred_start_pending = irrigation_deferred_contains(&ctx->deferred,
+                                                                      ctx->config.primary_valve);
+        status->minutes_until_window = (clock_valid && window_zone < IRRIGATION_ZONE_COUNT)
+            ? irrigation_window_minutes_until_open(&ctx->windows[window_zone], minute) : 0;
+
+        // Pulse program progress
+        int64_t now_ms = time_sync_get_monotonic_ms();
+        status->pulse_count = ctx->pulse_count;
+        status->pulse_index = ctx->pulse_index;
+        status->pulse_soaking = ctx->pulse_soaking;
+        status->pulse_phase_remaining_sec = (ctx->pulse_phase_end_ms > now_ms)
+            ? (uint32_t)((ctx->pulse_phase_end_ms - now_ms) / 1000) : 0;
+        status->session_water_sec = (ctx->session_active &&
+                                     (ctx->is_valve_open || ctx->pulse_count > 0))
+            ? (uint32_t)(irrigation_session_water_ms_locked(ctx, now_ms) / 1000) : 0;
+
+        // Learned soil response
+        uint8_t zone = ctx->config.primary_valve - 1;
+        if (zone < IRRIGATION_ZONE_COUNT) {
+            status->soil_gain_pct_per_min = soil_response_model_gain(&ctx->soil_models[zone]);
+            status->soil_model_sessions = ctx->soil_models[zone].sessions;
+        } else {
+            status->soil_gain_pct_per_min = 0.0f;
+            status->soil_model_sessions = 0;
+        }
 
         // Statistics
-        status->stats.total_sessions = s_irrig_ctx.session_count;
-        status->stats.total_runtime_seconds = 0;  // TODO: accumulate from NVS
-        status->stats.today_runtime_seconds = s_irrig_ctx.total_runtime_today_sec;
-        status->stats.last_session_time = s_irrig_ctx.last_session_end_time;
+        status->stats.total_sessions = totals.total_sessions;
+        status->stats.total_runtime_seconds = totals.total_runtime_seconds;
+        status->stats.today_runtime_seconds = ctx->total_runtime_today_sec;
+        status->stats.emergency_stops = totals.emergency_stops;
+        status->stats.thermal_stops = totals.thermal_stops;
+        status->stats.last_session_time = ctx->last_session_end_time;
 
         // Last evaluation
-        status->last_eval = s_irrig_ctx.last_evaluation;
-        status->last_eval_time = s_irrig_ctx.last_eval_time;
+        status->last_eval = ctx->last_evaluation;
+        status->last_eval_time = ctx->last_eval_time;
     }
-    portEXIT_CRITICAL(&s_irrigation_spinlock);
+    portEXIT_CRITICAL(&ctx->spinlock);
 
     return ESP_OK;
 }
 
 bool irrigation_controller_is_initialized(void)
 {
-    return is_initialized;
+    return s_irrig_ctx.is_initialized;
 }
 
 bool irrigation_controller_is_online(void)
 {
+    irrigation_controller_context_t* ctx = &s_irrig_ctx;
     bool is_online;
 
-    portENTER_CRITICAL(&s_irrigation_spinlock);
+    portENTER_CRITICAL(&ctx->spinlock);
     {
-        is_online = s_irrig_ctx.is_online;
+        is_online = ctx->is_online;
     }
-    portEXIT_CRITICAL(&s_irrigation_spinlock);
+    portEXIT_CRITICAL(&ctx->spinlock);
 
     return is_online;
 }
 
 esp_err_t irrigation_controller_get_config(irrigation_controller_config_t* config)
 {
+    irrigation_controller_context_t* ctx = &s_irrig_ctx;
+
     if (config == NULL) {
         return ESP_ERR_INVALID_ARG;
     }
 
-    portENTER_CRITICAL(&s_irrigation_spinlock);
+    portENTER_CRITICAL(&ctx->spinlock);
     {
-        *config = s_irrig_ctx.config;
+        *config = ctx->config;
     }
-    portEXIT_CRITICAL(&s_irrigation_spinlock);
+    portEXIT_CRITICAL(&ctx->spinlock);
 
     return ESP_OK;
 }
@@ -861,7 +2500,9 @@ esp_err_t irrigation_controller_get_config(irrigation_controller_config_t* confi
 esp_err_t irrigation_controller_execute_command(irrigation_command_t command,
                                                 uint16_t duration_minutes)
 {
-    if (!is_initialized) {
+    irrigation_controller_context_t* ctx = &s_irrig_ctx;
+
+    if (!ctx->is_initialized) {
         ESP_LOGE(TAG, "Irrigation controller not initialized");
         return ESP_ERR_INVALID_STATE;
     }
@@ -870,32 +2511,41 @@ esp_err_t irrigation_controller_execute_command(irrigation_command_t command,
 
     // Get current state
     bool safety_lock;
-    time_t next_allowed;
+    int64_t next_allowed_ms;
     uint32_t daily_runtime;
+    uint8_t pulse_count;
 
-    portENTER_CRITICAL(&s_irrigation_spinlock);
+    portENTER_CRITICAL(&ctx->spinlock);
     {
-        safety_lock = s_irrig_ctx.safety_lock;
-        next_allowed = s_irrig_ctx.next_allowed_session;
-        daily_runtime = s_irrig_ctx.total_runtime_today_sec;
+        safety_lock = ctx->safety_lock;
+        next_allowed_ms = ctx->next_allowed_session_ms;
+        daily_runtime = ctx->total_runtime_today_sec;
+        pulse_count = ctx->pulse_count;
     }
-    portEXIT_CRITICAL(&s_irrigation_spinlock);
+    portEXIT_CRITICAL(&ctx->spinlock);
 
     // Handle EMERGENCY_STOP
     if (command == IRRIGATION_CMD_EMERGENCY_STOP) {
         ESP_LOGE(TAG, "EMERGENCY STOP executed via MQTT command");
 
         // Close all valves immediately
+        irrigation_pulse_cancel(ctx);
         valve_driver_emergency_close_all();
 
         // Activate safety lock
-        portENTER_CRITICAL(&s_irrigation_spinlock);
+        portENTER_CRITICAL(&ctx->spinlock);
         {
-            s_irrig_ctx.safety_lock = true;
-            s_irrig_ctx.is_valve_open = false;
-            s_irrig_ctx.current_state = IRRIGATION_EMERGENCY_STOP;
+            ctx->safety_lock = true;
+            ctx->is_valve_open = false;
+            ctx->current_state = IRRIGATION_EMERGENCY_STOP;
         }
-        portEXIT_CRITICAL(&s_irrigation_spinlock);
+        portEXIT_CRITICAL(&ctx->spinlock);
+        irrigation_log_decision(ctx, DECISION_EVENT_COMMAND, DECISION_REASON_EMERGENCY_STOP,
+                                0, 0, (uint8_t)command, NULL);
+        irrigation_session_end(ctx, -1.0f);
+        irrigation_stats_record_emergency_stop();
+        irrigation_journal_save(ctx, true);      // The lock must survive a crash
+        irrigation_update_sample_profile(ctx);
 
         // Send notification
         notification_send_irrigation_event("emergency_stop", 0.0f, 0.0f, 0.0f);
@@ -907,89 +2557,149 @@ esp_err_t irrigation_controller_execute_command(irrigation_command_t command,
     if (command == IRRIGATION_CMD_STOP) {
         ESP_LOGI(TAG, "Stop irrigation via MQTT command");
 
-        // Close valves
-        valve_driver_close(s_irrig_ctx.config.primary_valve);
+        // Close the session's valve (also ends a pulse program, soaking or not)
+        uint8_t valve;
+        portENTER_CRITICAL(&ctx->spinlock);
+        {
+            valve = (ctx->active_valve_num != 0) ? ctx->active_valve_num : ctx->config.primary_valve;
+        }
+        portEXIT_CRITICAL(&ctx->spinlock);
+        irrigation_pulse_cancel(ctx);
+        valve_driver_close(valve);
 
-        portENTER_CRITICAL(&s_irrigation_spinlock);
+        bool in_session;
+        uint32_t water_s = 0;
+        portENTER_CRITICAL(&ctx->spinlock);
         {
-            if (s_irrig_ctx.is_valve_open) {
-                s_irrig_ctx.is_valve_open = false;
-                s_irrig_ctx.last_session_end_time = time(NULL);
-                if (s_irrig_ctx.session_start_time > 0) {
-                    time_t duration = time(NULL) - s_irrig_ctx.session_start_time;
-                    s_irrig_ctx.total_runtime_today_sec += duration;
-                }
+            in_session = ctx->is_valve_open || ctx->pulse_count > 0;
+            if (in_session) {
+                water_s = (uint32_t)(irrigation_session_water_ms_locked(ctx, time_sync_get_monotonic_ms()) / 1000);
+                ctx->is_valve_open = false;
+                ctx->last_session_end_time = time(NULL);
             }
-            s_irrig_ctx.current_state = IRRIGATION_IDLE;
-            s_irrig_ctx.mqtt_override_active = false;
+            ctx->current_state = IRRIGATION_IDLE;
+            ctx->mqtt_override_active = false;
         }
-        portEXIT_CRITICAL(&s_irrigation_spinlock);
+        portEXIT_CRITICAL(&ctx->spinlock);
+        irrigation_log_decision(ctx, in_session ? DECISION_EVENT_VALVE_CLOSE : DECISION_EVENT_COMMAND,
+                                DECISION_REASON_REMOTE_COMMAND, valve,
+                                (uint16_t)water_s, (uint8_t)command, NULL);
+        irrigation_session_end(ctx, irrigation_latest_soil_avg());
+        irrigation_update_sample_profile(ctx);
 
         return ESP_OK;
     }
 
-    // Handle START
-    if (command == IRRIGATION_CMD_START) {
+    // Handle START / START_PULSE
+    if (command == IRRIGATION_CMD_START || command == IRRIGATION_CMD_START_PULSE) {
         // Check safety lock
         if (safety_lock) {
             ESP_LOGW(TAG, "Cannot START: safety lock is active (requires manual unlock)");
             return ESP_ERR_INVALID_STATE;
         }
 
+        // A running pulse program must be stopped first
+        if (pulse_count > 0) {
+            ESP_LOGW(TAG, "Cannot START: pulse program in progress");
+            return ESP_ERR_INVALID_STATE;
+        }
+
         // Check minimum interval between sessions
-        time_t now = time(NULL);
-        if (now < next_allowed) {
-            uint32_t wait_minutes = (next_allowed - now) / 60;
+        int64_t now_ms = time_sync_get_monotonic_ms();
+        if (now_ms < next_allowed_ms) {
+            uint32_t wait_minutes = (uint32_t)((next_allowed_ms - now_ms) / 60000);
             ESP_LOGW(TAG, "Cannot START: must wait %lu more minutes (min interval: %d minutes)",
-                     wait_minutes, s_irrig_ctx.config.min_interval_minutes);
+                     wait_minutes, ctx->config.min_interval_minutes);
             return ESP_ERR_INVALID_STATE;
         }
 
         // Check max daily duration
-        if (daily_runtime >= (s_irrig_ctx.config.max_daily_minutes * 60)) {
+        if (daily_runtime >= (ctx->config.max_daily_minutes * 60)) {
             ESP_LOGW(TAG, "Cannot START: max daily duration reached (%d minutes)",
-                     s_irrig_ctx.config.max_daily_minutes);
+                     ctx->config.max_daily_minutes);
             return ESP_ERR_INVALID_STATE;
         }
 
         // If duration not specified, use default
         if (duration_minutes == 0) {
-            duration_minutes = 15;  // Default 15 minutes
+            duration_minutes = (command == IRRIGATION_CMD_START_PULSE)
+                ? CONFIG_IRRIGATION_PULSE_COUNT * CONFIG_IRRIGATION_PULSE_ON_MINUTES
+                : 15;  // Default 15 minutes
         }
 
         // Validate duration against max
-        if (duration_minutes > s_irrig_ctx.config.max_duration_minutes) {
+        if (duration_minutes > ctx->config.max_duration_minutes) {
             ESP_LOGW(TAG, "Duration %d exceeds max %d, clamping",
-                     duration_minutes, s_irrig_ctx.config.max_duration_minutes);
-            duration_minutes = s_irrig_ctx.config.max_duration_minutes;
+                     duration_minutes, ctx->config.max_duration_minutes);
+            duration_minutes = ctx->config.max_duration_minutes;
+        }
+
+        if (command == IRRIGATION_CMD_START_PULSE) {
+            // Water time split into pulses of about CONFIG_IRRIGATION_PULSE_ON_MINUTES,
+            // limited to what is left of the daily budget
+            uint16_t daily_left_min = ctx->config.max_daily_minutes - daily_runtime / 60;
+            if (duration_minutes > daily_left_min) {
+                duration_minutes = daily_left_min;
+            }
+            uint8_t count = (duration_minutes + CONFIG_IRRIGATION_PULSE_ON_MINUTES - 1) /
+                            CONFIG_IRRIGATION_PULSE_ON_MINUTES;
+            if (count > IRRIGATION_PULSE_MAX) {
+                count = IRRIGATION_PULSE_MAX;
+            }
+            uint16_t on_minutes = (duration_minutes + count - 1) / count;
+
+            esp_err_t ret = irrigation_pulse_start(ctx, ctx->config.primary_valve, count,
+                                                   on_minutes, CONFIG_IRRIGATION_PULSE_SOAK_MINUTES);
+            if (ret != ESP_OK) {
+                return ret;
+            }
+
+            portENTER_CRITICAL(&ctx->spinlock);
+            {
+                ctx->mqtt_override_active = true;
+            }
+            portEXIT_CRITICAL(&ctx->spinlock);
+            irrigation_log_decision(ctx, DECISION_EVENT_VALVE_OPEN, DECISION_REASON_REMOTE_COMMAND,
+                                    ctx->config.primary_valve, duration_minutes,
+                                    (uint8_t)command, NULL);
+
+            notification_send_irrigation_event("irrigation_on", 0.0f, 0.0f, 0.0f);
+            return ESP_OK;
         }
 
         // Open valve
-        esp_err_t ret = valve_driver_open(s_irrig_ctx.config.primary_valve);
+        esp_err_t ret = valve_driver_open(ctx->config.primary_valve);
         if (ret != ESP_OK) {
             ESP_LOGE(TAG, "Failed to open valve: %s", esp_err_to_name(ret));
             return ret;
         }
 
         // Update state
-        portENTER_CRITICAL(&s_irrigation_spinlock);
+        portENTER_CRITICAL(&ctx->spinlock);
         {
-            s_irrig_ctx.is_valve_open = true;
-            s_irrig_ctx.active_valve_num = s_irrig_ctx.config.primary_valve;
-            s_irrig_ctx.session_start_time = time(NULL);
-            s_irrig_ctx.current_session_duration_min = duration_minutes;
-            s_irrig_ctx.current_state = IRRIGATION_ACTIVE;
-            s_irrig_ctx.session_count++;
-            s_irrig_ctx.mqtt_override_active = true;
+            ctx->is_valve_open = true;
+            ctx->active_valve_num = ctx->config.primary_valve;
+            ctx->session_start_ms = time_sync_get_monotonic_ms();
+            ctx->session_active = true;
+            ctx->current_session_duration_min = duration_minutes;
+            ctx->current_state = IRRIGATION_ACTIVE;
+            ctx->session_count++;
+            ctx->mqtt_override_active = true;
         }
-        portEXIT_CRITICAL(&s_irrigation_spinlock);
+        portEXIT_CRITICAL(&ctx->spinlock);
+        // Operator-chosen duration: closed loop, but still learned from
+        irrigation_session_begin(ctx, irrigation_latest_soil_avg(), false);
+        irrigation_update_sample_profile(ctx);
+        irrigation_log_decision(ctx, DECISION_EVENT_VALVE_OPEN, DECISION_REASON_REMOTE_COMMAND,
+                                ctx->config.primary_valve, duration_minutes,
+                                (uint8_t)command, NULL);
 
         // Reset watchdog timers
-        safety_watchdog_reset_session();
-        safety_watchdog_reset_valve_timer();
+        safety_watchdog_instance_reset_session(ctx->watchdog);
+        safety_watchdog_instance_reset_valve_timer(ctx->watchdog);
 
         ESP_LOGI(TAG, "Irrigation started via MQTT: valve %d, duration %d min",
-                 s_irrig_ctx.config.primary_valve, duration_minutes);
+                 ctx->config.primary_valve, duration_minutes);
 
         // Send notification
         notification_send_irrigation_event("irrigation_on", 0.0f, 0.0f, 0.0f);
@@ -1007,7 +2717,9 @@ esp_err_t irrigation_controller_evaluate_and_act(const soil_data_t* soil_data,
                                                  const ambient_data_t* ambient_data,
                                                  irrigation_evaluation_t* evaluation)
 {
-    if (!is_initialized) {
+    irrigation_controller_context_t* ctx = &s_irrig_ctx;
+
+    if (!ctx->is_initialized) {
         return ESP_ERR_INVALID_STATE;
     }
 
@@ -1016,25 +2728,20 @@ esp_err_t irrigation_controller_evaluate_and_act(const soil_data_t* soil_data,
         return ESP_ERR_INVALID_ARG;
     }
 
-    // Calculate average soil humidity from 3 sensors
-    float soil_avg = (soil_data->soil_humidity[0] +
-                      soil_data->soil_humidity[1] +
-                      soil_data->soil_humidity[2]) / 3.0f;
-
-    float soil_max = soil_data->soil_humidity[0];
-    if (soil_data->soil_humidity[1] > soil_max) soil_max = soil_data->soil_humidity[1];
-    if (soil_data->soil_humidity[2] > soil_max) soil_max = soil_data->soil_humidity[2];
+    // Calculate average soil humidity over the active sensors
+    float soil_avg = sensor_reader_soil_average(soil_data);
+    float soil_max = sensor_reader_soil_max(soil_data);
 
     // Get current state and mode
     irrigation_state_t current_state;
     bool is_online;
 
-    portENTER_CRITICAL(&s_irrigation_spinlock);
+    portENTER_CRITICAL(&ctx->spinlock);
     {
-        current_state = s_irrig_ctx.current_state;
-        is_online = s_irrig_ctx.is_online;
+        current_state = ctx->current_state;
+        is_online = ctx->is_online;
     }
-    portEXIT_CRITICAL(&s_irrigation_spinlock);
+    portEXIT_CRITICAL(&ctx->spinlock);
 
     // Initialize evaluation result
     irrigation_evaluation_t eval = {
@@ -1052,94 +2759,115 @@ esp_err_t irrigation_controller_evaluate_and_act(const soil_data_t* soil_data,
 
         if (current_state == IRRIGATION_IDLE) {
             // Check if should start
-            if (soil_avg < s_irrig_ctx.config.soil_threshold_critical) {
+            if (soil_avg < ctx->config.soil_threshold_critical) {
+                uint16_t planned = irrigation_model_plan_minutes(ctx, ctx->config.primary_valve, soil_avg);
                 eval.decision = IRRIGATION_DECISION_START;
-                eval.duration_minutes = 15;
-                snprintf(eval.reason, sizeof(eval.reason),
-                        "Dry soil (%.1f%% < %.1f%%), recommendation only",
-                        soil_avg, s_irrig_ctx.config.soil_threshold_critical);
-            } else if (soil_avg < s_irrig_ctx.config.soil_threshold_optimal) {
+                eval.duration_minutes = (planned > 0) ? planned : IRRIGATION_ONLINE_DEFAULT_MIN;
+                eval.reason = DECISION_REASON_SOIL_DRY;     // Recommendation only
+            } else if (soil_avg < ctx->config.soil_threshold_optimal) {
                 eval.decision = IRRIGATION_DECISION_NO_ACTION;
-                snprintf(eval.reason, sizeof(eval.reason),
-                        "Soil moisture adequate (%.1f%%)", soil_avg);
+                eval.reason = DECISION_REASON_SOIL_ADEQUATE;
             } else {
                 eval.decision = IRRIGATION_DECISION_NO_ACTION;
-                snprintf(eval.reason, sizeof(eval.reason),
-                        "Soil moisture sufficient (%.1f%%)", soil_avg);
+                eval.reason = DECISION_REASON_SOIL_SUFFICIENT;
             }
         } else if (current_state == IRRIGATION_ACTIVE) {
             // Monitoring running irrigation
-            if (soil_max >= s_irrig_ctx.config.soil_threshold_max) {
+            if (soil_max >= ctx->config.soil_threshold_max) {
                 eval.decision = IRRIGATION_DECISION_STOP;
-                snprintf(eval.reason, sizeof(eval.reason),
-                        "Over-moisture detected (%.1f%% >= %.1f%%)",
-                        soil_max, s_irrig_ctx.config.soil_threshold_max);
-            } else if (soil_avg >= s_irrig_ctx.config.soil_threshold_optimal) {
+                eval.reason = DECISION_REASON_OVER_MOISTURE;
+            } else if (soil_avg >= ctx->config.soil_threshold_optimal) {
                 eval.decision = IRRIGATION_DECISION_STOP;
-                snprintf(eval.reason, sizeof(eval.reason),
-                        "Target soil moisture reached (%.1f%% >= %.1f%%)",
-                        soil_avg, s_irrig_ctx.config.soil_threshold_optimal);
+                eval.reason = DECISION_REASON_TARGET_REACHED;
             } else {
                 eval.decision = IRRIGATION_DECISION_CONTINUE;
-                snprintf(eval.reason, sizeof(eval.reason),
-                        "Continue irrigation (soil %.1f%% < target %.1f%%)",
-                        soil_avg, s_irrig_ctx.config.soil_threshold_optimal);
+                eval.reason = DECISION_REASON_CONTINUE;
             }
         }
     } else {
         // OFFLINE MODE: Evaluate and execute automatically
-        offline_evaluation_t offline_eval = offline_mode_evaluate(soil_avg);
+        offline_evaluation_t offline_eval = offline_mode_instance_evaluate(ctx->offline, soil_avg);
 
         ESP_LOGD(TAG, "OFFLINE mode: level=%d, interval=%lu ms, soil=%.1f%%",
                  offline_eval.level, offline_eval.interval_ms, soil_avg);
 
         if (current_state == IRRIGATION_IDLE) {
             // Check offline level
-            if (offline_eval.level >= OFFLINE_LEVEL_CRITICAL) {
+            if (offline_eval.level >= OFFLINE_LEVEL_CRITICAL &&
+                !irrigation_window_allows_start(ctx, ctx->config.primary_valve,
+                                                offline_eval.level, soil_avg)) {
+                eval.decision = IRRIGATION_DECISION_NO_ACTION;
+                eval.reason = DECISION_REASON_WINDOW_DEFERRED;
+            } else if (offline_eval.level >= OFFLINE_LEVEL_CRITICAL) {
                 // Critical or emergency - start automatically
                 ESP_LOGI(TAG, "OFFLINE: Starting automatic irrigation (level=%d, soil=%.1f%%)",
                         offline_eval.level, soil_avg);
 
+#if CONFIG_IRRIGATION_PULSE_AUTO
+                // Execute start as a cycle-and-soak program
+                esp_err_t ret = irrigation_pulse_start(ctx, ctx->config.primary_valve,
+                                                       CONFIG_IRRIGATION_PULSE_COUNT,
+                                                       CONFIG_IRRIGATION_PULSE_ON_MINUTES,
+                                                       CONFIG_IRRIGATION_PULSE_SOAK_MINUTES);
+                if (ret == ESP_OK) {
+                    eval.decision = IRRIGATION_DECISION_START;
+                    eval.duration_minutes = CONFIG_IRRIGATION_PULSE_COUNT * CONFIG_IRRIGATION_PULSE_ON_MINUTES;
+                    eval.reason = DECISION_REASON_OFFLINE_LEVEL;
+                } else {
+                    eval.decision = IRRIGATION_DECISION_NO_ACTION;
+                    eval.reason = DECISION_REASON_VALVE_FAILURE;
+                }
+#else
                 // Execute start
-                esp_err_t ret = valve_driver_open(s_irrig_ctx.config.primary_valve);
+                esp_err_t ret = valve_driver_open(ctx->config.primary_valve);
                 if (ret == ESP_OK) {
-                    portENTER_CRITICAL(&s_irrigation_spinlock);
+                    portENTER_CRITICAL(&ctx->spinlock);
                     {
-                        s_irrig_ctx.is_valve_open = true;
-                        s_irrig_ctx.active_valve_num = s_irrig_ctx.config.primary_valve;
-                        s_irrig_ctx.session_start_time = time(NULL);
-                        s_irrig_ctx.current_state = IRRIGATION_ACTIVE;
-                        s_irrig_ctx.session_count++;
+                        ctx->is_valve_open = true;
+                        ctx->active_valve_num = ctx->config.primary_valve;
+                        ctx->session_start_ms = time_sync_get_monotonic_ms();
+                        ctx->session_active = true;
+                        ctx->current_state = IRRIGATION_ACTIVE;
+                        ctx->session_count++;
                     }
-                    portEXIT_CRITICAL(&s_irrigation_spinlock);
+                    portEXIT_CRITICAL(&ctx->spinlock);
 
-                    safety_watchdog_reset_session();
-                    safety_watchdog_reset_valve_timer();
+                    uint16_t planned = irrigation_session_begin(ctx, soil_avg, true);
+
+                    safety_watchdog_instance_reset_session(ctx->watchdog);
+                    safety_watchdog_instance_reset_valve_timer(ctx->watchdog);
 
                     eval.decision = IRRIGATION_DECISION_START;
-                    eval.duration_minutes = 20;
-                    snprintf(eval.reason, sizeof(eval.reason),
-                            "Auto-start OFFLINE (level=%s, soil=%.1f%%)",
-                            offline_eval.reason, soil_avg);
+                    eval.duration_minutes = (planned > 0) ? planned : IRRIGATION_OFFLINE_DEFAULT_MIN;
+                    eval.reason = DECISION_REASON_OFFLINE_LEVEL;
                 } else {
                     eval.decision = IRRIGATION_DECISION_NO_ACTION;
-                    snprintf(eval.reason, sizeof(eval.reason), "Failed to open valve");
+                    eval.reason = DECISION_REASON_VALVE_FAILURE;
                 }
+#endif
             } else {
                 eval.decision = IRRIGATION_DECISION_NO_ACTION;
-                snprintf(eval.reason, sizeof(eval.reason),
-                        "OFFLINE: Normal level, no action (soil=%.1f%%)", soil_avg);
+                eval.reason = DECISION_REASON_OFFLINE_NORMAL;
             }
         }
     }
 
+    // Only automatic actions are logged (recommendations repeat every cycle)
+    if (eval.reason == DECISION_REASON_OFFLINE_LEVEL || eval.reason == DECISION_REASON_VALVE_FAILURE) {
+        sensor_reading_t inputs = { .soil = *soil_data, .ambient = *ambient_data };
+        irrigation_log_decision(ctx, eval.reason == DECISION_REASON_OFFLINE_LEVEL
+                                    ? DECISION_EVENT_VALVE_OPEN : DECISION_EVENT_EVALUATION,
+                                eval.reason, ctx->config.primary_valve,
+                                eval.duration_minutes, 0, &inputs);
+    }
+
     // Save evaluation
-    portENTER_CRITICAL(&s_irrigation_spinlock);
+    portENTER_CRITICAL(&ctx->spinlock);
     {
-        s_irrig_ctx.last_evaluation = eval;
-        s_irrig_ctx.last_eval_time = time(NULL);
+        ctx->last_evaluation = eval;
+        ctx->last_eval_time = time(NULL);
     }
-    portEXIT_CRITICAL(&s_irrigation_spinlock);
+    portEXIT_CRITICAL(&ctx->spinlock);
 
     // Return result if requested
     if (evaluation != NULL) {
@@ -1153,47 +2881,55 @@ esp_err_t irrigation_controller_evaluate_and_act(const soil_data_t* soil_data,
 
 esp_err_t irrigation_controller_get_stats(irrigation_stats_t* stats)
 {
+    irrigation_controller_context_t* ctx = &s_irrig_ctx;
+
     if (stats == NULL) {
         return ESP_ERR_INVALID_ARG;
     }
 
-    if (!is_initialized) {
+    if (!ctx->is_initialized) {
         return ESP_ERR_INVALID_STATE;
     }
 
-    portENTER_CRITICAL(&s_irrigation_spinlock);
+    irrigation_stats_totals_t totals;
+    irrigation_stats_get(&totals);
+
+    portENTER_CRITICAL(&ctx->spinlock);
     {
-        stats->total_sessions = s_irrig_ctx.session_count;
-        stats->total_runtime_seconds = 0;  // TODO: read from NVS
-        stats->today_runtime_seconds = s_irrig_ctx.total_runtime_today_sec;
-        stats->emergency_stops = 0;        // TODO: increment in emergency_stop
-        stats->thermal_stops = 0;          // TODO: increment in thermal protection
-        stats->last_session_time = s_irrig_ctx.last_session_end_time;
+        stats->total_sessions = totals.total_sessions;
+        stats->total_runtime_seconds = totals.total_runtime_seconds;
+        stats->today_runtime_seconds = ctx->total_runtime_today_sec;
+        stats->emergency_stops = totals.emergency_stops;
+        stats->thermal_stops = totals.thermal_stops;
+        stats->last_session_time = ctx->last_session_end_time;
 
         // Memset to avoid uninitialized data
         memset(&stats->last_session, 0, sizeof(irrigation_session_t));
     }
-    portEXIT_CRITICAL(&s_irrigation_spinlock);
+    portEXIT_CRITICAL(&ctx->spinlock);
 
     return ESP_OK;
 }
 
 esp_err_t irrigation_controller_reset_daily_stats(void)
 {
-    if (!is_initialized) {
+    irrigation_controller_context_t* ctx = &s_irrig_ctx;
+
+    if (!ctx->is_initialized) {
         return ESP_ERR_INVALID_STATE;
     }
 
     ESP_LOGI(TAG, "Resetting daily statistics");
 
-    portENTER_CRITICAL(&s_irrigation_spinlock);
+    portENTER_CRITICAL(&ctx->spinlock);
     {
-        s_irrig_ctx.total_runtime_today_sec = 0;
+        ctx->total_runtime_today_sec = 0;
     }
-    portEXIT_CRITICAL(&s_irrigation_spinlock);
+    portEXIT_CRITICAL(&ctx->spinlock);
 
-    // TODO: Persist to NVS for recovery after reboot
-    // device_config_set_u32("irrig_cfg", "today_run", 0);
+    // Checkpoint so a reboot does not restore yesterday's runtime
+    irrigation_journal_save(ctx, true);
+    irrigation_stats_checkpoint(true);
 
     return ESP_OK;
 }
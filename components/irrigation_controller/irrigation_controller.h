@@ -32,6 +32,7 @@
 #include "esp_err.h"
 #include "esp_event.h"
 #include "common_types.h"
+#include "decision_log.h"
 #include <stdbool.h>
 
 #ifdef __cplusplus
@@ -60,7 +61,7 @@ typedef struct {
     uint16_t duration_minutes;          ///< Recommended duration (for START)
     float soil_avg_humidity;            ///< Average soil humidity evaluated
     float ambient_temperature;          ///< Current temperature
-    char reason[64];                    ///< Human-readable reason
+    decision_reason_t reason;           ///< Reason code (decision_log_reason_to_string())
 } irrigation_evaluation_t;
 
 /**
@@ -143,6 +144,22 @@ typedef struct {
     uint32_t session_start;             ///< Current session start
     uint32_t session_elapsed_sec;       ///< Current session elapsed time
     uint8_t active_valve;               ///< Active valve (1-2, 0=none)
+    uint16_t planned_duration_min;      ///< Learned-model duration (0 = stop on threshold)
+
+    // Learned soil response of the primary valve zone
+    float soil_gain_pct_per_min;        ///< Soaked rise per minute (0 = not learned)
+    uint16_t soil_model_sessions;       ///< Sessions learned from
+
+    // Time-of-day start window of the primary valve zone
+    bool deferred_start_pending;        ///< Automatic start waiting for the window
+    uint16_t minutes_until_window;      ///< 0 if the window is open (or clock unsynced)
+
+    // Cycle-and-soak pulse program (pulse_count 0 = continuous session)
+    uint8_t pulse_count;                ///< Pulses in the program
+    uint8_t pulse_index;                ///< Current pulse (1-pulse_count)
+    bool pulse_soaking;                 ///< Valve closed, soaking after pulse_index
+    uint32_t pulse_phase_remaining_sec; ///< Time left in the current on/soak period
+    uint32_t session_water_sec;         ///< Valve-open time of the session (soaks excluded)
 
     // Safety status
     bool safety_lock;                   ///< Safety lock active
@@ -220,10 +237,30 @@ esp_err_t irrigation_controller_evaluate_and_act(const soil_data_t* soil_data,
  */
 esp_err_t irrigation_controller_start(uint16_t duration_minutes, uint8_t valve_number);
 
+/**
+ * @brief Start a cycle-and-soak pulse program
+ *
+ * Opens the valve for @p pulse_count on-periods separated by soak periods
+ * (valve closed) so water infiltrates instead of running off. Phase
+ * changes run on an esp_timer, not on the evaluation loop. Only on-periods
+ * count against the daily and per-session limits; the program ends early
+ * when the soil reaches the target or the budget runs out.
+ *
+ * @param pulse_count Number of pulses (1-IRRIGATION_PULSE_MAX)
+ * @param on_minutes Valve-open time of each pulse
+ * @param soak_minutes Valve-closed time between pulses
+ * @param valve_number Valve to use (1-2, 0 for primary)
+ * @return ESP_OK if started, ESP_ERR_INVALID_ARG on bad parameters,
+ *         ESP_ERR_INVALID_STATE if a safety check failed
+ */
+esp_err_t irrigation_controller_start_pulse(uint8_t pulse_count, uint16_t on_minutes,
+                                            uint16_t soak_minutes, uint8_t valve_number);
+
 /**
  * @brief Manual stop irrigation
  *
- * Manually stops current irrigation session.
+ * Manually stops current irrigation session, including a pulse program,
+ * and stops the evaluation task (it exits at its next wakeup).
  *
  * @return ESP_OK on success
  */
@@ -440,6 +477,11 @@ typedef enum {
  */
 #define IRRIGATION_DEFAULT_DURATION_MIN     15
 
+/**
+ * @brief Maximum pulses of a cycle-and-soak program
+ */
+#define IRRIGATION_PULSE_MAX                10
+
 /**
  * @brief Irrigation controller NVS namespace
  */
@@ -457,6 +499,8 @@ typedef enum {
  */
 #define IRRIGATION_NVS_KEY_TOTAL_SESSIONS   "total_sess"
 #define IRRIGATION_NVS_KEY_TOTAL_RUNTIME    "total_run"
+#define IRRIGATION_NVS_KEY_EMERGENCY_STOPS  "emerg_stops"
+#define IRRIGATION_NVS_KEY_THERMAL_STOPS    "therm_stops"
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,363 @@
+/**
+ * @file metrics.c
+ * @brief Metrics Component - Registry and OpenMetrics exporter
+ *
+ * The registry is a singly linked list threaded through the static metric
+ * objects; it only grows, and members of one family (same name, different
+ * labels) are kept adjacent so the family gets a single HELP/TYPE block.
+ * Registration and link reads take a spinlock, value updates never do
+ * (see metrics.h).
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "metrics.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <inttypes.h>
+
+/* ============================ PRIVATE TYPES ============================ */
+
+/**
+ * @brief Export state: fixed buffer plus the sink it drains into
+ */
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t pos;
+    metrics_flush_t flush;
+    void *ctx;
+    esp_err_t err;
+} metrics_writer_t;
+
+/* ============================ PRIVATE STATE ============================ */
+
+static const char *TAG = "metrics";
+
+static metrics_desc_t *s_head = NULL;
+static metrics_desc_t *s_tail = NULL;
+static portMUX_TYPE s_metrics_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+/* ============================ SYSTEM GAUGES ============================ */
+
+static int32_t read_free_heap(void)
+{
+    return (int32_t)esp_get_free_heap_size();
+}
+
+static int32_t read_min_free_heap(void)
+{
+    return (int32_t)esp_get_minimum_free_heap_size();
+}
+
+static int32_t read_uptime(void)
+{
+    return (int32_t)(esp_timer_get_time() / 1000000);
+}
+
+static metrics_gauge_t s_free_heap = METRICS_GAUGE_INIT(
+    "esp_free_heap_bytes", "Free heap", NULL, read_free_heap);
+static metrics_gauge_t s_min_free_heap = METRICS_GAUGE_INIT(
+    "esp_min_free_heap_bytes", "Lowest free heap since boot", NULL, read_min_free_heap);
+static metrics_gauge_t s_uptime = METRICS_GAUGE_INIT(
+    "esp_uptime_seconds", "Seconds since boot", NULL, read_uptime);
+
+/* ============================ REGISTRY ============================ */
+
+static bool metrics_name_valid(const char *name)
+{
+    if (name == NULL || name[0] == '\0' || (name[0] >= '0' && name[0] <= '9')) {
+        return false;
+    }
+    for (const char *p = name; *p != '\0'; p++) {
+        bool ok = (*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z') ||
+                  (*p >= '0' && *p <= '9') || *p == '_' || *p == ':';
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool metrics_histogram_valid(const metrics_histogram_t *histogram)
+{
+    if (histogram->bounds == NULL || histogram->bound_count == 0 ||
+        histogram->bound_count > METRICS_HISTOGRAM_MAX_BOUNDS) {
+        return false;
+    }
+    for (uint8_t i = 1; i < histogram->bound_count; i++) {
+        if (histogram->bounds[i] <= histogram->bounds[i - 1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static metrics_desc_t* registry_first(void)
+{
+    metrics_desc_t *desc;
+    portENTER_CRITICAL(&s_metrics_spinlock);
+    {
+        desc = s_head;
+    }
+    portEXIT_CRITICAL(&s_metrics_spinlock);
+    return desc;
+}
+
+static metrics_desc_t* registry_next(const metrics_desc_t *desc)
+{
+    metrics_desc_t *next;
+    portENTER_CRITICAL(&s_metrics_spinlock);
+    {
+        next = desc->next;
+    }
+    portEXIT_CRITICAL(&s_metrics_spinlock);
+    return next;
+}
+
+/* ============================ EXPORT ============================ */
+
+static void writer_flush(metrics_writer_t *w)
+{
+    if (w->err == ESP_OK && w->pos > 0) {
+        w->err = w->flush(w->buf, w->pos, w->ctx);
+        w->pos = 0;
+    }
+}
+
+/**
+ * @brief Append one formatted line, flushing first if it does not fit
+ */
+static void writer_printf(metrics_writer_t *w, const char *fmt, ...)
+{
+    for (int attempt = 0; attempt < 2 && w->err == ESP_OK; attempt++) {
+        va_list args;
+        va_start(args, fmt);
+        int n = vsnprintf(w->buf + w->pos, w->size - w->pos, fmt, args);
+        va_end(args);
+
+        if (n < 0) {
+            w->err = ESP_FAIL;
+            return;
+        }
+        if ((size_t)n < w->size - w->pos) {
+            w->pos += (size_t)n;
+            return;
+        }
+        if (w->pos == 0) {
+            break;
+        }
+        writer_flush(w);
+    }
+
+    if (w->err == ESP_OK) {
+        w->err = ESP_ERR_INVALID_SIZE;
+    }
+}
+
+static void export_family_header(metrics_writer_t *w, const metrics_desc_t *desc)
+{
+    static const char *type_names[] = { "counter", "gauge", "histogram" };
+
+    writer_printf(w, "# HELP %s %s\n", desc->name, desc->help);
+    writer_printf(w, "# TYPE %s %s\n", desc->name, type_names[desc->type]);
+}
+
+static void export_counter(metrics_writer_t *w, const metrics_counter_t *counter)
+{
+    const char *labels = counter->desc.labels;
+
+    writer_printf(w, "%s_total%s%s%s %" PRIu32 "\n", counter->desc.name,
+                  labels ? "{" : "", labels ? labels : "", labels ? "}" : "",
+                  metrics_counter_get(counter));
+}
+
+static void export_gauge(metrics_writer_t *w, const metrics_gauge_t *gauge)
+{
+    const char *labels = gauge->desc.labels;
+    int32_t value = (gauge->read != NULL) ? gauge->read()
+                                          : atomic_load_explicit(&gauge->value, memory_order_relaxed);
+
+    writer_printf(w, "%s%s%s%s %" PRId32 "\n", gauge->desc.name,
+                  labels ? "{" : "", labels ? labels : "", labels ? "}" : "", value);
+}
+
+static void export_histogram(metrics_writer_t *w, const metrics_histogram_t *histogram)
+{
+    const char *name = histogram->desc.name;
+    const char *labels = histogram->desc.labels ? histogram->desc.labels : "";
+    const char *sep = histogram->desc.labels ? "," : "";
+
+    uint32_t cumulative = 0;
+    for (uint8_t i = 0; i <= histogram->bound_count; i++) {
+        for (int core = 0; core < METRICS_CORES; core++) {
+            cumulative += atomic_load_explicit(&histogram->buckets[core][i], memory_order_relaxed);
+        }
+        if (i < histogram->bound_count) {
+            writer_printf(w, "%s_bucket{%s%sle=\"%" PRIu32 "\"} %" PRIu32 "\n",
+                          name, labels, sep, histogram->bounds[i], cumulative);
+        } else {
+            writer_printf(w, "%s_bucket{%s%sle=\"+Inf\"} %" PRIu32 "\n",
+                          name, labels, sep, cumulative);
+        }
+    }
+
+    uint32_t sum = 0;
+    for (int core = 0; core < METRICS_CORES; core++) {
+        sum += atomic_load_explicit(&histogram->sum[core], memory_order_relaxed);
+    }
+
+    const char *open = histogram->desc.labels ? "{" : "";
+    const char *close = histogram->desc.labels ? "}" : "";
+    writer_printf(w, "%s_sum%s%s%s %" PRIu32 "\n", name, open, labels, close, sum);
+    writer_printf(w, "%s_count%s%s%s %" PRIu32 "\n", name, open, labels, close, cumulative);
+}
+
+/* ============================ PUBLIC API ============================ */
+
+esp_err_t metrics_init(void)
+{
+    esp_err_t ret = metrics_register(&s_free_heap.desc);
+    if (ret == ESP_OK) {
+        ret = metrics_register(&s_min_free_heap.desc);
+    }
+    if (ret == ESP_OK) {
+        ret = metrics_register(&s_uptime.desc);
+    }
+    return ret;
+}
+
+esp_err_t metrics_register(metrics_desc_t *desc)
+{
+    if (desc == NULL || !metrics_name_valid(desc->name) || desc->help == NULL ||
+        desc->type > METRICS_TYPE_HISTOGRAM) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (desc->type == METRICS_TYPE_HISTOGRAM &&
+        !metrics_histogram_valid((const metrics_histogram_t*)desc)) {
+        ESP_LOGE(TAG, "Histogram %s: 1..%d ascending bounds required",
+                 desc->name, METRICS_HISTOGRAM_MAX_BOUNDS);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = ESP_OK;
+    portENTER_CRITICAL(&s_metrics_spinlock);
+    {
+        if (!desc->registered) {
+            // Link after the last member of the family, or at the tail
+            metrics_desc_t *prev = s_tail;
+            for (metrics_desc_t *it = s_head; it != NULL; it = it->next) {
+                if (strcmp(it->name, desc->name) == 0) {
+                    if (it->type != desc->type) {
+                        ret = ESP_ERR_INVALID_ARG;
+                        break;
+                    }
+                    prev = it;
+                    while (prev->next != NULL && strcmp(prev->next->name, desc->name) == 0) {
+                        prev = prev->next;
+                    }
+                    break;
+                }
+            }
+
+            if (ret == ESP_OK) {
+                desc->registered = true;
+                if (prev == NULL) {
+                    desc->next = NULL;
+                    s_head = desc;
+                } else {
+                    desc->next = prev->next;
+                    prev->next = desc;
+                }
+                if (desc->next == NULL) {
+                    s_tail = desc;
+                }
+            }
+        }
+    }
+    portEXIT_CRITICAL(&s_metrics_spinlock);
+
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Metric %s: family already registered with another type", desc->name);
+    }
+    return ret;
+}
+
+esp_err_t metrics_export(char *buf, size_t size, metrics_flush_t flush, void *ctx)
+{
+    if (buf == NULL || size == 0 || flush == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    metrics_writer_t w = {
+        .buf = buf,
+        .size = size,
+        .flush = flush,
+        .ctx = ctx,
+        .err = ESP_OK,
+    };
+
+    const char *family = NULL;
+    for (metrics_desc_t *desc = registry_first(); desc != NULL && w.err == ESP_OK;
+         desc = registry_next(desc)) {
+        // One HELP/TYPE per family (registration keeps families adjacent)
+        if (family == NULL || strcmp(family, desc->name) != 0) {
+            export_family_header(&w, desc);
+            family = desc->name;
+        }
+
+        switch (desc->type) {
+            case METRICS_TYPE_COUNTER:
+                export_counter(&w, (const metrics_counter_t*)desc);
+                break;
+            case METRICS_TYPE_GAUGE:
+                export_gauge(&w, (const metrics_gauge_t*)desc);
+                break;
+            case METRICS_TYPE_HISTOGRAM:
+                export_histogram(&w, (const metrics_histogram_t*)desc);
+                break;
+        }
+    }
+
+    writer_printf(&w, "# EOF\n");
+    writer_flush(&w);
+
+    if (w.err != ESP_OK) {
+        ESP_LOGW(TAG, "Export aborted: %s", esp_err_to_name(w.err));
+    }
+    return w.err;
+}
+
+uint32_t metrics_counter_get(const metrics_counter_t *counter)
+{
+    uint32_t total = 0;
+    for (int core = 0; core < METRICS_CORES; core++) {
+        total += atomic_load_explicit(&counter->cells[core], memory_order_relaxed);
+    }
+    return total;
+}
+
+void metrics_counter_reset(metrics_counter_t *counter)
+{
+    for (int core = 0; core < METRICS_CORES; core++) {
+        atomic_store_explicit(&counter->cells[core], 0, memory_order_relaxed);
+    }
+}
+
+void metrics_histogram_observe(metrics_histogram_t *histogram, uint32_t value)
+{
+    uint8_t bucket = 0;
+    while (bucket < histogram->bound_count && value > histogram->bounds[bucket]) {
+        bucket++;
+    }
+
+    int core = xPortGetCoreID();
+    atomic_fetch_add_explicit(&histogram->buckets[core][bucket], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&histogram->sum[core], value, memory_order_relaxed);
+}
@@ -0,0 +1,227 @@
+/**
+ * @file metrics.h
+ * @brief Metrics Component - Registry of counters, gauges and histograms
+ *
+ * Components define their metrics as static objects with the *_INIT
+ * macros and register them once at init; nothing is allocated. Updates
+ * are relaxed atomic adds on a per-core cell, so hot paths (httpd
+ * handlers, MQTT events, the sensor task) never take a lock and the two
+ * cores never contend on the same word. The exporter sums the cells.
+ *
+ * Export (OpenMetrics text, what Prometheus scrapes):
+ * - Counter "x" is exported as x_total
+ * - Histogram "x" as x_bucket{le=...}, x_sum and x_count
+ * - Metrics sharing a name form one family (one HELP/TYPE), differ only
+ *   in their labels and are exported together whatever their
+ *   registration order
+ * - Output is written into a caller buffer and flushed whenever it fills,
+ *   so any number of metrics streams through a fixed-size chunk
+ *
+ * Values are 32-bit (lock-free on the ESP32 atomics); counters wrap,
+ * which the scraper treats as a counter reset.
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================ CONSTANTS ============================ */
+
+#ifndef CONFIG_METRICS_EXPORT_CHUNK_SIZE
+#define CONFIG_METRICS_EXPORT_CHUNK_SIZE 512
+#endif
+
+#define METRICS_CORES                   portNUM_PROCESSORS
+#define METRICS_HISTOGRAM_MAX_BOUNDS    8       ///< Finite buckets per histogram (+Inf is implicit)
+#define METRICS_EXPORT_CHUNK_SIZE       CONFIG_METRICS_EXPORT_CHUNK_SIZE
+
+/* ============================ TYPES ============================ */
+
+/**
+ * @brief Metric type
+ */
+typedef enum {
+    METRICS_TYPE_COUNTER = 0,
+    METRICS_TYPE_GAUGE,
+    METRICS_TYPE_HISTOGRAM
+} metrics_type_t;
+
+/**
+ * @brief Common metric header (first member of every metric)
+ */
+typedef struct metrics_desc {
+    const char *name;               ///< Family name ([a-z_], no _total suffix)
+    const char *help;               ///< HELP text
+    const char *labels;             ///< Label set without braces, e.g. endpoint="ping" (NULL = none)
+    metrics_type_t type;
+    bool registered;
+    struct metrics_desc *next;      ///< Registry link
+} metrics_desc_t;
+
+/**
+ * @brief Monotonic counter
+ */
+typedef struct {
+    metrics_desc_t desc;
+    _Atomic uint32_t cells[METRICS_CORES];
+} metrics_counter_t;
+
+/**
+ * @brief Gauge read at export time instead of being stored
+ */
+typedef int32_t (*metrics_gauge_read_t)(void);
+
+/**
+ * @brief Gauge (set/add, or sampled through a read callback)
+ */
+typedef struct {
+    metrics_desc_t desc;
+    _Atomic int32_t value;
+    metrics_gauge_read_t read;      ///< Overrides value when set
+} metrics_gauge_t;
+
+/**
+ * @brief Histogram with fixed integer bucket bounds
+ *
+ * Bucket and sum cells are updated separately; a scrape racing an
+ * observation may see the count one ahead of the sum.
+ */
+typedef struct {
+    metrics_desc_t desc;
+    const uint32_t *bounds;         ///< Ascending upper bounds (inclusive)
+    uint8_t bound_count;            ///< Entries in bounds (<= METRICS_HISTOGRAM_MAX_BOUNDS)
+    _Atomic uint32_t buckets[METRICS_CORES][METRICS_HISTOGRAM_MAX_BOUNDS + 1];  ///< Last is +Inf
+    _Atomic uint32_t sum[METRICS_CORES];
+} metrics_histogram_t;
+
+/**
+ * @brief Sink for exported text
+ *
+ * @param data Complete lines
+ * @param len Bytes in @p data
+ * @param ctx User context passed to metrics_export()
+ * @return ESP_OK to continue, any error aborts the export
+ */
+typedef esp_err_t (*metrics_flush_t)(const char *data, size_t len, void *ctx);
+
+/* ============================ STATIC DEFINITION ============================ */
+
+#define METRICS_DESC_INIT(name_, help_, labels_, type_) \
+    { .name = (name_), .help = (help_), .labels = (labels_), .type = (type_) }
+
+/**
+ * @brief Initializer for a static metrics_counter_t
+ */
+#define METRICS_COUNTER_INIT(name_, help_, labels_) \
+    { .desc = METRICS_DESC_INIT(name_, help_, labels_, METRICS_TYPE_COUNTER) }
+
+/**
+ * @brief Initializer for a static metrics_gauge_t (read_ may be NULL)
+ */
+#define METRICS_GAUGE_INIT(name_, help_, labels_, read_) \
+    { .desc = METRICS_DESC_INIT(name_, help_, labels_, METRICS_TYPE_GAUGE), .read = (read_) }
+
+/**
+ * @brief Initializer for a static metrics_histogram_t
+ *
+ * @p bounds_ must be a static const uint32_t array (its size is taken here).
+ */
+#define METRICS_HISTOGRAM_INIT(name_, help_, labels_, bounds_) \
+    { .desc = METRICS_DESC_INIT(name_, help_, labels_, METRICS_TYPE_HISTOGRAM), \
+      .bounds = (bounds_), .bound_count = (uint8_t)(sizeof(bounds_) / sizeof((bounds_)[0])) }
+
+/* ============================ PUBLIC API ============================ */
+
+/**
+ * @brief Register the built-in system gauges (heap, uptime)
+ *
+ * @return ESP_OK on success
+ */
+esp_err_t metrics_init(void);
+
+/**
+ * @brief Add a metric to the registry
+ *
+ * Safe from any task; registering twice is a no-op. Metrics cannot be
+ * removed, so they must have static storage. Metrics sharing a name form
+ * one family: they must have the same type and are exported together,
+ * in any registration order.
+ *
+ * @param desc &metric.desc
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for a bad name or histogram,
+ *         or a type that differs from the family's
+ */
+esp_err_t metrics_register(metrics_desc_t *desc);
+
+/**
+ * @brief Stream every registered metric as OpenMetrics text
+ *
+ * Lines are formatted into @p buf and handed to @p flush whenever the next
+ * line would not fit, then once more at the end (after "# EOF").
+ *
+ * @param buf Work buffer (METRICS_EXPORT_CHUNK_SIZE is enough)
+ * @param size Size of @p buf
+ * @param flush Output sink
+ * @param ctx Passed to @p flush
+ * @return ESP_OK on success, the flush error, or ESP_ERR_INVALID_SIZE if a
+ *         single line does not fit @p buf
+ */
+esp_err_t metrics_export(char *buf, size_t size, metrics_flush_t flush, void *ctx);
+
+/**
+ * @brief Current value of a counter (sum of the per-core cells)
+ */
+uint32_t metrics_counter_get(const metrics_counter_t *counter);
+
+/**
+ * @brief Zero a counter (for legacy "reset statistics" APIs)
+ */
+void metrics_counter_reset(metrics_counter_t *counter);
+
+/**
+ * @brief Record one observation
+ */
+void metrics_histogram_observe(metrics_histogram_t *histogram, uint32_t value);
+
+/* ============================ HOT-PATH UPDATES ============================ */
+
+static inline void metrics_counter_add(metrics_counter_t *counter, uint32_t n)
+{
+    atomic_fetch_add_explicit(&counter->cells[xPortGetCoreID()], n, memory_order_relaxed);
+}
+
+static inline void metrics_counter_inc(metrics_counter_t *counter)
+{
+    metrics_counter_add(counter, 1);
+}
+
+static inline void metrics_gauge_set(metrics_gauge_t *gauge, int32_t value)
+{
+    atomic_store_explicit(&gauge->value, value, memory_order_relaxed);
+}
+
+static inline void metrics_gauge_add(metrics_gauge_t *gauge, int32_t delta)
+{
+    atomic_fetch_add_explicit(&gauge->value, delta, memory_order_relaxed);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // METRICS_H
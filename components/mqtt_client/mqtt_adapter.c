@@ -30,11 +30,18 @@
 #include "sensor_reader.h"
 #include "device_config.h"
 #include "wifi_manager.h"
+#include "event_bus.h"
+#include "time_sync.h"
+#include "ota_manager.h"
+#include "decision_log.h"
+#include "payload_cache.h"
+#include "metrics.h"
 
 #include "sdkconfig.h"
 
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <inttypes.h>
 
 /* ========================== CONSTANTS AND MACROS ========================== */
@@ -45,21 +52,28 @@ static const char *TAG = "mqtt_client";
 #define MQTT_DEFAULT_BROKER_URI CONFIG_MQTT_BROKER_URI
 
 #define MQTT_DEFAULT_PORT               8083
-#define MQTT_DEFAULT_KEEPALIVE_SEC      60
 #define MQTT_DEFAULT_USE_WEBSOCKETS     true
 #define MQTT_DEFAULT_ENABLE_SSL         true
-#define MQTT_CLIENT_ID_PREFIX           "ESP32"
 
-// Reconnection configuration (exponential backoff)
-#define MQTT_RECONNECT_INITIAL_DELAY_MS 10000   // 10 seconds
-#define MQTT_RECONNECT_MAX_DELAY_MS     3600000 // 1 hour
+// Keepalive, client id prefix and reconnect backoff: mqtt_protocol.h
 
 // Buffer sizes
 #define MQTT_BUFFER_SIZE                4096
-#define MQTT_TASK_STACK_SIZE            6144
 
-// Firmware version
-#define FIRMWARE_VERSION                "v1.2.0"
+// Task stacks (menuconfig)
+#ifndef CONFIG_MQTT_TASK_STACK_SIZE
+#define CONFIG_MQTT_TASK_STACK_SIZE     6144
+#endif
+
+#ifndef CONFIG_MQTT_BUS_TASK_STACK_SIZE
+#define CONFIG_MQTT_BUS_TASK_STACK_SIZE 3072
+#endif
+
+#define MQTT_TASK_STACK_SIZE            CONFIG_MQTT_TASK_STACK_SIZE
+
+// Event bus subscriber (WiFi IP obtained / disconnected)
+#define MQTT_BUS_TASK_STACK_SIZE        CONFIG_MQTT_BUS_TASK_STACK_SIZE
+#define MQTT_BUS_TASK_PRIORITY          4
 
 /* ========================== TYPES AND STRUCTURES ========================== */
 
@@ -97,16 +111,25 @@ typedef struct {
 
 static mqtt_client_context_t s_mqtt_ctx = {0};
 
-// Event base declaration
-ESP_EVENT_DEFINE_BASE(MQTT_CLIENT_EVENTS);
+// Event bus subscriptions cannot be removed; survive deinit/re-init cycles
+static bool s_bus_subscribed = false;
+
+// Counters in the metrics registry (message_count/reconnect_count of mqtt_status_t)
+static metrics_counter_t s_mqtt_published = METRICS_COUNTER_INIT(
+    "mqtt_messages_published", "Publishes acknowledged by the broker", NULL);
+static metrics_counter_t s_mqtt_received = METRICS_COUNTER_INIT(
+    "mqtt_messages_received", "Messages received on subscribed topics", NULL);
+static metrics_counter_t s_mqtt_connections = METRICS_COUNTER_INIT(
+    "mqtt_connections", "Successful broker connections", NULL);
+static metrics_counter_t s_mqtt_errors = METRICS_COUNTER_INIT(
+    "mqtt_errors", "MQTT client errors", NULL);
 
 /* ========================== FORWARD DECLARATIONS ========================== */
 
 // Event handlers
 static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
                                int32_t event_id, void *event_data);
-static void mqtt_wifi_event_handler(void* arg, esp_event_base_t event_base,
-                                    int32_t event_id, void* event_data);
+static void mqtt_wifi_event_handler(const event_bus_event_t *event, void *user_ctx);
 static void mqtt_reconnect_timer_callback(void* arg);
 
 // Internal helpers
@@ -115,8 +138,6 @@ static esp_err_t mqtt_configure_client(void);
 static esp_err_t mqtt_start_reconnect_timer(uint32_t delay_ms);
 static void mqtt_handle_irrigation_command(esp_mqtt_event_t* event);
 static esp_err_t mqtt_build_device_json(cJSON** json_out);
-static esp_err_t mqtt_build_sensor_data_json(const sensor_reading_t* reading,
-                                             cJSON** json_out);
 
 /* ========================== INITIALIZATION ========================== */
 
@@ -132,8 +153,7 @@ static esp_err_t mqtt_generate_client_id(char* client_id, size_t size)
         return ret;
     }
 
-    snprintf(client_id, size, "%s_%02X%02X%02X",
-             MQTT_CLIENT_ID_PREFIX, mac[3], mac[4], mac[5]);
+    mqtt_protocol_client_id(mac, client_id, size);
 
     ESP_LOGI(TAG, "Generated MQTT client ID: %s", client_id);
     return ESP_OK;
@@ -225,15 +245,32 @@ esp_err_t mqtt_client_init(void)
         return ret;
     }
 
-    // Register WiFi event handler (auto-start on IP obtained)
-    ret = esp_event_handler_register(WIFI_MANAGER_EVENTS, ESP_EVENT_ANY_ID,
-                                     &mqtt_wifi_event_handler, NULL);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to register WiFi event handler: %s",
-                 esp_err_to_name(ret));
-        return ret;
+    // Subscribe to WiFi events on the bus (auto-start on IP obtained)
+    if (!s_bus_subscribed) {
+        const event_bus_subscriber_config_t bus_cfg = {
+            .name = "mqtt_bus",
+            .event_mask = EVENT_BUS_MASK(EVENT_BUS_WIFI_IP_OBTAINED) |
+                          EVENT_BUS_MASK(EVENT_BUS_WIFI_DISCONNECTED),
+            .handler = mqtt_wifi_event_handler,
+            .user_ctx = NULL,
+            .stack_size = MQTT_BUS_TASK_STACK_SIZE,
+            .priority = MQTT_BUS_TASK_PRIORITY,
+            .queue_len = 0,
+        };
+        ret = event_bus_subscribe(&bus_cfg);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to subscribe to WiFi events: %s",
+                     esp_err_to_name(ret));
+            return ret;
+        }
+        s_bus_subscribed = true;
     }
 
+    metrics_register(&s_mqtt_published.desc);
+    metrics_register(&s_mqtt_received.desc);
+    metrics_register(&s_mqtt_connections.desc);
+    metrics_register(&s_mqtt_errors.desc);
+
     // Update status
     s_mqtt_ctx.state = MQTT_STATE_UNINITIALIZED;  // Initialized but not connected yet
     s_mqtt_ctx.initialized = true;
@@ -243,10 +280,6 @@ esp_err_t mqtt_client_init(void)
             sizeof(s_mqtt_ctx.status.broker_uri) - 1);
     s_mqtt_ctx.status.broker_port = s_mqtt_ctx.config.broker_port;
 
-    // Post initialization event
-    esp_event_post(MQTT_CLIENT_EVENTS, MQTT_CLIENT_EVENT_INITIALIZED,
-                   NULL, 0, portMAX_DELAY);
-
     ESP_LOGI(TAG, "MQTT client component initialized successfully");
     return ESP_OK;
 }
@@ -268,8 +301,6 @@ esp_err_t mqtt_client_start(void)
     ESP_LOGI(TAG, "Starting MQTT client...");
 
     s_mqtt_ctx.state = MQTT_STATE_CONNECTING;
-    esp_event_post(MQTT_CLIENT_EVENTS, MQTT_CLIENT_EVENT_CONNECTING,
-                   NULL, 0, portMAX_DELAY);
 
     esp_err_t ret = esp_mqtt_client_start(s_mqtt_ctx.client);
     if (ret != ESP_OK) {
@@ -328,9 +359,7 @@ esp_err_t mqtt_client_deinit(void)
         s_mqtt_ctx.client = NULL;
     }
 
-    // Unregister event handlers
-    esp_event_handler_unregister(WIFI_MANAGER_EVENTS, ESP_EVENT_ANY_ID,
-                                  &mqtt_wifi_event_handler);
+    // Bus subscription stays; the handler ignores events while uninitialized
 
     // Reset state
     memset(&s_mqtt_ctx, 0, sizeof(mqtt_client_context_t));
@@ -380,8 +409,6 @@ static void mqtt_reconnect_timer_callback(void* arg)
         s_mqtt_ctx.state == MQTT_STATE_ERROR) {
 
         s_mqtt_ctx.state = MQTT_STATE_CONNECTING;
-        esp_event_post(MQTT_CLIENT_EVENTS, MQTT_CLIENT_EVENT_CONNECTING,
-                       NULL, 0, portMAX_DELAY);
 
         esp_err_t ret = esp_mqtt_client_start(s_mqtt_ctx.client);
         if (ret != ESP_OK) {
@@ -389,10 +416,8 @@ static void mqtt_reconnect_timer_callback(void* arg)
                      esp_err_to_name(ret));
 
             // Increase retry delay with exponential backoff
-            s_mqtt_ctx.current_retry_delay_ms *= 2;
-            if (s_mqtt_ctx.current_retry_delay_ms > MQTT_RECONNECT_MAX_DELAY_MS) {
-                s_mqtt_ctx.current_retry_delay_ms = MQTT_RECONNECT_MAX_DELAY_MS;
-            }
+            s_mqtt_ctx.current_retry_delay_ms =
+                mqtt_protocol_next_retry_delay(s_mqtt_ctx.current_retry_delay_ms);
 
             ESP_LOGW(TAG, "Next reconnection attempt in %lu ms",
                      s_mqtt_ctx.current_retry_delay_ms);
@@ -447,16 +472,15 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
             s_mqtt_ctx.state = MQTT_STATE_CONNECTED;
             s_mqtt_ctx.status.connected = true;
             s_mqtt_ctx.current_retry_delay_ms = MQTT_RECONNECT_INITIAL_DELAY_MS;
-            s_mqtt_ctx.status.reconnect_count++;
+            metrics_counter_inc(&s_mqtt_connections);
 
             // Stop reconnection timer
             if (s_mqtt_ctx.reconnect_timer != NULL) {
                 esp_timer_stop(s_mqtt_ctx.reconnect_timer);
             }
 
-            // Post connected event
-            esp_event_post(MQTT_CLIENT_EVENTS, MQTT_CLIENT_EVENT_CONNECTED,
-                           NULL, 0, portMAX_DELAY);
+            // Notify bus subscribers
+            event_bus_post(EVENT_BUS_MQTT_CONNECTED, NULL);
 
             // Publish device registration
             esp_err_t ret = mqtt_client_publish_registration();
@@ -478,9 +502,8 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
             s_mqtt_ctx.status.connected = false;
             s_mqtt_ctx.status.device_registered = false;
 
-            // Post disconnected event
-            esp_event_post(MQTT_CLIENT_EVENTS, MQTT_CLIENT_EVENT_DISCONNECTED,
-                           NULL, 0, portMAX_DELAY);
+            // Notify bus subscribers
+            event_bus_post(EVENT_BUS_MQTT_DISCONNECTED, NULL);
 
             // Start reconnection timer with exponential backoff
             mqtt_start_reconnect_timer(s_mqtt_ctx.current_retry_delay_ms);
@@ -489,35 +512,25 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
         case MQTT_EVENT_PUBLISHED:
             ESP_LOGD(TAG, "MQTT_EVENT_PUBLISHED, msg_id=%d", event->msg_id);
 
-            s_mqtt_ctx.status.message_count++;
+            metrics_counter_inc(&s_mqtt_published);
             s_mqtt_ctx.status.last_publish_time = xTaskGetTickCount() * portTICK_PERIOD_MS;
-
-            // Post published event
-            esp_event_post(MQTT_CLIENT_EVENTS, MQTT_CLIENT_EVENT_PUBLISHED,
-                           &event->msg_id, sizeof(int), portMAX_DELAY);
             break;
 
         case MQTT_EVENT_DATA:
             ESP_LOGD(TAG, "MQTT_EVENT_DATA");
             ESP_LOGD(TAG, "  Topic: %.*s", event->topic_len, event->topic);
             ESP_LOGD(TAG, "  Data length: %d", event->data_len);
+            metrics_counter_inc(&s_mqtt_received);
 
             // Handle irrigation commands
             mqtt_handle_irrigation_command(event);
-
-            // Post data received event
-            esp_event_post(MQTT_CLIENT_EVENTS, MQTT_CLIENT_EVENT_DATA_RECEIVED,
-                           NULL, 0, portMAX_DELAY);
             break;
 
         case MQTT_EVENT_ERROR:
             ESP_LOGE(TAG, "MQTT_EVENT_ERROR");
 
             s_mqtt_ctx.state = MQTT_STATE_ERROR;
-
-            // Post error event
-            esp_event_post(MQTT_CLIENT_EVENTS, MQTT_CLIENT_EVENT_ERROR,
-                           NULL, 0, portMAX_DELAY);
+            metrics_counter_inc(&s_mqtt_errors);
 
             // Start reconnection timer on error
             mqtt_start_reconnect_timer(s_mqtt_ctx.current_retry_delay_ms);
@@ -527,10 +540,6 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
             ESP_LOGI(TAG, "MQTT_EVENT_SUBSCRIBED, msg_id=%d", event->msg_id);
 
             s_mqtt_ctx.state = MQTT_STATE_SUBSCRIBED;
-
-            // Post subscribed event
-            esp_event_post(MQTT_CLIENT_EVENTS, MQTT_CLIENT_EVENT_SUBSCRIBED,
-                           &event->msg_id, sizeof(int), portMAX_DELAY);
             break;
 
         default:
@@ -540,34 +549,31 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
 }
 
 /**
- * @brief WiFi event handler for MQTT component
+ * @brief WiFi event handler for MQTT component (event bus subscriber)
  *
  * Auto-starts MQTT client when WiFi IP is obtained.
- * Consolidated from mqtt_adapter.c:mqtt_adapter_wifi_event_handler()
+ * Runs on the component's own bus dispatch task.
  */
-static void mqtt_wifi_event_handler(void* arg, esp_event_base_t event_base,
-                                    int32_t event_id, void* event_data)
+static void mqtt_wifi_event_handler(const event_bus_event_t *event, void *user_ctx)
 {
-    if (event_base == WIFI_MANAGER_EVENTS) {
-        switch (event_id) {
-            case WIFI_MANAGER_EVENT_IP_OBTAINED:
-                ESP_LOGI(TAG, "WiFi IP obtained - starting MQTT client");
-
-                if (s_mqtt_ctx.initialized && s_mqtt_ctx.state != MQTT_STATE_CONNECTED) {
-                    esp_err_t ret = mqtt_client_start();
-                    if (ret != ESP_OK) {
-                        ESP_LOGE(TAG, "Failed to start MQTT client after WiFi IP obtained");
-                    }
+    switch (event->id) {
+        case EVENT_BUS_WIFI_IP_OBTAINED:
+            ESP_LOGI(TAG, "WiFi IP obtained - starting MQTT client");
+
+            if (s_mqtt_ctx.initialized && s_mqtt_ctx.state != MQTT_STATE_CONNECTED) {
+                esp_err_t ret = mqtt_client_start();
+                if (ret != ESP_OK) {
+                    ESP_LOGE(TAG, "Failed to start MQTT client after WiFi IP obtained");
                 }
-                break;
+            }
+            break;
 
-            case WIFI_MANAGER_EVENT_DISCONNECTED:
-                ESP_LOGW(TAG, "WiFi disconnected - MQTT will attempt reconnection when WiFi recovers");
-                break;
+        case EVENT_BUS_WIFI_DISCONNECTED:
+            ESP_LOGW(TAG, "WiFi disconnected - MQTT will attempt reconnection when WiFi recovers");
+            break;
 
-            default:
-                break;
-        }
+        default:
+            break;
     }
 }
 
@@ -594,8 +600,7 @@ static esp_err_t mqtt_build_device_json(cJSON** json_out)
     }
 
     char mac_str[18];
-    snprintf(mac_str, sizeof(mac_str), "%02X:%02X:%02X:%02X:%02X:%02X",
-             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    mqtt_protocol_mac_string(mac, mac_str, sizeof(mac_str));
 
     // Get IP address from WiFi manager
     char ip_str[16] = "0.0.0.0";
@@ -609,67 +614,12 @@ static esp_err_t mqtt_build_device_json(cJSON** json_out)
     // device_config_get_device_name(device_name, sizeof(device_name));
     // device_config_get_crop_name(crop_name, sizeof(crop_name));
 
-    // Create JSON object
-    cJSON *json = cJSON_CreateObject();
+    cJSON *json = mqtt_protocol_registration_json(mac_str, ip_str, device_name, crop_name);
     if (json == NULL) {
         ESP_LOGE(TAG, "Failed to create JSON object");
         return ESP_ERR_NO_MEM;
     }
 
-    cJSON_AddStringToObject(json, "event_type", "device_registration");
-    cJSON_AddStringToObject(json, "mac_address", mac_str);
-    cJSON_AddStringToObject(json, "ip_address", ip_str);
-    cJSON_AddStringToObject(json, "device_name", device_name);
-    cJSON_AddStringToObject(json, "crop_name", crop_name);
-    cJSON_AddStringToObject(json, "firmware_version", FIRMWARE_VERSION);
-
-    *json_out = json;
-    return ESP_OK;
-}
-
-/**
- * @brief Build sensor data JSON
- *
- * Consolidated from json_device_serializer.c:serialize_complete_sensor_data()
- * Creates JSON: {event_type, mac_address, ip_address, ambient_*, soil_humidity_*}
- */
-static esp_err_t mqtt_build_sensor_data_json(const sensor_reading_t* reading,
-                                             cJSON** json_out)
-{
-    if (reading == NULL || json_out == NULL) {
-        return ESP_ERR_INVALID_ARG;
-    }
-
-    // Get MAC address
-    uint8_t mac[6];
-    esp_err_t ret = esp_read_mac(mac, ESP_MAC_WIFI_STA);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to read MAC address: %s", esp_err_to_name(ret));
-        return ret;
-    }
-
-    char mac_str[18];
-    snprintf(mac_str, sizeof(mac_str), "%02X:%02X:%02X:%02X:%02X:%02X",
-             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
-
-    // Get IP address (use from reading structure)
-
-    // Create JSON object
-    cJSON *json = cJSON_CreateObject();
-    if (json == NULL) {
-        ESP_LOGE(TAG, "Failed to create JSON object");
-        return ESP_ERR_NO_MEM;
-    }
-
-    cJSON_AddStringToObject(json, "event_type", "sensor_data");
-    cJSON_AddStringToObject(json, "mac_address", mac_str);
-    cJSON_AddStringToObject(json, "ip_address", reading->device_ip);
-    cJSON_AddNumberToObject(json, "ambient_temperature", reading->ambient.temperature);
-    cJSON_AddNumberToObject(json, "ambient_humidity", reading->ambient.humidity);
-    cJSON_AddNumberToObject(json, "soil_humidity_1", reading->soil.soil_humidity[0]);
-    cJSON_AddNumberToObject(json, "soil_humidity_2", reading->soil.soil_humidity[1]);
-    cJSON_AddNumberToObject(json, "soil_humidity_3", reading->soil.soil_humidity[2]);
-
     *json_out = json;
     return ESP_OK;
 }
@@ -753,21 +703,14 @@ esp_err_t mqtt_client_publish_sensor_data(const sensor_reading_t* reading)
 
     ESP_LOGD(TAG, "Publishing sensor data...");
 
-    // Build JSON
-    cJSON *json = NULL;
-    esp_err_t ret = mqtt_build_sensor_data_json(reading, &json);
+    // Encoded once per sample and shared with HTTP and push subscribers
+    const payload_buffer_t *payload = NULL;
+    esp_err_t ret = payload_cache_acquire(reading, PAYLOAD_FORMAT_JSON, &payload);
     if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to encode sensor data: %s", esp_err_to_name(ret));
         return ret;
     }
 
-    // Serialize to string
-    char *json_string = cJSON_Print(json);
-    if (json_string == NULL) {
-        ESP_LOGE(TAG, "Failed to serialize JSON");
-        cJSON_Delete(json);
-        return ESP_ERR_NO_MEM;
-    }
-
     // Build dynamic topic: irrigation/data/{crop_name}/{mac_address}
     char topic[MQTT_MAX_TOPIC_LENGTH];
     char crop_name[16] = "Unknown";
@@ -779,8 +722,8 @@ esp_err_t mqtt_client_publish_sensor_data(const sensor_reading_t* reading)
     // Publish to topic
     int msg_id = esp_mqtt_client_publish(s_mqtt_ctx.client,
                                          topic,
-                                         json_string,
-                                         0,  // Let ESP-MQTT calculate length
+                                         (const char*)payload->data,
+                                         (int)payload->len,
                                          MQTT_DEFAULT_QOS,
                                          0); // Don't retain
 
@@ -791,22 +734,78 @@ esp_err_t mqtt_client_publish_sensor_data(const sensor_reading_t* reading)
         ESP_LOGD(TAG, "Sensor data published successfully");
         ESP_LOGD(TAG, "  Topic: %s", topic);
         ESP_LOGD(TAG, "  Message ID: %d", msg_id);
-        ESP_LOGV(TAG, "  Payload: %s", json_string);
+        ESP_LOGV(TAG, "  Payload: %s", (const char*)payload->data);
         ret = ESP_OK;
     }
 
-    // Cleanup
-    free(json_string);
-    cJSON_Delete(json);
+    payload_cache_release(payload);
 
     return ret;
 }
 
 esp_err_t mqtt_client_publish_irrigation_status(const irrigation_status_t* status)
 {
-    // TODO: Implement when irrigation_controller component is migrated (Phase 2)
-    ESP_LOGW(TAG, "mqtt_client_publish_irrigation_status() not yet implemented (Phase 2)");
-    return ESP_ERR_NOT_SUPPORTED;
+    if (!s_mqtt_ctx.initialized) {
+        ESP_LOGE(TAG, "MQTT client not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (status == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (s_mqtt_ctx.state != MQTT_STATE_CONNECTED) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Build topic: irrigation/status/{mac_address}
+    uint8_t mac[6];
+    esp_err_t ret = esp_read_mac(mac, ESP_MAC_WIFI_STA);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to read MAC address: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    char mac_str[18];
+    mqtt_protocol_mac_string(mac, mac_str, sizeof(mac_str));
+
+    char topic[MQTT_MAX_TOPIC_LENGTH];
+    MQTT_BUILD_STATUS_TOPIC(topic, mac_str);
+
+    cJSON *json = mqtt_protocol_irrigation_status_json(status, mac_str,
+                                                       time_sync_get_monotonic_ms());
+    if (json == NULL) {
+        ESP_LOGE(TAG, "Failed to create JSON object");
+        return ESP_ERR_NO_MEM;
+    }
+
+    char *json_string = cJSON_Print(json);
+    if (json_string == NULL) {
+        ESP_LOGE(TAG, "Failed to serialize JSON");
+        cJSON_Delete(json);
+        return ESP_ERR_NO_MEM;
+    }
+
+    int msg_id = esp_mqtt_client_publish(s_mqtt_ctx.client,
+                                         topic,
+                                         json_string,
+                                         0,  // Let ESP-MQTT calculate length
+                                         MQTT_DEFAULT_QOS,
+                                         0); // Don't retain
+
+    if (msg_id == -1) {
+        ESP_LOGE(TAG, "Failed to publish irrigation status message");
+        ret = ESP_FAIL;
+    } else {
+        ESP_LOGD(TAG, "Irrigation status published (msg_id=%d)", msg_id);
+        ESP_LOGV(TAG, "  Payload: %s", json_string);
+        ret = ESP_OK;
+    }
+
+    free(json_string);
+    cJSON_Delete(json);
+
+    return ret;
 }
 
 /* ========================== SUBSCRIPTION ========================== */
@@ -832,8 +831,7 @@ esp_err_t mqtt_client_subscribe_irrigation_commands(void)
     }
 
     char mac_str[18];
-    snprintf(mac_str, sizeof(mac_str), "%02X:%02X:%02X:%02X:%02X:%02X",
-             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    mqtt_protocol_mac_string(mac, mac_str, sizeof(mac_str));
 
     char topic[MQTT_MAX_TOPIC_LENGTH];
     MQTT_BUILD_CONTROL_TOPIC(topic, mac_str);
@@ -871,11 +869,140 @@ esp_err_t mqtt_client_register_command_callback(mqtt_irrigation_command_cb_t cal
     return ESP_OK;
 }
 
+/**
+ * @brief Handle firmware update command received via MQTT
+ *
+ * Parses JSON payload: {"command": "ota_update", "url": "...", "delta": true,
+ *                       "sha256": "...", "base_sha256": "..."}
+ */
+static void mqtt_handle_ota_command(const cJSON* json)
+{
+    ota_manager_request_t request = {0};
+
+    const char *url = cJSON_GetStringValue(cJSON_GetObjectItem(json, "url"));
+    if (url == NULL) {
+        ESP_LOGE(TAG, "ota_update without url");
+        return;
+    }
+    strncpy(request.url, url, sizeof(request.url) - 1);
+
+    const char *sha256 = cJSON_GetStringValue(cJSON_GetObjectItem(json, "sha256"));
+    if (sha256 != NULL) {
+        strncpy(request.sha256, sha256, sizeof(request.sha256) - 1);
+    }
+
+    const char *base_sha256 = cJSON_GetStringValue(cJSON_GetObjectItem(json, "base_sha256"));
+    if (base_sha256 != NULL) {
+        strncpy(request.base_sha256, base_sha256, sizeof(request.base_sha256) - 1);
+    }
+
+    request.delta = cJSON_IsTrue(cJSON_GetObjectItem(json, "delta"));
+
+    esp_err_t ret = ota_manager_start(&request);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start OTA update: %s", esp_err_to_name(ret));
+    } else {
+        ESP_LOGI(TAG, "OTA update started (%s)", request.delta ? "delta" : "full image");
+    }
+}
+
+/**
+ * @brief Unsigned number field of a command, @p default_value if absent
+ */
+static uint32_t mqtt_command_u32(const cJSON* json, const char* key, uint32_t default_value)
+{
+    const cJSON *item = cJSON_GetObjectItem(json, key);
+    if (!cJSON_IsNumber(item) || cJSON_GetNumberValue(item) < 0) {
+        return default_value;
+    }
+    return (uint32_t)cJSON_GetNumberValue(item);
+}
+
+/**
+ * @brief Handle decision log query received via MQTT
+ *
+ * Parses JSON payload: {"command": "query_log", "from": 1760000000,
+ *                       "to": 1760086400, "after": 0, "limit": 32}
+ * and publishes one page to irrigation/events/{mac}. Repeat with
+ * "after" = next_after of the reply to read the next page.
+ */
+static void mqtt_handle_query_log_command(const cJSON* json)
+{
+    decision_log_filter_t filter = {
+        .from = mqtt_command_u32(json, "from", 0),
+        .to = mqtt_command_u32(json, "to", 0),
+        .after_seq = mqtt_command_u32(json, "after", 0),
+    };
+    uint32_t limit = mqtt_command_u32(json, "limit", DECISION_LOG_QUERY_MAX);
+    if (limit == 0 || limit > DECISION_LOG_QUERY_MAX) {
+        limit = DECISION_LOG_QUERY_MAX;
+    }
+
+    decision_log_record_t *records = malloc(limit * sizeof(decision_log_record_t));
+    if (records == NULL) {
+        ESP_LOGE(TAG, "query_log: out of memory");
+        return;
+    }
+
+    size_t count = 0;
+    esp_err_t ret = decision_log_query(&filter, records, limit, &count);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "query_log: decision log not available (%s)", esp_err_to_name(ret));
+        free(records);
+        return;
+    }
+
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL) {
+        free(records);
+        return;
+    }
+
+    cJSON_AddNumberToObject(root, "from", filter.from);
+    cJSON_AddNumberToObject(root, "to", filter.to);
+    cJSON_AddNumberToObject(root, "count", count);
+    cJSON_AddNumberToObject(root, "next_after", (count > 0) ? records[count - 1].seq : filter.after_seq);
+    cJSON_AddBoolToObject(root, "more", count == limit);
+    cJSON_AddNumberToObject(root, "dropped", decision_log_get_dropped());
+
+    cJSON *events = cJSON_AddArrayToObject(root, "events");
+    for (size_t i = 0; i < count && events != NULL; i++) {
+        cJSON_AddItemToArray(events, decision_log_record_to_json(&records[i]));
+    }
+    free(records);
+
+    char *json_string = cJSON_Print(root);
+    cJSON_Delete(root);
+    if (json_string == NULL) {
+        ESP_LOGE(TAG, "Failed to serialize JSON");
+        return;
+    }
+
+    uint8_t mac[6];
+    esp_read_mac(mac, ESP_MAC_WIFI_STA);
+    char mac_str[18];
+    mqtt_protocol_mac_string(mac, mac_str, sizeof(mac_str));
+
+    char topic[MQTT_MAX_TOPIC_LENGTH];
+    MQTT_BUILD_EVENTS_TOPIC(topic, mac_str);
+
+    int msg_id = esp_mqtt_client_publish(s_mqtt_ctx.client, topic, json_string, 0,
+                                         MQTT_DEFAULT_QOS, 0);
+    if (msg_id == -1) {
+        ESP_LOGE(TAG, "Failed to publish decision log page");
+    } else {
+        ESP_LOGI(TAG, "query_log: %u records published to %s", (unsigned)count, topic);
+    }
+    free(json_string);
+}
+
 /**
  * @brief Handle irrigation command received via MQTT
  *
  * Parses JSON payload: {"command": "start|stop|emergency_stop", "duration_minutes": 15}
  * Calls registered callback if command is valid.
+ * "ota_update" commands on the same topic go to mqtt_handle_ota_command(),
+ * "query_log" to mqtt_handle_query_log_command().
  */
 static void mqtt_handle_irrigation_command(esp_mqtt_event_t* event)
 {
@@ -887,12 +1014,6 @@ static void mqtt_handle_irrigation_command(esp_mqtt_event_t* event)
 
     ESP_LOGI(TAG, "Received irrigation command");
 
-    // Check if callback is registered
-    if (s_mqtt_ctx.cmd_callback == NULL) {
-        ESP_LOGW(TAG, "No irrigation command callback registered, ignoring command");
-        return;
-    }
-
     // Parse JSON payload
     cJSON *json = cJSON_ParseWithLength(event->data, event->data_len);
     if (json == NULL) {
@@ -909,6 +1030,26 @@ static void mqtt_handle_irrigation_command(esp_mqtt_event_t* event)
     }
 
     const char *cmd_str = cJSON_GetStringValue(cmd_item);
+
+    if (strcmp(cmd_str, "ota_update") == 0) {
+        mqtt_handle_ota_command(json);
+        cJSON_Delete(json);
+        return;
+    }
+
+    if (strcmp(cmd_str, "query_log") == 0) {
+        mqtt_handle_query_log_command(json);
+        cJSON_Delete(json);
+        return;
+    }
+
+    // Check if callback is registered
+    if (s_mqtt_ctx.cmd_callback == NULL) {
+        ESP_LOGW(TAG, "No irrigation command callback registered, ignoring command");
+        cJSON_Delete(json);
+        return;
+    }
+
     irrigation_command_t command;
 
     if (strcmp(cmd_str, "start") == 0) {
@@ -917,6 +1058,8 @@ static void mqtt_handle_irrigation_command(esp_mqtt_event_t* event)
         command = IRRIGATION_CMD_STOP;
     } else if (strcmp(cmd_str, "emergency_stop") == 0) {
         command = IRRIGATION_CMD_EMERGENCY_STOP;
+    } else if (strcmp(cmd_str, "start_pulse") == 0) {
+        command = IRRIGATION_CMD_START_PULSE;
     } else {
         ESP_LOGE(TAG, "Unknown irrigation command: %s", cmd_str);
         cJSON_Delete(json);
@@ -948,6 +1091,8 @@ esp_err_t mqtt_client_get_status(mqtt_status_t* status)
     }
 
     memcpy(status, &s_mqtt_ctx.status, sizeof(mqtt_status_t));
+    status->message_count = metrics_counter_get(&s_mqtt_published);
+    status->reconnect_count = metrics_counter_get(&s_mqtt_connections);
     status->state = s_mqtt_ctx.state;
     status->connected = (s_mqtt_ctx.state == MQTT_STATE_CONNECTED);
 
@@ -25,6 +25,7 @@
 #include "esp_err.h"
 #include "esp_event.h"
 #include "common_types.h"
+#include "mqtt_protocol.h"
 #include <stdbool.h>
 #include "sdkconfig.h"
 
@@ -142,7 +143,10 @@ esp_err_t mqtt_client_publish_registration(void);
  *
  * Publishes sensor reading to "irrigation/data/{crop_name}/{mac_address}" topic.
  * JSON format: {event_type, mac_address, ip_address, ambient_temperature,
- *               ambient_humidity, soil_humidity_1, soil_humidity_2, soil_humidity_3}
+ *               ambient_humidity, soil_sensor_count, soil_humidity_1..N,
+ *               timestamp, time_quality, uptime_ms}, one soil_humidity_N per
+ *               active channel (N = soil_sensor_count, up to 16; a channel
+ *               whose valid_mask bit is clear reads 0)
  *
  * @param reading Sensor reading data
  * @return ESP_OK if published successfully, error code otherwise
@@ -153,7 +157,10 @@ esp_err_t mqtt_client_publish_sensor_data(const sensor_reading_t* reading);
  * @brief Publish irrigation status
  *
  * Publishes current irrigation status to "irrigation/status/{mac_address}" topic.
- * JSON format: {state, mode, session_duration, valve_number, last_soil_avg}
+ * JSON format: {event_type, mac_address, state, mode, session_duration,
+ *               valve_number, safety_lock, last_soil_avg,
+ *               stats: {today_runtime, total_sessions, total_runtime,
+ *                       emergency_stops, thermal_stops}, uptime_ms}
  *
  * @param status Irrigation status data
  * @return ESP_OK if published successfully, error code otherwise
@@ -208,55 +215,17 @@ esp_err_t mqtt_client_reconnect(void);
 
 /* ============================ EVENT DEFINITIONS ============================ */
 
-/**
- * @brief MQTT client event base
- */
-ESP_EVENT_DECLARE_BASE(MQTT_CLIENT_EVENTS);
-
-/**
- * @brief MQTT client event IDs
+/*
+ * Broker connect/disconnect notifications are delivered on the event bus as
+ * EVENT_BUS_MQTT_CONNECTED / EVENT_BUS_MQTT_DISCONNECTED (see event_bus.h).
  */
-typedef enum {
-    MQTT_CLIENT_EVENT_INITIALIZED,      ///< Component initialized
-    MQTT_CLIENT_EVENT_CONNECTING,       ///< Connecting to broker
-    MQTT_CLIENT_EVENT_CONNECTED,        ///< Connected to broker
-    MQTT_CLIENT_EVENT_DISCONNECTED,     ///< Disconnected from broker
-    MQTT_CLIENT_EVENT_SUBSCRIBED,       ///< Subscribed to topics
-    MQTT_CLIENT_EVENT_PUBLISHED,        ///< Message published successfully
-    MQTT_CLIENT_EVENT_DATA_RECEIVED,    ///< Data received from subscribed topic
-    MQTT_CLIENT_EVENT_ERROR             ///< Error occurred
-} mqtt_client_event_id_t;
 
 /* ============================ MQTT TOPICS ============================ */
 
-/**
- * @brief MQTT topic definitions
- */
-#define MQTT_TOPIC_REGISTER             "irrigation/register"
-#define MQTT_TOPIC_DATA_PREFIX          "irrigation/data"
-#define MQTT_TOPIC_CONTROL_PREFIX       "irrigation/control"
-#define MQTT_TOPIC_STATUS_PREFIX        "irrigation/status"
-
-/**
- * @brief Build data topic for specific device
- * Format: irrigation/data/{crop_name}/{mac_address}
- */
-#define MQTT_BUILD_DATA_TOPIC(buf, crop, mac) \
-    snprintf(buf, sizeof(buf), "%s/%s/%s", MQTT_TOPIC_DATA_PREFIX, crop, mac)
-
-/**
- * @brief Build control topic for specific device
- * Format: irrigation/control/{mac_address}
- */
-#define MQTT_BUILD_CONTROL_TOPIC(buf, mac) \
-    snprintf(buf, sizeof(buf), "%s/%s", MQTT_TOPIC_CONTROL_PREFIX, mac)
-
-/**
- * @brief Build status topic for specific device
- * Format: irrigation/status/{mac_address}
+/*
+ * Topic layout, QoS, buffer sizes and reconnect timing live in
+ * mqtt_protocol.h (shared with tools/fleet_loadgen).
  */
-#define MQTT_BUILD_STATUS_TOPIC(buf, mac) \
-    snprintf(buf, sizeof(buf), "%s/%s", MQTT_TOPIC_STATUS_PREFIX, mac)
 
 /* ============================ CONFIGURATION ============================ */
 
@@ -273,7 +242,7 @@ typedef enum {
     .client_id = "",                      \
     .username = "",                       \
     .password = "",                       \
-    .keepalive_sec = 60,                   \
+    .keepalive_sec = MQTT_DEFAULT_KEEPALIVE_SEC, \
     .use_websockets = true,                \
     .enable_ssl = true                     \
 }
@@ -291,24 +260,6 @@ typedef enum {
 #define MQTT_CLIENT_NVS_KEY_USERNAME    "username"
 #define MQTT_CLIENT_NVS_KEY_PASSWORD    "password"
 
-/**
- * @brief MQTT QoS levels
- */
-#define MQTT_QOS_0  0   ///< At most once delivery
-#define MQTT_QOS_1  1   ///< At least once delivery (default)
-#define MQTT_QOS_2  2   ///< Exactly once delivery
-
-/**
- * @brief Default QoS for sensor data and commands
- */
-#define MQTT_DEFAULT_QOS    MQTT_QOS_1
-
-/**
- * @brief MQTT message buffer sizes
- */
-#define MQTT_MAX_TOPIC_LENGTH       128
-#define MQTT_MAX_PAYLOAD_LENGTH     512
-
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,102 @@
+/**
+ * @file mqtt_protocol.c
+ * @brief MQTT Client Component - Topics, timing and message builders
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "mqtt_protocol.h"
+
+/* ============================ PUBLIC API ============================ */
+
+void mqtt_protocol_client_id(const uint8_t mac[6], char *client_id, size_t size)
+{
+    snprintf(client_id, size, "%s_%02X%02X%02X",
+             MQTT_CLIENT_ID_PREFIX, mac[3], mac[4], mac[5]);
+}
+
+void mqtt_protocol_mac_string(const uint8_t mac[6], char *mac_str, size_t size)
+{
+    snprintf(mac_str, size, "%02X:%02X:%02X:%02X:%02X:%02X",
+             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+}
+
+uint32_t mqtt_protocol_next_retry_delay(uint32_t current_ms)
+{
+    if (current_ms >= MQTT_RECONNECT_MAX_DELAY_MS / 2) {
+        return MQTT_RECONNECT_MAX_DELAY_MS;
+    }
+    return current_ms * 2;
+}
+
+cJSON* mqtt_protocol_registration_json(const char *mac_str, const char *ip_str,
+                                       const char *device_name, const char *crop_name)
+{
+    cJSON *json = cJSON_CreateObject();
+    if (json == NULL) {
+        return NULL;
+    }
+
+    cJSON_AddStringToObject(json, "event_type", "device_registration");
+    cJSON_AddStringToObject(json, "mac_address", mac_str);
+    cJSON_AddStringToObject(json, "ip_address", ip_str);
+    cJSON_AddStringToObject(json, "device_name", device_name);
+    cJSON_AddStringToObject(json, "crop_name", crop_name);
+    cJSON_AddStringToObject(json, "firmware_version", MQTT_FIRMWARE_VERSION);
+
+    return json;
+}
+
+const char* mqtt_protocol_irrigation_state_name(irrigation_state_t state)
+{
+    switch (state) {
+        case IRRIGATION_IDLE:               return "idle";
+        case IRRIGATION_ACTIVE:             return "active";
+        case IRRIGATION_PAUSED:             return "paused";
+        case IRRIGATION_ERROR:              return "error";
+        case IRRIGATION_EMERGENCY_STOP:     return "emergency_stop";
+        case IRRIGATION_THERMAL_PROTECTION: return "thermal_protection";
+        default:                            return "unknown";
+    }
+}
+
+cJSON* mqtt_protocol_irrigation_status_json(const irrigation_status_t *status,
+                                            const char *mac_str, int64_t uptime_ms)
+{
+    static const char *mode_names[] = {
+        "online", "offline_normal", "offline_warning", "offline_critical", "offline_emergency"
+    };
+
+    cJSON *json = cJSON_CreateObject();
+    if (json == NULL) {
+        return NULL;
+    }
+
+    cJSON_AddStringToObject(json, "event_type", "irrigation_status");
+    cJSON_AddStringToObject(json, "mac_address", mac_str);
+    cJSON_AddStringToObject(json, "state", mqtt_protocol_irrigation_state_name(status->state));
+    cJSON_AddStringToObject(json, "mode",
+                            (status->mode <= IRRIGATION_MODE_OFFLINE_EMERGENCY)
+                                ? mode_names[status->mode] : "unknown");
+    cJSON_AddNumberToObject(json, "session_duration", status->session_duration_sec);
+    cJSON_AddNumberToObject(json, "valve_number", status->valve_number);
+    cJSON_AddBoolToObject(json, "safety_lock", status->safety_lock);
+    cJSON_AddNumberToObject(json, "last_soil_avg", status->last_soil_avg);
+
+    cJSON *stats = cJSON_AddObjectToObject(json, "stats");
+    if (stats == NULL) {
+        cJSON_Delete(json);
+        return NULL;
+    }
+    cJSON_AddNumberToObject(stats, "today_runtime", status->total_runtime_today);
+    cJSON_AddNumberToObject(stats, "total_sessions", status->total_sessions);
+    cJSON_AddNumberToObject(stats, "total_runtime", status->total_runtime_sec);
+    cJSON_AddNumberToObject(stats, "emergency_stops", status->emergency_stops);
+    cJSON_AddNumberToObject(stats, "thermal_stops", status->thermal_stops);
+
+    cJSON_AddNumberToObject(json, "uptime_ms", (double)uptime_ms);
+
+    return json;
+}
@@ -0,0 +1,150 @@
+/**
+ * @file mqtt_protocol.h
+ * @brief MQTT Client Component - Topics, timing and message builders
+ *
+ * Everything the device puts on the wire besides the sensor_data payload
+ * (see payload_codec.h): topic layout, QoS, keepalive, client id,
+ * reconnect backoff and the registration and irrigation status messages.
+ *
+ * Pure C with no ESP-IDF dependencies (cJSON only), so the fleet load
+ * generator in tools/fleet_loadgen reproduces the firmware's traffic from
+ * the same code.
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef MQTT_PROTOCOL_H
+#define MQTT_PROTOCOL_H
+
+#include "common_types.h"
+#include "cJSON.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================ MQTT TOPICS ============================ */
+
+/**
+ * @brief MQTT topic definitions
+ */
+#define MQTT_TOPIC_REGISTER             "irrigation/register"
+#define MQTT_TOPIC_DATA_PREFIX          "irrigation/data"
+#define MQTT_TOPIC_CONTROL_PREFIX       "irrigation/control"
+#define MQTT_TOPIC_STATUS_PREFIX        "irrigation/status"
+#define MQTT_TOPIC_EVENTS_PREFIX        "irrigation/events"
+
+/**
+ * @brief Build data topic for specific device
+ * Format: irrigation/data/{crop_name}/{mac_address}
+ */
+#define MQTT_BUILD_DATA_TOPIC(buf, crop, mac) \
+    snprintf(buf, sizeof(buf), "%s/%s/%s", MQTT_TOPIC_DATA_PREFIX, crop, mac)
+
+/**
+ * @brief Build control topic for specific device
+ * Format: irrigation/control/{mac_address}
+ */
+#define MQTT_BUILD_CONTROL_TOPIC(buf, mac) \
+    snprintf(buf, sizeof(buf), "%s/%s", MQTT_TOPIC_CONTROL_PREFIX, mac)
+
+/**
+ * @brief Build status topic for specific device
+ * Format: irrigation/status/{mac_address}
+ */
+#define MQTT_BUILD_STATUS_TOPIC(buf, mac) \
+    snprintf(buf, sizeof(buf), "%s/%s", MQTT_TOPIC_STATUS_PREFIX, mac)
+
+/**
+ * @brief Build decision log topic for specific device (query_log replies)
+ * Format: irrigation/events/{mac_address}
+ */
+#define MQTT_BUILD_EVENTS_TOPIC(buf, mac) \
+    snprintf(buf, sizeof(buf), "%s/%s", MQTT_TOPIC_EVENTS_PREFIX, mac)
+
+/* ============================ SESSION ============================ */
+
+/**
+ * @brief MQTT QoS levels
+ */
+#define MQTT_QOS_0  0   ///< At most once delivery
+#define MQTT_QOS_1  1   ///< At least once delivery (default)
+#define MQTT_QOS_2  2   ///< Exactly once delivery
+
+/**
+ * @brief Default QoS for sensor data and commands
+ */
+#define MQTT_DEFAULT_QOS    MQTT_QOS_1
+
+/**
+ * @brief MQTT message buffer sizes
+ */
+#define MQTT_MAX_TOPIC_LENGTH       128
+#define MQTT_MAX_PAYLOAD_LENGTH     512
+
+#define MQTT_DEFAULT_KEEPALIVE_SEC      60
+#define MQTT_CLIENT_ID_PREFIX           "ESP32"
+#define MQTT_CLIENT_ID_LENGTH           16      ///< "ESP32_XXXXXX" plus NUL, rounded up
+
+// Reconnection configuration (exponential backoff)
+#define MQTT_RECONNECT_INITIAL_DELAY_MS 10000   // 10 seconds
+#define MQTT_RECONNECT_MAX_DELAY_MS     3600000 // 1 hour
+
+// Firmware version reported in device_registration
+#define MQTT_FIRMWARE_VERSION           "v1.2.0"
+
+/* ============================ PUBLIC API ============================ */
+
+/**
+ * @brief Client id from the WiFi STA MAC: "ESP32_" + last three bytes in hex
+ */
+void mqtt_protocol_client_id(const uint8_t mac[6], char *client_id, size_t size);
+
+/**
+ * @brief "AA:BB:CC:DD:EE:FF" form of a MAC (size >= 18)
+ */
+void mqtt_protocol_mac_string(const uint8_t mac[6], char *mac_str, size_t size);
+
+/**
+ * @brief Reconnect delay that follows a failed attempt after @p current_ms
+ *
+ * Doubles the delay, capped at MQTT_RECONNECT_MAX_DELAY_MS.
+ */
+uint32_t mqtt_protocol_next_retry_delay(uint32_t current_ms);
+
+/**
+ * @brief Build device registration JSON
+ *
+ * Creates JSON: {event_type, mac_address, ip_address, device_name, crop_name, firmware_version}
+ *
+ * @return New object owned by the caller, NULL on allocation failure
+ */
+cJSON* mqtt_protocol_registration_json(const char *mac_str, const char *ip_str,
+                                       const char *device_name, const char *crop_name);
+
+/**
+ * @brief Irrigation state name for the status payload
+ */
+const char* mqtt_protocol_irrigation_state_name(irrigation_state_t state);
+
+/**
+ * @brief Build irrigation status JSON
+ *
+ * Creates JSON: {event_type, mac_address, state, mode, session_duration,
+ *                valve_number, safety_lock, last_soil_avg, stats, uptime_ms}
+ *
+ * @return New object owned by the caller, NULL on allocation failure
+ */
+cJSON* mqtt_protocol_irrigation_status_json(const irrigation_status_t *status,
+                                            const char *mac_str, int64_t uptime_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MQTT_PROTOCOL_H
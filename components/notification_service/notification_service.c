@@ -15,6 +15,7 @@
 
 #include "notification_service.h"
 #include "wifi_manager.h"
+#include "metrics.h"
 #include "esp_http_client.h"
 #include "cJSON.h"
 #include "esp_log.h"
@@ -31,8 +32,6 @@
  */
 typedef struct {
     bool is_initialized;
-    uint32_t send_count;
-    uint32_t error_count;
     bool last_send_ok;
 } notification_service_context_t;
 
@@ -45,11 +44,17 @@ static const char *TAG = "notification_service";
  */
 static notification_service_context_t s_notif_ctx = {
     .is_initialized = false,
-    .send_count = 0,
-    .error_count = 0,
     .last_send_ok = false
 };
 
+/**
+ * @brief Webhook counters (metrics registry, exported on GET /metrics)
+ */
+static metrics_counter_t s_notif_sent = METRICS_COUNTER_INIT(
+    "notification_webhooks", "Webhook notifications by result", "result=\"sent\"");
+static metrics_counter_t s_notif_failed = METRICS_COUNTER_INIT(
+    "notification_webhooks", "Webhook notifications by result", "result=\"failed\"");
+
 /**
  * @brief Spinlock for thread-safe state access
  */
@@ -152,9 +157,9 @@ static esp_err_t _send_webhook_post(
         ESP_LOGI(TAG, "N8N webhook sent: %s (HTTP %d)", event_type, status_code);
 
         // Update stats
+        metrics_counter_inc(&s_notif_sent);
         portENTER_CRITICAL(&s_notification_spinlock);
         {
-            s_notif_ctx.send_count++;
             s_notif_ctx.last_send_ok = true;
         }
         portEXIT_CRITICAL(&s_notification_spinlock);
@@ -162,9 +167,9 @@ static esp_err_t _send_webhook_post(
         ESP_LOGE(TAG, "HTTP request failed: %s", esp_err_to_name(ret));
 
         // Update error stats
+        metrics_counter_inc(&s_notif_failed);
         portENTER_CRITICAL(&s_notification_spinlock);
         {
-            s_notif_ctx.error_count++;
             s_notif_ctx.last_send_ok = false;
         }
         portEXIT_CRITICAL(&s_notification_spinlock);
@@ -189,12 +194,15 @@ esp_err_t notification_service_init(void)
         }
 
         s_notif_ctx.is_initialized = true;
-        s_notif_ctx.send_count = 0;
-        s_notif_ctx.error_count = 0;
         s_notif_ctx.last_send_ok = false;
     }
     portEXIT_CRITICAL(&s_notification_spinlock);
 
+    metrics_counter_reset(&s_notif_sent);
+    metrics_counter_reset(&s_notif_failed);
+    metrics_register(&s_notif_sent.desc);
+    metrics_register(&s_notif_failed.desc);
+
     ESP_LOGI(TAG, "Notification service initialized");
 
     // Log configuration
@@ -288,32 +296,20 @@ bool notification_service_is_last_send_ok(void)
 
 uint32_t notification_service_get_send_count(void)
 {
-    uint32_t count;
-    portENTER_CRITICAL(&s_notification_spinlock);
-    {
-        count = s_notif_ctx.send_count;
-    }
-    portEXIT_CRITICAL(&s_notification_spinlock);
-    return count;
+    return metrics_counter_get(&s_notif_sent);
 }
 
 uint32_t notification_service_get_error_count(void)
 {
-    uint32_t count;
-    portENTER_CRITICAL(&s_notification_spinlock);
-    {
-        count = s_notif_ctx.error_count;
-    }
-    portEXIT_CRITICAL(&s_notification_spinlock);
-    return count;
+    return metrics_counter_get(&s_notif_failed);
 }
 
 esp_err_t notification_service_reset_stats(void)
 {
+    metrics_counter_reset(&s_notif_sent);
+    metrics_counter_reset(&s_notif_failed);
     portENTER_CRITICAL(&s_notification_spinlock);
     {
-        s_notif_ctx.send_count = 0;
-        s_notif_ctx.error_count = 0;
         s_notif_ctx.last_send_ok = false;
     }
     portEXIT_CRITICAL(&s_notification_spinlock);
@@ -0,0 +1,486 @@
+/**
+ * @file ota_manager.c
+ * @brief OTA Manager Component - Delta firmware updates with rollback
+ *
+ * Patch flow: HTTP chunk -> esp_delta_ota_feed_patch() -> read_cb pulls
+ * matching regions from the running slot, write_cb appends the merged
+ * stream to the inactive slot via esp_ota_write().
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "ota_manager.h"
+#include "esp_log.h"
+#include "esp_ota_ops.h"
+#include "esp_partition.h"
+#include "esp_http_client.h"
+#include "esp_crt_bundle.h"
+#include "esp_delta_ota.h"
+#include "esp_timer.h"
+#include "esp_system.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/portmacro.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+#include <ctype.h>
+#include <inttypes.h>
+
+/* ============================ CONFIGURATION ============================ */
+
+#ifndef CONFIG_OTA_MANAGER_BUFFER_SIZE
+#define CONFIG_OTA_MANAGER_BUFFER_SIZE 1024
+#endif
+
+#ifndef CONFIG_OTA_MANAGER_HTTP_TIMEOUT_MS
+#define CONFIG_OTA_MANAGER_HTTP_TIMEOUT_MS 15000
+#endif
+
+#ifndef CONFIG_OTA_MANAGER_CONFIRM_TIMEOUT_S
+#define CONFIG_OTA_MANAGER_CONFIRM_TIMEOUT_S 600
+#endif
+
+#ifndef CONFIG_OTA_MANAGER_TASK_STACK_SIZE
+#define CONFIG_OTA_MANAGER_TASK_STACK_SIZE 6144
+#endif
+
+#define OTA_MANAGER_TASK_STACK_SIZE    CONFIG_OTA_MANAGER_TASK_STACK_SIZE  // TLS handshake + delta decoder
+#define OTA_MANAGER_TASK_PRIORITY      2       // Below sensors/irrigation
+#define OTA_MANAGER_REBOOT_DELAY_MS    2000
+
+/* ============================ PRIVATE STATE ============================ */
+
+static const char *TAG = "ota_manager";
+
+typedef struct {
+    ota_manager_status_t status;
+    ota_manager_request_t request;
+    const esp_partition_t *running;
+    const esp_partition_t *update;
+    esp_ota_handle_t ota_handle;
+    esp_timer_handle_t confirm_timer;
+    bool busy;
+} ota_manager_context_t;
+
+static ota_manager_context_t s_ota_ctx = {0};
+static portMUX_TYPE s_ota_spinlock = portMUX_INITIALIZER_UNLOCKED;
+static bool s_initialized = false;
+
+/* ============================ PRIVATE FUNCTIONS ============================ */
+
+static void ota_manager_set_state(ota_manager_state_t state, esp_err_t error)
+{
+    portENTER_CRITICAL(&s_ota_spinlock);
+    s_ota_ctx.status.state = state;
+    if (error != ESP_OK) {
+        s_ota_ctx.status.last_error = error;
+    }
+    portEXIT_CRITICAL(&s_ota_spinlock);
+}
+
+/**
+ * @brief Exactly 64 hex digits
+ */
+static bool ota_manager_sha256_valid(const char *hex)
+{
+    size_t len = strnlen(hex, OTA_MANAGER_SHA256_HEX_LEN);
+    if (len != OTA_MANAGER_SHA256_HEX_LEN - 1) {
+        return false;
+    }
+    for (size_t i = 0; i < len; i++) {
+        if (!isxdigit((unsigned char)hex[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void ota_manager_sha256_to_hex(const uint8_t *sha, char *hex_out)
+{
+    for (int i = 0; i < 32; i++) {
+        sprintf(hex_out + (i * 2), "%02x", sha[i]);
+    }
+    hex_out[64] = '\0';
+}
+
+static esp_err_t ota_manager_partition_sha256_hex(const esp_partition_t *partition, char *hex_out)
+{
+    uint8_t sha[32];
+    esp_err_t ret = esp_partition_get_sha256(partition, sha);
+    if (ret == ESP_OK) {
+        ota_manager_sha256_to_hex(sha, hex_out);
+    }
+    return ret;
+}
+
+/**
+ * @brief Delta decoder callback: read base image region from running slot
+ */
+static esp_err_t ota_manager_delta_read_cb(uint8_t *buf_p, size_t size, int src_offset)
+{
+    if (size == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return esp_partition_read(s_ota_ctx.running, src_offset, buf_p, size);
+}
+
+/**
+ * @brief Delta decoder callback: append merged image data to update slot
+ */
+static esp_err_t ota_manager_delta_write_cb(const uint8_t *buf_p, size_t size)
+{
+    if (size == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = esp_ota_write(s_ota_ctx.ota_handle, buf_p, size);
+    if (ret == ESP_OK) {
+        portENTER_CRITICAL(&s_ota_spinlock);
+        s_ota_ctx.status.bytes_written += size;
+        portEXIT_CRITICAL(&s_ota_spinlock);
+    }
+    return ret;
+}
+
+static esp_err_t ota_manager_download(esp_http_client_handle_t client, esp_delta_ota_handle_t delta_handle)
+{
+    char *buffer = malloc(CONFIG_OTA_MANAGER_BUFFER_SIZE);
+    if (buffer == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t ret = ESP_OK;
+    while (1) {
+        int len = esp_http_client_read(client, buffer, CONFIG_OTA_MANAGER_BUFFER_SIZE);
+        if (len < 0) {
+            ESP_LOGE(TAG, "HTTP read error");
+            ret = ESP_FAIL;
+            break;
+        }
+        if (len == 0) {
+            if (!esp_http_client_is_complete_data_received(client)) {
+                ESP_LOGE(TAG, "Connection closed before download completed");
+                ret = ESP_FAIL;
+            }
+            break;
+        }
+
+        portENTER_CRITICAL(&s_ota_spinlock);
+        s_ota_ctx.status.bytes_received += len;
+        portEXIT_CRITICAL(&s_ota_spinlock);
+
+        if (delta_handle != NULL) {
+            ret = esp_delta_ota_feed_patch(delta_handle, (const uint8_t *)buffer, len);
+        } else {
+            ret = ota_manager_delta_write_cb((const uint8_t *)buffer, len);
+        }
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to apply chunk: %s", esp_err_to_name(ret));
+            break;
+        }
+    }
+
+    free(buffer);
+    return ret;
+}
+
+static esp_err_t ota_manager_run_update(const ota_manager_request_t *request)
+{
+    char hex[OTA_MANAGER_SHA256_HEX_LEN];
+
+    s_ota_ctx.running = esp_ota_get_running_partition();
+    s_ota_ctx.update = esp_ota_get_next_update_partition(NULL);
+    if (s_ota_ctx.running == NULL || s_ota_ctx.update == NULL) {
+        ESP_LOGE(TAG, "No OTA slot available - check partition table");
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // A patch only applies to the exact image it was generated against
+    if (request->delta && request->base_sha256[0] != '\0') {
+        esp_err_t ret = ota_manager_partition_sha256_hex(s_ota_ctx.running, hex);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        if (strcasecmp(hex, request->base_sha256) != 0) {
+            ESP_LOGE(TAG, "Patch base mismatch: running %s", hex);
+            return ESP_ERR_INVALID_VERSION;
+        }
+    }
+
+    esp_http_client_config_t http_config = {
+        .url = request->url,
+        .timeout_ms = CONFIG_OTA_MANAGER_HTTP_TIMEOUT_MS,
+        .crt_bundle_attach = esp_crt_bundle_attach,
+        .keep_alive_enable = true,
+    };
+    esp_http_client_handle_t client = esp_http_client_init(&http_config);
+    if (client == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t ret = esp_http_client_open(client, 0);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open %s: %s", request->url, esp_err_to_name(ret));
+        esp_http_client_cleanup(client);
+        return ret;
+    }
+
+    int64_t content_length = esp_http_client_fetch_headers(client);
+    int status_code = esp_http_client_get_status_code(client);
+    if (status_code != 200) {
+        ESP_LOGE(TAG, "HTTP status %d", status_code);
+        esp_http_client_close(client);
+        esp_http_client_cleanup(client);
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+
+    ESP_LOGI(TAG, "Downloading %s %s (%" PRId64 " bytes) into %s",
+             request->delta ? "patch" : "image", request->url, content_length, s_ota_ctx.update->label);
+
+    ret = esp_ota_begin(s_ota_ctx.update, OTA_WITH_SEQUENTIAL_WRITES, &s_ota_ctx.ota_handle);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "esp_ota_begin failed: %s", esp_err_to_name(ret));
+        esp_http_client_close(client);
+        esp_http_client_cleanup(client);
+        return ret;
+    }
+
+    esp_delta_ota_handle_t delta_handle = NULL;
+    if (request->delta) {
+        esp_delta_ota_cfg_t delta_config = {
+            .read_cb = ota_manager_delta_read_cb,
+            .write_cb = ota_manager_delta_write_cb,
+        };
+        delta_handle = esp_delta_ota_init(&delta_config);
+        if (delta_handle == NULL) {
+            ret = ESP_ERR_NO_MEM;
+        }
+    }
+
+    if (ret == ESP_OK) {
+        ret = ota_manager_download(client, delta_handle);
+    }
+
+    if (delta_handle != NULL) {
+        if (ret == ESP_OK) {
+            ret = esp_delta_ota_finalize(delta_handle);
+        }
+        esp_delta_ota_deinit(delta_handle);
+    }
+
+    esp_http_client_close(client);
+    esp_http_client_cleanup(client);
+
+    if (ret != ESP_OK) {
+        esp_ota_abort(s_ota_ctx.ota_handle);
+        return ret;
+    }
+
+    // Verify: image header/checksum (esp_ota_end), then full-image hash
+    ota_manager_set_state(OTA_MANAGER_STATE_VERIFYING, ESP_OK);
+
+    ret = esp_ota_end(s_ota_ctx.ota_handle);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Image validation failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    // Mandatory (see ota_manager_start()): the hash comes over the command
+    // channel, so plain HTTP transport cannot swap the image
+    ret = ota_manager_partition_sha256_hex(s_ota_ctx.update, hex);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (strcasecmp(hex, request->sha256) != 0) {
+        ESP_LOGE(TAG, "SHA-256 mismatch: got %s", hex);
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    return esp_ota_set_boot_partition(s_ota_ctx.update);
+}
+
+static void ota_manager_task(void *param)
+{
+    ota_manager_request_t request;
+
+    portENTER_CRITICAL(&s_ota_spinlock);
+    request = s_ota_ctx.request;
+    portEXIT_CRITICAL(&s_ota_spinlock);
+
+    int64_t start_us = esp_timer_get_time();
+    esp_err_t ret = ota_manager_run_update(&request);
+
+    if (ret == ESP_OK) {
+        ota_manager_status_t status;
+        ota_manager_get_status(&status);
+        ESP_LOGW(TAG, "Update installed in %" PRId64 " s (%" PRIu32 " bytes downloaded, %" PRIu32 " written) - restarting",
+                 (esp_timer_get_time() - start_us) / 1000000, status.bytes_received, status.bytes_written);
+        ota_manager_set_state(OTA_MANAGER_STATE_REBOOTING, ESP_OK);
+        vTaskDelay(pdMS_TO_TICKS(OTA_MANAGER_REBOOT_DELAY_MS));
+        esp_restart();
+    }
+
+    ESP_LOGE(TAG, "Update failed: %s", esp_err_to_name(ret));
+    ota_manager_set_state(OTA_MANAGER_STATE_FAILED, ret);
+
+    portENTER_CRITICAL(&s_ota_spinlock);
+    s_ota_ctx.busy = false;
+    portEXIT_CRITICAL(&s_ota_spinlock);
+
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief No health signal before the deadline: go back to the previous image
+ */
+static void ota_manager_confirm_timeout_cb(void *arg)
+{
+    portENTER_CRITICAL(&s_ota_spinlock);
+    bool pending = s_ota_ctx.status.pending_verify;
+    s_ota_ctx.status.pending_verify = false;
+    portEXIT_CRITICAL(&s_ota_spinlock);
+
+    if (!pending) {
+        return;     // Confirmed meanwhile
+    }
+
+    ESP_LOGE(TAG, "New image not healthy after %d s - rolling back", CONFIG_OTA_MANAGER_CONFIRM_TIMEOUT_S);
+    esp_ota_mark_app_invalid_rollback_and_reboot();
+}
+
+/* ============================ PUBLIC API ============================ */
+
+esp_err_t ota_manager_init(void)
+{
+    if (s_initialized) {
+        ESP_LOGW(TAG, "OTA manager already initialized");
+        return ESP_OK;
+    }
+
+    const esp_partition_t *running = esp_ota_get_running_partition();
+    esp_ota_img_states_t img_state;
+    bool pending = (esp_ota_get_state_partition(running, &img_state) == ESP_OK &&
+                    img_state == ESP_OTA_IMG_PENDING_VERIFY);
+
+    portENTER_CRITICAL(&s_ota_spinlock);
+    s_ota_ctx.status.state = OTA_MANAGER_STATE_IDLE;
+    s_ota_ctx.status.last_error = ESP_OK;
+    s_ota_ctx.status.pending_verify = pending;
+    portEXIT_CRITICAL(&s_ota_spinlock);
+
+    if (pending) {
+        const esp_timer_create_args_t timer_args = {
+            .callback = ota_manager_confirm_timeout_cb,
+            .name = "ota_confirm"
+        };
+        esp_err_t ret = esp_timer_create(&timer_args, &s_ota_ctx.confirm_timer);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        esp_timer_start_once(s_ota_ctx.confirm_timer, (uint64_t)CONFIG_OTA_MANAGER_CONFIRM_TIMEOUT_S * 1000000);
+        ESP_LOGW(TAG, "New image in %s pending verification (rollback in %d s unless confirmed)",
+                 running->label, CONFIG_OTA_MANAGER_CONFIRM_TIMEOUT_S);
+    }
+
+    s_initialized = true;
+    ESP_LOGI(TAG, "OTA manager initialized (running: %s)", running->label);
+
+    return ESP_OK;
+}
+
+esp_err_t ota_manager_start(const ota_manager_request_t *request)
+{
+    if (!s_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (request == NULL || strncmp(request->url, "http", 4) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // The resulting image is always checked against a hash from the command
+    if (!ota_manager_sha256_valid(request->sha256) ||
+        (request->base_sha256[0] != '\0' && !ota_manager_sha256_valid(request->base_sha256))) {
+        ESP_LOGE(TAG, "Update refused: sha256 of the resulting image is required");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&s_ota_spinlock);
+    if (s_ota_ctx.busy || s_ota_ctx.status.pending_verify) {
+        // Never overwrite the previous slot before the running one is confirmed
+        portEXIT_CRITICAL(&s_ota_spinlock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_ota_ctx.busy = true;
+    s_ota_ctx.request = *request;
+    s_ota_ctx.request.url[OTA_MANAGER_URL_MAX_LEN - 1] = '\0';
+    s_ota_ctx.request.sha256[OTA_MANAGER_SHA256_HEX_LEN - 1] = '\0';
+    s_ota_ctx.request.base_sha256[OTA_MANAGER_SHA256_HEX_LEN - 1] = '\0';
+    s_ota_ctx.status.state = OTA_MANAGER_STATE_DOWNLOADING;
+    s_ota_ctx.status.bytes_received = 0;
+    s_ota_ctx.status.bytes_written = 0;
+    portEXIT_CRITICAL(&s_ota_spinlock);
+
+    BaseType_t ret = xTaskCreate(ota_manager_task, "ota_update", OTA_MANAGER_TASK_STACK_SIZE,
+                                 NULL, OTA_MANAGER_TASK_PRIORITY, NULL);
+    if (ret != pdPASS) {
+        portENTER_CRITICAL(&s_ota_spinlock);
+        s_ota_ctx.busy = false;
+        s_ota_ctx.status.state = OTA_MANAGER_STATE_IDLE;
+        portEXIT_CRITICAL(&s_ota_spinlock);
+        return ESP_ERR_NO_MEM;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t ota_manager_confirm_image(void)
+{
+    portENTER_CRITICAL(&s_ota_spinlock);
+    bool pending = s_ota_ctx.status.pending_verify;
+    s_ota_ctx.status.pending_verify = false;
+    portEXIT_CRITICAL(&s_ota_spinlock);
+
+    if (!pending) {
+        return ESP_OK;
+    }
+
+    if (s_ota_ctx.confirm_timer != NULL) {
+        esp_timer_stop(s_ota_ctx.confirm_timer);
+    }
+
+    esp_err_t ret = esp_ota_mark_app_valid_cancel_rollback();
+    if (ret == ESP_OK) {
+        ESP_LOGW(TAG, "Running image confirmed - rollback cancelled");
+    } else {
+        ESP_LOGE(TAG, "Failed to confirm image: %s", esp_err_to_name(ret));
+    }
+
+    return ret;
+}
+
+esp_err_t ota_manager_get_status(ota_manager_status_t *status)
+{
+    if (status == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&s_ota_spinlock);
+    *status = s_ota_ctx.status;
+    portEXIT_CRITICAL(&s_ota_spinlock);
+
+    return ESP_OK;
+}
+
+esp_err_t ota_manager_get_running_sha256(char *hex_out, size_t len)
+{
+    if (hex_out == NULL || len < OTA_MANAGER_SHA256_HEX_LEN) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return ota_manager_partition_sha256_hex(esp_ota_get_running_partition(), hex_out);
+}
@@ -0,0 +1,138 @@
+/**
+ * @file ota_manager.h
+ * @brief OTA Manager Component - Delta firmware updates with rollback
+ *
+ * Downloads compressed binary diffs (detools/heatshrink via esp_delta_ota)
+ * against the running image and applies them to the inactive OTA slot.
+ * The patch is streamed in CONFIG_OTA_MANAGER_BUFFER_SIZE chunks; the
+ * full image is never buffered. Full images are accepted as fallback.
+ *
+ * Component Responsibilities:
+ * - Verify the running image matches the patch base (SHA-256)
+ * - Stream patch/image from HTTP(S) into the inactive slot
+ * - Verify the result (image check + mandatory SHA-256) and switch slots
+ * - Confirm a freshly booted image once it is healthy, or roll back
+ *
+ * Thread-Safety:
+ * - All state access protected by spinlock (portMUX_TYPE)
+ * - Updates run in a dedicated task; one update at a time
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef OTA_MANAGER_H
+#define OTA_MANAGER_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================ CONSTANTS ============================ */
+
+#define OTA_MANAGER_URL_MAX_LEN        256
+#define OTA_MANAGER_SHA256_HEX_LEN     65      ///< 64 hex chars + terminator
+
+/* ============================ TYPES ============================ */
+
+/**
+ * @brief OTA update state
+ */
+typedef enum {
+    OTA_MANAGER_STATE_IDLE = 0,         ///< No update in progress
+    OTA_MANAGER_STATE_DOWNLOADING,      ///< Streaming patch into inactive slot
+    OTA_MANAGER_STATE_VERIFYING,        ///< Checking written image
+    OTA_MANAGER_STATE_REBOOTING,        ///< Boot slot switched, restarting
+    OTA_MANAGER_STATE_FAILED            ///< Last update failed (see last_error)
+} ota_manager_state_t;
+
+/**
+ * @brief OTA update request
+ */
+typedef struct {
+    char url[OTA_MANAGER_URL_MAX_LEN];              ///< Patch or image URL (http/https)
+    char sha256[OTA_MANAGER_SHA256_HEX_LEN];        ///< Expected SHA-256 of resulting image (required)
+    char base_sha256[OTA_MANAGER_SHA256_HEX_LEN];   ///< SHA-256 of the image the patch was built against (delta only)
+    bool delta;                                     ///< true = detools patch, false = full image
+} ota_manager_request_t;
+
+/**
+ * @brief OTA status
+ */
+typedef struct {
+    ota_manager_state_t state;          ///< Current state
+    uint32_t bytes_received;            ///< Patch bytes downloaded
+    uint32_t bytes_written;             ///< Image bytes written to flash
+    esp_err_t last_error;               ///< Error of last failed update
+    bool pending_verify;                ///< Running image not yet confirmed
+} ota_manager_status_t;
+
+/* ============================ PUBLIC API ============================ */
+
+/**
+ * @brief Initialize OTA manager
+ *
+ * If the running image was just installed (pending verify), starts the
+ * confirmation deadline: without ota_manager_confirm_image() within
+ * CONFIG_OTA_MANAGER_CONFIRM_TIMEOUT_S the image is marked invalid and the
+ * device restarts into the previous slot.
+ *
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t ota_manager_init(void);
+
+/**
+ * @brief Start an update in the background
+ *
+ * Device restarts automatically when the update succeeds.
+ *
+ * @param request Update request (copied)
+ * The expected SHA-256 of the resulting image is required (64 hex digits)
+ * and checked before the boot slot is switched, over HTTP or HTTPS alike.
+ *
+ * @return ESP_OK if started, ESP_ERR_INVALID_STATE if an update is running,
+ *         ESP_ERR_INVALID_ARG if request invalid or without sha256
+ */
+esp_err_t ota_manager_start(const ota_manager_request_t *request);
+
+/**
+ * @brief Mark the running image as valid (cancels rollback)
+ *
+ * Call it on a health signal, not on boot: the application confirms after
+ * its first sensor sample is published over MQTT. No-op if the image is
+ * already confirmed.
+ *
+ * @return ESP_OK on success
+ */
+esp_err_t ota_manager_confirm_image(void);
+
+/**
+ * @brief Get OTA status
+ *
+ * @param[out] status Status structure
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if status is NULL
+ */
+esp_err_t ota_manager_get_status(ota_manager_status_t *status);
+
+/**
+ * @brief Get SHA-256 of the running image as hex string
+ *
+ * This is the base a delta patch must be generated against.
+ *
+ * @param[out] hex_out Output buffer (at least OTA_MANAGER_SHA256_HEX_LEN)
+ * @param len Buffer length
+ * @return ESP_OK on success
+ */
+esp_err_t ota_manager_get_running_sha256(char *hex_out, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OTA_MANAGER_H
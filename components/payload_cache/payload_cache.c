@@ -0,0 +1,298 @@
+/**
+ * @file payload_cache.c
+ * @brief Payload Cache Component - Encode-once sensor payloads for all transports
+ *
+ * The pool is allocated once at init. A slot holds one encoding of one
+ * sample; slots with no references keep their encoding and are reused
+ * least-recently-used first, so a sample published over MQTT and then
+ * polled over HTTP is encoded once.
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "payload_cache.h"
+#include "time_sync.h"
+#include "metrics.h"
+#include "esp_log.h"
+#include "esp_mac.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================ CONFIGURATION ============================ */
+
+#ifndef CONFIG_PAYLOAD_CACHE_SLOTS
+#define CONFIG_PAYLOAD_CACHE_SLOTS 4
+#endif
+
+#ifndef CONFIG_PAYLOAD_CACHE_BUFFER_SIZE
+#define CONFIG_PAYLOAD_CACHE_BUFFER_SIZE 1536
+#endif
+
+_Static_assert(CONFIG_PAYLOAD_CACHE_BUFFER_SIZE >= PAYLOAD_BINARY_MAX_SIZE,
+               "binary payload must fit a slot");
+
+/* ============================ PRIVATE TYPES ============================ */
+
+/**
+ * @brief Pool slot
+ *
+ * buffer must stay the first member: payload_cache_release() recovers the
+ * slot from the buffer pointer handed out by acquire.
+ */
+typedef struct {
+    payload_buffer_t buffer;
+    uint32_t soil_timestamp;            ///< Sample identity besides reading_id
+    uint32_t ambient_timestamp;
+    uint32_t last_used;                 ///< Acquire counter value, for LRU reuse
+    uint16_t refcount;
+    bool valid;                         ///< Holds an encoding
+    uint8_t *storage;                   ///< CONFIG_PAYLOAD_CACHE_BUFFER_SIZE bytes
+} payload_slot_t;
+
+/**
+ * @brief Payload cache context
+ */
+typedef struct {
+    payload_slot_t slots[CONFIG_PAYLOAD_CACHE_SLOTS];
+    uint8_t *pool;
+    uint32_t use_counter;
+    SemaphoreHandle_t mutex;            ///< Lookup and encoding
+} payload_cache_context_t;
+
+/* ============================ PRIVATE STATE ============================ */
+
+static const char *TAG = "payload_cache";
+
+static payload_cache_context_t s_pc_ctx = {0};
+static portMUX_TYPE s_pc_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+static metrics_counter_t s_pc_encodes = METRICS_COUNTER_INIT(
+    "payload_cache_acquires", "Payload acquires by result", "result=\"encoded\"");
+static metrics_counter_t s_pc_hits = METRICS_COUNTER_INIT(
+    "payload_cache_acquires", "Payload acquires by result", "result=\"hit\"");
+static metrics_counter_t s_pc_exhausted = METRICS_COUNTER_INIT(
+    "payload_cache_acquires", "Payload acquires by result", "result=\"exhausted\"");
+
+/* ============================ ENCODING ============================ */
+
+static esp_err_t encode(const sensor_reading_t *reading, payload_format_t format,
+                        uint8_t *out, size_t size, size_t *len)
+{
+    payload_codec_context_t codec = {
+        .uptime_ms = time_sync_get_monotonic_ms(),
+        .time_quality = time_sync_quality_to_string((time_quality_t)reading->soil.time_quality),
+    };
+
+    esp_err_t ret = esp_read_mac(codec.mac, ESP_MAC_WIFI_STA);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to read MAC address: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    if (format == PAYLOAD_FORMAT_JSON) {
+        *len = payload_codec_encode_json(reading, &codec, out, size);
+    } else {
+        *len = payload_codec_encode_binary(reading, &codec, out, size);
+    }
+
+    if (*len == 0) {
+        ESP_LOGE(TAG, "%s payload exceeds %d bytes",
+                 format == PAYLOAD_FORMAT_JSON ? "sensor_data JSON" : "Binary",
+                 CONFIG_PAYLOAD_CACHE_BUFFER_SIZE);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    return ESP_OK;
+}
+
+/* ============================ SLOTS ============================ */
+
+static bool slot_matches(const payload_slot_t *slot, const sensor_reading_t *reading,
+                         payload_format_t format)
+{
+    return slot->valid &&
+           slot->buffer.format == format &&
+           slot->buffer.reading_id == reading->reading_id &&
+           slot->soil_timestamp == reading->soil.timestamp &&
+           slot->ambient_timestamp == reading->ambient.timestamp;
+}
+
+/**
+ * @brief Least recently used slot with no references (caller holds the mutex)
+ */
+static payload_slot_t* slot_find_free(void)
+{
+    payload_slot_t *best = NULL;
+
+    portENTER_CRITICAL(&s_pc_spinlock);
+    {
+        for (int i = 0; i < CONFIG_PAYLOAD_CACHE_SLOTS; i++) {
+            payload_slot_t *slot = &s_pc_ctx.slots[i];
+            if (slot->refcount != 0) {
+                continue;
+            }
+            if (!slot->valid) {
+                best = slot;
+                break;
+            }
+            if (best == NULL || (int32_t)(slot->last_used - best->last_used) < 0) {
+                best = slot;
+            }
+        }
+    }
+    portEXIT_CRITICAL(&s_pc_spinlock);
+
+    return best;
+}
+
+/* ============================ PUBLIC API ============================ */
+
+esp_err_t payload_cache_init(void)
+{
+    if (s_pc_ctx.pool != NULL) {
+        return ESP_OK;
+    }
+
+    s_pc_ctx.mutex = xSemaphoreCreateMutex();
+    if (s_pc_ctx.mutex == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    uint8_t *pool = calloc(CONFIG_PAYLOAD_CACHE_SLOTS, CONFIG_PAYLOAD_CACHE_BUFFER_SIZE);
+    if (pool == NULL) {
+        vSemaphoreDelete(s_pc_ctx.mutex);
+        s_pc_ctx.mutex = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    for (int i = 0; i < CONFIG_PAYLOAD_CACHE_SLOTS; i++) {
+        s_pc_ctx.slots[i].storage = pool + i * CONFIG_PAYLOAD_CACHE_BUFFER_SIZE;
+        s_pc_ctx.slots[i].buffer.data = s_pc_ctx.slots[i].storage;
+    }
+    s_pc_ctx.pool = pool;
+
+    metrics_register(&s_pc_encodes.desc);
+    metrics_register(&s_pc_hits.desc);
+    metrics_register(&s_pc_exhausted.desc);
+
+    ESP_LOGI(TAG, "Payload cache ready: %d slots x %d bytes",
+             CONFIG_PAYLOAD_CACHE_SLOTS, CONFIG_PAYLOAD_CACHE_BUFFER_SIZE);
+    return ESP_OK;
+}
+
+esp_err_t payload_cache_acquire(const sensor_reading_t *reading, payload_format_t format,
+                                const payload_buffer_t **buffer)
+{
+    if (reading == NULL || buffer == NULL || format >= PAYLOAD_FORMAT_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_pc_ctx.pool == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    *buffer = NULL;
+    esp_err_t ret = ESP_OK;
+
+    xSemaphoreTake(s_pc_ctx.mutex, portMAX_DELAY);
+
+    uint32_t now = ++s_pc_ctx.use_counter;
+    payload_slot_t *slot = NULL;
+
+    for (int i = 0; i < CONFIG_PAYLOAD_CACHE_SLOTS; i++) {
+        if (slot_matches(&s_pc_ctx.slots[i], reading, format)) {
+            slot = &s_pc_ctx.slots[i];
+            break;
+        }
+    }
+
+    if (slot != NULL) {
+        portENTER_CRITICAL(&s_pc_spinlock);
+        {
+            slot->refcount++;
+            slot->last_used = now;
+        }
+        portEXIT_CRITICAL(&s_pc_spinlock);
+        metrics_counter_inc(&s_pc_hits);
+        *buffer = &slot->buffer;
+        xSemaphoreGive(s_pc_ctx.mutex);
+        return ESP_OK;
+    }
+
+    slot = slot_find_free();
+    if (slot == NULL) {
+        metrics_counter_inc(&s_pc_exhausted);
+        xSemaphoreGive(s_pc_ctx.mutex);
+        ESP_LOGW(TAG, "All %d payload slots in use", CONFIG_PAYLOAD_CACHE_SLOTS);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Unreferenced and only reachable under the mutex: safe to rewrite
+    slot->valid = false;
+    size_t len = 0;
+    ret = encode(reading, format, slot->storage, CONFIG_PAYLOAD_CACHE_BUFFER_SIZE, &len);
+    if (ret == ESP_OK) {
+        slot->buffer.len = len;
+        slot->buffer.reading_id = reading->reading_id;
+        slot->buffer.format = format;
+        if (!payload_codec_find_uptime(slot->storage, len, format == PAYLOAD_FORMAT_BINARY,
+                                       &slot->buffer.uptime_offset, &slot->buffer.uptime_len)) {
+            slot->buffer.uptime_offset = 0;
+            slot->buffer.uptime_len = 0;
+        }
+        slot->soil_timestamp = reading->soil.timestamp;
+        slot->ambient_timestamp = reading->ambient.timestamp;
+
+        portENTER_CRITICAL(&s_pc_spinlock);
+        {
+            slot->valid = true;
+            slot->refcount = 1;
+            slot->last_used = now;
+        }
+        portEXIT_CRITICAL(&s_pc_spinlock);
+        metrics_counter_inc(&s_pc_encodes);
+        *buffer = &slot->buffer;
+    }
+
+    xSemaphoreGive(s_pc_ctx.mutex);
+    return ret;
+}
+
+void payload_cache_release(const payload_buffer_t *buffer)
+{
+    if (buffer == NULL) {
+        return;
+    }
+
+    payload_slot_t *slot = (payload_slot_t*)buffer;
+
+    portENTER_CRITICAL(&s_pc_spinlock);
+    {
+        if (slot->refcount > 0) {
+            slot->refcount--;
+        }
+    }
+    portEXIT_CRITICAL(&s_pc_spinlock);
+}
+
+size_t payload_cache_encode_uptime(const payload_buffer_t *buffer, uint8_t *out, size_t size)
+{
+    if (buffer == NULL || buffer->uptime_len == 0) {
+        return 0;
+    }
+    return payload_codec_encode_uptime(time_sync_get_monotonic_ms(),
+                                       buffer->format == PAYLOAD_FORMAT_BINARY, out, size);
+}
+
+void payload_cache_get_stats(payload_cache_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+
+    stats->encodes = metrics_counter_get(&s_pc_encodes);
+    stats->hits = metrics_counter_get(&s_pc_hits);
+    stats->exhausted = metrics_counter_get(&s_pc_exhausted);
+}
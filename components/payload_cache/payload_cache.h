@@ -0,0 +1,131 @@
+/**
+ * @file payload_cache.h
+ * @brief Payload Cache Component - Encode-once sensor payloads for all transports
+ *
+ * A sensor sample is serialized at most once per format. The encoded bytes
+ * live in a refcounted buffer from a fixed pool allocated at init, and MQTT,
+ * HTTP and push subscribers send that buffer directly instead of each
+ * building and printing their own cJSON tree.
+ *
+ * Component Responsibilities:
+ * - Encode sensor_scheduler samples as JSON or compact binary
+ * - Keep recent encodings keyed by reading_id until their slot is reused
+ * - Hand out read-only buffers with reference counting
+ *
+ * Encoders and the binary layout live in payload_codec.h.
+ *
+ * Thread-Safety:
+ * - Lookup and encoding serialized by a mutex (one encoding per sample)
+ * - Release is a spinlock decrement, safe from any task
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef PAYLOAD_CACHE_H
+#define PAYLOAD_CACHE_H
+
+#include "esp_err.h"
+#include "common_types.h"
+#include "payload_codec.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================ TYPES ============================ */
+
+/**
+ * @brief Payload encodings
+ */
+typedef enum {
+    PAYLOAD_FORMAT_JSON = 0,        ///< sensor_data JSON (NUL-terminated)
+    PAYLOAD_FORMAT_BINARY,          ///< Compact binary (see payload_codec.h)
+    PAYLOAD_FORMAT_COUNT
+} payload_format_t;
+
+/**
+ * @brief Encoded payload (read-only for holders)
+ */
+typedef struct {
+    const uint8_t *data;            ///< Encoded bytes
+    size_t len;                     ///< Length in bytes (JSON: without the NUL)
+    uint32_t reading_id;            ///< Sample the payload was encoded from
+    payload_format_t format;        ///< Encoding
+    size_t uptime_offset;           ///< Uptime value in data (stamped at encode time)
+    size_t uptime_len;              ///< Its length, 0 if the payload has none
+} payload_buffer_t;
+
+/**
+ * @brief Cache counters since boot (also on GET /metrics)
+ */
+typedef struct {
+    uint32_t encodes;               ///< Payloads encoded
+    uint32_t hits;                  ///< Acquires served from an existing encoding
+    uint32_t exhausted;             ///< Acquires failed: every slot referenced
+} payload_cache_stats_t;
+
+/* ============================ PUBLIC API ============================ */
+
+/**
+ * @brief Allocate the buffer pool
+ *
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the pool cannot be allocated
+ */
+esp_err_t payload_cache_init(void);
+
+/**
+ * @brief Get the encoded payload of a sample, encoding it on first use
+ *
+ * Samples are identified by reading_id and their timestamps, so pass the
+ * sample as returned by sensor_scheduler_get_latest(). Every successful
+ * acquire must be paired with payload_cache_release().
+ *
+ * @param reading Sample to encode
+ * @param format Encoding
+ * @param[out] buffer Referenced buffer
+ * @return ESP_OK on success
+ *         ESP_ERR_INVALID_STATE if not initialized
+ *         ESP_ERR_NO_MEM if every slot is referenced
+ *         ESP_ERR_INVALID_SIZE if the payload does not fit a slot
+ */
+esp_err_t payload_cache_acquire(const sensor_reading_t *reading, payload_format_t format,
+                                const payload_buffer_t **buffer);
+
+/**
+ * @brief Drop a reference taken by payload_cache_acquire()
+ *
+ * The encoding stays cached for later acquires until its slot is reused.
+ *
+ * @param buffer Buffer to release (NULL is ignored)
+ */
+void payload_cache_release(const payload_buffer_t *buffer);
+
+/**
+ * @brief Encode the current uptime in the format of @p buffer's uptime field
+ *
+ * The cached bytes keep the uptime of their encoding, which the backend
+ * uses to re-base unsynced timestamps. A sender serving a payload later
+ * sends data[0, uptime_offset), this field, then the bytes after
+ * uptime_offset + uptime_len.
+ *
+ * @param buffer Acquired buffer
+ * @param[out] out Output, PAYLOAD_UPTIME_MAX_SIZE bytes are enough
+ * @param size Size of @p out
+ * @return Field length, 0 if the buffer has no uptime field or @p out is too small
+ */
+size_t payload_cache_encode_uptime(const payload_buffer_t *buffer, uint8_t *out, size_t size);
+
+/**
+ * @brief Copy the cache counters
+ */
+void payload_cache_get_stats(payload_cache_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PAYLOAD_CACHE_H
@@ -0,0 +1,195 @@
+/**
+ * @file payload_codec.c
+ * @brief Sensor payload encoders - sensor_data JSON and compact binary
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "payload_codec.h"
+#include "cJSON.h"
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+/* ============================ HELPERS ============================ */
+
+static size_t put_u16(uint8_t *out, uint16_t value)
+{
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+    return 2;
+}
+
+static size_t put_u32(uint8_t *out, uint32_t value)
+{
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+    out[2] = (uint8_t)(value >> 16);
+    out[3] = (uint8_t)(value >> 24);
+    return 4;
+}
+
+/**
+ * @brief Scale to hundredths and clamp to [min, max]
+ */
+static int32_t scale_x100(float value, int32_t min, int32_t max)
+{
+    float scaled = value * 100.0f;
+    scaled += (scaled < 0.0f) ? -0.5f : 0.5f;
+    if (scaled <= (float)min) {
+        return min;
+    }
+    if (scaled >= (float)max) {
+        return max;
+    }
+    return (int32_t)scaled;
+}
+
+/* ============================ PUBLIC API ============================ */
+
+size_t payload_codec_encode_json(const sensor_reading_t *reading,
+                                 const payload_codec_context_t *ctx,
+                                 uint8_t *out, size_t size)
+{
+    // cJSON_PrintPreallocated() wants 5 spare bytes beyond the output
+    if (reading == NULL || ctx == NULL || out == NULL || size <= 5) {
+        return 0;
+    }
+
+    char mac_str[18];
+    snprintf(mac_str, sizeof(mac_str), "%02X:%02X:%02X:%02X:%02X:%02X",
+             ctx->mac[0], ctx->mac[1], ctx->mac[2], ctx->mac[3], ctx->mac[4], ctx->mac[5]);
+
+    cJSON *json = cJSON_CreateObject();
+    if (json == NULL) {
+        return 0;
+    }
+
+    cJSON_AddStringToObject(json, "event_type", "sensor_data");
+    cJSON_AddStringToObject(json, "mac_address", mac_str);
+    cJSON_AddStringToObject(json, "ip_address", reading->device_ip);
+    cJSON_AddNumberToObject(json, "ambient_temperature", reading->ambient.temperature);
+    cJSON_AddNumberToObject(json, "ambient_humidity", reading->ambient.humidity);
+
+    // One soil_humidity_N key per active channel (N = 1..soil_sensor_count)
+    cJSON_AddNumberToObject(json, "soil_sensor_count", reading->soil.sensor_count);
+    for (uint8_t i = 0; i < reading->soil.sensor_count && i < SOIL_MAX_SENSORS; i++) {
+        char key[20];
+        snprintf(key, sizeof(key), "soil_humidity_%d", i + 1);
+        cJSON_AddNumberToObject(json, key, reading->soil.soil_humidity[i]);
+    }
+
+    // Unsynced timestamps are seconds since boot; backend re-bases them with uptime_ms
+    cJSON_AddNumberToObject(json, "timestamp", reading->soil.timestamp);
+    cJSON_AddStringToObject(json, "time_quality", ctx->time_quality);
+    cJSON_AddNumberToObject(json, "uptime_ms", (double)ctx->uptime_ms);
+
+    int printed = cJSON_PrintPreallocated(json, (char*)out, (int)(size - 5), 1);
+    cJSON_Delete(json);
+
+    return printed ? strlen((const char*)out) : 0;
+}
+
+size_t payload_codec_encode_binary(const sensor_reading_t *reading,
+                                   const payload_codec_context_t *ctx,
+                                   uint8_t *out, size_t size)
+{
+    if (reading == NULL || ctx == NULL || out == NULL) {
+        return 0;
+    }
+
+    uint8_t count = reading->soil.sensor_count;
+    if (count > SOIL_MAX_SENSORS) {
+        count = SOIL_MAX_SENSORS;
+    }
+    if (size < PAYLOAD_BINARY_HEADER_SIZE + 2u * count) {
+        return 0;
+    }
+
+    uint8_t *p = out;
+    *p++ = PAYLOAD_BINARY_VERSION;
+    *p++ = reading->soil.time_quality;
+    *p++ = count;
+    *p++ = 0;
+    p += put_u32(p, reading->reading_id);
+    p += put_u32(p, reading->soil.timestamp);
+    p += put_u32(p, (uint32_t)(ctx->uptime_ms / 1000));
+    memcpy(p, ctx->mac, 6);
+    p += 6;
+    p += put_u16(p, reading->soil.valid_mask);
+    p += put_u16(p, (uint16_t)(int16_t)scale_x100(reading->ambient.temperature, INT16_MIN, INT16_MAX));
+    p += put_u16(p, (uint16_t)scale_x100(reading->ambient.humidity, 0, 10000));
+    for (uint8_t i = 0; i < count; i++) {
+        p += put_u16(p, (uint16_t)scale_x100(reading->soil.soil_humidity[i], 0, 10000));
+    }
+
+    return (size_t)(p - out);
+}
+
+bool payload_codec_find_uptime(const uint8_t *payload, size_t len, bool binary,
+                               size_t *offset, size_t *field_len)
+{
+    if (payload == NULL || offset == NULL || field_len == NULL) {
+        return false;
+    }
+
+    if (binary) {
+        if (len < PAYLOAD_BINARY_HEADER_SIZE) {
+            return false;
+        }
+        *offset = PAYLOAD_BINARY_UPTIME_OFFSET;
+        *field_len = 4;
+        return true;
+    }
+
+    // Last key of the object: "uptime_ms":<whitespace><digits>
+    static const char key[] = "\"uptime_ms\":";
+    const char *text = (const char*)payload;
+    const char *found = NULL;
+    for (size_t i = 0; i + sizeof(key) - 1 <= len; i++) {
+        if (memcmp(text + i, key, sizeof(key) - 1) == 0) {
+            found = text + i + sizeof(key) - 1;
+        }
+    }
+    if (found == NULL) {
+        return false;
+    }
+
+    const char *end = text + len;
+    while (found < end && (*found == ' ' || *found == '\t')) {
+        found++;
+    }
+    const char *digits = found;
+    while (found < end && *found >= '0' && *found <= '9') {
+        found++;
+    }
+    if (found == digits) {
+        return false;
+    }
+
+    *offset = (size_t)(digits - text);
+    *field_len = (size_t)(found - digits);
+    return true;
+}
+
+size_t payload_codec_encode_uptime(int64_t uptime_ms, bool binary, uint8_t *out, size_t size)
+{
+    if (out == NULL) {
+        return 0;
+    }
+
+    if (binary) {
+        return (size >= 4) ? put_u32(out, (uint32_t)(uptime_ms / 1000)) : 0;
+    }
+
+    // Same digits cJSON prints for an integral number
+    char digits[PAYLOAD_UPTIME_MAX_SIZE + 1];
+    int n = snprintf(digits, sizeof(digits), "%" PRId64, uptime_ms);
+    if (n <= 0 || (size_t)n > size) {
+        return 0;
+    }
+    memcpy(out, digits, (size_t)n);
+    return (size_t)n;
+}
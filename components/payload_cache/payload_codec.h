@@ -0,0 +1,119 @@
+/**
+ * @file payload_codec.h
+ * @brief Sensor payload encoders - sensor_data JSON and compact binary
+ *
+ * Pure C with no ESP-IDF dependencies (cJSON only), so the exact bytes the
+ * firmware publishes can be produced on a host, e.g. by the fleet load
+ * generator in tools/fleet_loadgen. payload_cache supplies the device
+ * context (MAC, uptime, time quality) on target.
+ *
+ * Binary format (little endian, PAYLOAD_BINARY_VERSION 1):
+ * | Offset | Size | Field                                  |
+ * |--------|------|----------------------------------------|
+ * | 0      | 1    | version                                |
+ * | 1      | 1    | time_quality (time_quality_t)          |
+ * | 2      | 1    | soil_count                             |
+ * | 3      | 1    | reserved (0)                           |
+ * | 4      | 4    | reading_id                             |
+ * | 8      | 4    | timestamp (s, soil sample)             |
+ * | 12     | 4    | uptime (s, at encode time)             |
+ * | 16     | 6    | MAC address (WiFi STA)                 |
+ * | 22     | 2    | soil valid_mask                        |
+ * | 24     | 2    | ambient temperature (int16, 0.01 °C)   |
+ * | 26     | 2    | ambient humidity (uint16, 0.01 %)      |
+ * | 28     | 2*n  | soil humidity per channel (0.01 %)     |
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef PAYLOAD_CODEC_H
+#define PAYLOAD_CODEC_H
+
+#include "common_types.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================ CONSTANTS ============================ */
+
+#define PAYLOAD_BINARY_VERSION      1
+#define PAYLOAD_BINARY_HEADER_SIZE  28      ///< Bytes before the soil channels
+#define PAYLOAD_BINARY_MAX_SIZE     (PAYLOAD_BINARY_HEADER_SIZE + 2 * SOIL_MAX_SENSORS)
+#define PAYLOAD_BINARY_UPTIME_OFFSET 12
+#define PAYLOAD_UPTIME_MAX_SIZE     20      ///< Longest uptime field (JSON digits)
+
+/* ============================ TYPES ============================ */
+
+/**
+ * @brief Device fields that are not part of sensor_reading_t
+ */
+typedef struct {
+    uint8_t mac[6];                 ///< WiFi STA MAC
+    int64_t uptime_ms;              ///< Monotonic uptime at encode time
+    const char *time_quality;       ///< Name of the sample's time_quality_t
+} payload_codec_context_t;
+
+/* ============================ PUBLIC API ============================ */
+
+/**
+ * @brief Encode the sensor_data JSON published on irrigation/data
+ *
+ * JSON: {event_type, mac_address, ip_address, ambient_*, soil_sensor_count,
+ *        soil_humidity_1..N, timestamp, time_quality, uptime_ms}
+ * Written NUL-terminated and formatted like cJSON_Print().
+ *
+ * @param reading Sample to encode
+ * @param ctx Device context
+ * @param[out] out Output buffer
+ * @param size Size of @p out
+ * @return Length without the NUL, 0 if it does not fit or on allocation failure
+ */
+size_t payload_codec_encode_json(const sensor_reading_t *reading,
+                                 const payload_codec_context_t *ctx,
+                                 uint8_t *out, size_t size);
+
+/**
+ * @brief Encode the compact binary payload (layout above)
+ *
+ * @return Length in bytes, 0 if it does not fit
+ */
+size_t payload_codec_encode_binary(const sensor_reading_t *reading,
+                                   const payload_codec_context_t *ctx,
+                                   uint8_t *out, size_t size);
+
+/**
+ * @brief Find the uptime value in an encoded payload
+ *
+ * Lets a sender replace the encode-time uptime of a stored payload with
+ * the current one (see payload_codec_encode_uptime()).
+ *
+ * @param payload Output of one of the encoders above
+ * @param len Payload length
+ * @param binary true for the binary layout, false for JSON
+ * @param[out] offset First byte of the value
+ * @param[out] field_len Length of the value
+ * @return true if found
+ */
+bool payload_codec_find_uptime(const uint8_t *payload, size_t len, bool binary,
+                               size_t *offset, size_t *field_len);
+
+/**
+ * @brief Encode an uptime value exactly as the encoders write it
+ *
+ * JSON: decimal milliseconds. Binary: 4-byte little-endian seconds.
+ *
+ * @return Bytes written, 0 if it does not fit
+ */
+size_t payload_codec_encode_uptime(int64_t uptime_ms, bool binary, uint8_t *out, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PAYLOAD_CODEC_H
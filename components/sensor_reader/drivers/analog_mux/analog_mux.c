@@ -0,0 +1,183 @@
+/**
+ * @file analog_mux.c
+ * @brief CD4051 / CD74HC4067 analog multiplexer with settle-aware scanning
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "analog_mux.h"
+#include "driver/gpio.h"
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdbool.h>
+#include <inttypes.h>
+
+/* ============================ PRIVATE STATE ============================ */
+
+static const char *TAG = "analog_mux";
+
+// Only touched from the sensor_reader task
+static analog_mux_config_t s_config;
+static bool s_initialized = false;
+static int64_t s_settled_at_us = 0;     // esp_timer time at which the selected channel is valid
+
+/* ============================ PRIVATE HELPERS ============================ */
+
+static void mux_set_inhibit(bool inhibit)
+{
+    if (s_config.inhibit_gpio >= 0) {
+        gpio_set_level((gpio_num_t)s_config.inhibit_gpio, inhibit ? 1 : 0);
+    }
+}
+
+/**
+ * @brief Drive the address lines and start the settle window
+ */
+static void mux_select(uint8_t channel)
+{
+    for (uint8_t line = 0; line < s_config.addr_lines; line++) {
+        gpio_set_level((gpio_num_t)s_config.addr_gpio[line], (channel >> line) & 1U);
+    }
+    s_settled_at_us = esp_timer_get_time() + s_config.settle_us;
+}
+
+/**
+ * @brief Wait for whatever is left of the settle window
+ *
+ * Long windows (RC filters on the sensor lines) yield to other tasks;
+ * the sub-tick remainder is busy-waited.
+ */
+static void mux_wait_settled(void)
+{
+    int64_t remaining_us = s_settled_at_us - esp_timer_get_time();
+    if (remaining_us <= 0) {
+        return;
+    }
+
+    int64_t tick_us = (int64_t)portTICK_PERIOD_MS * 1000;
+    if (remaining_us > 2 * tick_us) {
+        vTaskDelay((TickType_t)(remaining_us / tick_us) - 1);
+        remaining_us = s_settled_at_us - esp_timer_get_time();
+    }
+
+    if (remaining_us > 0) {
+        esp_rom_delay_us((uint32_t)remaining_us);
+    }
+}
+
+/* ============================ PUBLIC API ============================ */
+
+esp_err_t analog_mux_init(const analog_mux_config_t *config)
+{
+    if (config == NULL || config->addr_lines == 0 ||
+        config->addr_lines > ANALOG_MUX_MAX_ADDR_LINES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint64_t pin_mask = 0;
+    for (uint8_t line = 0; line < config->addr_lines; line++) {
+        if (config->addr_gpio[line] < 0) {
+            ESP_LOGE(TAG, "Address line S%d has no GPIO", line);
+            return ESP_ERR_INVALID_ARG;
+        }
+        pin_mask |= 1ULL << config->addr_gpio[line];
+    }
+    if (config->inhibit_gpio >= 0) {
+        pin_mask |= 1ULL << config->inhibit_gpio;
+    }
+
+    gpio_config_t io_cfg = {
+        .pin_bit_mask = pin_mask,
+        .mode = GPIO_MODE_OUTPUT,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_DISABLE,
+    };
+    esp_err_t ret = gpio_config(&io_cfg);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "GPIO config failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    s_config = *config;
+    s_initialized = true;
+
+    mux_set_inhibit(true);
+    mux_select(0);
+
+    ESP_LOGI(TAG, "%d-channel mux ready (settle %" PRIu32 " us, inhibit GPIO %d)",
+             analog_mux_channel_count(), s_config.settle_us, s_config.inhibit_gpio);
+    return ESP_OK;
+}
+
+esp_err_t analog_mux_deinit(void)
+{
+    if (!s_initialized) {
+        return ESP_OK;
+    }
+
+    mux_set_inhibit(true);
+    for (uint8_t line = 0; line < s_config.addr_lines; line++) {
+        gpio_reset_pin((gpio_num_t)s_config.addr_gpio[line]);
+    }
+    // INH stays driven high so the sensors remain disconnected from the ADC pin
+
+    s_initialized = false;
+    return ESP_OK;
+}
+
+uint8_t analog_mux_channel_count(void)
+{
+    if (!s_initialized) {
+        return 0;
+    }
+    return (uint8_t)(1U << s_config.addr_lines);
+}
+
+esp_err_t analog_mux_scan(uint8_t count, analog_mux_convert_fn convert,
+                          analog_mux_process_fn process, void *ctx)
+{
+    if (!s_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (convert == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint8_t max_channels = analog_mux_channel_count();
+    if (count > max_channels) {
+        count = max_channels;
+    }
+    if (count == 0) {
+        return ESP_OK;
+    }
+
+    // Enabling the switch counts as a transition: settle channel 0 first
+    mux_select(0);
+    mux_set_inhibit(false);
+
+    for (uint8_t ch = 0; ch < count; ch++) {
+        mux_wait_settled();
+
+        int raw = 0;
+        esp_err_t result = convert(ch, &raw, ctx);
+
+        // Switch right after the conversion so the next channel settles
+        // while this one is post-processed
+        if (ch + 1 < count) {
+            mux_select(ch + 1);
+        }
+
+        if (process != NULL) {
+            process(ch, result, raw, ctx);
+        }
+    }
+
+    mux_set_inhibit(true);
+    return ESP_OK;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file analog_mux.h
+ * @brief CD4051 / CD74HC4067 analog multiplexer with settle-aware scanning
+ *
+ * Routes up to 16 soil sensors to a single ADC1 input. The driver owns the
+ * address (S0..S3) and inhibit GPIOs and provides a scan scheduler that
+ * overlaps the settle time of the next channel with the post-processing of
+ * the current one:
+ *
+ *   select(0) | settle | convert(0) | select(1) + process(0) | settle | ...
+ *
+ * The settle deadline is measured from the address switch, so any time
+ * spent in the process callback is subtracted from the wait.
+ *
+ * Thread-Safety:
+ * - Not thread-safe; sensor_reader serializes all scans
+ *
+ * Configuration:
+ * - CONFIG_SENSOR_SOIL_MUX_* (menuconfig → Sensor Reader Configuration)
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef ANALOG_MUX_H
+#define ANALOG_MUX_H
+
+#include "esp_err.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ANALOG_MUX_MAX_ADDR_LINES   4       ///< CD74HC4067: S0..S3
+#define ANALOG_MUX_MAX_CHANNELS     16
+
+/**
+ * @brief Multiplexer wiring
+ */
+typedef struct {
+    int8_t addr_gpio[ANALOG_MUX_MAX_ADDR_LINES]; ///< S0..S3 (unused lines: -1)
+    uint8_t addr_lines;         ///< 3 (CD4051) or 4 (CD74HC4067)
+    int8_t inhibit_gpio;        ///< INH/E pin, active high disables (-1 = tied low)
+    uint32_t settle_us;         ///< Wait after an address switch before converting
+} analog_mux_config_t;
+
+/**
+ * @brief Convert the currently selected channel
+ *
+ * Runs after the settle time has elapsed. Must only touch the ADC.
+ *
+ * @param channel Mux channel being converted
+ * @param[out] raw Raw ADC value
+ * @param ctx User context from analog_mux_scan()
+ * @return ESP_OK on success
+ */
+typedef esp_err_t (*analog_mux_convert_fn)(uint8_t channel, int *raw, void *ctx);
+
+/**
+ * @brief Post-process a converted channel
+ *
+ * Runs while the next channel is settling (calibration, logging, ...).
+ *
+ * @param channel Mux channel that was converted
+ * @param result Result of the convert callback
+ * @param raw Raw ADC value (valid if result == ESP_OK)
+ * @param ctx User context from analog_mux_scan()
+ */
+typedef void (*analog_mux_process_fn)(uint8_t channel, esp_err_t result, int raw, void *ctx);
+
+/**
+ * @brief Configure the address and inhibit GPIOs
+ *
+ * Leaves the mux inhibited until the first scan.
+ *
+ * @param config Wiring (copied)
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on bad wiring
+ */
+esp_err_t analog_mux_init(const analog_mux_config_t *config);
+
+/**
+ * @brief Inhibit the mux and release the GPIOs
+ *
+ * @return ESP_OK (also if not initialized)
+ */
+esp_err_t analog_mux_deinit(void);
+
+/**
+ * @brief Number of channels addressable with the configured lines
+ */
+uint8_t analog_mux_channel_count(void);
+
+/**
+ * @brief Scan channels 0..count-1 in order
+ *
+ * Enables the mux for the duration of the scan and inhibits it afterwards
+ * so idle sensors do not load the ADC input.
+ *
+ * @param count Channels to scan (clamped to analog_mux_channel_count())
+ * @param convert ADC conversion callback
+ * @param process Post-processing callback (may be NULL)
+ * @param ctx Passed to both callbacks
+ * @return ESP_OK if the scan ran (per-channel errors go to @p process),
+ *         ESP_ERR_INVALID_STATE if not initialized
+ */
+esp_err_t analog_mux_scan(uint8_t count, analog_mux_convert_fn convert,
+                          analog_mux_process_fn process, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ANALOG_MUX_H */
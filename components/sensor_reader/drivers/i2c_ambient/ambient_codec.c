@@ -0,0 +1,109 @@
+/**
+ * @file ambient_codec.c
+ * @brief SHT3x / BME280 data decoding - CRC, compensation and range checks
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "ambient_codec.h"
+
+/* ============================ PRIVATE FUNCTIONS ============================ */
+
+static ambient_codec_result_t ambient_check_range(float temperature, float humidity)
+{
+    if (temperature < AMBIENT_TEMPERATURE_MIN || temperature > AMBIENT_TEMPERATURE_MAX ||
+        humidity < 0.0f || humidity > 100.0f) {
+        return AMBIENT_CODEC_ERR_RANGE;
+    }
+    return AMBIENT_CODEC_OK;
+}
+
+/* ============================ SHT3X ============================ */
+
+uint8_t sht3x_crc8(const uint8_t *data, uint8_t len)
+{
+    uint8_t crc = 0xFF;
+
+    for (uint8_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+ambient_codec_result_t sht3x_decode(const uint8_t rx[SHT3X_MEASUREMENT_LEN],
+                                    float *temperature, float *humidity)
+{
+    if (sht3x_crc8(&rx[0], 2) != rx[2] || sht3x_crc8(&rx[3], 2) != rx[5]) {
+        return AMBIENT_CODEC_ERR_CRC;
+    }
+
+    uint16_t raw_t = (uint16_t)((rx[0] << 8) | rx[1]);
+    uint16_t raw_rh = (uint16_t)((rx[3] << 8) | rx[4]);
+
+    *temperature = -45.0f + 175.0f * (float)raw_t / 65535.0f;
+    *humidity = 100.0f * (float)raw_rh / 65535.0f;
+
+    return ambient_check_range(*temperature, *humidity);
+}
+
+/* ============================ BME280 ============================ */
+
+void bme280_parse_calib(const uint8_t tp[BME280_CALIB_TP_LEN],
+                        const uint8_t h[BME280_CALIB_H_LEN],
+                        bme280_calib_t *calib)
+{
+    calib->dig_t1 = (uint16_t)(tp[0] | (tp[1] << 8));
+    calib->dig_t2 = (int16_t)(tp[2] | (tp[3] << 8));
+    calib->dig_t3 = (int16_t)(tp[4] | (tp[5] << 8));
+    calib->dig_h1 = tp[25];                                     // 0xA1
+    calib->dig_h2 = (int16_t)(h[0] | (h[1] << 8));              // 0xE1/0xE2
+    calib->dig_h3 = h[2];                                       // 0xE3
+    calib->dig_h4 = (int16_t)(((int8_t)h[3] * 16) | (h[4] & 0x0F)); // 0xE4[11:4] 0xE5[3:0]
+    calib->dig_h5 = (int16_t)(((int8_t)h[5] * 16) | (h[4] >> 4));   // 0xE6[11:4] 0xE5[7:4]
+    calib->dig_h6 = (int8_t)h[6];                               // 0xE7
+}
+
+ambient_codec_result_t bme280_decode(const bme280_calib_t *calib,
+                                     const uint8_t raw[BME280_DATA_TH_LEN],
+                                     float *temperature, float *humidity)
+{
+    int32_t adc_t = (int32_t)(((uint32_t)raw[0] << 12) | ((uint32_t)raw[1] << 4) | (raw[2] >> 4));
+    int32_t adc_h = (int32_t)((raw[3] << 8) | raw[4]);
+
+    // Reset values: the conversion did not run
+    if (adc_t == 0x80000 || adc_h == 0x8000) {
+        return AMBIENT_CODEC_ERR_SKIPPED;
+    }
+
+    // Temperature (datasheet 4.2.3, resolution 0.01 °C)
+    int32_t var1 = ((((adc_t >> 3) - ((int32_t)calib->dig_t1 << 1))) *
+                    ((int32_t)calib->dig_t2)) >> 11;
+    int32_t var2 = (((((adc_t >> 4) - ((int32_t)calib->dig_t1)) *
+                      ((adc_t >> 4) - ((int32_t)calib->dig_t1))) >> 12) *
+                    ((int32_t)calib->dig_t3)) >> 14;
+    int32_t t_fine = var1 + var2;
+    int32_t t_centi = (t_fine * 5 + 128) >> 8;
+
+    // Humidity (datasheet 4.2.3, Q22.10 %RH)
+    int32_t v = t_fine - ((int32_t)76800);
+    v = (((((adc_h << 14) - (((int32_t)calib->dig_h4) << 20) -
+            (((int32_t)calib->dig_h5) * v)) + ((int32_t)16384)) >> 15) *
+         (((((((v * ((int32_t)calib->dig_h6)) >> 10) *
+              (((v * ((int32_t)calib->dig_h3)) >> 11) + ((int32_t)32768))) >> 10) +
+            ((int32_t)2097152)) * ((int32_t)calib->dig_h2) + 8192) >> 14));
+    v = (v - (((((v >> 15) * (v >> 15)) >> 7) * ((int32_t)calib->dig_h1)) >> 4));
+    v = (v < 0) ? 0 : v;
+    v = (v > 419430400) ? 419430400 : v;
+    uint32_t h_q10 = (uint32_t)(v >> 12);
+
+    *temperature = (float)t_centi / 100.0f;
+    *humidity = (float)h_q10 / 1024.0f;
+
+    return ambient_check_range(*temperature, *humidity);
+}
@@ -0,0 +1,109 @@
+/**
+ * @file ambient_codec.h
+ * @brief SHT3x / BME280 data decoding - CRC, compensation and range checks
+ *
+ * Pure C with no ESP-IDF dependencies, so conversions can be checked on a
+ * host against datasheet examples.
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef AMBIENT_CODEC_H
+#define AMBIENT_CODEC_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================ CONSTANTS ============================ */
+
+#define SHT3X_MEASUREMENT_LEN           6       ///< T(2) + CRC + RH(2) + CRC
+#define BME280_CALIB_TP_LEN             26      ///< Registers 0x88..0xA1
+#define BME280_CALIB_H_LEN              7       ///< Registers 0xE1..0xE7
+#define BME280_DATA_TH_LEN              5       ///< Registers 0xFA..0xFE (temperature + humidity)
+
+#define AMBIENT_TEMPERATURE_MIN         -40.0f  ///< Sensor operating range
+#define AMBIENT_TEMPERATURE_MAX         85.0f
+
+/**
+ * @brief Decode result
+ */
+typedef enum {
+    AMBIENT_CODEC_OK = 0,               ///< Values decoded
+    AMBIENT_CODEC_ERR_CRC,              ///< CRC mismatch (SHT3x)
+    AMBIENT_CODEC_ERR_SKIPPED,          ///< Measurement not performed (BME280 reset value)
+    AMBIENT_CODEC_ERR_RANGE             ///< Decoded value outside sensor range
+} ambient_codec_result_t;
+
+/**
+ * @brief BME280 trimming parameters (temperature and humidity only)
+ */
+typedef struct {
+    uint16_t dig_t1;
+    int16_t dig_t2;
+    int16_t dig_t3;
+    uint8_t dig_h1;
+    int16_t dig_h2;
+    uint8_t dig_h3;
+    int16_t dig_h4;
+    int16_t dig_h5;
+    int8_t dig_h6;
+} bme280_calib_t;
+
+/* ============================ API ============================ */
+
+/**
+ * @brief Sensirion CRC-8 (poly 0x31, init 0xFF)
+ *
+ * @param data Bytes to check
+ * @param len Number of bytes (2 for SHT3x words)
+ * @return CRC byte
+ */
+uint8_t sht3x_crc8(const uint8_t *data, uint8_t len);
+
+/**
+ * @brief Decode an SHT3x single-shot measurement
+ *
+ * @param rx Raw bytes read after the conversion
+ * @param[out] temperature °C
+ * @param[out] humidity %RH
+ * @return AMBIENT_CODEC_OK or error
+ */
+ambient_codec_result_t sht3x_decode(const uint8_t rx[SHT3X_MEASUREMENT_LEN],
+                                    float *temperature, float *humidity);
+
+/**
+ * @brief Parse BME280 trimming registers
+ *
+ * @param tp Registers 0x88..0xA1
+ * @param h Registers 0xE1..0xE7
+ * @param[out] calib Parsed parameters
+ */
+void bme280_parse_calib(const uint8_t tp[BME280_CALIB_TP_LEN],
+                        const uint8_t h[BME280_CALIB_H_LEN],
+                        bme280_calib_t *calib);
+
+/**
+ * @brief Compensate a BME280 temperature/humidity burst read
+ *
+ * Uses the 32-bit integer formulas from the Bosch datasheet.
+ *
+ * @param calib Trimming parameters
+ * @param raw Registers 0xFA..0xFE
+ * @param[out] temperature °C
+ * @param[out] humidity %RH
+ * @return AMBIENT_CODEC_OK or error
+ */
+ambient_codec_result_t bme280_decode(const bme280_calib_t *calib,
+                                     const uint8_t raw[BME280_DATA_TH_LEN],
+                                     float *temperature, float *humidity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AMBIENT_CODEC_H
@@ -0,0 +1,198 @@
+/**
+ * @file bme280.c
+ * @brief Ambient backend for Bosch BME280 on I2C
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "bme280.h"
+#include "i2c_ambient_bus.h"
+#include "ambient_codec.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+
+/* ============================ CONFIGURATION ============================ */
+
+#ifndef CONFIG_SENSOR_BME280_ADDRESS
+#define CONFIG_SENSOR_BME280_ADDRESS 0x76
+#endif
+
+#define BME280_REG_CALIB_TP             0x88
+#define BME280_REG_CHIP_ID              0xD0
+#define BME280_REG_RESET                0xE0
+#define BME280_REG_CALIB_H              0xE1
+#define BME280_REG_CTRL_HUM             0xF2
+#define BME280_REG_STATUS               0xF3
+#define BME280_REG_CTRL_MEAS            0xF4
+#define BME280_REG_CONFIG               0xF5
+#define BME280_REG_TEMP_MSB             0xFA
+
+#define BME280_CHIP_ID                  0x60
+#define BME280_RESET_CMD                0xB6
+#define BME280_STATUS_MEASURING         0x08
+#define BME280_STATUS_IM_UPDATE         0x01
+
+#define BME280_CTRL_HUM_X1              0x01
+#define BME280_CTRL_MEAS_FORCED         ((0x01 << 5) | (0x00 << 2) | 0x01)  ///< osrs_t x1, osrs_p skip, forced
+
+#define BME280_STARTUP_TIME_MS          3
+#define BME280_CONVERSION_TIME_MS       7       ///< Datasheet max 6.4 ms for T x1 + H x1
+#define BME280_POLL_RETRIES             3
+#define BME280_POLL_MS                  2
+
+/* ============================ PRIVATE STATE ============================ */
+
+static const char *TAG = "bme280";
+
+static i2c_master_dev_handle_t s_dev = NULL;
+static bme280_calib_t s_calib;
+
+/* ============================ PRIVATE FUNCTIONS ============================ */
+
+static esp_err_t bme280_read_regs(uint8_t reg, uint8_t *buf, size_t len)
+{
+    return i2c_master_transmit_receive(s_dev, &reg, 1, buf, len, I2C_AMBIENT_XFER_TIMEOUT_MS);
+}
+
+static esp_err_t bme280_write_reg(uint8_t reg, uint8_t value)
+{
+    const uint8_t tx[2] = { reg, value };
+    return i2c_master_transmit(s_dev, tx, sizeof(tx), I2C_AMBIENT_XFER_TIMEOUT_MS);
+}
+
+/**
+ * @brief Wait until the given status bits clear
+ */
+static esp_err_t bme280_wait_status_clear(uint8_t mask)
+{
+    for (int attempt = 0; attempt <= BME280_POLL_RETRIES; attempt++) {
+        uint8_t status;
+        esp_err_t ret = bme280_read_regs(BME280_REG_STATUS, &status, 1);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        if ((status & mask) == 0) {
+            return ESP_OK;
+        }
+        i2c_ambient_wait_ms(BME280_POLL_MS);
+    }
+    return ESP_ERR_TIMEOUT;
+}
+
+static esp_err_t bme280_setup(void)
+{
+    uint8_t chip_id = 0;
+    esp_err_t ret = bme280_read_regs(BME280_REG_CHIP_ID, &chip_id, 1);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (chip_id != BME280_CHIP_ID) {
+        ESP_LOGE(TAG, "Unexpected chip id 0x%02x (BMP280 has no humidity sensor)", chip_id);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    ret = bme280_write_reg(BME280_REG_RESET, BME280_RESET_CMD);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    i2c_ambient_wait_ms(BME280_STARTUP_TIME_MS);
+
+    ret = bme280_wait_status_clear(BME280_STATUS_IM_UPDATE);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    uint8_t calib_tp[BME280_CALIB_TP_LEN];
+    uint8_t calib_h[BME280_CALIB_H_LEN];
+    ret = bme280_read_regs(BME280_REG_CALIB_TP, calib_tp, sizeof(calib_tp));
+    if (ret == ESP_OK) {
+        ret = bme280_read_regs(BME280_REG_CALIB_H, calib_h, sizeof(calib_h));
+    }
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    bme280_parse_calib(calib_tp, calib_h, &s_calib);
+
+    // ctrl_hum only takes effect after the next ctrl_meas write (in read)
+    ret = bme280_write_reg(BME280_REG_CTRL_HUM, BME280_CTRL_HUM_X1);
+    if (ret == ESP_OK) {
+        ret = bme280_write_reg(BME280_REG_CONFIG, 0x00);   // IIR filter off
+    }
+    return ret;
+}
+
+/* ============================ BACKEND OPERATIONS ============================ */
+
+static esp_err_t bme280_init(const sensor_config_t *config)
+{
+    (void)config;
+
+    esp_err_t ret = i2c_ambient_bus_add_device(CONFIG_SENSOR_BME280_ADDRESS, &s_dev);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    ret = bme280_setup();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Setup failed: %s", esp_err_to_name(ret));
+        i2c_ambient_bus_remove_device(s_dev);
+        s_dev = NULL;
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "BME280 ready at 0x%02x", CONFIG_SENSOR_BME280_ADDRESS);
+    return ESP_OK;
+}
+
+static esp_err_t bme280_read(ambient_data_t *data)
+{
+    if (s_dev == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t ret = bme280_write_reg(BME280_REG_CTRL_MEAS, BME280_CTRL_MEAS_FORCED);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // Sleep through the conversion, then confirm it finished
+    i2c_ambient_wait_ms(BME280_CONVERSION_TIME_MS);
+    ret = bme280_wait_status_clear(BME280_STATUS_MEASURING);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    uint8_t raw[BME280_DATA_TH_LEN];
+    ret = bme280_read_regs(BME280_REG_TEMP_MSB, raw, sizeof(raw));
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    if (bme280_decode(&s_calib, raw, &data->temperature, &data->humidity) != AMBIENT_CODEC_OK) {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+
+    return ESP_OK;
+}
+
+static esp_err_t bme280_deinit(void)
+{
+    esp_err_t ret = i2c_ambient_bus_remove_device(s_dev);
+    s_dev = NULL;
+    return ret;
+}
+
+static const sensor_ambient_backend_t s_bme280_backend = {
+    .name = "bme280",
+    .init = bme280_init,
+    .read = bme280_read,
+    .deinit = bme280_deinit,
+    .min_interval_ms = 1000,    // Limits self-heating
+};
+
+const sensor_ambient_backend_t *bme280_ambient_backend(void)
+{
+    return &s_bme280_backend;
+}
@@ -0,0 +1,36 @@
+/**
+ * @file bme280.h
+ * @brief Ambient backend for Bosch BME280 on I2C
+ *
+ * Forced mode with x1 oversampling for temperature and humidity
+ * (pressure skipped): each read triggers one conversion, the task sleeps
+ * for the conversion time and fetches the burst registers afterwards.
+ * The BME280 has no data CRC; reads are validated through the status
+ * register, the "skipped" reset values and range checks instead.
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef BME280_H
+#define BME280_H
+
+#include "sensor_reader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Get the BME280 ambient backend (address via CONFIG_SENSOR_BME280_ADDRESS)
+ *
+ * @return Backend operations table
+ */
+const sensor_ambient_backend_t *bme280_ambient_backend(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BME280_H
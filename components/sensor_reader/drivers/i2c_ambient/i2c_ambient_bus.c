@@ -0,0 +1,117 @@
+/**
+ * @file i2c_ambient_bus.c
+ * @brief Shared I2C master bus for ambient sensors
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "i2c_ambient_bus.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/* ============================ CONFIGURATION ============================ */
+
+#ifndef CONFIG_SENSOR_I2C_PORT
+#define CONFIG_SENSOR_I2C_PORT 0
+#endif
+
+#ifndef CONFIG_SENSOR_I2C_SDA_GPIO
+#define CONFIG_SENSOR_I2C_SDA_GPIO 32
+#endif
+
+#ifndef CONFIG_SENSOR_I2C_SCL_GPIO
+#define CONFIG_SENSOR_I2C_SCL_GPIO 33
+#endif
+
+#ifndef CONFIG_SENSOR_I2C_FREQ_HZ
+#define CONFIG_SENSOR_I2C_FREQ_HZ 100000
+#endif
+
+/* ============================ PRIVATE STATE ============================ */
+
+static const char *TAG = "i2c_ambient";
+
+// Only touched from sensor_reader init/deinit (single task)
+static i2c_master_bus_handle_t s_bus = NULL;
+static uint8_t s_device_count = 0;
+
+/* ============================ PUBLIC API ============================ */
+
+esp_err_t i2c_ambient_bus_add_device(uint8_t address, i2c_master_dev_handle_t *dev)
+{
+    if (dev == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (s_bus == NULL) {
+        i2c_master_bus_config_t bus_cfg = {
+            .i2c_port = CONFIG_SENSOR_I2C_PORT,
+            .sda_io_num = CONFIG_SENSOR_I2C_SDA_GPIO,
+            .scl_io_num = CONFIG_SENSOR_I2C_SCL_GPIO,
+            .clk_source = I2C_CLK_SRC_DEFAULT,
+            .glitch_ignore_cnt = 7,
+            .trans_queue_depth = 0,     // Synchronous transfers
+            .flags.enable_internal_pullup = true,
+        };
+        esp_err_t ret = i2c_new_master_bus(&bus_cfg, &s_bus);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to create I2C bus: %s", esp_err_to_name(ret));
+            return ret;
+        }
+        ESP_LOGI(TAG, "I2C bus %d ready (SDA=%d, SCL=%d, %d Hz)",
+                 CONFIG_SENSOR_I2C_PORT, CONFIG_SENSOR_I2C_SDA_GPIO,
+                 CONFIG_SENSOR_I2C_SCL_GPIO, CONFIG_SENSOR_I2C_FREQ_HZ);
+    }
+
+    esp_err_t ret = i2c_master_probe(s_bus, address, I2C_AMBIENT_XFER_TIMEOUT_MS);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "No device at 0x%02x: %s", address, esp_err_to_name(ret));
+        ret = ESP_ERR_NOT_FOUND;
+    } else {
+        i2c_device_config_t dev_cfg = {
+            .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+            .device_address = address,
+            .scl_speed_hz = CONFIG_SENSOR_I2C_FREQ_HZ,
+        };
+        ret = i2c_master_bus_add_device(s_bus, &dev_cfg, dev);
+    }
+
+    if (ret == ESP_OK) {
+        s_device_count++;
+    } else if (s_device_count == 0) {
+        i2c_del_master_bus(s_bus);
+        s_bus = NULL;
+    }
+
+    return ret;
+}
+
+esp_err_t i2c_ambient_bus_remove_device(i2c_master_dev_handle_t dev)
+{
+    if (dev == NULL) {
+        return ESP_OK;
+    }
+
+    esp_err_t ret = i2c_master_bus_rm_device(dev);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    if (s_device_count > 0 && --s_device_count == 0 && s_bus != NULL) {
+        ret = i2c_del_master_bus(s_bus);
+        s_bus = NULL;
+    }
+
+    return ret;
+}
+
+void i2c_ambient_wait_ms(uint32_t ms)
+{
+    // vTaskDelay(n) may return up to one tick early: add one
+    TickType_t ticks = (ms + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS;
+    vTaskDelay(ticks + 1);
+}
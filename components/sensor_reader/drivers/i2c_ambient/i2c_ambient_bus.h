@@ -0,0 +1,60 @@
+/**
+ * @file i2c_ambient_bus.h
+ * @brief Shared I2C master bus for ambient sensors
+ *
+ * Thin wrapper over the ESP-IDF i2c_master driver in synchronous mode
+ * (interrupt driven, no DMA, no critical sections held across a
+ * transfer). The calling task blocks on the driver semaphore while bytes
+ * move and sleeps with vTaskDelay() during sensor conversions.
+ *
+ * Configuration:
+ * - CONFIG_SENSOR_I2C_PORT, CONFIG_SENSOR_I2C_SDA_GPIO, CONFIG_SENSOR_I2C_SCL_GPIO
+ * - CONFIG_SENSOR_I2C_FREQ_HZ
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef I2C_AMBIENT_BUS_H
+#define I2C_AMBIENT_BUS_H
+
+#include "esp_err.h"
+#include "driver/i2c_master.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define I2C_AMBIENT_XFER_TIMEOUT_MS     20      ///< Per-transfer timeout
+
+/**
+ * @brief Create the bus (if needed) and attach a device
+ *
+ * @param address 7-bit device address
+ * @param[out] dev Device handle
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if the device does not ACK
+ */
+esp_err_t i2c_ambient_bus_add_device(uint8_t address, i2c_master_dev_handle_t *dev);
+
+/**
+ * @brief Detach a device; the bus is deleted with the last one
+ *
+ * @param dev Device handle (NULL is ignored)
+ * @return ESP_OK on success
+ */
+esp_err_t i2c_ambient_bus_remove_device(i2c_master_dev_handle_t dev);
+
+/**
+ * @brief Sleep for at least ms milliseconds (rounded up to whole ticks)
+ *
+ * @param ms Minimum delay
+ */
+void i2c_ambient_wait_ms(uint32_t ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // I2C_AMBIENT_BUS_H
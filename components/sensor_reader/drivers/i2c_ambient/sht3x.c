@@ -0,0 +1,122 @@
+/**
+ * @file sht3x.c
+ * @brief Ambient backend for Sensirion SHT30/31/35 on I2C
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "sht3x.h"
+#include "i2c_ambient_bus.h"
+#include "ambient_codec.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+
+/* ============================ CONFIGURATION ============================ */
+
+#ifndef CONFIG_SENSOR_SHT3X_ADDRESS
+#define CONFIG_SENSOR_SHT3X_ADDRESS 0x44
+#endif
+
+#define SHT3X_CMD_SOFT_RESET            0x30A2
+#define SHT3X_CMD_SINGLE_SHOT_HIGH      0x2400  ///< High repeatability, no clock stretching
+#define SHT3X_RESET_TIME_MS             2
+#define SHT3X_CONVERSION_TIME_MS        16      ///< Datasheet max 15.5 ms
+#define SHT3X_FETCH_RETRIES             2       ///< Extra polls if the sensor NACKs (still converting)
+#define SHT3X_FETCH_RETRY_MS            2
+
+/* ============================ PRIVATE STATE ============================ */
+
+static const char *TAG = "sht3x";
+
+static i2c_master_dev_handle_t s_dev = NULL;
+
+/* ============================ PRIVATE FUNCTIONS ============================ */
+
+static esp_err_t sht3x_command(uint16_t command)
+{
+    const uint8_t tx[2] = { (uint8_t)(command >> 8), (uint8_t)(command & 0xFF) };
+    return i2c_master_transmit(s_dev, tx, sizeof(tx), I2C_AMBIENT_XFER_TIMEOUT_MS);
+}
+
+/* ============================ BACKEND OPERATIONS ============================ */
+
+static esp_err_t sht3x_init(const sensor_config_t *config)
+{
+    (void)config;
+
+    esp_err_t ret = i2c_ambient_bus_add_device(CONFIG_SENSOR_SHT3X_ADDRESS, &s_dev);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    ret = sht3x_command(SHT3X_CMD_SOFT_RESET);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Soft reset failed: %s", esp_err_to_name(ret));
+        i2c_ambient_bus_remove_device(s_dev);
+        s_dev = NULL;
+        return ret;
+    }
+    i2c_ambient_wait_ms(SHT3X_RESET_TIME_MS);
+
+    ESP_LOGI(TAG, "SHT3x ready at 0x%02x", CONFIG_SENSOR_SHT3X_ADDRESS);
+    return ESP_OK;
+}
+
+static esp_err_t sht3x_read(ambient_data_t *data)
+{
+    if (s_dev == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t ret = sht3x_command(SHT3X_CMD_SINGLE_SHOT_HIGH);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // Sleep through the conversion instead of holding the bus
+    i2c_ambient_wait_ms(SHT3X_CONVERSION_TIME_MS);
+
+    uint8_t rx[SHT3X_MEASUREMENT_LEN];
+    for (int attempt = 0; attempt <= SHT3X_FETCH_RETRIES; attempt++) {
+        ret = i2c_master_receive(s_dev, rx, sizeof(rx), I2C_AMBIENT_XFER_TIMEOUT_MS);
+        if (ret == ESP_OK) {
+            break;
+        }
+        i2c_ambient_wait_ms(SHT3X_FETCH_RETRY_MS);
+    }
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    ambient_codec_result_t result = sht3x_decode(rx, &data->temperature, &data->humidity);
+    if (result == AMBIENT_CODEC_ERR_CRC) {
+        return ESP_ERR_INVALID_CRC;
+    }
+    if (result != AMBIENT_CODEC_OK) {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+
+    return ESP_OK;
+}
+
+static esp_err_t sht3x_deinit(void)
+{
+    esp_err_t ret = i2c_ambient_bus_remove_device(s_dev);
+    s_dev = NULL;
+    return ret;
+}
+
+static const sensor_ambient_backend_t s_sht3x_backend = {
+    .name = "sht3x",
+    .init = sht3x_init,
+    .read = sht3x_read,
+    .deinit = sht3x_deinit,
+    .min_interval_ms = 1000,    // Limits self-heating
+};
+
+const sensor_ambient_backend_t *sht3x_ambient_backend(void)
+{
+    return &s_sht3x_backend;
+}
@@ -0,0 +1,34 @@
+/**
+ * @file sht3x.h
+ * @brief Ambient backend for Sensirion SHT30/31/35 on I2C
+ *
+ * Single-shot, high repeatability, clock stretching disabled: the
+ * measurement command is sent, the task sleeps for the conversion time
+ * and the result (two CRC-protected words) is fetched afterwards.
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef SHT3X_H
+#define SHT3X_H
+
+#include "sensor_reader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Get the SHT3x ambient backend (address via CONFIG_SENSOR_SHT3X_ADDRESS)
+ *
+ * @return Backend operations table
+ */
+const sensor_ambient_backend_t *sht3x_ambient_backend(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SHT3X_H
@@ -0,0 +1,262 @@
+/**
+ * @file modbus_rtu.c
+ * @brief Modbus RTU master over RS-485 (UART half-duplex)
+ *
+ * The UART hardware drives DE through RTS (UART_MODE_RS485_HALF_DUPLEX),
+ * so no GPIO toggling or turnaround delay is needed in software. The ESP32
+ * UART has no general-purpose DMA; the RX FIFO timeout interrupt (set to
+ * the Modbus inter-frame gap) hands each complete response to the driver
+ * buffer in one go, and the master reads exactly the expected frame length.
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "modbus_rtu.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/portmacro.h"
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+/* ============================ CONSTANTS ============================ */
+
+#define MODBUS_RTU_RX_BUFFER_SIZE       512
+#define MODBUS_RTU_FRAME_MAX            MODBUS_RTU_READ_RESPONSE_LEN(MODBUS_RTU_MAX_READ_REGS)
+#define MODBUS_RTU_RX_TIMEOUT_SYMBOLS   4       ///< ~3.5 characters of silence ends a frame
+#define MODBUS_RTU_GAP_FIXED_US         1750    ///< Spec: fixed gap above 19200 baud
+
+/* ============================ PRIVATE STATE ============================ */
+
+static const char *TAG = "modbus_rtu";
+
+typedef struct {
+    bool initialized;
+    modbus_rtu_config_t config;
+    SemaphoreHandle_t bus_lock;
+    uint32_t frame_gap_us;
+    modbus_rtu_stats_t stats;
+} modbus_rtu_context_t;
+
+static modbus_rtu_context_t s_bus = {0};
+
+static portMUX_TYPE s_stats_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+/* ============================ PRIVATE FUNCTIONS ============================ */
+
+/**
+ * @brief 3.5 character times of 11 bits (start + 8 data + parity/stop)
+ */
+static uint32_t modbus_rtu_frame_gap_us(uint32_t baud_rate)
+{
+    if (baud_rate > 19200) {
+        return MODBUS_RTU_GAP_FIXED_US;
+    }
+    return 38500000UL / baud_rate;
+}
+
+static esp_err_t modbus_rtu_transact(modbus_rtu_request_t *request)
+{
+    uint8_t frame[MODBUS_RTU_FRAME_MAX];
+    uart_port_t uart = s_bus.config.uart_num;
+
+    size_t len = modbus_rtu_build_read_request(request->address, request->function,
+                                               request->start, request->count, frame);
+    if (len == 0 || request->regs == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uart_flush_input(uart);
+    if (uart_write_bytes(uart, frame, len) != (int)len) {
+        return ESP_FAIL;
+    }
+
+    portENTER_CRITICAL(&s_stats_spinlock);
+    s_bus.stats.transactions++;
+    portEXIT_CRITICAL(&s_stats_spinlock);
+
+    // Header first: an exception response is only 5 bytes long
+    TickType_t timeout = pdMS_TO_TICKS(s_bus.config.response_timeout_ms);
+    int received = uart_read_bytes(uart, frame, MODBUS_RTU_EXCEPTION_LEN, timeout);
+    if (received < MODBUS_RTU_EXCEPTION_LEN) {
+        portENTER_CRITICAL(&s_stats_spinlock);
+        s_bus.stats.timeouts++;
+        portEXIT_CRITICAL(&s_stats_spinlock);
+        return ESP_ERR_TIMEOUT;
+    }
+
+    size_t expected = (frame[1] & MODBUS_RTU_FC_EXCEPTION_BIT) ?
+                      MODBUS_RTU_EXCEPTION_LEN : MODBUS_RTU_READ_RESPONSE_LEN(request->count);
+    if (expected > (size_t)received) {
+        int rest = uart_read_bytes(uart, frame + received, expected - received, timeout);
+        if (rest < (int)(expected - received)) {
+            portENTER_CRITICAL(&s_stats_spinlock);
+            s_bus.stats.timeouts++;
+            portEXIT_CRITICAL(&s_stats_spinlock);
+            return ESP_ERR_TIMEOUT;
+        }
+        received += rest;
+    }
+
+    uint8_t exception_code = 0;
+    modbus_rtu_frame_result_t result = modbus_rtu_parse_read_response(frame, received,
+                                                                      request->address,
+                                                                      request->function,
+                                                                      request->count,
+                                                                      request->regs,
+                                                                      &exception_code);
+    switch (result) {
+        case MODBUS_RTU_FRAME_OK:
+            return ESP_OK;
+
+        case MODBUS_RTU_FRAME_ERR_CRC:
+            portENTER_CRITICAL(&s_stats_spinlock);
+            s_bus.stats.crc_errors++;
+            portEXIT_CRITICAL(&s_stats_spinlock);
+            return ESP_ERR_INVALID_CRC;
+
+        case MODBUS_RTU_FRAME_ERR_EXCEPTION:
+            portENTER_CRITICAL(&s_stats_spinlock);
+            s_bus.stats.exceptions++;
+            portEXIT_CRITICAL(&s_stats_spinlock);
+            ESP_LOGW(TAG, "Slave %d exception 0x%02X", request->address, exception_code);
+            return ESP_ERR_INVALID_RESPONSE;
+
+        default:
+            ESP_LOGW(TAG, "Slave %d bad frame (%d)", request->address, result);
+            return ESP_ERR_INVALID_RESPONSE;
+    }
+}
+
+/* ============================ PUBLIC API ============================ */
+
+esp_err_t modbus_rtu_init(const modbus_rtu_config_t *config)
+{
+    if (config == NULL || config->baud_rate == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (s_bus.initialized) {
+        return ESP_OK;
+    }
+
+    s_bus.bus_lock = xSemaphoreCreateMutex();
+    if (s_bus.bus_lock == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    const uart_config_t uart_cfg = {
+        .baud_rate = (int)config->baud_rate,
+        .data_bits = UART_DATA_8_BITS,
+        .parity = UART_PARITY_DISABLE,
+        .stop_bits = UART_STOP_BITS_1,
+        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
+        .source_clk = UART_SCLK_DEFAULT,
+    };
+
+    esp_err_t ret = uart_driver_install(config->uart_num, MODBUS_RTU_RX_BUFFER_SIZE, 0, 0, NULL, 0);
+    if (ret == ESP_OK) {
+        ret = uart_param_config(config->uart_num, &uart_cfg);
+    }
+    if (ret == ESP_OK) {
+        ret = uart_set_pin(config->uart_num, config->tx_gpio, config->rx_gpio,
+                           config->de_gpio, UART_PIN_NO_CHANGE);
+    }
+    if (ret == ESP_OK) {
+        ret = uart_set_mode(config->uart_num, UART_MODE_RS485_HALF_DUPLEX);
+    }
+    if (ret == ESP_OK) {
+        ret = uart_set_rx_timeout(config->uart_num, MODBUS_RTU_RX_TIMEOUT_SYMBOLS);
+    }
+
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "UART%d setup failed: %s", config->uart_num, esp_err_to_name(ret));
+        if (uart_is_driver_installed(config->uart_num)) {
+            uart_driver_delete(config->uart_num);
+        }
+        vSemaphoreDelete(s_bus.bus_lock);
+        s_bus.bus_lock = NULL;
+        return ret;
+    }
+
+    s_bus.config = *config;
+    s_bus.frame_gap_us = modbus_rtu_frame_gap_us(config->baud_rate);
+    memset(&s_bus.stats, 0, sizeof(s_bus.stats));
+    s_bus.initialized = true;
+
+    ESP_LOGI(TAG, "RS-485 bus on UART%d (TX=%d RX=%d DE=%d) at %" PRIu32 " baud, gap %" PRIu32 " us",
+             config->uart_num, config->tx_gpio, config->rx_gpio, config->de_gpio,
+             config->baud_rate, s_bus.frame_gap_us);
+    return ESP_OK;
+}
+
+esp_err_t modbus_rtu_deinit(void)
+{
+    if (!s_bus.initialized) {
+        return ESP_OK;
+    }
+
+    xSemaphoreTake(s_bus.bus_lock, portMAX_DELAY);
+    uart_driver_delete(s_bus.config.uart_num);
+    s_bus.initialized = false;
+    xSemaphoreGive(s_bus.bus_lock);
+
+    vSemaphoreDelete(s_bus.bus_lock);
+    s_bus.bus_lock = NULL;
+    return ESP_OK;
+}
+
+esp_err_t modbus_rtu_read_batch(modbus_rtu_request_t *requests, size_t count)
+{
+    if (!s_bus.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (requests == NULL || count == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    size_t ok_count = 0;
+
+    xSemaphoreTake(s_bus.bus_lock, portMAX_DELAY);
+    int64_t cycle_start = esp_timer_get_time();
+
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0) {
+            // Inter-frame silence before addressing the next slave
+            esp_rom_delay_us(s_bus.frame_gap_us);
+        }
+
+        requests[i].result = modbus_rtu_transact(&requests[i]);
+        if (requests[i].result == ESP_OK) {
+            ok_count++;
+        }
+    }
+
+    uint32_t cycle_us = (uint32_t)(esp_timer_get_time() - cycle_start);
+    xSemaphoreGive(s_bus.bus_lock);
+
+    portENTER_CRITICAL(&s_stats_spinlock);
+    s_bus.stats.last_cycle_us = cycle_us;
+    portEXIT_CRITICAL(&s_stats_spinlock);
+
+    return (ok_count > 0) ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t modbus_rtu_get_stats(modbus_rtu_stats_t *stats)
+{
+    if (stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&s_stats_spinlock);
+    *stats = s_bus.stats;
+    portEXIT_CRITICAL(&s_stats_spinlock);
+
+    return ESP_OK;
+}
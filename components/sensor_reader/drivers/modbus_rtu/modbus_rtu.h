@@ -0,0 +1,111 @@
+/**
+ * @file modbus_rtu.h
+ * @brief Modbus RTU master over RS-485 (UART half-duplex)
+ *
+ * Minimal read-only master for sensor probes. A bus cycle runs a batch of
+ * read requests back to back: each request goes out as soon as the previous
+ * response is complete (its length is known in advance) plus the 3.5
+ * character inter-frame gap, instead of waiting for a fixed poll period.
+ *
+ * Thread-Safety:
+ * - Bus access serialized by a mutex; safe to call from multiple tasks
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef MODBUS_RTU_H
+#define MODBUS_RTU_H
+
+#include "esp_err.h"
+#include "driver/uart.h"
+#include "modbus_rtu_frame.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================ TYPES ============================ */
+
+/**
+ * @brief Bus configuration
+ */
+typedef struct {
+    uart_port_t uart_num;           ///< UART peripheral
+    int tx_gpio;                    ///< UART TX (transceiver DI)
+    int rx_gpio;                    ///< UART RX (transceiver RO)
+    int de_gpio;                    ///< Driver enable (RTS, transceiver DE/RE)
+    uint32_t baud_rate;             ///< Baud rate (8N1)
+    uint32_t response_timeout_ms;   ///< Max wait for a slave response
+} modbus_rtu_config_t;
+
+/**
+ * @brief One read request of a bus cycle
+ */
+typedef struct {
+    uint8_t address;                ///< Slave address
+    uint8_t function;               ///< MODBUS_RTU_FC_READ_HOLDING / _INPUT
+    uint16_t start;                 ///< First register
+    uint16_t count;                 ///< Number of registers
+    uint16_t *regs;                 ///< [out] Decoded registers (count entries)
+    esp_err_t result;               ///< [out] ESP_OK, ESP_ERR_TIMEOUT, ESP_ERR_INVALID_CRC, ESP_ERR_INVALID_RESPONSE
+} modbus_rtu_request_t;
+
+/**
+ * @brief Bus statistics
+ */
+typedef struct {
+    uint32_t transactions;          ///< Requests sent
+    uint32_t timeouts;              ///< No or incomplete response
+    uint32_t crc_errors;            ///< Bad CRC
+    uint32_t exceptions;            ///< Exception responses
+    uint32_t last_cycle_us;         ///< Duration of the last batch
+} modbus_rtu_stats_t;
+
+/* ============================ API ============================ */
+
+/**
+ * @brief Install the UART driver in RS-485 half-duplex mode
+ *
+ * @param config Bus configuration
+ * @return ESP_OK on success, error from the UART driver otherwise
+ */
+esp_err_t modbus_rtu_init(const modbus_rtu_config_t *config);
+
+/**
+ * @brief Remove the UART driver
+ *
+ * @return ESP_OK on success
+ */
+esp_err_t modbus_rtu_deinit(void);
+
+/**
+ * @brief Run a batch of read requests in one bus cycle
+ *
+ * Each request's result field is set; a failing slave does not abort
+ * the cycle.
+ *
+ * @param requests Requests to run in order
+ * @param count Number of requests
+ * @return ESP_OK if at least one request succeeded
+ * @return ESP_ERR_INVALID_STATE if not initialized
+ * @return ESP_FAIL if every request failed
+ */
+esp_err_t modbus_rtu_read_batch(modbus_rtu_request_t *requests, size_t count);
+
+/**
+ * @brief Get bus statistics
+ *
+ * @param[out] stats Statistics
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if stats is NULL
+ */
+esp_err_t modbus_rtu_get_stats(modbus_rtu_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MODBUS_RTU_H
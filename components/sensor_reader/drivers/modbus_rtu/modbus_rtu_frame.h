@@ -0,0 +1,92 @@
+/**
+ * @file modbus_rtu_frame.h
+ * @brief Modbus RTU framing - CRC, request build and response parsing
+ *
+ * Pure C with no ESP-IDF dependencies, so the framing can be built and
+ * exercised on a host against a simulated slave.
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef MODBUS_RTU_FRAME_H
+#define MODBUS_RTU_FRAME_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================ CONSTANTS ============================ */
+
+#define MODBUS_RTU_FC_READ_HOLDING      0x03    ///< Read holding registers
+#define MODBUS_RTU_FC_READ_INPUT        0x04    ///< Read input registers
+#define MODBUS_RTU_FC_EXCEPTION_BIT     0x80    ///< Set in exception responses
+
+#define MODBUS_RTU_MAX_READ_REGS        125     ///< Protocol limit per read
+#define MODBUS_RTU_READ_REQUEST_LEN     8       ///< addr + fc + start(2) + count(2) + crc(2)
+#define MODBUS_RTU_EXCEPTION_LEN        5       ///< addr + fc + code + crc(2)
+#define MODBUS_RTU_READ_RESPONSE_LEN(n) (5 + 2 * (n)) ///< addr + fc + bytes + data + crc(2)
+
+/**
+ * @brief Frame parse result
+ */
+typedef enum {
+    MODBUS_RTU_FRAME_OK = 0,            ///< Valid response, registers decoded
+    MODBUS_RTU_FRAME_ERR_LENGTH,        ///< Truncated or wrong-length frame
+    MODBUS_RTU_FRAME_ERR_CRC,           ///< CRC mismatch
+    MODBUS_RTU_FRAME_ERR_ADDRESS,       ///< Response from a different slave
+    MODBUS_RTU_FRAME_ERR_FUNCTION,      ///< Unexpected function code
+    MODBUS_RTU_FRAME_ERR_EXCEPTION      ///< Slave returned an exception
+} modbus_rtu_frame_result_t;
+
+/* ============================ API ============================ */
+
+/**
+ * @brief Modbus CRC-16 (poly 0xA001, init 0xFFFF)
+ *
+ * @param data Frame bytes
+ * @param len Number of bytes
+ * @return CRC; transmitted low byte first
+ */
+uint16_t modbus_rtu_crc16(const uint8_t *data, size_t len);
+
+/**
+ * @brief Build a read registers request (FC 0x03 / 0x04)
+ *
+ * @param address Slave address (1-247)
+ * @param function MODBUS_RTU_FC_READ_HOLDING or MODBUS_RTU_FC_READ_INPUT
+ * @param start First register
+ * @param count Number of registers (1-125)
+ * @param[out] frame Buffer of at least MODBUS_RTU_READ_REQUEST_LEN bytes
+ * @return Frame length, or 0 on invalid arguments
+ */
+size_t modbus_rtu_build_read_request(uint8_t address, uint8_t function,
+                                     uint16_t start, uint16_t count,
+                                     uint8_t *frame);
+
+/**
+ * @brief Validate a read response and decode its registers
+ *
+ * @param frame Received bytes
+ * @param len Number of received bytes
+ * @param address Expected slave address
+ * @param function Function code of the request
+ * @param count Number of registers requested
+ * @param[out] regs Decoded registers (count entries)
+ * @param[out] exception_code Exception code if MODBUS_RTU_FRAME_ERR_EXCEPTION (may be NULL)
+ * @return Parse result
+ */
+modbus_rtu_frame_result_t modbus_rtu_parse_read_response(const uint8_t *frame, size_t len,
+                                                         uint8_t address, uint8_t function,
+                                                         uint16_t count, uint16_t *regs,
+                                                         uint8_t *exception_code);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MODBUS_RTU_FRAME_H
@@ -0,0 +1,146 @@
+/**
+ * @file modbus_soil_probe.c
+ * @brief Soil backend for multi-depth Modbus RTU probes
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "modbus_soil_probe.h"
+#include "modbus_rtu.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include <string.h>
+#include <sys/param.h>
+
+#if CONFIG_SENSOR_SOIL_BACKEND_MODBUS
+
+/* ============================ CONFIGURATION ============================ */
+
+#if CONFIG_SENSOR_MODBUS_HAS_TEMPERATURE
+#define MODBUS_SOIL_REGS_PER_DEPTH      2
+#else
+#define MODBUS_SOIL_REGS_PER_DEPTH      1
+#endif
+
+#if CONFIG_SENSOR_MODBUS_INPUT_REGISTERS
+#define MODBUS_SOIL_FUNCTION            MODBUS_RTU_FC_READ_INPUT
+#else
+#define MODBUS_SOIL_FUNCTION            MODBUS_RTU_FC_READ_HOLDING
+#endif
+
+#define MODBUS_SOIL_REGS_PER_PROBE      (CONFIG_SENSOR_MODBUS_DEPTHS_PER_PROBE * MODBUS_SOIL_REGS_PER_DEPTH)
+#define MODBUS_SOIL_MOISTURE_SCALE      0.1f
+#define MODBUS_SOIL_TEMPERATURE_SCALE   0.1f
+
+/* ============================ PRIVATE STATE ============================ */
+
+static const char *TAG = "modbus_soil";
+
+static uint16_t s_regs[CONFIG_SENSOR_MODBUS_PROBE_COUNT][MODBUS_SOIL_REGS_PER_PROBE];
+static modbus_rtu_request_t s_requests[CONFIG_SENSOR_MODBUS_PROBE_COUNT];
+static uint8_t s_probe_count = 0;
+
+/* ============================ BACKEND OPERATIONS ============================ */
+
+static esp_err_t modbus_soil_init(const sensor_config_t *config)
+{
+    (void)config;
+
+    const modbus_rtu_config_t bus_cfg = {
+        .uart_num = (uart_port_t)CONFIG_SENSOR_MODBUS_UART_NUM,
+        .tx_gpio = CONFIG_SENSOR_MODBUS_TX_GPIO,
+        .rx_gpio = CONFIG_SENSOR_MODBUS_RX_GPIO,
+        .de_gpio = CONFIG_SENSOR_MODBUS_DE_GPIO,
+        .baud_rate = CONFIG_SENSOR_MODBUS_BAUD_RATE,
+        .response_timeout_ms = CONFIG_SENSOR_MODBUS_TIMEOUT_MS,
+    };
+
+    esp_err_t ret = modbus_rtu_init(&bus_cfg);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // Only poll probes whose channels fit in a soil profile
+    s_probe_count = MIN(CONFIG_SENSOR_MODBUS_PROBE_COUNT,
+                        SOIL_PROFILE_MAX_CHANNELS / CONFIG_SENSOR_MODBUS_DEPTHS_PER_PROBE);
+    if (s_probe_count < CONFIG_SENSOR_MODBUS_PROBE_COUNT) {
+        ESP_LOGW(TAG, "Only %d of %d probes fit in %d channels",
+                 s_probe_count, CONFIG_SENSOR_MODBUS_PROBE_COUNT, SOIL_PROFILE_MAX_CHANNELS);
+    }
+
+    for (uint8_t p = 0; p < s_probe_count; p++) {
+        s_requests[p] = (modbus_rtu_request_t) {
+            .address = (uint8_t)(CONFIG_SENSOR_MODBUS_FIRST_ADDRESS + p),
+            .function = MODBUS_SOIL_FUNCTION,
+            .start = CONFIG_SENSOR_MODBUS_REG_START,
+            .count = MODBUS_SOIL_REGS_PER_PROBE,
+            .regs = s_regs[p],
+            .result = ESP_FAIL,
+        };
+    }
+
+    ESP_LOGI(TAG, "%d probes x %d depths (addresses %d-%d)",
+             s_probe_count, CONFIG_SENSOR_MODBUS_DEPTHS_PER_PROBE,
+             CONFIG_SENSOR_MODBUS_FIRST_ADDRESS,
+             CONFIG_SENSOR_MODBUS_FIRST_ADDRESS + s_probe_count - 1);
+    return ESP_OK;
+}
+
+static esp_err_t modbus_soil_read(soil_profile_t *profile)
+{
+    esp_err_t ret = modbus_rtu_read_batch(s_requests, s_probe_count);
+
+    uint8_t index = 0;
+    for (uint8_t p = 0; p < s_probe_count; p++) {
+        bool probe_ok = (s_requests[p].result == ESP_OK);
+        if (!probe_ok) {
+            ESP_LOGW(TAG, "Probe %d: %s", s_requests[p].address, esp_err_to_name(s_requests[p].result));
+        }
+
+        for (uint8_t d = 0; d < CONFIG_SENSOR_MODBUS_DEPTHS_PER_PROBE; d++, index++) {
+            soil_channel_t *channel = &profile->channels[index];
+            memset(channel, 0, sizeof(*channel));
+            channel->probe_id = s_requests[p].address;
+            channel->depth_cm = (uint16_t)(CONFIG_SENSOR_MODBUS_FIRST_DEPTH_CM +
+                                           d * CONFIG_SENSOR_MODBUS_DEPTH_STEP_CM);
+            if (!probe_ok) {
+                continue;
+            }
+
+            const uint16_t *regs = &s_regs[p][d * MODBUS_SOIL_REGS_PER_DEPTH];
+            float moisture = regs[0] * MODBUS_SOIL_MOISTURE_SCALE;
+            if (moisture <= SOIL_MOISTURE_MAX) {
+                channel->moisture = moisture;
+                channel->flags |= SOIL_CHANNEL_FLAG_VALID;
+            }
+#if CONFIG_SENSOR_MODBUS_HAS_TEMPERATURE
+            channel->temperature = (int16_t)regs[1] * MODBUS_SOIL_TEMPERATURE_SCALE;
+            channel->flags |= SOIL_CHANNEL_FLAG_HAS_TEMP;
+#endif
+        }
+    }
+
+    profile->channel_count = index;
+    return ret;
+}
+
+static esp_err_t modbus_soil_deinit(void)
+{
+    return modbus_rtu_deinit();
+}
+
+static const sensor_soil_backend_t s_modbus_soil_backend = {
+    .name = "modbus",
+    .init = modbus_soil_init,
+    .read = modbus_soil_read,
+    .deinit = modbus_soil_deinit,
+};
+
+const sensor_soil_backend_t *modbus_soil_probe_backend(void)
+{
+    return &s_modbus_soil_backend;
+}
+
+#endif /* CONFIG_SENSOR_SOIL_BACKEND_MODBUS */
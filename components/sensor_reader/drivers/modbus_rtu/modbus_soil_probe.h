@@ -0,0 +1,35 @@
+/**
+ * @file modbus_soil_probe.h
+ * @brief Soil backend for multi-depth Modbus RTU probes
+ *
+ * Register layout per probe, starting at CONFIG_SENSOR_MODBUS_REG_START:
+ * for each depth, moisture in 0.1 % followed (if configured) by
+ * temperature in 0.1 °C as a signed value. Probes are polled in one
+ * bus cycle, one read request per probe.
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef MODBUS_SOIL_PROBE_H
+#define MODBUS_SOIL_PROBE_H
+
+#include "sensor_reader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Get the Modbus probe soil backend (configured via Kconfig)
+ *
+ * @return Backend operations table
+ */
+const sensor_soil_backend_t *modbus_soil_probe_backend(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MODBUS_SOIL_PROBE_H
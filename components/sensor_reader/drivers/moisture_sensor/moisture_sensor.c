@@ -1,5 +1,6 @@
 #include "moisture_sensor.h"
 #include "esp_log.h"
+#include "deferred_log.h"
 #include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -59,6 +60,23 @@ esp_err_t moisture_sensor_init(moisture_sensor_config_t *config) {
     return ESP_OK;
 }
 
+esp_err_t moisture_sensor_deinit(void) {
+    if (!adc_initialized) {
+        return ESP_OK;
+    }
+
+    // Liberar ADC1 (p. ej. para entregarlo al coprocesador ULP)
+    esp_err_t ret = adc_oneshot_del_unit(adc_handle);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Error al liberar el ADC: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    adc_handle = NULL;
+    adc_initialized = false;
+    return ESP_OK;
+}
+
 int sensor_read_raw(adc_channel_t channel) {
     if (!adc_initialized) {
         ESP_LOGE(TAG, "YL69 no inicializado");
@@ -113,7 +131,14 @@ esp_err_t sensor_read_with_raw(
     }
 
     *raw_adc = raw_value;
-    ESP_LOGI(TAG, "Raw ADC Value: %d Channel: %d", raw_value, channel);
+    DLOG_D(TAG, "Raw ADC Value: %d Channel: %d", raw_value, channel);
+    *humidity = sensor_raw_to_percent(raw_value, sensor_type);
+
+    return ESP_OK;
+}
+
+int sensor_raw_to_percent(int raw_adc, groud_sensor_type_t sensor_type)
+{
     // Seleccionar valores de calibración según tipo de sensor
     int value_when_dry;
     int value_when_wet;
@@ -127,11 +152,30 @@ esp_err_t sensor_read_with_raw(
     }
 
     // Calcular porcentaje con mapeo lineal
-    *humidity = map_value(raw_value, value_when_dry, value_when_wet);
+    int humidity = map_value(raw_adc, value_when_dry, value_when_wet);
 
     // Clamp al rango válido (0-100%)
-    if (*humidity < 0) *humidity = 0;
-    if (*humidity > 100) *humidity = 100;
+    if (humidity < HUMIDITY_MIN) humidity = HUMIDITY_MIN;
+    if (humidity > HUMIDITY_MAX) humidity = HUMIDITY_MAX;
 
-    return ESP_OK;
-}
\ No newline at end of file
+    return humidity;
+}
+
+int sensor_percent_to_raw(float humidity, groud_sensor_type_t sensor_type)
+{
+    int value_when_dry;
+    int value_when_wet;
+
+    if (sensor_type == TYPE_YL69) {
+        value_when_dry = VALUE_WHEN_DRY_YL;
+        value_when_wet = VALUE_WHEN_WET_YL;
+    } else {
+        value_when_dry = VALUE_WHEN_DRY_CAP;
+        value_when_wet = VALUE_WHEN_WET_CAP;
+    }
+
+    // Inversa de map_value()
+    return value_when_dry +
+           (int)((humidity - HUMIDITY_MIN) * (value_when_wet - value_when_dry) /
+                 (HUMIDITY_MAX - HUMIDITY_MIN));
+}
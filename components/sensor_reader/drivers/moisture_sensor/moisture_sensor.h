@@ -36,6 +36,14 @@ typedef struct {
 }
 
 esp_err_t moisture_sensor_init(moisture_sensor_config_t *config);
+
+/**
+ * @brief Release ADC1 (all channels)
+ *
+ * @return ESP_OK on success (also if not initialized)
+ */
+esp_err_t moisture_sensor_deinit(void);
+
 int sensor_read_raw(adc_channel_t channel);
 void sensor_read_percentage(adc_channel_t channel, int *humidity, groud_sensor_type_t sensor_type);
 
@@ -59,4 +67,28 @@ esp_err_t sensor_read_with_raw(
     groud_sensor_type_t sensor_type
 );
 
+/**
+ * @brief Convert a raw ADC value to a humidity percentage
+ *
+ * Same calibration as sensor_read_with_raw(), for callers that sample the
+ * ADC themselves (e.g. through an analog multiplexer).
+ *
+ * @param raw_adc Raw ADC value (0-4095)
+ * @param sensor_type Sensor type (TYPE_CAP or TYPE_YL69)
+ * @return Humidity percentage, clamped to 0-100%
+ */
+int sensor_raw_to_percent(int raw_adc, groud_sensor_type_t sensor_type);
+
+/**
+ * @brief Convert a humidity percentage to the raw ADC value that maps to it
+ *
+ * Inverse of the calibration used by sensor_read_with_raw(). Capacitive
+ * sensors read higher raw values in drier soil.
+ *
+ * @param humidity Humidity percentage (0-100%)
+ * @param sensor_type Sensor type (TYPE_CAP or TYPE_YL69)
+ * @return Raw ADC value (not clamped)
+ */
+int sensor_percent_to_raw(float humidity, groud_sensor_type_t sensor_type);
+
 #endif // MOISTURE_SENSOR_H
\ No newline at end of file
@@ -0,0 +1,202 @@
+/**
+ * @file probe_power.c
+ * @brief Switched excitation rails for soil probe groups
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "probe_power.h"
+#include "driver/gpio.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <inttypes.h>
+
+/* ============================ PRIVATE STATE ============================ */
+
+static const char *TAG = "probe_power";
+
+// Only touched from the sensor_reader task
+static probe_power_config_t s_config;
+static bool s_initialized = false;
+static uint8_t s_on_mask = 0;
+static int64_t s_ready_at_us[PROBE_POWER_MAX_GROUPS];
+static uint8_t s_scan_count = 0;        // 0 = scan length unknown
+
+/* ============================ PRIVATE HELPERS ============================ */
+
+static uint8_t group_of(uint8_t channel)
+{
+    uint8_t group = channel / s_config.group_size;
+    return (group < s_config.group_count) ? group : (uint8_t)(s_config.group_count - 1);
+}
+
+static uint8_t group_first_channel(uint8_t group)
+{
+    return (uint8_t)(group * s_config.group_size);
+}
+
+static void group_set(uint8_t group, bool on)
+{
+    uint32_t level = (on != s_config.active_low) ? 1 : 0;
+    gpio_set_level((gpio_num_t)s_config.gpio[group], level);
+
+    if (on) {
+        if (!(s_on_mask & (1U << group))) {
+            s_ready_at_us[group] = esp_timer_get_time() + (int64_t)s_config.settle_ms * 1000;
+        }
+        s_on_mask |= (uint8_t)(1U << group);
+    } else {
+        s_on_mask &= (uint8_t)~(1U << group);
+    }
+}
+
+static void group_wait_ready(uint8_t group)
+{
+    int64_t remaining_us = s_ready_at_us[group] - esp_timer_get_time();
+    if (remaining_us <= 0) {
+        return;
+    }
+
+    // Round up to whole ticks (pdMS_TO_TICKS truncates), then add one:
+    // vTaskDelay(n) may return up to one tick early
+    uint32_t remaining_ms = (uint32_t)((remaining_us + 999) / 1000);
+    TickType_t ticks = (remaining_ms + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS;
+    vTaskDelay(ticks + 1);
+}
+
+/* ============================ PUBLIC API ============================ */
+
+esp_err_t probe_power_init(const probe_power_config_t *config)
+{
+    if (config == NULL || config->group_count == 0 ||
+        config->group_count > PROBE_POWER_MAX_GROUPS || config->group_size == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint64_t pin_mask = 0;
+    for (uint8_t g = 0; g < config->group_count; g++) {
+        if (config->gpio[g] < 0) {
+            ESP_LOGE(TAG, "Probe group %d has no GPIO", g);
+            return ESP_ERR_INVALID_ARG;
+        }
+        pin_mask |= 1ULL << config->gpio[g];
+    }
+
+    s_config = *config;
+
+    // A ULP hand-off may have left the pads latched on through deep sleep
+    gpio_deep_sleep_hold_dis();
+    for (uint8_t g = 0; g < s_config.group_count; g++) {
+        gpio_hold_dis((gpio_num_t)s_config.gpio[g]);
+    }
+
+    gpio_config_t io_cfg = {
+        .pin_bit_mask = pin_mask,
+        .mode = GPIO_MODE_OUTPUT,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_DISABLE,
+    };
+    esp_err_t ret = gpio_config(&io_cfg);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "GPIO config failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    s_initialized = true;
+    s_on_mask = 0xFF;       // Force every rail to be driven off
+    probe_power_all_off();
+
+    ESP_LOGI(TAG, "%d probe power group(s), settle %" PRIu32 " ms, active %s",
+             s_config.group_count, s_config.settle_ms,
+             s_config.active_low ? "low" : "high");
+    return ESP_OK;
+}
+
+esp_err_t probe_power_deinit(void)
+{
+    if (!s_initialized) {
+        return ESP_OK;
+    }
+
+    probe_power_all_off();
+    s_initialized = false;
+    s_scan_count = 0;
+    return ESP_OK;
+}
+
+void probe_power_prepare(uint8_t channel_count)
+{
+    if (!s_initialized || channel_count == 0) {
+        return;
+    }
+
+    s_scan_count = channel_count;
+    group_set(0, true);
+}
+
+void probe_power_channel_begin(uint8_t channel)
+{
+    if (!s_initialized) {
+        return;
+    }
+
+    uint8_t group = group_of(channel);
+    group_set(group, true);
+
+    // Pre-power the next group so it settles while this one is sampled
+    uint8_t next = group + 1;
+    if (next < s_config.group_count &&
+        (s_scan_count == 0 || group_first_channel(next) < s_scan_count)) {
+        group_set(next, true);
+    }
+
+    group_wait_ready(group);
+}
+
+void probe_power_channel_end(uint8_t channel)
+{
+    if (!s_initialized) {
+        return;
+    }
+
+    uint8_t group = group_of(channel);
+    bool last_in_group = (group_of(channel + 1) != group) ||
+                         (s_scan_count != 0 && channel + 1 >= s_scan_count);
+    if (last_in_group) {
+        group_set(group, false);
+    }
+}
+
+void probe_power_all_off(void)
+{
+    if (!s_initialized) {
+        return;
+    }
+
+    for (uint8_t g = 0; g < s_config.group_count; g++) {
+        if (s_on_mask & (1U << g)) {
+            group_set(g, false);
+        }
+    }
+    s_scan_count = 0;
+}
+
+esp_err_t probe_power_hold_on(void)
+{
+    // Allowed after probe_power_deinit(): the pads are still outputs
+    if (s_config.group_count == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    for (uint8_t g = 0; g < s_config.group_count; g++) {
+        group_set(g, true);
+        gpio_hold_en((gpio_num_t)s_config.gpio[g]);
+    }
+    gpio_deep_sleep_hold_en();
+    return ESP_OK;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file probe_power.h
+ * @brief Switched excitation rails for soil probe groups
+ *
+ * Each probe group is fed through a GPIO-controlled switch (MOSFET or load
+ * switch) that is only closed around a sampling burst: power on, wait the
+ * settle time, sample every channel of the group back to back, power off.
+ * Saves the probe supply current on battery sites and keeps DC off
+ * resistive probes (TYPE_YL69) between samples.
+ *
+ * Overlap:
+ * - probe_power_prepare() powers the first group early so its settle time
+ *   runs in parallel with other work (the ambient sensor read)
+ * - While group g is sampled, group g+1 is already powered and settling
+ *
+ * All calls are no-ops until probe_power_init() succeeds, so callers need
+ * no conditional compilation.
+ *
+ * Thread-Safety:
+ * - Not thread-safe; sensor_reader serializes all acquisitions
+ *
+ * Configuration:
+ * - CONFIG_SENSOR_PROBE_POWER_* (menuconfig → Sensor Reader Configuration)
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef PROBE_POWER_H
+#define PROBE_POWER_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PROBE_POWER_MAX_GROUPS  4
+
+/**
+ * @brief Rail wiring and timing
+ */
+typedef struct {
+    int8_t gpio[PROBE_POWER_MAX_GROUPS]; ///< Switch GPIO per group
+    uint8_t group_count;        ///< Groups in use (1-PROBE_POWER_MAX_GROUPS)
+    uint8_t group_size;         ///< Channels per group; the last group takes the rest
+    bool active_low;            ///< true for P-channel high-side switches
+    uint32_t settle_ms;         ///< Probe warm-up after power on
+} probe_power_config_t;
+
+/**
+ * @brief Configure the switch GPIOs and power every group down
+ *
+ * Releases a deep sleep pad hold left by probe_power_hold_on().
+ *
+ * @param config Wiring (copied)
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on bad wiring
+ */
+esp_err_t probe_power_init(const probe_power_config_t *config);
+
+/**
+ * @brief Power every group down and release the GPIOs
+ *
+ * @return ESP_OK (also if not initialized)
+ */
+esp_err_t probe_power_deinit(void);
+
+/**
+ * @brief Start a scan: power the first group without waiting
+ *
+ * @param channel_count Channels the following scan will sample
+ */
+void probe_power_prepare(uint8_t channel_count);
+
+/**
+ * @brief Make sure the group of @p channel is powered and settled
+ *
+ * Blocks (yielding) for whatever is left of the settle time and powers the
+ * next group so it settles while this one is sampled.
+ *
+ * @param channel Channel about to be sampled
+ */
+void probe_power_channel_begin(uint8_t channel);
+
+/**
+ * @brief Power the group down after its last channel was sampled
+ *
+ * @param channel Channel just sampled
+ */
+void probe_power_channel_end(uint8_t channel);
+
+/**
+ * @brief Power every group down (end of scan or error path)
+ */
+void probe_power_all_off(void);
+
+/**
+ * @brief Power every group and latch the pads through deep sleep
+ *
+ * For the ULP soil monitor, which samples without the main CPU. May be
+ * called after probe_power_deinit(); the hold is released by the next
+ * probe_power_init().
+ *
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if never initialized
+ */
+esp_err_t probe_power_hold_on(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PROBE_POWER_H */
@@ -0,0 +1,87 @@
+/**
+ * @file ulp_soil_model.c
+ * @brief Reference model of the ULP soil monitor decision logic
+ *
+ * Keep in sync with ulp/soil_monitor.S: every operation is done in
+ * uint16_t like the ULP-FSM ALU.
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "ulp_soil_model.h"
+#include <stddef.h>
+
+void ulp_soil_model_reset(ulp_soil_model_state_t *state, const ulp_soil_model_config_t *config)
+{
+    state->filtered = 0;
+    state->primed = false;
+    state->heartbeat_left = config->heartbeat_samples;
+    state->sample_count = 0;
+}
+
+uint16_t ulp_soil_model_sample(const uint16_t raw_sums[ULP_SOIL_MAX_CHANNELS], uint8_t channel_mask)
+{
+    uint16_t acc = 0;
+
+    for (size_t i = 0; i < ULP_SOIL_MAX_CHANNELS; i++) {
+        if (channel_mask & (1U << i)) {
+            acc = (uint16_t)(acc + raw_sums[i]);
+        }
+    }
+
+    return (uint16_t)(acc >> ULP_SOIL_OVERSAMPLE_SHIFT);
+}
+
+ulp_soil_wake_reason_t ulp_soil_model_step(ulp_soil_model_state_t *state,
+                                           const ulp_soil_model_config_t *config,
+                                           uint16_t sample)
+{
+    // Filter: first sample loads directly, then (3 * filtered + sample) / 4
+    if (!state->primed) {
+        state->primed = true;
+        state->filtered = sample;
+    } else {
+        uint16_t acc = (uint16_t)(state->filtered + (uint16_t)(state->filtered << 1));
+        acc = (uint16_t)(acc + sample);
+        state->filtered = (uint16_t)(acc >> ULP_SOIL_FILTER_SHIFT);
+    }
+
+    state->sample_count++;
+
+    // Boundaries (ULP: sub + jump ov, i.e. strict comparisons)
+    if (state->filtered > config->wake_above) {
+        return ULP_SOIL_WAKE_DRY;
+    }
+    if (state->filtered < config->wake_below) {
+        return ULP_SOIL_WAKE_WET;
+    }
+
+    // Heartbeat (ULP: jumpr ..., 2, lt)
+    if (state->heartbeat_left < 2) {
+        return ULP_SOIL_WAKE_HEARTBEAT;
+    }
+    state->heartbeat_left--;
+
+    return ULP_SOIL_WAKE_NONE;
+}
+
+uint16_t ulp_soil_model_threshold(uint16_t raw, uint8_t channel_mask)
+{
+    uint32_t scaled = (uint32_t)raw * ulp_soil_model_channel_count(channel_mask);
+    return (scaled > 0xFFFF) ? 0xFFFF : (uint16_t)scaled;
+}
+
+uint8_t ulp_soil_model_channel_count(uint8_t channel_mask)
+{
+    uint8_t count = 0;
+
+    for (size_t i = 0; i < ULP_SOIL_MAX_CHANNELS; i++) {
+        if (channel_mask & (1U << i)) {
+            count++;
+        }
+    }
+
+    return count;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file ulp_soil_model.h
+ * @brief Reference model of the ULP soil monitor decision logic
+ *
+ * Mirrors ulp/soil_monitor.S step by step (16-bit arithmetic, filter,
+ * boundary and heartbeat checks). Pure C with no ESP-IDF dependencies,
+ * so thresholds and filter behaviour can be checked on a host.
+ *
+ * Units: a "sample" is the sum over enabled channels of the oversampled
+ * per-channel average raw ADC value (12-bit), so thresholds scale with
+ * the number of enabled channels.
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef ULP_SOIL_MODEL_H
+#define ULP_SOIL_MODEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================ CONSTANTS ============================ */
+
+#define ULP_SOIL_MAX_CHANNELS           3       ///< ADC1 CH0/CH3/CH6
+#define ULP_SOIL_OVERSAMPLE_SHIFT       2       ///< 4 conversions per channel
+#define ULP_SOIL_FILTER_SHIFT           2       ///< filtered = (3 * filtered + sample) / 4
+#define ULP_SOIL_RAW_MAX                4095    ///< 12-bit ADC
+#define ULP_SOIL_WAKE_ABOVE_DISABLED    0xFFFF  ///< No dry-side boundary
+#define ULP_SOIL_WAKE_BELOW_DISABLED    0       ///< No wet-side boundary
+
+/**
+ * @brief Why the ULP woke the main CPU (values shared with the ULP program)
+ */
+typedef enum {
+    ULP_SOIL_WAKE_NONE = 0,         ///< Keep sleeping
+    ULP_SOIL_WAKE_DRY = 1,          ///< Filtered raw rose above wake_above (soil drier)
+    ULP_SOIL_WAKE_WET = 2,          ///< Filtered raw fell below wake_below (soil wetter)
+    ULP_SOIL_WAKE_HEARTBEAT = 3     ///< Heartbeat expired
+} ulp_soil_wake_reason_t;
+
+/**
+ * @brief Monitor configuration (written by the main CPU before sleep)
+ *
+ * Capacitive sensors read higher raw values in drier soil, so the dry
+ * boundary is an upper raw limit and the wet boundary a lower one.
+ */
+typedef struct {
+    uint16_t wake_above;            ///< Wake when filtered > this (sample units)
+    uint16_t wake_below;            ///< Wake when filtered < this (sample units)
+    uint16_t heartbeat_samples;     ///< Wake after this many samples regardless
+} ulp_soil_model_config_t;
+
+/**
+ * @brief Monitor state (lives in RTC slow memory on target)
+ */
+typedef struct {
+    uint16_t filtered;              ///< Filtered sample
+    bool primed;                    ///< First sample loaded into the filter
+    uint16_t heartbeat_left;        ///< Samples until heartbeat wake
+    uint16_t sample_count;          ///< Samples since arm (wraps)
+} ulp_soil_model_state_t;
+
+/* ============================ API ============================ */
+
+/**
+ * @brief Reset state as the main CPU does when arming the ULP
+ */
+void ulp_soil_model_reset(ulp_soil_model_state_t *state, const ulp_soil_model_config_t *config);
+
+/**
+ * @brief Combine oversampled per-channel readings into one sample
+ *
+ * @param raw_sums Sum of 2^ULP_SOIL_OVERSAMPLE_SHIFT conversions per channel
+ * @param channel_mask Bit i set if channel i is enabled
+ * @return Sample value as computed by the ULP
+ */
+uint16_t ulp_soil_model_sample(const uint16_t raw_sums[ULP_SOIL_MAX_CHANNELS], uint8_t channel_mask);
+
+/**
+ * @brief Run one ULP period
+ *
+ * @return Wake reason (ULP_SOIL_WAKE_NONE to keep sleeping)
+ */
+ulp_soil_wake_reason_t ulp_soil_model_step(ulp_soil_model_state_t *state,
+                                           const ulp_soil_model_config_t *config,
+                                           uint16_t sample);
+
+/**
+ * @brief Scale a per-channel raw threshold to sample units
+ *
+ * @param raw Per-channel raw ADC threshold
+ * @param channel_mask Enabled channels
+ * @return raw * enabled channel count
+ */
+uint16_t ulp_soil_model_threshold(uint16_t raw, uint8_t channel_mask);
+
+/**
+ * @brief Number of enabled channels in a mask
+ */
+uint8_t ulp_soil_model_channel_count(uint8_t channel_mask);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ULP_SOIL_MODEL_H
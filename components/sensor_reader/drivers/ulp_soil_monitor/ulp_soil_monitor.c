@@ -0,0 +1,174 @@
+/**
+ * @file ulp_soil_monitor.c
+ * @brief ULP-FSM soil monitor - loader and wake decoding
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "ulp_soil_monitor.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+
+#if CONFIG_SENSOR_ULP_SOIL_MONITOR
+
+#include "ulp.h"
+#include "ulp_soil.h"               // Generated by ulp_embed_binary()
+#include "esp_sleep.h"
+#include <inttypes.h>
+
+/* ============================ CONFIGURATION ============================ */
+
+#ifndef CONFIG_SENSOR_ULP_SAMPLE_PERIOD_MS
+#define CONFIG_SENSOR_ULP_SAMPLE_PERIOD_MS 10000
+#endif
+
+/* ============================ PRIVATE STATE ============================ */
+
+static const char *TAG = "ulp_soil";
+
+extern const uint8_t ulp_soil_bin_start[] asm("_binary_ulp_soil_bin_start");
+extern const uint8_t ulp_soil_bin_end[]   asm("_binary_ulp_soil_bin_end");
+
+static const adc_channel_t s_ulp_channels[ULP_SOIL_MAX_CHANNELS] = {
+    ADC_CHANNEL_0,  // GPIO 36
+    ADC_CHANNEL_3,  // GPIO 39
+    ADC_CHANNEL_6   // GPIO 34
+};
+
+// Kept for the lifetime of the sleep; the next boot starts from scratch
+static adc_oneshot_unit_handle_t s_ulp_adc_handle = NULL;
+
+/* ============================ PRIVATE FUNCTIONS ============================ */
+
+static esp_err_t ulp_soil_adc_init(const ulp_soil_monitor_config_t *config)
+{
+    if (s_ulp_adc_handle == NULL) {
+        adc_oneshot_unit_init_cfg_t unit_cfg = {
+            .unit_id = ADC_UNIT_1,
+            .ulp_mode = ADC_ULP_MODE_FSM,
+        };
+        esp_err_t ret = adc_oneshot_new_unit(&unit_cfg, &s_ulp_adc_handle);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "ADC1 unavailable for ULP: %s", esp_err_to_name(ret));
+            return ret;
+        }
+    }
+
+    adc_oneshot_chan_cfg_t chan_cfg = {
+        .atten = config->atten,
+        .bitwidth = ADC_BITWIDTH_12,
+    };
+    for (uint8_t i = 0; i < ULP_SOIL_MAX_CHANNELS; i++) {
+        if ((config->channel_mask & (1U << i)) == 0) {
+            continue;
+        }
+        esp_err_t ret = adc_oneshot_config_channel(s_ulp_adc_handle, s_ulp_channels[i], &chan_cfg);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to configure ADC channel %d: %s",
+                     s_ulp_channels[i], esp_err_to_name(ret));
+            return ret;
+        }
+    }
+
+    return ESP_OK;
+}
+
+static uint16_t ulp_soil_to_channel_raw(uint32_t value, uint8_t channel_mask)
+{
+    uint8_t count = ulp_soil_model_channel_count(channel_mask);
+    return (count > 0) ? (uint16_t)((value & 0xFFFF) / count) : 0;
+}
+
+/* ============================ PUBLIC API ============================ */
+
+esp_err_t ulp_soil_monitor_start(const ulp_soil_monitor_config_t *config)
+{
+    if (config == NULL || ulp_soil_model_channel_count(config->channel_mask) == 0 ||
+        config->heartbeat_s == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = ulp_load_binary(0, ulp_soil_bin_start,
+                                    (ulp_soil_bin_end - ulp_soil_bin_start) / sizeof(uint32_t));
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to load ULP program: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ret = ulp_soil_adc_init(config);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    // Thresholds in ULP sample units (sum of per-channel averages)
+    uint16_t wake_above = (config->wake_above_raw == ULP_SOIL_WAKE_ABOVE_DISABLED) ?
+                          ULP_SOIL_WAKE_ABOVE_DISABLED :
+                          ulp_soil_model_threshold(config->wake_above_raw, config->channel_mask);
+    uint16_t wake_below = ulp_soil_model_threshold(config->wake_below_raw, config->channel_mask);
+
+    uint32_t heartbeat_samples = (config->heartbeat_s * 1000U) / CONFIG_SENSOR_ULP_SAMPLE_PERIOD_MS;
+    if (heartbeat_samples < 1) {
+        heartbeat_samples = 1;
+    } else if (heartbeat_samples > 0xFFFF) {
+        heartbeat_samples = 0xFFFF;
+    }
+
+    // .bss was cleared by ulp_load_binary(); only the inputs need setting
+    ulp_ch_enable = config->channel_mask;
+    ulp_wake_above = wake_above;
+    ulp_wake_below = wake_below;
+    ulp_heartbeat_left = heartbeat_samples;
+
+    ret = ulp_set_wakeup_period(0, CONFIG_SENSOR_ULP_SAMPLE_PERIOD_MS * 1000U);
+    if (ret == ESP_OK) {
+        ret = esp_sleep_enable_ulp_wakeup();
+    }
+    if (ret == ESP_OK) {
+        ret = ulp_run(&ulp_entry - RTC_SLOW_MEM);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start ULP: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "ULP armed: mask=0x%x, wake raw >%u / <%u, heartbeat %" PRIu32 " samples x %d ms",
+             config->channel_mask, config->wake_above_raw, config->wake_below_raw,
+             heartbeat_samples, CONFIG_SENSOR_ULP_SAMPLE_PERIOD_MS);
+
+    return ESP_OK;
+}
+
+bool ulp_soil_monitor_woke_up(ulp_soil_monitor_wake_t *wake)
+{
+    if (esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_ULP) {
+        return false;
+    }
+
+    if (wake != NULL) {
+        uint8_t mask = (uint8_t)(ulp_ch_enable & 0xFFFF);
+        wake->reason = (ulp_soil_wake_reason_t)(ulp_wake_reason & 0xFFFF);
+        wake->filtered_raw = ulp_soil_to_channel_raw(ulp_filtered, mask);
+        wake->last_raw = ulp_soil_to_channel_raw(ulp_last_sample, mask);
+        wake->sample_count = (uint16_t)(ulp_sample_count & 0xFFFF);
+    }
+
+    return true;
+}
+
+#else /* !CONFIG_SENSOR_ULP_SOIL_MONITOR */
+
+esp_err_t ulp_soil_monitor_start(const ulp_soil_monitor_config_t *config)
+{
+    (void)config;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+bool ulp_soil_monitor_woke_up(ulp_soil_monitor_wake_t *wake)
+{
+    (void)wake;
+    return false;
+}
+
+#endif /* CONFIG_SENSOR_ULP_SOIL_MONITOR */
@@ -0,0 +1,81 @@
+/**
+ * @file ulp_soil_monitor.h
+ * @brief ULP-FSM soil monitor - soil thresholds checked during deep sleep
+ *
+ * Loads ulp/soil_monitor.S, hands ADC1 to the ULP and enables the ULP
+ * wakeup source. The caller then enters deep sleep; the main CPU is only
+ * woken when the filtered soil reading leaves the armed band or the
+ * heartbeat expires.
+ *
+ * Thread-Safety:
+ * - ulp_soil_monitor_start() must be the last thing done before
+ *   esp_deep_sleep_start(); ADC1 must not be in use by anyone else
+ *
+ * Configuration:
+ * - CONFIG_SENSOR_ULP_SOIL_MONITOR (requires the ULP-FSM coprocessor)
+ * - CONFIG_SENSOR_ULP_SAMPLE_PERIOD_MS
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef ULP_SOIL_MONITOR_H
+#define ULP_SOIL_MONITOR_H
+
+#include "esp_err.h"
+#include "esp_adc/adc_oneshot.h"
+#include "ulp_soil_model.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Monitor arm parameters (per-channel raw ADC units)
+ */
+typedef struct {
+    uint8_t channel_mask;           ///< Bit 0: CH0 (GPIO36), bit 1: CH3 (GPIO39), bit 2: CH6 (GPIO34)
+    adc_atten_t atten;              ///< Attenuation used for all channels
+    uint16_t wake_above_raw;        ///< Wake if average raw > this (ULP_SOIL_WAKE_ABOVE_DISABLED = off)
+    uint16_t wake_below_raw;        ///< Wake if average raw < this (ULP_SOIL_WAKE_BELOW_DISABLED = off)
+    uint32_t heartbeat_s;           ///< Wake after this long regardless
+} ulp_soil_monitor_config_t;
+
+/**
+ * @brief Result of the last monitoring period
+ */
+typedef struct {
+    ulp_soil_wake_reason_t reason;  ///< Why the CPU was woken
+    uint16_t filtered_raw;          ///< Filtered per-channel average raw ADC
+    uint16_t last_raw;              ///< Last unfiltered per-channel average raw ADC
+    uint16_t sample_count;          ///< ULP periods since arm
+} ulp_soil_monitor_wake_t;
+
+/**
+ * @brief Load the ULP program, configure ADC1 for it and start sampling
+ *
+ * Also enables the ULP wakeup source. ADC1 must have been released by
+ * the oneshot driver (sensor_reader_deinit()).
+ *
+ * @param config Arm parameters
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on bad config,
+ *         ESP_ERR_NOT_SUPPORTED if CONFIG_SENSOR_ULP_SOIL_MONITOR is off
+ */
+esp_err_t ulp_soil_monitor_start(const ulp_soil_monitor_config_t *config);
+
+/**
+ * @brief Check whether this boot was a ULP soil monitor wakeup
+ *
+ * @param[out] wake Filled when returning true (may be NULL)
+ * @return true if the ULP woke the CPU from deep sleep
+ */
+bool ulp_soil_monitor_woke_up(ulp_soil_monitor_wake_t *wake);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ULP_SOIL_MONITOR_H
@@ -13,9 +13,20 @@
 #include "sensor_reader.h"
 #include "dht.h"                    // Driver DHT22
 #include "moisture_sensor.h"        // Driver sensores suelo
+#include "analog_mux.h"             // Multiplexor analógico CD4051/CD74HC4067
+#include "probe_power.h"            // Alimentación conmutada de sondas
+#include "modbus_soil_probe.h"      // Backend Modbus RTU (sondas multi-profundidad)
+#include "ulp_soil_monitor.h"       // Monitoreo de suelo en ULP durante deep sleep
+#include "sht3x.h"                  // Backend ambiental I2C SHT3x
+#include "bme280.h"                 // Backend ambiental I2C BME280
+#include "sensor_scheduler.h"       // Pausar el muestreo antes de ceder el ADC al ULP
 #include "esp_log.h"
 #include "esp_mac.h"                // Para MAC address
 #include "esp_netif.h"              // Para IP address
+#include "time_sync.h"              // Timestamps con calidad de sincronización
+#include "deferred_log.h"           // Logs diferidos en rutas calientes
+#include "freertos/FreeRTOS.h"
+#include "freertos/portmacro.h"
 #include <string.h>
 #include <time.h>
 #include <inttypes.h>               // Para PRIu32
@@ -30,8 +41,152 @@ static sensor_health_t s_sensor_health[SENSOR_TYPE_COUNT];
 static uint32_t s_total_readings = 0;
 static uint32_t s_reading_id = 0;
 
+// Backend de humedad de suelo y último perfil leído
+static const sensor_soil_backend_t *s_soil_backend = NULL;
+static soil_profile_t s_last_profile;
+static bool s_profile_valid = false;
+static portMUX_TYPE s_profile_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+// Backend ambiental (NULL = según s_config.ambient_sensor)
+static const sensor_ambient_backend_t *s_ambient_backend = NULL;
+static bool s_ambient_override = false;
+
+// Último intento de lectura ambiental (respeta min_interval_ms del backend)
+static ambient_data_t s_last_ambient;
+static esp_err_t s_last_ambient_ret = ESP_OK;
+static int64_t s_last_ambient_ms = 0;
+static bool s_ambient_attempted = false;
+
 /* ============================ CONSTANTES ============================ */
 
+#if !CONFIG_SENSOR_SOIL_BACKEND_MODBUS && CONFIG_SENSOR_SOIL_MUX_ENABLE
+
+#if CONFIG_SENSOR_SOIL_MUX_CD4051
+#define SOIL_MUX_ADDR_LINES     3
+#define SOIL_MUX_S3_GPIO        -1
+#else
+#define SOIL_MUX_ADDR_LINES     4
+#define SOIL_MUX_S3_GPIO        CONFIG_SENSOR_SOIL_MUX_S3_GPIO
+#endif
+
+// Canal ADC1 conectado al pin común del multiplexor
+#define SOIL_MUX_ADC_CHANNEL    ((adc_channel_t)CONFIG_SENSOR_SOIL_MUX_ADC_CHANNEL)
+
+/* ============================ BACKEND ADC CON MULTIPLEXOR ============================ */
+
+// Canales escaneados (min(soil_sensor_count, canales del mux))
+static uint8_t s_mux_channels = 0;
+
+static esp_err_t soil_mux_convert(uint8_t channel, int *raw, void *ctx)
+{
+    (void)ctx;
+
+    // Sólo la conversión: la calibración corre mientras asienta el siguiente canal
+    probe_power_channel_begin(channel);
+    *raw = sensor_read_raw(SOIL_MUX_ADC_CHANNEL);
+    return (*raw < 0) ? ESP_FAIL : ESP_OK;
+}
+
+static void soil_mux_process(uint8_t channel, esp_err_t result, int raw, void *ctx)
+{
+    soil_profile_t *profile = (soil_profile_t *)ctx;
+    soil_channel_t *soil_channel = &profile->channels[channel];
+
+    probe_power_channel_end(channel);
+    memset(soil_channel, 0, sizeof(*soil_channel));
+    soil_channel->probe_id = channel;
+
+    if (result != ESP_OK) {
+        return;
+    }
+
+    int humidity = sensor_raw_to_percent(raw, TYPE_CAP);
+    soil_channel->moisture = (float)humidity;
+    soil_channel->flags = SOIL_CHANNEL_FLAG_VALID;
+
+    // Valores RAW para calibración manual (nivel DEBUG)
+    DLOG_D(TAG, "Soil mux ch%d: RAW=%d %%=%d", channel, raw, humidity);
+}
+
+static esp_err_t soil_adc_init(const sensor_config_t *config)
+{
+    moisture_sensor_config_t soil_cfg = {
+        .channel = SOIL_MUX_ADC_CHANNEL,
+        .bitwidth = ADC_BITWIDTH_12,
+        .atten = config->adc_attenuation,
+        .unit = ADC_UNIT_1,
+        .read_interval_ms = 1000,
+        .sensor_type = TYPE_CAP  // Sensor capacitivo
+    };
+
+    esp_err_t ret = moisture_sensor_init(&soil_cfg);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to init mux ADC channel %d: %s",
+                 SOIL_MUX_ADC_CHANNEL, esp_err_to_name(ret));
+        return ret;
+    }
+
+    analog_mux_config_t mux_cfg = {
+        .addr_gpio = {
+            CONFIG_SENSOR_SOIL_MUX_S0_GPIO,
+            CONFIG_SENSOR_SOIL_MUX_S1_GPIO,
+            CONFIG_SENSOR_SOIL_MUX_S2_GPIO,
+            SOIL_MUX_S3_GPIO,
+        },
+        .addr_lines = SOIL_MUX_ADDR_LINES,
+        .inhibit_gpio = CONFIG_SENSOR_SOIL_MUX_INHIBIT_GPIO,
+        .settle_us = CONFIG_SENSOR_SOIL_MUX_SETTLE_US,
+    };
+
+    ret = analog_mux_init(&mux_cfg);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to init analog mux: %s", esp_err_to_name(ret));
+        moisture_sensor_deinit();
+        return ret;
+    }
+
+    s_mux_channels = config->soil_sensor_count;
+    if (s_mux_channels > analog_mux_channel_count()) {
+        ESP_LOGW(TAG, "%d soil sensors configured, mux only has %d channels",
+                 config->soil_sensor_count, analog_mux_channel_count());
+        s_mux_channels = analog_mux_channel_count();
+    }
+    if (s_mux_channels > SOIL_MAX_SENSORS) {
+        s_mux_channels = SOIL_MAX_SENSORS;
+    }
+
+    ESP_LOGI(TAG, "%d soil sensors behind the mux on ADC channel %d",
+             s_mux_channels, SOIL_MUX_ADC_CHANNEL);
+    return ESP_OK;
+}
+
+static esp_err_t soil_adc_read(soil_profile_t *profile)
+{
+    esp_err_t ret = analog_mux_scan(s_mux_channels, soil_mux_convert, soil_mux_process, profile);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    profile->channel_count = s_mux_channels;
+    return ESP_OK;
+}
+
+static esp_err_t soil_adc_deinit(void)
+{
+    analog_mux_deinit();
+    s_mux_channels = 0;
+    return moisture_sensor_deinit();
+}
+
+static const sensor_soil_backend_t s_soil_adc_backend = {
+    .name = "adc_mux",
+    .init = soil_adc_init,
+    .read = soil_adc_read,
+    .deinit = soil_adc_deinit,
+};
+
+#elif !CONFIG_SENSOR_SOIL_BACKEND_MODBUS
+
 // Canales ADC para sensores de suelo (common_types.h línea 226-228)
 static const adc_channel_t SOIL_ADC_CHANNELS[3] = {
     ADC_CHANNEL_0,  // GPIO 36 (ADC_SOIL_SENSOR_1)
@@ -39,8 +194,170 @@ static const adc_channel_t SOIL_ADC_CHANNELS[3] = {
     ADC_CHANNEL_6   // GPIO 34 (ADC_SOIL_SENSOR_3)
 };
 
+/* ============================ BACKEND ADC (POR DEFECTO) ============================ */
+
+static esp_err_t soil_adc_init(const sensor_config_t *config)
+{
+    ESP_LOGI(TAG, "Initializing %d soil moisture sensors...", config->soil_sensor_count);
+    for (uint8_t i = 0; i < config->soil_sensor_count && i < 3; i++) {
+        moisture_sensor_config_t soil_cfg = {
+            .channel = SOIL_ADC_CHANNELS[i],
+            .bitwidth = ADC_BITWIDTH_12,
+            .atten = config->adc_attenuation,
+            .unit = ADC_UNIT_1,
+            .read_interval_ms = 1000,
+            .sensor_type = TYPE_CAP  // Sensor capacitivo
+        };
+
+        esp_err_t ret = moisture_sensor_init(&soil_cfg);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to init soil sensor %d on ADC channel %d: %s",
+                     i, SOIL_ADC_CHANNELS[i], esp_err_to_name(ret));
+            s_sensor_health[SENSOR_TYPE_SOIL_1 + i].is_healthy = false;
+        } else {
+            ESP_LOGI(TAG, "Soil sensor %d initialized successfully (ADC channel %d)",
+                     i, SOIL_ADC_CHANNELS[i]);
+        }
+    }
+
+    return ESP_OK;
+}
+
+static esp_err_t soil_adc_read(soil_profile_t *profile)
+{
+    // Buffers para logs compactos (DEBUG level)
+    int raw_values[3] = {0};
+    int humidity_values[3] = {0};
+    uint8_t count = 0;
+
+    for (uint8_t i = 0; i < s_config.soil_sensor_count && i < 3; i++, count++) {
+        soil_channel_t *channel = &profile->channels[i];
+        memset(channel, 0, sizeof(*channel));
+        channel->probe_id = i;
+
+        // Llamar nueva API que retorna RAW + porcentaje
+        probe_power_channel_begin(i);
+        esp_err_t ret = sensor_read_with_raw(
+            SOIL_ADC_CHANNELS[i],
+            &humidity_values[i],
+            &raw_values[i],
+            TYPE_CAP
+        );
+        probe_power_channel_end(i);
+
+        if (ret == ESP_OK && humidity_values[i] >= 0 && humidity_values[i] <= 100) {
+            channel->moisture = (float)humidity_values[i];
+            channel->flags = SOIL_CHANNEL_FLAG_VALID;
+        }
+    }
+    profile->channel_count = count;
+
+    // ============================================================================
+    // DEBUG LOG - Formato Compacto (solo visible con nivel DEBUG activo)
+    // ============================================================================
+    // Mostrar valores RAW para calibración manual
+    // Para activar: idf.py menuconfig → Component config → Log output → Debug
+    DLOG_D(TAG, "Soil sensors: [RAW: %d/%d/%d] [%%: %d/%d/%d]",
+             raw_values[0], raw_values[1], raw_values[2],
+             humidity_values[0], humidity_values[1], humidity_values[2]);
+
+    return ESP_OK;
+}
+
+static esp_err_t soil_adc_deinit(void)
+{
+    return moisture_sensor_deinit();
+}
+
+static const sensor_soil_backend_t s_soil_adc_backend = {
+    .name = "adc",
+    .init = soil_adc_init,
+    .read = soil_adc_read,
+    .deinit = soil_adc_deinit,
+};
+
+#endif /* !CONFIG_SENSOR_SOIL_BACKEND_MODBUS */
+
+/* ============================ BACKEND AMBIENTAL DHT22 ============================ */
+
+static esp_err_t ambient_dht22_init(const sensor_config_t *config)
+{
+    (void)config;   // El driver DHT configura el GPIO en cada lectura
+    return ESP_OK;
+}
+
+static esp_err_t ambient_dht22_read(ambient_data_t *data)
+{
+    // Retries automáticos; dht_read_ambient_data() ya retorna ambient_data_t directamente
+    return dht_read_ambient_data(
+        DHT_TYPE_AM2301,                    // DHT22 sensor type
+        (gpio_num_t)s_config.dht22_gpio,    // GPIO configurado
+        data,                                // Puntero a ambient_data_t
+        0                                    // 0 = usar DHT_MAX_RETRIES (3 intentos)
+    );
+}
+
+static const sensor_ambient_backend_t s_ambient_dht22_backend = {
+    .name = "dht22",
+    .init = ambient_dht22_init,
+    .read = ambient_dht22_read,
+    .deinit = NULL,
+    .min_interval_ms = 2000,    // DHT22: máximo 0.5 Hz
+};
+
+/**
+ * @brief Backend ambiental según la selección de device_config
+ */
+static const sensor_ambient_backend_t *ambient_backend_for(ambient_sensor_type_t type)
+{
+    switch (type) {
+        case AMBIENT_SENSOR_SHT3X:
+            return sht3x_ambient_backend();
+        case AMBIENT_SENSOR_BME280:
+            return bme280_ambient_backend();
+        case AMBIENT_SENSOR_DHT22:
+        default:
+            return &s_ambient_dht22_backend;
+    }
+}
+
+/**
+ * @brief Backend seleccionado en menuconfig
+ */
+static const sensor_soil_backend_t *soil_default_backend(void)
+{
+#if CONFIG_SENSOR_SOIL_BACKEND_MODBUS
+    return modbus_soil_probe_backend();
+#else
+    return &s_soil_adc_backend;
+#endif
+}
+
 /* ============================ IMPLEMENTACIÓN API PÚBLICA ============================ */
 
+esp_err_t sensor_reader_set_ambient_backend(const sensor_ambient_backend_t *backend)
+{
+    if (s_initialized) {
+        ESP_LOGE(TAG, "Ambient backend must be set before sensor_reader_init()");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    s_ambient_backend = backend;
+    s_ambient_override = (backend != NULL);
+    return ESP_OK;
+}
+
+esp_err_t sensor_reader_set_soil_backend(const sensor_soil_backend_t *backend)
+{
+    if (s_initialized) {
+        ESP_LOGE(TAG, "Soil backend must be set before sensor_reader_init()");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    s_soil_backend = backend;
+    return ESP_OK;
+}
+
 esp_err_t sensor_reader_init(const sensor_config_t* config)
 {
     if (s_initialized) {
@@ -68,32 +385,72 @@ esp_err_t sensor_reader_init(const sensor_config_t* config)
         s_sensor_health[i].last_value = 0.0f;
     }
 
-    // Inicializar sensores de humedad del suelo
-    ESP_LOGI(TAG, "Initializing %d soil moisture sensors...", s_config.soil_sensor_count);
-    for (uint8_t i = 0; i < s_config.soil_sensor_count && i < 3; i++) {
-        moisture_sensor_config_t soil_cfg = {
-            .channel = SOIL_ADC_CHANNELS[i],
-            .bitwidth = ADC_BITWIDTH_12,
-            .atten = s_config.adc_attenuation,
-            .unit = ADC_UNIT_1,
-            .read_interval_ms = 1000,
-            .sensor_type = TYPE_CAP  // Sensor capacitivo
-        };
+    // Inicializar backend ambiental (selección en tiempo de ejecución)
+    if (!s_ambient_override) {
+        s_ambient_backend = ambient_backend_for(s_config.ambient_sensor);
+    }
 
-        esp_err_t ret = moisture_sensor_init(&soil_cfg);
-        if (ret != ESP_OK) {
-            ESP_LOGE(TAG, "Failed to init soil sensor %d on ADC channel %d: %s",
-                     i, SOIL_ADC_CHANNELS[i], esp_err_to_name(ret));
+    esp_err_t ambient_ret = s_ambient_backend->init(&s_config);
+    if (ambient_ret != ESP_OK) {
+        ESP_LOGE(TAG, "Ambient backend '%s' init failed: %s",
+                 s_ambient_backend->name, esp_err_to_name(ambient_ret));
+        s_sensor_health[SENSOR_TYPE_DHT22].is_healthy = false;
+    }
+
+    // Inicializar backend de humedad del suelo
+    if (s_soil_backend == NULL) {
+        s_soil_backend = soil_default_backend();
+    }
+
+#if CONFIG_SENSOR_PROBE_POWER_ENABLE
+    // Alimentación de sondas: apagada hasta la próxima lectura
+    probe_power_config_t power_cfg = {
+        .gpio = {
+            CONFIG_SENSOR_PROBE_POWER_GPIO_0,
+#if CONFIG_SENSOR_PROBE_POWER_GROUPS >= 2
+            CONFIG_SENSOR_PROBE_POWER_GPIO_1,
+#else
+            -1,
+#endif
+#if CONFIG_SENSOR_PROBE_POWER_GROUPS >= 3
+            CONFIG_SENSOR_PROBE_POWER_GPIO_2,
+#else
+            -1,
+#endif
+#if CONFIG_SENSOR_PROBE_POWER_GROUPS >= 4
+            CONFIG_SENSOR_PROBE_POWER_GPIO_3,
+#else
+            -1,
+#endif
+        },
+        .group_count = CONFIG_SENSOR_PROBE_POWER_GROUPS,
+        .group_size = CONFIG_SENSOR_PROBE_POWER_GROUP_SIZE,
+#if CONFIG_SENSOR_PROBE_POWER_ACTIVE_LOW
+        .active_low = true,
+#else
+        .active_low = false,
+#endif
+        .settle_ms = CONFIG_SENSOR_PROBE_POWER_SETTLE_MS,
+    };
+    esp_err_t power_ret = probe_power_init(&power_cfg);
+    if (power_ret != ESP_OK) {
+        // Sin control de alimentación las lecturas fallarán: reportarlo
+        ESP_LOGE(TAG, "Probe power init failed: %s", esp_err_to_name(power_ret));
+    }
+#endif
+
+    esp_err_t ret = s_soil_backend->init(&s_config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Soil backend '%s' init failed: %s",
+                 s_soil_backend->name, esp_err_to_name(ret));
+        for (uint8_t i = 0; i < 3; i++) {
             s_sensor_health[SENSOR_TYPE_SOIL_1 + i].is_healthy = false;
-        } else {
-            ESP_LOGI(TAG, "Soil sensor %d initialized successfully (ADC channel %d)",
-                     i, SOIL_ADC_CHANNELS[i]);
         }
     }
 
     s_initialized = true;
-    ESP_LOGI(TAG, "Sensor reader initialized: DHT22 GPIO=%d, Soil sensors=%d",
-             s_config.dht22_gpio, s_config.soil_sensor_count);
+    ESP_LOGI(TAG, "Sensor reader initialized: Ambient backend=%s, Soil backend=%s, Soil sensors=%d",
+             s_ambient_backend->name, s_soil_backend->name, s_config.soil_sensor_count);
 
     return ESP_OK;
 }
@@ -105,14 +462,98 @@ esp_err_t sensor_reader_deinit(void)
         return ESP_OK;
     }
 
+    if (s_ambient_backend != NULL && s_ambient_backend->deinit != NULL) {
+        s_ambient_backend->deinit();
+    }
+
+    if (s_soil_backend != NULL && s_soil_backend->deinit != NULL) {
+        s_soil_backend->deinit();
+    }
+    probe_power_deinit();
+
     s_initialized = false;
     s_total_readings = 0;
     s_reading_id = 0;
+    s_ambient_attempted = false;
+
+    portENTER_CRITICAL(&s_profile_spinlock);
+    s_profile_valid = false;
+    portEXIT_CRITICAL(&s_profile_spinlock);
 
     ESP_LOGI(TAG, "Sensor reader deinitialized");
     return ESP_OK;
 }
 
+esp_err_t sensor_reader_start_soil_monitor(float wake_below_pct, float wake_above_pct,
+                                          uint32_t heartbeat_s)
+{
+#if CONFIG_SENSOR_ULP_SOIL_MONITOR
+    if (!s_initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (s_soil_backend != &s_soil_adc_backend) {
+        ESP_LOGE(TAG, "ULP soil monitor requires the ADC backend (active: %s)",
+                 s_soil_backend->name);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    // Sensores habilitados: bit i = canal SOIL_ADC_CHANNELS[i]
+    uint8_t channel_mask = 0;
+    for (uint8_t i = 0; i < s_config.soil_sensor_count && i < ULP_SOIL_MAX_CHANNELS; i++) {
+        if (s_sensor_health[SENSOR_TYPE_SOIL_1 + i].is_healthy) {
+            channel_mask |= (uint8_t)(1U << i);
+        }
+    }
+    if (channel_mask == 0) {
+        ESP_LOGE(TAG, "No healthy soil sensor to monitor from the ULP");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Sensor capacitivo: más seco = RAW más alto, por eso los límites se invierten
+    ulp_soil_monitor_config_t ulp_cfg = {
+        .channel_mask = channel_mask,
+        .atten = s_config.adc_attenuation,
+        .wake_above_raw = ULP_SOIL_WAKE_ABOVE_DISABLED,
+        .wake_below_raw = ULP_SOIL_WAKE_BELOW_DISABLED,
+        .heartbeat_s = heartbeat_s,
+    };
+    if (wake_below_pct > 0.0f) {
+        int raw = sensor_percent_to_raw(wake_below_pct, TYPE_CAP);
+        ulp_cfg.wake_above_raw = (uint16_t)((raw > ULP_SOIL_RAW_MAX) ? ULP_SOIL_RAW_MAX : raw);
+    }
+    if (wake_above_pct < 100.0f) {
+        int raw = sensor_percent_to_raw(wake_above_pct, TYPE_CAP);
+        ulp_cfg.wake_below_raw = (uint16_t)((raw < 0) ? 0 : raw);
+    }
+
+    // El ULP necesita ADC1 en modo ULP: detener el planificador (queda en
+    // pausa hasta el deep sleep) y liberar el driver oneshot
+    sensor_scheduler_pause();
+    sensor_config_t saved_config = s_config;
+    sensor_reader_deinit();
+
+    esp_err_t ret = ulp_soil_monitor_start(&ulp_cfg);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "ULP soil monitor start failed: %s", esp_err_to_name(ret));
+        sensor_reader_init(&saved_config);
+        sensor_scheduler_resume();
+        return ret;
+    }
+
+    // El ULP muestrea sin la CPU: sondas alimentadas durante todo el deep sleep
+    probe_power_hold_on();
+
+    ESP_LOGI(TAG, "Soil monitoring handed to ULP: wake <%.1f%% or >=%.1f%%, heartbeat %" PRIu32 " s",
+             wake_below_pct, wake_above_pct, heartbeat_s);
+    return ESP_OK;
+#else
+    (void)wake_below_pct;
+    (void)wake_above_pct;
+    (void)heartbeat_s;
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
 esp_err_t sensor_reader_get_ambient(ambient_data_t* data)
 {
     if (!s_initialized) {
@@ -125,19 +566,31 @@ esp_err_t sensor_reader_get_ambient(ambient_data_t* data)
         return ESP_ERR_INVALID_ARG;
     }
 
+    // Respetar la frecuencia máxima del sensor: repetir el último resultado
+    int64_t now_ms = time_sync_get_monotonic_ms();
+    if (s_ambient_attempted &&
+        now_ms - s_last_ambient_ms < (int64_t)s_ambient_backend->min_interval_ms) {
+        if (s_last_ambient_ret == ESP_OK) {
+            *data = s_last_ambient;
+        }
+        return s_last_ambient_ret;
+    }
+
     // Actualizar estadísticas de lectura
     s_sensor_health[SENSOR_TYPE_DHT22].total_reads++;
 
-    // Llamar driver DHT22 con retries automáticos
-    // IMPORTANTE: dht_read_ambient_data() ya retorna ambient_data_t directamente
-    esp_err_t ret = dht_read_ambient_data(
-        DHT_TYPE_AM2301,                    // DHT22 sensor type
-        (gpio_num_t)s_config.dht22_gpio,    // GPIO configurado
-        data,                                // Puntero a ambient_data_t
-        0                                    // 0 = usar DHT_MAX_RETRIES (3 intentos)
-    );
+    esp_err_t ret = s_ambient_backend->read(data);
+    s_ambient_attempted = true;
+    s_last_ambient_ms = now_ms;
+    s_last_ambient_ret = ret;
 
     if (ret == ESP_OK) {
+        // Sellar con la calidad del reloj (los drivers no conocen time_sync)
+        time_quality_t quality;
+        data->timestamp = time_sync_get_timestamp(&quality);
+        data->time_quality = (uint8_t)quality;
+        s_last_ambient = *data;
+
         // Lectura exitosa - actualizar health tracking
         s_sensor_health[SENSOR_TYPE_DHT22].successful_reads++;
         s_sensor_health[SENSOR_TYPE_DHT22].error_count = 0;
@@ -145,8 +598,8 @@ esp_err_t sensor_reader_get_ambient(ambient_data_t* data)
         s_sensor_health[SENSOR_TYPE_DHT22].last_read_time = data->timestamp;
         s_sensor_health[SENSOR_TYPE_DHT22].last_value = data->temperature;
 
-        ESP_LOGD(TAG, "DHT22 reading: T=%.1f°C, H=%.1f%%",
-                 data->temperature, data->humidity);
+        ESP_LOGD(TAG, "%s reading: T=%.1f°C, H=%.1f%%",
+                 s_ambient_backend->name, data->temperature, data->humidity);
     } else {
         // Lectura falló - incrementar contador de errores
         s_sensor_health[SENSOR_TYPE_DHT22].error_count++;
@@ -154,12 +607,12 @@ esp_err_t sensor_reader_get_ambient(ambient_data_t* data)
         // Marcar como no saludable si supera el límite de errores
         if (s_sensor_health[SENSOR_TYPE_DHT22].error_count >= s_config.max_consecutive_errors) {
             s_sensor_health[SENSOR_TYPE_DHT22].is_healthy = false;
-            ESP_LOGE(TAG, "DHT22 marked unhealthy after %" PRIu32 " consecutive errors",
-                     s_sensor_health[SENSOR_TYPE_DHT22].error_count);
+            ESP_LOGE(TAG, "%s marked unhealthy after %" PRIu32 " consecutive errors",
+                     s_ambient_backend->name, s_sensor_health[SENSOR_TYPE_DHT22].error_count);
         }
 
-        ESP_LOGW(TAG, "DHT22 read failed: %s (error count: %" PRIu32 ")",
-                 esp_err_to_name(ret),
+        ESP_LOGW(TAG, "%s read failed: %s (error count: %" PRIu32 ")",
+                 s_ambient_backend->name, esp_err_to_name(ret),
                  s_sensor_health[SENSOR_TYPE_DHT22].error_count);
     }
 
@@ -181,73 +634,94 @@ esp_err_t sensor_reader_get_soil(soil_data_t* data)
     // Inicializar estructura de salida
     memset(data, 0, sizeof(soil_data_t));
     data->sensor_count = 0;
-    data->timestamp = (uint32_t)time(NULL);
+    time_quality_t quality;
+    data->timestamp = time_sync_get_timestamp(&quality);
+    data->time_quality = (uint8_t)quality;
+
+    // Leer todos los canales del backend (un ciclo de bus para Modbus)
+    soil_profile_t profile;
+    memset(&profile, 0, sizeof(profile));
+    profile.timestamp = data->timestamp;
+    profile.time_quality = data->time_quality;
+
+    esp_err_t backend_ret = s_soil_backend->read(&profile);
+    probe_power_all_off();
+    if (backend_ret != ESP_OK) {
+        ESP_LOGW(TAG, "Soil backend '%s' read failed: %s",
+                 s_soil_backend->name, esp_err_to_name(backend_ret));
+    }
 
-    uint8_t successful_reads = 0;
+    for (uint8_t i = 0; i < profile.channel_count; i++) {
+        if (profile.channels[i].flags & SOIL_CHANNEL_FLAG_VALID) {
+            profile.valid_count++;
+        }
+    }
 
-    // Buffers para logs compactos (DEBUG level)
-    int raw_values[3] = {0};
-    int humidity_values[3] = {0};
+    portENTER_CRITICAL(&s_profile_spinlock);
+    s_last_profile = profile;
+    s_profile_valid = true;
+    portEXIT_CRITICAL(&s_profile_spinlock);
 
-    // Leer cada sensor de suelo configurado
-    for (uint8_t i = 0; i < s_config.soil_sensor_count && i < 3; i++) {
-        sensor_type_t sensor_type = (sensor_type_t)(SENSOR_TYPE_SOIL_1 + i);
-        s_sensor_health[sensor_type].total_reads++;
+    // Canales activos: los que reportó el backend (o los configurados si falló el bus)
+    uint8_t active = profile.channel_count;
+    if (active == 0) {
+        active = s_config.soil_sensor_count;
+    }
+    if (active > SOIL_MAX_SENSORS) {
+        active = SOIL_MAX_SENSORS;
+    }
 
-        int humidity_percent = 0;
-        int raw_adc = 0;
+    uint8_t successful_reads = 0;
 
-        // Llamar nueva API que retorna RAW + porcentaje
-        esp_err_t ret = sensor_read_with_raw(
-            SOIL_ADC_CHANNELS[i],
-            &humidity_percent,
-            &raw_adc,
-            TYPE_CAP
-        );
+    // soil_data_t: todos los canales activos (lógica de riego y payloads)
+    for (uint8_t i = 0; i < active; i++) {
+        // Health tracking individual sólo para SENSOR_TYPE_SOIL_1..3
+        sensor_health_t *health = (i < 3) ? &s_sensor_health[SENSOR_TYPE_SOIL_1 + i] : NULL;
+        if (health != NULL) {
+            health->total_reads++;
+        }
 
-        // Guardar valores para log compacto
-        raw_values[i] = raw_adc;
-        humidity_values[i] = humidity_percent;
+        bool valid = (i < profile.channel_count) &&
+                     (profile.channels[i].flags & SOIL_CHANNEL_FLAG_VALID);
 
-        // Validar resultado
-        if (ret == ESP_OK && humidity_percent >= 0 && humidity_percent <= 100) {
+        if (valid) {
             // Lectura válida
-            data->soil_humidity[i] = (float)humidity_percent;
+            float humidity = profile.channels[i].moisture;
+            data->soil_humidity[i] = humidity;
+            data->valid_mask |= (uint16_t)(1U << i);
             successful_reads++;
 
             // Actualizar health tracking
-            s_sensor_health[sensor_type].successful_reads++;
-            s_sensor_health[sensor_type].error_count = 0;
-            s_sensor_health[sensor_type].is_healthy = true;
-            s_sensor_health[sensor_type].last_value = (float)humidity_percent;
-            s_sensor_health[sensor_type].last_read_time = data->timestamp;
+            if (health != NULL) {
+                health->successful_reads++;
+                health->error_count = 0;
+                health->is_healthy = true;
+                health->last_value = humidity;
+                health->last_read_time = data->timestamp;
+            }
         } else {
             // Lectura inválida
             data->soil_humidity[i] = 0.0f;
-            s_sensor_health[sensor_type].error_count++;
 
-            // Marcar como no saludable si supera el límite
-            if (s_sensor_health[sensor_type].error_count >= s_config.max_consecutive_errors) {
-                s_sensor_health[sensor_type].is_healthy = false;
-                ESP_LOGE(TAG, "Soil sensor %d marked unhealthy after %" PRIu32 " errors",
-                         i, s_sensor_health[sensor_type].error_count);
-            }
+            if (health != NULL) {
+                health->error_count++;
+
+                // Marcar como no saludable si supera el límite
+                if (health->error_count >= s_config.max_consecutive_errors) {
+                    health->is_healthy = false;
+                    ESP_LOGE(TAG, "Soil sensor %d marked unhealthy after %" PRIu32 " errors",
+                             i, health->error_count);
+                }
 
-            ESP_LOGW(TAG, "Soil sensor %d invalid reading: RAW=%d, %%=%d (error count: %" PRIu32 ")",
-                     i, raw_adc, humidity_percent, s_sensor_health[sensor_type].error_count);
+                ESP_LOGW(TAG, "Soil channel %d invalid reading (error count: %" PRIu32 ")",
+                         i, health->error_count);
+            } else {
+                ESP_LOGW(TAG, "Soil channel %d invalid reading", i);
+            }
         }
     }
 
-    data->sensor_count = successful_reads;
-
-    // ============================================================================
-    // DEBUG LOG - Formato Compacto (solo visible con nivel DEBUG activo)
-    // ============================================================================
-    // Mostrar valores RAW para calibración manual
-    // Para activar: idf.py menuconfig → Component config → Log output → Debug
-    ESP_LOGD(TAG, "Soil sensors: [RAW: %d/%d/%d] [%%: %d/%d/%d]",
-             raw_values[0], raw_values[1], raw_values[2],
-             humidity_values[0], humidity_values[1], humidity_values[2]);
+    data->sensor_count = active;
 
     // Retornar error solo si TODOS los sensores fallaron
     if (successful_reads == 0) {
@@ -256,31 +730,114 @@ esp_err_t sensor_reader_get_soil(soil_data_t* data)
     }
 
     ESP_LOGD(TAG, "Soil sensors read: %d/%d successful",
-             successful_reads, s_config.soil_sensor_count);
+             successful_reads, active);
 
     return ESP_OK;
 }
 
+esp_err_t sensor_reader_get_soil_profile(soil_profile_t *profile)
+{
+    if (profile == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = ESP_OK;
+
+    portENTER_CRITICAL(&s_profile_spinlock);
+    if (s_profile_valid) {
+        *profile = s_last_profile;
+    } else {
+        ret = ESP_ERR_NOT_FOUND;
+    }
+    portEXIT_CRITICAL(&s_profile_spinlock);
+
+    return ret;
+}
+
+float sensor_reader_soil_average(const soil_data_t* data)
+{
+    if (data == NULL) {
+        return 0.0f;
+    }
+
+    float sum = 0.0f;
+    uint8_t valid = 0;
+    for (uint8_t i = 0; i < data->sensor_count && i < SOIL_MAX_SENSORS; i++) {
+        if (data->valid_mask & (1U << i)) {
+            sum += data->soil_humidity[i];
+            valid++;
+        }
+    }
+
+    return (valid > 0) ? sum / valid : 0.0f;
+}
+
+float sensor_reader_soil_max(const soil_data_t* data)
+{
+    if (data == NULL) {
+        return 0.0f;
+    }
+
+    float max = 0.0f;
+    for (uint8_t i = 0; i < data->sensor_count && i < SOIL_MAX_SENSORS; i++) {
+        if ((data->valid_mask & (1U << i)) && data->soil_humidity[i] > max) {
+            max = data->soil_humidity[i];
+        }
+    }
+
+    return max;
+}
+
 esp_err_t sensor_reader_get_all(sensor_reading_t* reading)
+{
+    if (reading == NULL) {
+        ESP_LOGE(TAG, "sensor_reading_t pointer is NULL");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Inicializar estructura completa (las partes que fallen quedan en cero)
+    memset(reading, 0, sizeof(sensor_reading_t));
+
+    return sensor_reader_read(reading, SENSOR_READ_ALL, NULL, NULL);
+}
+
+esp_err_t sensor_reader_read(sensor_reading_t* reading, uint8_t which,
+                             esp_err_t* ambient_ret_out, esp_err_t* soil_ret_out)
 {
     if (!s_initialized) {
         ESP_LOGE(TAG, "Sensor reader not initialized");
         return ESP_ERR_INVALID_STATE;
     }
 
-    if (reading == NULL) {
-        ESP_LOGE(TAG, "sensor_reading_t pointer is NULL");
+    if (reading == NULL || (which & SENSOR_READ_ALL) == 0) {
         return ESP_ERR_INVALID_ARG;
     }
 
-    // Inicializar estructura completa
-    memset(reading, 0, sizeof(sensor_reading_t));
+    esp_err_t ambient_ret = ESP_ERR_NOT_FINISHED;
+    esp_err_t soil_ret = ESP_ERR_NOT_FINISHED;
 
-    // 1. Leer sensor ambiental (DHT22)
-    esp_err_t ambient_ret = sensor_reader_get_ambient(&reading->ambient);
+    // 0. Encender sondas de suelo: asientan mientras se lee el sensor ambiental
+    if (which & SENSOR_READ_SOIL) {
+        probe_power_prepare(s_config.soil_sensor_count);
+    }
+
+    // 1. Leer sensor ambiental (sólo se copia si la lectura es válida)
+    if (which & SENSOR_READ_AMBIENT) {
+        ambient_data_t ambient;
+        ambient_ret = sensor_reader_get_ambient(&ambient);
+        if (ambient_ret == ESP_OK) {
+            reading->ambient = ambient;
+        }
+    }
 
     // 2. Leer sensores de suelo
-    esp_err_t soil_ret = sensor_reader_get_soil(&reading->soil);
+    if (which & SENSOR_READ_SOIL) {
+        soil_data_t soil;
+        soil_ret = sensor_reader_get_soil(&soil);
+        if (soil_ret == ESP_OK) {
+            reading->soil = soil;
+        }
+    }
 
     // 3. Obtener MAC address del dispositivo
     uint8_t mac[6];
@@ -309,17 +866,24 @@ esp_err_t sensor_reader_get_all(sensor_reading_t* reading)
     // 6. Incrementar contador total de lecturas
     s_total_readings++;
 
+    if (ambient_ret_out != NULL) {
+        *ambient_ret_out = ambient_ret;
+    }
+    if (soil_ret_out != NULL) {
+        *soil_ret_out = soil_ret;
+    }
+
     // Retornar éxito si AL MENOS UNO de los sensores funcionó
     if (ambient_ret == ESP_OK || soil_ret == ESP_OK) {
         ESP_LOGD(TAG, "Reading #%" PRIu32 " complete (ambient:%s, soil:%s)",
                  reading->reading_id,
-                 ambient_ret == ESP_OK ? "OK" : "FAIL",
-                 soil_ret == ESP_OK ? "OK" : "FAIL");
+                 (which & SENSOR_READ_AMBIENT) ? (ambient_ret == ESP_OK ? "OK" : "FAIL") : "-",
+                 (which & SENSOR_READ_SOIL) ? (soil_ret == ESP_OK ? "OK" : "FAIL") : "-");
         return ESP_OK;
     }
 
-    // Ambos sensores fallaron
-    ESP_LOGE(TAG, "Complete sensor reading failed - all sensors returned errors");
+    // Todos los sensores seleccionados fallaron
+    ESP_LOGE(TAG, "Sensor reading failed - all selected sensors returned errors");
     return ESP_ERR_INVALID_RESPONSE;
 }
 
@@ -7,7 +7,8 @@
  *
  * Component Responsibilities:
  * - DHT22 temperature/humidity reading
- * - 3x capacitive soil moisture sensor reading (ADC)
+ * - Soil moisture through a pluggable backend: 3x capacitive (ADC, default)
+ *   or multi-depth Modbus RTU probes on RS-485 (see Kconfig)
  * - Data validation and filtering
  * - Sensor health monitoring
  * - Calibration management
@@ -53,7 +54,7 @@ typedef enum {
  * @brief Sensor type enumeration
  */
 typedef enum {
-    SENSOR_TYPE_DHT22 = 0,          ///< DHT22 environmental sensor
+    SENSOR_TYPE_DHT22 = 0,          ///< Ambient sensor (DHT22 or I2C backend)
     SENSOR_TYPE_SOIL_1,             ///< Soil moisture sensor 1
     SENSOR_TYPE_SOIL_2,             ///< Soil moisture sensor 2
     SENSOR_TYPE_SOIL_3,             ///< Soil moisture sensor 3
@@ -78,11 +79,12 @@ typedef struct {
  */
 typedef struct {
     // Soil sensors
-    uint8_t soil_sensor_count;      ///< Number of soil sensors (1-3)
+    uint8_t soil_sensor_count;      ///< Number of soil sensors (1-3 direct ADC, up to 16 behind a mux)
     bool enable_soil_filtering;     ///< Enable moving average filter
     uint8_t filter_window_size;     ///< Filter window size (default: 5)
 
-    // DHT22
+    // Ambient sensor
+    ambient_sensor_type_t ambient_sensor; ///< Ambient sensor model (device_config)
     uint8_t dht22_gpio;             ///< DHT22 GPIO pin (default: 18)
     uint16_t dht22_read_timeout_ms; ///< DHT22 read timeout (default: 2000ms)
 
@@ -110,8 +112,63 @@ typedef struct {
     bool all_sensors_healthy;       ///< True if all sensors operational
 } sensor_status_t;
 
+/**
+ * @brief Soil moisture backend operations
+ *
+ * A backend fills a soil_profile_t with one channel per measurement point.
+ * sensor_reader stamps the timestamp, derives soil_data_t from the first
+ * three channels and tracks their health.
+ */
+typedef struct {
+    const char *name;                                   ///< Backend name (logs)
+    esp_err_t (*init)(const sensor_config_t *config);   ///< Set up hardware
+    esp_err_t (*read)(soil_profile_t *profile);         ///< Fill channels and channel_count
+    esp_err_t (*deinit)(void);                          ///< Release hardware (optional)
+} sensor_soil_backend_t;
+
+/**
+ * @brief Ambient (temperature/humidity) backend operations
+ *
+ * sensor_reader stamps the timestamp and tracks health under
+ * SENSOR_TYPE_DHT22 whatever the backend.
+ */
+typedef struct {
+    const char *name;                                   ///< Backend name (logs)
+    esp_err_t (*init)(const sensor_config_t *config);   ///< Set up hardware
+    esp_err_t (*read)(ambient_data_t *data);            ///< Fill temperature and humidity
+    esp_err_t (*deinit)(void);                          ///< Release hardware (optional)
+    uint32_t min_interval_ms;                           ///< Faster reads return the last sample
+} sensor_ambient_backend_t;
+
+#define SENSOR_READ_AMBIENT     0x01    ///< sensor_reader_read(): ambient sensor
+#define SENSOR_READ_SOIL        0x02    ///< sensor_reader_read(): soil channels
+#define SENSOR_READ_ALL         (SENSOR_READ_AMBIENT | SENSOR_READ_SOIL)
+
 /* ============================ PUBLIC API ============================ */
 
+/**
+ * @brief Replace the soil backend selected in Kconfig
+ *
+ * Must be called before sensor_reader_init(). Useful for bench setups
+ * and simulated probes.
+ *
+ * @param backend Backend operations (must stay valid; NULL restores the Kconfig default)
+ * @return ESP_OK on success
+ * @return ESP_ERR_INVALID_STATE if the component is already initialized
+ */
+esp_err_t sensor_reader_set_soil_backend(const sensor_soil_backend_t *backend);
+
+/**
+ * @brief Replace the ambient backend selected by sensor_config_t.ambient_sensor
+ *
+ * Must be called before sensor_reader_init().
+ *
+ * @param backend Backend operations (must stay valid; NULL restores config selection)
+ * @return ESP_OK on success
+ * @return ESP_ERR_INVALID_STATE if the component is already initialized
+ */
+esp_err_t sensor_reader_set_ambient_backend(const sensor_ambient_backend_t *backend);
+
 /**
  * @brief Initialize sensor reader component
  *
@@ -132,11 +189,33 @@ esp_err_t sensor_reader_init(const sensor_config_t* config);
  */
 esp_err_t sensor_reader_deinit(void);
 
+/**
+ * @brief Hand soil monitoring to the ULP coprocessor before deep sleep
+ *
+ * Deinitializes the sensor reader so ADC1 can be switched to ULP mode,
+ * then arms the ULP to wake the CPU when the average soil humidity
+ * leaves [wake_below_pct, wake_above_pct) or heartbeat_s elapses.
+ * On failure the sensor reader is reinitialized.
+ *
+ * The caller is expected to call esp_deep_sleep_start() right after.
+ *
+ * @param wake_below_pct Wake if humidity drops below this (<= 0 disables)
+ * @param wake_above_pct Wake if humidity reaches this (>= 100 disables)
+ * @param heartbeat_s Maximum sleep time
+ * @return ESP_OK on success
+ * @return ESP_ERR_NOT_SUPPORTED if CONFIG_SENSOR_ULP_SOIL_MONITOR is off or the ADC backend is not active
+ * @return ESP_ERR_INVALID_STATE if not initialized or no healthy soil sensor
+ */
+esp_err_t sensor_reader_start_soil_monitor(float wake_below_pct, float wake_above_pct,
+                                          uint32_t heartbeat_s);
+
 /**
  * @brief Read ambient environmental data
  *
  * Reads temperature and humidity from DHT22 sensor.
- * Applies validation and error checking.
+ * Applies validation and error checking. Calls closer together than the
+ * backend's min_interval_ms (2 s for the DHT22) return the previous
+ * sample without touching the sensor.
  *
  * @param[out] data Pointer to ambient data structure to fill
  * @return ESP_OK if read successful, error code otherwise
@@ -146,14 +225,44 @@ esp_err_t sensor_reader_get_ambient(ambient_data_t* data);
 /**
  * @brief Read soil moisture data
  *
- * Reads humidity from all configured soil sensors.
- * Applies calibration, filtering, and validation.
+ * Reads humidity from all configured soil sensors (up to SOIL_MAX_SENSORS).
+ * Applies calibration, filtering, and validation. data->sensor_count is the
+ * number of active channels; failed channels are cleared in valid_mask.
  *
  * @param[out] data Pointer to soil data structure to fill
  * @return ESP_OK if at least one sensor read successfully, error code otherwise
  */
 esp_err_t sensor_reader_get_soil(soil_data_t* data);
 
+/**
+ * @brief Average moisture over the valid channels of a soil reading
+ *
+ * @param data Soil reading
+ * @return Average in % (0.0 if no channel is valid)
+ */
+float sensor_reader_soil_average(const soil_data_t* data);
+
+/**
+ * @brief Wettest valid channel of a soil reading
+ *
+ * @param data Soil reading
+ * @return Maximum in % (0.0 if no channel is valid)
+ */
+float sensor_reader_soil_max(const soil_data_t* data);
+
+/**
+ * @brief Get all soil channels of the last soil read
+ *
+ * Does not access the bus; returns the profile captured by the last
+ * sensor_reader_get_soil() / sensor_reader_get_all() call.
+ *
+ * @param[out] profile Soil profile to fill
+ * @return ESP_OK on success
+ * @return ESP_ERR_INVALID_ARG if profile is NULL
+ * @return ESP_ERR_NOT_FOUND if no soil read has completed yet
+ */
+esp_err_t sensor_reader_get_soil_profile(soil_profile_t *profile);
+
 /**
  * @brief Read all sensors (ambient + soil)
  *
@@ -165,6 +274,23 @@ esp_err_t sensor_reader_get_soil(soil_data_t* data);
  */
 esp_err_t sensor_reader_get_all(sensor_reading_t* reading);
 
+/**
+ * @brief Read a subset of the sensors into an existing reading
+ *
+ * Selected parts are only overwritten when their read succeeds, so a
+ * cached reading can be refreshed in place. Device MAC/IP and reading_id
+ * are always updated. When both parts are selected the soil probes are
+ * powered before the ambient read so they settle in parallel.
+ *
+ * @param[in,out] reading Reading to refresh
+ * @param which SENSOR_READ_* bits
+ * @param[out] ambient_ret Ambient result (ESP_ERR_NOT_FINISHED if not selected; may be NULL)
+ * @param[out] soil_ret Soil result (ESP_ERR_NOT_FINISHED if not selected; may be NULL)
+ * @return ESP_OK if at least one selected part was read successfully
+ */
+esp_err_t sensor_reader_read(sensor_reading_t* reading, uint8_t which,
+                             esp_err_t* ambient_ret, esp_err_t* soil_ret);
+
 /**
  * @brief Get sensor reader status
  *
@@ -254,6 +380,7 @@ esp_err_t sensor_reader_get_soil_calibration(uint8_t sensor_index,
     .soil_sensor_count = 3,                     \
     .enable_soil_filtering = true,              \
     .filter_window_size = 5,                    \
+    .ambient_sensor = AMBIENT_SENSOR_DHT22,     \
     .dht22_gpio = GPIO_DHT22,                   \
     .dht22_read_timeout_ms = 2000,              \
     .adc_attenuation = ADC_ATTEN_DB_12,         \
@@ -0,0 +1,456 @@
+/**
+ * @file sensor_scheduler.c
+ * @brief Sensor Scheduler - State-aware multi-rate sampling
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "sensor_scheduler.h"
+#include "event_bus.h"
+#include "time_sync.h"
+#include "metrics.h"
+#include "common_types.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include <string.h>
+#include <time.h>
+#include <inttypes.h>
+
+/* ============================ CONFIGURATION ============================ */
+
+#ifndef CONFIG_SENSOR_SCHED_IRRIGATING_SOIL_MS
+#define CONFIG_SENSOR_SCHED_IRRIGATING_SOIL_MS 5000
+#endif
+
+#ifndef CONFIG_SENSOR_SCHED_IRRIGATING_AMBIENT_MS
+#define CONFIG_SENSOR_SCHED_IRRIGATING_AMBIENT_MS 30000
+#endif
+
+#ifndef CONFIG_SENSOR_SCHED_IDLE_PERIOD_S
+#define CONFIG_SENSOR_SCHED_IDLE_PERIOD_S 60
+#endif
+
+#ifndef CONFIG_SENSOR_SCHED_NIGHT_PERIOD_S
+#define CONFIG_SENSOR_SCHED_NIGHT_PERIOD_S 900
+#endif
+
+#ifndef CONFIG_SENSOR_SCHED_NIGHT_START_HOUR
+#define CONFIG_SENSOR_SCHED_NIGHT_START_HOUR 20
+#endif
+
+#ifndef CONFIG_SENSOR_SCHED_NIGHT_END_HOUR
+#define CONFIG_SENSOR_SCHED_NIGHT_END_HOUR 6
+#endif
+
+#ifndef CONFIG_SENSOR_SCHED_MERGE_WINDOW_MS
+#define CONFIG_SENSOR_SCHED_MERGE_WINDOW_MS 2000
+#endif
+
+#ifndef CONFIG_SENSOR_SCHED_TASK_STACK_SIZE
+#define CONFIG_SENSOR_SCHED_TASK_STACK_SIZE 4096
+#endif
+
+#define SENSOR_SCHED_MIN_PERIOD_MS      1000
+#define SENSOR_SCHED_MAX_SLEEP_MS       60000   // Re-check the night window at least this often
+
+// Sample sequence parity bits (see sensor_scheduler_wait_sample())
+#define SENSOR_SCHED_BIT_EVEN           BIT0
+#define SENSOR_SCHED_BIT_ODD            BIT1
+
+/* ============================ PRIVATE STATE ============================ */
+
+static const char *TAG = "sensor_sched";
+
+typedef enum {
+    SCHED_CLASS_SOIL = 0,
+    SCHED_CLASS_AMBIENT,
+    SCHED_CLASS_COUNT
+} sched_class_t;
+
+static sensor_sample_policy_t s_policies[SENSOR_SAMPLE_PROFILE_MAX] = {
+    [SENSOR_SAMPLE_PROFILE_IDLE] = {
+        CONFIG_SENSOR_SCHED_IDLE_PERIOD_S * 1000,
+        CONFIG_SENSOR_SCHED_IDLE_PERIOD_S * 1000,
+    },
+    [SENSOR_SAMPLE_PROFILE_IRRIGATING] = {
+        CONFIG_SENSOR_SCHED_IRRIGATING_SOIL_MS,
+        CONFIG_SENSOR_SCHED_IRRIGATING_AMBIENT_MS,
+    },
+    [SENSOR_SAMPLE_PROFILE_NIGHT] = {
+        CONFIG_SENSOR_SCHED_NIGHT_PERIOD_S * 1000,
+        CONFIG_SENSOR_SCHED_NIGHT_PERIOD_S * 1000,
+    },
+    [SENSOR_SAMPLE_PROFILE_OFFLINE_NORMAL] = {
+        SENSOR_READING_INTERVAL_OFFLINE_NORMAL * 1000,
+        SENSOR_READING_INTERVAL_OFFLINE_NORMAL * 1000,
+    },
+    [SENSOR_SAMPLE_PROFILE_OFFLINE_WARNING] = {
+        SENSOR_READING_INTERVAL_OFFLINE_WARNING * 1000,
+        SENSOR_READING_INTERVAL_OFFLINE_WARNING * 1000,
+    },
+    [SENSOR_SAMPLE_PROFILE_OFFLINE_CRITICAL] = {
+        SENSOR_READING_INTERVAL_OFFLINE_CRITICAL * 1000,
+        SENSOR_READING_INTERVAL_OFFLINE_CRITICAL * 1000,
+    },
+    [SENSOR_SAMPLE_PROFILE_OFFLINE_EMERGENCY] = {
+        SENSOR_READING_INTERVAL_OFFLINE_EMERGENCY * 1000,
+        SENSOR_READING_INTERVAL_OFFLINE_EMERGENCY * 1000,
+    },
+};
+
+static portMUX_TYPE s_sched_spinlock = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t s_task = NULL;
+static SemaphoreHandle_t s_acq_mutex = NULL;        // Held while touching the sensors
+static EventGroupHandle_t s_sample_events = NULL;
+
+// Sampling metrics (GET /metrics)
+static const uint32_t s_sample_ms_bounds[] = { 10, 50, 100, 250, 500, 1000, 2500, 5000 };
+
+static metrics_counter_t s_samples = METRICS_COUNTER_INIT(
+    "sensor_samples", "Samples taken by the scheduler", NULL);
+static metrics_counter_t s_soil_failures = METRICS_COUNTER_INIT(
+    "sensor_read_failures", "Failed reads by sensor class", "class=\"soil\"");
+static metrics_counter_t s_ambient_failures = METRICS_COUNTER_INIT(
+    "sensor_read_failures", "Failed reads by sensor class", "class=\"ambient\"");
+static metrics_histogram_t s_sample_duration = METRICS_HISTOGRAM_INIT(
+    "sensor_sample_duration_ms", "Time to read the due sensors (ms)", NULL, s_sample_ms_bounds);
+
+// Protected by s_sched_spinlock
+static sensor_sample_profile_t s_requested_profile = SENSOR_SAMPLE_PROFILE_IDLE;
+static sensor_sample_profile_t s_applied_profile = SENSOR_SAMPLE_PROFILE_IDLE;
+static sensor_reading_t s_latest;
+static esp_err_t s_latest_ret = ESP_ERR_NOT_FOUND;
+static uint32_t s_sample_seq = 0;
+
+// Scheduler task only
+static int64_t s_next_due_ms[SCHED_CLASS_COUNT];
+static int64_t s_last_read_ms[SCHED_CLASS_COUNT];
+
+/* ============================ PRIVATE HELPERS ============================ */
+
+static uint32_t policy_period_ms(sensor_sample_profile_t profile, sched_class_t cls)
+{
+    uint32_t period;
+    portENTER_CRITICAL(&s_sched_spinlock);
+    period = (cls == SCHED_CLASS_SOIL) ? s_policies[profile].soil_period_ms
+                                       : s_policies[profile].ambient_period_ms;
+    portEXIT_CRITICAL(&s_sched_spinlock);
+    return period;
+}
+
+/**
+ * @brief True during the configured night hours (clock must be synchronized)
+ */
+static bool sched_is_night(void)
+{
+    if (!time_sync_is_valid()) {
+        return false;
+    }
+
+    time_t now = time(NULL);
+    struct tm timeinfo;
+    localtime_r(&now, &timeinfo);
+
+    int start = CONFIG_SENSOR_SCHED_NIGHT_START_HOUR;
+    int end = CONFIG_SENSOR_SCHED_NIGHT_END_HOUR;
+    if (start <= end) {
+        return timeinfo.tm_hour >= start && timeinfo.tm_hour < end;
+    }
+    return timeinfo.tm_hour >= start || timeinfo.tm_hour < end;    // Window wraps midnight
+}
+
+/**
+ * @brief Resolve the profile to apply and pull due times in on a speed-up
+ */
+static sensor_sample_profile_t sched_apply_profile(void)
+{
+    sensor_sample_profile_t requested;
+    sensor_sample_profile_t previous;
+    portENTER_CRITICAL(&s_sched_spinlock);
+    requested = s_requested_profile;
+    previous = s_applied_profile;
+    portEXIT_CRITICAL(&s_sched_spinlock);
+
+    sensor_sample_profile_t profile = requested;
+    if (profile == SENSOR_SAMPLE_PROFILE_IDLE && sched_is_night()) {
+        profile = SENSOR_SAMPLE_PROFILE_NIGHT;
+    }
+
+    if (profile != previous) {
+        for (int cls = 0; cls < SCHED_CLASS_COUNT; cls++) {
+            int64_t due = s_last_read_ms[cls] + policy_period_ms(profile, (sched_class_t)cls);
+            if (due < s_next_due_ms[cls]) {
+                s_next_due_ms[cls] = due;
+            }
+        }
+
+        portENTER_CRITICAL(&s_sched_spinlock);
+        s_applied_profile = profile;
+        portEXIT_CRITICAL(&s_sched_spinlock);
+
+        ESP_LOGI(TAG, "Sampling profile %d -> %d (soil %" PRIu32 " ms, ambient %" PRIu32 " ms)",
+                 previous, profile,
+                 policy_period_ms(profile, SCHED_CLASS_SOIL),
+                 policy_period_ms(profile, SCHED_CLASS_AMBIENT));
+    }
+
+    return profile;
+}
+
+/**
+ * @brief Read the due sensors and publish the sample to the consumers
+ */
+static void sched_acquire(uint8_t which)
+{
+    sensor_reading_t reading;
+    portENTER_CRITICAL(&s_sched_spinlock);
+    reading = s_latest;
+    portEXIT_CRITICAL(&s_sched_spinlock);
+
+    esp_err_t ambient_ret = ESP_ERR_NOT_FINISHED;
+    esp_err_t soil_ret = ESP_ERR_NOT_FINISHED;
+    int64_t start_ms = time_sync_get_monotonic_ms();
+    esp_err_t ret = sensor_reader_read(&reading, which, &ambient_ret, &soil_ret);
+
+    metrics_histogram_observe(&s_sample_duration, (uint32_t)(time_sync_get_monotonic_ms() - start_ms));
+    metrics_counter_inc(&s_samples);
+    if ((which & SENSOR_READ_SOIL) && soil_ret != ESP_OK) {
+        metrics_counter_inc(&s_soil_failures);
+    }
+    if ((which & SENSOR_READ_AMBIENT) && ambient_ret != ESP_OK) {
+        metrics_counter_inc(&s_ambient_failures);
+    }
+
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Sample failed (ambient:%s, soil:%s)",
+                 esp_err_to_name(ambient_ret), esp_err_to_name(soil_ret));
+    }
+
+    uint32_t seq;
+    portENTER_CRITICAL(&s_sched_spinlock);
+    seq = ++s_sample_seq;
+    reading.reading_id = seq;
+    s_latest = reading;
+    s_latest_ret = ret;
+    portEXIT_CRITICAL(&s_sched_spinlock);
+
+    // Wake sensor_scheduler_wait_sample() callers
+    if (seq & 1U) {
+        xEventGroupClearBits(s_sample_events, SENSOR_SCHED_BIT_EVEN);
+        xEventGroupSetBits(s_sample_events, SENSOR_SCHED_BIT_ODD);
+    } else {
+        xEventGroupClearBits(s_sample_events, SENSOR_SCHED_BIT_ODD);
+        xEventGroupSetBits(s_sample_events, SENSOR_SCHED_BIT_EVEN);
+    }
+
+    if (ret == ESP_OK) {
+        event_bus_data_t sample = {0};
+        sample.sensor.soil_avg = sensor_reader_soil_average(&reading.soil);
+        sample.sensor.temperature = reading.ambient.temperature;
+        sample.sensor.humidity = reading.ambient.humidity;
+        sample.sensor.timestamp = (which & SENSOR_READ_SOIL) ? reading.soil.timestamp
+                                                             : reading.ambient.timestamp;
+        event_bus_post(EVENT_BUS_SENSOR_SAMPLE, &sample);
+    }
+}
+
+static void sensor_scheduler_task(void *arg)
+{
+    (void)arg;
+
+    while (1) {
+        sensor_sample_profile_t profile = sched_apply_profile();
+
+        int64_t now = time_sync_get_monotonic_ms();
+        int64_t next_due = s_next_due_ms[SCHED_CLASS_SOIL];
+        if (s_next_due_ms[SCHED_CLASS_AMBIENT] < next_due) {
+            next_due = s_next_due_ms[SCHED_CLASS_AMBIENT];
+        }
+
+        if (next_due > now) {
+            int64_t sleep_ms = next_due - now;
+            if (sleep_ms > SENSOR_SCHED_MAX_SLEEP_MS) {
+                sleep_ms = SENSOR_SCHED_MAX_SLEEP_MS;
+            }
+            // Woken early by sensor_scheduler_set_profile()
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS((uint32_t)sleep_ms) + 1);
+            continue;
+        }
+
+        // Merge: anything due within the window shares this wakeup
+        uint8_t which = 0;
+        if (s_next_due_ms[SCHED_CLASS_SOIL] <= now + CONFIG_SENSOR_SCHED_MERGE_WINDOW_MS) {
+            which |= SENSOR_READ_SOIL;
+        }
+        if (s_next_due_ms[SCHED_CLASS_AMBIENT] <= now + CONFIG_SENSOR_SCHED_MERGE_WINDOW_MS) {
+            which |= SENSOR_READ_AMBIENT;
+        }
+
+        xSemaphoreTake(s_acq_mutex, portMAX_DELAY);
+        sched_acquire(which);
+        xSemaphoreGive(s_acq_mutex);
+
+        now = time_sync_get_monotonic_ms();
+        if (which & SENSOR_READ_SOIL) {
+            s_last_read_ms[SCHED_CLASS_SOIL] = now;
+            s_next_due_ms[SCHED_CLASS_SOIL] = now + policy_period_ms(profile, SCHED_CLASS_SOIL);
+        }
+        if (which & SENSOR_READ_AMBIENT) {
+            s_last_read_ms[SCHED_CLASS_AMBIENT] = now;
+            s_next_due_ms[SCHED_CLASS_AMBIENT] = now + policy_period_ms(profile, SCHED_CLASS_AMBIENT);
+        }
+    }
+}
+
+/* ============================ PUBLIC API ============================ */
+
+esp_err_t sensor_scheduler_start(void)
+{
+    if (s_task != NULL) {
+        return ESP_OK;
+    }
+
+    sensor_status_t status;
+    if (sensor_reader_get_status(&status) != ESP_OK || status.state == SENSOR_STATE_UNINITIALIZED) {
+        ESP_LOGE(TAG, "sensor_reader must be initialized first");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    s_acq_mutex = xSemaphoreCreateMutex();
+    s_sample_events = xEventGroupCreate();
+    if (s_acq_mutex == NULL || s_sample_events == NULL) {
+        ESP_LOGE(TAG, "Failed to create synchronization objects");
+        return ESP_ERR_NO_MEM;
+    }
+
+    metrics_register(&s_samples.desc);
+    metrics_register(&s_soil_failures.desc);
+    metrics_register(&s_ambient_failures.desc);
+    metrics_register(&s_sample_duration.desc);
+
+    memset(&s_latest, 0, sizeof(s_latest));
+    memset(s_next_due_ms, 0, sizeof(s_next_due_ms));    // First sample: everything, now
+    memset(s_last_read_ms, 0, sizeof(s_last_read_ms));
+
+    BaseType_t ret = xTaskCreate(sensor_scheduler_task, "sensor_sched",
+                                 CONFIG_SENSOR_SCHED_TASK_STACK_SIZE, NULL,
+                                 TASK_PRIORITY_SENSOR, &s_task);
+    if (ret != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create scheduler task");
+        s_task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "Sensor scheduler started (merge window %d ms)",
+             CONFIG_SENSOR_SCHED_MERGE_WINDOW_MS);
+    return ESP_OK;
+}
+
+esp_err_t sensor_scheduler_set_profile(sensor_sample_profile_t profile)
+{
+    if (profile >= SENSOR_SAMPLE_PROFILE_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    bool changed;
+    portENTER_CRITICAL(&s_sched_spinlock);
+    changed = (s_requested_profile != profile);
+    s_requested_profile = profile;
+    portEXIT_CRITICAL(&s_sched_spinlock);
+
+    if (changed && s_task != NULL) {
+        xTaskNotifyGive(s_task);
+    }
+
+    return ESP_OK;
+}
+
+sensor_sample_profile_t sensor_scheduler_get_profile(void)
+{
+    sensor_sample_profile_t profile;
+    portENTER_CRITICAL(&s_sched_spinlock);
+    profile = s_applied_profile;
+    portEXIT_CRITICAL(&s_sched_spinlock);
+    return profile;
+}
+
+esp_err_t sensor_scheduler_set_policy(sensor_sample_profile_t profile,
+                                      const sensor_sample_policy_t *policy)
+{
+    if (profile >= SENSOR_SAMPLE_PROFILE_MAX || policy == NULL ||
+        policy->soil_period_ms < SENSOR_SCHED_MIN_PERIOD_MS ||
+        policy->ambient_period_ms < SENSOR_SCHED_MIN_PERIOD_MS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&s_sched_spinlock);
+    s_policies[profile] = *policy;
+    portEXIT_CRITICAL(&s_sched_spinlock);
+
+    if (s_task != NULL) {
+        xTaskNotifyGive(s_task);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t sensor_scheduler_get_latest(sensor_reading_t *reading)
+{
+    if (reading == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret;
+    portENTER_CRITICAL(&s_sched_spinlock);
+    *reading = s_latest;
+    ret = s_latest_ret;
+    portEXIT_CRITICAL(&s_sched_spinlock);
+
+    return ret;
+}
+
+esp_err_t sensor_scheduler_wait_sample(uint32_t last_id, uint32_t timeout_ms)
+{
+    if (s_sample_events == NULL) {
+        vTaskDelay(pdMS_TO_TICKS(timeout_ms));
+        return ESP_ERR_TIMEOUT;
+    }
+
+    uint32_t seq;
+    portENTER_CRITICAL(&s_sched_spinlock);
+    seq = s_sample_seq;
+    portEXIT_CRITICAL(&s_sched_spinlock);
+
+    if (seq != last_id) {
+        return ESP_OK;
+    }
+
+    // The bit for the parity of last_id + 1 is set when that sample lands
+    // and stays set until the one after it, so a sample published between
+    // the check above and the wait below is not missed
+    EventBits_t wanted = ((last_id + 1) & 1U) ? SENSOR_SCHED_BIT_ODD : SENSOR_SCHED_BIT_EVEN;
+    EventBits_t bits = xEventGroupWaitBits(s_sample_events, wanted, pdFALSE, pdFALSE,
+                                           pdMS_TO_TICKS(timeout_ms));
+
+    return (bits & wanted) ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+void sensor_scheduler_pause(void)
+{
+    if (s_acq_mutex != NULL) {
+        xSemaphoreTake(s_acq_mutex, portMAX_DELAY);
+    }
+}
+
+void sensor_scheduler_resume(void)
+{
+    if (s_acq_mutex != NULL) {
+        xSemaphoreGive(s_acq_mutex);
+    }
+}
@@ -0,0 +1,137 @@
+/**
+ * @file sensor_scheduler.h
+ * @brief Sensor Scheduler - State-aware multi-rate sampling
+ *
+ * Owns the sensor bus after startup: one task reads soil and ambient
+ * sensors at independent rates chosen by the active sampling profile
+ * (irrigating, idle, night, offline level) and hands every sample to the
+ * consumers through a shared cache, a wait primitive and
+ * EVENT_BUS_SENSOR_SAMPLE.
+ *
+ * Scheduling:
+ * - Each sensor class has its own due time; reads that fall due within
+ *   CONFIG_SENSOR_SCHED_MERGE_WINDOW_MS of each other share one wakeup
+ *   (a merged read powers the soil probes while the ambient sensor runs)
+ * - Switching to a faster profile pulls pending due times in immediately
+ * - IDLE becomes NIGHT during the configured night hours once the clock
+ *   is synchronized
+ *
+ * Thread-Safety:
+ * - All functions are thread-safe; the cache is protected by spinlock
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef SENSOR_SCHEDULER_H
+#define SENSOR_SCHEDULER_H
+
+#include "esp_err.h"
+#include "sensor_reader.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================ TYPES ============================ */
+
+/**
+ * @brief Sampling profiles, set by the irrigation controller
+ */
+typedef enum {
+    SENSOR_SAMPLE_PROFILE_IDLE = 0,             ///< Online, valve closed
+    SENSOR_SAMPLE_PROFILE_IRRIGATING,           ///< Valve open: fast soil sampling
+    SENSOR_SAMPLE_PROFILE_NIGHT,                ///< Idle during night hours (automatic)
+    SENSOR_SAMPLE_PROFILE_OFFLINE_NORMAL,       ///< Offline, OFFLINE_LEVEL_NORMAL
+    SENSOR_SAMPLE_PROFILE_OFFLINE_WARNING,      ///< Offline, OFFLINE_LEVEL_WARNING
+    SENSOR_SAMPLE_PROFILE_OFFLINE_CRITICAL,     ///< Offline, OFFLINE_LEVEL_CRITICAL
+    SENSOR_SAMPLE_PROFILE_OFFLINE_EMERGENCY,    ///< Offline, OFFLINE_LEVEL_EMERGENCY
+    SENSOR_SAMPLE_PROFILE_MAX
+} sensor_sample_profile_t;
+
+/**
+ * @brief Sampling periods of one profile
+ */
+typedef struct {
+    uint32_t soil_period_ms;        ///< Soil channels
+    uint32_t ambient_period_ms;     ///< Ambient sensor (floored by the backend minimum)
+} sensor_sample_policy_t;
+
+/* ============================ PUBLIC API ============================ */
+
+/**
+ * @brief Start the sampling task
+ *
+ * sensor_reader_init() must have been called. The first sample (soil and
+ * ambient) is taken immediately.
+ *
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if sensor_reader is not
+ *         initialized, ESP_ERR_NO_MEM if the task cannot be created
+ */
+esp_err_t sensor_scheduler_start(void);
+
+/**
+ * @brief Select the sampling profile
+ *
+ * @param profile Requested profile (SENSOR_SAMPLE_PROFILE_NIGHT is applied
+ *                automatically and should not be requested)
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if out of range
+ */
+esp_err_t sensor_scheduler_set_profile(sensor_sample_profile_t profile);
+
+/**
+ * @brief Get the profile currently applied (after the night substitution)
+ */
+sensor_sample_profile_t sensor_scheduler_get_profile(void);
+
+/**
+ * @brief Override the periods of a profile
+ *
+ * @param profile Profile to change
+ * @param policy New periods (each at least 1000 ms)
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on bad input
+ */
+esp_err_t sensor_scheduler_set_policy(sensor_sample_profile_t profile,
+                                      const sensor_sample_policy_t *policy);
+
+/**
+ * @brief Copy the latest sample
+ *
+ * Soil and ambient parts carry their own timestamps and may come from
+ * different wakeups. reading_id is the sample sequence number.
+ *
+ * @param[out] reading Latest sample
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND before the first sample,
+ *         ESP_ERR_INVALID_RESPONSE if every sensor failed in the last wakeup
+ */
+esp_err_t sensor_scheduler_get_latest(sensor_reading_t *reading);
+
+/**
+ * @brief Block until a sample newer than @p last_id is available
+ *
+ * @param last_id reading_id the caller already processed (0 = none)
+ * @param timeout_ms Maximum wait
+ * @return ESP_OK if a newer sample exists, ESP_ERR_TIMEOUT otherwise
+ */
+esp_err_t sensor_scheduler_wait_sample(uint32_t last_id, uint32_t timeout_ms);
+
+/**
+ * @brief Stop touching the sensors until sensor_scheduler_resume()
+ *
+ * Waits for an acquisition in progress to finish. Used before handing the
+ * ADC to the ULP coprocessor. No-op if the scheduler is not running.
+ */
+void sensor_scheduler_pause(void);
+
+/**
+ * @brief Resume sampling after sensor_scheduler_pause()
+ */
+void sensor_scheduler_resume(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SENSOR_SCHEDULER_H
@@ -0,0 +1,177 @@
+/**
+ * @file time_sync.c
+ * @brief Time Sync Component - SNTP wall clock and monotonic time source
+ *
+ * SNTP is started on every IP_EVENT_STA_GOT_IP. The system clock keeps
+ * running across deep sleep and soft resets (RTC timer), so the last sync
+ * state is kept in RTC memory to tell a restored clock from a 1970 one.
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "time_sync.h"
+#include "esp_log.h"
+#include "esp_event.h"
+#include "esp_netif.h"
+#include "esp_netif_sntp.h"
+#include "esp_timer.h"
+#include "esp_attr.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/portmacro.h"
+#include <sys/time.h>
+#include <time.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+/* ============================ CONFIGURATION ============================ */
+
+#ifndef CONFIG_TIME_SYNC_SNTP_SERVER
+#define CONFIG_TIME_SYNC_SNTP_SERVER "pool.ntp.org"
+#endif
+
+#ifndef CONFIG_TIME_SYNC_TIMEZONE
+#define CONFIG_TIME_SYNC_TIMEZONE "<-05>5"
+#endif
+
+#define TIME_SYNC_RTC_MAGIC            0x54494D45  // "TIME"
+#define TIME_SYNC_MIN_VALID_EPOCH      1735689600  // 2025-01-01: earlier means unset clock
+
+/* ============================ PRIVATE STATE ============================ */
+
+static const char *TAG = "time_sync";
+
+/**
+ * @brief Sync state surviving deep sleep and soft reset
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t last_sync_epoch;       ///< Wall-clock time of last SNTP sync
+} time_sync_rtc_state_t;
+
+static RTC_DATA_ATTR time_sync_rtc_state_t s_rtc_state;
+
+static time_quality_t s_quality = TIME_QUALITY_UNSYNCED;
+static portMUX_TYPE s_time_sync_spinlock = portMUX_INITIALIZER_UNLOCKED;
+static bool s_initialized = false;
+
+/* ============================ PRIVATE FUNCTIONS ============================ */
+
+static void time_sync_notification_cb(struct timeval *tv)
+{
+    portENTER_CRITICAL(&s_time_sync_spinlock);
+    s_quality = TIME_QUALITY_SNTP;
+    s_rtc_state.magic = TIME_SYNC_RTC_MAGIC;
+    s_rtc_state.last_sync_epoch = (uint32_t)tv->tv_sec;
+    portEXIT_CRITICAL(&s_time_sync_spinlock);
+
+    struct tm timeinfo;
+    char buf[32];
+    time_t now = tv->tv_sec;
+    localtime_r(&now, &timeinfo);
+    strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &timeinfo);
+    ESP_LOGI(TAG, "Time synchronized: %s", buf);
+}
+
+static void time_sync_ip_event_handler(void* arg, esp_event_base_t event_base,
+                                       int32_t event_id, void* event_data)
+{
+    esp_err_t ret = esp_netif_sntp_start();
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to start SNTP: %s", esp_err_to_name(ret));
+    }
+}
+
+/* ============================ PUBLIC API ============================ */
+
+esp_err_t time_sync_init(void)
+{
+    if (s_initialized) {
+        ESP_LOGW(TAG, "Time sync already initialized");
+        return ESP_OK;
+    }
+
+    setenv("TZ", CONFIG_TIME_SYNC_TIMEZONE, 1);
+    tzset();
+
+    // Clock kept running through deep sleep / soft reset and was synced before
+    time_t now = time(NULL);
+    portENTER_CRITICAL(&s_time_sync_spinlock);
+    if (s_rtc_state.magic == TIME_SYNC_RTC_MAGIC && now >= TIME_SYNC_MIN_VALID_EPOCH) {
+        s_quality = TIME_QUALITY_RTC;
+    } else {
+        s_rtc_state.magic = 0;
+        s_quality = TIME_QUALITY_UNSYNCED;
+    }
+    time_quality_t quality = s_quality;
+    uint32_t last_sync = s_rtc_state.last_sync_epoch;
+    portEXIT_CRITICAL(&s_time_sync_spinlock);
+
+    if (quality == TIME_QUALITY_RTC) {
+        ESP_LOGI(TAG, "Clock restored from RTC (last sync %" PRIu32 " s ago)",
+                 (uint32_t)(now - last_sync));
+    }
+
+    esp_sntp_config_t config = ESP_NETIF_SNTP_DEFAULT_CONFIG(CONFIG_TIME_SYNC_SNTP_SERVER);
+    config.start = false;
+    config.sync_cb = time_sync_notification_cb;
+    esp_err_t ret = esp_netif_sntp_init(&config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize SNTP: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    ret = esp_event_handler_register(IP_EVENT, IP_EVENT_STA_GOT_IP, &time_sync_ip_event_handler, NULL);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to register IP event handler: %s", esp_err_to_name(ret));
+        esp_netif_sntp_deinit();
+        return ret;
+    }
+
+    s_initialized = true;
+    ESP_LOGI(TAG, "Time sync initialized (server: %s, TZ: %s)",
+             CONFIG_TIME_SYNC_SNTP_SERVER, CONFIG_TIME_SYNC_TIMEZONE);
+
+    return ESP_OK;
+}
+
+time_quality_t time_sync_get_quality(void)
+{
+    time_quality_t quality;
+
+    portENTER_CRITICAL(&s_time_sync_spinlock);
+    quality = s_quality;
+    portEXIT_CRITICAL(&s_time_sync_spinlock);
+
+    return quality;
+}
+
+bool time_sync_is_valid(void)
+{
+    return time_sync_get_quality() != TIME_QUALITY_UNSYNCED;
+}
+
+uint32_t time_sync_get_timestamp(time_quality_t *quality)
+{
+    if (quality != NULL) {
+        *quality = time_sync_get_quality();
+    }
+
+    return (uint32_t)time(NULL);
+}
+
+int64_t time_sync_get_monotonic_ms(void)
+{
+    return esp_timer_get_time() / 1000;
+}
+
+const char* time_sync_quality_to_string(time_quality_t quality)
+{
+    switch (quality) {
+        case TIME_QUALITY_SNTP:     return "sntp";
+        case TIME_QUALITY_RTC:      return "rtc";
+        case TIME_QUALITY_UNSYNCED:
+        default:                    return "unsynced";
+    }
+}
@@ -0,0 +1,98 @@
+/**
+ * @file time_sync.h
+ * @brief Time Sync Component - SNTP wall clock and monotonic time source
+ *
+ * Keeps the system clock synchronized via SNTP and reports how trustworthy
+ * the current wall-clock time is, so timestamps taken before the first sync
+ * can be re-based by the backend.
+ *
+ * Component Responsibilities:
+ * - Start SNTP each time the station obtains an IP address
+ * - Remember sync state in RTC memory across deep sleep / soft reset
+ * - Provide wall-clock timestamps tagged with a time_quality_t
+ * - Provide a monotonic millisecond clock (esp_timer) for duration math
+ *
+ * Thread-Safety:
+ * - All state access protected by spinlock (portMUX_TYPE)
+ * - Safe for concurrent calls from multiple tasks
+ *
+ * Configuration:
+ * - SNTP server and POSIX timezone via Kconfig
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef TIME_SYNC_H
+#define TIME_SYNC_H
+
+#include "esp_err.h"
+#include "common_types.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================ PUBLIC API ============================ */
+
+/**
+ * @brief Initialize time sync component
+ *
+ * Applies the configured timezone, restores sync state kept in RTC memory
+ * and arms SNTP to start on IP_EVENT_STA_GOT_IP.
+ * Must be called after esp_netif_init() and the default event loop.
+ *
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t time_sync_init(void);
+
+/**
+ * @brief Get quality of the current wall-clock time
+ *
+ * @return TIME_QUALITY_SNTP, TIME_QUALITY_RTC or TIME_QUALITY_UNSYNCED
+ */
+time_quality_t time_sync_get_quality(void);
+
+/**
+ * @brief Check if wall-clock time can be trusted (synced now or before a soft reset)
+ *
+ * @return true if quality is not TIME_QUALITY_UNSYNCED
+ */
+bool time_sync_is_valid(void);
+
+/**
+ * @brief Get current Unix timestamp with its quality
+ *
+ * Unsynced timestamps count from 1970 at boot and must be re-based by the
+ * consumer (see time_sync_get_monotonic_ms()).
+ *
+ * @param[out] quality Time quality (may be NULL)
+ * @return Unix timestamp in seconds
+ */
+uint32_t time_sync_get_timestamp(time_quality_t *quality);
+
+/**
+ * @brief Get monotonic time since boot in milliseconds
+ *
+ * Unaffected by SNTP adjustments. Use for all elapsed-time and timeout math.
+ *
+ * @return Milliseconds since boot
+ */
+int64_t time_sync_get_monotonic_ms(void);
+
+/**
+ * @brief Get name of a time quality value
+ *
+ * @param quality Time quality
+ * @return "sntp", "rtc" or "unsynced"
+ */
+const char* time_sync_quality_to_string(time_quality_t quality);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TIME_SYNC_H
@@ -12,6 +12,7 @@
 
 #include "wifi_manager.h"
 #include "device_config.h"
+#include "event_bus.h"
 #include "esp_log.h"
 #include "esp_wifi.h"
 #include "esp_netif.h"
@@ -19,11 +20,13 @@
 #include "esp_mac.h"
 #include "esp_http_server.h"
 #include "esp_timer.h"
+#include "esp_random.h"
 #include "nvs_flash.h"
 #include "soc/rtc.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/event_groups.h"
+#include "freertos/semphr.h"
 #include "lwip/err.h"
 #include "lwip/sys.h"
 #include "lwip/ip4_addr.h"
@@ -61,9 +64,37 @@ static esp_err_t boot_counter_set_normal_operation(void);
 #define CONFIG_WIFI_PROV_CONNECTION_MAX_RETRIES 5
 #endif
 
+#ifndef CONFIG_WIFI_MANAGER_RECONNECT_MIN_MS
+#define CONFIG_WIFI_MANAGER_RECONNECT_MIN_MS 1000
+#endif
+
+#ifndef CONFIG_WIFI_MANAGER_RECONNECT_MAX_MS
+#define CONFIG_WIFI_MANAGER_RECONNECT_MAX_MS 300000
+#endif
+
+#define RECONNECT_NO_AP_MIN_MS         10000   // AP powered off / out of range
+#define RECONNECT_AUTH_MIN_MS          30000   // Wrong password or AP rejecting us
+#define RECONNECT_RETRY_COUNT_CAP      64      // Backoff is at its maximum long before this
+
 #define WIFI_CONNECTED_BIT BIT0
 #define WIFI_FAIL_BIT BIT1
 
+/**
+ * @brief Reconnect policy class derived from the disconnect reason code
+ */
+typedef enum {
+    RECONNECT_CLASS_TRANSIENT = 0,  // Beacon timeout, assoc failure, AP kick - retry fast
+    RECONNECT_CLASS_NO_AP,          // SSID not visible - retry slower
+    RECONNECT_CLASS_AUTH,           // Authentication failure - retry slowest
+    RECONNECT_CLASS_COUNT
+} reconnect_class_t;
+
+static const uint32_t s_reconnect_min_ms[RECONNECT_CLASS_COUNT] = {
+    [RECONNECT_CLASS_TRANSIENT] = CONFIG_WIFI_MANAGER_RECONNECT_MIN_MS,
+    [RECONNECT_CLASS_NO_AP]     = RECONNECT_NO_AP_MIN_MS,
+    [RECONNECT_CLASS_AUTH]      = RECONNECT_AUTH_MIN_MS,
+};
+
 typedef struct {
     wifi_manager_connection_state_t state;
     bool connected;
@@ -73,6 +104,28 @@ typedef struct {
     char ssid[33];
     uint8_t mac_address[6];
     esp_ip4_addr_t ip_addr;
+
+    // Reconnect scheduler
+    bool auto_reconnect;
+    bool validating;
+    esp_timer_handle_t reconnect_timer;
+
+    // Roaming: target config applied once the current link is torn down
+    bool roam_pending;
+    wifi_config_t roam_config;
+
+    // Fast connect: scan config kept for fallback, AP of the current link
+    wifi_config_t scan_config;
+    bool bssid_locked;
+    uint8_t ap_bssid[6];
+    uint8_t ap_channel;
+
+    // Connect-time breakdown (esp_timer microseconds)
+    int64_t connect_start_us;
+    int64_t attempt_start_us;
+    int64_t link_up_us;
+    uint8_t attempts;
+    wifi_manager_connect_timing_t timing;
 } wifi_connection_manager_t;
 
 static wifi_connection_manager_t s_conn_manager = {0};
@@ -87,8 +140,114 @@ static esp_err_t connection_manager_stop(void);
 static esp_err_t connection_manager_deinit(void);
 static esp_err_t connection_manager_connect(const wifi_config_t *config);
 static esp_err_t connection_manager_disconnect(void);
+static void connection_manager_fallback_to_scan(uint8_t reason);
+static void connection_timing_mark_attempt(bool new_connection);
+static reconnect_class_t connection_classify_reason(uint8_t reason);
+static uint32_t connection_backoff_delay_ms(reconnect_class_t reconnect_class, int retry_count);
+static void connection_manager_schedule_reconnect(uint32_t delay_ms);
+static void connection_manager_cancel_reconnect(void);
+static void reconnect_timer_callback(void *arg);
 static void connection_event_handler(void* arg, esp_event_base_t event_base, int32_t event_id, void* event_data);
 
+/* ============================ FAST CONNECT CACHE SECTION ============================ */
+
+#define FAST_CONNECT_MAGIC_NUMBER      0xFA57C0DE
+#define FAST_CONNECT_NVS_KEY           "fast_conn"
+
+typedef struct {
+    uint32_t magic_number;
+    char ssid[33];
+    uint8_t bssid[6];
+    uint8_t channel;
+} fast_connect_cache_t;
+
+// RTC copy survives deep sleep and soft resets, NVS copy survives power loss
+RTC_DATA_ATTR static fast_connect_cache_t s_fast_connect;
+
+/* Fast connect forward declarations */
+static void fast_connect_cache_load(void);
+static void fast_connect_cache_store(const char *ssid, const uint8_t *bssid, uint8_t channel);
+static void fast_connect_cache_invalidate(void);
+static void fast_connect_cache_persist(const fast_connect_cache_t *cache);
+static bool fast_connect_cache_apply(wifi_config_t *config);
+
+/* ============================ CREDENTIAL STORE SECTION ============================ */
+
+#ifndef CONFIG_WIFI_MANAGER_MAX_NETWORKS
+#define CONFIG_WIFI_MANAGER_MAX_NETWORKS 4
+#endif
+
+#ifndef CONFIG_WIFI_MANAGER_ROAM_RSSI_THRESHOLD
+#define CONFIG_WIFI_MANAGER_ROAM_RSSI_THRESHOLD -75
+#endif
+
+#ifndef CONFIG_WIFI_MANAGER_ROAM_RSSI_HYSTERESIS
+#define CONFIG_WIFI_MANAGER_ROAM_RSSI_HYSTERESIS 8
+#endif
+
+#define CRED_STORE_NVS_KEY             "creds"
+#define CRED_STORE_VERSION             1
+#define CRED_RSSI_UNKNOWN              (-90)   // Ranking RSSI for never-seen networks
+
+#define ROAM_CHECK_INTERVAL_MS         30000   // RSSI sampling period while connected
+#define ROAM_LOW_RSSI_SAMPLES          3       // Consecutive weak samples before scanning
+
+typedef struct {
+    char ssid[33];
+    char password[65];
+    int8_t last_rssi;           // Last RSSI seen for this SSID (0 = never seen)
+    uint8_t fail_streak;        // Consecutive connection failures
+    uint16_t success_count;     // Successful connections (saturating)
+} wifi_credential_t;
+
+typedef struct {
+    uint8_t version;
+    uint8_t count;
+    uint8_t reserved[2];
+    wifi_credential_t entries[CONFIG_WIFI_MANAGER_MAX_NETWORKS];
+} wifi_credential_store_t;
+
+static wifi_credential_store_t s_cred_store = {0};
+static portMUX_TYPE s_cred_store_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+typedef struct {
+    esp_timer_handle_t timer;
+    uint8_t low_rssi_samples;
+    bool scan_pending;
+    int8_t current_rssi;
+} wifi_roam_t;
+
+static wifi_roam_t s_roam = {0};
+
+/* Credential store forward declarations */
+static void credential_store_load(void);
+static void credential_store_save(void);
+static esp_err_t credential_store_add(const char *ssid, const char *password);
+static void credential_store_erase(void);
+static bool credential_store_select(const char *exclude_ssid, wifi_config_t *config);
+static void credential_store_record_result(const char *ssid, bool success, int8_t rssi);
+static void credential_store_ranking(uint8_t *order);
+static void roam_timer_callback(void *arg);
+static void roam_scan_done_handler(void* arg, esp_event_base_t event_base, int32_t event_id, void* event_data);
+
+/* ============================ DEFERRED PERSISTENCE SECTION ============================ */
+
+// The connection handler runs on the system event task (2 KB stack), which is
+// too small for NVS writes; it only marks what changed and the writes run on
+// the esp_timer task
+#define PERSIST_FAST_CONNECT           BIT0
+#define PERSIST_CRED_STORE             BIT1
+#define PERSIST_DELAY_MS               100     // Coalesces back-to-back updates into one write
+
+static esp_timer_handle_t s_persist_timer = NULL;
+static uint32_t s_persist_pending = 0;
+static portMUX_TYPE s_persist_spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+/* Deferred persistence forward declarations */
+static void persist_schedule(uint32_t what);
+static void persist_flush(void);
+static void persist_timer_callback(void *arg);
+
 /* ============================ PROVISIONING MANAGER SECTION ============================ */
 
 #ifndef CONFIG_WIFI_PROV_SOFTAP_SSID
@@ -102,6 +261,11 @@ static void connection_event_handler(void* arg, esp_event_base_t event_base, int
 #define VALIDATION_SUCCESS_BIT BIT0
 #define VALIDATION_FAILED_BIT BIT1
 
+#define PROV_SCAN_REFRESH_INTERVAL_MS  20000   // Background scan period while provisioning
+#define PROV_SCAN_MAX_RECORDS          20      // Raw AP records fetched from the driver
+#define PROV_SCAN_MAX_NETWORKS         15      // Unique SSIDs served to the portal
+#define PROV_SCAN_ENTRY_MAX_LEN        128     // Worst case per entry (escaped 32-byte SSID)
+
 typedef struct {
     wifi_manager_prov_state_t state;
     bool provisioned;
@@ -119,6 +283,14 @@ static wifi_manager_validation_result_t s_validation_result = WIFI_VALIDATION_OK
 static portMUX_TYPE s_validation_spinlock = portMUX_INITIALIZER_UNLOCKED;
 static EventGroupHandle_t s_validation_event_group = NULL;
 
+// Background scan cache: pre-serialized '"networks":[...]}' served by GET /scan
+static esp_timer_handle_t s_scan_timer = NULL;
+static SemaphoreHandle_t s_scan_cache_mutex = NULL;
+static char *s_scan_cache_json = NULL;
+static size_t s_scan_cache_len = 0;
+static int64_t s_scan_cache_time_us = 0;
+static volatile bool s_scan_in_progress = false;
+
 // Minified HTML for WiFi configuration (~4KB)
 static const char html_page[] =
 "<!DOCTYPE html><html><head><title>Config Liwaisi</title><meta charset='UTF-8'><meta name='viewport' content='width=device-width,initial-scale=1'>"
@@ -132,7 +304,7 @@ static const char html_page[] =
 "<div class='g'><label>Ubicación:</label><textarea id='loc' maxlength='150' rows='2' required></textarea></div>"
 "<div class='g'><label>Red (SSID):</label><input id='ssid' required></div><div class='g'><label>Contraseña:</label><input type='password' id='pass'></div>"
 "<button type='submit'>💾 Guardar</button></form><div id='status'></div></div>"
-"<script>function scan(){document.getElementById('status').innerHTML='<div class=\"info\">Escaneando...</div>';fetch('/scan').then(r=>r.json()).then(d=>{let h='';d.networks.forEach(n=>{h+=`<div class=\"net\" onclick=\"sel('${n.ssid}')\">${n.ssid} ${n.auth!='open'?'🔒':''}</div>`;});document.getElementById('nets').innerHTML=h;document.getElementById('status').innerHTML='<div class=\"success\">'+d.networks.length+' redes</div>';}).catch(e=>{document.getElementById('status').innerHTML='<div class=\"error\">Fallo</div>';})}function sel(s){document.getElementById('ssid').value=s;document.getElementById('pass').focus()}document.getElementById('form').onsubmit=function(e){e.preventDefault();let d=document.getElementById('dev').value,l=document.getElementById('loc').value,s=document.getElementById('ssid').value,p=document.getElementById('pass').value;if(!d||!l||!s){alert('Complete todos los campos');return}document.getElementById('status').innerHTML='<div class=\"info\">⏳ Validando WiFi...</div>';fetch('/config',{method:'POST',headers:{'Content-Type':'application/x-www-form-urlencoded'},body:'device_name='+encodeURIComponent(d)+'&device_location='+encodeURIComponent(l)+'&ssid='+encodeURIComponent(s)+'&password='+encodeURIComponent(p)}).then(r=>r.json()).then(d=>{if(d.success){document.getElementById('status').innerHTML='<div class=\"success\">✅ WiFi configurado! Reiniciando...</div>';setTimeout(()=>window.location.href='/',3000)}else{let msg=d.message||'Error desconocido';if(msg.includes('incorrecta')){document.getElementById('status').innerHTML='<div class=\"error\">❌ Contraseña WiFi incorrecta</div>'}else if(msg.includes('no encontrada')){document.getElementById('status').innerHTML='<div class=\"error\">❌ Red WiFi no encontrada</div>'}else if(msg.includes('Timeout')){document.getElementById('status').innerHTML='<div class=\"error\">❌ Conexión lenta - intente de nuevo</div>'}else{document.getElementById('status').innerHTML='<div class=\"error\">❌ Error: '+msg+'</div>'}document.getElementById('pass').focus()}}).catch(e=>{document.getElementById('status').innerHTML='<div class=\"error\">❌ Error de conexión</div>'})}</script></body></html>";
+"<script>function scan(){document.getElementById('status').innerHTML='<div class=\"info\">Escaneando...</div>';fetch('/scan').then(r=>r.json()).then(d=>{if(d.scanning&&!d.networks.length){setTimeout(scan,1500);return}let h='';d.networks.forEach(n=>{h+=`<div class=\"net\" onclick=\"sel('${n.ssid}')\">${n.ssid} ${n.auth!='open'?'🔒':''}</div>`;});document.getElementById('nets').innerHTML=h;document.getElementById('status').innerHTML='<div class=\"success\">'+d.networks.length+' redes</div>';}).catch(e=>{document.getElementById('status').innerHTML='<div class=\"error\">Fallo</div>';})}function sel(s){document.getElementById('ssid').value=s;document.getElementById('pass').focus()}document.getElementById('form').onsubmit=function(e){e.preventDefault();let d=document.getElementById('dev').value,l=document.getElementById('loc').value,s=document.getElementById('ssid').value,p=document.getElementById('pass').value;if(!d||!l||!s){alert('Complete todos los campos');return}document.getElementById('status').innerHTML='<div class=\"info\">⏳ Validando WiFi...</div>';fetch('/config',{method:'POST',headers:{'Content-Type':'application/x-www-form-urlencoded'},body:'device_name='+encodeURIComponent(d)+'&device_location='+encodeURIComponent(l)+'&ssid='+encodeURIComponent(s)+'&password='+encodeURIComponent(p)}).then(r=>r.json()).then(d=>{if(d.success){document.getElementById('status').innerHTML='<div class=\"success\">✅ WiFi configurado! Reiniciando...</div>';setTimeout(()=>window.location.href='/',3000)}else{let msg=d.message||'Error desconocido';if(msg.includes('incorrecta')){document.getElementById('status').innerHTML='<div class=\"error\">❌ Contraseña WiFi incorrecta</div>'}else if(msg.includes('no encontrada')){document.getElementById('status').innerHTML='<div class=\"error\">❌ Red WiFi no encontrada</div>'}else if(msg.includes('Timeout')){document.getElementById('status').innerHTML='<div class=\"error\">❌ Conexión lenta - intente de nuevo</div>'}else{document.getElementById('status').innerHTML='<div class=\"error\">❌ Error: '+msg+'</div>'}document.getElementById('pass').focus()}}).catch(e=>{document.getElementById('status').innerHTML='<div class=\"error\">❌ Error de conexión</div>'})}</script></body></html>";
 
 /* Provisioning manager forward declarations */
 static esp_err_t prov_manager_init(void);
@@ -148,10 +320,14 @@ static void prov_validation_event_handler(void* arg, esp_event_base_t event_base
 static esp_err_t root_get_handler(httpd_req_t *req);
 static esp_err_t scan_get_handler(httpd_req_t *req);
 static esp_err_t config_post_handler(httpd_req_t *req);
+static void prov_scan_start(void);
+static void prov_scan_timer_callback(void *arg);
+static void prov_scan_done_handler(void* arg, esp_event_base_t event_base, int32_t event_id, void* event_data);
+static esp_err_t prov_scan_cache_start(void);
+static void prov_scan_cache_stop(void);
 
 /* ============================ MAIN WIFI MANAGER SECTION ============================ */
 
-ESP_EVENT_DEFINE_BASE(WIFI_MANAGER_EVENTS);
 ESP_EVENT_DEFINE_BASE(WIFI_MANAGER_PROV_EVENTS);
 ESP_EVENT_DEFINE_BASE(WIFI_MANAGER_CONNECTION_EVENTS);
 
@@ -247,30 +423,624 @@ static esp_err_t boot_counter_check_reset_pattern(bool *should_provision)
         }
     }
 
-    return ESP_OK;
+    return ESP_OK;
+}
+
+static bool boot_counter_is_in_time_window(void)
+{
+    if (s_boot_counter.boot_count == 0) {
+        return false;
+    }
+
+    uint32_t current_time = (uint32_t)(esp_timer_get_time() / 1000);
+    uint32_t time_since_first = current_time - s_boot_counter.first_boot_time;
+
+    return time_since_first <= BOOT_COUNTER_TIME_WINDOW_MS;
+}
+
+static esp_err_t boot_counter_set_normal_operation(void)
+{
+    ESP_LOGI(TAG, "Setting normal operation mode - clearing boot counter");
+    return boot_counter_clear();
+}
+
+/* ============================================================================
+ * FAST CONNECT CACHE IMPLEMENTATION
+ * ============================================================================ */
+
+static void fast_connect_cache_load(void)
+{
+    if (s_fast_connect.magic_number == FAST_CONNECT_MAGIC_NUMBER) {
+        ESP_LOGD(TAG, "Fast connect cache found in RTC memory (channel %d)", s_fast_connect.channel);
+        return;
+    }
+
+    nvs_handle_t nvs_handle;
+    if (nvs_open(WIFI_MANAGER_NVS_NAMESPACE, NVS_READONLY, &nvs_handle) != ESP_OK) {
+        return;
+    }
+
+    fast_connect_cache_t cache = {0};
+    size_t size = sizeof(cache);
+    esp_err_t ret = nvs_get_blob(nvs_handle, FAST_CONNECT_NVS_KEY, &cache, &size);
+    nvs_close(nvs_handle);
+
+    if (ret == ESP_OK && size == sizeof(cache) && cache.magic_number == FAST_CONNECT_MAGIC_NUMBER) {
+        cache.ssid[sizeof(cache.ssid) - 1] = '\0';
+        s_fast_connect = cache;
+        ESP_LOGD(TAG, "Fast connect cache restored from NVS (channel %d)", s_fast_connect.channel);
+    }
+}
+
+static void fast_connect_cache_store(const char *ssid, const uint8_t *bssid, uint8_t channel)
+{
+    if (s_fast_connect.magic_number == FAST_CONNECT_MAGIC_NUMBER &&
+        s_fast_connect.channel == channel &&
+        memcmp(s_fast_connect.bssid, bssid, sizeof(s_fast_connect.bssid)) == 0 &&
+        strcmp(s_fast_connect.ssid, ssid) == 0) {
+        return;  // Unchanged - avoid flash wear on every reconnect
+    }
+
+    fast_connect_cache_t cache = {0};
+    cache.magic_number = FAST_CONNECT_MAGIC_NUMBER;
+    strncpy(cache.ssid, ssid, sizeof(cache.ssid) - 1);
+    memcpy(cache.bssid, bssid, sizeof(cache.bssid));
+    cache.channel = channel;
+
+    portENTER_CRITICAL(&s_persist_spinlock);
+    s_fast_connect = cache;
+    portEXIT_CRITICAL(&s_persist_spinlock);
+    persist_schedule(PERSIST_FAST_CONNECT);
+
+    ESP_LOGD(TAG, "Fast connect cache updated: " MACSTR " channel %d", MAC2STR(bssid), channel);
+}
+
+static void fast_connect_cache_invalidate(void)
+{
+    if (s_fast_connect.magic_number != FAST_CONNECT_MAGIC_NUMBER) {
+        return;
+    }
+
+    portENTER_CRITICAL(&s_persist_spinlock);
+    memset(&s_fast_connect, 0, sizeof(s_fast_connect));
+    portEXIT_CRITICAL(&s_persist_spinlock);
+    persist_schedule(PERSIST_FAST_CONNECT);
+}
+
+static void fast_connect_cache_persist(const fast_connect_cache_t *cache)
+{
+    nvs_handle_t nvs_handle;
+    esp_err_t ret = nvs_open(WIFI_MANAGER_NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+    if (ret == ESP_OK) {
+        if (cache->magic_number == FAST_CONNECT_MAGIC_NUMBER) {
+            ret = nvs_set_blob(nvs_handle, FAST_CONNECT_NVS_KEY, cache, sizeof(*cache));
+        } else {
+            ret = nvs_erase_key(nvs_handle, FAST_CONNECT_NVS_KEY);
+            if (ret == ESP_ERR_NVS_NOT_FOUND) {
+                ret = ESP_OK;
+            }
+        }
+        if (ret == ESP_OK) {
+            ret = nvs_commit(nvs_handle);
+        }
+        nvs_close(nvs_handle);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to persist fast connect cache: %s", esp_err_to_name(ret));
+    }
+}
+
+static bool fast_connect_cache_apply(wifi_config_t *config)
+{
+#ifdef CONFIG_WIFI_MANAGER_FAST_CONNECT
+    if (s_fast_connect.magic_number != FAST_CONNECT_MAGIC_NUMBER ||
+        strncmp(s_fast_connect.ssid, (char *)config->sta.ssid, sizeof(config->sta.ssid)) != 0) {
+        return false;
+    }
+
+    config->sta.bssid_set = true;
+    memcpy(config->sta.bssid, s_fast_connect.bssid, sizeof(config->sta.bssid));
+    config->sta.channel = s_fast_connect.channel;
+    config->sta.scan_method = WIFI_FAST_SCAN;
+    return true;
+#else
+    (void)config;
+    return false;
+#endif
+}
+
+/* ============================================================================
+ * CREDENTIAL STORE IMPLEMENTATION
+ * ============================================================================ */
+
+static void credential_store_load(void)
+{
+    nvs_handle_t nvs_handle;
+    if (nvs_open(WIFI_MANAGER_NVS_NAMESPACE, NVS_READONLY, &nvs_handle) != ESP_OK) {
+        return;
+    }
+
+    wifi_credential_store_t *store = calloc(1, sizeof(wifi_credential_store_t));
+    if (store == NULL) {
+        nvs_close(nvs_handle);
+        return;
+    }
+
+    size_t size = sizeof(wifi_credential_store_t);
+    esp_err_t ret = nvs_get_blob(nvs_handle, CRED_STORE_NVS_KEY, store, &size);
+    nvs_close(nvs_handle);
+
+    // A size mismatch means CONFIG_WIFI_MANAGER_MAX_NETWORKS changed - start over
+    if (ret == ESP_OK && size == sizeof(wifi_credential_store_t) &&
+        store->version == CRED_STORE_VERSION && store->count <= CONFIG_WIFI_MANAGER_MAX_NETWORKS) {
+        portENTER_CRITICAL(&s_cred_store_spinlock);
+        s_cred_store = *store;
+        portEXIT_CRITICAL(&s_cred_store_spinlock);
+        ESP_LOGD(TAG, "Credential store loaded: %d network(s)", store->count);
+    }
+
+    free(store);
+}
+
+static void credential_store_save(void)
+{
+    wifi_credential_store_t *snapshot = malloc(sizeof(wifi_credential_store_t));
+    if (snapshot == NULL) {
+        return;
+    }
+
+    portENTER_CRITICAL(&s_cred_store_spinlock);
+    *snapshot = s_cred_store;
+    portEXIT_CRITICAL(&s_cred_store_spinlock);
+
+    nvs_handle_t nvs_handle;
+    esp_err_t ret = nvs_open(WIFI_MANAGER_NVS_NAMESPACE, NVS_READWRITE, &nvs_handle);
+    if (ret == ESP_OK) {
+        ret = nvs_set_blob(nvs_handle, CRED_STORE_NVS_KEY, snapshot, sizeof(wifi_credential_store_t));
+        if (ret == ESP_OK) {
+            ret = nvs_commit(nvs_handle);
+        }
+        nvs_close(nvs_handle);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to persist credential store: %s", esp_err_to_name(ret));
+    }
+
+    free(snapshot);
+}
+
+static int credential_score(const wifi_credential_t *cred)
+{
+    int score = (cred->last_rssi != 0) ? cred->last_rssi : CRED_RSSI_UNKNOWN;
+    score += 2 * MIN(cred->success_count, 10);
+    score -= 15 * MIN(cred->fail_streak, 4);
+    return score;
+}
+
+static esp_err_t credential_store_add(const char *ssid, const char *password)
+{
+    if (ssid == NULL || ssid[0] == '\0') {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&s_cred_store_spinlock);
+    s_cred_store.version = CRED_STORE_VERSION;
+
+    int slot = -1;
+    for (int i = 0; i < s_cred_store.count; i++) {
+        if (strncmp(s_cred_store.entries[i].ssid, ssid, sizeof(s_cred_store.entries[i].ssid)) == 0) {
+            slot = i;  // Update password, keep history
+            break;
+        }
+    }
+
+    if (slot < 0) {
+        if (s_cred_store.count < CONFIG_WIFI_MANAGER_MAX_NETWORKS) {
+            slot = s_cred_store.count++;
+        } else {
+            // Full: evict the lowest ranked network
+            slot = 0;
+            for (int i = 1; i < s_cred_store.count; i++) {
+                if (credential_score(&s_cred_store.entries[i]) < credential_score(&s_cred_store.entries[slot])) {
+                    slot = i;
+                }
+            }
+        }
+        memset(&s_cred_store.entries[slot], 0, sizeof(wifi_credential_t));
+        strncpy(s_cred_store.entries[slot].ssid, ssid, sizeof(s_cred_store.entries[slot].ssid) - 1);
+    }
+
+    memset(s_cred_store.entries[slot].password, 0, sizeof(s_cred_store.entries[slot].password));
+    if (password != NULL) {
+        strncpy(s_cred_store.entries[slot].password, password, sizeof(s_cred_store.entries[slot].password) - 1);
+    }
+    s_cred_store.entries[slot].fail_streak = 0;
+    portEXIT_CRITICAL(&s_cred_store_spinlock);
+
+    credential_store_save();
+    ESP_LOGI(TAG, "Network '%s' stored in slot %d", ssid, slot);
+    return ESP_OK;
+}
+
+static void credential_store_erase(void)
+{
+    portENTER_CRITICAL(&s_cred_store_spinlock);
+    memset(&s_cred_store, 0, sizeof(s_cred_store));
+    portEXIT_CRITICAL(&s_cred_store_spinlock);
+
+    nvs_handle_t nvs_handle;
+    if (nvs_open(WIFI_MANAGER_NVS_NAMESPACE, NVS_READWRITE, &nvs_handle) == ESP_OK) {
+        nvs_erase_key(nvs_handle, CRED_STORE_NVS_KEY);
+        nvs_commit(nvs_handle);
+        nvs_close(nvs_handle);
+    }
+}
+
+static bool credential_store_select(const char *exclude_ssid, wifi_config_t *config)
+{
+    int best = -1;
+
+    portENTER_CRITICAL(&s_cred_store_spinlock);
+    for (int i = 0; i < s_cred_store.count; i++) {
+        if (exclude_ssid != NULL && strcmp(s_cred_store.entries[i].ssid, exclude_ssid) == 0) {
+            continue;
+        }
+        if (best < 0 || credential_score(&s_cred_store.entries[i]) > credential_score(&s_cred_store.entries[best])) {
+            best = i;
+        }
+    }
+    if (best >= 0) {
+        memset(config, 0, sizeof(wifi_config_t));
+        strncpy((char *)config->sta.ssid, s_cred_store.entries[best].ssid, sizeof(config->sta.ssid) - 1);
+        strncpy((char *)config->sta.password, s_cred_store.entries[best].password, sizeof(config->sta.password) - 1);
+    }
+    portEXIT_CRITICAL(&s_cred_store_spinlock);
+
+    return best >= 0;
+}
+
+// Fills order[] with entry indices best first, ties kept in slot order like
+// credential_store_select(). Caller holds s_cred_store_spinlock.
+static void credential_store_ranking(uint8_t *order)
+{
+    for (int i = 0; i < s_cred_store.count; i++) {
+        int j = i;
+        while (j > 0 && credential_score(&s_cred_store.entries[i]) >
+                        credential_score(&s_cred_store.entries[order[j - 1]])) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = (uint8_t)i;
+    }
+}
+
+static void credential_store_record_result(const char *ssid, bool success, int8_t rssi)
+{
+    uint8_t before[CONFIG_WIFI_MANAGER_MAX_NETWORKS];
+    uint8_t after[CONFIG_WIFI_MANAGER_MAX_NETWORKS];
+    bool found = false;
+    bool reranked = false;
+
+    portENTER_CRITICAL(&s_cred_store_spinlock);
+    credential_store_ranking(before);
+    for (int i = 0; i < s_cred_store.count; i++) {
+        wifi_credential_t *cred = &s_cred_store.entries[i];
+        if (strcmp(cred->ssid, ssid) != 0) {
+            continue;
+        }
+        if (success) {
+            if (cred->success_count < UINT16_MAX) {
+                cred->success_count++;
+            }
+            cred->fail_streak = 0;
+            if (rssi != 0) {
+                cred->last_rssi = rssi;
+            }
+        } else if (cred->fail_streak < UINT8_MAX) {
+            cred->fail_streak++;
+        }
+        found = true;
+        break;
+    }
+    if (found) {
+        credential_store_ranking(after);
+        reranked = memcmp(before, after, s_cred_store.count) != 0;
+    }
+    portEXIT_CRITICAL(&s_cred_store_spinlock);
+
+    // Counters and RSSI stay in RAM until the order they feed changes; the
+    // next save (or re-rank) carries them along
+    if (reranked) {
+        persist_schedule(PERSIST_CRED_STORE);
+    }
+}
+
+/* ============================================================================
+ * DEFERRED PERSISTENCE IMPLEMENTATION
+ * ============================================================================ */
+
+static void persist_schedule(uint32_t what)
+{
+    portENTER_CRITICAL(&s_persist_spinlock);
+    s_persist_pending |= what;
+    portEXIT_CRITICAL(&s_persist_spinlock);
+
+    if (s_persist_timer == NULL) {
+        return;  // Picked up by the next persist_flush()
+    }
+
+    // Already armed: the pending write picks up this change too
+    esp_err_t ret = esp_timer_start_once(s_persist_timer, (uint64_t)PERSIST_DELAY_MS * 1000);
+    if (ret != ESP_OK && ret != ESP_ERR_INVALID_STATE) {
+        ESP_LOGW(TAG, "Failed to schedule NVS write: %s", esp_err_to_name(ret));
+    }
+}
+
+static void persist_timer_callback(void *arg)
+{
+    (void)arg;
+
+    portENTER_CRITICAL(&s_persist_spinlock);
+    uint32_t pending = s_persist_pending;
+    s_persist_pending = 0;
+    fast_connect_cache_t cache = s_fast_connect;
+    portEXIT_CRITICAL(&s_persist_spinlock);
+
+    if (pending & PERSIST_FAST_CONNECT) {
+        fast_connect_cache_persist(&cache);
+    }
+    if (pending & PERSIST_CRED_STORE) {
+        credential_store_save();
+    }
+}
+
+static void persist_flush(void)
+{
+    if (s_persist_timer != NULL) {
+        esp_timer_stop(s_persist_timer);
+    }
+    persist_timer_callback(NULL);
+}
+
+static void roam_timer_callback(void *arg)
+{
+    portENTER_CRITICAL(&s_conn_manager_spinlock);
+    bool connected = s_conn_manager.connected;
+    bool busy = s_conn_manager.validating || s_conn_manager.roam_pending;
+    portEXIT_CRITICAL(&s_conn_manager_spinlock);
+
+    wifi_ap_record_t ap_info;
+    if (!connected || busy || esp_wifi_sta_get_ap_info(&ap_info) != ESP_OK) {
+        s_roam.low_rssi_samples = 0;
+        return;
+    }
+
+    s_roam.current_rssi = ap_info.rssi;
+
+    if (ap_info.rssi >= CONFIG_WIFI_MANAGER_ROAM_RSSI_THRESHOLD) {
+        s_roam.low_rssi_samples = 0;
+        return;
+    }
+
+    if (++s_roam.low_rssi_samples < ROAM_LOW_RSSI_SAMPLES || s_roam.scan_pending) {
+        return;
+    }
+
+    ESP_LOGW(TAG, "RSSI %d dBm below %d dBm for %d samples - scanning for a better AP",
+             ap_info.rssi, CONFIG_WIFI_MANAGER_ROAM_RSSI_THRESHOLD, ROAM_LOW_RSSI_SAMPLES);
+
+    wifi_scan_config_t scan_config = {
+        .show_hidden = false,
+        .scan_type = WIFI_SCAN_TYPE_ACTIVE,
+        .scan_time.active.min = 50,
+        .scan_time.active.max = 150
+    };
+    if (esp_wifi_scan_start(&scan_config, false) == ESP_OK) {
+        s_roam.scan_pending = true;
+    }
+    s_roam.low_rssi_samples = 0;
+}
+
+static void roam_scan_done_handler(void* arg, esp_event_base_t event_base,
+                                   int32_t event_id, void* event_data)
+{
+    if (!s_roam.scan_pending) {
+        return;  // Not our scan (provisioning portal)
+    }
+    s_roam.scan_pending = false;
+
+    uint16_t ap_count = PROV_SCAN_MAX_RECORDS;
+    wifi_ap_record_t *ap_list = calloc(ap_count, sizeof(wifi_ap_record_t));
+    if (ap_list == NULL) {
+        esp_wifi_clear_ap_list();
+        return;
+    }
+    if (esp_wifi_scan_get_ap_records(&ap_count, ap_list) != ESP_OK) {
+        free(ap_list);
+        return;
+    }
+
+    wifi_ap_record_t current;
+    if (esp_wifi_sta_get_ap_info(&current) != ESP_OK) {
+        free(ap_list);
+        return;
+    }
+
+    // Refresh last-known RSSI of stored networks and pick the strongest candidate
+    int best = -1;
+    portENTER_CRITICAL(&s_cred_store_spinlock);
+    for (int i = 0; i < ap_count; i++) {
+        for (int j = 0; j < s_cred_store.count; j++) {
+            if (strncmp((char *)ap_list[i].ssid, s_cred_store.entries[j].ssid, sizeof(ap_list[i].ssid)) != 0) {
+                continue;
+            }
+            if (s_cred_store.entries[j].last_rssi == 0 || ap_list[i].rssi > s_cred_store.entries[j].last_rssi) {
+                s_cred_store.entries[j].last_rssi = ap_list[i].rssi;
+            }
+            if (memcmp(ap_list[i].bssid, current.bssid, sizeof(current.bssid)) != 0 &&
+                s_cred_store.entries[j].fail_streak == 0 &&
+                (best < 0 || ap_list[i].rssi > ap_list[best].rssi)) {
+                best = i;
+            }
+        }
+    }
+
+    wifi_config_t roam_config = {0};
+    bool roam = (best >= 0 && ap_list[best].rssi >= current.rssi + CONFIG_WIFI_MANAGER_ROAM_RSSI_HYSTERESIS);
+    if (roam) {
+        for (int j = 0; j < s_cred_store.count; j++) {
+            if (strncmp((char *)ap_list[best].ssid, s_cred_store.entries[j].ssid, sizeof(ap_list[best].ssid)) == 0) {
+                strncpy((char *)roam_config.sta.ssid, s_cred_store.entries[j].ssid, sizeof(roam_config.sta.ssid) - 1);
+                strncpy((char *)roam_config.sta.password, s_cred_store.entries[j].password, sizeof(roam_config.sta.password) - 1);
+                break;
+            }
+        }
+    }
+    portEXIT_CRITICAL(&s_cred_store_spinlock);
+
+    if (!roam) {
+        ESP_LOGD(TAG, "No stronger AP found (current %d dBm)", current.rssi);
+        free(ap_list);
+        return;
+    }
+
+    ESP_LOGW(TAG, "Roaming from %d dBm to '%s' " MACSTR " (%d dBm, channel %d)",
+             current.rssi, roam_config.sta.ssid, MAC2STR(ap_list[best].bssid),
+             ap_list[best].rssi, ap_list[best].primary);
+
+    roam_config.sta.bssid_set = true;
+    memcpy(roam_config.sta.bssid, ap_list[best].bssid, sizeof(roam_config.sta.bssid));
+    roam_config.sta.channel = ap_list[best].primary;
+    free(ap_list);
+
+    portENTER_CRITICAL(&s_conn_manager_spinlock);
+    s_conn_manager.roam_config = roam_config;
+    s_conn_manager.roam_pending = true;
+    portEXIT_CRITICAL(&s_conn_manager_spinlock);
+
+    // The DISCONNECTED handler applies roam_config and associates immediately
+    esp_wifi_disconnect();
+}
+
+/* ============================================================================
+ * CONNECTION MANAGER IMPLEMENTATION
+ * ============================================================================ */
+
+static void connection_timing_mark_attempt(bool new_connection)
+{
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&s_conn_manager_spinlock);
+    if (new_connection) {
+        s_conn_manager.connect_start_us = now;
+        s_conn_manager.attempts = 0;
+    }
+    s_conn_manager.attempt_start_us = now;
+    s_conn_manager.link_up_us = 0;
+    if (s_conn_manager.attempts < UINT8_MAX) {
+        s_conn_manager.attempts++;
+    }
+    portEXIT_CRITICAL(&s_conn_manager_spinlock);
+}
+
+static void connection_manager_fallback_to_scan(uint8_t reason)
+{
+    ESP_LOGW(TAG, "Fast connect failed (reason: %d), falling back to full scan", reason);
+
+    fast_connect_cache_invalidate();
+
+    wifi_config_t scan_config;
+    portENTER_CRITICAL(&s_conn_manager_spinlock);
+    scan_config = s_conn_manager.scan_config;
+    s_conn_manager.bssid_locked = false;
+    s_conn_manager.state = WIFI_CONNECTION_STATE_CONNECTING;
+    portEXIT_CRITICAL(&s_conn_manager_spinlock);
+
+    esp_err_t ret = esp_wifi_set_config(WIFI_IF_STA, &scan_config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to restore scan config: %s", esp_err_to_name(ret));
+    }
+
+    connection_timing_mark_attempt(false);
+    esp_wifi_connect();
+}
+
+static reconnect_class_t connection_classify_reason(uint8_t reason)
+{
+    switch (reason) {
+        case WIFI_REASON_AUTH_EXPIRE:
+        case WIFI_REASON_AUTH_FAIL:
+        case WIFI_REASON_4WAY_HANDSHAKE_TIMEOUT:
+        case WIFI_REASON_HANDSHAKE_TIMEOUT:
+            return RECONNECT_CLASS_AUTH;
+
+        case WIFI_REASON_NO_AP_FOUND:
+            return RECONNECT_CLASS_NO_AP;
+
+        default:
+            return RECONNECT_CLASS_TRANSIENT;
+    }
+}
+
+static uint32_t connection_backoff_delay_ms(reconnect_class_t reconnect_class, int retry_count)
+{
+    uint32_t delay_ms = s_reconnect_min_ms[reconnect_class];
+
+    for (int i = 0; i < retry_count && delay_ms < CONFIG_WIFI_MANAGER_RECONNECT_MAX_MS; i++) {
+        delay_ms *= 2;
+    }
+    if (delay_ms > CONFIG_WIFI_MANAGER_RECONNECT_MAX_MS) {
+        delay_ms = CONFIG_WIFI_MANAGER_RECONNECT_MAX_MS;
+    }
+
+    // +/-25% jitter so devices sharing an AP do not reconnect in lockstep
+    uint32_t jitter_ms = delay_ms / 4;
+    if (jitter_ms > 0) {
+        delay_ms = delay_ms - jitter_ms + (esp_random() % (2 * jitter_ms + 1));
+    }
+
+    return delay_ms;
 }
 
-static bool boot_counter_is_in_time_window(void)
+static void connection_manager_schedule_reconnect(uint32_t delay_ms)
 {
-    if (s_boot_counter.boot_count == 0) {
-        return false;
+    if (s_conn_manager.reconnect_timer == NULL) {
+        return;
     }
 
-    uint32_t current_time = (uint32_t)(esp_timer_get_time() / 1000);
-    uint32_t time_since_first = current_time - s_boot_counter.first_boot_time;
-
-    return time_since_first <= BOOT_COUNTER_TIME_WINDOW_MS;
+    esp_timer_stop(s_conn_manager.reconnect_timer);
+    esp_err_t ret = esp_timer_start_once(s_conn_manager.reconnect_timer, (uint64_t)delay_ms * 1000);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to schedule reconnect: %s", esp_err_to_name(ret));
+    }
 }
 
-static esp_err_t boot_counter_set_normal_operation(void)
+static void connection_manager_cancel_reconnect(void)
 {
-    ESP_LOGI(TAG, "Setting normal operation mode - clearing boot counter");
-    return boot_counter_clear();
+    if (s_conn_manager.reconnect_timer != NULL) {
+        esp_timer_stop(s_conn_manager.reconnect_timer);
+    }
 }
 
-/* ============================================================================
- * CONNECTION MANAGER IMPLEMENTATION
- * ============================================================================ */
+static void reconnect_timer_callback(void *arg)
+{
+    portENTER_CRITICAL(&s_conn_manager_spinlock);
+    bool auto_reconnect = s_conn_manager.auto_reconnect;
+    if (auto_reconnect) {
+        s_conn_manager.state = WIFI_CONNECTION_STATE_CONNECTING;
+    }
+    portEXIT_CRITICAL(&s_conn_manager_spinlock);
+
+    if (!auto_reconnect) {
+        return;
+    }
+
+    connection_timing_mark_attempt(false);
+    esp_err_t ret = esp_wifi_connect();
+    if (ret != ESP_OK && ret != ESP_ERR_WIFI_CONN) {
+        ESP_LOGW(TAG, "Reconnect attempt failed to start: %s", esp_err_to_name(ret));
+    }
+}
 
 static void connection_event_handler(void* arg, esp_event_base_t event_base,
                                      int32_t event_id, void* event_data)
@@ -280,54 +1050,165 @@ static void connection_event_handler(void* arg, esp_event_base_t event_base,
         portENTER_CRITICAL(&s_conn_manager_spinlock);
         s_conn_manager.state = WIFI_CONNECTION_STATE_CONNECTING;
         portEXIT_CRITICAL(&s_conn_manager_spinlock);
+        connection_timing_mark_attempt(true);
         esp_wifi_connect();
 
+    } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_CONNECTED) {
+        wifi_event_sta_connected_t* connected = (wifi_event_sta_connected_t*) event_data;
+
+        portENTER_CRITICAL(&s_conn_manager_spinlock);
+        s_conn_manager.link_up_us = esp_timer_get_time();
+        memcpy(s_conn_manager.ap_bssid, connected->bssid, sizeof(s_conn_manager.ap_bssid));
+        s_conn_manager.ap_channel = connected->channel;
+        portEXIT_CRITICAL(&s_conn_manager_spinlock);
+
+        ESP_LOGD(TAG, "Associated with " MACSTR " on channel %d", MAC2STR(connected->bssid), connected->channel);
+
     } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
         wifi_event_sta_disconnected_t* disconnected = (wifi_event_sta_disconnected_t*) event_data;
 
         portENTER_CRITICAL(&s_conn_manager_spinlock);
+        bool was_connected = s_conn_manager.connected;
+        bool bssid_locked = s_conn_manager.bssid_locked;
+        bool auto_reconnect = s_conn_manager.auto_reconnect;
+        bool validating = s_conn_manager.validating;
+        bool roam_pending = s_conn_manager.roam_pending;
+        s_conn_manager.roam_pending = false;
         s_conn_manager.state = WIFI_CONNECTION_STATE_DISCONNECTED;
         s_conn_manager.connected = false;
         s_conn_manager.has_ip = false;
+        if (was_connected) {
+            s_conn_manager.connect_start_us = esp_timer_get_time();
+            s_conn_manager.attempts = 0;
+        }
         portEXIT_CRITICAL(&s_conn_manager_spinlock);
 
+        xEventGroupClearBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
+
         ESP_LOGW(TAG, "WiFi disconnected - reason: %d, SSID: %s", disconnected->reason, disconnected->ssid);
 
-        // Check specific disconnection reasons
-        if (disconnected->reason == WIFI_REASON_AUTH_EXPIRE ||
-            disconnected->reason == WIFI_REASON_AUTH_FAIL ||
-            disconnected->reason == WIFI_REASON_4WAY_HANDSHAKE_TIMEOUT ||
-            disconnected->reason == WIFI_REASON_HANDSHAKE_TIMEOUT) {
-            ESP_LOGE(TAG, "WiFi authentication failed - incorrect password");
+        if (!auto_reconnect) {
+            ESP_LOGD(TAG, "Disconnect requested locally - not reconnecting");
+            return;
+        }
+
+        if (roam_pending) {
+            // Associate with the roaming target; if it fails the fast-path
+            // fallback below scans for the same SSID
+            wifi_config_t roam_config;
             portENTER_CRITICAL(&s_conn_manager_spinlock);
-            s_conn_manager.state = WIFI_CONNECTION_STATE_FAILED;
+            roam_config = s_conn_manager.roam_config;
+            s_conn_manager.scan_config = roam_config;
+            s_conn_manager.scan_config.sta.bssid_set = false;
+            s_conn_manager.scan_config.sta.channel = 0;
+            s_conn_manager.bssid_locked = true;
+            s_conn_manager.retry_count = 0;
+            strncpy(s_conn_manager.ssid, (char *)roam_config.sta.ssid, sizeof(s_conn_manager.ssid) - 1);
+            s_conn_manager.ssid[sizeof(s_conn_manager.ssid) - 1] = '\0';
+            s_conn_manager.state = WIFI_CONNECTION_STATE_CONNECTING;
             portEXIT_CRITICAL(&s_conn_manager_spinlock);
-            xEventGroupSetBits(s_wifi_event_group, WIFI_FAIL_BIT);
-            esp_event_post(WIFI_MANAGER_CONNECTION_EVENTS, WIFI_CONNECTION_EVENT_AUTH_FAILED, &disconnected->reason, sizeof(uint8_t), portMAX_DELAY);
+
+            esp_wifi_set_config(WIFI_IF_STA, &roam_config);
+            connection_timing_mark_attempt(false);
+            esp_wifi_connect();
+            esp_event_post(WIFI_MANAGER_CONNECTION_EVENTS, WIFI_CONNECTION_EVENT_DISCONNECTED, NULL, 0, portMAX_DELAY);
+            return;
+        }
+
+        reconnect_class_t reconnect_class = connection_classify_reason(disconnected->reason);
+
+        // A failed attempt on the cached BSSID/channel falls back to a full scan
+        // before any retry is consumed; a drop of an established link retries it first
+        if (bssid_locked && !was_connected && reconnect_class != RECONNECT_CLASS_AUTH) {
+            connection_manager_fallback_to_scan(disconnected->reason);
             return;
-        } else if (disconnected->reason == WIFI_REASON_NO_AP_FOUND) {
-            ESP_LOGE(TAG, "WiFi network not found - check SSID");
+        }
+
+        if (validating) {
+            // Credential validation needs a fast, definitive answer: no backoff
+            if (reconnect_class == RECONNECT_CLASS_AUTH) {
+                ESP_LOGE(TAG, "WiFi authentication failed - incorrect password");
+                portENTER_CRITICAL(&s_conn_manager_spinlock);
+                s_conn_manager.state = WIFI_CONNECTION_STATE_FAILED;
+                portEXIT_CRITICAL(&s_conn_manager_spinlock);
+                xEventGroupSetBits(s_wifi_event_group, WIFI_FAIL_BIT);
+                esp_event_post(WIFI_MANAGER_CONNECTION_EVENTS, WIFI_CONNECTION_EVENT_AUTH_FAILED, &disconnected->reason, sizeof(uint8_t), portMAX_DELAY);
+                return;
+            } else if (reconnect_class == RECONNECT_CLASS_NO_AP) {
+                ESP_LOGE(TAG, "WiFi network not found - check SSID");
+                portENTER_CRITICAL(&s_conn_manager_spinlock);
+                s_conn_manager.state = WIFI_CONNECTION_STATE_FAILED;
+                portEXIT_CRITICAL(&s_conn_manager_spinlock);
+                xEventGroupSetBits(s_wifi_event_group, WIFI_FAIL_BIT);
+                esp_event_post(WIFI_MANAGER_CONNECTION_EVENTS, WIFI_CONNECTION_EVENT_NETWORK_NOT_FOUND, &disconnected->reason, sizeof(uint8_t), portMAX_DELAY);
+                return;
+            }
+
             portENTER_CRITICAL(&s_conn_manager_spinlock);
-            s_conn_manager.state = WIFI_CONNECTION_STATE_FAILED;
+            int retry_count = s_conn_manager.retry_count;
+            int max_retries = s_conn_manager.max_retries;
             portEXIT_CRITICAL(&s_conn_manager_spinlock);
-            xEventGroupSetBits(s_wifi_event_group, WIFI_FAIL_BIT);
-            esp_event_post(WIFI_MANAGER_CONNECTION_EVENTS, WIFI_CONNECTION_EVENT_NETWORK_NOT_FOUND, &disconnected->reason, sizeof(uint8_t), portMAX_DELAY);
+
+            if (retry_count < max_retries) {
+                connection_timing_mark_attempt(false);
+                esp_wifi_connect();
+                portENTER_CRITICAL(&s_conn_manager_spinlock);
+                s_conn_manager.retry_count++;
+                portEXIT_CRITICAL(&s_conn_manager_spinlock);
+                ESP_LOGD(TAG, "Retry connection (%d/%d)", retry_count + 1, max_retries);
+            } else {
+                ESP_LOGE(TAG, "WiFi connection failed after %d retries", max_retries);
+                portENTER_CRITICAL(&s_conn_manager_spinlock);
+                s_conn_manager.state = WIFI_CONNECTION_STATE_FAILED;
+                portEXIT_CRITICAL(&s_conn_manager_spinlock);
+                xEventGroupSetBits(s_wifi_event_group, WIFI_FAIL_BIT);
+                esp_event_post(WIFI_MANAGER_CONNECTION_EVENTS, WIFI_CONNECTION_EVENT_RETRY_EXHAUSTED, NULL, 0, portMAX_DELAY);
+            }
+
+            esp_event_post(WIFI_MANAGER_CONNECTION_EVENTS, WIFI_CONNECTION_EVENT_DISCONNECTED, NULL, 0, portMAX_DELAY);
             return;
         }
 
+        // Normal operation: never give up, back off according to the failure class
+        if (reconnect_class == RECONNECT_CLASS_AUTH) {
+            esp_event_post(WIFI_MANAGER_CONNECTION_EVENTS, WIFI_CONNECTION_EVENT_AUTH_FAILED, &disconnected->reason, sizeof(uint8_t), portMAX_DELAY);
+        } else if (reconnect_class == RECONNECT_CLASS_NO_AP) {
+            esp_event_post(WIFI_MANAGER_CONNECTION_EVENTS, WIFI_CONNECTION_EVENT_NETWORK_NOT_FOUND, &disconnected->reason, sizeof(uint8_t), portMAX_DELAY);
+        }
+
+        // Saturate the attempt counter during long outages; it still passes
+        // max_retries exactly once for the failover below
         portENTER_CRITICAL(&s_conn_manager_spinlock);
         int retry_count = s_conn_manager.retry_count;
         int max_retries = s_conn_manager.max_retries;
+        if (retry_count < RECONNECT_RETRY_COUNT_CAP || retry_count < max_retries) {
+            s_conn_manager.retry_count++;
+        }
         portEXIT_CRITICAL(&s_conn_manager_spinlock);
 
-        if (retry_count < max_retries) {
-            esp_wifi_connect();
+        if (retry_count + 1 == max_retries) {
+            char failed_ssid[33];
             portENTER_CRITICAL(&s_conn_manager_spinlock);
-            s_conn_manager.retry_count++;
+            strncpy(failed_ssid, s_conn_manager.ssid, sizeof(failed_ssid));
             portEXIT_CRITICAL(&s_conn_manager_spinlock);
-            ESP_LOGD(TAG, "Retry connection (%d/%d)", retry_count + 1, max_retries);
-        } else {
-            ESP_LOGE(TAG, "WiFi connection failed after %d retries", max_retries);
+            credential_store_record_result(failed_ssid, false, 0);
+
+            // Fail over to the next ranked network, if any, with a fresh retry budget
+            wifi_config_t next_config;
+            if (credential_store_select(failed_ssid, &next_config)) {
+                ESP_LOGW(TAG, "'%s' failed %d times - switching to '%s'",
+                         failed_ssid, max_retries, next_config.sta.ssid);
+                esp_err_t ret = connection_manager_connect(&next_config);
+                if (ret == ESP_OK) {
+                    if (was_connected) {
+                        esp_event_post(WIFI_MANAGER_CONNECTION_EVENTS, WIFI_CONNECTION_EVENT_DISCONNECTED, NULL, 0, portMAX_DELAY);
+                    }
+                    return;
+                }
+                ESP_LOGE(TAG, "Failover to '%s' failed: %s", next_config.sta.ssid, esp_err_to_name(ret));
+            }
+
+            ESP_LOGE(TAG, "WiFi connection failed after %d retries - continuing with backoff", max_retries);
             portENTER_CRITICAL(&s_conn_manager_spinlock);
             s_conn_manager.state = WIFI_CONNECTION_STATE_FAILED;
             portEXIT_CRITICAL(&s_conn_manager_spinlock);
@@ -335,7 +1216,14 @@ static void connection_event_handler(void* arg, esp_event_base_t event_base,
             esp_event_post(WIFI_MANAGER_CONNECTION_EVENTS, WIFI_CONNECTION_EVENT_RETRY_EXHAUSTED, NULL, 0, portMAX_DELAY);
         }
 
-        esp_event_post(WIFI_MANAGER_CONNECTION_EVENTS, WIFI_CONNECTION_EVENT_DISCONNECTED, NULL, 0, portMAX_DELAY);
+        uint32_t delay_ms = connection_backoff_delay_ms(reconnect_class, retry_count);
+        connection_manager_schedule_reconnect(delay_ms);
+        ESP_LOGW(TAG, "Reconnecting in %lu ms (attempt %d, class %d)", delay_ms, retry_count + 1, reconnect_class);
+
+        esp_event_post(WIFI_MANAGER_CONNECTION_EVENTS, WIFI_CONNECTION_EVENT_RECONNECT_SCHEDULED, &delay_ms, sizeof(delay_ms), portMAX_DELAY);
+        if (was_connected) {
+            esp_event_post(WIFI_MANAGER_CONNECTION_EVENTS, WIFI_CONNECTION_EVENT_DISCONNECTED, NULL, 0, portMAX_DELAY);
+        }
 
     } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
         ip_event_got_ip_t* event = (ip_event_got_ip_t*) event_data;
@@ -350,14 +1238,45 @@ static void connection_event_handler(void* arg, esp_event_base_t event_base,
         ESP_LOGD(TAG, "Connected to WiFi network: '%s'", ssid_copy);
         ESP_LOGD(TAG, "Got IP address: " IPSTR, IP2STR(&event->ip_info.ip));
 
+        int64_t now = esp_timer_get_time();
+        uint8_t ap_bssid[6];
+        uint8_t ap_channel;
+        bool new_link;
+
         portENTER_CRITICAL(&s_conn_manager_spinlock);
+        new_link = !s_conn_manager.connected;
+        if (new_link) {
+            wifi_manager_connect_timing_t *timing = &s_conn_manager.timing;
+            int64_t link_up_us = s_conn_manager.link_up_us ? s_conn_manager.link_up_us : now;
+            timing->assoc_ms = (uint32_t)((link_up_us - s_conn_manager.attempt_start_us) / 1000);
+            timing->dhcp_ms = (uint32_t)((now - link_up_us) / 1000);
+            timing->total_ms = (uint32_t)((now - s_conn_manager.connect_start_us) / 1000);
+            timing->attempts = s_conn_manager.attempts;
+            timing->fast_path = s_conn_manager.bssid_locked;
+        }
+        memcpy(ap_bssid, s_conn_manager.ap_bssid, sizeof(ap_bssid));
+        ap_channel = s_conn_manager.ap_channel;
         s_conn_manager.state = WIFI_CONNECTION_STATE_CONNECTED;
         s_conn_manager.connected = true;
         s_conn_manager.has_ip = true;
         s_conn_manager.retry_count = 0;
         s_conn_manager.ip_addr = event->ip_info.ip;
+        wifi_manager_connect_timing_t timing = s_conn_manager.timing;
         portEXIT_CRITICAL(&s_conn_manager_spinlock);
 
+        if (new_link) {
+            ESP_LOGI(TAG, "Connected in %lu ms (assoc %lu ms, dhcp %lu ms, attempts %d, %s)",
+                     timing.total_ms, timing.assoc_ms, timing.dhcp_ms, timing.attempts,
+                     timing.fast_path ? "fast path" : "full scan");
+            fast_connect_cache_store(ssid_copy, ap_bssid, ap_channel);
+
+            wifi_ap_record_t ap_info;
+            int8_t rssi = (esp_wifi_sta_get_ap_info(&ap_info) == ESP_OK) ? ap_info.rssi : 0;
+            s_roam.current_rssi = rssi;
+            s_roam.low_rssi_samples = 0;
+            credential_store_record_result(ssid_copy, true, rssi);
+        }
+
         xEventGroupSetBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
 
         esp_event_post(WIFI_MANAGER_CONNECTION_EVENTS, WIFI_CONNECTION_EVENT_CONNECTED, NULL, 0, portMAX_DELAY);
@@ -382,6 +1301,25 @@ static esp_err_t connection_manager_init(void)
         return ESP_FAIL;
     }
 
+#ifdef CONFIG_WIFI_MANAGER_STATIC_IP
+    esp_netif_ip_info_t static_ip = {0};
+    esp_netif_dns_info_t static_dns = {0};
+    static_dns.ip.type = ESP_IPADDR_TYPE_V4;
+    if (esp_netif_str_to_ip4(CONFIG_WIFI_MANAGER_STATIC_IP_ADDR, &static_ip.ip) != ESP_OK ||
+        esp_netif_str_to_ip4(CONFIG_WIFI_MANAGER_STATIC_IP_NETMASK, &static_ip.netmask) != ESP_OK ||
+        esp_netif_str_to_ip4(CONFIG_WIFI_MANAGER_STATIC_IP_GATEWAY, &static_ip.gw) != ESP_OK ||
+        esp_netif_str_to_ip4(CONFIG_WIFI_MANAGER_STATIC_IP_DNS, &static_dns.ip.u_addr.ip4) != ESP_OK) {
+        ESP_LOGE(TAG, "Invalid static IP configuration - using DHCP");
+    } else {
+        esp_netif_dhcpc_stop(s_sta_netif);
+        ESP_ERROR_CHECK(esp_netif_set_ip_info(s_sta_netif, &static_ip));
+        ESP_ERROR_CHECK(esp_netif_set_dns_info(s_sta_netif, ESP_NETIF_DNS_MAIN, &static_dns));
+        ESP_LOGI(TAG, "Static IP configured: " IPSTR, IP2STR(&static_ip.ip));
+    }
+#endif
+
+    fast_connect_cache_load();
+
     wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
     ESP_ERROR_CHECK(esp_wifi_init(&cfg));
 
@@ -390,6 +1328,30 @@ static esp_err_t connection_manager_init(void)
 
     ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
 
+    const esp_timer_create_args_t reconnect_timer_args = {
+        .callback = reconnect_timer_callback,
+        .name = "wifi_reconnect"
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&reconnect_timer_args, &s_conn_manager.reconnect_timer));
+
+    const esp_timer_create_args_t persist_timer_args = {
+        .callback = persist_timer_callback,
+        .name = "wifi_persist"
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&persist_timer_args, &s_persist_timer));
+
+    credential_store_load();
+
+#ifdef CONFIG_WIFI_MANAGER_ROAMING
+    const esp_timer_create_args_t roam_timer_args = {
+        .callback = roam_timer_callback,
+        .name = "wifi_roam"
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&roam_timer_args, &s_roam.timer));
+    ESP_ERROR_CHECK(esp_event_handler_register(WIFI_EVENT, WIFI_EVENT_SCAN_DONE, &roam_scan_done_handler, NULL));
+    esp_timer_start_periodic(s_roam.timer, (uint64_t)ROAM_CHECK_INTERVAL_MS * 1000);
+#endif
+
     s_conn_manager.state = WIFI_CONNECTION_STATE_IDLE;
     s_conn_manager.connected = false;
     s_conn_manager.has_ip = false;
@@ -413,6 +1375,8 @@ static esp_err_t connection_manager_start(void)
 static esp_err_t connection_manager_stop(void)
 {
     ESP_LOGD(TAG, "Stopping connection manager");
+    s_conn_manager.auto_reconnect = false;
+    connection_manager_cancel_reconnect();
     ESP_ERROR_CHECK(esp_wifi_stop());
 
     s_conn_manager.state = WIFI_CONNECTION_STATE_IDLE;
@@ -434,6 +1398,24 @@ static esp_err_t connection_manager_deinit(void)
 
     ESP_ERROR_CHECK(esp_wifi_deinit());
 
+    if (s_conn_manager.reconnect_timer) {
+        esp_timer_delete(s_conn_manager.reconnect_timer);
+        s_conn_manager.reconnect_timer = NULL;
+    }
+
+    persist_flush();
+    if (s_persist_timer) {
+        esp_timer_delete(s_persist_timer);
+        s_persist_timer = NULL;
+    }
+
+    if (s_roam.timer) {
+        esp_timer_stop(s_roam.timer);
+        esp_timer_delete(s_roam.timer);
+        s_roam.timer = NULL;
+        esp_event_handler_unregister(WIFI_EVENT, WIFI_EVENT_SCAN_DONE, &roam_scan_done_handler);
+    }
+
     if (s_sta_netif) {
         esp_netif_destroy(s_sta_netif);
         s_sta_netif = NULL;
@@ -456,17 +1438,38 @@ static esp_err_t connection_manager_connect(const wifi_config_t *config)
 
     ESP_LOGD(TAG, "Connecting to WiFi network: %s", config->sta.ssid);
 
-    ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, (wifi_config_t *)config));
+    // Stored configs may carry a BSSID lock from a previous fast connect
+    wifi_config_t sta_config = *config;
+    sta_config.sta.bssid_set = false;
+    sta_config.sta.channel = 0;
+    s_conn_manager.scan_config = sta_config;
+
+    bool fast_path = fast_connect_cache_apply(&sta_config);
+    if (fast_path) {
+        ESP_LOGD(TAG, "Fast connect: " MACSTR " channel %d",
+                 MAC2STR(sta_config.sta.bssid), sta_config.sta.channel);
+    }
+
+    esp_err_t ret = esp_wifi_set_config(WIFI_IF_STA, &sta_config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set WiFi config: %s", esp_err_to_name(ret));
+        return ret;
+    }
 
     strncpy(s_conn_manager.ssid, (char *)config->sta.ssid, sizeof(s_conn_manager.ssid) - 1);
     s_conn_manager.ssid[sizeof(s_conn_manager.ssid) - 1] = '\0';
 
     s_conn_manager.retry_count = 0;
     s_conn_manager.state = WIFI_CONNECTION_STATE_CONNECTING;
+    s_conn_manager.bssid_locked = fast_path;
+    s_conn_manager.auto_reconnect = true;
+    s_conn_manager.roam_pending = false;
+    connection_manager_cancel_reconnect();
 
     xEventGroupClearBits(s_wifi_event_group, WIFI_CONNECTED_BIT | WIFI_FAIL_BIT);
+    connection_timing_mark_attempt(true);
 
-    esp_err_t ret = esp_wifi_connect();
+    ret = esp_wifi_connect();
     if (ret == ESP_ERR_WIFI_CONN) {
         ESP_LOGW(TAG, "WiFi already connecting, waiting for connection result");
         return ESP_OK;
@@ -482,6 +1485,8 @@ static esp_err_t connection_manager_disconnect(void)
 {
     ESP_LOGD(TAG, "Disconnecting from WiFi");
 
+    s_conn_manager.auto_reconnect = false;
+    connection_manager_cancel_reconnect();
     ESP_ERROR_CHECK(esp_wifi_disconnect());
 
     s_conn_manager.state = WIFI_CONNECTION_STATE_DISCONNECTED;
@@ -591,9 +1596,21 @@ static esp_err_t prov_manager_validate_credentials(const char* ssid, const char*
     portEXIT_CRITICAL(&s_validation_spinlock);
     xEventGroupClearBits(s_validation_event_group, VALIDATION_SUCCESS_BIT | VALIDATION_FAILED_BIT);
 
+    portENTER_CRITICAL(&s_conn_manager_spinlock);
+    s_conn_manager.validating = true;
+    portEXIT_CRITICAL(&s_conn_manager_spinlock);
+
+    // A background scan in flight would make the association attempt fail
+    if (s_scan_in_progress) {
+        esp_wifi_scan_stop();
+    }
+
     ret = connection_manager_connect(&validation_config);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to start validation connection: %s", esp_err_to_name(ret));
+        portENTER_CRITICAL(&s_conn_manager_spinlock);
+        s_conn_manager.validating = false;
+        portEXIT_CRITICAL(&s_conn_manager_spinlock);
         esp_event_handler_unregister(WIFI_MANAGER_CONNECTION_EVENTS, ESP_EVENT_ANY_ID, &prov_validation_event_handler);
         return ret;
     }
@@ -605,6 +1622,10 @@ static esp_err_t prov_manager_validate_credentials(const char* ssid, const char*
 
     esp_event_handler_unregister(WIFI_MANAGER_CONNECTION_EVENTS, ESP_EVENT_ANY_ID, &prov_validation_event_handler);
 
+    portENTER_CRITICAL(&s_conn_manager_spinlock);
+    s_conn_manager.validating = false;
+    portEXIT_CRITICAL(&s_conn_manager_spinlock);
+
     if (bits & VALIDATION_SUCCESS_BIT) {
         ESP_LOGI(TAG, "WiFi credential validation successful");
         *result = WIFI_VALIDATION_OK;
@@ -646,17 +1667,40 @@ static esp_err_t root_get_handler(httpd_req_t *req)
     return ESP_OK;
 }
 
-static esp_err_t scan_get_handler(httpd_req_t *req)
+static int prov_scan_compare_rssi(const void *a, const void *b)
 {
-    ESP_LOGD(TAG, "Starting WiFi scan for web interface");
+    const wifi_ap_record_t *ap_a = (const wifi_ap_record_t *)a;
+    const wifi_ap_record_t *ap_b = (const wifi_ap_record_t *)b;
+    return ap_b->rssi - ap_a->rssi;
+}
 
-    size_t free_heap = esp_get_free_heap_size();
-    if (free_heap < 20000) {
-        ESP_LOGW(TAG, "Low memory before scan: %zu bytes", free_heap);
-        httpd_resp_set_status(req, "503 Service Unavailable");
-        httpd_resp_set_type(req, "application/json");
-        httpd_resp_send(req, "{\"error\":\"Low memory\"}", HTTPD_RESP_USE_STRLEN);
-        return ESP_OK;
+static size_t prov_scan_escape_ssid(char *dst, const uint8_t *ssid)
+{
+    size_t len = 0;
+    for (int i = 0; i < 32 && ssid[i] != '\0'; i++) {
+        char c = (char)ssid[i];
+        if (c == '"' || c == '\\') {
+            dst[len++] = '\\';
+            dst[len++] = c;
+        } else if ((uint8_t)c < 0x20) {
+            dst[len++] = '?';
+        } else {
+            dst[len++] = c;
+        }
+    }
+    dst[len] = '\0';
+    return len;
+}
+
+static void prov_scan_start(void)
+{
+    if (s_scan_in_progress || s_prov_manager.state == WIFI_PROV_STATE_VALIDATING) {
+        return;
+    }
+
+    if (esp_get_free_heap_size() < 20000) {
+        ESP_LOGW(TAG, "Low memory, skipping background scan");
+        return;
     }
 
     wifi_scan_config_t scan_config = {
@@ -666,136 +1710,196 @@ static esp_err_t scan_get_handler(httpd_req_t *req)
         .show_hidden = false,
         .scan_type = WIFI_SCAN_TYPE_ACTIVE,
         .scan_time.active.min = 100,
-        .scan_time.active.max = 500
+        .scan_time.active.max = 300
     };
 
-    esp_err_t ret = esp_wifi_scan_start(&scan_config, true);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "WiFi scan failed: %s", esp_err_to_name(ret));
-        httpd_resp_set_status(req, "500 Internal Server Error");
-        httpd_resp_set_type(req, "application/json");
-        httpd_resp_send(req, "{\"error\":\"Scan failed\"}", HTTPD_RESP_USE_STRLEN);
-        return ESP_OK;
-    }
-
-    uint16_t ap_count = 0;
-    ret = esp_wifi_scan_get_ap_num(&ap_count);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to get AP count: %s", esp_err_to_name(ret));
-        httpd_resp_set_status(req, "500 Internal Server Error");
-        httpd_resp_set_type(req, "application/json");
-        httpd_resp_send(req, "{\"error\":\"Scan result failed\"}", HTTPD_RESP_USE_STRLEN);
-        return ESP_OK;
+    esp_err_t ret = esp_wifi_scan_start(&scan_config, false);
+    if (ret == ESP_OK) {
+        s_scan_in_progress = true;
+    } else {
+        ESP_LOGW(TAG, "Background scan not started: %s", esp_err_to_name(ret));
     }
+}
 
-    if (ap_count > 15) {
-        ESP_LOGW(TAG, "Too many APs found (%d), limiting to 15", ap_count);
-        ap_count = 15;
-    }
+static void prov_scan_timer_callback(void *arg)
+{
+    prov_scan_start();
+}
 
-    wifi_ap_record_t *ap_list = NULL;
-    char *json_response = NULL;
+static void prov_scan_done_handler(void* arg, esp_event_base_t event_base,
+                                   int32_t event_id, void* event_data)
+{
+    wifi_event_sta_scan_done_t *scan_done = (wifi_event_sta_scan_done_t *)event_data;
+    s_scan_in_progress = false;
 
-    if (ap_count == 0) {
-        ESP_LOGD(TAG, "No WiFi networks found");
-        httpd_resp_set_type(req, "application/json");
-        httpd_resp_send(req, "{\"networks\":[]}", HTTPD_RESP_USE_STRLEN);
-        return ESP_OK;
+    if (scan_done != NULL && scan_done->status != 0) {
+        // Aborted (e.g. by credential validation) - keep the previous cache
+        esp_wifi_clear_ap_list();
+        return;
     }
 
-    ap_list = malloc(ap_count * sizeof(wifi_ap_record_t));
+    uint16_t ap_count = PROV_SCAN_MAX_RECORDS;
+    wifi_ap_record_t *ap_list = calloc(ap_count, sizeof(wifi_ap_record_t));
     if (ap_list == NULL) {
-        ESP_LOGE(TAG, "Failed to allocate memory for AP list (%d APs)", ap_count);
-        httpd_resp_set_status(req, "500 Internal Server Error");
-        httpd_resp_set_type(req, "application/json");
-        httpd_resp_send(req, "{\"error\":\"Memory allocation failed\"}", HTTPD_RESP_USE_STRLEN);
-        return ESP_OK;
+        ESP_LOGE(TAG, "Failed to allocate scan records");
+        esp_wifi_clear_ap_list();
+        return;
     }
 
-    ret = esp_wifi_scan_get_ap_records(&ap_count, ap_list);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to get AP records: %s", esp_err_to_name(ret));
+    if (esp_wifi_scan_get_ap_records(&ap_count, ap_list) != ESP_OK) {
         free(ap_list);
-        httpd_resp_set_status(req, "500 Internal Server Error");
-        httpd_resp_set_type(req, "application/json");
-        httpd_resp_send(req, "{\"error\":\"Scan records failed\"}", HTTPD_RESP_USE_STRLEN);
-        return ESP_OK;
+        return;
     }
 
-    size_t required_size = 50;
-    for (int i = 0; i < ap_count && i < 15; i++) {
-        required_size += strlen((char*)ap_list[i].ssid) + 100;
-    }
+    qsort(ap_list, ap_count, sizeof(wifi_ap_record_t), prov_scan_compare_rssi);
 
-    json_response = malloc(required_size + 200);
-    if (json_response == NULL) {
-        ESP_LOGE(TAG, "Failed to allocate JSON buffer (%zu bytes)", required_size);
+    size_t capacity = 32 + PROV_SCAN_MAX_NETWORKS * PROV_SCAN_ENTRY_MAX_LEN;
+    char *json = malloc(capacity);
+    if (json == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate scan cache (%zu bytes)", capacity);
         free(ap_list);
-        httpd_resp_set_status(req, "500 Internal Server Error");
-        httpd_resp_set_type(req, "application/json");
-        httpd_resp_send(req, "{\"error\":\"Memory allocation failed\"}", HTTPD_RESP_USE_STRLEN);
-        return ESP_OK;
+        return;
     }
 
-    strcpy(json_response, "{\"networks\":[");
-
-    for (int i = 0; i < ap_count && i < 15; i++) {
-        char network_entry[256];
-        const char *auth_mode = "open";
-
-        if (strlen((char*)ap_list[i].ssid) == 0) {
+    // Single pass with a running offset; strongest BSSID wins for each SSID
+    size_t len = snprintf(json, capacity, "\"networks\":[");
+    int emitted = 0;
+    for (int i = 0; i < ap_count && emitted < PROV_SCAN_MAX_NETWORKS; i++) {
+        if (ap_list[i].ssid[0] == '\0') {
             continue;
         }
 
-        if (ap_list[i].authmode != WIFI_AUTH_OPEN) {
-            auth_mode = "secured";
+        bool duplicate = false;
+        for (int j = 0; j < i; j++) {
+            if (strncmp((char *)ap_list[j].ssid, (char *)ap_list[i].ssid, sizeof(ap_list[i].ssid)) == 0) {
+                duplicate = true;
+                break;
+            }
+        }
+        if (duplicate) {
+            continue;
         }
 
-        int written = snprintf(network_entry, sizeof(network_entry),
-                              "%s{\"ssid\": \"%.*s\", \"rssi\": %d, \"auth\": \"%s\"}",
-                              i > 0 ? "," : "",
-                              32, (char*)ap_list[i].ssid,
-                              ap_list[i].rssi,
-                              auth_mode);
+        len += snprintf(json + len, capacity - len, "%s{\"ssid\":\"", emitted > 0 ? "," : "");
+        len += prov_scan_escape_ssid(json + len, ap_list[i].ssid);
+        len += snprintf(json + len, capacity - len, "\",\"rssi\":%d,\"auth\":\"%s\"}",
+                        ap_list[i].rssi,
+                        ap_list[i].authmode == WIFI_AUTH_OPEN ? "open" : "secured");
+        emitted++;
+    }
+    len += snprintf(json + len, capacity - len, "]}");
+
+    free(ap_list);
+
+    if (xSemaphoreTake(s_scan_cache_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+        // A client is still reading the previous result; next refresh will land
+        free(json);
+        return;
+    }
+    char *old_json = s_scan_cache_json;
+    s_scan_cache_json = json;
+    s_scan_cache_len = len;
+    s_scan_cache_time_us = esp_timer_get_time();
+    xSemaphoreGive(s_scan_cache_mutex);
+
+    free(old_json);
+
+    ESP_LOGD(TAG, "Scan cache refreshed: %d networks (%u records, %zu bytes)", emitted, ap_count, len);
+}
 
-        if (written >= sizeof(network_entry)) {
-            ESP_LOGW(TAG, "Network entry truncated for SSID: %s", ap_list[i].ssid);
+static esp_err_t prov_scan_cache_start(void)
+{
+    if (s_scan_cache_mutex == NULL) {
+        s_scan_cache_mutex = xSemaphoreCreateMutex();
+        if (s_scan_cache_mutex == NULL) {
+            return ESP_ERR_NO_MEM;
         }
+    }
 
-        if (strlen(json_response) + strlen(network_entry) + 10 > required_size + 150) {
-            ESP_LOGW(TAG, "Response buffer full, truncating at %d networks", i);
-            break;
+    esp_err_t ret = esp_event_handler_register(WIFI_EVENT, WIFI_EVENT_SCAN_DONE, &prov_scan_done_handler, NULL);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    if (s_scan_timer == NULL) {
+        const esp_timer_create_args_t scan_timer_args = {
+            .callback = prov_scan_timer_callback,
+            .name = "prov_scan"
+        };
+        ret = esp_timer_create(&scan_timer_args, &s_scan_timer);
+        if (ret != ESP_OK) {
+            esp_event_handler_unregister(WIFI_EVENT, WIFI_EVENT_SCAN_DONE, &prov_scan_done_handler);
+            return ret;
         }
+    }
+
+    esp_timer_start_periodic(s_scan_timer, (uint64_t)PROV_SCAN_REFRESH_INTERVAL_MS * 1000);
+    prov_scan_start();
+
+    return ESP_OK;
+}
 
-        strcat(json_response, network_entry);
+static void prov_scan_cache_stop(void)
+{
+    if (s_scan_timer != NULL) {
+        esp_timer_stop(s_scan_timer);
+        esp_timer_delete(s_scan_timer);
+        s_scan_timer = NULL;
+    }
+
+    esp_event_handler_unregister(WIFI_EVENT, WIFI_EVENT_SCAN_DONE, &prov_scan_done_handler);
+
+    if (s_scan_in_progress) {
+        esp_wifi_scan_stop();
+        s_scan_in_progress = false;
     }
 
-    strcat(json_response, "]}");
+    if (s_scan_cache_mutex != NULL) {
+        xSemaphoreTake(s_scan_cache_mutex, portMAX_DELAY);
+        free(s_scan_cache_json);
+        s_scan_cache_json = NULL;
+        s_scan_cache_len = 0;
+        s_scan_cache_time_us = 0;
+        xSemaphoreGive(s_scan_cache_mutex);
+    }
+}
 
+static esp_err_t scan_get_handler(httpd_req_t *req)
+{
     httpd_resp_set_type(req, "application/json");
 
-    size_t response_len = strlen(json_response);
-    if (response_len > 1024) {
-        size_t sent = 0;
-        size_t chunk_size = 512;
-        while (sent < response_len) {
-            size_t to_send = (response_len - sent > chunk_size) ? chunk_size : (response_len - sent);
-            esp_err_t send_ret = httpd_resp_send_chunk(req, json_response + sent, to_send);
-            if (send_ret != ESP_OK) {
-                ESP_LOGE(TAG, "Failed to send JSON chunk: %s", esp_err_to_name(send_ret));
-                break;
-            }
-            sent += to_send;
-        }
-        httpd_resp_send_chunk(req, NULL, 0);
-    } else {
-        httpd_resp_send(req, json_response, response_len);
+    if (s_scan_cache_mutex == NULL ||
+        xSemaphoreTake(s_scan_cache_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_send(req, "{\"error\":\"Scan cache busy\"}", HTTPD_RESP_USE_STRLEN);
+        return ESP_OK;
     }
 
-    free(ap_list);
-    free(json_response);
+    if (s_scan_cache_json == NULL) {
+        xSemaphoreGive(s_scan_cache_mutex);
+        prov_scan_start();
+        httpd_resp_send(req, "{\"age_ms\":0,\"scanning\":true,\"networks\":[]}", HTTPD_RESP_USE_STRLEN);
+        return ESP_OK;
+    }
+
+    char prefix[64];
+    uint32_t age_ms = (uint32_t)((esp_timer_get_time() - s_scan_cache_time_us) / 1000);
+    snprintf(prefix, sizeof(prefix), "{\"age_ms\":%lu,\"scanning\":%s,",
+             age_ms, s_scan_in_progress ? "true" : "false");
+
+    esp_err_t ret = httpd_resp_send_chunk(req, prefix, HTTPD_RESP_USE_STRLEN);
+    if (ret == ESP_OK) {
+        ret = httpd_resp_send_chunk(req, s_scan_cache_json, s_scan_cache_len);
+    }
+    xSemaphoreGive(s_scan_cache_mutex);
+
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to send scan results: %s", esp_err_to_name(ret));
+        return ret;
+    }
 
-    ESP_LOGD(TAG, "WiFi scan completed, found %d networks (sent %zu bytes)", ap_count, response_len);
+    httpd_resp_send_chunk(req, NULL, 0);
+    ESP_LOGD(TAG, "Served cached scan (age %lu ms)", age_ms);
     return ESP_OK;
 }
 
@@ -1003,6 +2107,8 @@ static esp_err_t config_post_handler(httpd_req_t *req)
     s_prov_manager.state = WIFI_PROV_STATE_CONNECTED;
     strncpy(s_prov_manager.ssid, ssid, sizeof(s_prov_manager.ssid) - 1);
 
+    credential_store_add(ssid, password);
+
     httpd_resp_set_type(req, "application/json");
     httpd_resp_send(req, "{\"success\":true,\"message\":\"WiFi configurado exitosamente\"}", HTTPD_RESP_USE_STRLEN);
 
@@ -1129,6 +2235,11 @@ static esp_err_t prov_manager_start(void)
     s_prov_manager.state = WIFI_PROV_STATE_PROVISIONING;
     s_prov_manager.provisioning_active = true;
 
+    ret = prov_scan_cache_start();
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Background scan unavailable: %s", esp_err_to_name(ret));
+    }
+
     ESP_LOGD(TAG, "Web-based provisioning started");
     ESP_LOGD(TAG, "AP SSID: %s", WIFI_PROV_SOFTAP_SSID_DEFAULT);
     ESP_LOGD(TAG, "Web interface: http://192.168.4.1");
@@ -1143,6 +2254,8 @@ static esp_err_t prov_manager_stop(void)
     ESP_LOGD(TAG, "Stopping web-based WiFi provisioning");
 
     if (s_prov_manager.provisioning_active) {
+        prov_scan_cache_stop();
+
         if (s_server) {
             ESP_LOGI(TAG, "Stopping provisioning HTTP server...");
             esp_err_t stop_ret = httpd_stop(s_server);
@@ -1184,6 +2297,11 @@ static esp_err_t prov_manager_deinit(void)
         s_validation_event_group = NULL;
     }
 
+    if (s_scan_cache_mutex) {
+        vSemaphoreDelete(s_scan_cache_mutex);
+        s_scan_cache_mutex = NULL;
+    }
+
     return ESP_OK;
 }
 
@@ -1269,7 +2387,7 @@ static void wifi_manager_provisioning_event_handler(void* arg, esp_event_base_t
                 portENTER_CRITICAL(&s_manager_status_spinlock);
                 s_manager_status.state = WIFI_MANAGER_STATE_PROVISIONING;
                 portEXIT_CRITICAL(&s_manager_status_spinlock);
-                esp_event_post(WIFI_MANAGER_EVENTS, WIFI_MANAGER_EVENT_PROVISIONING_STARTED, NULL, 0, portMAX_DELAY);
+                event_bus_post(EVENT_BUS_WIFI_PROVISIONING_STARTED, NULL);
                 break;
 
             case WIFI_PROV_EVENT_CREDENTIALS_SUCCESS:
@@ -1293,10 +2411,16 @@ static void wifi_manager_provisioning_event_handler(void* arg, esp_event_base_t
                     prov_manager_deinit();
 
                     ESP_LOGD(TAG, "Starting WiFi connection with provisioned credentials");
-                    connection_manager_connect(&config);
+                    esp_err_t ret = connection_manager_connect(&config);
+                    if (ret != ESP_OK) {
+                        ESP_LOGE(TAG, "Failed to connect with provisioned credentials: %s", esp_err_to_name(ret));
+                        portENTER_CRITICAL(&s_manager_status_spinlock);
+                        s_manager_status.state = WIFI_MANAGER_STATE_ERROR;
+                        portEXIT_CRITICAL(&s_manager_status_spinlock);
+                    }
                 }
 
-                esp_event_post(WIFI_MANAGER_EVENTS, WIFI_MANAGER_EVENT_PROVISIONING_COMPLETED, NULL, 0, portMAX_DELAY);
+                event_bus_post(EVENT_BUS_WIFI_PROVISIONING_COMPLETED, NULL);
                 break;
 
             case WIFI_PROV_EVENT_FAILED:
@@ -1317,14 +2441,22 @@ static void wifi_manager_connection_event_handler(void* arg, esp_event_base_t ev
 {
     if (event_base == WIFI_MANAGER_CONNECTION_EVENTS) {
         switch (event_id) {
-            case WIFI_CONNECTION_EVENT_CONNECTED:
+            case WIFI_CONNECTION_EVENT_CONNECTED: {
+                // Failover and roaming can change the SSID behind our back
+                char ssid_copy[33];
+                portENTER_CRITICAL(&s_conn_manager_spinlock);
+                strncpy(ssid_copy, s_conn_manager.ssid, sizeof(ssid_copy));
+                portEXIT_CRITICAL(&s_conn_manager_spinlock);
+
                 portENTER_CRITICAL(&s_manager_status_spinlock);
+                strncpy(s_manager_status.ssid, ssid_copy, sizeof(s_manager_status.ssid));
                 ESP_LOGD(TAG, "WiFi connected successfully to: '%s'", s_manager_status.ssid);
                 s_manager_status.connected = true;
                 s_manager_status.state = WIFI_MANAGER_STATE_CONNECTED;
                 portEXIT_CRITICAL(&s_manager_status_spinlock);
-                esp_event_post(WIFI_MANAGER_EVENTS, WIFI_MANAGER_EVENT_CONNECTED, NULL, 0, portMAX_DELAY);
+                event_bus_post(EVENT_BUS_WIFI_CONNECTED, NULL);
                 break;
+            }
 
             case WIFI_CONNECTION_EVENT_DISCONNECTED:
                 ESP_LOGD(TAG, "WiFi disconnected");
@@ -1333,7 +2465,7 @@ static void wifi_manager_connection_event_handler(void* arg, esp_event_base_t ev
                 s_manager_status.has_ip = false;
                 s_manager_status.state = WIFI_MANAGER_STATE_DISCONNECTED;
                 portEXIT_CRITICAL(&s_manager_status_spinlock);
-                esp_event_post(WIFI_MANAGER_EVENTS, WIFI_MANAGER_EVENT_DISCONNECTED, NULL, 0, portMAX_DELAY);
+                event_bus_post(EVENT_BUS_WIFI_DISCONNECTED, NULL);
                 break;
 
             case WIFI_CONNECTION_EVENT_GOT_IP:
@@ -1346,7 +2478,12 @@ static void wifi_manager_connection_event_handler(void* arg, esp_event_base_t ev
                     ESP_LOGD(TAG, "IP address: " IPSTR, IP2STR(ip));
                 }
                 portEXIT_CRITICAL(&s_manager_status_spinlock);
-                esp_event_post(WIFI_MANAGER_EVENTS, WIFI_MANAGER_EVENT_IP_OBTAINED, event_data, sizeof(esp_ip4_addr_t), portMAX_DELAY);
+                if (event_data != NULL) {
+                    event_bus_data_t bus_data = { .ip_addr = ((esp_ip4_addr_t *)event_data)->addr };
+                    event_bus_post(EVENT_BUS_WIFI_IP_OBTAINED, &bus_data);
+                } else {
+                    event_bus_post(EVENT_BUS_WIFI_IP_OBTAINED, NULL);
+                }
                 break;
 
             case WIFI_CONNECTION_EVENT_RETRY_EXHAUSTED:
@@ -1354,7 +2491,7 @@ static void wifi_manager_connection_event_handler(void* arg, esp_event_base_t ev
                 portENTER_CRITICAL(&s_manager_status_spinlock);
                 s_manager_status.state = WIFI_MANAGER_STATE_ERROR;
                 portEXIT_CRITICAL(&s_manager_status_spinlock);
-                esp_event_post(WIFI_MANAGER_EVENTS, WIFI_MANAGER_EVENT_CONNECTION_FAILED, NULL, 0, portMAX_DELAY);
+                event_bus_post(EVENT_BUS_WIFI_CONNECTION_FAILED, NULL);
                 break;
 
             default:
@@ -1400,7 +2537,7 @@ esp_err_t wifi_manager_init(void)
              s_manager_status.mac_address[2], s_manager_status.mac_address[3],
              s_manager_status.mac_address[4], s_manager_status.mac_address[5]);
 
-    esp_event_post(WIFI_MANAGER_EVENTS, WIFI_MANAGER_EVENT_INIT_COMPLETE, NULL, 0, portMAX_DELAY);
+    event_bus_post(EVENT_BUS_WIFI_INIT_COMPLETE, NULL);
 
     return ESP_OK;
 }
@@ -1495,7 +2632,7 @@ esp_err_t wifi_manager_check_and_connect(void)
         ESP_LOGD(TAG, "Resetting boot counter after reset pattern detection");
         boot_counter_clear();
 
-        esp_event_post(WIFI_MANAGER_EVENTS, WIFI_MANAGER_EVENT_RESET_REQUESTED, NULL, 0, portMAX_DELAY);
+        event_bus_post(EVENT_BUS_WIFI_RESET_REQUESTED, NULL);
         return wifi_manager_force_provisioning();
     }
 
@@ -1531,6 +2668,16 @@ esp_err_t wifi_manager_check_and_connect(void)
             return wifi_manager_force_provisioning();
         }
 
+        // Networks provisioned before the credential store existed are migrated once
+        portENTER_CRITICAL(&s_cred_store_spinlock);
+        uint8_t stored_networks = s_cred_store.count;
+        portEXIT_CRITICAL(&s_cred_store_spinlock);
+        if (stored_networks == 0) {
+            credential_store_add((char *)config.sta.ssid, (char *)config.sta.password);
+        }
+
+        credential_store_select(NULL, &config);
+
         ESP_LOGD(TAG, "Connecting to stored WiFi network: '%s' (length: %d)", config.sta.ssid, strlen((char*)config.sta.ssid));
         portENTER_CRITICAL(&s_manager_status_spinlock);
         strncpy(s_manager_status.ssid, (char *)config.sta.ssid, sizeof(s_manager_status.ssid) - 1);
@@ -1582,6 +2729,7 @@ esp_err_t wifi_manager_reset_credentials(void)
         ESP_LOGE(TAG, "Failed to reset credentials: %s", esp_err_to_name(ret));
         return ret;
     }
+    credential_store_erase();
 
     portENTER_CRITICAL(&s_manager_status_spinlock);
     s_manager_status.provisioned = false;
@@ -1610,6 +2758,11 @@ esp_err_t wifi_manager_get_status(wifi_manager_status_t *status)
     *status = s_manager_status;
     portEXIT_CRITICAL(&s_manager_status_spinlock);
 
+    portENTER_CRITICAL(&s_conn_manager_spinlock);
+    status->connect_timing = s_conn_manager.timing;
+    status->rssi = s_conn_manager.connected ? s_roam.current_rssi : 0;
+    portEXIT_CRITICAL(&s_conn_manager_spinlock);
+
     return ESP_OK;
 }
 
@@ -1631,6 +2784,19 @@ bool wifi_manager_is_connected(void)
     return connected;
 }
 
+esp_err_t wifi_manager_wait_connected(uint32_t timeout_ms)
+{
+    if (!s_manager_initialized || s_wifi_event_group == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    TickType_t ticks = (timeout_ms == UINT32_MAX) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    EventBits_t bits = xEventGroupWaitBits(s_wifi_event_group, WIFI_CONNECTED_BIT,
+                                           pdFALSE, pdTRUE, ticks);
+
+    return (bits & WIFI_CONNECTED_BIT) ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
 esp_err_t wifi_manager_get_ip(esp_ip4_addr_t *ip)
 {
     if (!s_manager_initialized || !ip) {
@@ -1675,6 +2841,52 @@ esp_err_t wifi_manager_get_ssid(char *ssid, size_t ssid_len)
     return ESP_OK;
 }
 
+esp_err_t wifi_manager_add_network(const char *ssid, const char *password)
+{
+    if (ssid == NULL || strlen(ssid) == 0 || strlen(ssid) > 32 ||
+        (password != NULL && strlen(password) > 64)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return credential_store_add(ssid, password);
+}
+
+esp_err_t wifi_manager_remove_network(const char *ssid)
+{
+    if (ssid == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    bool found = false;
+    portENTER_CRITICAL(&s_cred_store_spinlock);
+    for (int i = 0; i < s_cred_store.count; i++) {
+        if (strcmp(s_cred_store.entries[i].ssid, ssid) == 0) {
+            s_cred_store.entries[i] = s_cred_store.entries[s_cred_store.count - 1];
+            memset(&s_cred_store.entries[s_cred_store.count - 1], 0, sizeof(wifi_credential_t));
+            s_cred_store.count--;
+            found = true;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_cred_store_spinlock);
+
+    if (!found) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    credential_store_save();
+    return ESP_OK;
+}
+
+size_t wifi_manager_get_network_count(void)
+{
+    size_t count;
+    portENTER_CRITICAL(&s_cred_store_spinlock);
+    count = s_cred_store.count;
+    portEXIT_CRITICAL(&s_cred_store_spinlock);
+    return count;
+}
+
 esp_err_t wifi_manager_clear_all_credentials(void)
 {
     if (!s_manager_initialized) {
@@ -1684,6 +2896,9 @@ esp_err_t wifi_manager_clear_all_credentials(void)
     connection_manager_disconnect();
     prov_manager_stop();
     prov_manager_reset_credentials();
+    fast_connect_cache_invalidate();
+    persist_flush();
+    credential_store_erase();
 
     // Clear NVS credentials
     nvs_handle_t nvs_handle;
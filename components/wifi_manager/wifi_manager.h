@@ -8,7 +8,9 @@
  * Component Responsibilities:
  * - WiFi initialization and connection
  * - Web-based provisioning with credential validation
- * - Automatic reconnection with retry logic
+ * - Automatic reconnection with exponential backoff and jitter (no hard give-up)
+ * - Fast reconnect using cached BSSID/channel (RTC + NVS)
+ * - Multi-network credential store with RSSI-ranked failover and roaming
  * - Boot counter for factory reset pattern (3 reboots in 30s)
  * - Connection status monitoring
  * - IP address management
@@ -36,11 +38,6 @@ extern "C" {
 
 /* ============================ EVENT BASES ============================ */
 
-/**
- * @brief WiFi manager event base
- */
-ESP_EVENT_DECLARE_BASE(WIFI_MANAGER_EVENTS);
-
 /**
  * @brief WiFi provisioning events
  */
@@ -98,6 +95,21 @@ typedef enum {
     WIFI_VALIDATION_TIMEOUT                 ///< Connection timeout
 } wifi_manager_validation_result_t;
 
+/**
+ * @brief Connect-time breakdown of the last successful connection
+ *
+ * The WiFi driver reports the link as up only after the WPA handshake, so
+ * 802.11 authentication/association and key exchange are measured together
+ * (assoc_ms). All values are 0 until the first IP is obtained.
+ */
+typedef struct {
+    uint32_t assoc_ms;                      ///< Last attempt start → link up (auth/assoc + WPA handshake)
+    uint32_t dhcp_ms;                       ///< Link up → IP obtained (0 with static IP)
+    uint32_t total_ms;                      ///< First attempt start → IP obtained
+    uint8_t attempts;                       ///< Association attempts used
+    bool fast_path;                         ///< Connected using cached BSSID/channel
+} wifi_manager_connect_timing_t;
+
 /**
  * @brief WiFi manager status
  */
@@ -109,23 +121,16 @@ typedef struct {
     char ssid[33];                          ///< Connected SSID (or empty)
     uint8_t mac_address[6];                 ///< Device MAC address
     esp_ip4_addr_t ip_addr;                 ///< Current IP address
+    wifi_manager_connect_timing_t connect_timing; ///< Last connect-time breakdown
+    int8_t rssi;                            ///< Last sampled RSSI in dBm (0 if unknown)
 } wifi_manager_status_t;
 
 /* ============================ EVENT IDs ============================ */
 
-/**
- * @brief WiFi manager main event IDs
+/*
+ * Public WiFi notifications (init complete, connected, IP obtained, ...) are
+ * delivered on the event bus as EVENT_BUS_WIFI_* (see event_bus.h).
  */
-typedef enum {
-    WIFI_MANAGER_EVENT_INIT_COMPLETE = 0,   ///< Initialization complete
-    WIFI_MANAGER_EVENT_PROVISIONING_STARTED,///< Provisioning started
-    WIFI_MANAGER_EVENT_PROVISIONING_COMPLETED,///< Provisioning completed
-    WIFI_MANAGER_EVENT_CONNECTED,           ///< Connected to AP
-    WIFI_MANAGER_EVENT_DISCONNECTED,        ///< Disconnected from AP
-    WIFI_MANAGER_EVENT_IP_OBTAINED,         ///< IP address obtained
-    WIFI_MANAGER_EVENT_CONNECTION_FAILED,   ///< Connection failed
-    WIFI_MANAGER_EVENT_RESET_REQUESTED      ///< Factory reset requested (boot pattern)
-} wifi_manager_event_id_t;
 
 /**
  * @brief WiFi provisioning event IDs
@@ -152,7 +157,8 @@ typedef enum {
     WIFI_CONNECTION_EVENT_GOT_IP,           ///< IP address obtained
     WIFI_CONNECTION_EVENT_AUTH_FAILED,      ///< Authentication failed
     WIFI_CONNECTION_EVENT_NETWORK_NOT_FOUND,///< Network not found
-    WIFI_CONNECTION_EVENT_RETRY_EXHAUSTED   ///< Max retries reached
+    WIFI_CONNECTION_EVENT_RETRY_EXHAUSTED,  ///< Max retries reached (reconnection continues with backoff)
+    WIFI_CONNECTION_EVENT_RECONNECT_SCHEDULED ///< Reconnect scheduled (data: uint32_t delay in ms)
 } wifi_connection_event_id_t;
 
 /* ============================ PUBLIC API ============================ */
@@ -274,6 +280,18 @@ bool wifi_manager_is_provisioned(void);
  */
 bool wifi_manager_is_connected(void);
 
+/**
+ * @brief Block until WiFi is connected with an IP address
+ *
+ * Waits on the connection event group instead of polling
+ * wifi_manager_is_connected(). Returns immediately if already connected.
+ *
+ * @param timeout_ms Maximum time to wait in ms (UINT32_MAX waits forever)
+ * @return ESP_OK if connected, ESP_ERR_TIMEOUT if still disconnected,
+ *         ESP_ERR_INVALID_STATE if not initialized
+ */
+esp_err_t wifi_manager_wait_connected(uint32_t timeout_ms);
+
 /**
  * @brief Get current IP address
  *
@@ -299,6 +317,35 @@ esp_err_t wifi_manager_get_mac(uint8_t *mac);
  */
 esp_err_t wifi_manager_get_ssid(char *ssid, size_t ssid_len);
 
+/**
+ * @brief Add or update a network in the credential store
+ *
+ * Networks are ranked by last-known RSSI and connection history. When the
+ * active network fails WIFI_PROV_CONNECTION_MAX_RETRIES times the next ranked
+ * one is tried. Updating an existing SSID keeps its history.
+ * The lowest ranked entry is evicted when the store is full.
+ *
+ * @param ssid Network SSID (1-32 chars)
+ * @param password Network password (NULL or empty for open networks)
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if parameters invalid
+ */
+esp_err_t wifi_manager_add_network(const char *ssid, const char *password);
+
+/**
+ * @brief Remove a network from the credential store
+ *
+ * @param ssid Network SSID
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if not stored
+ */
+esp_err_t wifi_manager_remove_network(const char *ssid);
+
+/**
+ * @brief Get number of networks in the credential store
+ *
+ * @return Stored network count (0 to CONFIG_WIFI_MANAGER_MAX_NETWORKS)
+ */
+size_t wifi_manager_get_network_count(void);
+
 /* ============================ CONFIGURATION ============================ */
 
 /**
@@ -331,6 +378,11 @@ esp_err_t wifi_manager_get_ssid(char *ssid, size_t ssid_len);
  */
 #define WIFI_MANAGER_VALIDATION_TIMEOUT_MS 15000
 
+/**
+ * @brief NVS namespace for the fast-connect cache (BSSID/channel)
+ */
+#define WIFI_MANAGER_NVS_NAMESPACE "wifi_mgr"
+
 #ifdef __cplusplus
 }
 #endif
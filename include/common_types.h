@@ -23,35 +23,103 @@ extern "C" {
 
 /* ============================ SENSOR DATA TYPES ============================ */
 
+/**
+ * @brief Trustworthiness of a wall-clock timestamp
+ *
+ * UNSYNCED timestamps count from 1970 at boot; the backend re-bases them
+ * using the time the message was received.
+ */
+typedef enum {
+    TIME_QUALITY_UNSYNCED = 0,      ///< Clock never synced since power-on
+    TIME_QUALITY_RTC,               ///< Synced before a deep sleep / soft reset
+    TIME_QUALITY_SNTP               ///< Synced via SNTP during this boot
+} time_quality_t;
+
 /**
  * @brief Ambient environmental data (temperature and humidity)
  *
- * Size: 12 bytes (3 x 4 bytes float)
+ * Size: 16 bytes (3 x 4 bytes + quality/padding)
  * FPU optimized: All floats aligned
  */
 typedef struct {
     float temperature;      ///< Temperature in °C (-40 to 80°C for DHT22)
     float humidity;         ///< Relative humidity in % (0-100%)
     uint32_t timestamp;     ///< Unix timestamp of reading
+    uint8_t time_quality;   ///< time_quality_t of timestamp
+    uint8_t reserved[3];    ///< Reserved for alignment
 } ambient_data_t;
 
+/**
+ * @brief Ambient sensor model (selected at runtime from device_config)
+ */
+typedef enum {
+    AMBIENT_SENSOR_DHT22 = 0,   ///< DHT22/AM2301 single-wire (GPIO_DHT22)
+    AMBIENT_SENSOR_SHT3X,       ///< Sensirion SHT30/31/35 on I2C
+    AMBIENT_SENSOR_BME280,      ///< Bosch BME280 on I2C
+    AMBIENT_SENSOR_MAX
+} ambient_sensor_type_t;
+
+/**
+ * @brief Maximum soil channels in soil_data_t (16-channel analog mux)
+ */
+#define SOIL_MAX_SENSORS    16
+
 /**
  * @brief Soil moisture sensor data
  *
- * Size: 16 bytes (4 x 4 bytes)
- * Supports 1-3 capacitive soil moisture sensors
+ * Size: 72 bytes
+ * Only the first sensor_count entries are meaningful; a channel whose bit
+ * is clear in valid_mask failed this cycle and reads 0.
  */
 typedef struct {
-    float soil_humidity[3]; ///< Soil moisture % (0-100%) for up to 3 sensors
-    uint8_t sensor_count;   ///< Number of active sensors (1-3)
-    uint8_t reserved[3];    ///< Reserved for alignment
+    float soil_humidity[SOIL_MAX_SENSORS]; ///< Soil moisture % (0-100%) per channel
+    uint16_t valid_mask;    ///< Bit i set if soil_humidity[i] is valid
+    uint8_t sensor_count;   ///< Number of active channels (1-SOIL_MAX_SENSORS)
+    uint8_t time_quality;   ///< time_quality_t of timestamp
     uint32_t timestamp;     ///< Unix timestamp of reading
 } soil_data_t;
 
+/**
+ * @brief Maximum channels in a soil profile (e.g. 4 probes x 4 depths)
+ */
+#define SOIL_PROFILE_MAX_CHANNELS   16
+
+#define SOIL_CHANNEL_FLAG_VALID     0x01    ///< Moisture value is valid
+#define SOIL_CHANNEL_FLAG_HAS_TEMP  0x02    ///< Temperature value is valid
+
+/**
+ * @brief One soil measurement point (probe + depth)
+ *
+ * Size: 12 bytes
+ */
+typedef struct {
+    float moisture;         ///< Soil moisture % (0-100%)
+    float temperature;      ///< Soil temperature °C (if SOIL_CHANNEL_FLAG_HAS_TEMP)
+    uint16_t depth_cm;      ///< Depth below surface in cm (0 = unspecified)
+    uint8_t probe_id;       ///< Probe identifier (Modbus address, ADC sensor index)
+    uint8_t flags;          ///< SOIL_CHANNEL_FLAG_*
+} soil_channel_t;
+
+/**
+ * @brief Soil profile: all channels of the active soil backend
+ *
+ * soil_data_t mirrors the moisture of every channel (up to
+ * SOIL_MAX_SENSORS, failed channels cleared in valid_mask) for the
+ * irrigation logic and the payloads.
+ */
+typedef struct {
+    soil_channel_t channels[SOIL_PROFILE_MAX_CHANNELS]; ///< Channels, ordered by probe then depth
+    uint8_t channel_count;  ///< Number of populated channels
+    uint8_t valid_count;    ///< Channels with SOIL_CHANNEL_FLAG_VALID
+    uint8_t time_quality;   ///< time_quality_t of timestamp
+    uint8_t reserved;       ///< Reserved for alignment
+    uint32_t timestamp;     ///< Unix timestamp of reading
+} soil_profile_t;
+
 /**
  * @brief Complete sensor reading package
  *
- * Size: 76 bytes total
+ * Size: 80 bytes total
  * Combines ambient and soil data with device info
  */
 typedef struct {
@@ -95,7 +163,8 @@ typedef enum {
     IRRIGATION_CMD_STOP,            ///< Stop irrigation normally
     IRRIGATION_CMD_EMERGENCY_STOP,  ///< Emergency stop
     IRRIGATION_CMD_PAUSE,           ///< Pause irrigation
-    IRRIGATION_CMD_RESUME           ///< Resume paused irrigation
+    IRRIGATION_CMD_RESUME,          ///< Resume paused irrigation
+    IRRIGATION_CMD_START_PULSE      ///< Start cycle-and-soak pulses (duration = total on-time)
 } irrigation_command_t;
 
 /**
@@ -112,6 +181,12 @@ typedef struct {
     uint16_t valve_number;          ///< Active valve number (1-2)
     bool safety_lock;               ///< Safety lock status
     float last_soil_avg;            ///< Last average soil humidity %
+
+    // Lifetime statistics (persisted in NVS)
+    uint32_t total_sessions;        ///< Completed sessions
+    uint32_t total_runtime_sec;     ///< Irrigated time of every session
+    uint32_t emergency_stops;       ///< Emergency stops
+    uint32_t thermal_stops;         ///< Thermal protection triggers
 } irrigation_status_t;
 
 /* ============================ DEVICE TYPES ============================ */
@@ -147,7 +222,7 @@ typedef struct {
     uint16_t min_interval_minutes;  ///< Min interval between sessions (240 min)
 
     // Sensor Configuration
-    uint8_t soil_sensor_count;      ///< Number of soil sensors (1-3)
+    uint8_t soil_sensor_count;      ///< Number of soil sensors (1-SOIL_MAX_SENSORS)
     uint16_t reading_interval_sec;  ///< Sensor reading interval (60s online)
 
     // Safety Configuration
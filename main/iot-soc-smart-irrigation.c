@@ -18,16 +18,37 @@
 #include "mqtt_client_manager.h"     // Migrated from mqtt_adapter
 #include "device_config.h"           // Migrated component
 #include "sensor_reader.h"           // Migrated component - unified sensor interface
+#include "sensor_scheduler.h"        // Muestreo multi-tasa (única tarea que toca los sensores)
 #include "notification_service.h"    // Notification service for webhooks
 #include "irrigation_controller.h"   // Phase 5 - Irrigation control logic
+#include "time_sync.h"               // SNTP + calidad de timestamps
+#include "deferred_log.h"            // Logs diferidos para rutas calientes
+#include "decision_log.h"            // Registro de decisiones de riego en flash
+#include "payload_cache.h"           // Payloads de sensores codificados una sola vez
+#include "metrics.h"                 // Registro de métricas (GET /metrics)
+#include "ota_manager.h"             // Actualizaciones OTA delta con rollback
+#include "event_bus.h"               // Bus de eventos tipado (WiFi, MQTT, sensores, riego)
+#include "footprint_audit.h"         // Auditoría de stacks y RAM (menuconfig)
 
 static const char *TAG = "SMART_IRRIGATION_MAIN";
 static bool s_http_server_initialized = false;
 
+// Stacks configurables por menuconfig (ver Kconfig.projbuild)
+#ifndef CONFIG_APP_SENSOR_PUBLISH_STACK_SIZE
+#define CONFIG_APP_SENSOR_PUBLISH_STACK_SIZE 4096
+#endif
+
+#ifndef CONFIG_APP_WIFI_BUS_STACK_SIZE
+#define CONFIG_APP_WIFI_BUS_STACK_SIZE    4096
+#endif
+
 // Task configuration constants
-#define SENSOR_PUBLISH_TASK_STACK_SIZE    4096
+#define SENSOR_PUBLISH_TASK_STACK_SIZE    CONFIG_APP_SENSOR_PUBLISH_STACK_SIZE
 #define SENSOR_PUBLISH_TASK_PRIORITY      3  // Reduced from 5 to 3 - avoid priority inversion with HTTP/WiFi tasks
 #define SENSOR_PUBLISH_INTERVAL_MS        30000  // 30 seconds
+#define IRRIGATION_STATUS_PUBLISH_CYCLES  10     // Estado de riego sin cambios: cada 5 minutos
+#define MAIN_BUS_TASK_STACK_SIZE          CONFIG_APP_WIFI_BUS_STACK_SIZE  // Arranca HTTP server desde el handler WiFi
+#define MAIN_BUS_TASK_PRIORITY            3
 
 /**
  * @brief Callback para comandos de riego recibidos via MQTT
@@ -39,11 +60,93 @@ static void mqtt_irrigation_command_handler(irrigation_command_t command,
                                            uint16_t duration_minutes,
                                            void* user_data);
 
+/**
+ * @brief Convierte el estado del controlador al irrigation_status_t común
+ *
+ * mqtt_client y http_server no dependen de irrigation_controller; main
+ * compone el estado que ambos publican.
+ *
+ * @param[out] status Estado común a completar
+ * @param soil_avg Humedad promedio del suelo de la última muestra
+ * @return ESP_OK, o error si el controlador no está inicializado
+ */
+static esp_err_t build_irrigation_status(irrigation_status_t* status, float soil_avg)
+{
+    irrigation_controller_status_t ctrl;
+    esp_err_t ret = irrigation_controller_get_status(&ctrl);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    *status = (irrigation_status_t) {
+        .state = ctrl.state,
+        .mode = ctrl.mode,
+        .session_start_time = ctrl.session_start,
+        .session_duration_sec = ctrl.session_elapsed_sec,
+        .total_runtime_today = ctrl.stats.today_runtime_seconds,
+        .valve_number = ctrl.active_valve,
+        .safety_lock = ctrl.safety_lock,
+        .last_soil_avg = soil_avg,
+        .total_sessions = ctrl.stats.total_sessions,
+        .total_runtime_sec = ctrl.stats.total_runtime_seconds,
+        .emergency_stops = ctrl.stats.emergency_stops,
+        .thermal_stops = ctrl.stats.thermal_stops,
+    };
+    return ESP_OK;
+}
+
+/**
+ * @brief Proveedor de estado de riego para GET /status
+ */
+static esp_err_t http_irrigation_status_provider(irrigation_status_t* status, void* user_data)
+{
+    sensor_reading_t reading;
+    float soil_avg = (sensor_scheduler_get_latest(&reading) == ESP_OK)
+        ? sensor_reader_soil_average(&reading.soil) : 0.0f;
+    return build_irrigation_status(status, soil_avg);
+}
+
+/**
+ * @brief Publica el estado y las estadísticas de riego via MQTT
+ *
+ * Publica solo si cambió el estado, el bloqueo o algún contador, o cada
+ * IRRIGATION_STATUS_PUBLISH_CYCLES ciclos.
+ *
+ * @param soil_avg Humedad promedio del suelo de la última muestra
+ * @param cycle_count Ciclo actual de la tarea de publicación
+ */
+static void publish_irrigation_status(float soil_avg, uint32_t cycle_count)
+{
+    static irrigation_status_t s_last_published;
+    static bool s_published_once = false;
+
+    irrigation_status_t status;
+    if (build_irrigation_status(&status, soil_avg) != ESP_OK) {
+        return;
+    }
+
+    bool changed = !s_published_once ||
+                   status.state != s_last_published.state ||
+                   status.safety_lock != s_last_published.safety_lock ||
+                   status.total_sessions != s_last_published.total_sessions ||
+                   status.emergency_stops != s_last_published.emergency_stops ||
+                   status.thermal_stops != s_last_published.thermal_stops;
+    if (!changed && cycle_count % IRRIGATION_STATUS_PUBLISH_CYCLES != 0) {
+        return;
+    }
+
+    if (mqtt_client_publish_irrigation_status(&status) == ESP_OK) {
+        s_last_published = status;
+        s_published_once = true;
+    }
+}
+
 /**
  * @brief Sensor publishing task (Component-Based Architecture)
  *
- * Periodically reads all sensors (DHT22 + soil) and publishes data via MQTT.
- * Uses vTaskDelayUntil() for precise 30-second intervals.
+ * Periodically publishes the latest sample from sensor_scheduler via MQTT.
+ * Uses vTaskDelayUntil() for precise 30-second intervals; a cycle with no
+ * new sample since the last one (slow night/offline profiles) is skipped.
  * Handles failures gracefully by continuing the publishing loop.
  * Implements anti-deadlock measures for WiFi provisioning compatibility.
  */
@@ -54,15 +157,16 @@ static void sensor_publishing_task(void *pvParameters)
     TickType_t xLastWakeTime = xTaskGetTickCount();
     const TickType_t xFrequency = pdMS_TO_TICKS(SENSOR_PUBLISH_INTERVAL_MS);
     uint32_t cycle_count = 0;
+    uint32_t last_published_id = 0;
 
     while (1) {
         // Wait for the next cycle (30 seconds)
         vTaskDelayUntil(&xLastWakeTime, xFrequency);
         cycle_count++;
 
-        // 1. LEER TODOS LOS SENSORES usando nuevo componente
+        // 1. OBTENER ÚLTIMA MUESTRA del planificador (no toca los sensores)
         sensor_reading_t reading;
-        esp_err_t ret = sensor_reader_get_all(&reading);
+        esp_err_t ret = sensor_scheduler_get_latest(&reading);
 
         if (ret != ESP_OK) {
             // Falló lectura de sensores - log reducido para evitar spam
@@ -73,16 +177,22 @@ static void sensor_publishing_task(void *pvParameters)
             continue;  // Saltar publicación si no hay datos válidos
         }
 
+        // Sin muestra nueva desde el último ciclo: no republicar
+        if (reading.reading_id == last_published_id) {
+            continue;
+        }
+        last_published_id = reading.reading_id;
+
         // 2. LOG DE DATOS LEÍDOS - SIEMPRE (independiente de MQTT)
         // FIX: Mover logs ANTES del check MQTT para visibilidad en modo offline
         if (cycle_count % 5 == 0) {
-            ESP_LOGI(TAG, "Cycle %" PRIu32 ": T=%.1f°C H=%.1f%% Soil=[%.1f%%, %.1f%%, %.1f%%] - Heap:%" PRIu32,
+            ESP_LOGI(TAG, "Cycle %" PRIu32 ": T=%.1f°C H=%.1f%% Soil=%.1f%% prom/%.1f%% máx (%d sensores) - Heap:%" PRIu32,
                      cycle_count,
                      reading.ambient.temperature,
                      reading.ambient.humidity,
-                     reading.soil.soil_humidity[0],
-                     reading.soil.soil_humidity[1],
-                     reading.soil.soil_humidity[2],
+                     sensor_reader_soil_average(&reading.soil),
+                     sensor_reader_soil_max(&reading.soil),
+                     reading.soil.sensor_count,
                      esp_get_free_heap_size());
         }
 
@@ -102,10 +212,17 @@ static void sensor_publishing_task(void *pvParameters)
             continue;
         }
 
+        // Firmware nuevo con broker alcanzable y un ciclo de sensores completo:
+        // se considera válido (cancela rollback; no-op si ya está confirmado)
+        ota_manager_confirm_image();
+
         // Éxito - log solo cada 10 ciclos (5 minutos)
         if (cycle_count % 10 == 0) {
             ESP_LOGI(TAG, "Cycle %" PRIu32 ": Data published successfully to MQTT", cycle_count);
         }
+
+        // 5. ESTADO Y ESTADÍSTICAS DE RIEGO (al cambiar o cada 5 minutos)
+        publish_irrigation_status(sensor_reader_soil_average(&reading.soil), cycle_count);
     }
 }
 
@@ -117,9 +234,10 @@ static void sensor_publishing_task(void *pvParameters)
  * - START: Inicia riego con duración especificada (default 15 min)
  * - STOP: Detiene riego normalmente
  * - EMERGENCY_STOP: Detiene riego y activa safety lock
+ * - START_PULSE: Riego por pulsos (ciclo y remojo) hasta sumar la duración
  *
- * @param command Tipo de comando (START/STOP/EMERGENCY_STOP)
- * @param duration_minutes Duración en minutos (solo para START, 0=default)
+ * @param command Tipo de comando (START/STOP/EMERGENCY_STOP/START_PULSE)
+ * @param duration_minutes Duración en minutos (START/START_PULSE, 0=default)
  * @param user_data Datos de usuario (no utilizado)
  */
 static void mqtt_irrigation_command_handler(irrigation_command_t command,
@@ -127,7 +245,7 @@ static void mqtt_irrigation_command_handler(irrigation_command_t command,
                                            void* user_data)
 {
     // Nombres de comandos para logging
-    const char* cmd_names[] = {"START", "STOP", "EMERGENCY_STOP", "PAUSE", "RESUME"};
+    const char* cmd_names[] = {"START", "STOP", "EMERGENCY_STOP", "PAUSE", "RESUME", "START_PULSE"};
 
     ESP_LOGI(TAG, "MQTT irrigation command received: %s (duration: %d min)",
              cmd_names[command], duration_minutes);
@@ -147,77 +265,104 @@ static void mqtt_irrigation_command_handler(irrigation_command_t command,
 
 /**
  * @brief Manejador de eventos WiFi para la aplicación principal
+ *
+ * Suscriptor del bus de eventos; corre en su propia tarea de despacho.
  */
-static void main_wifi_event_handler(void* arg, esp_event_base_t event_base,
-                                    int32_t event_id, void* event_data)
+static void main_wifi_event_handler(const event_bus_event_t *event, void *user_ctx)
 {
-    if (event_base == WIFI_MANAGER_EVENTS) {
-        switch (event_id) {
-            case WIFI_MANAGER_EVENT_INIT_COMPLETE:
-                ESP_LOGI(TAG, "WiFi manager inicializado");
-                break;
-
-            case WIFI_MANAGER_EVENT_PROVISIONING_STARTED:
-                ESP_LOGI(TAG, "Modo de aprovisionamiento WiFi iniciado");
-                ESP_LOGI(TAG, "Conectar a red 'Liwaisi-Config' para configurar WiFi");
-                break;
-
-            case WIFI_MANAGER_EVENT_PROVISIONING_COMPLETED:
-                ESP_LOGI(TAG, "Aprovisionamiento WiFi completado");
-                break;
-
-            case WIFI_MANAGER_EVENT_CONNECTED:
-                ESP_LOGI(TAG, "Conexión WiFi establecida");
-                break;
-
-            case WIFI_MANAGER_EVENT_IP_OBTAINED: {
-                esp_ip4_addr_t ip;
-                if (wifi_manager_get_ip(&ip) == ESP_OK) {
-                    ESP_LOGI(TAG, "Dirección IP obtenida: " IPSTR, IP2STR(&ip));
-                }
-
-                // Initialize HTTP server when IP is obtained (both after provisioning and normal connections)
-                if (!s_http_server_initialized) {
-                    ESP_LOGI(TAG, "Inicializando servidor HTTP tras obtener IP...");
-                    // Small delay to ensure any provisioning server is fully stopped
-                    vTaskDelay(pdMS_TO_TICKS(1000));
+    switch (event->id) {
+        case EVENT_BUS_WIFI_INIT_COMPLETE:
+            ESP_LOGI(TAG, "WiFi manager inicializado");
+            break;
+
+        case EVENT_BUS_WIFI_PROVISIONING_STARTED:
+            ESP_LOGI(TAG, "Modo de aprovisionamiento WiFi iniciado");
+            ESP_LOGI(TAG, "Conectar a red 'Liwaisi-Config' para configurar WiFi");
+            break;
+
+        case EVENT_BUS_WIFI_PROVISIONING_COMPLETED:
+            ESP_LOGI(TAG, "Aprovisionamiento WiFi completado");
+            break;
+
+        case EVENT_BUS_WIFI_CONNECTED:
+            ESP_LOGI(TAG, "Conexión WiFi establecida");
+            break;
+
+        case EVENT_BUS_WIFI_IP_OBTAINED: {
+            esp_ip4_addr_t ip = { .addr = event->data.ip_addr };
+            if (ip.addr != 0 || wifi_manager_get_ip(&ip) == ESP_OK) {
+                ESP_LOGI(TAG, "Dirección IP obtenida: " IPSTR, IP2STR(&ip));
+            }
 
-                    // Use default HTTP server configuration
-                    esp_err_t ret = http_server_init(NULL);  // NULL = use defaults
+            // Initialize HTTP server when IP is obtained (both after provisioning and normal connections)
+            if (!s_http_server_initialized) {
+                ESP_LOGI(TAG, "Inicializando servidor HTTP tras obtener IP...");
+                // Small delay to ensure any provisioning server is fully stopped
+                vTaskDelay(pdMS_TO_TICKS(1000));
+
+                // Use default HTTP server configuration
+                esp_err_t ret = http_server_init(NULL);  // NULL = use defaults
+                if (ret == ESP_OK) {
+                    // FIX: Start HTTP server (init only configures, start actually opens port)
+                    ret = http_server_start();
                     if (ret == ESP_OK) {
-                        // FIX: Start HTTP server (init only configures, start actually opens port)
-                        ret = http_server_start();
-                        if (ret == ESP_OK) {
-                            s_http_server_initialized = true;
-                            ESP_LOGI(TAG, "Servidor HTTP arrancado correctamente en IP: " IPSTR " puerto 80", IP2STR(&ip));
-                        } else {
-                            ESP_LOGE(TAG, "Error al arrancar servidor HTTP: %s", esp_err_to_name(ret));
-                        }
+                        s_http_server_initialized = true;
+                        ESP_LOGI(TAG, "Servidor HTTP arrancado correctamente en IP: " IPSTR " puerto 80", IP2STR(&ip));
                     } else {
-                        ESP_LOGE(TAG, "Error al inicializar servidor HTTP: %s", esp_err_to_name(ret));
+                        ESP_LOGE(TAG, "Error al arrancar servidor HTTP: %s", esp_err_to_name(ret));
                     }
+                } else {
+                    ESP_LOGE(TAG, "Error al inicializar servidor HTTP: %s", esp_err_to_name(ret));
                 }
-                break;
             }
+            break;
+        }
 
-            case WIFI_MANAGER_EVENT_DISCONNECTED:
-                ESP_LOGW(TAG, "Conexión WiFi perdida - reintentando...");
-                break;
+        case EVENT_BUS_WIFI_DISCONNECTED:
+            ESP_LOGW(TAG, "Conexión WiFi perdida - reintentando...");
+            break;
 
-            case WIFI_MANAGER_EVENT_RESET_REQUESTED:
-                ESP_LOGW(TAG, "Patrón de reinicio detectado - iniciando aprovisionamiento");
-                break;
+        case EVENT_BUS_WIFI_RESET_REQUESTED:
+            ESP_LOGW(TAG, "Patrón de reinicio detectado - iniciando aprovisionamiento");
+            break;
 
-            case WIFI_MANAGER_EVENT_CONNECTION_FAILED:
-                ESP_LOGE(TAG, "Fallo en conexión WiFi");
-                break;
+        case EVENT_BUS_WIFI_CONNECTION_FAILED:
+            ESP_LOGE(TAG, "Fallo en conexión WiFi");
+            break;
 
-            default:
-                break;
-        }
+        default:
+            break;
     }
 }
 
+/**
+ * @brief Registra las tareas del sistema en la auditoría de footprint
+ *
+ * Los tamaños vienen de menuconfig, así el reporte compara el stack
+ * configurado contra el high-water mark real. Sin efecto si
+ * CONFIG_FOOTPRINT_AUDIT_ENABLE está deshabilitado.
+ */
+static void main_register_footprint_tasks(void)
+{
+    const http_server_config_t http_defaults = HTTP_SERVER_DEFAULT_CONFIG();
+
+    // Tareas de la aplicación y componentes propios
+    footprint_audit_register_task("sensor_publish", SENSOR_PUBLISH_TASK_STACK_SIZE);
+    footprint_audit_register_task("sensor_sched", CONFIG_SENSOR_SCHED_TASK_STACK_SIZE);
+    footprint_audit_register_task("main_wifi_bus", MAIN_BUS_TASK_STACK_SIZE);
+    footprint_audit_register_task("irrigation_task", CONFIG_IRRIGATION_TASK_STACK_SIZE);
+    footprint_audit_register_task("mqtt_task", CONFIG_MQTT_TASK_STACK_SIZE);
+    footprint_audit_register_task("mqtt_bus", CONFIG_MQTT_BUS_TASK_STACK_SIZE);
+    footprint_audit_register_task("dlog_flush", CONFIG_DEFERRED_LOG_TASK_STACK_SIZE);
+    footprint_audit_register_task("ota_update", CONFIG_OTA_MANAGER_TASK_STACK_SIZE);
+    footprint_audit_register_task("httpd", http_defaults.stack_size);
+
+    // Tareas de ESP-IDF reducidas en sdkconfig.defaults
+    footprint_audit_register_task("sys_evt", CONFIG_ESP_SYSTEM_EVENT_TASK_STACK_SIZE);
+    footprint_audit_register_task("tiT", CONFIG_LWIP_TCPIP_TASK_STACK_SIZE);
+    footprint_audit_register_task("esp_timer", CONFIG_ESP_TIMER_TASK_STACK_SIZE);
+}
+
 /**
  * @brief Punto de entrada principal de la aplicación
  *
@@ -244,12 +389,69 @@ void app_main(void)
     ESP_ERROR_CHECK(ret);
     ESP_ERROR_CHECK(esp_event_loop_create_default());
 
-    // Inicializar componente sensor_reader (DHT22 + sensores de suelo)
+    // Métricas: heap y uptime; cada componente registra sus contadores al iniciar
+    ret = metrics_init();
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Métricas del sistema no disponibles: %s", esp_err_to_name(ret));
+    }
+
+    // Logs diferidos: las rutas calientes (ADC, ciclo de riego) no formatean en línea
+    ret = deferred_log_init();
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Logs diferidos no disponibles: %s - formateo síncrono", esp_err_to_name(ret));
+    }
+
+    // Registro de decisiones en flash (partición irrlog, consultas vía /events y MQTT)
+    ret = decision_log_init();
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Registro de decisiones no disponible: %s", esp_err_to_name(ret));
+    }
+
+    // Caché de payloads: MQTT y HTTP comparten la misma codificación de cada muestra
+    ret = payload_cache_init();
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Caché de payloads no disponible: %s", esp_err_to_name(ret));
+    }
+
+    // Auditoría de footprint (solo con CONFIG_FOOTPRINT_AUDIT_ENABLE)
+    ret = footprint_audit_init();
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Auditoría de footprint no disponible: %s", esp_err_to_name(ret));
+    }
+
+    // OTA: confirma o revierte la imagen recién instalada
+    ret = ota_manager_init();
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Error al inicializar ota_manager: %s", esp_err_to_name(ret));
+    }
+
+    // Inicializar servicio de configuración del dispositivo
+    // (antes de sensor_reader: define el sensor ambiental instalado)
+    ESP_LOGI(TAG, "Inicializando servicio de configuración del dispositivo...");
+    ESP_ERROR_CHECK(device_config_init());
+
+    ambient_sensor_type_t ambient_sensor = AMBIENT_SENSOR_DHT22;
+    ret = device_config_get_ambient_sensor(&ambient_sensor);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Sensor ambiental no configurado (%s) - usando DHT22", esp_err_to_name(ret));
+        ambient_sensor = AMBIENT_SENSOR_DHT22;
+    }
+
+    // Sensores de suelo instalados (más de 3 sólo con multiplexor analógico)
+    uint8_t soil_sensor_count = 3;
+    ret = device_config_get_soil_sensor_count(&soil_sensor_count);
+    if (ret != ESP_OK || soil_sensor_count == 0 || soil_sensor_count > SOIL_MAX_SENSORS) {
+        ESP_LOGW(TAG, "Cantidad de sensores de suelo inválida - usando 3");
+        soil_sensor_count = 3;
+    }
+
+    // Inicializar componente sensor_reader (sensor ambiental + sensores de suelo)
     ESP_LOGI(TAG, "Inicializando componente sensor_reader...");
     sensor_config_t sensor_cfg = {
-        .soil_sensor_count = 3,
+        .soil_sensor_count = soil_sensor_count,
         .enable_soil_filtering = true,
         .filter_window_size = 5,
+        .ambient_sensor = ambient_sensor,
         .dht22_gpio = GPIO_DHT22,           // Definido en common_types.h como 18
         .dht22_read_timeout_ms = 2000,
         .adc_attenuation = ADC_ATTEN_DB_12,
@@ -257,30 +459,54 @@ void app_main(void)
         .soil_cal_wet_mv = {1200, 1200, 1200},
         .max_consecutive_errors = 5
     };
+    footprint_audit_heap_begin("sensor_reader");
     ret = sensor_reader_init(&sensor_cfg);
+    footprint_audit_heap_end();
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Error al inicializar sensor_reader: %s", esp_err_to_name(ret));
         ESP_LOGE(TAG, "CRITICAL: Sistema no puede funcionar sin sensores");
         ESP_ERROR_CHECK(ESP_FAIL);  // Forzar reinicio
     } else {
-        ESP_LOGI(TAG, "Sensor reader inicializado: DHT22 (GPIO %d) + %d sensores suelo",
-                 GPIO_DHT22, sensor_cfg.soil_sensor_count);
+        ESP_LOGI(TAG, "Sensor reader inicializado: sensor ambiental %d + %d sensores suelo",
+                 ambient_sensor, sensor_cfg.soil_sensor_count);
     }
-    
-    // Inicializar servicio de configuración del dispositivo
-    ESP_LOGI(TAG, "Inicializando servicio de configuración del dispositivo...");
-    ESP_ERROR_CHECK(device_config_init());
 
+    // Planificador de muestreo: a partir de aquí sólo él accede a los sensores
+    ret = sensor_scheduler_start();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Error al iniciar sensor_scheduler: %s", esp_err_to_name(ret));
+        ESP_ERROR_CHECK(ESP_FAIL);  // Forzar reinicio
+    }
+    
     // 2. Inicialización de componentes de conectividad
     ESP_LOGI(TAG, "Inicializando componentes de conectividad...");
 
-    // Registrar manejador de eventos WiFi
-    ESP_ERROR_CHECK(esp_event_handler_register(WIFI_MANAGER_EVENTS, ESP_EVENT_ANY_ID, &main_wifi_event_handler, NULL));
+    // Suscribir manejador de eventos WiFi al bus
+    const event_bus_subscriber_config_t wifi_sub = {
+        .name = "main_wifi_bus",
+        .event_mask = EVENT_BUS_MASK_WIFI,
+        .handler = main_wifi_event_handler,
+        .user_ctx = NULL,
+        .stack_size = MAIN_BUS_TASK_STACK_SIZE,
+        .priority = MAIN_BUS_TASK_PRIORITY,
+        .queue_len = 0,
+    };
+    ESP_ERROR_CHECK(event_bus_subscribe(&wifi_sub));
 
     // Inicializar y arrancar WiFi manager
     ESP_LOGI(TAG, "Inicializando WiFi manager...");
+    footprint_audit_heap_begin("wifi+time_sync");
     ESP_ERROR_CHECK(wifi_manager_init());
+
+    // Sincronización horaria (SNTP arranca con cada IP obtenida)
+    ret = time_sync_init();
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Error al inicializar time_sync: %s", esp_err_to_name(ret));
+        ESP_LOGW(TAG, "Timestamps quedarán marcados como 'unsynced'");
+    }
+
     ESP_ERROR_CHECK(wifi_manager_start());
+    footprint_audit_heap_end();
 
     // Mostrar estado del dispositivo
     wifi_manager_status_t wifi_status;
@@ -300,7 +526,9 @@ void app_main(void)
 
     // Inicializar cliente MQTT
     ESP_LOGI(TAG, "Inicializando cliente MQTT...");
+    footprint_audit_heap_begin("mqtt_client");
     ESP_ERROR_CHECK(mqtt_client_init());
+    footprint_audit_heap_end();
 
     // Inicializar servicio de notificaciones (webhooks N8N)
     ESP_LOGI(TAG, "Inicializando servicio de notificaciones...");
@@ -315,7 +543,9 @@ void app_main(void)
     // Inicializar controlador de riego (Phase 5)
     ESP_LOGI(TAG, "Inicializando controlador de riego...");
     irrigation_controller_config_t irrig_cfg = IRRIGATION_CONTROLLER_DEFAULT_CONFIG();
+    footprint_audit_heap_begin("irrigation");
     ret = irrigation_controller_init(&irrig_cfg);
+    footprint_audit_heap_end();
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Error al inicializar irrigation_controller: %s", esp_err_to_name(ret));
         ESP_LOGW(TAG, "Sistema continuará sin control de riego automático");
@@ -323,6 +553,9 @@ void app_main(void)
         ESP_LOGI(TAG, "Irrigation controller inicializado correctamente");
     }
 
+    // Estado de riego para GET /status (el servidor HTTP arranca después, con IP)
+    http_server_register_status_provider(http_irrigation_status_provider, NULL);
+
     // Registrar callback para comandos MQTT de riego
     ESP_LOGI(TAG, "Registrando callback de comandos MQTT para riego...");
     ret = mqtt_client_register_command_callback(mqtt_irrigation_command_handler, NULL);
@@ -349,6 +582,8 @@ void app_main(void)
         ESP_ERROR_CHECK(ESP_FAIL); // This will cause a restart
     }
 
+    main_register_footprint_tasks();
+
     // 4. Mensaje de inicialización completa
     ESP_LOGI(TAG, "==============================================");
     ESP_LOGI(TAG, "Sistema inicializado correctamente");
@@ -0,0 +1,1074 @@
+/**
+ * @file fleet_loadgen.c
+ * @brief Fleet load generator - thousands of virtual devices in one process
+ *
+ * Runs N virtual irrigation devices against an in-process broker stand-in
+ * and reports the traffic a real broker would see for one firmware
+ * configuration: messages/s, bytes/s, reconnect-storm peaks and command
+ * acknowledgement latency.
+ *
+ * Payloads are produced by the firmware's own code (payload_codec.c for
+ * sensor_data, mqtt_protocol.c for topics, client ids, registration,
+ * irrigation_status and reconnect backoff), so payload sizes follow the
+ * firmware as it changes. Device behaviour mirrors main and mqtt_adapter:
+ *
+ * - Sensor cycle every SENSOR_PUBLISH_INTERVAL_MS; skipped while offline
+ * - irrigation_status after a successful sensor publish when the state
+ *   changed (the de facto command ack) or every IRRIGATION_STATUS_PUBLISH_CYCLES
+ * - On CONNACK: device_registration (QoS 1) then SUBSCRIBE to the control topic
+ * - Reconnect after the current retry delay. mqtt_adapter re-arms the timer
+ *   with an unchanged delay on MQTT_EVENT_DISCONNECTED/ERROR and only
+ *   doubles it when the client fails to start, so "fixed" is the default
+ * - esp-mqtt sends PINGREQ every half keepalive period
+ *
+ * Single-threaded discrete-event loop on a virtual clock (a min-heap of
+ * timed events, no thread per device), so a 10k device fleet runs far
+ * faster than real time. No sockets are opened; the broker stand-in
+ * accounts MQTT 3.1.1 packets at wire size plus WebSocket framing and TLS
+ * record overhead for the selected transport. TCP/IP headers are not
+ * counted. Counts are PUBLISH messages, or packets for session/keepalive.
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "payload_codec.h"
+#include "mqtt_protocol.h"
+#include "cJSON.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <getopt.h>
+#include <math.h>
+#include <time.h>
+
+/* ============================ CONSTANTS ============================ */
+
+// Firmware defaults (main/iot-soc-smart-irrigation.c, payload_cache Kconfig)
+#define FIRMWARE_PUBLISH_INTERVAL_MS    30000
+#define FIRMWARE_STATUS_CYCLES          10
+#define FIRMWARE_PAYLOAD_BUFFER_SIZE    1536
+#define FIRMWARE_CROP_NAME              "Unknown"
+#define FIRMWARE_DEVICE_NAME            "Smart Irrigation Device"
+
+// Wall clock of the virtual fleet at t=0 (SNTP-synced devices)
+#define LOADGEN_EPOCH_S                 1792195200u
+
+// MQTT 3.1.1 fixed sizes
+#define MQTT_CONNECT_VARIABLE_HEADER    10      ///< "MQTT", level, flags, keepalive
+#define MQTT_CONNACK_SIZE               4
+#define MQTT_PUBACK_SIZE                4
+#define MQTT_SUBACK_SIZE                5
+#define MQTT_PING_SIZE                  2
+
+// Transport overhead (approximate, per connection / per packet)
+#define WS_UPGRADE_REQUEST_SIZE         260     ///< GET /mqtt Upgrade request
+#define WS_UPGRADE_RESPONSE_SIZE        130     ///< 101 Switching Protocols
+#define WS_MASK_SIZE                    4       ///< Client frames are masked
+#define TLS_CLIENT_HANDSHAKE_SIZE       600     ///< ClientHello, key exchange, Finished
+#define TLS_SERVER_HANDSHAKE_SIZE       4200    ///< ServerHello, certificate chain, Finished
+#define TLS_RECORD_OVERHEAD             29      ///< Header, explicit nonce, GCM tag
+
+#define US_PER_S                        1000000.0
+
+/* ============================ TYPES ============================ */
+
+typedef enum {
+    TRANSPORT_TCP = 0,
+    TRANSPORT_WS,
+    TRANSPORT_WSS,
+} transport_t;
+
+typedef enum {
+    BACKOFF_FIXED = 0,          ///< Retry at the current delay (firmware on disconnect)
+    BACKOFF_EXPONENTIAL,        ///< mqtt_protocol_next_retry_delay() after every failure
+} backoff_t;
+
+/**
+ * @brief One firmware configuration under test
+ */
+typedef struct {
+    uint32_t devices;
+    uint32_t duration_s;
+    uint32_t ramp_s;                ///< Boot times spread over [0, ramp_s)
+    bool binary;                    ///< Compact binary sensor_data instead of JSON
+    int qos;
+    uint32_t interval_ms;
+    uint32_t status_cycles;
+    uint32_t keepalive_s;
+    uint8_t soil_sensors;
+    transport_t transport;
+    backoff_t backoff;
+    uint32_t jitter_pct;            ///< +/- spread applied to retry delays
+    double drops_per_hour;          ///< Per device link drops
+    double commands_per_hour;       ///< Per device irrigation commands
+    uint32_t outage_start_s;        ///< Broker outage, 0 length = none
+    uint32_t outage_len_s;
+    uint64_t seed;
+    bool csv;
+} loadgen_config_t;
+
+typedef enum {
+    EV_CONNECT = 0,             ///< Connection attempt
+    EV_CYCLE,                   ///< Sensor publishing cycle
+    EV_PING,                    ///< Keepalive
+    EV_DROP,                    ///< Link drop
+    EV_COMMAND,                 ///< Backend sends an irrigation command
+    EV_OUTAGE_START,
+    EV_OUTAGE_END,
+} event_type_t;
+
+typedef struct {
+    uint64_t at_ms;
+    uint32_t device;
+    uint32_t epoch;             ///< Connection epoch; connection-bound events go stale
+    uint8_t type;
+} event_t;
+
+typedef struct {
+    event_t *items;
+    size_t count;
+    size_t capacity;
+} event_queue_t;
+
+typedef enum {
+    MSG_REGISTRATION = 0,
+    MSG_SENSOR_DATA,
+    MSG_STATUS,
+    MSG_COMMAND,
+    MSG_SESSION,                ///< CONNECT/CONNACK/SUBSCRIBE/SUBACK/PUBACK/handshakes
+    MSG_KEEPALIVE,
+    MSG_TYPE_COUNT
+} msg_type_t;
+
+typedef struct {
+    uint64_t count;
+    uint64_t wire_bytes;
+    uint64_t payload_bytes;
+} msg_stats_t;
+
+/**
+ * @brief Per simulated second
+ */
+typedef struct {
+    uint32_t publishes;
+    uint32_t connects;
+    uint32_t attempts;
+    uint64_t bytes;
+} second_stats_t;
+
+/**
+ * @brief Virtual device
+ */
+typedef struct {
+    uint8_t mac[6];
+    char mac_str[18];
+    char client_id[MQTT_CLIENT_ID_LENGTH];
+    uint64_t boot_ms;
+    uint64_t command_ms;        ///< Pending command arrival, 0 if none
+    uint32_t epoch;
+    uint32_t retry_delay_ms;
+    uint32_t cycle;
+    uint32_t reading_id;
+    bool connected;
+    bool status_dirty;
+    float temperature;
+    float humidity;
+    float soil[SOIL_MAX_SENSORS];
+    irrigation_status_t status;
+} vdevice_t;
+
+/* ============================ PRIVATE STATE ============================ */
+
+static loadgen_config_t s_cfg = {
+    .devices = 1000,
+    .duration_s = 3600,
+    .ramp_s = 60,
+    .qos = MQTT_DEFAULT_QOS,
+    .interval_ms = FIRMWARE_PUBLISH_INTERVAL_MS,
+    .status_cycles = FIRMWARE_STATUS_CYCLES,
+    .keepalive_s = MQTT_DEFAULT_KEEPALIVE_SEC,
+    .soil_sensors = 3,
+    .transport = TRANSPORT_WSS,
+    .backoff = BACKOFF_FIXED,
+    .seed = 1,
+};
+
+static vdevice_t *s_devices = NULL;
+static event_queue_t s_queue = {0};
+static second_stats_t *s_seconds = NULL;
+static msg_stats_t s_msgs[MSG_TYPE_COUNT];
+
+static uint64_t s_rng_state = 1;
+static uint64_t s_now_ms = 0;
+static bool s_broker_down = false;
+static uint32_t s_connected = 0;
+static uint64_t s_recovered_ms = 0;
+
+static uint64_t s_publishes_up = 0;
+static uint64_t s_publishes_down = 0;
+static uint64_t s_packets = 0;
+static uint64_t s_bytes_up = 0;
+static uint64_t s_bytes_down = 0;
+static uint64_t s_connects = 0;
+static uint64_t s_failed_attempts = 0;
+static uint64_t s_skipped_cycles = 0;
+static uint64_t s_commands_lost = 0;
+static uint64_t s_acks = 0;
+static uint64_t s_ack_latency_sum_ms = 0;
+static uint64_t s_ack_latency_max_ms = 0;
+static uint64_t s_encodes = 0;
+static double s_encode_us = 0.0;
+
+static size_t s_command_start_len = 0;
+static size_t s_command_stop_len = 0;
+
+static const char *s_msg_names[MSG_TYPE_COUNT] = {
+    "registration", "sensor_data", "irrigation_status", "command", "session", "keepalive"
+};
+static const char *s_transport_names[] = { "tcp", "ws", "wss" };
+static const char *s_backoff_names[] = { "fixed", "exponential" };
+
+/* ============================ HELPERS ============================ */
+
+static uint64_t rng_next(void)
+{
+    // xorshift64*
+    s_rng_state ^= s_rng_state >> 12;
+    s_rng_state ^= s_rng_state << 25;
+    s_rng_state ^= s_rng_state >> 27;
+    return s_rng_state * 2685821657736338717ull;
+}
+
+static double rng_unit(void)
+{
+    return (double)(rng_next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * @brief Exponentially distributed interval for a per-hour rate, 0 if disabled
+ */
+static uint64_t rng_interval_ms(double per_hour)
+{
+    if (per_hour <= 0.0) {
+        return 0;
+    }
+    double u = rng_unit();
+    return 1 + (uint64_t)(-log(1.0 - u) * 3600000.0 / per_hour);
+}
+
+static double host_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * US_PER_S + (double)ts.tv_nsec / 1000.0;
+}
+
+static float clampf(float value, float min, float max)
+{
+    return value < min ? min : (value > max ? max : value);
+}
+
+/* ============================ EVENT QUEUE ============================ */
+
+static bool event_before(const event_t *a, const event_t *b)
+{
+    return a->at_ms < b->at_ms;
+}
+
+static void queue_push(uint64_t at_ms, uint32_t device, uint32_t epoch, event_type_t type)
+{
+    if (s_queue.count == s_queue.capacity) {
+        size_t capacity = s_queue.capacity ? s_queue.capacity * 2 : 1024;
+        event_t *items = realloc(s_queue.items, capacity * sizeof(event_t));
+        if (items == NULL) {
+            fprintf(stderr, "fleet_loadgen: out of memory (%zu events)\n", capacity);
+            exit(EXIT_FAILURE);
+        }
+        s_queue.items = items;
+        s_queue.capacity = capacity;
+    }
+
+    size_t i = s_queue.count++;
+    event_t ev = { .at_ms = at_ms, .device = device, .epoch = epoch, .type = (uint8_t)type };
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (!event_before(&ev, &s_queue.items[parent])) {
+            break;
+        }
+        s_queue.items[i] = s_queue.items[parent];
+        i = parent;
+    }
+    s_queue.items[i] = ev;
+}
+
+static bool queue_pop(event_t *out)
+{
+    if (s_queue.count == 0) {
+        return false;
+    }
+
+    *out = s_queue.items[0];
+    event_t last = s_queue.items[--s_queue.count];
+    size_t i = 0;
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= s_queue.count) {
+            break;
+        }
+        if (child + 1 < s_queue.count && event_before(&s_queue.items[child + 1], &s_queue.items[child])) {
+            child++;
+        }
+        if (!event_before(&s_queue.items[child], &last)) {
+            break;
+        }
+        s_queue.items[i] = s_queue.items[child];
+        i = child;
+    }
+    if (s_queue.count > 0) {
+        s_queue.items[i] = last;
+    }
+    return true;
+}
+
+/* ============================ BROKER STAND-IN ============================ */
+
+static size_t mqtt_packet_size(size_t remaining_length)
+{
+    size_t length_bytes = remaining_length < 128 ? 1
+                        : remaining_length < 16384 ? 2
+                        : remaining_length < 2097152 ? 3 : 4;
+    return 1 + length_bytes + remaining_length;
+}
+
+static size_t mqtt_publish_size(size_t topic_len, size_t payload_len, int qos)
+{
+    return mqtt_packet_size(2 + topic_len + (qos > 0 ? 2 : 0) + payload_len);
+}
+
+/**
+ * @brief Bytes on the socket for one MQTT packet on the configured transport
+ */
+static size_t transport_size(size_t mqtt_len, bool upstream)
+{
+    size_t len = mqtt_len;
+    if (s_cfg.transport >= TRANSPORT_WS) {
+        len += (mqtt_len < 126) ? 2 : (mqtt_len < 65536) ? 4 : 10;
+        len += upstream ? WS_MASK_SIZE : 0;
+    }
+    if (s_cfg.transport == TRANSPORT_WSS) {
+        len += TLS_RECORD_OVERHEAD;
+    }
+    return len;
+}
+
+static second_stats_t* current_second(void)
+{
+    uint64_t second = s_now_ms / 1000;
+    return &s_seconds[second < s_cfg.duration_s ? second : s_cfg.duration_s - 1];
+}
+
+static void account_raw(msg_type_t type, size_t wire_len, bool upstream)
+{
+    s_msgs[type].wire_bytes += wire_len;
+    current_second()->bytes += wire_len;
+    if (upstream) {
+        s_bytes_up += wire_len;
+    } else {
+        s_bytes_down += wire_len;
+    }
+}
+
+static void account_packet(msg_type_t type, size_t mqtt_len, bool upstream)
+{
+    s_packets++;
+    if (type == MSG_SESSION || type == MSG_KEEPALIVE) {
+        s_msgs[type].count++;
+    }
+    account_raw(type, transport_size(mqtt_len, upstream), upstream);
+}
+
+/**
+ * @brief PUBLISH in either direction plus its PUBACK at QoS 1
+ */
+static void account_publish(msg_type_t type, size_t topic_len, size_t payload_len,
+                            int qos, bool upstream)
+{
+    s_msgs[type].count++;
+    s_msgs[type].payload_bytes += payload_len;
+    current_second()->publishes++;
+    if (upstream) {
+        s_publishes_up++;
+    } else {
+        s_publishes_down++;
+    }
+
+    account_packet(type, mqtt_publish_size(topic_len, payload_len, qos), upstream);
+    if (qos > 0) {
+        account_packet(MSG_SESSION, MQTT_PUBACK_SIZE, !upstream);
+    }
+}
+
+/* ============================ VIRTUAL DEVICE ============================ */
+
+static uint32_t retry_delay_with_jitter(uint32_t delay_ms)
+{
+    if (s_cfg.jitter_pct == 0) {
+        return delay_ms;
+    }
+    double spread = (double)delay_ms * s_cfg.jitter_pct / 100.0;
+    double jittered = (double)delay_ms + (rng_unit() * 2.0 - 1.0) * spread;
+    return jittered < 1.0 ? 1 : (uint32_t)jittered;
+}
+
+static void device_schedule_reconnect(uint32_t index)
+{
+    vdevice_t *dev = &s_devices[index];
+    queue_push(s_now_ms + retry_delay_with_jitter(dev->retry_delay_ms),
+               index, dev->epoch, EV_CONNECT);
+}
+
+static void device_disconnect(uint32_t index)
+{
+    vdevice_t *dev = &s_devices[index];
+    if (!dev->connected) {
+        return;
+    }
+    dev->connected = false;
+    dev->epoch++;
+    s_connected--;
+    device_schedule_reconnect(index);
+}
+
+static void device_publish_registration(vdevice_t *dev)
+{
+    cJSON *json = mqtt_protocol_registration_json(dev->mac_str, "0.0.0.0",
+                                                  FIRMWARE_DEVICE_NAME, FIRMWARE_CROP_NAME);
+    char *payload = (json != NULL) ? cJSON_Print(json) : NULL;
+    cJSON_Delete(json);
+    if (payload == NULL) {
+        return;
+    }
+
+    account_publish(MSG_REGISTRATION, strlen(MQTT_TOPIC_REGISTER), strlen(payload),
+                    MQTT_QOS_1, true);
+    cJSON_free(payload);
+}
+
+static void device_connect(uint32_t index)
+{
+    vdevice_t *dev = &s_devices[index];
+    second_stats_t *second = current_second();
+    second->attempts++;
+
+    if (s_broker_down) {
+        // Connection refused: no application bytes
+        s_failed_attempts++;
+        if (s_cfg.backoff == BACKOFF_EXPONENTIAL) {
+            dev->retry_delay_ms = mqtt_protocol_next_retry_delay(dev->retry_delay_ms);
+        }
+        device_schedule_reconnect(index);
+        return;
+    }
+
+    if (s_cfg.transport == TRANSPORT_WSS) {
+        account_raw(MSG_SESSION, TLS_CLIENT_HANDSHAKE_SIZE, true);
+        account_raw(MSG_SESSION, TLS_SERVER_HANDSHAKE_SIZE, false);
+    }
+    if (s_cfg.transport >= TRANSPORT_WS) {
+        account_raw(MSG_SESSION, WS_UPGRADE_REQUEST_SIZE, true);
+        account_raw(MSG_SESSION, WS_UPGRADE_RESPONSE_SIZE, false);
+    }
+    account_packet(MSG_SESSION,
+                   mqtt_packet_size(MQTT_CONNECT_VARIABLE_HEADER + 2 + strlen(dev->client_id)), true);
+    account_packet(MSG_SESSION, MQTT_CONNACK_SIZE, false);
+
+    dev->connected = true;
+    dev->epoch++;
+    dev->retry_delay_ms = MQTT_RECONNECT_INITIAL_DELAY_MS;
+    s_connected++;
+    s_connects++;
+    second->connects++;
+    if (s_connected == s_cfg.devices && s_recovered_ms == 0 && s_cfg.outage_len_s > 0 &&
+        s_now_ms >= (uint64_t)(s_cfg.outage_start_s + s_cfg.outage_len_s) * 1000) {
+        s_recovered_ms = s_now_ms;
+    }
+
+    // MQTT_EVENT_CONNECTED: registration, then command subscription
+    device_publish_registration(dev);
+
+    char topic[MQTT_MAX_TOPIC_LENGTH];
+    MQTT_BUILD_CONTROL_TOPIC(topic, dev->mac_str);
+    account_packet(MSG_SESSION, mqtt_packet_size(2 + 2 + strlen(topic) + 1), true);
+    account_packet(MSG_SESSION, MQTT_SUBACK_SIZE, false);
+
+    if (s_cfg.keepalive_s > 0) {
+        queue_push(s_now_ms + s_cfg.keepalive_s * 500u, index, dev->epoch, EV_PING);
+    }
+    uint64_t drop = rng_interval_ms(s_cfg.drops_per_hour);
+    if (drop > 0) {
+        queue_push(s_now_ms + drop, index, dev->epoch, EV_DROP);
+    }
+}
+
+/**
+ * @brief Advance the simulated sensors by one sample
+ */
+static void device_sample(vdevice_t *dev, sensor_reading_t *reading)
+{
+    uint32_t now_s = LOADGEN_EPOCH_S + (uint32_t)(s_now_ms / 1000);
+
+    dev->temperature = clampf(dev->temperature + (float)(rng_unit() - 0.5) * 0.4f, 5.0f, 45.0f);
+    dev->humidity = clampf(dev->humidity + (float)(rng_unit() - 0.5) * 1.0f, 20.0f, 99.0f);
+    float drift = (dev->status.state == IRRIGATION_ACTIVE) ? 0.5f : -0.05f;
+    for (uint8_t i = 0; i < s_cfg.soil_sensors; i++) {
+        dev->soil[i] = clampf(dev->soil[i] + drift + (float)(rng_unit() - 0.5) * 0.2f, 0.0f, 100.0f);
+    }
+
+    memset(reading, 0, sizeof(*reading));
+    reading->ambient.temperature = dev->temperature;
+    reading->ambient.humidity = dev->humidity;
+    reading->ambient.timestamp = now_s;
+    reading->ambient.time_quality = TIME_QUALITY_SNTP;
+    memcpy(reading->soil.soil_humidity, dev->soil, sizeof(dev->soil));
+    reading->soil.sensor_count = s_cfg.soil_sensors;
+    reading->soil.valid_mask = (uint16_t)((1u << s_cfg.soil_sensors) - 1);
+    reading->soil.time_quality = TIME_QUALITY_SNTP;
+    reading->soil.timestamp = now_s;
+    memcpy(reading->device_mac, dev->mac_str, sizeof(reading->device_mac));
+    snprintf(reading->device_ip, sizeof(reading->device_ip), "10.%u.%u.%u",
+             dev->mac[3], dev->mac[4], dev->mac[5]);
+    reading->reading_id = ++dev->reading_id;
+}
+
+static bool device_publish_sensor_data(vdevice_t *dev)
+{
+    static uint8_t payload[FIRMWARE_PAYLOAD_BUFFER_SIZE];
+
+    sensor_reading_t reading;
+    device_sample(dev, &reading);
+
+    payload_codec_context_t codec = {
+        .uptime_ms = (int64_t)(s_now_ms - dev->boot_ms),
+        .time_quality = "sntp",
+    };
+    memcpy(codec.mac, dev->mac, sizeof(codec.mac));
+
+    double start = host_us();
+    size_t len = s_cfg.binary
+        ? payload_codec_encode_binary(&reading, &codec, payload, sizeof(payload))
+        : payload_codec_encode_json(&reading, &codec, payload, sizeof(payload));
+    s_encode_us += host_us() - start;
+    s_encodes++;
+    if (len == 0) {
+        return false;
+    }
+
+    char topic[MQTT_MAX_TOPIC_LENGTH];
+    MQTT_BUILD_DATA_TOPIC(topic, FIRMWARE_CROP_NAME, dev->mac_str);
+    account_publish(MSG_SENSOR_DATA, strlen(topic), len, s_cfg.qos, true);
+    return true;
+}
+
+static void device_publish_status(vdevice_t *dev)
+{
+    cJSON *json = mqtt_protocol_irrigation_status_json(&dev->status, dev->mac_str,
+                                                       (int64_t)(s_now_ms - dev->boot_ms));
+    char *payload = (json != NULL) ? cJSON_Print(json) : NULL;
+    cJSON_Delete(json);
+    if (payload == NULL) {
+        return;
+    }
+
+    char topic[MQTT_MAX_TOPIC_LENGTH];
+    MQTT_BUILD_STATUS_TOPIC(topic, dev->mac_str);
+    account_publish(MSG_STATUS, strlen(topic), strlen(payload), MQTT_DEFAULT_QOS, true);
+    cJSON_free(payload);
+
+    dev->status_dirty = false;
+    if (dev->command_ms != 0) {
+        uint64_t latency = s_now_ms - dev->command_ms;
+        s_acks++;
+        s_ack_latency_sum_ms += latency;
+        if (latency > s_ack_latency_max_ms) {
+            s_ack_latency_max_ms = latency;
+        }
+        dev->command_ms = 0;
+    }
+}
+
+/**
+ * @brief One pass of sensor_publishing_task
+ */
+static void device_cycle(uint32_t index)
+{
+    vdevice_t *dev = &s_devices[index];
+    dev->cycle++;
+    queue_push(s_now_ms + s_cfg.interval_ms, index, 0, EV_CYCLE);
+
+    if (!dev->connected) {
+        s_skipped_cycles++;
+        return;
+    }
+    if (!device_publish_sensor_data(dev)) {
+        return;
+    }
+
+    if (dev->status_dirty || dev->cycle % s_cfg.status_cycles == 0) {
+        device_publish_status(dev);
+    }
+}
+
+static void device_command(uint32_t index)
+{
+    vdevice_t *dev = &s_devices[index];
+    queue_push(s_now_ms + rng_interval_ms(s_cfg.commands_per_hour), index, 0, EV_COMMAND);
+
+    if (!dev->connected) {
+        // Clean session: nothing queued for an offline subscriber
+        s_commands_lost++;
+        return;
+    }
+
+    bool start = (dev->status.state != IRRIGATION_ACTIVE);
+    char topic[MQTT_MAX_TOPIC_LENGTH];
+    MQTT_BUILD_CONTROL_TOPIC(topic, dev->mac_str);
+    account_publish(MSG_COMMAND, strlen(topic),
+                    start ? s_command_start_len : s_command_stop_len, MQTT_DEFAULT_QOS, false);
+
+    if (start) {
+        dev->status.state = IRRIGATION_ACTIVE;
+        dev->status.valve_number = 1;
+        dev->status.session_start_time = LOADGEN_EPOCH_S + (uint32_t)(s_now_ms / 1000);
+    } else {
+        uint32_t ran = LOADGEN_EPOCH_S + (uint32_t)(s_now_ms / 1000) - dev->status.session_start_time;
+        dev->status.state = IRRIGATION_IDLE;
+        dev->status.valve_number = 0;
+        dev->status.session_duration_sec = ran;
+        dev->status.total_runtime_today += ran;
+        dev->status.total_runtime_sec += ran;
+        dev->status.total_sessions++;
+    }
+    dev->status_dirty = true;
+    if (dev->command_ms == 0) {
+        dev->command_ms = s_now_ms;
+    }
+}
+
+static void device_ping(uint32_t index)
+{
+    vdevice_t *dev = &s_devices[index];
+    account_packet(MSG_KEEPALIVE, MQTT_PING_SIZE, true);
+    account_packet(MSG_KEEPALIVE, MQTT_PING_SIZE, false);
+    queue_push(s_now_ms + s_cfg.keepalive_s * 500u, index, dev->epoch, EV_PING);
+}
+
+static void device_init(uint32_t index)
+{
+    vdevice_t *dev = &s_devices[index];
+
+    // Espressif OUI, device index in the NIC-specific bytes
+    dev->mac[0] = 0x24;
+    dev->mac[1] = 0x6F;
+    dev->mac[2] = 0x28;
+    dev->mac[3] = (uint8_t)(index >> 16);
+    dev->mac[4] = (uint8_t)(index >> 8);
+    dev->mac[5] = (uint8_t)index;
+    mqtt_protocol_mac_string(dev->mac, dev->mac_str, sizeof(dev->mac_str));
+    mqtt_protocol_client_id(dev->mac, dev->client_id, sizeof(dev->client_id));
+
+    dev->boot_ms = (s_cfg.ramp_s > 0) ? (uint64_t)(rng_unit() * s_cfg.ramp_s * 1000.0) : 0;
+    dev->retry_delay_ms = MQTT_RECONNECT_INITIAL_DELAY_MS;
+    dev->status_dirty = true;  // First status after boot is always published
+    dev->temperature = 18.0f + (float)rng_unit() * 12.0f;
+    dev->humidity = 40.0f + (float)rng_unit() * 40.0f;
+    for (uint8_t i = 0; i < s_cfg.soil_sensors; i++) {
+        dev->soil[i] = 30.0f + (float)rng_unit() * 40.0f;
+    }
+    dev->status.state = IRRIGATION_IDLE;
+    dev->status.mode = IRRIGATION_MODE_ONLINE;
+
+    queue_push(dev->boot_ms, index, dev->epoch, EV_CONNECT);
+    queue_push(dev->boot_ms + s_cfg.interval_ms, index, 0, EV_CYCLE);
+    uint64_t command = rng_interval_ms(s_cfg.commands_per_hour);
+    if (command > 0) {
+        queue_push(dev->boot_ms + command, index, 0, EV_COMMAND);
+    }
+}
+
+/* ============================ SIMULATION ============================ */
+
+static size_t command_payload_len(const char *command)
+{
+    cJSON *json = cJSON_CreateObject();
+    if (json == NULL) {
+        return 0;
+    }
+    cJSON_AddStringToObject(json, "command", command);
+    if (strcmp(command, "start") == 0) {
+        cJSON_AddNumberToObject(json, "duration_minutes", 15);
+    }
+    char *text = cJSON_Print(json);
+    cJSON_Delete(json);
+
+    size_t len = (text != NULL) ? strlen(text) : 0;
+    cJSON_free(text);
+    return len;
+}
+
+static void broker_outage(bool start)
+{
+    s_broker_down = start;
+    if (!start) {
+        return;
+    }
+    // Broker restart: every session is reset at once
+    for (uint32_t i = 0; i < s_cfg.devices; i++) {
+        device_disconnect(i);
+    }
+}
+
+static void simulate(void)
+{
+    s_command_start_len = command_payload_len("start");
+    s_command_stop_len = command_payload_len("stop");
+
+    for (uint32_t i = 0; i < s_cfg.devices; i++) {
+        device_init(i);
+    }
+    if (s_cfg.outage_len_s > 0) {
+        queue_push((uint64_t)s_cfg.outage_start_s * 1000, UINT32_MAX, 0, EV_OUTAGE_START);
+        queue_push((uint64_t)(s_cfg.outage_start_s + s_cfg.outage_len_s) * 1000,
+                   UINT32_MAX, 0, EV_OUTAGE_END);
+    }
+
+    uint64_t end_ms = (uint64_t)s_cfg.duration_s * 1000;
+    event_t ev;
+    while (queue_pop(&ev) && ev.at_ms < end_ms) {
+        s_now_ms = ev.at_ms;
+
+        if (ev.type == EV_OUTAGE_START || ev.type == EV_OUTAGE_END) {
+            broker_outage(ev.type == EV_OUTAGE_START);
+            continue;
+        }
+
+        vdevice_t *dev = &s_devices[ev.device];
+        bool connection_bound = (ev.type == EV_CONNECT || ev.type == EV_PING || ev.type == EV_DROP);
+        if (connection_bound && ev.epoch != dev->epoch) {
+            continue;
+        }
+
+        switch ((event_type_t)ev.type) {
+            case EV_CONNECT:
+                if (!dev->connected) {
+                    device_connect(ev.device);
+                }
+                break;
+            case EV_CYCLE:
+                device_cycle(ev.device);
+                break;
+            case EV_PING:
+                device_ping(ev.device);
+                break;
+            case EV_DROP:
+                device_disconnect(ev.device);
+                break;
+            case EV_COMMAND:
+                device_command(ev.device);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/* ============================ REPORT ============================ */
+
+typedef struct {
+    double avg;
+    uint64_t peak;
+    uint32_t peak_s;
+} rate_t;
+
+static rate_t rate_of(uint64_t (*value)(const second_stats_t *))
+{
+    rate_t rate = {0};
+    uint64_t total = 0;
+    for (uint32_t s = 0; s < s_cfg.duration_s; s++) {
+        uint64_t v = value(&s_seconds[s]);
+        total += v;
+        if (v > rate.peak) {
+            rate.peak = v;
+            rate.peak_s = s;
+        }
+    }
+    rate.avg = (double)total / s_cfg.duration_s;
+    return rate;
+}
+
+static uint64_t second_publishes(const second_stats_t *s) { return s->publishes; }
+static uint64_t second_bytes(const second_stats_t *s) { return s->bytes; }
+static uint64_t second_connects(const second_stats_t *s) { return s->connects; }
+static uint64_t second_attempts(const second_stats_t *s) { return s->attempts; }
+
+static void report_text(double wall_s)
+{
+    rate_t msgs = rate_of(second_publishes);
+    rate_t bytes = rate_of(second_bytes);
+    rate_t connects = rate_of(second_connects);
+    rate_t attempts = rate_of(second_attempts);
+
+    printf("fleet_loadgen: %" PRIu32 " devices, %" PRIu32 " s, %s payload, QoS %d, %s, "
+           "interval %" PRIu32 " ms, keepalive %" PRIu32 " s, backoff %s",
+           s_cfg.devices, s_cfg.duration_s,
+           s_cfg.binary ? "binary" : "json", s_cfg.qos,
+           s_transport_names[s_cfg.transport], s_cfg.interval_ms, s_cfg.keepalive_s,
+           s_backoff_names[s_cfg.backoff]);
+    if (s_cfg.jitter_pct > 0) {
+        printf(" +/-%" PRIu32 "%%", s_cfg.jitter_pct);
+    }
+    printf("\n\n");
+
+    printf("Totals\n");
+    printf("  publishes       %12" PRIu64 "  (up %" PRIu64 ", down %" PRIu64 ")\n",
+           s_publishes_up + s_publishes_down, s_publishes_up, s_publishes_down);
+    printf("  packets         %12" PRIu64 "\n", s_packets);
+    printf("  bytes           %12" PRIu64 "  (up %" PRIu64 ", down %" PRIu64 ")\n",
+           s_bytes_up + s_bytes_down, s_bytes_up, s_bytes_down);
+    printf("  connects        %12" PRIu64 "  (%" PRIu64 " refused attempts)\n",
+           s_connects, s_failed_attempts);
+    printf("  skipped cycles  %12" PRIu64 "  (offline)\n", s_skipped_cycles);
+    printf("  connected       %12" PRIu32 "  of %" PRIu32 " at end\n\n", s_connected, s_cfg.devices);
+
+    printf("Rates per simulated second        avg          peak   at\n");
+    printf("  messages/s        %14.1f  %12" PRIu64 "   %" PRIu32 " s\n", msgs.avg, msgs.peak, msgs.peak_s);
+    printf("  bytes/s           %14.1f  %12" PRIu64 "   %" PRIu32 " s\n", bytes.avg, bytes.peak, bytes.peak_s);
+    printf("  connects/s        %14.2f  %12" PRIu64 "   %" PRIu32 " s\n", connects.avg, connects.peak, connects.peak_s);
+    printf("  attempts/s        %14.2f  %12" PRIu64 "   %" PRIu32 " s\n\n", attempts.avg, attempts.peak, attempts.peak_s);
+
+    printf("Per message type         count     wire bytes   avg payload\n");
+    for (int i = 0; i < MSG_TYPE_COUNT; i++) {
+        const msg_stats_t *m = &s_msgs[i];
+        printf("  %-18s %10" PRIu64 " %14" PRIu64, s_msg_names[i], m->count, m->wire_bytes);
+        if (m->payload_bytes > 0) {
+            printf(" %13.1f", (double)m->payload_bytes / (double)m->count);
+        }
+        printf("\n");
+    }
+    printf("\n");
+
+    if (s_cfg.commands_per_hour > 0.0) {
+        printf("Commands: %" PRIu64 " delivered, %" PRIu64 " lost offline, ack latency avg %.1f s max %.1f s\n",
+               s_msgs[MSG_COMMAND].count, s_commands_lost,
+               s_acks ? (double)s_ack_latency_sum_ms / s_acks / 1000.0 : 0.0,
+               (double)s_ack_latency_max_ms / 1000.0);
+    }
+    if (s_cfg.outage_len_s > 0) {
+        if (s_recovered_ms > 0) {
+            printf("Outage: %" PRIu32 " s at %" PRIu32 " s, fleet reconnected %.1f s after the broker returned\n",
+                   s_cfg.outage_len_s, s_cfg.outage_start_s,
+                   (double)s_recovered_ms / 1000.0 - (s_cfg.outage_start_s + s_cfg.outage_len_s));
+        } else {
+            printf("Outage: %" PRIu32 " s at %" PRIu32 " s, fleet not fully reconnected by the end\n",
+                   s_cfg.outage_len_s, s_cfg.outage_start_s);
+        }
+    }
+    printf("Host: %" PRIu64 " payloads encoded, %.2f us each; %.2f s wall, %.0fx real time\n",
+           s_encodes, s_encodes ? s_encode_us / s_encodes : 0.0, wall_s,
+           wall_s > 0.0 ? s_cfg.duration_s / wall_s : 0.0);
+}
+
+static void report_csv(void)
+{
+    rate_t msgs = rate_of(second_publishes);
+    rate_t bytes = rate_of(second_bytes);
+    rate_t connects = rate_of(second_connects);
+    rate_t attempts = rate_of(second_attempts);
+
+    printf("devices,duration_s,format,qos,transport,interval_ms,keepalive_s,backoff,jitter_pct,"
+           "msgs_per_s,peak_msgs_per_s,bytes_per_s,peak_bytes_per_s,peak_connects_per_s,"
+           "peak_attempts_per_s,avg_sensor_payload\n");
+    printf("%" PRIu32 ",%" PRIu32 ",%s,%d,%s,%" PRIu32 ",%" PRIu32 ",%s,%" PRIu32
+           ",%.1f,%" PRIu64 ",%.1f,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%.1f\n",
+           s_cfg.devices, s_cfg.duration_s,
+           s_cfg.binary ? "binary" : "json", s_cfg.qos,
+           s_transport_names[s_cfg.transport], s_cfg.interval_ms, s_cfg.keepalive_s,
+           s_backoff_names[s_cfg.backoff], s_cfg.jitter_pct,
+           msgs.avg, msgs.peak, bytes.avg, bytes.peak, connects.peak, attempts.peak,
+           s_msgs[MSG_SENSOR_DATA].count
+               ? (double)s_msgs[MSG_SENSOR_DATA].payload_bytes / s_msgs[MSG_SENSOR_DATA].count : 0.0);
+}
+
+/* ============================ COMMAND LINE ============================ */
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+        "Usage: %s [options]\n"
+        "  --devices N          virtual devices (default 1000)\n"
+        "  --duration S         simulated seconds (default 3600)\n"
+        "  --ramp S             boot times spread over S seconds (default 60)\n"
+        "  --format json|binary sensor_data encoding (default json)\n"
+        "  --qos 0|1            sensor_data QoS (default %d)\n"
+        "  --interval MS        sensor publish interval (default %d)\n"
+        "  --status-cycles N    periodic irrigation_status every N cycles (default %d)\n"
+        "  --keepalive S        MQTT keepalive, 0 disables pings (default %d)\n"
+        "  --soil-sensors N     soil channels per device, 1-%d (default 3)\n"
+        "  --transport tcp|ws|wss (default wss)\n"
+        "  --backoff fixed|exponential  retry delay after a refused attempt (default fixed)\n"
+        "  --jitter PCT         +/- random spread on retry delays (default 0)\n"
+        "  --drop-rate R        link drops per device per hour (default 0)\n"
+        "  --command-rate R     irrigation commands per device per hour (default 0)\n"
+        "  --outage START:LEN   broker down for LEN s from START s\n"
+        "  --seed N             random seed (default 1)\n"
+        "  --csv                one CSV header and row instead of the text report\n",
+        prog, MQTT_DEFAULT_QOS, FIRMWARE_PUBLISH_INTERVAL_MS, FIRMWARE_STATUS_CYCLES,
+        MQTT_DEFAULT_KEEPALIVE_SEC, SOIL_MAX_SENSORS);
+}
+
+static bool parse_u32(const char *text, uint32_t *out)
+{
+    char *end = NULL;
+    unsigned long value = strtoul(text, &end, 10);
+    if (end == text || *end != '\0' || value > UINT32_MAX) {
+        return false;
+    }
+    *out = (uint32_t)value;
+    return true;
+}
+
+static bool parse_rate(const char *text, double *out)
+{
+    char *end = NULL;
+    double value = strtod(text, &end);
+    if (end == text || *end != '\0' || value < 0.0) {
+        return false;
+    }
+    *out = value;
+    return true;
+}
+
+static bool parse_args(int argc, char **argv)
+{
+    static const struct option options[] = {
+        { "devices",       required_argument, NULL, 'n' },
+        { "duration",      required_argument, NULL, 'd' },
+        { "ramp",          required_argument, NULL, 'r' },
+        { "format",        required_argument, NULL, 'f' },
+        { "qos",           required_argument, NULL, 'q' },
+        { "interval",      required_argument, NULL, 'i' },
+        { "status-cycles", required_argument, NULL, 'c' },
+        { "keepalive",     required_argument, NULL, 'k' },
+        { "soil-sensors",  required_argument, NULL, 's' },
+        { "transport",     required_argument, NULL, 't' },
+        { "backoff",       required_argument, NULL, 'b' },
+        { "jitter",        required_argument, NULL, 'j' },
+        { "drop-rate",     required_argument, NULL, 'D' },
+        { "command-rate",  required_argument, NULL, 'C' },
+        { "outage",        required_argument, NULL, 'o' },
+        { "seed",          required_argument, NULL, 'S' },
+        { "csv",           no_argument,       NULL, 'v' },
+        { "help",          no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+
+    uint32_t value = 0;
+    int index = 0;
+    int opt;
+    while ((opt = getopt_long(argc, argv, "", options, &index)) != -1) {
+        bool ok = true;
+        switch (opt) {
+            case 'n': ok = parse_u32(optarg, &s_cfg.devices) && s_cfg.devices > 0; break;
+            case 'd': ok = parse_u32(optarg, &s_cfg.duration_s) && s_cfg.duration_s > 0; break;
+            case 'r': ok = parse_u32(optarg, &s_cfg.ramp_s); break;
+            case 'q': ok = parse_u32(optarg, &value) && value <= MQTT_QOS_1; s_cfg.qos = (int)value; break;
+            case 'i': ok = parse_u32(optarg, &s_cfg.interval_ms) && s_cfg.interval_ms > 0; break;
+            case 'c': ok = parse_u32(optarg, &s_cfg.status_cycles) && s_cfg.status_cycles > 0; break;
+            case 'k': ok = parse_u32(optarg, &s_cfg.keepalive_s); break;
+            case 'j': ok = parse_u32(optarg, &s_cfg.jitter_pct) && s_cfg.jitter_pct <= 100; break;
+            case 'D': ok = parse_rate(optarg, &s_cfg.drops_per_hour); break;
+            case 'C': ok = parse_rate(optarg, &s_cfg.commands_per_hour); break;
+            case 'S': s_cfg.seed = strtoull(optarg, NULL, 10); break;
+            case 'v': s_cfg.csv = true; break;
+            case 's':
+                ok = parse_u32(optarg, &value) && value >= 1 && value <= SOIL_MAX_SENSORS;
+                s_cfg.soil_sensors = (uint8_t)value;
+                break;
+            case 'f':
+                if (strcmp(optarg, "json") == 0) {
+                    s_cfg.binary = false;
+                } else if (strcmp(optarg, "binary") == 0) {
+                    s_cfg.binary = true;
+                } else {
+                    ok = false;
+                }
+                break;
+            case 't':
+                ok = false;
+                for (int t = TRANSPORT_TCP; t <= TRANSPORT_WSS; t++) {
+                    if (strcmp(optarg, s_transport_names[t]) == 0) {
+                        s_cfg.transport = (transport_t)t;
+                        ok = true;
+                    }
+                }
+                break;
+            case 'b':
+                ok = false;
+                for (int b = BACKOFF_FIXED; b <= BACKOFF_EXPONENTIAL; b++) {
+                    if (strcmp(optarg, s_backoff_names[b]) == 0) {
+                        s_cfg.backoff = (backoff_t)b;
+                        ok = true;
+                    }
+                }
+                break;
+            case 'o':
+                ok = sscanf(optarg, "%" SCNu32 ":%" SCNu32,
+                            &s_cfg.outage_start_s, &s_cfg.outage_len_s) == 2;
+                break;
+            default:
+                return false;
+        }
+        if (!ok) {
+            fprintf(stderr, "fleet_loadgen: invalid value for --%s: %s\n",
+                    options[index].name, optarg);
+            return false;
+        }
+    }
+    return optind == argc;
+}
+
+int main(int argc, char **argv)
+{
+    if (!parse_args(argc, argv)) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    s_rng_state = s_cfg.seed ? s_cfg.seed : 1;
+    s_devices = calloc(s_cfg.devices, sizeof(vdevice_t));
+    s_seconds = calloc(s_cfg.duration_s, sizeof(second_stats_t));
+    if (s_devices == NULL || s_seconds == NULL) {
+        fprintf(stderr, "fleet_loadgen: out of memory for %" PRIu32 " devices\n", s_cfg.devices);
+        return EXIT_FAILURE;
+    }
+
+    double start = host_us();
+    simulate();
+    double wall_s = (host_us() - start) / US_PER_S;
+
+    if (s_cfg.csv) {
+        report_csv();
+    } else {
+        report_text(wall_s);
+    }
+
+    free(s_queue.items);
+    free(s_seconds);
+    free(s_devices);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file host_test.h
+ * @brief Minimal check macros for the host test programs
+ *
+ * Each test is a plain executable: CHECK() records a failure with its
+ * location and keeps going, HOST_TEST_RESULT() prints the summary and is
+ * the exit code seen by ctest.
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdio.h>
+#include <math.h>
+
+static int s_host_test_checks = 0;
+static int s_host_test_failures = 0;
+
+#define CHECK(cond) do {                                                        \
+        s_host_test_checks++;                                                   \
+        if (!(cond)) {                                                          \
+            s_host_test_failures++;                                             \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+        }                                                                       \
+    } while (0)
+
+#define CHECK_EQ_INT(actual, expected) do {                                     \
+        long long _a = (long long)(actual);                                     \
+        long long _e = (long long)(expected);                                   \
+        s_host_test_checks++;                                                   \
+        if (_a != _e) {                                                         \
+            s_host_test_failures++;                                             \
+            fprintf(stderr, "%s:%d: %s == %lld, expected %lld\n",               \
+                    __FILE__, __LINE__, #actual, _a, _e);                       \
+        }                                                                       \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance) do {                            \
+        double _a = (double)(actual);                                           \
+        double _e = (double)(expected);                                         \
+        s_host_test_checks++;                                                   \
+        if (!(fabs(_a - _e) <= (double)(tolerance))) {                          \
+            s_host_test_failures++;                                             \
+            fprintf(stderr, "%s:%d: %s == %g, expected %g +/- %g\n",            \
+                    __FILE__, __LINE__, #actual, _a, _e, (double)(tolerance));  \
+        }                                                                       \
+    } while (0)
+
+#define HOST_TEST_RESULT(name)                                                  \
+    (printf("%s: %d checks, %d failed\n", (name), s_host_test_checks,           \
+            s_host_test_failures), s_host_test_failures == 0 ? 0 : 1)
+
+#endif // HOST_TEST_H
@@ -0,0 +1,31 @@
+/**
+ * @file cJSON.h
+ * @brief Host shim: the cJSON calls used by the modules under test
+ *
+ * cJSON is opaque here; the test implements the calls with a small tree
+ * it can inspect.
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef HOST_SHIM_CJSON_H
+#define HOST_SHIM_CJSON_H
+
+typedef int cJSON_bool;
+typedef struct cJSON cJSON;
+
+cJSON *cJSON_CreateObject(void);
+cJSON *cJSON_CreateNull(void);
+cJSON *cJSON_CreateNumber(double num);
+cJSON *cJSON_AddNullToObject(cJSON *const object, const char *const name);
+cJSON *cJSON_AddBoolToObject(cJSON *const object, const char *const name, const cJSON_bool boolean);
+cJSON *cJSON_AddNumberToObject(cJSON *const object, const char *const name, const double number);
+cJSON *cJSON_AddStringToObject(cJSON *const object, const char *const name, const char *const string);
+cJSON *cJSON_AddArrayToObject(cJSON *const object, const char *const name);
+cJSON_bool cJSON_AddItemToArray(cJSON *array, cJSON *item);
+cJSON_bool cJSON_PrintPreallocated(cJSON *item, char *buffer, const int length, const cJSON_bool format);
+void cJSON_Delete(cJSON *item);
+
+#endif // HOST_SHIM_CJSON_H
@@ -0,0 +1,29 @@
+/**
+ * @file i2c_master.h
+ * @brief Host shim: i2c_master device transfers, implemented by the test
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef HOST_SHIM_I2C_MASTER_H
+#define HOST_SHIM_I2C_MASTER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+typedef struct i2c_master_dev_t *i2c_master_dev_handle_t;
+
+esp_err_t i2c_master_transmit(i2c_master_dev_handle_t i2c_dev, const uint8_t *write_buffer,
+                              size_t write_size, int xfer_timeout_ms);
+
+esp_err_t i2c_master_receive(i2c_master_dev_handle_t i2c_dev, uint8_t *read_buffer,
+                             size_t read_size, int xfer_timeout_ms);
+
+esp_err_t i2c_master_transmit_receive(i2c_master_dev_handle_t i2c_dev, const uint8_t *write_buffer,
+                                      size_t write_size, uint8_t *read_buffer, size_t read_size,
+                                      int xfer_timeout_ms);
+
+#endif // HOST_SHIM_I2C_MASTER_H
@@ -0,0 +1,19 @@
+/**
+ * @file adc_oneshot.h
+ * @brief Host shim: ADC types referenced by sensor_reader.h
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef HOST_SHIM_ADC_ONESHOT_H
+#define HOST_SHIM_ADC_ONESHOT_H
+
+#include "esp_err.h"
+
+typedef int adc_channel_t;
+typedef int adc_atten_t;
+typedef int adc_unit_t;
+
+#endif // HOST_SHIM_ADC_ONESHOT_H
@@ -0,0 +1,41 @@
+/**
+ * @file esp_err.h
+ * @brief Host shim: ESP-IDF error codes used by the modules under test
+ *
+ * The shim directory lets a firmware driver compile unchanged on Linux;
+ * each test provides fakes for the functions it calls.
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef HOST_SHIM_ESP_ERR_H
+#define HOST_SHIM_ESP_ERR_H
+
+// Same standard headers as the ESP-IDF esp_err.h, which modules rely on
+#include <stdint.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+typedef int esp_err_t;
+
+#define ESP_OK                      0
+#define ESP_FAIL                    -1
+#define ESP_ERR_NO_MEM              0x101
+#define ESP_ERR_INVALID_ARG         0x102
+#define ESP_ERR_INVALID_STATE       0x103
+#define ESP_ERR_INVALID_SIZE        0x104
+#define ESP_ERR_NOT_FOUND           0x105
+#define ESP_ERR_NOT_SUPPORTED       0x106
+#define ESP_ERR_TIMEOUT             0x107
+#define ESP_ERR_INVALID_RESPONSE    0x108
+#define ESP_ERR_INVALID_CRC         0x109
+
+static inline const char *esp_err_to_name(esp_err_t err)
+{
+    (void)err;
+    return "esp_err";
+}
+
+#endif // HOST_SHIM_ESP_ERR_H
@@ -0,0 +1,28 @@
+/**
+ * @file esp_log.h
+ * @brief Host shim: ESP_LOGx compiled to nothing, format strings still checked
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef HOST_SHIM_ESP_LOG_H
+#define HOST_SHIM_ESP_LOG_H
+
+#include "esp_err.h"
+
+__attribute__((format(printf, 2, 3)))
+static inline void host_log(const char *tag, const char *format, ...)
+{
+    (void)tag;
+    (void)format;
+}
+
+#define ESP_LOGE(tag, format, ...)  host_log(tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...)  host_log(tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...)  host_log(tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...)  host_log(tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...)  host_log(tag, format, ##__VA_ARGS__)
+
+#endif // HOST_SHIM_ESP_LOG_H
@@ -0,0 +1,17 @@
+/**
+ * @file esp_rom_crc.h
+ * @brief Host shim: ROM CRC32, implemented by the test
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef HOST_SHIM_ESP_ROM_CRC_H
+#define HOST_SHIM_ESP_ROM_CRC_H
+
+#include <stdint.h>
+
+uint32_t esp_rom_crc32_le(uint32_t crc, uint8_t const *buf, uint32_t len);
+
+#endif // HOST_SHIM_ESP_ROM_CRC_H
@@ -0,0 +1,17 @@
+/**
+ * @file esp_timer.h
+ * @brief Host shim: monotonic time, implemented by the test (virtual clock)
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef HOST_SHIM_ESP_TIMER_H
+#define HOST_SHIM_ESP_TIMER_H
+
+#include <stdint.h>
+
+int64_t esp_timer_get_time(void);
+
+#endif // HOST_SHIM_ESP_TIMER_H
@@ -0,0 +1,22 @@
+/**
+ * @file semphr.h
+ * @brief Host shim: mutex calls, implemented by the test
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef HOST_SHIM_SEMPHR_H
+#define HOST_SHIM_SEMPHR_H
+
+#include "FreeRTOS.h"
+
+typedef struct QueueDefinition *SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t xSemaphore, TickType_t xBlockTime);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t xSemaphore);
+void vSemaphoreDelete(SemaphoreHandle_t xSemaphore);
+
+#endif // HOST_SHIM_SEMPHR_H
@@ -0,0 +1,13 @@
+/**
+ * @file sdkconfig.h
+ * @brief Host shim: no Kconfig values, modules fall back to their defaults
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#ifndef HOST_SHIM_SDKCONFIG_H
+#define HOST_SHIM_SDKCONFIG_H
+
+#endif // HOST_SHIM_SDKCONFIG_H
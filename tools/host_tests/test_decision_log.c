@@ -0,0 +1,825 @@
+/**
+ * @file test_decision_log.c
+ * @brief Flash ring, recovery and time-range queries of decision_log.c
+ *
+ * decision_log.c is compiled unchanged against the shim headers. The
+ * partition is an 8-segment NOR flash fake in shared memory: writes can
+ * only clear bits, erase sets a whole sector to 0xFF, and a write can be
+ * cut short to simulate a power loss. decision_log_init() only runs once
+ * per process, so every boot is a fork() that sees the flash left by the
+ * previous one.
+ *
+ * Every range query is paged to the end and compared with a brute-force
+ * filter of the full log, so the index skips are checked against records
+ * they must not hide (clock steps back, unsynced timestamps).
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "decision_log.h"
+#include "time_sync.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "host_test.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+/* ============================ FAKE FLASH ============================ */
+
+// Flash format of decision_log.c
+#define SEGMENT_SIZE            4096
+#define HEADER_SIZE             64
+#define RECORD_SIZE             48
+#define SEGMENT_RECORDS         ((SEGMENT_SIZE - HEADER_SIZE) / RECORD_SIZE)
+
+#define SEGMENTS                8
+#define PARTITION_SIZE          (SEGMENTS * SEGMENT_SIZE)
+#define MAX_IDS                 4096
+#define CRASH_EXIT              75
+
+/**
+ * @brief State that survives a reboot: the flash and the test's own records
+ */
+typedef struct {
+    uint8_t flash[PARTITION_SIZE];
+    uint32_t ts_by_id[MAX_IDS];         // Timestamp given to each appended record
+    uint32_t clock;                     // Wall clock, kept by the RTC across reboots
+    uint16_t next_id;
+    size_t kept;                        // Records on flash at the start of a boot
+    int checks;                         // CHECK count of the last boot
+} shared_t;
+
+static shared_t *s_shared;
+
+static esp_partition_t s_partition = {
+    .type = ESP_PARTITION_TYPE_DATA,
+    .subtype = 0x40,
+    .size = PARTITION_SIZE,
+    .erase_size = SEGMENT_SIZE,
+    .label = "irrlog",
+};
+static bool s_partition_present = true;
+
+static uint64_t s_read_bytes;
+static int s_nor_violations;            // Writes that needed a 0 -> 1 transition
+static int s_crash_countdown;           // Power loss on this write (0 = never)
+static size_t s_crash_bytes;            // Bytes of that write that reach the flash
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type,
+                                                esp_partition_subtype_t subtype, const char *label)
+{
+    (void)subtype;
+    if (!s_partition_present || type != ESP_PARTITION_TYPE_DATA || strcmp(label, s_partition.label) != 0) {
+        return NULL;
+    }
+    return &s_partition;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *partition, size_t src_offset, void *dst, size_t size)
+{
+    if (partition != &s_partition || src_offset + size > PARTITION_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(dst, &s_shared->flash[src_offset], size);
+    s_read_bytes += size;
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t *partition, size_t dst_offset, const void *src, size_t size)
+{
+    CHECK(partition == &s_partition);
+    if (dst_offset + size > PARTITION_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    size_t n = size;
+    bool crash = s_crash_countdown > 0 && --s_crash_countdown == 0;
+    if (crash && s_crash_bytes < n) {
+        n = s_crash_bytes;
+    }
+
+    const uint8_t *bytes = src;
+    for (size_t i = 0; i < n; i++) {
+        uint8_t *cell = &s_shared->flash[dst_offset + i];
+        if ((*cell & bytes[i]) != bytes[i]) {
+            s_nor_violations++;
+        }
+        *cell &= bytes[i];
+    }
+
+    if (crash) {
+        fflush(NULL);
+        s_shared->checks = s_host_test_checks;
+        _exit(s_host_test_failures ? 1 : CRASH_EXIT);
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *partition, size_t offset, size_t size)
+{
+    CHECK(partition == &s_partition);
+    CHECK(offset % SEGMENT_SIZE == 0 && size % SEGMENT_SIZE == 0);
+    if (offset + size > PARTITION_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memset(&s_shared->flash[offset], 0xFF, size);
+    return ESP_OK;
+}
+
+uint32_t esp_rom_crc32_le(uint32_t crc, uint8_t const *buf, uint32_t len)
+{
+    crc = ~crc;
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= buf[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+/* ============================ FAKE CLOCK AND RTOS ============================ */
+
+static time_quality_t s_quality = TIME_QUALITY_SNTP;
+static int64_t s_uptime_us;
+
+static int s_mutex;
+static bool s_mutex_held;
+static int s_notifies;
+
+uint32_t time_sync_get_timestamp(time_quality_t *quality)
+{
+    if (quality != NULL) {
+        *quality = s_quality;
+    }
+    return s_shared->clock;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return s_uptime_us;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return (SemaphoreHandle_t)&s_mutex;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t xSemaphore, TickType_t xBlockTime)
+{
+    (void)xBlockTime;
+    CHECK(xSemaphore == (SemaphoreHandle_t)&s_mutex);
+    CHECK(!s_mutex_held);
+    s_mutex_held = true;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t xSemaphore)
+{
+    CHECK(xSemaphore == (SemaphoreHandle_t)&s_mutex);
+    CHECK(s_mutex_held);
+    s_mutex_held = false;
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t xSemaphore)
+{
+    (void)xSemaphore;
+}
+
+// The writer task is never run: records reach flash on decision_log_flush()
+BaseType_t xTaskCreate(TaskFunction_t pxTaskCode, const char *const pcName,
+                       const uint32_t usStackDepth, void *const pvParameters,
+                       UBaseType_t uxPriority, TaskHandle_t *const pxCreatedTask)
+{
+    (void)pxTaskCode; (void)pcName; (void)usStackDepth; (void)pvParameters; (void)uxPriority;
+    *pxCreatedTask = (TaskHandle_t)&s_notifies;
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait)
+{
+    (void)xClearCountOnExit; (void)xTicksToWait;
+    return 0;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t xTaskToNotify)
+{
+    CHECK(xTaskToNotify == (TaskHandle_t)&s_notifies);
+    s_notifies++;
+    return pdPASS;
+}
+
+void vTaskDelay(const TickType_t xTicksToDelay)
+{
+    (void)xTicksToDelay;
+}
+
+/* ============================ FAKE cJSON ============================ */
+
+enum { JSON_NULL, JSON_FALSE, JSON_TRUE, JSON_NUMBER, JSON_STRING, JSON_OBJECT, JSON_ARRAY };
+
+struct cJSON {
+    struct cJSON *next;
+    struct cJSON *child;
+    int type;
+    char name[24];
+    double number;
+    char string[32];
+};
+
+static int s_json_live;                 // Items not deleted yet
+
+static cJSON *json_new(int type)
+{
+    cJSON *item = calloc(1, sizeof(cJSON));
+    if (item != NULL) {
+        item->type = type;
+        s_json_live++;
+    }
+    return item;
+}
+
+static cJSON *json_add(cJSON *parent, const char *name, cJSON *item)
+{
+    if (parent == NULL || item == NULL) {
+        return NULL;
+    }
+    if (name != NULL) {
+        snprintf(item->name, sizeof(item->name), "%s", name);
+    }
+    cJSON **tail = &parent->child;
+    while (*tail != NULL) {
+        tail = &(*tail)->next;
+    }
+    *tail = item;
+    return item;
+}
+
+static const cJSON *json_get(const cJSON *object, const char *name)
+{
+    for (const cJSON *item = object->child; item != NULL; item = item->next) {
+        if (strcmp(item->name, name) == 0) {
+            return item;
+        }
+    }
+    return NULL;
+}
+
+cJSON *cJSON_CreateObject(void) { return json_new(JSON_OBJECT); }
+cJSON *cJSON_CreateNull(void) { return json_new(JSON_NULL); }
+
+cJSON *cJSON_CreateNumber(double num)
+{
+    cJSON *item = json_new(JSON_NUMBER);
+    if (item != NULL) {
+        item->number = num;
+    }
+    return item;
+}
+
+cJSON *cJSON_AddNullToObject(cJSON *const object, const char *const name)
+{
+    return json_add(object, name, json_new(JSON_NULL));
+}
+
+cJSON *cJSON_AddBoolToObject(cJSON *const object, const char *const name, const cJSON_bool boolean)
+{
+    return json_add(object, name, json_new(boolean ? JSON_TRUE : JSON_FALSE));
+}
+
+cJSON *cJSON_AddNumberToObject(cJSON *const object, const char *const name, const double number)
+{
+    return json_add(object, name, cJSON_CreateNumber(number));
+}
+
+cJSON *cJSON_AddStringToObject(cJSON *const object, const char *const name, const char *const string)
+{
+    cJSON *item = json_new(JSON_STRING);
+    if (item != NULL) {
+        snprintf(item->string, sizeof(item->string), "%s", string);
+    }
+    return json_add(object, name, item);
+}
+
+cJSON *cJSON_AddArrayToObject(cJSON *const object, const char *const name)
+{
+    return json_add(object, name, json_new(JSON_ARRAY));
+}
+
+cJSON_bool cJSON_AddItemToArray(cJSON *array, cJSON *item)
+{
+    return json_add(array, NULL, item) != NULL;
+}
+
+void cJSON_Delete(cJSON *item)
+{
+    while (item != NULL) {
+        cJSON *next = item->next;
+        cJSON_Delete(item->child);
+        free(item);
+        s_json_live--;
+        item = next;
+    }
+}
+
+/* ============================ BOOTS ============================ */
+
+static void flash_erase_all(void)
+{
+    memset(s_shared->flash, 0xFF, sizeof(s_shared->flash));
+    s_shared->clock = 1760000000;
+    s_shared->next_id = 0;
+}
+
+/**
+ * @brief Run @p fn as one boot of the device in a child process
+ * @return Child exit status: 0 passed, 1 a check failed, CRASH_EXIT power lost
+ */
+static int boot(void (*fn)(void))
+{
+    fflush(NULL);
+    s_shared->checks = 0;
+    pid_t pid = fork();
+    if (pid == 0) {
+        s_host_test_checks = 0;
+        s_host_test_failures = 0;
+        fn();
+        fflush(NULL);
+        s_shared->checks = s_host_test_checks;
+        _exit(s_host_test_failures ? 1 : 0);
+    }
+
+    int status = 0;
+    CHECK(pid > 0 && waitpid(pid, &status, 0) == pid);
+    s_host_test_checks += s_shared->checks;
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+static void init_ok(void)
+{
+    CHECK_EQ_INT(decision_log_init(), ESP_OK);
+}
+
+/**
+ * @brief Append one record and advance the clock by @p step_s
+ */
+static void log_one(uint32_t step_s)
+{
+    uint16_t id = s_shared->next_id++;
+    decision_log_record_t record = {
+        .event = (uint8_t)(id % DECISION_EVENT_COUNT),
+        .reason = (uint8_t)(id % DECISION_REASON_COUNT),
+        .level = DECISION_LOG_LEVEL_NONE,
+        .valve = (uint8_t)(1 + id % 3),
+        .value = id,
+        .temperature_x10 = 215,
+        .humidity_x10 = 780,
+        .soil_count = 2,
+        .soil = { decision_log_soil_encode(40.0f + (float)(id % 20)), DECISION_LOG_SOIL_NONE },
+    };
+    s_shared->ts_by_id[id] = (s_quality != TIME_QUALITY_UNSYNCED) ? s_shared->clock : 0;
+    decision_log_append(&record);
+    s_shared->clock += step_s;
+    s_uptime_us += (int64_t)step_s * 1000000;
+}
+
+static void log_flushed(int count, uint32_t step_s)
+{
+    for (int i = 0; i < count; i++) {
+        log_one(step_s);
+        decision_log_flush();
+    }
+}
+
+/**
+ * @brief Page through every record matching [from, to]
+ * @return Records matching, in write order
+ */
+static size_t query_all(uint32_t from, uint32_t to, decision_log_record_t *out, size_t max_out)
+{
+    decision_log_record_t page[DECISION_LOG_QUERY_MAX];
+    decision_log_filter_t filter = { .from = from, .to = to, .after_seq = 0 };
+    size_t total = 0;
+    size_t count;
+
+    do {
+        CHECK_EQ_INT(decision_log_query(&filter, page, DECISION_LOG_QUERY_MAX, &count), ESP_OK);
+        for (size_t i = 0; i < count && total < max_out; i++) {
+            CHECK(page[i].seq > filter.after_seq);
+            out[total++] = page[i];
+            filter.after_seq = page[i].seq;
+        }
+    } while (count == DECISION_LOG_QUERY_MAX);
+    CHECK(!s_mutex_held);
+    return total;
+}
+
+/**
+ * @brief The whole log: seq contiguous from @p first_seq, every field as appended
+ */
+static size_t check_log(decision_log_record_t *all, size_t max_all, uint32_t first_seq, size_t expected)
+{
+    size_t n = query_all(0, 0, all, max_all);
+    CHECK_EQ_INT(n, expected);
+    for (size_t i = 0; i < n; i++) {
+        const decision_log_record_t *r = &all[i];
+        CHECK_EQ_INT(r->seq, first_seq + i);
+        CHECK_EQ_INT(r->timestamp, s_shared->ts_by_id[r->value]);
+        CHECK_EQ_INT((r->flags & DECISION_LOG_FLAG_TIME_SYNCED) != 0, r->timestamp != 0);
+        CHECK_EQ_INT(r->event, r->value % DECISION_EVENT_COUNT);
+        CHECK_EQ_INT(r->reason, r->value % DECISION_REASON_COUNT);
+        CHECK_EQ_INT(r->soil[0], decision_log_soil_encode(40.0f + (float)(r->value % 20)));
+    }
+    CHECK_EQ_INT(s_nor_violations, 0);
+    return n;
+}
+
+static bool filter_match(const decision_log_record_t *r, uint32_t from, uint32_t to)
+{
+    if (r->timestamp == 0) {
+        return from == 0;
+    }
+    return r->timestamp >= from && (to == 0 || r->timestamp <= to);
+}
+
+static uint32_t lcg_next(uint32_t *lcg)
+{
+    *lcg = *lcg * 1103515245u + 12345u;
+    return *lcg >> 8;
+}
+
+/**
+ * @brief Random ranges around the logged timestamps against a brute-force filter
+ */
+static void check_ranges(const decision_log_record_t *all, size_t n, int queries, uint32_t seed)
+{
+    static decision_log_record_t got[SEGMENTS * SEGMENT_RECORDS];
+    uint32_t lcg = seed;
+
+    for (int q = 0; q < queries; q++) {
+        uint32_t from = all[lcg_next(&lcg) % n].timestamp;
+        if (q % 3 != 0) {
+            from += lcg_next(&lcg) % 21 - 10;       // Otherwise exactly a logged time
+        }
+        uint32_t to = from + lcg_next(&lcg) % 3000;
+        if (q % 5 == 0) {
+            to = 0;                     // Open-ended
+        }
+        if (q % 7 == 0) {
+            from = 0;                   // From the beginning, unsynced included
+        }
+
+        size_t got_n = query_all(from, to, got, n);
+        size_t expected_n = 0;
+        bool same = true;
+        for (size_t i = 0; i < n; i++) {
+            if (filter_match(&all[i], from, to)) {
+                same = same && expected_n < got_n && got[expected_n].seq == all[i].seq;
+                expected_n++;
+            }
+        }
+        CHECK_EQ_INT(got_n, expected_n);
+        CHECK(same);
+    }
+}
+
+static decision_log_record_t s_all[SEGMENTS * SEGMENT_RECORDS];
+
+/* ============================ SCENARIOS ============================ */
+
+// 1000 records into a ring of 8 x 84: segments 4..11 of the fill remain
+#define WRAP_RECORDS            1000
+#define WRAP_OLDEST_SEQ         (4 * SEGMENT_RECORDS + 1)
+#define WRAP_KEPT               (WRAP_RECORDS - WRAP_OLDEST_SEQ + 1)
+
+static void boot_wrap_fill(void)
+{
+    init_ok();
+    log_flushed(WRAP_RECORDS, 10);
+
+    size_t n = check_log(s_all, WRAP_KEPT + 1, WRAP_OLDEST_SEQ, WRAP_KEPT);
+    check_ranges(s_all, n, 300, 1);
+
+    // Last 10 records by time (index skips) and by seq (reads the whole ring)
+    decision_log_record_t page[DECISION_LOG_QUERY_MAX];
+    size_t count;
+    decision_log_filter_t by_time = { .from = s_all[n - 10].timestamp };
+    decision_log_filter_t by_seq = { .after_seq = s_all[n - 11].seq };
+
+    s_read_bytes = 0;
+    CHECK_EQ_INT(decision_log_query(&by_time, page, DECISION_LOG_QUERY_MAX, &count), ESP_OK);
+    CHECK_EQ_INT(count, 10);
+    CHECK_EQ_INT(page[0].seq, WRAP_RECORDS - 9);
+    uint64_t indexed_bytes = s_read_bytes;
+
+    s_read_bytes = 0;
+    CHECK_EQ_INT(decision_log_query(&by_seq, page, DECISION_LOG_QUERY_MAX, &count), ESP_OK);
+    CHECK_EQ_INT(count, 10);
+    uint64_t scan_bytes = s_read_bytes;
+
+    printf("decision_log: last 10 records read %llu bytes by time, %llu by seq\n",
+           (unsigned long long)indexed_bytes, (unsigned long long)scan_bytes);
+    CHECK(indexed_bytes * 8 < scan_bytes);
+    // Headers plus the two index blocks holding slots 66..75 of the head
+    CHECK(indexed_bytes <= SEGMENTS * HEADER_SIZE + 2 * 8 * RECORD_SIZE);
+}
+
+static void boot_wrap_reopen(void)
+{
+    init_ok();
+    size_t n = check_log(s_all, WRAP_KEPT + 1, WRAP_OLDEST_SEQ, WRAP_KEPT);
+    check_ranges(s_all, n, 100, 2);
+
+    log_flushed(1, 10);
+    check_log(s_all, WRAP_KEPT + 2, WRAP_OLDEST_SEQ, WRAP_KEPT + 1);
+    CHECK_EQ_INT(s_all[WRAP_KEPT].seq, WRAP_RECORDS + 1);
+}
+
+static void test_wrap_and_reopen(void)
+{
+    flash_erase_all();
+    CHECK_EQ_INT(boot(boot_wrap_fill), 0);
+    CHECK_EQ_INT(boot(boot_wrap_reopen), 0);
+}
+
+// Clock steps back an hour mid-log, then a stretch without sync
+static void boot_clock_fill(void)
+{
+    init_ok();
+    log_flushed(80, 10);
+    log_flushed(12, 0);                 // One second across the segment 0 -> 1 boundary
+    log_flushed(108, 10);
+    s_shared->clock -= 3600;
+    log_flushed(150, 10);
+    s_quality = TIME_QUALITY_UNSYNCED;
+    log_flushed(20, 10);
+    s_quality = TIME_QUALITY_RTC;
+    log_flushed(100, 10);
+
+    size_t n = check_log(s_all, 470 + 1, 1, 470);
+    check_ranges(s_all, n, 300, 3);
+
+    decision_log_record_t got[470];
+    uint32_t burst = s_shared->ts_by_id[80];
+    int burst_records = 0;
+    for (int id = 0; id < 470; id++) {
+        burst_records += (s_shared->ts_by_id[id] == burst);
+    }
+    CHECK(burst_records >= 13);
+    CHECK_EQ_INT(query_all(burst, burst, got, 470), burst_records);
+    CHECK_EQ_INT(got[0].value, 80);
+
+    // The stepped-back hour lies below the high water of older segments
+    uint32_t back_from = s_shared->ts_by_id[200];
+    uint32_t back_to = s_shared->ts_by_id[349];
+    size_t got_n = query_all(back_from, back_to, got, 470);
+    CHECK(got_n >= 150);
+    bool has_back = false;
+    for (size_t i = 0; i < got_n; i++) {
+        has_back = has_back || got[i].value == 200;
+    }
+    CHECK(has_back);
+
+    // Unsynced records only come back from the beginning
+    got_n = query_all(1, 0, got, 470);
+    CHECK_EQ_INT(got_n, 450);
+}
+
+static void boot_clock_reopen(void)
+{
+    init_ok();
+    log_flushed(50, 10);
+    size_t n = check_log(s_all, 520 + 1, 1, 520);
+    check_ranges(s_all, n, 200, 4);
+}
+
+static void test_clock_steps(void)
+{
+    flash_erase_all();
+    CHECK_EQ_INT(boot(boot_clock_fill), 0);
+    CHECK_EQ_INT(boot(boot_clock_reopen), 0);
+}
+
+// Power loss halfway through a record: the slot stays used, seq is reused
+static void boot_torn_record(void)
+{
+    init_ok();
+    log_flushed(100, 10);
+    s_crash_countdown = 1;
+    s_crash_bytes = RECORD_SIZE / 2;
+    log_flushed(1, 10);
+    CHECK(false);                       // Not reached
+}
+
+static void boot_after_torn_record(void)
+{
+    init_ok();
+    check_log(s_all, 101, 1, 100);
+    log_flushed(1, 10);
+    check_log(s_all, 102, 1, 101);
+}
+
+// Segment 0 full; power lost after erasing segment 1, before its header
+static void boot_torn_header(void)
+{
+    init_ok();
+    log_flushed(SEGMENT_RECORDS, 10);
+    s_crash_countdown = 1;
+    s_crash_bytes = 0;
+    log_flushed(1, 10);
+    CHECK(false);
+}
+
+// Segments 0 and 1 full; power lost after segment 2's header
+static void boot_fresh_segment(void)
+{
+    init_ok();
+    log_flushed(2 * SEGMENT_RECORDS, 10);
+    s_crash_countdown = 2;
+    s_crash_bytes = 0;
+    log_flushed(1, 10);
+    CHECK(false);
+}
+
+static void boot_after_segment_crash(void)
+{
+    init_ok();
+    size_t n = check_log(s_all, 3 * SEGMENT_RECORDS, 1, s_shared->kept);
+    log_flushed(1, 10);
+    check_log(s_all, 3 * SEGMENT_RECORDS + 1, 1, n + 1);
+
+    // Newest timestamp recovered: the index still finds the tail
+    decision_log_record_t got[16];
+    CHECK_EQ_INT(query_all(s_all[n - 5].timestamp, 0, got, 16), 6);
+}
+
+// Head exactly full at reboot: the next record starts a segment
+static void boot_fill_segments(void)
+{
+    init_ok();
+    log_flushed(3 * SEGMENT_RECORDS, 10);
+}
+
+static void test_power_loss(void)
+{
+    flash_erase_all();
+    CHECK_EQ_INT(boot(boot_torn_record), CRASH_EXIT);
+    CHECK_EQ_INT(boot(boot_after_torn_record), 0);
+    // Torn slot 100 kept its place, seq 101 went to slot 101
+    decision_log_record_t slot;
+    memcpy(&slot, &s_shared->flash[SEGMENT_SIZE + HEADER_SIZE + (101 - SEGMENT_RECORDS) * RECORD_SIZE], sizeof(slot));
+    CHECK_EQ_INT(slot.seq, 101);
+
+    flash_erase_all();
+    CHECK_EQ_INT(boot(boot_torn_header), CRASH_EXIT);
+    s_shared->kept = SEGMENT_RECORDS;
+    CHECK_EQ_INT(boot(boot_after_segment_crash), 0);
+
+    flash_erase_all();
+    CHECK_EQ_INT(boot(boot_fresh_segment), CRASH_EXIT);
+    s_shared->kept = 2 * SEGMENT_RECORDS;
+    CHECK_EQ_INT(boot(boot_after_segment_crash), 0);
+
+    flash_erase_all();
+    CHECK_EQ_INT(boot(boot_fill_segments), 0);
+    s_shared->kept = 3 * SEGMENT_RECORDS;
+    CHECK_EQ_INT(boot(boot_after_segment_crash), 0);
+}
+
+// Writer task starved: the queue holds CONFIG_DECISION_LOG_QUEUE_RECORDS
+static void boot_queue_full(void)
+{
+    log_one(1);                         // Before init: ignored
+    s_shared->next_id = 0;
+    CHECK_EQ_INT(s_notifies, 0);
+
+    init_ok();
+    init_ok();                          // Second init is a no-op
+    for (int i = 0; i < 20; i++) {
+        log_one(1);
+    }
+    CHECK_EQ_INT(decision_log_get_dropped(), 4);
+    CHECK_EQ_INT(s_notifies, 16);
+
+    // The query flushes the queue first
+    check_log(s_all, 32, 1, 16);
+    CHECK_EQ_INT(decision_log_get_dropped(), 4);
+}
+
+static void test_queue_full(void)
+{
+    flash_erase_all();
+    CHECK_EQ_INT(boot(boot_queue_full), 0);
+}
+
+static void test_unavailable(void)
+{
+    decision_log_record_t page[1];
+    decision_log_filter_t filter = { 0 };
+    size_t count = 99;
+
+    // Runs in this process: init fails before any state is kept
+    CHECK_EQ_INT(decision_log_query(&filter, page, 1, &count), ESP_ERR_INVALID_STATE);
+    CHECK_EQ_INT(count, 0);
+    CHECK_EQ_INT(decision_log_query(NULL, page, 1, &count), ESP_ERR_INVALID_ARG);
+    CHECK_EQ_INT(decision_log_query(&filter, page, 0, &count), ESP_ERR_INVALID_ARG);
+    decision_log_flush();
+
+    s_partition_present = false;
+    CHECK_EQ_INT(decision_log_init(), ESP_ERR_NOT_FOUND);
+    s_partition_present = true;
+    s_partition.size = SEGMENT_SIZE;            // Too small for a ring
+    CHECK_EQ_INT(decision_log_init(), ESP_ERR_NOT_FOUND);
+    s_partition.size = PARTITION_SIZE;
+    CHECK_EQ_INT(decision_log_query(&filter, page, 1, &count), ESP_ERR_INVALID_STATE);
+}
+
+static void test_names_and_json(void)
+{
+    CHECK(strcmp(decision_log_event_to_string(DECISION_EVENT_VALVE_OPEN), "valve_open") == 0);
+    CHECK(strcmp(decision_log_event_to_string(DECISION_EVENT_COUNT), "unknown") == 0);
+    CHECK(strcmp(decision_log_reason_to_string(DECISION_REASON_SOIL_DRY), "soil_dry") == 0);
+    CHECK(strcmp(decision_log_reason_to_string(DECISION_REASON_SESSION_INTERRUPTED),
+                 "session_interrupted") == 0);
+    CHECK(strcmp(decision_log_reason_to_string(DECISION_REASON_COUNT), "unknown") == 0);
+    for (int r = 0; r < DECISION_REASON_COUNT; r++) {
+        CHECK(strcmp(decision_log_reason_to_string((uint8_t)r), "unknown") != 0);
+    }
+
+    CHECK_EQ_INT(decision_log_soil_encode(-1.0f), DECISION_LOG_SOIL_NONE);
+    CHECK_EQ_INT(decision_log_soil_encode(38.5f), 77);
+    CHECK_EQ_INT(decision_log_soil_encode(150.0f), 200);
+    CHECK_NEAR(decision_log_soil_percent(77), 38.5f, 1e-6f);
+    CHECK(decision_log_soil_percent(DECISION_LOG_SOIL_NONE) < 0.0f);
+
+    decision_log_record_t record = {
+        .seq = 1287, .timestamp = 1760670000, .uptime_s = 11520,
+        .event = DECISION_EVENT_VALVE_OPEN, .reason = DECISION_REASON_SOIL_DRY,
+        .state = 1, .level = 2, .valve = 1, .value = 18,
+        .flags = DECISION_LOG_FLAG_TIME_SYNCED,
+        .temperature_x10 = 214, .humidity_x10 = 780,
+        .soil_count = 3, .soil = { 77, 82, DECISION_LOG_SOIL_NONE },
+    };
+    cJSON *json = decision_log_record_to_json(&record);
+    CHECK(json != NULL);
+    CHECK_EQ_INT(json_get(json, "seq")->number, 1287);
+    CHECK_EQ_INT(json_get(json, "timestamp")->number, 1760670000);
+    CHECK(strcmp(json_get(json, "event")->string, "valve_open") == 0);
+    CHECK(strcmp(json_get(json, "reason")->string, "soil_dry") == 0);
+    CHECK_EQ_INT(json_get(json, "offline_level")->number, 2);
+    CHECK_EQ_INT(json_get(json, "online")->type, JSON_FALSE);
+    CHECK_NEAR(json_get(json, "temperature")->number, 21.4, 1e-9);
+    const cJSON *soil = json_get(json, "soil")->child;
+    CHECK_NEAR(soil->number, 38.5, 1e-9);
+    CHECK_NEAR(soil->next->number, 41.0, 1e-9);
+    CHECK_EQ_INT(soil->next->next->type, JSON_NULL);
+    CHECK(soil->next->next->next == NULL);
+    cJSON_Delete(json);
+
+    // Unsynced and online: null timestamp and level, soil_count clamped
+    record.flags = DECISION_LOG_FLAG_ONLINE;
+    record.level = DECISION_LOG_LEVEL_NONE;
+    record.soil_count = 200;
+    json = decision_log_record_to_json(&record);
+    CHECK_EQ_INT(json_get(json, "timestamp")->type, JSON_NULL);
+    CHECK_EQ_INT(json_get(json, "offline_level")->type, JSON_NULL);
+    CHECK_EQ_INT(json_get(json, "online")->type, JSON_TRUE);
+    int channels = 0;
+    for (const cJSON *c = json_get(json, "soil")->child; c != NULL; c = c->next) {
+        channels++;
+    }
+    CHECK_EQ_INT(channels, DECISION_LOG_SOIL_CHANNELS);
+    cJSON_Delete(json);
+    CHECK_EQ_INT(s_json_live, 0);
+    CHECK(decision_log_record_to_json(NULL) == NULL);
+}
+
+int main(void)
+{
+    s_shared = mmap(NULL, sizeof(shared_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (s_shared == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+
+    test_names_and_json();
+    test_unavailable();
+    test_wrap_and_reopen();
+    test_clock_steps();
+    test_power_loss();
+    test_queue_full();
+    return HOST_TEST_RESULT("decision_log");
+}
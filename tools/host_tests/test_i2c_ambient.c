@@ -0,0 +1,537 @@
+/**
+ * @file test_i2c_ambient.c
+ * @brief SHT3x / BME280 decoding and read sequences against fake I2C devices
+ *
+ * ambient_codec.c is checked against the datasheet examples: the
+ * Sensirion CRC-8 example (0xBEEF -> 0x92), the Bosch temperature
+ * example (adc_T 519888 -> 25.08 °C, t_fine 128422) and the Bosch
+ * double-precision humidity formula over the ADC range.
+ *
+ * sht3x.c and bme280.c are compiled unchanged against the shim headers
+ * and driven through a fake bus with a virtual clock: the devices NACK
+ * or report "measuring" until their conversion time has passed, so the
+ * tests see the command / sleep / fetch sequence, the retry and polling
+ * limits, and how CRC errors, skipped measurements and missing devices
+ * are reported.
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "ambient_codec.h"
+#include "i2c_ambient_bus.h"
+#include "sht3x.h"
+#include "bme280.h"
+#include "host_test.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* ============================ FAKE BUS ============================ */
+
+#define FAKE_XFER_US            100     // Time on the wire per transfer
+#define SHT3X_ADDRESS           0x44
+#define BME280_ADDRESS          0x76
+
+struct i2c_master_dev_t {
+    uint8_t address;
+};
+
+static struct i2c_master_dev_t s_sht_dev = { SHT3X_ADDRESS };
+static struct i2c_master_dev_t s_bme_dev = { BME280_ADDRESS };
+static int64_t s_now_us;
+static int s_attached;
+
+typedef struct {
+    bool present;
+    bool nack_reset;
+    bool corrupt;                   // Flip a bit in the humidity word
+    int64_t conversion_us;
+    uint16_t raw_t;
+    uint16_t raw_rh;
+    int64_t started_us;             // -1 = no measurement pending
+    int commands;
+    int resets;
+    int receives;
+    int nacks;
+} fake_sht3x_t;
+
+typedef struct {
+    bool present;
+    bool skip_measurement;          // Leave the data registers at their reset values
+    uint8_t regs[256];
+    int64_t conversion_us;
+    int64_t measuring_until_us;     // -1 = idle
+    int64_t im_update_until_us;
+    int32_t adc_t;
+    int32_t adc_h;
+    int ctrl_meas_forced;
+    bool ctrl_hum_before_meas;
+    int status_reads;
+} fake_bme280_t;
+
+static fake_sht3x_t s_sht;
+static fake_bme280_t s_bme;
+
+esp_err_t i2c_ambient_bus_add_device(uint8_t address, i2c_master_dev_handle_t *dev)
+{
+    if (address == SHT3X_ADDRESS && s_sht.present) {
+        *dev = &s_sht_dev;
+    } else if (address == BME280_ADDRESS && s_bme.present) {
+        *dev = &s_bme_dev;
+    } else {
+        return ESP_ERR_NOT_FOUND;
+    }
+    s_attached++;
+    return ESP_OK;
+}
+
+esp_err_t i2c_ambient_bus_remove_device(i2c_master_dev_handle_t dev)
+{
+    if (dev != NULL) {
+        s_attached--;
+    }
+    return ESP_OK;
+}
+
+void i2c_ambient_wait_ms(uint32_t ms)
+{
+    s_now_us += (int64_t)ms * 1000;
+}
+
+static uint16_t word_be(const uint8_t *p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static void bme_set_data(int32_t adc_t, int32_t adc_h)
+{
+    s_bme.regs[0xFA] = (uint8_t)(adc_t >> 12);
+    s_bme.regs[0xFB] = (uint8_t)(adc_t >> 4);
+    s_bme.regs[0xFC] = (uint8_t)((adc_t & 0x0F) << 4);
+    s_bme.regs[0xFD] = (uint8_t)(adc_h >> 8);
+    s_bme.regs[0xFE] = (uint8_t)adc_h;
+}
+
+/**
+ * @brief Finish a forced conversion whose time has passed
+ */
+static void bme_update(void)
+{
+    if (s_bme.measuring_until_us >= 0 && s_now_us >= s_bme.measuring_until_us) {
+        if (!s_bme.skip_measurement) {
+            bme_set_data(s_bme.adc_t, s_bme.adc_h);
+        }
+        s_bme.measuring_until_us = -1;
+    }
+}
+
+esp_err_t i2c_master_transmit(i2c_master_dev_handle_t i2c_dev, const uint8_t *write_buffer,
+                              size_t write_size, int xfer_timeout_ms)
+{
+    (void)xfer_timeout_ms;
+    s_now_us += FAKE_XFER_US;
+
+    if (i2c_dev == &s_sht_dev) {
+        uint16_t command = word_be(write_buffer);
+        s_sht.commands++;
+        if (write_size != 2) {
+            return ESP_FAIL;
+        }
+        if (command == 0x30A2) {
+            s_sht.resets++;
+            return s_sht.nack_reset ? ESP_FAIL : ESP_OK;
+        }
+        if (command == 0x2400) {
+            s_sht.started_us = s_now_us;
+            return ESP_OK;
+        }
+        return ESP_FAIL;
+    }
+
+    bme_update();
+    if (write_size != 2) {
+        return ESP_FAIL;
+    }
+    uint8_t reg = write_buffer[0];
+    uint8_t value = write_buffer[1];
+    if (reg == 0xE0 && value == 0xB6) {
+        s_bme.im_update_until_us = s_now_us + 2000;
+        bme_set_data(0x80000, 0x8000);
+        return ESP_OK;
+    }
+    if (reg == 0xF4 && (value & 0x03) == 0x01) {
+        s_bme.ctrl_meas_forced++;
+        s_bme.ctrl_hum_before_meas = (s_bme.regs[0xF2] == 0x01);
+        s_bme.measuring_until_us = s_now_us + s_bme.conversion_us;
+    }
+    s_bme.regs[reg] = value;
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_receive(i2c_master_dev_handle_t i2c_dev, uint8_t *read_buffer,
+                             size_t read_size, int xfer_timeout_ms)
+{
+    (void)xfer_timeout_ms;
+    s_now_us += FAKE_XFER_US;
+
+    if (i2c_dev != &s_sht_dev || read_size != SHT3X_MEASUREMENT_LEN) {
+        return ESP_FAIL;
+    }
+    s_sht.receives++;
+
+    // No clock stretching: NACK the read header while converting
+    if (s_sht.started_us < 0 || s_now_us - s_sht.started_us < s_sht.conversion_us) {
+        s_sht.nacks++;
+        return ESP_FAIL;
+    }
+
+    read_buffer[0] = (uint8_t)(s_sht.raw_t >> 8);
+    read_buffer[1] = (uint8_t)s_sht.raw_t;
+    read_buffer[2] = sht3x_crc8(&read_buffer[0], 2);
+    read_buffer[3] = (uint8_t)(s_sht.raw_rh >> 8);
+    read_buffer[4] = (uint8_t)s_sht.raw_rh;
+    read_buffer[5] = sht3x_crc8(&read_buffer[3], 2);
+    if (s_sht.corrupt) {
+        read_buffer[4] ^= 0x01;
+    }
+    s_sht.started_us = -1;
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_transmit_receive(i2c_master_dev_handle_t i2c_dev, const uint8_t *write_buffer,
+                                      size_t write_size, uint8_t *read_buffer, size_t read_size,
+                                      int xfer_timeout_ms)
+{
+    (void)xfer_timeout_ms;
+    s_now_us += FAKE_XFER_US;
+
+    if (i2c_dev != &s_bme_dev || write_size != 1) {
+        return ESP_FAIL;
+    }
+    bme_update();
+
+    uint8_t reg = write_buffer[0];
+    for (size_t i = 0; i < read_size; i++) {
+        read_buffer[i] = s_bme.regs[(uint8_t)(reg + i)];
+    }
+    if (reg == 0xF3) {
+        s_bme.status_reads++;
+        read_buffer[0] = (uint8_t)((s_bme.measuring_until_us >= 0 ? 0x08 : 0x00) |
+                                   (s_now_us < s_bme.im_update_until_us ? 0x01 : 0x00));
+    }
+    return ESP_OK;
+}
+
+/* ============================ DATASHEET VALUES ============================ */
+
+// Bosch example trimming (BMP280 datasheet 3.12, same temperature formula)
+#define EX_DIG_T1       27504
+#define EX_DIG_T2       26435
+#define EX_DIG_T3       -1000
+#define EX_ADC_T        519888
+
+// Typical humidity trimming of a production BME280
+#define EX_DIG_H1       75
+#define EX_DIG_H2       362
+#define EX_DIG_H3       0
+#define EX_DIG_H4       313
+#define EX_DIG_H5       50
+#define EX_DIG_H6       30
+
+static void fill_calib(uint8_t tp[BME280_CALIB_TP_LEN], uint8_t h[BME280_CALIB_H_LEN],
+                       int16_t h4, int16_t h5)
+{
+    memset(tp, 0, BME280_CALIB_TP_LEN);
+    tp[0] = (uint8_t)(EX_DIG_T1 & 0xFF);
+    tp[1] = (uint8_t)(EX_DIG_T1 >> 8);
+    tp[2] = (uint8_t)(EX_DIG_T2 & 0xFF);
+    tp[3] = (uint8_t)(EX_DIG_T2 >> 8);
+    tp[4] = (uint8_t)((uint16_t)EX_DIG_T3 & 0xFF);
+    tp[5] = (uint8_t)((uint16_t)EX_DIG_T3 >> 8);
+    tp[25] = EX_DIG_H1;
+
+    h[0] = (uint8_t)(EX_DIG_H2 & 0xFF);
+    h[1] = (uint8_t)(EX_DIG_H2 >> 8);
+    h[2] = EX_DIG_H3;
+    h[3] = (uint8_t)((uint16_t)h4 >> 4);                                // 0xE4: H4[11:4]
+    h[4] = (uint8_t)((((uint16_t)h5 & 0x0F) << 4) | ((uint16_t)h4 & 0x0F)); // 0xE5: H5[3:0] H4[3:0]
+    h[5] = (uint8_t)((uint16_t)h5 >> 4);                                // 0xE6: H5[11:4]
+    h[6] = (uint8_t)EX_DIG_H6;
+}
+
+/**
+ * @brief Bosch double-precision compensation (BME280 datasheet 8.1)
+ */
+static void bme280_reference(const bme280_calib_t *c, int32_t adc_t, int32_t adc_h,
+                             double *temperature, double *humidity)
+{
+    double var1 = ((double)adc_t / 16384.0 - (double)c->dig_t1 / 1024.0) * (double)c->dig_t2;
+    double var2 = ((double)adc_t / 131072.0 - (double)c->dig_t1 / 8192.0) *
+                  ((double)adc_t / 131072.0 - (double)c->dig_t1 / 8192.0) * (double)c->dig_t3;
+    double t_fine = var1 + var2;
+    *temperature = t_fine / 5120.0;
+
+    double h = t_fine - 76800.0;
+    h = ((double)adc_h - ((double)c->dig_h4 * 64.0 + (double)c->dig_h5 / 16384.0 * h)) *
+        ((double)c->dig_h2 / 65536.0 * (1.0 + (double)c->dig_h6 / 67108864.0 * h *
+                                        (1.0 + (double)c->dig_h3 / 67108864.0 * h)));
+    h = h * (1.0 - (double)c->dig_h1 * h / 524288.0);
+    *humidity = (h > 100.0) ? 100.0 : ((h < 0.0) ? 0.0 : h);
+}
+
+static void pack_bme_raw(int32_t adc_t, int32_t adc_h, uint8_t raw[BME280_DATA_TH_LEN])
+{
+    raw[0] = (uint8_t)(adc_t >> 12);
+    raw[1] = (uint8_t)(adc_t >> 4);
+    raw[2] = (uint8_t)((adc_t & 0x0F) << 4);
+    raw[3] = (uint8_t)(adc_h >> 8);
+    raw[4] = (uint8_t)adc_h;
+}
+
+/* ============================ CODEC ============================ */
+
+static void test_sht3x_codec(void)
+{
+    const uint8_t example[2] = { 0xBE, 0xEF };
+    CHECK_EQ_INT(sht3x_crc8(example, 2), 0x92);
+
+    float t = 0.0f;
+    float rh = 0.0f;
+    uint8_t rx[SHT3X_MEASUREMENT_LEN] = { 0x66, 0x66, 0, 0x80, 0x00, 0 };
+    rx[2] = sht3x_crc8(&rx[0], 2);
+    rx[5] = sht3x_crc8(&rx[3], 2);
+    CHECK_EQ_INT(sht3x_decode(rx, &t, &rh), AMBIENT_CODEC_OK);
+    CHECK_NEAR(t, 25.0f, 0.01f);                // -45 + 175 * 0.4
+    CHECK_NEAR(rh, 50.0f, 0.01f);
+
+    // Every single-bit error in a word is caught
+    for (int bit = 0; bit < 16; bit++) {
+        uint8_t bad[SHT3X_MEASUREMENT_LEN];
+        memcpy(bad, rx, sizeof(bad));
+        bad[bit < 8 ? 0 : 1] ^= (uint8_t)(1u << (bit & 7));
+        CHECK_EQ_INT(sht3x_decode(bad, &t, &rh), AMBIENT_CODEC_ERR_CRC);
+        memcpy(bad, rx, sizeof(bad));
+        bad[bit < 8 ? 3 : 4] ^= (uint8_t)(1u << (bit & 7));
+        CHECK_EQ_INT(sht3x_decode(bad, &t, &rh), AMBIENT_CODEC_ERR_CRC);
+    }
+
+    // -45 °C decodes fine but is outside the operating range
+    uint8_t cold[SHT3X_MEASUREMENT_LEN] = { 0x00, 0x00, 0, 0x80, 0x00, 0 };
+    cold[2] = sht3x_crc8(&cold[0], 2);
+    cold[5] = sht3x_crc8(&cold[3], 2);
+    CHECK_EQ_INT(sht3x_decode(cold, &t, &rh), AMBIENT_CODEC_ERR_RANGE);
+}
+
+static void test_bme280_codec(void)
+{
+    uint8_t tp[BME280_CALIB_TP_LEN];
+    uint8_t h[BME280_CALIB_H_LEN];
+    bme280_calib_t calib;
+
+    // 12-bit H4/H5 share register 0xE5, including negative values
+    fill_calib(tp, h, -7, -100);
+    bme280_parse_calib(tp, h, &calib);
+    CHECK_EQ_INT(calib.dig_h4, -7);
+    CHECK_EQ_INT(calib.dig_h5, -100);
+
+    fill_calib(tp, h, EX_DIG_H4, EX_DIG_H5);
+    bme280_parse_calib(tp, h, &calib);
+    CHECK_EQ_INT(calib.dig_t1, EX_DIG_T1);
+    CHECK_EQ_INT(calib.dig_t2, EX_DIG_T2);
+    CHECK_EQ_INT(calib.dig_t3, EX_DIG_T3);
+    CHECK_EQ_INT(calib.dig_h1, EX_DIG_H1);
+    CHECK_EQ_INT(calib.dig_h2, EX_DIG_H2);
+    CHECK_EQ_INT(calib.dig_h3, EX_DIG_H3);
+    CHECK_EQ_INT(calib.dig_h4, EX_DIG_H4);
+    CHECK_EQ_INT(calib.dig_h5, EX_DIG_H5);
+    CHECK_EQ_INT(calib.dig_h6, EX_DIG_H6);
+
+    // Datasheet example: 25.08 °C
+    float t = 0.0f;
+    float rh = 0.0f;
+    uint8_t raw[BME280_DATA_TH_LEN];
+    pack_bme_raw(EX_ADC_T, 30000, raw);
+    CHECK_EQ_INT(bme280_decode(&calib, raw, &t, &rh), AMBIENT_CODEC_OK);
+    CHECK_NEAR(t, 25.08f, 0.001f);
+
+    // Integer humidity against the double-precision formula
+    float previous = -1.0f;
+    double worst = 0.0;
+    for (int32_t adc_h = 20000; adc_h <= 45000; adc_h += 250) {
+        double ref_t;
+        double ref_h;
+        pack_bme_raw(EX_ADC_T, adc_h, raw);
+        CHECK_EQ_INT(bme280_decode(&calib, raw, &t, &rh), AMBIENT_CODEC_OK);
+        bme280_reference(&calib, EX_ADC_T, adc_h, &ref_t, &ref_h);
+        double diff = (rh > ref_h) ? rh - ref_h : ref_h - rh;
+        worst = (diff > worst) ? diff : worst;
+        CHECK(rh >= previous);
+        previous = rh;
+    }
+    CHECK(worst < 0.05);
+    CHECK_NEAR(previous, 100.0f, 0.001f);       // Clamped at the top
+
+    // Temperatures across the range
+    for (int32_t adc_t = 400000; adc_t <= 600000; adc_t += 10000) {
+        double ref_t;
+        double ref_h;
+        pack_bme_raw(adc_t, 30000, raw);
+        ambient_codec_result_t result = bme280_decode(&calib, raw, &t, &rh);
+        bme280_reference(&calib, adc_t, 30000, &ref_t, &ref_h);
+        CHECK_NEAR(t, ref_t, 0.01);
+        CHECK_EQ_INT(result, (ref_t > AMBIENT_TEMPERATURE_MAX) ? AMBIENT_CODEC_ERR_RANGE : AMBIENT_CODEC_OK);
+    }
+
+    // Skipped-measurement markers
+    pack_bme_raw(0x80000, 30000, raw);
+    CHECK_EQ_INT(bme280_decode(&calib, raw, &t, &rh), AMBIENT_CODEC_ERR_SKIPPED);
+    pack_bme_raw(EX_ADC_T, 0x8000, raw);
+    CHECK_EQ_INT(bme280_decode(&calib, raw, &t, &rh), AMBIENT_CODEC_ERR_SKIPPED);
+}
+
+/* ============================ READ SEQUENCES ============================ */
+
+static void sht_reset(int64_t conversion_us)
+{
+    memset(&s_sht, 0, sizeof(s_sht));
+    s_sht.present = true;
+    s_sht.conversion_us = conversion_us;
+    s_sht.raw_t = 0x6666;
+    s_sht.raw_rh = 0x8000;
+    s_sht.started_us = -1;
+    s_now_us = 0;
+    s_attached = 0;
+}
+
+static void test_sht3x_sequence(void)
+{
+    const sensor_ambient_backend_t *backend = sht3x_ambient_backend();
+    ambient_data_t data = { 0 };
+
+    // Absent sensor, or one that NACKs the soft reset: nothing stays attached
+    sht_reset(15500);
+    s_sht.present = false;
+    CHECK_EQ_INT(backend->init(NULL), ESP_ERR_NOT_FOUND);
+    CHECK_EQ_INT(backend->read(&data), ESP_ERR_INVALID_STATE);
+    sht_reset(15500);
+    s_sht.nack_reset = true;
+    CHECK(backend->init(NULL) != ESP_OK);
+    CHECK_EQ_INT(s_attached, 0);
+
+    // Datasheet worst case 15.5 ms: one command, one sleep, one fetch
+    sht_reset(15500);
+    CHECK_EQ_INT(backend->init(NULL), ESP_OK);
+    CHECK_EQ_INT(s_sht.resets, 1);
+    int64_t start_us = s_now_us;
+    CHECK_EQ_INT(backend->read(&data), ESP_OK);
+    CHECK_NEAR(data.temperature, 25.0f, 0.01f);
+    CHECK_NEAR(data.humidity, 50.0f, 0.01f);
+    CHECK_EQ_INT(s_sht.receives, 1);
+    CHECK_EQ_INT(s_sht.nacks, 0);
+    CHECK(s_now_us - start_us >= 15500);
+    CHECK(s_now_us - start_us < 17000);
+
+    // A slow part NACKs the fetch until it is done: retried every 2 ms
+    s_sht.conversion_us = 19000;
+    CHECK_EQ_INT(backend->read(&data), ESP_OK);
+    CHECK_EQ_INT(s_sht.receives, 1 + 3);
+    CHECK_EQ_INT(s_sht.nacks, 2);
+
+    // Gives up after the retries
+    s_sht.conversion_us = 40000;
+    s_sht.receives = 0;
+    CHECK(backend->read(&data) != ESP_OK);
+    CHECK_EQ_INT(s_sht.receives, 3);
+
+    // CRC error is reported as such
+    s_sht.conversion_us = 15500;
+    s_sht.corrupt = true;
+    CHECK_EQ_INT(backend->read(&data), ESP_ERR_INVALID_CRC);
+
+    CHECK_EQ_INT(backend->deinit(), ESP_OK);
+    CHECK_EQ_INT(s_attached, 0);
+    CHECK_EQ_INT(backend->read(&data), ESP_ERR_INVALID_STATE);
+}
+
+static void bme_reset(int64_t conversion_us)
+{
+    uint8_t tp[BME280_CALIB_TP_LEN];
+    uint8_t h[BME280_CALIB_H_LEN];
+
+    memset(&s_bme, 0, sizeof(s_bme));
+    s_bme.present = true;
+    s_bme.conversion_us = conversion_us;
+    s_bme.measuring_until_us = -1;
+    s_bme.im_update_until_us = -1;
+    s_bme.adc_t = EX_ADC_T;
+    s_bme.adc_h = 30000;
+    s_bme.regs[0xD0] = 0x60;
+    fill_calib(tp, h, EX_DIG_H4, EX_DIG_H5);
+    memcpy(&s_bme.regs[0x88], tp, sizeof(tp));
+    memcpy(&s_bme.regs[0xE1], h, sizeof(h));
+    bme_set_data(0x80000, 0x8000);
+    s_now_us = 0;
+    s_attached = 0;
+}
+
+static void test_bme280_sequence(void)
+{
+    const sensor_ambient_backend_t *backend = bme280_ambient_backend();
+    ambient_data_t data = { 0 };
+
+    // A BMP280 answers at the same address but has no humidity sensor
+    bme_reset(6400);
+    s_bme.regs[0xD0] = 0x58;
+    CHECK_EQ_INT(backend->init(NULL), ESP_ERR_NOT_SUPPORTED);
+    CHECK_EQ_INT(s_attached, 0);
+
+    // Forced mode, datasheet max 6.4 ms: one status poll after the sleep
+    bme_reset(6400);
+    CHECK_EQ_INT(backend->init(NULL), ESP_OK);
+    CHECK_EQ_INT(s_attached, 1);
+    s_bme.status_reads = 0;
+    int64_t start_us = s_now_us;
+    CHECK_EQ_INT(backend->read(&data), ESP_OK);
+    CHECK_NEAR(data.temperature, 25.08f, 0.001f);
+    CHECK_EQ_INT(s_bme.ctrl_meas_forced, 1);
+    CHECK(s_bme.ctrl_hum_before_meas);          // Humidity oversampling latched by ctrl_meas
+    CHECK_EQ_INT(s_bme.status_reads, 1);
+    CHECK(s_now_us - start_us < 8000);
+
+    // Every read triggers its own forced conversion
+    s_bme.adc_h = 32000;
+    float first_rh = data.humidity;
+    CHECK_EQ_INT(backend->read(&data), ESP_OK);
+    CHECK_EQ_INT(s_bme.ctrl_meas_forced, 2);
+    CHECK(data.humidity > first_rh);
+
+    // Slower conversion: polled every 2 ms, up to 3 extra times
+    s_bme.conversion_us = 10000;
+    s_bme.status_reads = 0;
+    CHECK_EQ_INT(backend->read(&data), ESP_OK);
+    CHECK_EQ_INT(s_bme.status_reads, 3);
+    s_bme.conversion_us = 30000;
+    CHECK_EQ_INT(backend->read(&data), ESP_ERR_TIMEOUT);
+    s_now_us += 30000;                          // Let the stuck conversion end
+
+    // Conversion that left the reset values behind
+    s_bme.conversion_us = 6400;
+    s_bme.skip_measurement = true;
+    bme_set_data(0x80000, 0x8000);
+    CHECK_EQ_INT(backend->read(&data), ESP_ERR_INVALID_RESPONSE);
+
+    CHECK_EQ_INT(backend->deinit(), ESP_OK);
+    CHECK_EQ_INT(s_attached, 0);
+}
+
+int main(void)
+{
+    test_sht3x_codec();
+    test_bme280_codec();
+    test_sht3x_sequence();
+    test_bme280_sequence();
+    return HOST_TEST_RESULT("i2c_ambient");
+}
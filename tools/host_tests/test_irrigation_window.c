@@ -0,0 +1,451 @@
+/**
+ * @file test_irrigation_window.c
+ * @brief Multi-day simulation of the irrigation windows and deferred-start queue
+ *
+ * irrigation_window.c takes the minute of day from its caller, so the
+ * simulation drives it with an accelerated clock: two zones sharing one
+ * pump, soil that dries faster around midday, and an evaluation loop that
+ * mirrors the controller (queue outside the window, emergency bypass,
+ * drop on recovery, wait capped to the next window opening). Over two
+ * weeks it checks that no automatic start leaves its window, that a
+ * queued zone starts within a minute of its window opening, that the
+ * more urgent zone goes first and that every zone is watered every day.
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "irrigation_window.h"
+#include "host_test.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* ============================ SIMULATION ============================ */
+
+#define SIM_ZONES               2
+#define SIM_DAYS                14
+#define SIM_STEP_S              60
+#define SIM_EVAL_S              (15 * 60)       // Evaluation interval of the controller
+#define SIM_SESSION_MAX_S       (60 * 60)
+
+#define SOIL_INITIAL            70.0f           // Watered the evening before
+#define SOIL_START              45.0f           // Below: irrigation wanted
+#define SOIL_RECOVERED          50.0f           // Above: a deferred start is dropped
+#define SOIL_STOP               70.0f
+#define SOIL_GAIN_PER_MIN       0.8f            // While the valve is open
+
+// offline_level_t values
+#define LEVEL_WARNING           1
+#define LEVEL_CRITICAL          2
+#define LEVEL_EMERGENCY         3
+
+static const char *const s_window_specs[SIM_ZONES] = {
+    "04:00-10:00,17:00-22:00",
+    "05:30-08:00,21:00-02:00",                  // Overlaps zone 1, wraps midnight
+};
+
+static const char *const s_shared_specs[SIM_ZONES] = {
+    "05:00-07:00",
+    "05:00-07:00",
+};
+
+/**
+ * @brief Expected window membership, written out by hand per scenario
+ */
+typedef bool (*sim_window_fn_t)(uint8_t zone, uint16_t minute);
+
+typedef struct {
+    sim_window_fn_t window_expected;
+    irrigation_window_schedule_t schedules[SIM_ZONES];
+    irrigation_deferred_queue_t queue;
+    float soil[SIM_ZONES];
+    float dry_factor[SIM_ZONES];
+    int64_t now_s;
+    int64_t next_eval_s;
+    uint8_t running;                            // Zone on the pump, 0 = idle
+    int64_t session_start_s;
+    bool was_open[SIM_ZONES];
+    int64_t opened_idle_s[SIM_ZONES];           // Window opened while queued, pump idle (-1 none)
+    int last_start_day[SIM_ZONES];
+
+    // Results
+    int starts;
+    int emergency_starts;
+    int outside_window_starts;
+    int priority_violations;
+    int contested_releases;                     // Another open zone was waiting
+    int refresh_violations;
+    int releases_at_open;
+    int64_t max_release_delay_s;
+    int days_without_start;
+    float min_soil;
+} sim_t;
+
+static uint16_t sim_minute(const sim_t *sim)
+{
+    return (uint16_t)((sim->now_s / 60) % IRRIGATION_WINDOW_DAY_MINUTES);
+}
+
+static bool sim_window_split(uint8_t zone, uint16_t minute)
+{
+    if (zone == 1) {
+        return (minute >= 4 * 60 && minute < 10 * 60) || (minute >= 17 * 60 && minute < 22 * 60);
+    }
+    return (minute >= 5 * 60 + 30 && minute < 8 * 60) || minute >= 21 * 60 || minute < 2 * 60;
+}
+
+static bool sim_window_shared(uint8_t zone, uint16_t minute)
+{
+    (void)zone;
+    return minute >= 5 * 60 && minute < 7 * 60;
+}
+
+static uint8_t sim_level(float soil)
+{
+    if (soil < 25.0f) {
+        return LEVEL_EMERGENCY;
+    }
+    return (soil < 35.0f) ? LEVEL_CRITICAL : LEVEL_WARNING;
+}
+
+/**
+ * @brief Urgency order of irrigation_window.h, written out independently
+ */
+static bool sim_more_urgent(const irrigation_deferred_t *a, const irrigation_deferred_t *b)
+{
+    if (a->level != b->level) {
+        return a->level > b->level;
+    }
+    if (a->soil != b->soil) {
+        return a->soil < b->soil;
+    }
+    return a->requested_s < b->requested_s;
+}
+
+static void sim_init(sim_t *sim, const char *const specs[SIM_ZONES],
+                     sim_window_fn_t window_expected, float heat)
+{
+    memset(sim, 0, sizeof(*sim));
+    sim->window_expected = window_expected;
+    for (uint8_t z = 0; z < SIM_ZONES; z++) {
+        CHECK(irrigation_window_parse(specs[z], &sim->schedules[z]));
+        sim->soil[z] = SOIL_INITIAL;
+        sim->opened_idle_s[z] = -1;
+        sim->last_start_day[z] = -1;
+    }
+    sim->dry_factor[0] = heat;
+    sim->dry_factor[1] = heat * 1.3f;
+    irrigation_deferred_init(&sim->queue);
+    sim->min_soil = SOIL_INITIAL;
+}
+
+/**
+ * @brief Soil loss in one minute: 0.6%/h at night, up to 2.4%/h at noon
+ */
+static float sim_drying(const sim_t *sim, uint8_t z)
+{
+    float hour = (float)sim_minute(sim) / 60.0f;
+    float sun = 0.0f;
+    if (hour > 6.0f && hour < 18.0f) {
+        float x = (hour - 6.0f) / 12.0f;        // Cheap half-sine, no libm needed
+        sun = 4.0f * x * (1.0f - x);
+    }
+    return 0.01f * (1.0f + 3.0f * sun) * sim->dry_factor[z];
+}
+
+static void sim_start(sim_t *sim, uint8_t zone, bool emergency)
+{
+    sim->running = zone;
+    sim->session_start_s = sim->now_s;
+    sim->starts++;
+    sim->last_start_day[zone - 1] = (int)(sim->now_s / 86400);
+    irrigation_deferred_remove(&sim->queue, zone);      // Started, by any path
+
+    if (emergency) {
+        sim->emergency_starts++;
+    } else if (!sim->window_expected(zone, sim_minute(sim))) {
+        sim->outside_window_starts++;
+    }
+}
+
+/**
+ * @brief One controller evaluation: queue, drop or release starts
+ */
+static void sim_evaluate(sim_t *sim)
+{
+    uint16_t minute = sim_minute(sim);
+
+    for (uint8_t z = 0; z < SIM_ZONES; z++) {
+        uint8_t zone = z + 1;
+        if (sim->running == zone) {
+            continue;
+        }
+        if (sim->soil[z] >= SOIL_RECOVERED) {
+            irrigation_deferred_remove(&sim->queue, zone);
+            continue;
+        }
+        if (sim->soil[z] >= SOIL_START) {
+            continue;
+        }
+
+        uint8_t level = sim_level(sim->soil[z]);
+        if (level >= LEVEL_EMERGENCY) {
+            if (sim->running == 0) {
+                sim_start(sim, zone, true);
+            }
+            continue;
+        }
+
+        int64_t first_request_s = -1;
+        for (uint8_t i = 0; i < sim->queue.count; i++) {
+            if (sim->queue.entries[i].zone == zone) {
+                first_request_s = sim->queue.entries[i].requested_s;
+            }
+        }
+        irrigation_deferred_t request = {
+            .zone = zone,
+            .level = level,
+            .soil = sim->soil[z],
+            .requested_s = sim->now_s,
+        };
+        CHECK(irrigation_deferred_push(&sim->queue, &request));
+        for (uint8_t i = 0; i < sim->queue.count; i++) {
+            const irrigation_deferred_t *entry = &sim->queue.entries[i];
+            if (entry->zone == zone && first_request_s >= 0 && entry->requested_s != first_request_s) {
+                sim->refresh_violations++;
+            }
+        }
+    }
+
+    if (sim->running != 0) {
+        return;
+    }
+
+    irrigation_deferred_queue_t before = sim->queue;
+    irrigation_deferred_t next;
+    if (!irrigation_deferred_pop_ready(&sim->queue, sim->schedules, SIM_ZONES, minute, &next)) {
+        for (uint8_t i = 0; i < before.count; i++) {
+            CHECK(!sim->window_expected(before.entries[i].zone, minute));
+        }
+        return;
+    }
+
+    for (uint8_t i = 0; i < before.count; i++) {
+        const irrigation_deferred_t *other = &before.entries[i];
+        if (other->zone == next.zone || !sim->window_expected(other->zone, minute)) {
+            continue;
+        }
+        sim->contested_releases++;
+        if (sim_more_urgent(other, &next)) {
+            sim->priority_violations++;
+        }
+    }
+
+    int64_t opened_s = sim->opened_idle_s[next.zone - 1];
+    if (opened_s >= 0) {
+        int64_t delay_s = sim->now_s - opened_s;
+        sim->releases_at_open++;
+        sim->max_release_delay_s = (delay_s > sim->max_release_delay_s) ? delay_s : sim->max_release_delay_s;
+    }
+    for (uint8_t z = 0; z < SIM_ZONES; z++) {
+        sim->opened_idle_s[z] = -1;
+    }
+    sim_start(sim, next.zone, false);
+}
+
+/**
+ * @brief Next evaluation, capped like irrigation_window_cap_wait_ms()
+ */
+static int64_t sim_next_eval_s(const sim_t *sim)
+{
+    int64_t wait_s = SIM_EVAL_S;
+    for (uint8_t i = 0; i < sim->queue.count; i++) {
+        uint8_t zone = sim->queue.entries[i].zone;
+        int64_t open_s = ((int64_t)irrigation_window_minutes_until_open(&sim->schedules[zone - 1],
+                                                                        sim_minute(sim)) + 1) * 60;
+        if (open_s < wait_s) {
+            wait_s = open_s;
+        }
+    }
+    return sim->now_s + wait_s;
+}
+
+static void sim_run(sim_t *sim, int days)
+{
+    int64_t end_s = (int64_t)days * 86400;
+
+    for (sim->now_s = 0; sim->now_s < end_s; sim->now_s += SIM_STEP_S) {
+        uint16_t minute = sim_minute(sim);
+
+        for (uint8_t z = 0; z < SIM_ZONES; z++) {
+            sim->soil[z] -= sim_drying(sim, z);
+            if (sim->running == z + 1) {
+                sim->soil[z] += SOIL_GAIN_PER_MIN;
+            }
+            if (sim->soil[z] < sim->min_soil) {
+                sim->min_soil = sim->soil[z];
+            }
+
+            bool open = irrigation_window_is_open(&sim->schedules[z], minute);
+            CHECK(open == sim->window_expected(z + 1, minute));
+            if (open && !sim->was_open[z] && sim->running == 0 &&
+                irrigation_deferred_contains(&sim->queue, z + 1)) {
+                sim->opened_idle_s[z] = sim->now_s;
+            }
+            sim->was_open[z] = open;
+        }
+
+        if (sim->running != 0 &&
+            (sim->soil[sim->running - 1] >= SOIL_STOP ||
+             sim->now_s - sim->session_start_s >= SIM_SESSION_MAX_S)) {
+            sim->running = 0;
+        }
+
+        // Midnight: every zone must have been watered the day that just ended
+        if (minute == 0 && sim->now_s > 0) {
+            int day = (int)(sim->now_s / 86400) - 1;
+            for (uint8_t z = 0; z < SIM_ZONES; z++) {
+                sim->days_without_start += (sim->last_start_day[z] != day && day > 0);
+            }
+        }
+
+        if (sim->now_s >= sim->next_eval_s) {
+            sim_evaluate(sim);
+            sim->next_eval_s = sim_next_eval_s(sim);
+        }
+        CHECK(sim->queue.count <= SIM_ZONES);
+    }
+}
+
+/* ============================ TESTS ============================ */
+
+static void test_parse_and_wait(void)
+{
+    irrigation_window_schedule_t schedule;
+
+    CHECK(irrigation_window_parse("", &schedule));
+    CHECK_EQ_INT(schedule.count, 0);
+    CHECK(irrigation_window_is_open(&schedule, 12 * 60));
+
+    CHECK(irrigation_window_parse(" 22:00-24:00 , 00:00-02:00", &schedule));
+    CHECK_EQ_INT(schedule.count, 2);
+    CHECK(irrigation_window_is_open(&schedule, 23 * 60 + 59));
+    CHECK(irrigation_window_is_open(&schedule, 0));
+    CHECK(!irrigation_window_is_open(&schedule, 2 * 60));
+
+    CHECK(!irrigation_window_parse("04:00-04:00", &schedule));
+    CHECK(!irrigation_window_parse("24:30-02:00", &schedule));
+    CHECK(!irrigation_window_parse("04:00-10:00;17:00-22:00", &schedule));
+    CHECK(!irrigation_window_parse("1:00-2:00,3:00-4:00,5:00-6:00,7:00-8:00,9:00-10:00", &schedule));
+    CHECK_EQ_INT(schedule.count, 0);
+
+    CHECK(irrigation_window_parse(s_window_specs[1], &schedule));
+    CHECK_EQ_INT(irrigation_window_minutes_until_open(&schedule, 2 * 60), 3 * 60 + 30);
+    CHECK_EQ_INT(irrigation_window_minutes_until_open(&schedule, 8 * 60), 13 * 60);
+    CHECK_EQ_INT(irrigation_window_minutes_until_open(&schedule, 23 * 60), 0);
+    for (uint16_t minute = 0; minute < IRRIGATION_WINDOW_DAY_MINUTES; minute++) {
+        uint16_t wait = irrigation_window_minutes_until_open(&schedule, minute);
+        CHECK(irrigation_window_is_open(&schedule, (uint16_t)((minute + wait) % IRRIGATION_WINDOW_DAY_MINUTES)));
+        CHECK(wait == 0 || !irrigation_window_is_open(&schedule, (uint16_t)((minute + wait - 1) % IRRIGATION_WINDOW_DAY_MINUTES)));
+    }
+}
+
+static void test_queue_order(void)
+{
+    irrigation_window_schedule_t schedules[3];
+    irrigation_deferred_queue_t queue;
+    irrigation_deferred_t out;
+
+    for (int i = 0; i < 3; i++) {
+        CHECK(irrigation_window_parse("", &schedules[i]));
+    }
+    irrigation_deferred_init(&queue);
+
+    irrigation_deferred_t a = { .zone = 1, .level = LEVEL_WARNING, .soil = 40.0f, .requested_s = 100 };
+    irrigation_deferred_t b = { .zone = 2, .level = LEVEL_WARNING, .soil = 38.0f, .requested_s = 200 };
+    irrigation_deferred_t c = { .zone = 3, .level = LEVEL_WARNING, .soil = 38.0f, .requested_s = 150 };
+    CHECK(irrigation_deferred_push(&queue, &a));
+    CHECK(irrigation_deferred_push(&queue, &b));
+    CHECK(irrigation_deferred_push(&queue, &c));
+
+    // Refresh: zone 1 becomes critical, keeps its request time
+    irrigation_deferred_t a2 = { .zone = 1, .level = LEVEL_CRITICAL, .soil = 34.0f, .requested_s = 900 };
+    CHECK(irrigation_deferred_push(&queue, &a2));
+    CHECK_EQ_INT(queue.count, 3);
+
+    CHECK(irrigation_deferred_pop_ready(&queue, schedules, 3, 0, &out));
+    CHECK_EQ_INT(out.zone, 1);
+    CHECK_EQ_INT(out.requested_s, 100);
+    CHECK(irrigation_deferred_pop_ready(&queue, schedules, 3, 0, &out));
+    CHECK_EQ_INT(out.zone, 3);                  // Same soil as zone 2, older request
+    CHECK(irrigation_deferred_pop_ready(&queue, schedules, 3, 0, &out));
+    CHECK_EQ_INT(out.zone, 2);
+    CHECK(!irrigation_deferred_pop_ready(&queue, schedules, 3, 0, &out));
+
+    // A zone outside the schedules table is never released
+    irrigation_deferred_t stray = { .zone = 4, .level = LEVEL_CRITICAL, .soil = 10.0f };
+    CHECK(irrigation_deferred_push(&queue, &stray));
+    CHECK(!irrigation_deferred_pop_ready(&queue, schedules, 3, 0, &out));
+    CHECK(irrigation_deferred_remove(&queue, 4));
+    CHECK(!irrigation_deferred_remove(&queue, 4));
+}
+
+static void test_two_weeks(void)
+{
+    sim_t sim;
+    sim_init(&sim, s_window_specs, sim_window_split, 1.0f);
+    sim_run(&sim, SIM_DAYS);
+
+    CHECK(sim.starts >= SIM_DAYS * SIM_ZONES);
+    CHECK_EQ_INT(sim.outside_window_starts, 0);
+    CHECK_EQ_INT(sim.emergency_starts, 0);
+    CHECK_EQ_INT(sim.priority_violations, 0);
+    CHECK_EQ_INT(sim.refresh_violations, 0);
+    CHECK_EQ_INT(sim.days_without_start, 0);
+    CHECK(sim.releases_at_open > 0);
+    CHECK(sim.max_release_delay_s <= 60);
+    CHECK(sim.min_soil >= 25.0f);
+}
+
+static void test_heat_wave(void)
+{
+    // Drying three times faster: emergency starts bypass the windows,
+    // everything else still waits for them
+    sim_t sim;
+    sim_init(&sim, s_window_specs, sim_window_split, 3.0f);
+    sim_run(&sim, SIM_DAYS);
+
+    CHECK(sim.emergency_starts > 0);
+    CHECK_EQ_INT(sim.outside_window_starts, 0);
+    CHECK_EQ_INT(sim.priority_violations, 0);
+    CHECK_EQ_INT(sim.refresh_violations, 0);
+    CHECK(sim.max_release_delay_s <= 60);
+}
+
+static void test_shared_window(void)
+{
+    // Both zones wait all day for the same two hours: the drier one goes
+    // first and the other still fits in the window
+    sim_t sim;
+    sim_init(&sim, s_shared_specs, sim_window_shared, 1.0f);
+    sim_run(&sim, SIM_DAYS);
+
+    CHECK(sim.contested_releases >= SIM_DAYS - 1);
+    CHECK_EQ_INT(sim.priority_violations, 0);
+    CHECK_EQ_INT(sim.outside_window_starts, 0);
+    CHECK_EQ_INT(sim.emergency_starts, 0);
+    CHECK_EQ_INT(sim.days_without_start, 0);
+}
+
+int main(void)
+{
+    test_parse_and_wait();
+    test_queue_order();
+    test_two_weeks();
+    test_heat_wave();
+    test_shared_window();
+    return HOST_TEST_RESULT("irrigation_window");
+}
@@ -0,0 +1,400 @@
+/**
+ * @file test_modbus_rtu_pty.c
+ * @brief Modbus RTU framing against a simulated slave on a pseudo-terminal
+ *
+ * The master side opens the pty slave like a serial port and runs the
+ * same transaction as modbus_rtu_transact(): flush input, write the
+ * request, read the 5-byte header, then the rest of the expected frame,
+ * and parse it. Requests of a bus cycle are separated only by the
+ * 3.5-character gap, as in modbus_rtu_read_batch().
+ *
+ * The simulated slaves run in a thread on the pty master. A frame ends
+ * after one gap of silence; requests with a bad length or CRC are ignored,
+ * as real slaves do. Behaviour per address:
+ *
+ * - 1, 2: probes with SIM_REG_COUNT registers (exception 0x02 past the end)
+ * - 4: valid reply with a corrupted CRC
+ * - 6: reply from the wrong address
+ * - others: absent (no reply)
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#define _GNU_SOURCE
+#include "modbus_rtu_frame.h"
+#include "host_test.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+/* ============================ CONSTANTS ============================ */
+
+#define SIM_BAUD_RATE           9600
+#define SIM_REG_COUNT           8
+#define SIM_RESPONSE_TIMEOUT_MS 200
+#define SIM_ADDR_CORRUPT_CRC    4
+#define SIM_ADDR_WRONG_REPLY    6
+#define SIM_ADDR_ABSENT         9
+
+typedef enum {
+    XFER_OK = 0,
+    XFER_TIMEOUT,
+    XFER_CRC,
+    XFER_EXCEPTION,
+    XFER_BAD_FRAME,
+} xfer_result_t;
+
+typedef struct {
+    int fd;                     ///< pty master (bus side of the slaves)
+    volatile bool stop;
+    uint32_t frame_gap_us;
+    uint32_t frames;            ///< Frames received
+    uint32_t bad_requests;      ///< Frames ignored for length/CRC
+    pthread_mutex_t lock;
+} sim_bus_t;
+
+/* ============================ HELPERS ============================ */
+
+/**
+ * @brief Same gap as modbus_rtu_frame_gap_us(): 3.5 chars of 11 bits
+ */
+static uint32_t frame_gap_us(uint32_t baud_rate)
+{
+    return (baud_rate > 19200) ? 1750 : 38500000UL / baud_rate;
+}
+
+static int64_t now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ * @brief Read exactly @p len bytes or give up after @p timeout_ms (uart_read_bytes)
+ */
+static int read_exact(int fd, uint8_t *buf, size_t len, int timeout_ms)
+{
+    size_t got = 0;
+    int64_t deadline = now_ms() + timeout_ms;
+
+    while (got < len) {
+        int left = (int)(deadline - now_ms());
+        if (left <= 0) {
+            break;
+        }
+        struct pollfd pfd = { .fd = fd, .events = POLLIN };
+        if (poll(&pfd, 1, left) <= 0) {
+            break;
+        }
+        ssize_t n = read(fd, buf + got, len - got);
+        if (n <= 0) {
+            break;
+        }
+        got += (size_t)n;
+    }
+    return (int)got;
+}
+
+static uint16_t sim_register_value(uint8_t address, uint16_t reg)
+{
+    return (uint16_t)(address * 1000 + reg * 10);
+}
+
+static void sim_send(sim_bus_t *bus, uint8_t *frame, size_t len_without_crc, bool corrupt_crc)
+{
+    uint16_t crc = modbus_rtu_crc16(frame, len_without_crc);
+    frame[len_without_crc] = (uint8_t)(crc & 0xFF);
+    frame[len_without_crc + 1] = (uint8_t)(crc >> 8);
+    if (corrupt_crc) {
+        frame[len_without_crc + 1] ^= 0x5A;
+    }
+    ssize_t n = write(bus->fd, frame, len_without_crc + 2);
+    (void)n;
+}
+
+/* ============================ SIMULATED SLAVES ============================ */
+
+static void sim_handle_frame(sim_bus_t *bus, const uint8_t *req, size_t len)
+{
+    pthread_mutex_lock(&bus->lock);
+    bus->frames++;
+    bool valid = (len == MODBUS_RTU_READ_REQUEST_LEN);
+    if (valid) {
+        uint16_t crc = modbus_rtu_crc16(req, len - 2);
+        valid = req[len - 2] == (uint8_t)(crc & 0xFF) && req[len - 1] == (uint8_t)(crc >> 8);
+    }
+    if (!valid) {
+        bus->bad_requests++;
+    }
+    pthread_mutex_unlock(&bus->lock);
+    if (!valid) {
+        return;
+    }
+
+    uint8_t address = req[0];
+    uint8_t function = req[1];
+    uint16_t start = (uint16_t)((req[2] << 8) | req[3]);
+    uint16_t count = (uint16_t)((req[4] << 8) | req[5]);
+    uint8_t reply[MODBUS_RTU_READ_RESPONSE_LEN(MODBUS_RTU_MAX_READ_REGS)];
+
+    bool present = address == 1 || address == 2 ||
+                   address == SIM_ADDR_CORRUPT_CRC || address == SIM_ADDR_WRONG_REPLY;
+    if (!present) {
+        return;
+    }
+
+    uint8_t exception = 0;
+    if (function != MODBUS_RTU_FC_READ_HOLDING && function != MODBUS_RTU_FC_READ_INPUT) {
+        exception = 0x01;
+    } else if ((uint32_t)start + count > SIM_REG_COUNT) {
+        exception = 0x02;
+    }
+
+    reply[0] = (address == SIM_ADDR_WRONG_REPLY) ? address + 1 : address;
+    if (exception != 0) {
+        reply[1] = function | MODBUS_RTU_FC_EXCEPTION_BIT;
+        reply[2] = exception;
+        sim_send(bus, reply, 3, false);
+        return;
+    }
+
+    reply[1] = function;
+    reply[2] = (uint8_t)(count * 2);
+    for (uint16_t i = 0; i < count; i++) {
+        uint16_t value = sim_register_value(address, start + i);
+        reply[3 + 2 * i] = (uint8_t)(value >> 8);
+        reply[4 + 2 * i] = (uint8_t)(value & 0xFF);
+    }
+    sim_send(bus, reply, 3 + 2 * (size_t)count, address == SIM_ADDR_CORRUPT_CRC);
+}
+
+/**
+ * @brief Slave side: a frame ends after one inter-frame gap of silence
+ */
+static void *sim_bus_thread(void *arg)
+{
+    sim_bus_t *bus = arg;
+    uint8_t frame[256];
+    size_t len = 0;
+    int gap_ms = (int)((bus->frame_gap_us + 999) / 1000);
+
+    while (!bus->stop) {
+        struct pollfd pfd = { .fd = bus->fd, .events = POLLIN };
+        int ready = poll(&pfd, 1, gap_ms);
+        if (ready > 0 && (pfd.revents & POLLIN)) {
+            ssize_t n = read(bus->fd, frame + len, sizeof(frame) - len);
+            if (n > 0) {
+                len += (size_t)n;
+                continue;
+            }
+        }
+        if (len > 0) {
+            sim_handle_frame(bus, frame, len);
+            len = 0;
+        }
+    }
+    return NULL;
+}
+
+/* ============================ MASTER ============================ */
+
+/**
+ * @brief One request/response, as modbus_rtu_transact() does it
+ */
+static xfer_result_t master_transact(int fd, uint8_t address, uint8_t function,
+                                     uint16_t start, uint16_t count,
+                                     uint16_t *regs, uint8_t *exception_code)
+{
+    uint8_t frame[MODBUS_RTU_READ_RESPONSE_LEN(MODBUS_RTU_MAX_READ_REGS)];
+    size_t len = modbus_rtu_build_read_request(address, function, start, count, frame);
+    if (len == 0) {
+        return XFER_BAD_FRAME;
+    }
+
+    tcflush(fd, TCIFLUSH);
+    if (write(fd, frame, len) != (ssize_t)len) {
+        return XFER_BAD_FRAME;
+    }
+
+    int received = read_exact(fd, frame, MODBUS_RTU_EXCEPTION_LEN, SIM_RESPONSE_TIMEOUT_MS);
+    if (received < MODBUS_RTU_EXCEPTION_LEN) {
+        return XFER_TIMEOUT;
+    }
+    size_t expected = (frame[1] & MODBUS_RTU_FC_EXCEPTION_BIT) ?
+                      MODBUS_RTU_EXCEPTION_LEN : MODBUS_RTU_READ_RESPONSE_LEN(count);
+    if (expected > (size_t)received) {
+        int rest = read_exact(fd, frame + received, expected - received, SIM_RESPONSE_TIMEOUT_MS);
+        if (rest < (int)(expected - received)) {
+            return XFER_TIMEOUT;
+        }
+        received += rest;
+    }
+
+    switch (modbus_rtu_parse_read_response(frame, (size_t)received, address, function,
+                                           count, regs, exception_code)) {
+        case MODBUS_RTU_FRAME_OK:
+            return XFER_OK;
+        case MODBUS_RTU_FRAME_ERR_CRC:
+            return XFER_CRC;
+        case MODBUS_RTU_FRAME_ERR_EXCEPTION:
+            return XFER_EXCEPTION;
+        default:
+            return XFER_BAD_FRAME;
+    }
+}
+
+static int open_serial(const char *path)
+{
+    int fd = open(path, O_RDWR | O_NOCTTY);
+    if (fd < 0) {
+        return -1;
+    }
+    struct termios tio;
+    tcgetattr(fd, &tio);
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, B9600);
+    cfsetospeed(&tio, B9600);
+    tcsetattr(fd, TCSANOW, &tio);
+    return fd;
+}
+
+/* ============================ TESTS ============================ */
+
+static void test_frame_helpers(void)
+{
+    // Reference frames: 01 03 0000 0001 -> 84 0A, 11 03 006B 0003 -> 76 87
+    const uint8_t req1[] = { 0x01, 0x03, 0x00, 0x00, 0x00, 0x01 };
+    const uint8_t req2[] = { 0x11, 0x03, 0x00, 0x6B, 0x00, 0x03 };
+    CHECK_EQ_INT(modbus_rtu_crc16(req1, sizeof(req1)), 0x0A84);
+    CHECK_EQ_INT(modbus_rtu_crc16(req2, sizeof(req2)), 0x8776);
+
+    uint8_t frame[MODBUS_RTU_READ_REQUEST_LEN];
+    CHECK_EQ_INT(modbus_rtu_build_read_request(0x11, MODBUS_RTU_FC_READ_HOLDING, 0x006B, 3, frame),
+                 MODBUS_RTU_READ_REQUEST_LEN);
+    const uint8_t expected[] = { 0x11, 0x03, 0x00, 0x6B, 0x00, 0x03, 0x76, 0x87 };
+    CHECK(memcmp(frame, expected, sizeof(expected)) == 0);
+
+    CHECK_EQ_INT(modbus_rtu_build_read_request(0, MODBUS_RTU_FC_READ_HOLDING, 0, 1, frame), 0);
+    CHECK_EQ_INT(modbus_rtu_build_read_request(248, MODBUS_RTU_FC_READ_HOLDING, 0, 1, frame), 0);
+    CHECK_EQ_INT(modbus_rtu_build_read_request(1, MODBUS_RTU_FC_READ_HOLDING, 0, 0, frame), 0);
+    CHECK_EQ_INT(modbus_rtu_build_read_request(1, MODBUS_RTU_FC_READ_HOLDING, 0, 126, frame), 0);
+    CHECK_EQ_INT(modbus_rtu_build_read_request(1, 0x06, 0, 1, frame), 0);
+
+    uint16_t regs[2];
+    const uint8_t truncated[] = { 0x01, 0x03, 0x04, 0x00 };
+    CHECK_EQ_INT(modbus_rtu_parse_read_response(truncated, sizeof(truncated), 1,
+                                                MODBUS_RTU_FC_READ_HOLDING, 2, regs, NULL),
+                 MODBUS_RTU_FRAME_ERR_LENGTH);
+}
+
+static void test_bus(int fd, sim_bus_t *bus)
+{
+    uint16_t regs[SIM_REG_COUNT];
+    uint8_t exception = 0;
+
+    // Bus cycle: one request per probe, back to back with only the gap between
+    struct {
+        uint8_t address;
+        uint16_t start;
+        uint16_t count;
+    } cycle[] = { { 1, 0, 4 }, { 2, 0, SIM_REG_COUNT }, { 1, 4, 4 } };
+
+    for (size_t i = 0; i < sizeof(cycle) / sizeof(cycle[0]); i++) {
+        if (i > 0) {
+            usleep(bus->frame_gap_us);
+        }
+        memset(regs, 0, sizeof(regs));
+        CHECK_EQ_INT(master_transact(fd, cycle[i].address, MODBUS_RTU_FC_READ_HOLDING,
+                                     cycle[i].start, cycle[i].count, regs, &exception), XFER_OK);
+        for (uint16_t r = 0; r < cycle[i].count; r++) {
+            CHECK_EQ_INT(regs[r], sim_register_value(cycle[i].address, cycle[i].start + r));
+        }
+    }
+
+    usleep(bus->frame_gap_us);
+    CHECK_EQ_INT(master_transact(fd, 2, MODBUS_RTU_FC_READ_INPUT, 0, 2, regs, &exception), XFER_OK);
+
+    // Reading past the register map: exception 0x02 (5-byte reply)
+    usleep(bus->frame_gap_us);
+    exception = 0;
+    CHECK_EQ_INT(master_transact(fd, 1, MODBUS_RTU_FC_READ_HOLDING, 6, 4, regs, &exception),
+                 XFER_EXCEPTION);
+    CHECK_EQ_INT(exception, 0x02);
+
+    usleep(bus->frame_gap_us);
+    CHECK_EQ_INT(master_transact(fd, SIM_ADDR_CORRUPT_CRC, MODBUS_RTU_FC_READ_HOLDING, 0, 2,
+                                 regs, &exception), XFER_CRC);
+
+    usleep(bus->frame_gap_us);
+    CHECK_EQ_INT(master_transact(fd, SIM_ADDR_WRONG_REPLY, MODBUS_RTU_FC_READ_HOLDING, 0, 2,
+                                 regs, &exception), XFER_BAD_FRAME);
+
+    usleep(bus->frame_gap_us);
+    CHECK_EQ_INT(master_transact(fd, SIM_ADDR_ABSENT, MODBUS_RTU_FC_READ_HOLDING, 0, 2,
+                                 regs, &exception), XFER_TIMEOUT);
+
+    // The bus recovers after errors: no stale bytes reach the next transaction
+    usleep(bus->frame_gap_us);
+    CHECK_EQ_INT(master_transact(fd, 1, MODBUS_RTU_FC_READ_HOLDING, 0, 2, regs, &exception), XFER_OK);
+    CHECK_EQ_INT(regs[1], sim_register_value(1, 1));
+
+    pthread_mutex_lock(&bus->lock);
+    CHECK_EQ_INT(bus->frames, 9);
+    CHECK_EQ_INT(bus->bad_requests, 0);
+    pthread_mutex_unlock(&bus->lock);
+
+    // Two requests without the gap merge into one invalid frame: no reply
+    uint8_t two[2 * MODBUS_RTU_READ_REQUEST_LEN];
+    modbus_rtu_build_read_request(1, MODBUS_RTU_FC_READ_HOLDING, 0, 1, two);
+    modbus_rtu_build_read_request(2, MODBUS_RTU_FC_READ_HOLDING, 0, 1, two + MODBUS_RTU_READ_REQUEST_LEN);
+    usleep(bus->frame_gap_us);
+    CHECK(write(fd, two, sizeof(two)) == (ssize_t)sizeof(two));
+    uint8_t reply[MODBUS_RTU_EXCEPTION_LEN];
+    CHECK_EQ_INT(read_exact(fd, reply, sizeof(reply), SIM_RESPONSE_TIMEOUT_MS), 0);
+
+    pthread_mutex_lock(&bus->lock);
+    CHECK_EQ_INT(bus->frames, 10);
+    CHECK_EQ_INT(bus->bad_requests, 1);
+    pthread_mutex_unlock(&bus->lock);
+}
+
+int main(void)
+{
+    test_frame_helpers();
+
+    sim_bus_t bus = {
+        .frame_gap_us = frame_gap_us(SIM_BAUD_RATE),
+        .lock = PTHREAD_MUTEX_INITIALIZER,
+    };
+    bus.fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (bus.fd < 0 || grantpt(bus.fd) != 0 || unlockpt(bus.fd) != 0) {
+        perror("posix_openpt");
+        return 1;
+    }
+    int serial = open_serial(ptsname(bus.fd));
+    if (serial < 0) {
+        perror("open pty");
+        return 1;
+    }
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, sim_bus_thread, &bus);
+    test_bus(serial, &bus);
+    bus.stop = true;
+    pthread_join(thread, NULL);
+
+    close(serial);
+    close(bus.fd);
+    return HOST_TEST_RESULT("modbus_rtu_pty");
+}
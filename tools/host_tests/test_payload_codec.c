@@ -0,0 +1,249 @@
+/**
+ * @file test_payload_codec.c
+ * @brief Uptime field of the cached sensor payloads (payload_codec.c)
+ *
+ * payload_cache keeps a payload encoded once per sample, and GET /sensors
+ * replaces its encode-time uptime with the current one while sending.
+ * For both encodings the test splices a new uptime into a payload the
+ * way http_server.c does and checks the result is byte for byte the
+ * payload encoded with that uptime.
+ *
+ * cJSON is faked with a printer that follows cJSON_PrintPreallocated()
+ * with format = 1 (tab indent, "%d" for integral numbers that fit an int,
+ * "%1.15g" otherwise).
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "payload_codec.h"
+#include "cJSON.h"
+#include "host_test.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+/* ============================ FAKE cJSON ============================ */
+
+struct cJSON {
+    struct cJSON *next;
+    char name[24];
+    bool is_string;
+    double number;
+    char string[32];
+};
+
+static cJSON s_root;                    // Only one object is built at a time
+
+cJSON *cJSON_CreateObject(void)
+{
+    memset(&s_root, 0, sizeof(s_root));
+    return &s_root;
+}
+
+static cJSON *add_item(cJSON *object, const char *name)
+{
+    cJSON *item = calloc(1, sizeof(cJSON));
+    if (item == NULL) {
+        return NULL;
+    }
+    snprintf(item->name, sizeof(item->name), "%s", name);
+    cJSON **tail = &object->next;
+    while (*tail != NULL) {
+        tail = &(*tail)->next;
+    }
+    *tail = item;
+    return item;
+}
+
+cJSON *cJSON_AddNumberToObject(cJSON *const object, const char *const name, const double number)
+{
+    cJSON *item = add_item(object, name);
+    if (item != NULL) {
+        item->number = number;
+    }
+    return item;
+}
+
+cJSON *cJSON_AddStringToObject(cJSON *const object, const char *const name, const char *const string)
+{
+    cJSON *item = add_item(object, name);
+    if (item != NULL) {
+        item->is_string = true;
+        snprintf(item->string, sizeof(item->string), "%s", string);
+    }
+    return item;
+}
+
+cJSON_bool cJSON_PrintPreallocated(cJSON *item, char *buffer, const int length, const cJSON_bool format)
+{
+    CHECK(format);
+    int pos = snprintf(buffer, (size_t)length, "{\n");
+    for (cJSON *child = item->next; child != NULL && pos < length; child = child->next) {
+        const char *sep = (child->next != NULL) ? "," : "";
+        if (child->is_string) {
+            pos += snprintf(buffer + pos, (size_t)(length - pos), "\t\"%s\":\t\"%s\"%s\n",
+                            child->name, child->string, sep);
+        } else {
+            double d = child->number;
+            int valueint = (d >= INT_MAX) ? INT_MAX : (d <= INT_MIN) ? INT_MIN : (int)d;
+            if (d == (double)valueint) {
+                pos += snprintf(buffer + pos, (size_t)(length - pos), "\t\"%s\":\t%d%s\n",
+                                child->name, valueint, sep);
+            } else {
+                pos += snprintf(buffer + pos, (size_t)(length - pos), "\t\"%s\":\t%1.15g%s\n",
+                                child->name, d, sep);
+            }
+        }
+    }
+    if (pos < length) {
+        pos += snprintf(buffer + pos, (size_t)(length - pos), "}");
+    }
+    return pos < length;
+}
+
+void cJSON_Delete(cJSON *item)
+{
+    cJSON *child = item->next;
+    while (child != NULL) {
+        cJSON *next = child->next;
+        free(child);
+        child = next;
+    }
+    item->next = NULL;
+}
+
+/* These are not used by payload_codec.c */
+cJSON *cJSON_CreateNull(void) { return NULL; }
+cJSON *cJSON_CreateNumber(double num) { (void)num; return NULL; }
+cJSON *cJSON_AddNullToObject(cJSON *const object, const char *const name) { (void)object; (void)name; return NULL; }
+cJSON *cJSON_AddBoolToObject(cJSON *const object, const char *const name, const cJSON_bool boolean)
+{
+    (void)object; (void)name; (void)boolean;
+    return NULL;
+}
+cJSON *cJSON_AddArrayToObject(cJSON *const object, const char *const name) { (void)object; (void)name; return NULL; }
+cJSON_bool cJSON_AddItemToArray(cJSON *array, cJSON *item) { (void)array; (void)item; return 0; }
+
+/* ============================ HELPERS ============================ */
+
+#define PAYLOAD_SIZE            1536
+
+static sensor_reading_t make_reading(uint8_t channels)
+{
+    sensor_reading_t reading;
+    memset(&reading, 0, sizeof(reading));
+    snprintf(reading.device_ip, sizeof(reading.device_ip), "192.168.1.52");
+    reading.reading_id = 4242;
+    reading.ambient.temperature = 25.6f;
+    reading.ambient.humidity = 65.2f;
+    reading.soil.sensor_count = channels;
+    for (uint8_t i = 0; i < channels; i++) {
+        reading.soil.soil_humidity[i] = 40.0f + (float)i;
+        reading.soil.valid_mask |= (uint16_t)(1u << i);
+    }
+    reading.soil.timestamp = 1760670000;
+    return reading;
+}
+
+static size_t encode(const sensor_reading_t *reading, int64_t uptime_ms, bool binary, uint8_t *out)
+{
+    payload_codec_context_t ctx = {
+        .mac = { 0xE8, 0x6B, 0xEA, 0xF6, 0x81, 0xB8 },
+        .uptime_ms = uptime_ms,
+        .time_quality = "sntp",
+    };
+    return binary ? payload_codec_encode_binary(reading, &ctx, out, PAYLOAD_SIZE)
+                  : payload_codec_encode_json(reading, &ctx, out, PAYLOAD_SIZE);
+}
+
+/**
+ * @brief What GET /sensors sends: the bytes around the field, the new field
+ */
+static size_t splice_uptime(const uint8_t *payload, size_t len, bool binary, int64_t uptime_ms,
+                            uint8_t *out)
+{
+    size_t offset = 0;
+    size_t field_len = 0;
+    uint8_t field[PAYLOAD_UPTIME_MAX_SIZE];
+
+    CHECK(payload_codec_find_uptime(payload, len, binary, &offset, &field_len));
+    size_t new_len = payload_codec_encode_uptime(uptime_ms, binary, field, sizeof(field));
+    CHECK(new_len > 0);
+
+    memcpy(out, payload, offset);
+    memcpy(out + offset, field, new_len);
+    memcpy(out + offset + new_len, payload + offset + field_len, len - offset - field_len);
+    return len - field_len + new_len;
+}
+
+/* ============================ TESTS ============================ */
+
+static void test_splice(bool binary)
+{
+    // Encode-time and send-time uptimes with different digit counts
+    static const int64_t uptimes[] = { 0, 7, 999, 1000, 65432, 3600000,
+                                       2147483647LL, 2147483648LL, 86400000LL * 400 };
+    const int count = (int)(sizeof(uptimes) / sizeof(uptimes[0]));
+    static uint8_t cached[PAYLOAD_SIZE];
+    static uint8_t sent[PAYLOAD_SIZE];
+    static uint8_t fresh[PAYLOAD_SIZE];
+
+    for (uint8_t channels = 1; channels <= SOIL_MAX_SENSORS; channels += 5) {
+        sensor_reading_t reading = make_reading(channels);
+        for (int a = 0; a < count; a++) {
+            size_t cached_len = encode(&reading, uptimes[a], binary, cached);
+            CHECK(cached_len > 0);
+            for (int b = 0; b < count; b++) {
+                size_t sent_len = splice_uptime(cached, cached_len, binary, uptimes[b], sent);
+                size_t fresh_len = encode(&reading, uptimes[b], binary, fresh);
+                CHECK_EQ_INT(sent_len, fresh_len);
+                CHECK(sent_len == fresh_len && memcmp(sent, fresh, sent_len) == 0);
+            }
+        }
+    }
+}
+
+static void test_find_uptime(void)
+{
+    size_t offset = 99;
+    size_t field_len = 99;
+    static uint8_t payload[PAYLOAD_SIZE];
+    sensor_reading_t reading = make_reading(3);
+
+    size_t len = encode(&reading, 3600000, false, payload);
+    CHECK(payload_codec_find_uptime(payload, len, false, &offset, &field_len));
+    CHECK_EQ_INT(field_len, 7);
+    CHECK(memcmp(payload + offset, "3600000", 7) == 0);
+
+    len = encode(&reading, 3600000, true, payload);
+    CHECK(payload_codec_find_uptime(payload, len, true, &offset, &field_len));
+    CHECK_EQ_INT(offset, PAYLOAD_BINARY_UPTIME_OFFSET);
+    CHECK_EQ_INT(field_len, 4);
+    CHECK_EQ_INT(payload[offset] | (payload[offset + 1] << 8), 3600);
+
+    // Not a payload, truncated, or without a value
+    static const char *bad[] = { "{}", "{\"uptime_ms\":", "{\"uptime_ms\":\t}", "\"uptime_ms\"" };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        CHECK(!payload_codec_find_uptime((const uint8_t*)bad[i], strlen(bad[i]), false,
+                                         &offset, &field_len));
+    }
+    CHECK(!payload_codec_find_uptime(payload, PAYLOAD_BINARY_HEADER_SIZE - 1, true, &offset, &field_len));
+    CHECK(!payload_codec_find_uptime(NULL, 10, false, &offset, &field_len));
+
+    uint8_t small[3];
+    CHECK_EQ_INT(payload_codec_encode_uptime(1234, false, small, sizeof(small)), 0);
+    CHECK_EQ_INT(payload_codec_encode_uptime(1234, true, small, sizeof(small)), 0);
+}
+
+int main(void)
+{
+    test_find_uptime();
+    test_splice(false);
+    test_splice(true);
+    return HOST_TEST_RESULT("payload_codec");
+}
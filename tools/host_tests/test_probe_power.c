@@ -0,0 +1,336 @@
+/**
+ * @file test_probe_power.c
+ * @brief Probe group sequencing and excitation timing of probe_power.c
+ *
+ * probe_power.c is compiled unchanged against the shim headers. GPIO
+ * levels are logged with the time of every edge on a virtual clock, and
+ * vTaskDelay(n) returns as early as FreeRTOS allows (n - 1 ticks plus a
+ * microsecond), so a rounding error in the settle wait shows up. A fake
+ * scan follows sensor_reader: prepare, the ambient read, then
+ * channel_begin / sample / channel_end for each channel and all_off.
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "probe_power.h"
+#include "driver/gpio.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "host_test.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* ============================ FAKE GPIO AND CLOCK ============================ */
+
+#define FAKE_GPIO_COUNT         40
+#define SAMPLE_US               1000    // One ADC channel read
+
+static int64_t s_now_us;
+static int s_level[FAKE_GPIO_COUNT];            // -1 = never driven
+static int64_t s_edge_us[FAKE_GPIO_COUNT];      // Time of the last level change
+static bool s_hold[FAKE_GPIO_COUNT];
+static bool s_deep_sleep_hold;
+static uint64_t s_output_mask;
+static int s_gpio_calls;
+static int s_delays;
+
+static void fake_reset(void)
+{
+    s_now_us = 1000000;
+    for (int i = 0; i < FAKE_GPIO_COUNT; i++) {
+        s_level[i] = -1;
+        s_edge_us[i] = 0;
+        s_hold[i] = false;
+    }
+    s_deep_sleep_hold = false;
+    s_output_mask = 0;
+    s_gpio_calls = 0;
+    s_delays = 0;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return s_now_us;
+}
+
+void vTaskDelay(const TickType_t xTicksToDelay)
+{
+    // Worst case: the first tick interrupt arrives right after the call
+    s_delays++;
+    if (xTicksToDelay > 0) {
+        s_now_us += (int64_t)(xTicksToDelay - 1) * portTICK_PERIOD_MS * 1000 + 1;
+    }
+}
+
+esp_err_t gpio_config(const gpio_config_t *pGPIOConfig)
+{
+    s_gpio_calls++;
+    if (pGPIOConfig->mode == GPIO_MODE_OUTPUT) {
+        s_output_mask |= pGPIOConfig->pin_bit_mask;
+    }
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level)
+{
+    s_gpio_calls++;
+    CHECK(gpio_num >= 0 && gpio_num < FAKE_GPIO_COUNT);
+    CHECK(s_output_mask & (1ULL << gpio_num));
+    CHECK(!s_hold[gpio_num]);
+    if (s_level[gpio_num] != (int)level) {
+        s_level[gpio_num] = (int)level;
+        s_edge_us[gpio_num] = s_now_us;
+    }
+    return ESP_OK;
+}
+
+esp_err_t gpio_hold_en(gpio_num_t gpio_num)
+{
+    s_gpio_calls++;
+    s_hold[gpio_num] = true;
+    return ESP_OK;
+}
+
+esp_err_t gpio_hold_dis(gpio_num_t gpio_num)
+{
+    s_gpio_calls++;
+    s_hold[gpio_num] = false;
+    return ESP_OK;
+}
+
+void gpio_deep_sleep_hold_en(void)
+{
+    s_deep_sleep_hold = true;
+}
+
+void gpio_deep_sleep_hold_dis(void)
+{
+    s_deep_sleep_hold = false;
+}
+
+/* ============================ SCAN ============================ */
+
+typedef struct {
+    int samples;
+    int unsettled;                  // Sampled before settle_ms of power
+    int unpowered;                  // Sampled with the rail off
+    int max_rails_on;
+    int64_t scan_us;
+    uint8_t ever_on;                // Groups powered during the scan
+} scan_result_t;
+
+static bool rail_on(const probe_power_config_t *config, uint8_t group)
+{
+    int level = s_level[config->gpio[group]];
+    return level == (config->active_low ? 0 : 1);
+}
+
+static int rails_on(const probe_power_config_t *config, scan_result_t *result)
+{
+    int count = 0;
+    for (uint8_t g = 0; g < config->group_count; g++) {
+        if (rail_on(config, g)) {
+            count++;
+            result->ever_on |= (uint8_t)(1u << g);
+        }
+    }
+    return count;
+}
+
+static uint8_t expected_group(const probe_power_config_t *config, uint8_t channel)
+{
+    uint8_t group = channel / config->group_size;
+    return (group < config->group_count) ? group : (uint8_t)(config->group_count - 1);
+}
+
+/**
+ * @brief One sensor_reader_get_all() acquisition
+ *
+ * @param ambient_us Time spent on the ambient sensor between prepare and the soil scan
+ */
+static void run_scan(const probe_power_config_t *config, uint8_t channels, int64_t ambient_us,
+                     scan_result_t *result)
+{
+    memset(result, 0, sizeof(*result));
+    int64_t start_us = s_now_us;
+
+    probe_power_prepare(channels);
+    s_now_us += ambient_us;
+
+    for (uint8_t ch = 0; ch < channels; ch++) {
+        probe_power_channel_begin(ch);
+
+        uint8_t group = expected_group(config, ch);
+        int on = rails_on(config, result);
+        result->max_rails_on = (on > result->max_rails_on) ? on : result->max_rails_on;
+        if (!rail_on(config, group)) {
+            result->unpowered++;
+        } else if (s_now_us - s_edge_us[config->gpio[group]] < (int64_t)config->settle_ms * 1000) {
+            result->unsettled++;
+        }
+        s_now_us += SAMPLE_US;
+        result->samples++;
+
+        probe_power_channel_end(ch);
+    }
+    probe_power_all_off();
+    result->scan_us = s_now_us - start_us;
+}
+
+static bool all_rails_off(const probe_power_config_t *config)
+{
+    for (uint8_t g = 0; g < config->group_count; g++) {
+        if (s_level[config->gpio[g]] != (config->active_low ? 1 : 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* ============================ TESTS ============================ */
+
+static void test_uninitialized(void)
+{
+    fake_reset();
+
+    // Never initialized: every call is a no-op, hold has nothing to hold
+    CHECK_EQ_INT(probe_power_hold_on(), ESP_ERR_INVALID_STATE);
+    probe_power_prepare(4);
+    probe_power_channel_begin(0);
+    probe_power_channel_end(0);
+    probe_power_all_off();
+    CHECK_EQ_INT(probe_power_deinit(), ESP_OK);
+    CHECK_EQ_INT(s_gpio_calls, 0);
+    CHECK_EQ_INT(s_delays, 0);
+
+    probe_power_config_t bad = { .gpio = { 4, -1 }, .group_count = 2, .group_size = 2, .settle_ms = 10 };
+    CHECK_EQ_INT(probe_power_init(NULL), ESP_ERR_INVALID_ARG);
+    CHECK_EQ_INT(probe_power_init(&bad), ESP_ERR_INVALID_ARG);
+    bad.group_count = 0;
+    CHECK_EQ_INT(probe_power_init(&bad), ESP_ERR_INVALID_ARG);
+    bad.group_count = PROBE_POWER_MAX_GROUPS + 1;
+    CHECK_EQ_INT(probe_power_init(&bad), ESP_ERR_INVALID_ARG);
+    bad.group_count = 1;
+    bad.group_size = 0;
+    CHECK_EQ_INT(probe_power_init(&bad), ESP_ERR_INVALID_ARG);
+    CHECK_EQ_INT(s_gpio_calls, 0);
+}
+
+static void test_settle_and_overlap(void)
+{
+    // Three groups of two, 25 ms settle: not a multiple of the 10 ms tick
+    probe_power_config_t config = {
+        .gpio = { 4, 5, 18 },
+        .group_count = 3,
+        .group_size = 2,
+        .active_low = false,
+        .settle_ms = 25,
+    };
+    scan_result_t result;
+
+    fake_reset();
+    s_hold[4] = true;                           // Left latched by a ULP hand-off
+    s_deep_sleep_hold = true;
+    CHECK_EQ_INT(probe_power_init(&config), ESP_OK);
+    CHECK(!s_hold[4]);
+    CHECK(!s_deep_sleep_hold);
+    CHECK(all_rails_off(&config));
+
+    // Ambient read shorter than the settle time: the wait covers the rest
+    run_scan(&config, 6, 5000, &result);
+    CHECK_EQ_INT(result.samples, 6);
+    CHECK_EQ_INT(result.unpowered, 0);
+    CHECK_EQ_INT(result.unsettled, 0);
+    CHECK_EQ_INT(result.max_rails_on, 2);       // Current group + the next one settling
+    CHECK_EQ_INT(result.ever_on, 0x07);
+    CHECK(all_rails_off(&config));
+    // Next groups settle while the previous one is sampled: well under 3 x 25 ms
+    CHECK(result.scan_us < 2 * 25000 + 20000);
+
+    // Ambient read longer than the settle time: group 0 is sampled at once
+    int delays = s_delays;
+    run_scan(&config, 2, 30000, &result);
+    CHECK_EQ_INT(result.unsettled, 0);
+    CHECK_EQ_INT(s_delays, delays);
+    CHECK_EQ_INT(result.ever_on, 0x01);         // Group 1 is past the scan: never powered
+
+    // Every settle time against the worst-case early tick
+    for (uint32_t settle_ms = 1; settle_ms <= 60; settle_ms++) {
+        config.settle_ms = settle_ms;
+        CHECK_EQ_INT(probe_power_init(&config), ESP_OK);
+        run_scan(&config, 6, 0, &result);
+        CHECK_EQ_INT(result.unsettled, 0);
+        CHECK_EQ_INT(result.unpowered, 0);
+    }
+    CHECK_EQ_INT(probe_power_deinit(), ESP_OK);
+}
+
+static void test_grouping_and_polarity(void)
+{
+    // Two groups of two, active low: channel 4 falls into the last group
+    probe_power_config_t config = {
+        .gpio = { 12, 13 },
+        .group_count = 2,
+        .group_size = 2,
+        .active_low = true,
+        .settle_ms = 10,
+    };
+    scan_result_t result;
+
+    fake_reset();
+    CHECK_EQ_INT(probe_power_init(&config), ESP_OK);
+    CHECK_EQ_INT(s_level[12], 1);               // Off = high for a P-channel switch
+    CHECK_EQ_INT(s_level[13], 1);
+
+    run_scan(&config, 5, 0, &result);
+    CHECK_EQ_INT(result.samples, 5);
+    CHECK_EQ_INT(result.unpowered, 0);
+    CHECK_EQ_INT(result.unsettled, 0);
+    CHECK(all_rails_off(&config));
+
+    // Group 0 goes down after its last channel, while group 1 is still on
+    probe_power_prepare(5);
+    probe_power_channel_begin(1);
+    CHECK(rail_on(&config, 0));
+    CHECK(rail_on(&config, 1));
+    probe_power_channel_end(1);
+    CHECK(!rail_on(&config, 0));
+    CHECK(rail_on(&config, 1));
+    probe_power_channel_begin(4);
+    probe_power_channel_end(4);
+    CHECK(all_rails_off(&config));
+
+    // Error path: all_off mid-scan drops everything
+    probe_power_prepare(5);
+    probe_power_channel_begin(0);
+    probe_power_all_off();
+    CHECK(all_rails_off(&config));
+
+    // ULP hand-off: rails on and latched, even after deinit
+    CHECK_EQ_INT(probe_power_deinit(), ESP_OK);
+    CHECK_EQ_INT(probe_power_hold_on(), ESP_OK);
+    CHECK(rail_on(&config, 0));
+    CHECK(rail_on(&config, 1));
+    CHECK(s_hold[12] && s_hold[13]);
+    CHECK(s_deep_sleep_hold);
+
+    // The next boot's init releases the hold and powers down
+    CHECK_EQ_INT(probe_power_init(&config), ESP_OK);
+    CHECK(!s_hold[12] && !s_hold[13]);
+    CHECK(!s_deep_sleep_hold);
+    CHECK(all_rails_off(&config));
+    CHECK_EQ_INT(probe_power_deinit(), ESP_OK);
+}
+
+int main(void)
+{
+    test_uninitialized();
+    test_settle_and_overlap();
+    test_grouping_and_polarity();
+    return HOST_TEST_RESULT("probe_power");
+}
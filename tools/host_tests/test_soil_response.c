@@ -0,0 +1,281 @@
+/**
+ * @file test_soil_response.c
+ * @brief Overshoot simulation of the learned soil response model
+ *
+ * Runs the same sequence of sessions twice against a simulated soil,
+ * once stopping on the optimal threshold only (model disabled) and once
+ * with soil_response_model.c planning the duration the way the
+ * controller does: closed loop until CONFIG_IRRIGATION_SOIL_MODEL_MIN_SESSIONS
+ * sessions are learned, then a planned duration, evaluations every 60 s
+ * and one verification sample at the end.
+ *
+ * The soil has two stores: water enters a surface store and reaches the
+ * probes with a 6 min time constant, so a session stopped when the probes
+ * reach the threshold keeps rising after the valve closes. Overshoot is
+ * the settled level 30 min after the valve closes minus the optimal
+ * threshold. Both runs print their mean overshoot and evaluations per
+ * session.
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "soil_response_model.h"
+#include "host_test.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+/* ============================ SIMULATION ============================ */
+
+// Controller defaults (irrigation_controller.c / Kconfig)
+#define SOIL_OPTIMAL            70.0f
+#define MAX_DURATION_MIN        120.0f
+#define MODEL_MIN_SESSIONS      3
+#define MODEL_SOAK_S            (10 * 60)
+#define MODEL_FORGETTING        0.90f
+#define MODEL_VERIFY_TOLERANCE  5.0f
+#define IRRIGATING_SAMPLE_S     5               // SENSOR_SCHED_IRRIGATING_SOIL_MS
+#define PLANNED_EVAL_S          60              // Planned sessions wake at most every 60 s
+
+// Soil
+#define SIM_SESSIONS            40
+#define SOIL_LAG_MIN            6.0f            // Surface store -> probes time constant
+#define SOIL_INFLOW_PER_MIN     1.15f           // Nominal rise per irrigation minute, once soaked
+#define SOIL_ET_PER_MIN         0.01f
+#define SOIL_SETTLE_S           (30 * 60)
+
+typedef struct {
+    float surface;                  // Water on its way to the probes (soil % equivalent)
+    float root;                     // What the probes see
+    uint32_t lcg;
+} soil_t;
+
+typedef struct {
+    float start;                    // Soil when the session starts
+    float inflow;                   // Rise per minute for this session (line pressure)
+} session_t;
+
+typedef struct {
+    float overshoot_sum;
+    int overshoot_sessions;
+    int evaluations;
+    int planned_evaluations;        // Evaluations of the planned sessions only
+    int sessions;
+    int planned_sessions;
+    int verify_failures;
+    float worst_undershoot;
+} run_result_t;
+
+static float sim_random(uint32_t *lcg)
+{
+    *lcg = *lcg * 1103515245u + 12345u;
+    return (float)((*lcg >> 8) & 0xFFFF) / 65535.0f;   // 0..1
+}
+
+/**
+ * @brief Advance the soil one second
+ */
+static void soil_step(soil_t *soil, bool valve_open, float inflow)
+{
+    const float dt_min = 1.0f / 60.0f;
+    float flux = soil->surface * dt_min / SOIL_LAG_MIN;
+
+    if (valve_open) {
+        soil->surface += inflow * dt_min;
+    }
+    soil->surface -= flux;
+    soil->root += flux - SOIL_ET_PER_MIN * dt_min;
+}
+
+/**
+ * @brief Probe reading: root store plus +/-0.5% noise
+ */
+static float soil_read(soil_t *soil)
+{
+    return soil->root + (sim_random(&soil->lcg) - 0.5f);
+}
+
+static void make_sessions(session_t sessions[SIM_SESSIONS])
+{
+    uint32_t lcg = 2026;
+    for (int i = 0; i < SIM_SESSIONS; i++) {
+        sessions[i].start = 40.0f + 15.0f * sim_random(&lcg);
+        sessions[i].inflow = SOIL_INFLOW_PER_MIN * (0.95f + 0.10f * sim_random(&lcg));
+    }
+}
+
+/**
+ * @brief Run every session; @p use_model false = threshold stop only
+ */
+static void run_sessions(const session_t sessions[SIM_SESSIONS], bool use_model, run_result_t *result)
+{
+    soil_response_model_t model;
+    soil_response_model_reset(&model);
+    *result = (run_result_t){ 0 };
+
+    for (int i = 0; i < SIM_SESSIONS; i++) {
+        soil_t soil = { .surface = 0.0f, .root = sessions[i].start, .lcg = 77u + (uint32_t)i };
+        float start_reading = soil_read(&soil);
+
+        float planned_min = 0.0f;
+        if (use_model && soil_response_model_ready(&model, MODEL_MIN_SESSIONS)) {
+            planned_min = ceilf(soil_response_model_plan(&model, start_reading, SOIL_OPTIMAL,
+                                                         MAX_DURATION_MIN));
+            result->planned_sessions++;
+        }
+
+        // Valve open: evaluate on every fast sample (closed loop) or every
+        // 60 s until the planned end, then on one verification sample
+        bool session_planned = planned_min > 0.0f;
+        int evaluations = 0;
+        int elapsed_s = 0;
+        int next_eval_s = planned_min > 0.0f ? PLANNED_EVAL_S : IRRIGATING_SAMPLE_S;
+        float stop_reading = start_reading;
+        bool open = true;
+        while (open) {
+            soil_step(&soil, true, sessions[i].inflow);
+            elapsed_s++;
+            if (elapsed_s < next_eval_s) {
+                continue;
+            }
+
+            float reading = soil_read(&soil);
+            float elapsed_min = (float)elapsed_s / 60.0f;
+            bool plan_due = planned_min > 0.0f && elapsed_min >= planned_min;
+            evaluations++;
+
+            if (reading >= SOIL_OPTIMAL || elapsed_min >= MAX_DURATION_MIN) {
+                open = false;
+            } else if (plan_due) {
+                float expected = start_reading + soil_response_model_immediate_gain(&model) * elapsed_min;
+                if (reading >= expected - MODEL_VERIFY_TOLERANCE) {
+                    open = false;
+                } else {
+                    planned_min = 0.0f;         // Back to the threshold stop
+                    result->verify_failures++;
+                }
+            }
+            stop_reading = reading;
+
+            if (planned_min > 0.0f) {
+                int plan_end_s = (int)(planned_min * 60.0f);
+                int wake_s = elapsed_s + PLANNED_EVAL_S;
+                // Past the planned end: one fresh fast sample to verify
+                next_eval_s = (wake_s < plan_end_s) ? wake_s
+                            : ((elapsed_s < plan_end_s) ? plan_end_s + IRRIGATING_SAMPLE_S
+                                                        : elapsed_s + IRRIGATING_SAMPLE_S);
+            } else {
+                next_eval_s = elapsed_s + IRRIGATING_SAMPLE_S;
+            }
+        }
+
+        result->evaluations += evaluations;
+        if (session_planned) {
+            result->planned_evaluations += evaluations;
+        }
+
+        // Soak, learn, then let the soil settle
+        for (int s = 0; s < MODEL_SOAK_S; s++) {
+            soil_step(&soil, false, 0.0f);
+        }
+        soil_response_observation_t obs = {
+            .minutes = (float)elapsed_s / 60.0f,
+            .soil_start = start_reading,
+            .soil_stop = stop_reading,
+            .soil_soaked = soil_read(&soil),
+        };
+        soil_response_model_update(&model, &obs, MODEL_FORGETTING);
+
+        for (int s = MODEL_SOAK_S; s < SOIL_SETTLE_S; s++) {
+            soil_step(&soil, false, 0.0f);
+        }
+        float overshoot = soil.root - SOIL_OPTIMAL;
+        result->sessions++;
+        if (i >= MODEL_MIN_SESSIONS) {          // Same sessions in both runs
+            result->overshoot_sum += overshoot;
+            result->overshoot_sessions++;
+        }
+        if (-overshoot > result->worst_undershoot) {
+            result->worst_undershoot = -overshoot;
+        }
+    }
+}
+
+/* ============================ TESTS ============================ */
+
+static void test_model_fit(void)
+{
+    soil_response_model_t model;
+    soil_response_model_reset(&model);
+    CHECK(soil_response_model_is_valid(&model));
+    CHECK(!soil_response_model_ready(&model, 1));
+    CHECK_EQ_INT(soil_response_model_plan(&model, 50.0f, 70.0f, 90.0f), 90);
+
+    // Rejected: too short, soil did not rise
+    soil_response_observation_t short_obs = { 0.5f, 50.0f, 51.0f, 52.0f };
+    soil_response_observation_t dry_obs = { 20.0f, 50.0f, 49.0f, 49.5f };
+    CHECK(!soil_response_model_update(&model, &short_obs, 0.9f));
+    CHECK(!soil_response_model_update(&model, &dry_obs, 0.9f));
+    CHECK_EQ_INT(model.sessions, 0);
+
+    // Exact line through the origin: 1 %/min soaked, 0.7 %/min immediate
+    for (int i = 1; i <= 3; i++) {
+        float t = 10.0f * (float)i;
+        soil_response_observation_t obs = { t, 40.0f, 40.0f + 0.7f * t, 40.0f + t };
+        CHECK(soil_response_model_update(&model, &obs, 0.9f));
+    }
+    CHECK(soil_response_model_ready(&model, 3));
+    CHECK_NEAR(soil_response_model_gain(&model), 1.0f, 1e-4f);
+    CHECK_NEAR(soil_response_model_immediate_gain(&model), 0.7f, 1e-4f);
+    CHECK_NEAR(soil_response_model_residual(&model), 0.0f, 1e-2f);
+    CHECK_NEAR(soil_response_model_plan(&model, 55.0f, 70.0f, 90.0f), 15.0f, 1e-3f);
+    CHECK_NEAR(soil_response_model_plan(&model, 69.8f, 70.0f, 90.0f), SOIL_RESPONSE_MIN_MINUTES, 1e-6f);
+    CHECK_NEAR(soil_response_model_plan(&model, 0.0f, 70.0f, 30.0f), 30.0f, 1e-6f);
+    CHECK_NEAR(soil_response_model_plan(&model, 71.0f, 70.0f, 30.0f), 0.0f, 1e-6f);
+
+    // Forgetting: the gain follows a change in infiltration
+    for (int i = 0; i < 30; i++) {
+        soil_response_observation_t obs = { 20.0f, 40.0f, 47.0f, 50.0f };   // 0.5 %/min
+        soil_response_model_update(&model, &obs, 0.9f);
+    }
+    CHECK_NEAR(soil_response_model_gain(&model), 0.5f, 0.02f);
+}
+
+static void test_overshoot(void)
+{
+    session_t sessions[SIM_SESSIONS];
+    run_result_t threshold;
+    run_result_t planned;
+
+    make_sessions(sessions);
+    run_sessions(sessions, false, &threshold);
+    run_sessions(sessions, true, &planned);
+
+    float threshold_overshoot = threshold.overshoot_sum / (float)threshold.overshoot_sessions;
+    float planned_overshoot = planned.overshoot_sum / (float)planned.overshoot_sessions;
+    float threshold_evals = (float)threshold.evaluations / (float)threshold.sessions;
+    float planned_evals = (float)planned.evaluations / (float)planned.sessions;
+    float per_plan_evals = (float)planned.planned_evaluations / (float)planned.planned_sessions;
+
+    printf("soil_response: mean overshoot %.2f%% -> %.2f%%, evaluations/session %.0f -> %.0f "
+           "(%.0f per planned session), verify failures %d\n", threshold_overshoot, planned_overshoot,
+           threshold_evals, planned_evals, per_plan_evals, planned.verify_failures);
+
+    CHECK_EQ_INT(planned.planned_sessions, SIM_SESSIONS - MODEL_MIN_SESSIONS);
+    CHECK_EQ_INT(planned.verify_failures, 0);
+    CHECK(threshold_overshoot > 5.0f);                  // ~ inflow * lag
+    CHECK(planned_overshoot < 2.0f);
+    CHECK(planned_overshoot > -1.0f);
+    CHECK(planned.worst_undershoot < 2.0f);
+    CHECK(planned_evals < threshold_evals / 5.0f);
+}
+
+int main(void)
+{
+    test_model_fit();
+    test_overshoot();
+    return HOST_TEST_RESULT("soil_response");
+}
@@ -0,0 +1,210 @@
+/**
+ * @file test_ulp_soil_model.c
+ * @brief Wake thresholds, filter hysteresis and heartbeat of the ULP soil model
+ *
+ * ulp_soil_model.c mirrors ulp/soil_monitor.S in 16-bit arithmetic, so
+ * these checks pin down what the ULP does during deep sleep: strict
+ * boundaries, the first-order filter that keeps noise and short spikes
+ * from waking the CPU, the heartbeat count and per-channel scaling.
+ *
+ * @author Liwaisi Tech
+ * @date 2026-10-17
+ * @version 1.0.0
+ */
+
+#include "ulp_soil_model.h"
+#include "host_test.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ALL_CHANNELS    0x07
+
+/**
+ * @brief Sample for @p raw on every channel of @p mask (4 conversions each)
+ */
+static uint16_t sample_of(uint16_t raw, uint8_t mask)
+{
+    uint16_t sums[ULP_SOIL_MAX_CHANNELS];
+    for (int i = 0; i < ULP_SOIL_MAX_CHANNELS; i++) {
+        sums[i] = (uint16_t)(raw << ULP_SOIL_OVERSAMPLE_SHIFT);
+    }
+    return ulp_soil_model_sample(sums, mask);
+}
+
+/**
+ * @brief Steps until a wake (0 if none within @p max_steps)
+ */
+static int steps_to_wake(ulp_soil_model_state_t *state, const ulp_soil_model_config_t *config,
+                         uint16_t sample, int max_steps, ulp_soil_wake_reason_t *reason)
+{
+    for (int i = 1; i <= max_steps; i++) {
+        *reason = ulp_soil_model_step(state, config, sample);
+        if (*reason != ULP_SOIL_WAKE_NONE) {
+            return i;
+        }
+    }
+    *reason = ULP_SOIL_WAKE_NONE;
+    return 0;
+}
+
+static void test_channel_scaling(void)
+{
+    CHECK_EQ_INT(ulp_soil_model_channel_count(0x00), 0);
+    CHECK_EQ_INT(ulp_soil_model_channel_count(0x05), 2);
+    CHECK_EQ_INT(ulp_soil_model_channel_count(0xFF), ULP_SOIL_MAX_CHANNELS);
+
+    // A sample is the sum of per-channel averages, thresholds scale alike
+    CHECK_EQ_INT(sample_of(2000, ALL_CHANNELS), 6000);
+    CHECK_EQ_INT(ulp_soil_model_threshold(2000, ALL_CHANNELS), 6000);
+    CHECK_EQ_INT(sample_of(2000, 0x01), ulp_soil_model_threshold(2000, 0x01));
+
+    const uint16_t sums[ULP_SOIL_MAX_CHANNELS] = { 4000, 8000, 12000 };
+    CHECK_EQ_INT(ulp_soil_model_sample(sums, 0x05), (4000 + 12000) >> ULP_SOIL_OVERSAMPLE_SHIFT);
+
+    // Full scale on all channels still fits the 16-bit filter
+    CHECK_EQ_INT(ulp_soil_model_threshold(0xFFFF, ALL_CHANNELS), 0xFFFF);
+    ulp_soil_model_config_t config = {
+        .wake_above = ULP_SOIL_WAKE_ABOVE_DISABLED,
+        .wake_below = ULP_SOIL_WAKE_BELOW_DISABLED,
+        .heartbeat_samples = 1000,
+    };
+    ulp_soil_model_state_t state;
+    ulp_soil_model_reset(&state, &config);
+    uint16_t max_sample = sample_of(ULP_SOIL_RAW_MAX, ALL_CHANNELS);
+    for (int i = 0; i < 50; i++) {
+        CHECK_EQ_INT(ulp_soil_model_step(&state, &config, max_sample), ULP_SOIL_WAKE_NONE);
+    }
+    CHECK_EQ_INT(state.filtered, max_sample);
+}
+
+static void test_boundaries(void)
+{
+    ulp_soil_model_config_t config = {
+        .wake_above = ulp_soil_model_threshold(2500, ALL_CHANNELS),
+        .wake_below = ulp_soil_model_threshold(1500, ALL_CHANNELS),
+        .heartbeat_samples = 1000,
+    };
+    ulp_soil_model_state_t state;
+    ulp_soil_wake_reason_t reason;
+
+    // Strict comparisons: sitting exactly on a boundary never wakes
+    ulp_soil_model_reset(&state, &config);
+    CHECK_EQ_INT(steps_to_wake(&state, &config, config.wake_above, 200, &reason), 0);
+    ulp_soil_model_reset(&state, &config);
+    CHECK_EQ_INT(steps_to_wake(&state, &config, config.wake_below, 200, &reason), 0);
+
+    // The first sample loads the filter directly: out of band wakes at once
+    ulp_soil_model_reset(&state, &config);
+    CHECK_EQ_INT(steps_to_wake(&state, &config, config.wake_above + 1, 10, &reason), 1);
+    CHECK_EQ_INT(reason, ULP_SOIL_WAKE_DRY);
+    ulp_soil_model_reset(&state, &config);
+    CHECK_EQ_INT(steps_to_wake(&state, &config, config.wake_below - 1, 10, &reason), 1);
+    CHECK_EQ_INT(reason, ULP_SOIL_WAKE_WET);
+
+    // Disabled sides never wake
+    ulp_soil_model_config_t open_band = config;
+    open_band.wake_above = ULP_SOIL_WAKE_ABOVE_DISABLED;
+    open_band.wake_below = ULP_SOIL_WAKE_BELOW_DISABLED;
+    ulp_soil_model_reset(&state, &open_band);
+    CHECK_EQ_INT(steps_to_wake(&state, &open_band, 0, 100, &reason), 0);
+    CHECK_EQ_INT(steps_to_wake(&state, &open_band, sample_of(ULP_SOIL_RAW_MAX, ALL_CHANNELS), 100, &reason), 0);
+}
+
+static void test_filter_hysteresis(void)
+{
+    ulp_soil_model_config_t config = {
+        .wake_above = 6000,
+        .wake_below = 3000,
+        .heartbeat_samples = 0xFFFF,
+    };
+    ulp_soil_model_state_t state;
+    ulp_soil_wake_reason_t reason;
+
+    // A single spike well past the boundary is absorbed: (3 * 5000 + 8000) / 4 = 5750
+    ulp_soil_model_reset(&state, &config);
+    CHECK_EQ_INT(ulp_soil_model_step(&state, &config, 5000), ULP_SOIL_WAKE_NONE);
+    CHECK_EQ_INT(ulp_soil_model_step(&state, &config, 8000), ULP_SOIL_WAKE_NONE);
+    CHECK_EQ_INT(state.filtered, 5750);
+    CHECK_EQ_INT(steps_to_wake(&state, &config, 5000, 50, &reason), 0);
+
+    // A sustained step wakes after the filter has moved: 5000 -> 6500
+    // filtered 5375, 5656, 5867, 6025 -> wakes on the 4th sample
+    ulp_soil_model_reset(&state, &config);
+    ulp_soil_model_step(&state, &config, 5000);
+    CHECK_EQ_INT(steps_to_wake(&state, &config, 6500, 50, &reason), 4);
+    CHECK_EQ_INT(reason, ULP_SOIL_WAKE_DRY);
+    CHECK(state.filtered > config.wake_above);
+
+    // Wet side, same filter: 4000 -> 2000 (3500, 3125, 2843)
+    ulp_soil_model_reset(&state, &config);
+    ulp_soil_model_step(&state, &config, 4000);
+    CHECK_EQ_INT(steps_to_wake(&state, &config, 2000, 50, &reason), 3);
+    CHECK_EQ_INT(reason, ULP_SOIL_WAKE_WET);
+
+    // Noise inside the band never wakes: the filtered value is an average
+    // of samples and stays within their range
+    ulp_soil_model_reset(&state, &config);
+    uint32_t lcg = 12345;
+    bool woke = false;
+    uint16_t lowest = 0xFFFF;
+    uint16_t highest = 0;
+    for (int i = 0; i < 5000; i++) {
+        lcg = lcg * 1103515245u + 12345u;
+        uint16_t sample = (uint16_t)(5500 + (lcg >> 16) % 501);     // 5500..6000
+        woke |= ulp_soil_model_step(&state, &config, sample) != ULP_SOIL_WAKE_NONE;
+        lowest = (state.filtered < lowest) ? state.filtered : lowest;
+        highest = (state.filtered > highest) ? state.filtered : highest;
+    }
+    CHECK(!woke);
+    CHECK(lowest >= 5500 - 1);      // Truncating shift may drop one unit
+    CHECK(highest <= 6000);
+
+    // Slow drift out of the band: wakes once, on the dry side
+    ulp_soil_model_reset(&state, &config);
+    int wake_step = 0;
+    for (int i = 0; i < 400 && wake_step == 0; i++) {
+        uint16_t sample = (uint16_t)(5000 + i * 5);
+        if (ulp_soil_model_step(&state, &config, sample) != ULP_SOIL_WAKE_NONE) {
+            wake_step = i;
+        }
+    }
+    CHECK(wake_step > 200);         // Sample crosses 6000 at i = 200, filter lags
+    CHECK(wake_step < 210);
+}
+
+static void test_heartbeat(void)
+{
+    ulp_soil_model_config_t config = {
+        .wake_above = 6000,
+        .wake_below = 3000,
+        .heartbeat_samples = 5,
+    };
+    ulp_soil_model_state_t state;
+    ulp_soil_wake_reason_t reason;
+
+    // Heartbeat of N samples wakes on the Nth in-band sample
+    ulp_soil_model_reset(&state, &config);
+    CHECK_EQ_INT(steps_to_wake(&state, &config, 4500, 100, &reason), 5);
+    CHECK_EQ_INT(reason, ULP_SOIL_WAKE_HEARTBEAT);
+    CHECK_EQ_INT(state.sample_count, 5);
+
+    config.heartbeat_samples = 1;
+    ulp_soil_model_reset(&state, &config);
+    CHECK_EQ_INT(steps_to_wake(&state, &config, 4500, 100, &reason), 1);
+    CHECK_EQ_INT(reason, ULP_SOIL_WAKE_HEARTBEAT);
+
+    // A boundary wake takes precedence on the same sample
+    config.heartbeat_samples = 1;
+    ulp_soil_model_reset(&state, &config);
+    CHECK_EQ_INT(ulp_soil_model_step(&state, &config, 7000), ULP_SOIL_WAKE_DRY);
+}
+
+int main(void)
+{
+    test_channel_scaling();
+    test_boundaries();
+    test_filter_hysteresis();
+    test_heartbeat();
+    return HOST_TEST_RESULT("ulp_soil_model");
+}